@@ -0,0 +1,2741 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_bench.c
+ * @brief  ROHC benchmark program
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The program compresses then decompresses a flow of IP packets and reports
+ * the throughput and latencies of the ROHC library. The IP packets are either
+ * generated in memory (several concurrent RTP, TCP, UDP, ESP and IP-only
+ * flows) or read from a PCAP capture. Losses and reordering may be simulated
+ * on the channel between the compressor and the decompressor.
+ */
+
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h> /* for PRIu64 */
+#include <string.h>
+#if HAVE_WINSOCK2_H == 1
+#  include <winsock2.h> /* for ntohs() on Windows */
+#endif
+#if HAVE_ARPA_INET_H == 1
+#  include <arpa/inet.h> /* for ntohs() on Linux */
+#endif
+#include <assert.h>
+#include <time.h> /* for clock_gettime(2) */
+#include <stdarg.h>
+#include <limits.h> /* for INT_MAX */
+#if HAVE_UNISTD_H == 1
+#  include <unistd.h> /* for sysconf(3) and read(2) */
+#endif
+#if HAVE_LINUX_PERF_EVENT_H == 1 && HAVE_SYS_SYSCALL_H == 1
+#  include <linux/perf_event.h> /* for the LLC misses */
+#  include <sys/syscall.h>
+#  define BENCH_HAVE_PERF_EVENT 1
+#endif
+
+/* includes for network headers */
+#include <protocols/ipv4.h>
+#include <protocols/ipv6.h>
+
+/* include for the PCAP library */
+#if HAVE_PCAP_PCAP_H == 1
+#  include <pcap/pcap.h>
+#elif HAVE_PCAP_H == 1
+#  include <pcap.h>
+#else
+#  error "pcap.h header not found, did you specified --enable-app-bench \
+for ./configure ? If yes, check configure output and config.log"
+#endif
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_packets.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The device MTU */
+#define DEV_MTU  0xffffU
+
+/** The maximal size for the ROHC packets */
+#define MAX_ROHC_SIZE  (DEV_MTU + 100U)
+
+/** The length of the Linux Cooked Sockets header */
+#define LINUX_COOKED_HDR_LEN  16U
+
+/** The length (in bytes) of the Ethernet address */
+#define ETH_ALEN  6U
+
+/** The length (in bytes) of the Ethernet header */
+#define ETHER_HDR_LEN  14U
+
+/** The minimum Ethernet length (in bytes) */
+#define ETHER_FRAME_MIN_LEN  60U
+
+/** The 10Mb/s ethernet header */
+struct ether_header
+{
+	uint8_t ether_dhost[ETH_ALEN];  /**< destination eth addr */
+	uint8_t ether_shost[ETH_ALEN];  /**< source ether addr */
+	uint16_t ether_type;            /**< packet type ID field */
+} __attribute__((__packed__));
+
+/** The Ethertype for the 802.1q protocol (VLAN) */
+#define ETHERTYPE_8021Q   0x8100U
+/** The Ethertype for the 802.1ad protocol */
+#define ETHERTYPE_8021AD  0x88a8U
+
+/** The VLAN header */
+struct vlan_hdr
+{
+	uint16_t vid;  /**< The PCP, DEI and VID fields */
+	uint16_t type; /**< The Ethertype of the next header */
+} __attribute__((packed));
+
+
+/** The default number of synthetic packets */
+#define BENCH_DEFAULT_PKTS_NR  100000U
+
+/** The default number of concurrent synthetic flows */
+#define BENCH_DEFAULT_FLOWS_NR  60U
+
+/** The max length of the synthetic packets */
+#define BENCH_MAX_PKT_LEN  1500U
+
+/** The delay between two synthetic packets (in nanoseconds) */
+#define BENCH_PKT_INTERVAL  100000U
+
+/** The UDP destination port of the synthetic RTP flows */
+#define BENCH_RTP_PORT  1234U
+
+/** The default max number of live flows of the context-scaling sweep */
+#define BENCH_SWEEP_MAX_FLOWS  16384U
+
+
+/** The kinds of synthetic flows */
+typedef enum
+{
+	BENCH_FLOW_RTP      = 0, /**< VoIP: IPv4/UDP/RTP with 20 ms G.711 frames */
+	BENCH_FLOW_TCP_BULK = 1, /**< IPv4/TCP bulk transfer of full segments */
+	BENCH_FLOW_TCP_ACK  = 2, /**< IPv4/TCP pure ACKs of a bulk transfer */
+	BENCH_FLOW_UDP      = 3, /**< IPv4/UDP datagrams */
+	BENCH_FLOW_ESP      = 4, /**< IPv4/ESP packets */
+	BENCH_FLOW_IP       = 5, /**< IPv4 packets with an unknown protocol */
+	BENCH_FLOW_KINDS_NR = 6, /**< The number of kinds of flows */
+} bench_flow_kind_t;
+
+/** The names of the kinds of synthetic flows */
+static const char *const bench_flow_kind_names[BENCH_FLOW_KINDS_NR] =
+{
+	[BENCH_FLOW_RTP]      = "rtp",
+	[BENCH_FLOW_TCP_BULK] = "tcp-bulk",
+	[BENCH_FLOW_TCP_ACK]  = "tcp-ack",
+	[BENCH_FLOW_UDP]      = "udp",
+	[BENCH_FLOW_ESP]      = "esp",
+	[BENCH_FLOW_IP]       = "ip",
+};
+
+
+/** The ways the synthetic flows are accessed */
+typedef enum
+{
+	BENCH_ACCESS_RR   = 0, /**< One packet of every flow in turn */
+	BENCH_ACCESS_ZIPF = 1, /**< Zipf-distributed flows (exponent 1) */
+} bench_access_t;
+
+
+/** One synthetic flow */
+struct bench_flow
+{
+	bench_flow_kind_t kind;  /**< The kind of flow */
+	uint32_t saddr;          /**< The IPv4 source address */
+	uint32_t daddr;          /**< The IPv4 destination address */
+	uint16_t sport;          /**< The UDP/TCP source port */
+	uint16_t dport;          /**< The UDP/TCP destination port */
+	uint16_t ip_id;          /**< The next IP-ID */
+	uint32_t sn;             /**< The next RTP, TCP or ESP sequence number */
+	uint32_t ack;            /**< The next TCP acknowledgment number */
+	uint32_t ts;             /**< The next RTP or TCP timestamp */
+	uint32_t id;             /**< The RTP SSRC or the ESP SPI */
+};
+
+
+/** One packet read from a PCAP capture */
+struct bench_pkt
+{
+	uint8_t *data;         /**< The IP packet */
+	size_t len;            /**< The length of the IP packet */
+	struct rohc_ts time;   /**< The arrival time of the IP packet */
+};
+
+
+/** The packets to (de)compress */
+struct bench_source
+{
+	/** The synthetic flows, NULL if packets are read from a capture */
+	struct bench_flow *flows;
+	/** The number of synthetic flows */
+	size_t flows_nr;
+	/** The identifier of the next synthetic flow */
+	uint32_t next_flow_id;
+	/** The cumulative popularity of the synthetic flows, NULL if the flows
+	 *  are accessed in turn */
+	double *flows_cdf;
+	/** The packets read from a capture, NULL for synthetic flows */
+	struct bench_pkt *pkts;
+	/** The number of packets read from the capture */
+	size_t pkts_nr;
+	/** The buffer for the synthetic packets */
+	uint8_t buf[BENCH_MAX_PKT_LEN];
+};
+
+
+/** A set of latency samples */
+struct bench_samples
+{
+	uint32_t *ns;   /**< The latencies (in nanoseconds) */
+	size_t nr;      /**< The number of latencies */
+	size_t max;     /**< The number of latencies that fit in \e ns */
+};
+
+
+/** The measures for one category of packets */
+struct bench_stats
+{
+	/** The number of compressed packets */
+	size_t comp_nr;
+	/** The number of decompressed packets */
+	size_t decomp_nr;
+	/** The total length (in bytes) of the uncompressed headers */
+	uint64_t uncomp_hdr_len;
+	/** The total length (in bytes) of the compressed headers */
+	uint64_t comp_hdr_len;
+	/** The total length (in bytes) of the uncompressed packets */
+	uint64_t uncomp_len;
+	/** The total length (in bytes) of the compressed packets */
+	uint64_t comp_len;
+	/** The compression latencies */
+	struct bench_samples comp_ns;
+	/** The decompression latencies */
+	struct bench_samples decomp_ns;
+};
+
+
+/** One ROHC packet held back by the channel to reorder it */
+struct bench_held_pkt
+{
+	bool is_held;                     /**< Whether one packet is held back */
+	size_t rohc_len;                  /**< The length of the ROHC packet */
+	uint8_t rohc[MAX_ROHC_SIZE];      /**< The ROHC packet */
+	size_t ip_len;                    /**< The length of the IP packet */
+	uint8_t ip[MAX_ROHC_SIZE];        /**< The original IP packet */
+	int profile_id;                   /**< The profile of the ROHC packet */
+	rohc_packet_t packet_type;        /**< The type of the ROHC packet */
+};
+
+
+/** The benchmark results */
+struct bench_results
+{
+	struct bench_stats total;                      /**< All packets */
+	struct bench_stats profiles[ROHC_PROFILE_MAX]; /**< Per profile */
+	struct bench_stats types[ROHC_PACKET_MAX];     /**< Per packet type */
+	size_t comp_failures;      /**< The packets that failed to be compressed */
+	size_t lost;               /**< The packets lost on the channel */
+	size_t reordered;          /**< The packets reordered on the channel */
+	size_t decomp_failures;    /**< The packets that failed to be decompressed */
+	size_t decomp_damaged;     /**< The packets wrongly decompressed */
+	rohc_mode_t mode;          /**< The mode of the decompressor */
+	size_t feedbacks_nr;       /**< The feedbacks delivered to the compressor */
+	uint64_t feedbacks_len;    /**< The length (in bytes) of the feedbacks */
+	uint64_t wall_ns;          /**< The duration of the whole benchmark */
+	rohc_comp_memory_usage_t comp_mem;     /**< The memory of the compressor */
+	rohc_decomp_memory_usage_t decomp_mem; /**< The memory of the decompressor */
+};
+
+
+/** The measures for one step of the context-scaling sweep */
+struct bench_sweep_step
+{
+	size_t flows_nr;           /**< The number of live flows */
+	size_t comp_ctxts_nr;      /**< The number of compression contexts */
+	size_t decomp_ctxts_nr;    /**< The number of decompression contexts */
+	size_t comp_nr;            /**< The number of compressed packets */
+	size_t decomp_nr;          /**< The number of decompressed packets */
+	size_t failures;           /**< The packets that failed or were damaged */
+	uint64_t comp_ns;          /**< The total time spent compressing */
+	uint64_t decomp_ns;        /**< The total time spent decompressing */
+	bool has_llc;              /**< Whether the LLC misses were counted */
+	uint64_t comp_llc;         /**< The LLC misses while compressing */
+	uint64_t decomp_llc;       /**< The LLC misses while decompressing */
+	bool has_rss;              /**< Whether the resident memory was measured */
+	int64_t comp_rss;          /**< The resident memory used by compression */
+	int64_t decomp_rss;        /**< The resident memory used by decompression */
+};
+
+
+/** Whether the application runs in verbose mode or not */
+static enum
+{
+	VERBOSITY_NONE,
+	VERBOSITY_NORMAL,
+	VERBOSITY_FULL
+} verbosity = VERBOSITY_NORMAL;
+
+/** The state of the pseudo-random generator of the channel and flows */
+static uint32_t bench_rand_state = 1;
+
+
+/* prototypes of private functions */
+static void usage(void);
+
+static int bench_run(struct bench_source *const source,
+                     const size_t pkts_nr,
+                     const rohc_cid_type_t cid_type,
+                     const size_t max_contexts,
+                     const unsigned int loss_rate,
+                     const unsigned int reorder_rate,
+                     const rohc_mode_t mode,
+                     struct bench_results *const results)
+	__attribute__((warn_unused_result, nonnull(1, 8)));
+static bool bench_decomp_one(struct rohc_decomp *const decomp,
+                             struct rohc_comp *const comp,
+                             const struct rohc_buf rohc_packet,
+                             const uint8_t *const ip_data,
+                             const size_t ip_len,
+                             const int profile_id,
+                             const rohc_packet_t packet_type,
+                             struct bench_results *const results)
+	__attribute__((warn_unused_result, nonnull(1, 4, 8)));
+static struct rohc_comp * bench_comp_new(const rohc_cid_type_t cid_type,
+                                         const size_t max_contexts)
+	__attribute__((warn_unused_result));
+static struct rohc_decomp * bench_decomp_new(const rohc_cid_type_t cid_type,
+                                             const size_t max_contexts,
+                                             const rohc_mode_t mode)
+	__attribute__((warn_unused_result));
+
+static int bench_sweep(const bool kinds[BENCH_FLOW_KINDS_NR],
+                       const size_t max_flows,
+                       const size_t pkts_nr,
+                       const rohc_cid_type_t cid_type,
+                       const size_t max_contexts,
+                       const bench_access_t access,
+                       const unsigned int churn_rate)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool bench_sweep_step(struct bench_source *const source,
+                             const size_t pkts_nr,
+                             const rohc_cid_type_t cid_type,
+                             const size_t max_contexts,
+                             const unsigned int churn_rate,
+                             const int llc_fd,
+                             struct bench_sweep_step *const step)
+	__attribute__((warn_unused_result, nonnull(1, 7)));
+static void bench_sweep_step_print(const struct bench_sweep_step *const step)
+	__attribute__((nonnull(1)));
+
+static bool bench_flows_init(struct bench_source *const source,
+                             const size_t flows_nr,
+                             const bool kinds[BENCH_FLOW_KINDS_NR])
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static void bench_flow_init(struct bench_flow *const flow,
+                            const bench_flow_kind_t kind,
+                            const uint32_t id)
+	__attribute__((nonnull(1)));
+static bool bench_flows_zipf_init(struct bench_source *const source)
+	__attribute__((warn_unused_result, nonnull(1)));
+static struct bench_flow * bench_flow_pick(struct bench_source *const source,
+                                           const size_t pkt_num)
+	__attribute__((warn_unused_result, nonnull(1)));
+static size_t bench_flow_build(struct bench_flow *const flow,
+                               uint8_t *const buf)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void bench_ipv4_build(const struct bench_flow *const flow,
+                             uint8_t *const buf,
+                             const uint8_t protocol,
+                             const size_t len)
+	__attribute__((nonnull(1, 2)));
+
+static bool bench_pcap_load(struct bench_source *const source,
+                            const char *const filename)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool detect_vlan_hdrs(const struct rohc_buf *const frame,
+                             size_t *const link_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void bench_source_free(struct bench_source *const source)
+	__attribute__((nonnull(1)));
+
+static bool bench_samples_add(struct bench_samples *const samples,
+                              const uint64_t ns)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool bench_stats_add(struct bench_stats *const stats,
+                            const bool is_comp,
+                            const uint64_t ns)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void bench_stats_free(struct bench_stats *const stats)
+	__attribute__((nonnull(1)));
+static void bench_results_print(struct bench_results *const results)
+	__attribute__((nonnull(1)));
+static void bench_stats_print(const char *const name,
+                              struct bench_stats *const stats)
+	__attribute__((nonnull(1, 2)));
+static void bench_mem_print(const struct bench_results *const results)
+	__attribute__((nonnull(1)));
+static uint32_t bench_samples_percentile(const struct bench_samples *const samples,
+                                         const unsigned int percentile)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static int bench_samples_cmp(const void *const sample1,
+                             const void *const sample2)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+
+static uint64_t bench_now(void)
+	__attribute__((warn_unused_result));
+static void bench_ts_next(struct rohc_ts *const time)
+	__attribute__((nonnull(1)));
+static int64_t bench_rss(void)
+	__attribute__((warn_unused_result));
+static int bench_llc_open(void)
+	__attribute__((warn_unused_result));
+static uint64_t bench_llc_read(const int llc_fd)
+	__attribute__((warn_unused_result));
+static uint32_t bench_rand(void)
+	__attribute__((warn_unused_result));
+
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Main function for the ROHC benchmark program
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct bench_source *source = NULL;
+	struct bench_results *results = NULL;
+	char *pcap_filename = NULL;
+	char *cid_type_name = NULL;
+	char *access_name = NULL;
+	char *mode_name = NULL;
+	bool kinds[BENCH_FLOW_KINDS_NR];
+	bool is_sweep = false;
+	bool is_mem_printed = false;
+	bench_access_t access = BENCH_ACCESS_RR;
+	int flows_nr = -1; /* default depends on the sweep */
+	int pkts_nr = -1; /* default depends on the source of packets */
+	int max_contexts = -1; /* default depends on the CID type */
+	int loss_rate = 0;
+	int reorder_rate = 0;
+	int churn_rate = 0;
+	int seed = 1;
+	size_t max_possible_contexts = ROHC_LARGE_CID_MAX + 1;
+	rohc_cid_type_t cid_type = ROHC_LARGE_CID;
+	rohc_mode_t mode = ROHC_U_MODE;
+	int status = 1;
+	int args_used;
+	size_t i;
+
+	/* set to normal mode by default */
+	verbosity = VERBOSITY_NORMAL;
+
+	/* all kinds of flows by default */
+	for(i = 0; i < BENCH_FLOW_KINDS_NR; i++)
+	{
+		kinds[i] = true;
+	}
+
+	/* parse program arguments, print the help message in case of failure */
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_bench version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "--verbose"))
+		{
+			/* be more verbose */
+			verbosity = VERBOSITY_FULL;
+		}
+		else if(!strcmp(*argv, "--quiet"))
+		{
+			/* be more quiet */
+			verbosity = VERBOSITY_NONE;
+		}
+		else if(!strcmp(*argv, "--sweep"))
+		{
+			/* sweep the number of live flows */
+			is_sweep = true;
+		}
+		else if(!strcmp(*argv, "--memory"))
+		{
+			/* print the memory used by the contexts of every profile */
+			is_mem_printed = true;
+		}
+		else if(argc <= 1)
+		{
+			/* all other options have one parameter */
+			fprintf(stderr, "unknown option '%s' or missing parameter\n", *argv);
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "--flows"))
+		{
+			/* get the number of concurrent synthetic flows */
+			flows_nr = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--kinds"))
+		{
+			/* get the kinds of synthetic flows */
+			char *kind_name = strtok(argv[1], ",");
+
+			for(i = 0; i < BENCH_FLOW_KINDS_NR; i++)
+			{
+				kinds[i] = false;
+			}
+			while(kind_name != NULL)
+			{
+				for(i = 0; i < BENCH_FLOW_KINDS_NR &&
+				           strcmp(kind_name, bench_flow_kind_names[i]) != 0; i++)
+				{
+				}
+				if(i >= BENCH_FLOW_KINDS_NR)
+				{
+					fprintf(stderr, "unknown kind of flow '%s'\n", kind_name);
+					usage();
+					goto error;
+				}
+				kinds[i] = true;
+				kind_name = strtok(NULL, ",");
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--pkts-nr"))
+		{
+			/* get the number of packets to (de)compress */
+			pkts_nr = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--loss"))
+		{
+			/* get the loss rate on the channel */
+			loss_rate = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--reorder"))
+		{
+			/* get the reordering rate on the channel */
+			reorder_rate = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--access"))
+		{
+			/* get the way the flows are accessed during the sweep */
+			access_name = argv[1];
+			if(!strcmp(access_name, "rr"))
+			{
+				access = BENCH_ACCESS_RR;
+			}
+			else if(!strcmp(access_name, "zipf"))
+			{
+				access = BENCH_ACCESS_ZIPF;
+			}
+			else
+			{
+				fprintf(stderr, "invalid access '%s', only 'rr' and 'zipf' "
+				        "expected\n", access_name);
+				usage();
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--churn"))
+		{
+			/* get the rate of new flows during the sweep */
+			churn_rate = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--seed"))
+		{
+			/* get the seed of the pseudo-random generators */
+			seed = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--cid-type"))
+		{
+			/* get the type of CID to use within the ROHC library */
+			cid_type_name = argv[1];
+			if(!strcmp(cid_type_name, "smallcid"))
+			{
+				cid_type = ROHC_SMALL_CID;
+				max_possible_contexts = ROHC_SMALL_CID_MAX + 1;
+			}
+			else if(!strcmp(cid_type_name, "largecid"))
+			{
+				cid_type = ROHC_LARGE_CID;
+				max_possible_contexts = ROHC_LARGE_CID_MAX + 1;
+			}
+			else
+			{
+				fprintf(stderr, "invalid CID type '%s', only 'smallcid' and "
+				        "'largecid' expected\n", cid_type_name);
+				usage();
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--mode"))
+		{
+			/* get the mode the decompressor shall target */
+			mode_name = argv[1];
+			if(!strcmp(mode_name, "u"))
+			{
+				mode = ROHC_U_MODE;
+			}
+			else if(!strcmp(mode_name, "o"))
+			{
+				mode = ROHC_O_MODE;
+			}
+			else
+			{
+				fprintf(stderr, "invalid mode '%s', only 'u' and 'o' expected\n",
+				        mode_name);
+				usage();
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--max-contexts"))
+		{
+			/* get the maximum number of contexts the test should use */
+			max_contexts = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--pcap"))
+		{
+			/* get the name of the capture to replay */
+			pcap_filename = argv[1];
+			args_used++;
+		}
+		else
+		{
+			fprintf(stderr, "unknown option '%s'\n", *argv);
+			usage();
+			goto error;
+		}
+	}
+
+	/* the sweep ends with the max number of live flows by default */
+	if(flows_nr == -1)
+	{
+		flows_nr = (is_sweep ? BENCH_SWEEP_MAX_FLOWS : BENCH_DEFAULT_FLOWS_NR);
+	}
+
+	/* check the synthetic flows */
+	if(flows_nr < 1)
+	{
+		fprintf(stderr, "the number of flows should be at least 1\n\n");
+		usage();
+		goto error;
+	}
+
+	/* check the rates of the channel */
+	if(loss_rate < 0 || loss_rate > 100 || reorder_rate < 0 || reorder_rate > 100)
+	{
+		fprintf(stderr, "the loss and reordering rates should be between 0 and "
+		        "100 %%\n\n");
+		usage();
+		goto error;
+	}
+
+	/* check the sweep */
+	if(is_sweep && pcap_filename != NULL)
+	{
+		fprintf(stderr, "the sweep only works with synthetic flows\n\n");
+		usage();
+		goto error;
+	}
+	if(is_sweep && is_mem_printed)
+	{
+		fprintf(stderr, "the sweep already reports the memory per context\n\n");
+		usage();
+		goto error;
+	}
+	if(is_sweep && mode != ROHC_U_MODE)
+	{
+		fprintf(stderr, "the sweep only runs in U-mode\n\n");
+		usage();
+		goto error;
+	}
+	if(churn_rate < 0 || churn_rate > 100)
+	{
+		fprintf(stderr, "the churn rate should be between 0 and 100 %%\n\n");
+		usage();
+		goto error;
+	}
+
+	/* one context per flow by default, within the limits of the CID type;
+	 * the sweep gives one context per flow at every step */
+	if(max_contexts < 0 && !is_sweep)
+	{
+		if(pcap_filename != NULL || ((size_t) flows_nr) > max_possible_contexts)
+		{
+			max_contexts = max_possible_contexts;
+		}
+		else
+		{
+			max_contexts = flows_nr;
+		}
+	}
+	if((max_contexts >= 0 || !is_sweep) &&
+	   (max_contexts < 1 || ((size_t) max_contexts) > max_possible_contexts))
+	{
+		fprintf(stderr, "the maximum number of ROHC contexts should be "
+		        "between 1 and %zu\n\n", max_possible_contexts);
+		usage();
+		goto error;
+	}
+
+	/* initialize the random generators with the given seed to ease
+	 * comparisons between runs */
+	srand(seed);
+	bench_rand_state = (seed != 0 ? seed : 1);
+
+	/* measure how the cost grows with the number of live flows */
+	if(is_sweep)
+	{
+		if(pkts_nr < 0)
+		{
+			pkts_nr = BENCH_DEFAULT_PKTS_NR;
+		}
+		if(verbosity != VERBOSITY_NONE)
+		{
+			printf("sweep from 1 to %d live flows with %s access and %d%% churn, "
+			       "%d packets per step with %s\n\n", flows_nr,
+			       (access == BENCH_ACCESS_ZIPF ? "Zipf" : "round-robin"),
+			       churn_rate, pkts_nr,
+			       (cid_type == ROHC_SMALL_CID ? "small CIDs" : "large CIDs"));
+		}
+		status = bench_sweep(kinds, flows_nr, pkts_nr, cid_type,
+		                     (max_contexts > 0 ? max_contexts : 0), access,
+		                     churn_rate);
+		goto error;
+	}
+
+	/* create the source of packets */
+	source = calloc(1, sizeof(struct bench_source));
+	if(source == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the source of packets\n");
+		goto error;
+	}
+	if(pcap_filename != NULL)
+	{
+		if(!bench_pcap_load(source, pcap_filename))
+		{
+			goto free_source;
+		}
+		if(pkts_nr < 0 || ((size_t) pkts_nr) > source->pkts_nr)
+		{
+			pkts_nr = source->pkts_nr;
+		}
+	}
+	else
+	{
+		if(!bench_flows_init(source, flows_nr, kinds))
+		{
+			goto free_source;
+		}
+		if(pkts_nr < 0)
+		{
+			pkts_nr = BENCH_DEFAULT_PKTS_NR;
+		}
+	}
+
+	/* run the benchmark */
+	results = calloc(1, sizeof(struct bench_results));
+	if(results == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the results\n");
+		goto free_source;
+	}
+	if(verbosity != VERBOSITY_NONE)
+	{
+		if(pcap_filename != NULL)
+		{
+			printf("replay %d packets from '%s'", pkts_nr, pcap_filename);
+		}
+		else
+		{
+			printf("generate %d packets on %d flows (", pkts_nr, flows_nr);
+			for(i = 0; i < BENCH_FLOW_KINDS_NR; i++)
+			{
+				if(kinds[i])
+				{
+					printf(" %s", bench_flow_kind_names[i]);
+				}
+			}
+			printf(" )");
+		}
+		printf(" with %s and %d contexts in %s, %d%% loss, %d%% reordering\n\n",
+		       (cid_type == ROHC_SMALL_CID ? "small CIDs" : "large CIDs"),
+		       max_contexts, rohc_get_mode_descr(mode), loss_rate, reorder_rate);
+	}
+	status = bench_run(source, pkts_nr, cid_type, max_contexts, loss_rate,
+	                   reorder_rate, mode, results);
+	if(status == 0)
+	{
+		bench_results_print(results);
+		if(is_mem_printed)
+		{
+			bench_mem_print(results);
+		}
+	}
+
+	bench_stats_free(&results->total);
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		bench_stats_free(&results->profiles[i]);
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		bench_stats_free(&results->types[i]);
+	}
+	free(results);
+free_source:
+	bench_source_free(source);
+	free(source);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the benchmark application
+ */
+static void usage(void)
+{
+	printf("The ROHC bench tool measures the performances of ROHC (de)compression\n"
+	       "\n"
+	       "The rohc_bench tool compresses then decompresses a flow of IP packets\n"
+	       "and reports the number of packets per second, the time per packet,\n"
+	       "the header bytes saved, and the latency percentiles per profile and\n"
+	       "per packet type. The IP packets are either generated in memory on\n"
+	       "several concurrent flows, or read from a capture in PCAP format.\n"
+	       "\n"
+	       "Usage: rohc_bench [OPTIONS]\n"
+	       "\n"
+	       "Options:\n"
+	       "  -v, --version           Print version information and exit\n"
+	       "  -h, --help              Print this usage and exit\n"
+	       "      --verbose           Be more verbose\n"
+	       "      --quiet             Tell the application to be even less verbose\n"
+	       "      --flows NUM         The number of concurrent synthetic flows\n"
+	       "                          (default: %u)\n"
+	       "      --kinds LIST        The comma-separated kinds of synthetic flows\n"
+	       "                          among 'rtp', 'tcp-bulk', 'tcp-ack', 'udp',\n"
+	       "                          'esp', and 'ip' (default: all)\n"
+	       "      --pcap FILE         Replay the IP packets of the given capture\n"
+	       "                          instead of generating synthetic flows\n"
+	       "      --pkts-nr NUM       The number of packets to (de)compress\n"
+	       "                          (default: %u synthetic packets, or all the\n"
+	       "                           packets of the capture)\n"
+	       "      --loss PERCENT      The rate of ROHC packets lost between the\n"
+	       "                          compressor and the decompressor (default: 0)\n"
+	       "      --reorder PERCENT   The rate of ROHC packets swapped with the next\n"
+	       "                          one between the compressor and the\n"
+	       "                          decompressor (default: 0)\n"
+	       "      --cid-type TYPE     The type of CID to use among 'smallcid' and\n"
+	       "                          'largecid' (default: largecid)\n"
+	       "      --max-contexts NUM  The maximum number of ROHC contexts to\n"
+	       "                          simultaneously use during the test\n"
+	       "                          (default: one per flow)\n"
+	       "      --mode MODE         The mode of the decompressor among 'u' and\n"
+	       "                          'o', in O-mode the feedbacks are delivered\n"
+	       "                          to the compressor (default: u)\n"
+	       "      --seed NUM          The seed of the pseudo-random generators\n"
+	       "                          (default: 1)\n"
+	       "      --sweep             Double the number of live synthetic flows\n"
+	       "                          from 1 up to --flows (default: %u),\n"
+	       "                          (de)compress --pkts-nr packets at every\n"
+	       "                          step, and report the time, the LLC misses,\n"
+	       "                          and the resident memory per context\n"
+	       "      --access TYPE       The way the live flows are accessed during\n"
+	       "                          the sweep among 'rr' (round-robin) and\n"
+	       "                          'zipf' (default: rr)\n"
+	       "      --churn PERCENT     The rate of packets that replace their flow\n"
+	       "                          by a new one during the sweep (default: 0)\n"
+	       "      --memory            Print the memory used by the compressor and\n"
+	       "                          the decompressor at the end of the benchmark,\n"
+	       "                          per subsystem and per profile\n"
+	       "\n"
+	       "Examples:\n"
+	       "  rohc_bench --flows 1000 --loss 1           Benchmark 1000 mixed flows\n"
+	       "  rohc_bench --kinds rtp --flows 16 --cid-type smallcid\n"
+	       "                                             Benchmark 16 VoIP flows\n"
+	       "  rohc_bench --pcap /tmp/rtp.pcap            Benchmark a capture\n"
+	       "  rohc_bench --mode o --loss 1               Benchmark with feedbacks\n"
+	       "  rohc_bench --kinds tcp-bulk --flows 1000 --memory\n"
+	       "                                             Memory of 1000 TCP contexts\n"
+	       "  rohc_bench --sweep --access zipf --churn 1 Benchmark from 1 to %u\n"
+	       "                                             live flows\n"
+	       "\n"
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n",
+	       BENCH_DEFAULT_FLOWS_NR, BENCH_DEFAULT_PKTS_NR, BENCH_SWEEP_MAX_FLOWS,
+	       BENCH_SWEEP_MAX_FLOWS);
+}
+
+
+/**
+ * @brief Compress, then decompress the packets of the given source
+ *
+ * @param source        The source of IP packets
+ * @param pkts_nr       The number of packets to (de)compress
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param loss_rate     The rate (in %) of ROHC packets lost on the channel
+ * @param reorder_rate  The rate (in %) of ROHC packets reordered on the
+ *                      channel
+ * @param mode          The mode of the decompressor, in O-mode its feedbacks
+ *                      are delivered to the compressor without loss
+ * @param results       The measures of the benchmark
+ * @return              0 in case of success,
+ *                      1 in case of failure
+ */
+static int bench_run(struct bench_source *const source,
+                     const size_t pkts_nr,
+                     const rohc_cid_type_t cid_type,
+                     const size_t max_contexts,
+                     const unsigned int loss_rate,
+                     const unsigned int reorder_rate,
+                     const rohc_mode_t mode,
+                     struct bench_results *const results)
+{
+	struct rohc_comp *comp;
+	struct rohc_comp *feedback_comp;
+	struct rohc_decomp *decomp;
+	struct bench_held_pkt *held;
+	uint8_t *rohc_buffer;
+	struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	uint64_t start_ns;
+	size_t i;
+	int is_failure = 1;
+
+	/* the buffers are too large for the stack */
+	rohc_buffer = malloc(MAX_ROHC_SIZE);
+	if(rohc_buffer == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the ROHC packets\n");
+		goto error;
+	}
+	held = calloc(1, sizeof(struct bench_held_pkt));
+	if(held == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the reordered packets\n");
+		goto free_rohc_buffer;
+	}
+
+	/* create the ROHC compressor and decompressor */
+	comp = bench_comp_new(cid_type, max_contexts);
+	if(comp == NULL)
+	{
+		goto free_held;
+	}
+	decomp = bench_decomp_new(cid_type, max_contexts, mode);
+	if(decomp == NULL)
+	{
+		goto destroy_comp;
+	}
+
+	/* in O-mode, the feedbacks of the decompressor go back to the compressor */
+	results->mode = mode;
+	feedback_comp = (mode == ROHC_O_MODE ? comp : NULL);
+
+	start_ns = bench_now();
+	for(i = 0; i < pkts_nr; i++)
+	{
+		struct rohc_buf ip_packet;
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		rohc_comp_last_packet_info2_t last_packet_info;
+		rohc_status_t status;
+		uint64_t comp_start_ns;
+		uint64_t comp_ns;
+
+		/* get the next IP packet */
+		if(source->pkts != NULL)
+		{
+			ip_packet.data = source->pkts[i].data;
+			ip_packet.max_len = source->pkts[i].len;
+			ip_packet.offset = 0;
+			ip_packet.len = source->pkts[i].len;
+			ip_packet.time = source->pkts[i].time;
+		}
+		else
+		{
+			struct bench_flow *const flow = &source->flows[i % source->flows_nr];
+
+			ip_packet.data = source->buf;
+			ip_packet.max_len = BENCH_MAX_PKT_LEN;
+			ip_packet.offset = 0;
+			ip_packet.len = bench_flow_build(flow, source->buf);
+			bench_ts_next(&arrival_time);
+			ip_packet.time = arrival_time;
+		}
+
+		/* compress the IP packet */
+		comp_start_ns = bench_now();
+		status = rohc_compress4(comp, ip_packet, &rohc_packet);
+		comp_ns = bench_now() - comp_start_ns;
+		if(status != ROHC_STATUS_OK)
+		{
+			if(verbosity == VERBOSITY_FULL)
+			{
+				fprintf(stderr, "packet #%zu: compression failed\n", i + 1);
+			}
+			results->comp_failures++;
+			continue;
+		}
+
+		/* record the compression measures */
+		last_packet_info.version_major = 0;
+		last_packet_info.version_minor = 0;
+		if(!rohc_comp_get_last_packet_info2(comp, &last_packet_info))
+		{
+			fprintf(stderr, "packet #%zu: cannot get stats about the last "
+			        "compressed packet\n", i + 1);
+			goto destroy_decomp;
+		}
+		assert(last_packet_info.profile_id >= 0);
+		assert(last_packet_info.profile_id < ROHC_PROFILE_MAX);
+		assert(last_packet_info.packet_type < ROHC_PACKET_MAX);
+		{
+			struct bench_stats *const stats[3] = {
+				&results->total,
+				&results->profiles[last_packet_info.profile_id],
+				&results->types[last_packet_info.packet_type],
+			};
+			size_t j;
+
+			for(j = 0; j < 3; j++)
+			{
+				stats[j]->uncomp_hdr_len += last_packet_info.header_last_uncomp_size;
+				stats[j]->comp_hdr_len += last_packet_info.header_last_comp_size;
+				stats[j]->uncomp_len += last_packet_info.total_last_uncomp_size;
+				stats[j]->comp_len += last_packet_info.total_last_comp_size;
+				if(!bench_stats_add(stats[j], true, comp_ns))
+				{
+					goto destroy_decomp;
+				}
+			}
+		}
+
+		/* lose the ROHC packet on the channel */
+		if(loss_rate > 0 && (bench_rand() % 100) < loss_rate)
+		{
+			results->lost++;
+			continue;
+		}
+
+		/* hold the ROHC packet back to swap it with the next one */
+		if(!held->is_held && reorder_rate > 0 &&
+		   (bench_rand() % 100) < reorder_rate)
+		{
+			held->is_held = true;
+			held->rohc_len = rohc_packet.len;
+			memcpy(held->rohc, rohc_buf_data(rohc_packet), rohc_packet.len);
+			held->ip_len = ip_packet.len;
+			memcpy(held->ip, rohc_buf_data(ip_packet), ip_packet.len);
+			held->profile_id = last_packet_info.profile_id;
+			held->packet_type = last_packet_info.packet_type;
+			results->reordered++;
+			continue;
+		}
+
+		/* decompress the ROHC packet, then the one held back if any */
+		if(!bench_decomp_one(decomp, feedback_comp, rohc_packet,
+		                     rohc_buf_data(ip_packet), ip_packet.len,
+		                     last_packet_info.profile_id,
+		                     last_packet_info.packet_type, results))
+		{
+			goto destroy_decomp;
+		}
+		if(held->is_held)
+		{
+			const struct rohc_buf held_packet =
+				rohc_buf_init_full(held->rohc, held->rohc_len, ip_packet.time);
+
+			if(!bench_decomp_one(decomp, feedback_comp, held_packet, held->ip,
+			                     held->ip_len, held->profile_id,
+			                     held->packet_type, results))
+			{
+				goto destroy_decomp;
+			}
+			held->is_held = false;
+		}
+	}
+	results->wall_ns = bench_now() - start_ns;
+
+	/* the memory used by the contexts of all the flows */
+	results->comp_mem.version_major = 0;
+	results->comp_mem.version_minor = 0;
+	if(!rohc_comp_get_memory_usage(comp, &results->comp_mem))
+	{
+		fprintf(stderr, "failed to get the memory used by the compressor\n");
+		goto destroy_decomp;
+	}
+	results->decomp_mem.version_major = 0;
+	results->decomp_mem.version_minor = 0;
+	if(!rohc_decomp_get_memory_usage(decomp, &results->decomp_mem))
+	{
+		fprintf(stderr, "failed to get the memory used by the decompressor\n");
+		goto destroy_decomp;
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+free_held:
+	free(held);
+free_rohc_buffer:
+	free(rohc_buffer);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Decompress one ROHC packet and record the measures
+ *
+ * The feedback returned by the decompressor, even upon failure, is delivered
+ * to the compressor if any.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param comp         The ROHC compressor to deliver the feedbacks to,
+ *                     NULL to ignore the feedbacks
+ * @param rohc_packet  The ROHC packet to decompress
+ * @param ip_data      The original IP packet
+ * @param ip_len       The length of the original IP packet
+ * @param profile_id   The profile the ROHC packet was compressed with
+ * @param packet_type  The type of the ROHC packet
+ * @param results      The measures of the benchmark
+ * @return             true if the measures were recorded, false if memory
+ *                     is missing or if the compressor rejected a feedback
+ */
+static bool bench_decomp_one(struct rohc_decomp *const decomp,
+                             struct rohc_comp *const comp,
+                             const struct rohc_buf rohc_packet,
+                             const uint8_t *const ip_data,
+                             const size_t ip_len,
+                             const int profile_id,
+                             const rohc_packet_t packet_type,
+                             struct bench_results *const results)
+{
+	uint8_t uncomp_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf uncomp_packet =
+		rohc_buf_init_empty(uncomp_buffer, MAX_ROHC_SIZE);
+	uint8_t feedback_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf feedback =
+		rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+	struct bench_stats *const stats[3] = {
+		&results->total,
+		&results->profiles[profile_id],
+		&results->types[packet_type],
+	};
+	rohc_status_t status;
+	uint64_t decomp_start_ns;
+	uint64_t decomp_ns;
+	size_t j;
+
+	decomp_start_ns = bench_now();
+	status = rohc_decompress3(decomp, rohc_packet, &uncomp_packet, NULL,
+	                          (comp != NULL ? &feedback : NULL));
+	decomp_ns = bench_now() - decomp_start_ns;
+
+	/* deliver the feedback to the compressor */
+	if(feedback.len > 0)
+	{
+		if(!rohc_comp_deliver_feedback2(comp, feedback))
+		{
+			fprintf(stderr, "failed to deliver the feedback to the compressor\n");
+			return false;
+		}
+		results->feedbacks_nr++;
+		results->feedbacks_len += feedback.len;
+	}
+
+	if(status != ROHC_STATUS_OK)
+	{
+		results->decomp_failures++;
+		return true;
+	}
+
+	/* check that decompressed packet matches the original IP packet */
+	if(uncomp_packet.len != ip_len ||
+	   memcmp(rohc_buf_data(uncomp_packet), ip_data, ip_len) != 0)
+	{
+		results->decomp_damaged++;
+	}
+
+	for(j = 0; j < 3; j++)
+	{
+		if(!bench_stats_add(stats[j], false, decomp_ns))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Create the ROHC compressor with all the benchmarked profiles
+ *
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @return              The ROHC compressor, NULL in case of failure
+ */
+static struct rohc_comp * bench_comp_new(const rohc_cid_type_t cid_type,
+                                         const size_t max_contexts)
+{
+	struct rohc_comp *comp;
+
+	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC compressor\n");
+		goto error;
+	}
+	if(verbosity == VERBOSITY_FULL &&
+	   !rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on compressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_RTP, ROHC_PROFILE_ESP,
+	                              ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set the RTP detection callback\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create the ROHC decompressor with all the benchmarked profiles
+ *
+ * @param cid_type      The type of CIDs the decompressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param mode          The mode the decompressor shall target
+ * @return              The ROHC decompressor, NULL in case of failure
+ */
+static struct rohc_decomp * bench_decomp_new(const rohc_cid_type_t cid_type,
+                                             const size_t max_contexts,
+                                             const rohc_mode_t mode)
+{
+	struct rohc_decomp *decomp;
+
+	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, mode);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC decompressor\n");
+		goto error;
+	}
+	if(verbosity == VERBOSITY_FULL &&
+	   !rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                                ROHC_PROFILE_RTP, ROHC_PROFILE_ESP,
+	                                ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	return decomp;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Measure how the cost per packet grows with the number of live flows
+ *
+ * The number of live flows doubles at every step, from 1 flow up to the
+ * given maximum. Every step uses a new compressor and a new decompressor.
+ *
+ * @param kinds         The kinds of synthetic flows
+ * @param max_flows     The number of live flows of the last step
+ * @param pkts_nr       The number of packets to (de)compress at every step
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use, 0 for one
+ *                      context per live flow
+ * @param access        The way the live flows are accessed
+ * @param churn_rate    The rate (in %) of packets that replace their flow
+ *                      by a new one
+ * @return              0 in case of success,
+ *                      1 in case of failure
+ */
+static int bench_sweep(const bool kinds[BENCH_FLOW_KINDS_NR],
+                       const size_t max_flows,
+                       const size_t pkts_nr,
+                       const rohc_cid_type_t cid_type,
+                       const size_t max_contexts,
+                       const bench_access_t access,
+                       const unsigned int churn_rate)
+{
+	const size_t max_possible_contexts =
+		(cid_type == ROHC_SMALL_CID ? ROHC_SMALL_CID_MAX : ROHC_LARGE_CID_MAX) + 1;
+	struct bench_source *source;
+	size_t flows_nr;
+	int llc_fd;
+	int is_failure = 1;
+
+	source = calloc(1, sizeof(struct bench_source));
+	if(source == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the source of packets\n");
+		goto error;
+	}
+
+	llc_fd = bench_llc_open();
+	if(llc_fd < 0 && verbosity != VERBOSITY_NONE)
+	{
+		printf("LLC misses are not available on this system\n\n");
+	}
+
+	printf("%7s %7s %7s %9s %9s %9s %9s %9s %9s %8s\n", "flows", "comp",
+	       "decomp", "comp", "decomp", "comp", "decomp", "comp", "decomp",
+	       "failures");
+	printf("%7s %7s %7s %9s %9s %9s %9s %9s %9s\n", "", "ctxts", "ctxts",
+	       "ns/pkt", "ns/pkt", "LLC/pkt", "LLC/pkt", "B/ctxt", "B/ctxt");
+	for(flows_nr = 1; ; flows_nr *= 2)
+	{
+		struct bench_sweep_step step;
+		size_t step_max_contexts = max_contexts;
+
+		if(flows_nr > max_flows)
+		{
+			flows_nr = max_flows;
+		}
+		if(step_max_contexts == 0)
+		{
+			step_max_contexts = (flows_nr < max_possible_contexts ?
+			                     flows_nr : max_possible_contexts);
+		}
+
+		bench_source_free(source);
+		if(!bench_flows_init(source, flows_nr, kinds))
+		{
+			goto close_llc;
+		}
+		if(access == BENCH_ACCESS_ZIPF && !bench_flows_zipf_init(source))
+		{
+			goto close_llc;
+		}
+		if(!bench_sweep_step(source, pkts_nr, cid_type, step_max_contexts,
+		                     churn_rate, llc_fd, &step))
+		{
+			goto close_llc;
+		}
+		bench_sweep_step_print(&step);
+
+		if(flows_nr >= max_flows)
+		{
+			break;
+		}
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+close_llc:
+#ifdef BENCH_HAVE_PERF_EVENT
+	if(llc_fd >= 0)
+	{
+		close(llc_fd);
+	}
+#endif
+	bench_source_free(source);
+	free(source);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Run one step of the context-scaling sweep
+ *
+ * The first packet of every flow creates its contexts: the resident memory
+ * of the process is measured around those packets. The given number of
+ * packets is then (de)compressed, and the time and the LLC misses are
+ * measured around every call to the library.
+ *
+ * @param source        The source of packets with its synthetic flows
+ * @param pkts_nr       The number of packets to (de)compress
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param churn_rate    The rate (in %) of packets that replace their flow
+ *                      by a new one
+ * @param llc_fd        The counter of LLC misses, -1 if not available
+ * @param step          The measures of the step
+ * @return              true if the step was run, false otherwise
+ */
+static bool bench_sweep_step(struct bench_source *const source,
+                             const size_t pkts_nr,
+                             const rohc_cid_type_t cid_type,
+                             const size_t max_contexts,
+                             const unsigned int churn_rate,
+                             const int llc_fd,
+                             struct bench_sweep_step *const step)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	uint8_t *rohc_buffer;
+	uint8_t *uncomp_buffer;
+	struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	rohc_comp_general_info_t comp_info;
+	rohc_decomp_general_info_t decomp_info;
+	size_t i;
+	bool is_success = false;
+
+	memset(step, 0, sizeof(struct bench_sweep_step));
+	step->flows_nr = source->flows_nr;
+	step->has_llc = (llc_fd >= 0);
+	step->has_rss = (bench_rss() >= 0);
+
+	/* the buffers are too large for the stack */
+	rohc_buffer = malloc(MAX_ROHC_SIZE);
+	if(rohc_buffer == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the ROHC packets\n");
+		goto error;
+	}
+	uncomp_buffer = malloc(MAX_ROHC_SIZE);
+	if(uncomp_buffer == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the decompressed "
+		        "packets\n");
+		goto free_rohc_buffer;
+	}
+
+	comp = bench_comp_new(cid_type, max_contexts);
+	if(comp == NULL)
+	{
+		goto free_uncomp_buffer;
+	}
+	decomp = bench_decomp_new(cid_type, max_contexts, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		goto destroy_comp;
+	}
+
+	for(i = 0; i < source->flows_nr + pkts_nr; i++)
+	{
+		const bool is_warmup = (i < source->flows_nr);
+		struct rohc_buf ip_packet;
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf uncomp_packet =
+			rohc_buf_init_empty(uncomp_buffer, MAX_ROHC_SIZE);
+		struct bench_flow *flow;
+		rohc_status_t status;
+		int64_t rss_start;
+		uint64_t llc_start;
+		uint64_t start_ns;
+		uint64_t end_ns;
+
+		/* one packet of every flow first, then the chosen access pattern
+		 * with new flows replacing old ones */
+		if(is_warmup)
+		{
+			flow = &source->flows[i];
+		}
+		else
+		{
+			flow = bench_flow_pick(source, i);
+			if(churn_rate > 0 && (bench_rand() % 100) < churn_rate)
+			{
+				bench_flow_init(flow, flow->kind, source->next_flow_id);
+				source->next_flow_id++;
+			}
+		}
+		ip_packet.data = source->buf;
+		ip_packet.max_len = BENCH_MAX_PKT_LEN;
+		ip_packet.offset = 0;
+		ip_packet.len = bench_flow_build(flow, source->buf);
+		bench_ts_next(&arrival_time);
+		ip_packet.time = arrival_time;
+
+		/* compress the IP packet */
+		rss_start = (is_warmup ? bench_rss() : 0);
+		llc_start = bench_llc_read(llc_fd);
+		start_ns = bench_now();
+		status = rohc_compress4(comp, ip_packet, &rohc_packet);
+		end_ns = bench_now();
+		if(is_warmup)
+		{
+			step->comp_rss += bench_rss() - rss_start;
+		}
+		else
+		{
+			step->comp_llc += bench_llc_read(llc_fd) - llc_start;
+			step->comp_ns += end_ns - start_ns;
+			step->comp_nr++;
+		}
+		if(status != ROHC_STATUS_OK)
+		{
+			step->failures++;
+			continue;
+		}
+
+		/* decompress the ROHC packet */
+		rss_start = (is_warmup ? bench_rss() : 0);
+		llc_start = bench_llc_read(llc_fd);
+		start_ns = bench_now();
+		status = rohc_decompress3(decomp, rohc_packet, &uncomp_packet, NULL, NULL);
+		end_ns = bench_now();
+		if(is_warmup)
+		{
+			step->decomp_rss += bench_rss() - rss_start;
+		}
+		else
+		{
+			step->decomp_llc += bench_llc_read(llc_fd) - llc_start;
+			step->decomp_ns += end_ns - start_ns;
+			step->decomp_nr++;
+		}
+		if(status != ROHC_STATUS_OK ||
+		   uncomp_packet.len != ip_packet.len ||
+		   memcmp(rohc_buf_data(uncomp_packet), rohc_buf_data(ip_packet),
+		          ip_packet.len) != 0)
+		{
+			step->failures++;
+		}
+	}
+
+	/* the number of contexts the flows were given */
+	comp_info.version_major = 0;
+	comp_info.version_minor = 0;
+	if(!rohc_comp_get_general_info(comp, &comp_info))
+	{
+		fprintf(stderr, "failed to get general information about the "
+		        "compressor\n");
+		goto destroy_decomp;
+	}
+	step->comp_ctxts_nr = comp_info.contexts_nr;
+	decomp_info.version_major = 0;
+	decomp_info.version_minor = 0;
+	if(!rohc_decomp_get_general_info(decomp, &decomp_info))
+	{
+		fprintf(stderr, "failed to get general information about the "
+		        "decompressor\n");
+		goto destroy_decomp;
+	}
+	step->decomp_ctxts_nr = decomp_info.contexts_nr;
+
+	is_success = true;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+free_uncomp_buffer:
+	free(uncomp_buffer);
+free_rohc_buffer:
+	free(rohc_buffer);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Print the measures of one step of the context-scaling sweep
+ *
+ * The resident memory per context is the growth of the resident memory of
+ * the process while the contexts were created, divided by the number of
+ * contexts. It is only meaningful with many contexts, since the resident
+ * memory grows by whole pages.
+ *
+ * @param step  The measures of the step
+ */
+static void bench_sweep_step_print(const struct bench_sweep_step *const step)
+{
+	printf("%7zu %7zu %7zu %9.1f %9.1f", step->flows_nr, step->comp_ctxts_nr,
+	       step->decomp_ctxts_nr,
+	       (step->comp_nr > 0 ? ((double) step->comp_ns) / step->comp_nr : 0.0),
+	       (step->decomp_nr > 0 ?
+	        ((double) step->decomp_ns) / step->decomp_nr : 0.0));
+	if(step->has_llc && step->comp_nr > 0 && step->decomp_nr > 0)
+	{
+		printf(" %9.2f %9.2f", ((double) step->comp_llc) / step->comp_nr,
+		       ((double) step->decomp_llc) / step->decomp_nr);
+	}
+	else
+	{
+		printf(" %9s %9s", "n/a", "n/a");
+	}
+	if(step->has_rss && step->comp_ctxts_nr > 0 && step->decomp_ctxts_nr > 0)
+	{
+		printf(" %9.0f %9.0f", ((double) step->comp_rss) / step->comp_ctxts_nr,
+		       ((double) step->decomp_rss) / step->decomp_ctxts_nr);
+	}
+	else
+	{
+		printf(" %9s %9s", "n/a", "n/a");
+	}
+	printf(" %8zu\n", step->failures);
+	fflush(stdout);
+}
+
+
+/**
+ * @brief Create the synthetic flows
+ *
+ * The flows are shared among the given kinds of flows in turn.
+ *
+ * @param source    The source of packets
+ * @param flows_nr  The number of flows
+ * @param kinds     The kinds of flows to generate
+ * @return          true if the flows were created, false otherwise
+ */
+static bool bench_flows_init(struct bench_source *const source,
+                             const size_t flows_nr,
+                             const bool kinds[BENCH_FLOW_KINDS_NR])
+{
+	bench_flow_kind_t kind = BENCH_FLOW_KINDS_NR - 1;
+	size_t i;
+
+	source->flows = calloc(flows_nr, sizeof(struct bench_flow));
+	if(source->flows == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu flows\n", flows_nr);
+		goto error;
+	}
+	source->flows_nr = flows_nr;
+
+	/* the payloads are always the same */
+	for(i = 0; i < BENCH_MAX_PKT_LEN; i++)
+	{
+		source->buf[i] = i & 0xff;
+	}
+
+	for(i = 0; i < flows_nr; i++)
+	{
+		/* next enabled kind of flow */
+		do
+		{
+			kind = (kind + 1) % BENCH_FLOW_KINDS_NR;
+		}
+		while(!kinds[kind]);
+
+		bench_flow_init(&source->flows[i], kind, i + 1);
+	}
+	source->next_flow_id = flows_nr + 1;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Start one synthetic flow
+ *
+ * The flows with different identifiers have different IPv4 source addresses
+ * and source ports, so that the compressor gives them different contexts.
+ *
+ * @param flow  The synthetic flow
+ * @param kind  The kind of flow
+ * @param id    The identifier of the flow, 1 for the first flow
+ */
+static void bench_flow_init(struct bench_flow *const flow,
+                            const bench_flow_kind_t kind,
+                            const uint32_t id)
+{
+	flow->kind = kind;
+	flow->saddr = 0x0a000000 | (id & 0x00ffffff);
+	flow->daddr = 0x0a800001;
+	flow->sport = 10000 + ((id - 1) % 50000);
+	flow->ip_id = bench_rand() & 0xffff;
+	flow->sn = bench_rand();
+	flow->ack = bench_rand();
+	flow->ts = bench_rand();
+	flow->id = bench_rand();
+	switch(kind)
+	{
+		case BENCH_FLOW_RTP:
+			flow->dport = BENCH_RTP_PORT;
+			flow->sn &= 0xffff;
+			break;
+		case BENCH_FLOW_TCP_BULK:
+		case BENCH_FLOW_TCP_ACK:
+			flow->dport = 80;
+			break;
+		case BENCH_FLOW_UDP:
+			flow->dport = 53;
+			break;
+		case BENCH_FLOW_ESP:
+		case BENCH_FLOW_IP:
+		case BENCH_FLOW_KINDS_NR:
+		default:
+			flow->dport = 0;
+			break;
+	}
+}
+
+
+/**
+ * @brief Build the Zipf cumulative popularity table of the synthetic flows
+ *
+ * The flow of rank k is accessed with a probability proportional to 1/k, so
+ * entry k-1 of the table holds the sum of 1/i for i from 1 to k.
+ * \ref bench_flow_pick searches the table to pick the flow of every packet.
+ *
+ * @param source  The source of packets with its synthetic flows
+ * @return        true if the table was built, false if memory is missing
+ */
+static bool bench_flows_zipf_init(struct bench_source *const source)
+{
+	double sum = 0;
+	size_t i;
+
+	source->flows_cdf = calloc(source->flows_nr, sizeof(double));
+	if(source->flows_cdf == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the popularity of %zu "
+		        "flows\n", source->flows_nr);
+		goto error;
+	}
+	for(i = 0; i < source->flows_nr; i++)
+	{
+		sum += 1.0 / (i + 1);
+		source->flows_cdf[i] = sum;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Pick the synthetic flow of the next packet
+ *
+ * @param source   The source of packets with its synthetic flows
+ * @param pkt_num  The number of the packet, starting at 0
+ * @return         The synthetic flow of the packet
+ */
+static struct bench_flow * bench_flow_pick(struct bench_source *const source,
+                                           const size_t pkt_num)
+{
+	size_t min = 0;
+	size_t max;
+	double target;
+
+	if(source->flows_cdf == NULL)
+	{
+		return &source->flows[pkt_num % source->flows_nr];
+	}
+
+	/* find the first flow whose cumulative popularity is above target */
+	target = (bench_rand() / 4294967296.0) * source->flows_cdf[source->flows_nr - 1];
+	max = source->flows_nr - 1;
+	while(min < max)
+	{
+		const size_t mid = (min + max) / 2;
+
+		if(source->flows_cdf[mid] <= target)
+		{
+			min = mid + 1;
+		}
+		else
+		{
+			max = mid;
+		}
+	}
+
+	return &source->flows[min];
+}
+
+
+/**
+ * @brief Build the next IP packet of the given synthetic flow
+ *
+ * Only the headers are written, the payload is already in the buffer.
+ *
+ * @param flow  The synthetic flow
+ * @param buf   The buffer for the IP packet
+ * @return      The length of the IP packet
+ */
+static size_t bench_flow_build(struct bench_flow *const flow,
+                               uint8_t *const buf)
+{
+	uint8_t *const l4 = buf + sizeof(struct ipv4_hdr);
+	uint16_t word16;
+	uint32_t word32;
+	size_t len;
+
+	switch(flow->kind)
+	{
+		case BENCH_FLOW_RTP:
+			/* IPv4/UDP/RTP with 160 bytes of G.711 every 20 ms */
+			len = sizeof(struct ipv4_hdr) + 8 + 12 + 160;
+			bench_ipv4_build(flow, buf, 17, len);
+			word16 = htons(flow->sport);
+			memcpy(l4, &word16, 2);
+			word16 = htons(flow->dport);
+			memcpy(l4 + 2, &word16, 2);
+			word16 = htons(len - sizeof(struct ipv4_hdr));
+			memcpy(l4 + 4, &word16, 2);
+			memset(l4 + 6, 0, 2);
+			l4[8] = 0x80; /* version 2 */
+			l4[9] = 8; /* PCMA */
+			word16 = htons(flow->sn);
+			memcpy(l4 + 10, &word16, 2);
+			word32 = htonl(flow->ts);
+			memcpy(l4 + 12, &word32, 4);
+			word32 = htonl(flow->id);
+			memcpy(l4 + 16, &word32, 4);
+			flow->sn = (flow->sn + 1) & 0xffff;
+			flow->ts += 160;
+			break;
+		case BENCH_FLOW_TCP_BULK:
+		case BENCH_FLOW_TCP_ACK:
+		{
+			/* IPv4/TCP with the Timestamp option, full segments or pure ACKs */
+			const bool is_bulk = (flow->kind == BENCH_FLOW_TCP_BULK);
+			const size_t payload_len = (is_bulk ? 1448 : 0);
+
+			len = sizeof(struct ipv4_hdr) + 32 + payload_len;
+			bench_ipv4_build(flow, buf, 6, len);
+			word16 = htons(flow->sport);
+			memcpy(l4, &word16, 2);
+			word16 = htons(flow->dport);
+			memcpy(l4 + 2, &word16, 2);
+			word32 = htonl(flow->sn);
+			memcpy(l4 + 4, &word32, 4);
+			word32 = htonl(flow->ack);
+			memcpy(l4 + 8, &word32, 4);
+			l4[12] = (32 / 4) << 4;
+			l4[13] = (is_bulk ? 0x18 : 0x10); /* ACK, and PSH for bulk */
+			word16 = htons(is_bulk ? 502 : 2048);
+			memcpy(l4 + 14, &word16, 2);
+			word16 = bench_rand() & 0xffff; /* checksum is not checked */
+			memcpy(l4 + 16, &word16, 2);
+			memset(l4 + 18, 0, 2);
+			l4[20] = 1; /* NOP */
+			l4[21] = 1; /* NOP */
+			l4[22] = 8; /* Timestamp */
+			l4[23] = 10;
+			word32 = htonl(flow->ts);
+			memcpy(l4 + 24, &word32, 4);
+			word32 = htonl(flow->ts - 10);
+			memcpy(l4 + 28, &word32, 4);
+			if(is_bulk)
+			{
+				flow->sn += payload_len;
+			}
+			else
+			{
+				flow->ack += 2 * 1448;
+			}
+			flow->ts++;
+			break;
+		}
+		case BENCH_FLOW_UDP:
+			/* IPv4/UDP with 120 bytes of payload */
+			len = sizeof(struct ipv4_hdr) + 8 + 120;
+			bench_ipv4_build(flow, buf, 17, len);
+			word16 = htons(flow->sport);
+			memcpy(l4, &word16, 2);
+			word16 = htons(flow->dport);
+			memcpy(l4 + 2, &word16, 2);
+			word16 = htons(len - sizeof(struct ipv4_hdr));
+			memcpy(l4 + 4, &word16, 2);
+			memset(l4 + 6, 0, 2);
+			break;
+		case BENCH_FLOW_ESP:
+			/* IPv4/ESP with 120 bytes of encrypted payload */
+			len = sizeof(struct ipv4_hdr) + 8 + 120;
+			bench_ipv4_build(flow, buf, 50, len);
+			word32 = htonl(flow->id);
+			memcpy(l4, &word32, 4);
+			word32 = htonl(flow->sn);
+			memcpy(l4 + 4, &word32, 4);
+			flow->sn++;
+			break;
+		case BENCH_FLOW_IP:
+		case BENCH_FLOW_KINDS_NR:
+		default:
+			/* IPv4 with 100 bytes of an unassigned protocol */
+			len = sizeof(struct ipv4_hdr) + 100;
+			bench_ipv4_build(flow, buf, 134, len);
+			break;
+	}
+	flow->ip_id++;
+
+	return len;
+}
+
+
+/**
+ * @brief Build the IPv4 header of one synthetic packet
+ *
+ * @param flow      The synthetic flow
+ * @param buf       The buffer for the IP packet
+ * @param protocol  The protocol of the IPv4 payload
+ * @param len       The length of the IP packet
+ */
+static void bench_ipv4_build(const struct bench_flow *const flow,
+                             uint8_t *const buf,
+                             const uint8_t protocol,
+                             const size_t len)
+{
+	struct ipv4_hdr ipv4;
+	uint32_t sum = 0;
+	size_t i;
+
+	ipv4.version = 4;
+	ipv4.ihl = 5;
+	ipv4.tos = 0;
+	ipv4.tot_len = htons(len);
+	ipv4.id = htons(flow->ip_id);
+	ipv4.frag_off = htons(0x4000); /* DF */
+	ipv4.ttl = 64;
+	ipv4.protocol = protocol;
+	ipv4.check = 0;
+	ipv4.saddr = htonl(flow->saddr);
+	ipv4.daddr = htonl(flow->daddr);
+	memcpy(buf, &ipv4, sizeof(struct ipv4_hdr));
+
+	/* compute the checksum in network byte order */
+	for(i = 0; i < sizeof(struct ipv4_hdr); i += 2)
+	{
+		sum += (buf[i] << 8) | buf[i + 1];
+	}
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	ipv4.check = htons(~sum & 0xffff);
+	memcpy(buf + 10, &ipv4.check, sizeof(uint16_t));
+}
+
+
+/**
+ * @brief Load all the IP packets of one PCAP capture in memory
+ *
+ * The packets are loaded before the benchmark starts, so that reading the
+ * capture is not measured.
+ *
+ * @param source    The source of packets
+ * @param filename  The name of the PCAP capture
+ * @return          true if the packets were loaded, false otherwise
+ */
+static bool bench_pcap_load(struct bench_source *const source,
+                            const char *const filename)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	pcap_t *handle;
+	int link_layer_type;
+	size_t link_len_base;
+	struct pcap_pkthdr header;
+	const unsigned char *packet;
+	size_t pkts_max = 0;
+
+	/* open the source PCAP file */
+	handle = pcap_open_offline(filename, errbuf);
+	if(handle == NULL)
+	{
+		fprintf(stderr, "failed to open the source pcap file: %s\n", errbuf);
+		goto error;
+	}
+
+	/* link layer in the source PCAP file must be Ethernet */
+	link_layer_type = pcap_datalink(handle);
+	if(link_layer_type == DLT_EN10MB)
+	{
+		link_len_base = ETHER_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_LINUX_SLL)
+	{
+		link_len_base = LINUX_COOKED_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_RAW)
+	{
+		link_len_base = 0;
+	}
+	else
+	{
+		fprintf(stderr, "link layer type %d not supported in source PCAP file "
+		        "(supported = %d, %d, %d)\n", link_layer_type, DLT_EN10MB,
+		        DLT_LINUX_SLL, DLT_RAW);
+		goto close_input;
+	}
+
+	while((packet = pcap_next(handle, &header)) != NULL)
+	{
+		const struct rohc_ts arrival_time = {
+			.sec = header.ts.tv_sec,
+			.nsec = header.ts.tv_usec * 1000
+		};
+		struct rohc_buf ip_packet =
+			rohc_buf_init_full((uint8_t *) packet, header.caplen, arrival_time);
+		size_t link_len = link_len_base;
+		struct bench_pkt *pkt;
+
+		/* check frame length */
+		if(header.len <= link_len || header.len != header.caplen)
+		{
+			fprintf(stderr, "packet #%zu: bad PCAP packet (len = %u, "
+			        "caplen = %u)\n", source->pkts_nr + 1, header.len,
+			        header.caplen);
+			goto free_pkts;
+		}
+
+		/* skip the link layer header (including VLAN headers) */
+		if(!detect_vlan_hdrs(&ip_packet, &link_len))
+		{
+			fprintf(stderr, "packet #%zu: malformed VLAN header\n",
+			        source->pkts_nr + 1);
+			goto free_pkts;
+		}
+		rohc_buf_pull(&ip_packet, link_len);
+
+		/* check for padding after the IP packet in the Ethernet payload */
+		if(link_len == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
+		{
+			uint8_t version;
+			uint16_t tot_len;
+
+			version = (rohc_buf_byte(ip_packet) >> 4) & 0x0f;
+			if(version == 4)
+			{
+				const struct ipv4_hdr *const ip =
+					(struct ipv4_hdr *) rohc_buf_data(ip_packet);
+				tot_len = ntohs(ip->tot_len);
+			}
+			else
+			{
+				const struct ipv6_hdr *const ip =
+					(struct ipv6_hdr *) rohc_buf_data(ip_packet);
+				tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
+			}
+
+			if(tot_len < ip_packet.len)
+			{
+				/* the Ethernet frame has some bytes of padding after the IP packet */
+				ip_packet.len = tot_len;
+			}
+		}
+
+		/* store the IP packet */
+		if(source->pkts_nr >= pkts_max)
+		{
+			const size_t new_max = (pkts_max == 0 ? 1024 : pkts_max * 2);
+			struct bench_pkt *const new_pkts =
+				realloc(source->pkts, new_max * sizeof(struct bench_pkt));
+			if(new_pkts == NULL)
+			{
+				fprintf(stderr, "failed to allocate memory for %zu packets\n",
+				        new_max);
+				goto free_pkts;
+			}
+			source->pkts = new_pkts;
+			pkts_max = new_max;
+		}
+		pkt = &source->pkts[source->pkts_nr];
+		pkt->data = malloc(ip_packet.len);
+		if(pkt->data == NULL)
+		{
+			fprintf(stderr, "failed to allocate memory for packet #%zu\n",
+			        source->pkts_nr + 1);
+			goto free_pkts;
+		}
+		memcpy(pkt->data, rohc_buf_data(ip_packet), ip_packet.len);
+		pkt->len = ip_packet.len;
+		pkt->time = arrival_time;
+		source->pkts_nr++;
+	}
+	if(source->pkts_nr == 0)
+	{
+		fprintf(stderr, "no packet found in the source pcap file\n");
+		goto close_input;
+	}
+
+	pcap_close(handle);
+	return true;
+
+free_pkts:
+	bench_source_free(source);
+close_input:
+	pcap_close(handle);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Detect 802.1q and 802.1ad headers
+ *
+ * @param frame             The frame in which VLAN headers shall be detected
+ * @param[in,out] link_len  in: the length of the link layer identified yet
+ *                          out: the length of the link layer including VLAN headers
+ * @return                  false if VLAN are malformed, true otherwise
+ */
+static bool detect_vlan_hdrs(const struct rohc_buf *const frame,
+                             size_t *const link_len)
+{
+	if((*link_len) == ETHER_HDR_LEN)
+	{
+		const struct ether_header *const eth_header =
+			(struct ether_header *) rohc_buf_data(*frame);
+		uint16_t proto_type = ntohs(eth_header->ether_type);
+
+		/* skip all 802.1q or 802.1ad headers */
+		while(proto_type == ETHERTYPE_8021Q || proto_type == ETHERTYPE_8021AD)
+		{
+			/* check min length */
+			if(frame->len < (*link_len) + sizeof(struct vlan_hdr))
+			{
+				fprintf(stderr, "truncated %zu-byte 802.1q or 802.1ad frame\n",
+				        frame->len);
+				goto error;
+			}
+
+			/* detect next header */
+			const struct vlan_hdr *const vlan_hdr =
+				(struct vlan_hdr *) rohc_buf_data_at(*frame, (*link_len));
+			proto_type = ntohs(vlan_hdr->type);
+
+			/* skip VLAN header */
+			(*link_len) += sizeof(struct vlan_hdr);
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Free the synthetic flows or the packets read from a capture
+ *
+ * @param source  The source of packets
+ */
+static void bench_source_free(struct bench_source *const source)
+{
+	size_t i;
+
+	for(i = 0; i < source->pkts_nr; i++)
+	{
+		free(source->pkts[i].data);
+	}
+	free(source->pkts);
+	source->pkts = NULL;
+	source->pkts_nr = 0;
+	free(source->flows);
+	source->flows = NULL;
+	source->flows_nr = 0;
+	free(source->flows_cdf);
+	source->flows_cdf = NULL;
+}
+
+
+/**
+ * @brief Record one latency sample
+ *
+ * @param samples  The set of samples
+ * @param ns       The latency (in nanoseconds)
+ * @return         true if the sample was recorded, false if memory is missing
+ */
+static bool bench_samples_add(struct bench_samples *const samples,
+                              const uint64_t ns)
+{
+	if(samples->nr >= samples->max)
+	{
+		const size_t new_max = (samples->max == 0 ? 1024 : samples->max * 2);
+		uint32_t *const new_ns = realloc(samples->ns, new_max * sizeof(uint32_t));
+		if(new_ns == NULL)
+		{
+			fprintf(stderr, "failed to allocate memory for %zu samples\n",
+			        new_max);
+			goto error;
+		}
+		samples->ns = new_ns;
+		samples->max = new_max;
+	}
+	samples->ns[samples->nr] = (ns > UINT32_MAX ? UINT32_MAX : ns);
+	samples->nr++;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Record the latency of one packet for one category of packets
+ *
+ * @param stats    The measures for the category of packets
+ * @param is_comp  Whether the packet was compressed or decompressed
+ * @param ns       The latency (in nanoseconds)
+ * @return         true if the latency was recorded, false if memory is
+ *                 missing
+ */
+static bool bench_stats_add(struct bench_stats *const stats,
+                            const bool is_comp,
+                            const uint64_t ns)
+{
+	if(is_comp)
+	{
+		stats->comp_nr++;
+		return bench_samples_add(&stats->comp_ns, ns);
+	}
+	else
+	{
+		stats->decomp_nr++;
+		return bench_samples_add(&stats->decomp_ns, ns);
+	}
+}
+
+
+/**
+ * @brief Free the latency samples of one category of packets
+ *
+ * @param stats  The measures for the category of packets
+ */
+static void bench_stats_free(struct bench_stats *const stats)
+{
+	free(stats->comp_ns.ns);
+	free(stats->decomp_ns.ns);
+}
+
+
+/**
+ * @brief Print the results of the benchmark
+ *
+ * @param results  The measures of the benchmark
+ */
+static void bench_results_print(struct bench_results *const results)
+{
+	const struct bench_stats *const total = &results->total;
+	uint64_t comp_ns = 0;
+	uint64_t decomp_ns = 0;
+	size_t i;
+
+	for(i = 0; i < total->comp_ns.nr; i++)
+	{
+		comp_ns += total->comp_ns.ns[i];
+	}
+	for(i = 0; i < total->decomp_ns.nr; i++)
+	{
+		decomp_ns += total->decomp_ns.ns[i];
+	}
+
+	printf("packets:        %zu compressed, %zu compression failures\n",
+	       total->comp_nr, results->comp_failures);
+	printf("channel:        %zu lost, %zu reordered\n", results->lost,
+	       results->reordered);
+	printf("packets:        %zu decompressed, %zu decompression failures, "
+	       "%zu damaged\n", total->decomp_nr, results->decomp_failures,
+	       results->decomp_damaged);
+	if(results->mode == ROHC_O_MODE)
+	{
+		printf("feedbacks:      %zu delivered to the compressor, %" PRIu64 " "
+		       "bytes\n", results->feedbacks_nr, results->feedbacks_len);
+	}
+	if(comp_ns > 0)
+	{
+		printf("compression:    %.0f packets/s, %.1f ns/packet\n",
+		       total->comp_nr * 1e9 / comp_ns,
+		       ((double) comp_ns) / total->comp_nr);
+	}
+	if(decomp_ns > 0)
+	{
+		printf("decompression:  %.0f packets/s, %.1f ns/packet\n",
+		       total->decomp_nr * 1e9 / decomp_ns,
+		       ((double) decomp_ns) / total->decomp_nr);
+	}
+	if(results->wall_ns > 0)
+	{
+		printf("end-to-end:     %.0f packets/s (traffic generation and checks "
+		       "included)\n", total->comp_nr * 1e9 / results->wall_ns);
+	}
+	printf("headers:        %" PRIu64 " bytes compressed into %" PRIu64 " bytes, "
+	       "%" PRId64 " bytes saved\n", total->uncomp_hdr_len,
+	       total->comp_hdr_len,
+	       (int64_t) (total->uncomp_hdr_len - total->comp_hdr_len));
+	printf("packets:        %" PRIu64 " bytes compressed into %" PRIu64 " "
+	       "bytes\n", total->uncomp_len, total->comp_len);
+
+	printf("\n%-22s %9s %9s %7s   %-23s   %-23s\n", "", "", "", "saved",
+	       "compression (ns)", "decompression (ns)");
+	printf("%-22s %9s %9s %7s   %7s %7s %7s   %7s %7s %7s\n", "per profile",
+	       "comp", "decomp", "bytes", "p50", "p90", "p99", "p50", "p90", "p99");
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(results->profiles[i].comp_nr > 0)
+		{
+			bench_stats_print(rohc_get_profile_descr(i), &results->profiles[i]);
+		}
+	}
+	printf("\n%-22s %9s %9s %7s   %7s %7s %7s   %7s %7s %7s\n", "per packet type",
+	       "comp", "decomp", "bytes", "p50", "p90", "p99", "p50", "p90", "p99");
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		if(results->types[i].comp_nr > 0)
+		{
+			bench_stats_print(rohc_get_packet_descr(i), &results->types[i]);
+		}
+	}
+	bench_stats_print("all", &results->total);
+}
+
+
+/**
+ * @brief Print the measures of one category of packets
+ *
+ * @param name   The name of the category of packets
+ * @param stats  The measures for the category of packets
+ */
+static void bench_stats_print(const char *const name,
+                              struct bench_stats *const stats)
+{
+	const double saved_per_pkt =
+		((double) (int64_t) (stats->uncomp_hdr_len - stats->comp_hdr_len)) /
+		stats->comp_nr;
+
+	qsort(stats->comp_ns.ns, stats->comp_ns.nr, sizeof(uint32_t),
+	      bench_samples_cmp);
+	qsort(stats->decomp_ns.ns, stats->decomp_ns.nr, sizeof(uint32_t),
+	      bench_samples_cmp);
+
+	printf("%-22.22s %9zu %9zu %7.1f   %7u %7u %7u   %7u %7u %7u\n", name,
+	       stats->comp_nr, stats->decomp_nr, saved_per_pkt,
+	       bench_samples_percentile(&stats->comp_ns, 50),
+	       bench_samples_percentile(&stats->comp_ns, 90),
+	       bench_samples_percentile(&stats->comp_ns, 99),
+	       bench_samples_percentile(&stats->decomp_ns, 50),
+	       bench_samples_percentile(&stats->decomp_ns, 90),
+	       bench_samples_percentile(&stats->decomp_ns, 99));
+}
+
+
+/**
+ * @brief Print the memory used by the compressor and the decompressor
+ *
+ * The memory is broken down per profile, then per subsystem. The cost of one
+ * context of a profile is the memory used by all the contexts of the profile
+ * divided by their number; the generic parts of the compression contexts are
+ * allocated for all the CIDs at once, so they are reported apart.
+ *
+ * @param results  The measures of the benchmark
+ */
+static void bench_mem_print(const struct bench_results *const results)
+{
+	const rohc_comp_memory_usage_t *const comp_mem = &results->comp_mem;
+	const rohc_decomp_memory_usage_t *const decomp_mem = &results->decomp_mem;
+	size_t comp_ctxts_nr = 0;
+	size_t decomp_ctxts_nr = 0;
+	size_t i;
+
+	printf("\nmemory:         compressor %zu bytes, decompressor %zu bytes\n",
+	       comp_mem->total_mem, decomp_mem->total_mem);
+
+	printf("\n%-22s %9s %10s %9s %10s %10s %10s %10s\n", "compressor",
+	       "contexts", "bytes", "per ctxt", "specific", "IP ctxts", "lists",
+	       "W-LSB");
+	for(i = 0; i < comp_mem->profiles_nr; i++)
+	{
+		const rohc_comp_profile_memory_usage_t *const profile =
+			&comp_mem->profiles[i];
+		const size_t mem = profile->specific_mem + profile->wlsb_mem;
+
+		printf("%-22s %9zu %10zu %9zu %10zu %10zu %10zu %10zu\n",
+		       rohc_get_profile_descr(profile->profile), profile->contexts_nr,
+		       mem, (profile->contexts_nr > 0 ? mem / profile->contexts_nr : 0),
+		       profile->specific_mem, profile->ip_ctxts_mem, profile->lists_mem,
+		       profile->wlsb_mem);
+		comp_ctxts_nr += profile->contexts_nr;
+	}
+	printf("%-22s %9s %10zu\n", "compressor object", "", comp_mem->comp_mem);
+	printf("%-22s %9s %10zu\n", "generic contexts", "", comp_mem->contexts_mem);
+	printf("%-22s %9s %10zu\n", "MRRU buffer", "", comp_mem->rru_mem);
+	printf("%-22s %9zu %10zu %9zu\n", "all", comp_ctxts_nr, comp_mem->total_mem,
+	       (comp_ctxts_nr > 0 ? comp_mem->total_mem / comp_ctxts_nr : 0));
+
+	printf("\n%-22s %9s %10s %9s %10s %10s %10s\n", "decompressor",
+	       "contexts", "bytes", "per ctxt", "generic", "specific", "scratch");
+	for(i = 0; i < decomp_mem->profiles_nr; i++)
+	{
+		const rohc_decomp_profile_memory_usage_t *const profile =
+			&decomp_mem->profiles[i];
+		const size_t mem =
+			profile->contexts_mem + profile->specific_mem + profile->scratch_mem;
+
+		printf("%-22s %9zu %10zu %9zu %10zu %10zu %10zu\n",
+		       rohc_get_profile_descr(profile->profile), profile->contexts_nr,
+		       mem, (profile->contexts_nr > 0 ?
+		             (profile->contexts_mem + profile->specific_mem) /
+		             profile->contexts_nr : 0),
+		       profile->contexts_mem, profile->specific_mem, profile->scratch_mem);
+		decomp_ctxts_nr += profile->contexts_nr;
+	}
+	printf("%-22s %9s %10zu\n", "decompressor object", "", decomp_mem->decomp_mem);
+	printf("%-22s %9s %10zu\n", "array of contexts", "", decomp_mem->contexts_mem);
+	printf("%-22s %9s %10zu\n", "pool of contexts", "", decomp_mem->pool_mem);
+	printf("%-22s %9s %10zu\n", "MRRU buffer", "", decomp_mem->rru_mem);
+	printf("%-22s %9zu %10zu %9zu\n", "all", decomp_ctxts_nr,
+	       decomp_mem->total_mem,
+	       (decomp_ctxts_nr > 0 ? decomp_mem->total_mem / decomp_ctxts_nr : 0));
+}
+
+
+/**
+ * @brief Get one percentile of the given sorted latency samples
+ *
+ * @param samples     The sorted latency samples
+ * @param percentile  The percentile to get, in range [0, 100]
+ * @return            The latency (in nanoseconds), 0 if there is no sample
+ */
+static uint32_t bench_samples_percentile(const struct bench_samples *const samples,
+                                         const unsigned int percentile)
+{
+	size_t pos;
+
+	if(samples->nr == 0)
+	{
+		return 0;
+	}
+
+	pos = (samples->nr * percentile) / 100;
+	if(pos >= samples->nr)
+	{
+		pos = samples->nr - 1;
+	}
+
+	return samples->ns[pos];
+}
+
+
+/**
+ * @brief Compare two latency samples for qsort(3)
+ *
+ * @param sample1  The first latency sample
+ * @param sample2  The second latency sample
+ * @return         A negative, zero, or positive value if the first latency is
+ *                 lower, equal, or greater than the second one
+ */
+static int bench_samples_cmp(const void *const sample1,
+                             const void *const sample2)
+{
+	const uint32_t ns1 = *((const uint32_t *) sample1);
+	const uint32_t ns2 = *((const uint32_t *) sample2);
+
+	return (ns1 > ns2) - (ns1 < ns2);
+}
+
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (in nanoseconds)
+ */
+static uint64_t bench_now(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t) now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+
+/**
+ * @brief Advance the arrival time by the delay between two synthetic packets
+ *
+ * @param time  The arrival time of the previous synthetic packet
+ */
+static void bench_ts_next(struct rohc_ts *const time)
+{
+	time->nsec += BENCH_PKT_INTERVAL;
+	if(time->nsec >= 1000000000)
+	{
+		time->sec++;
+		time->nsec -= 1000000000;
+	}
+}
+
+
+/**
+ * @brief Get the resident memory of the process
+ *
+ * @return  The resident memory (in bytes), -1 if not available
+ */
+static int64_t bench_rss(void)
+{
+#if HAVE_UNISTD_H == 1
+	FILE *statm;
+	unsigned long size;
+	unsigned long resident;
+	int ret;
+
+	statm = fopen("/proc/self/statm", "r");
+	if(statm == NULL)
+	{
+		return -1;
+	}
+	ret = fscanf(statm, "%lu %lu", &size, &resident);
+	fclose(statm);
+	if(ret != 2)
+	{
+		return -1;
+	}
+
+	return ((int64_t) resident) * sysconf(_SC_PAGESIZE);
+#else
+	return -1;
+#endif
+}
+
+
+/**
+ * @brief Open the counter of the LLC misses of the calling thread
+ *
+ * Only the misses in user space are counted, so that the system calls
+ * that read the counter are not measured.
+ *
+ * @return  The counter of LLC misses, -1 if not available
+ */
+static int bench_llc_open(void)
+{
+#ifdef BENCH_HAVE_PERF_EVENT
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(struct perf_event_attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(struct perf_event_attr);
+	attr.config = PERF_COUNT_HW_CACHE_MISSES;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	/* the calling thread on any CPU */
+	return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+	return -1;
+#endif
+}
+
+
+/**
+ * @brief Read the counter of LLC misses
+ *
+ * @param llc_fd  The counter of LLC misses, -1 if not available
+ * @return        The number of LLC misses so far, 0 if not available
+ */
+static uint64_t bench_llc_read(const int llc_fd)
+{
+	uint64_t count = 0;
+
+#ifdef BENCH_HAVE_PERF_EVENT
+	if(llc_fd >= 0 && read(llc_fd, &count, sizeof(uint64_t)) != sizeof(uint64_t))
+	{
+		count = 0;
+	}
+#endif
+
+	return count;
+}
+
+
+/**
+ * @brief Generate a pseudo-random number for the channel and the flows
+ *
+ * The generator (xorshift32) does not depend on the one of the C library,
+ * so that the compressor does not change the losses of the channel.
+ *
+ * @return  The pseudo-random number
+ */
+static uint32_t bench_rand(void)
+{
+	uint32_t x = bench_rand_state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	bench_rand_state = x;
+
+	return x;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
+                              const rohc_trace_level_t level __attribute__((unused)),
+                              const rohc_trace_entity_t entity __attribute__((unused)),
+                              const int profile __attribute__((unused)),
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
+
+
+/**
+ * @brief The RTP detection callback
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip __attribute__((unused)),
+                             const unsigned char *const udp,
+                             const unsigned char *const payload __attribute__((unused)),
+                             const unsigned int payload_size __attribute__((unused)),
+                             void *const rtp_private __attribute__((unused)))
+{
+	const size_t default_rtp_ports_nr = 5;
+	unsigned int default_rtp_ports[] = { 1234, 36780, 33238, 5020, 5002 };
+	uint16_t udp_dport;
+	bool is_rtp = false;
+	size_t i;
+
+	if(udp == NULL)
+	{
+		return false;
+	}
+
+	/* get the UDP destination port */
+	memcpy(&udp_dport, udp + 2, sizeof(uint16_t));
+
+	/* is the UDP destination port in the list of ports reserved for RTP
+	 * traffic by default (for compatibility reasons) */
+	for(i = 0; i < default_rtp_ports_nr; i++)
+	{
+		if(ntohs(udp_dport) == default_rtp_ports[i])
+		{
+			is_rtp = true;
+			break;
+		}
+	}
+
+	return is_rtp;
+}
+
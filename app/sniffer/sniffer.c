@@ -31,6 +31,15 @@
  *   the ROHC library with them. The packets are compressed, then decompressed,
  *   and finally compared with the original IP packets.
  *
+ * Threads:
+ *   One capture thread reads the packets from the network interface in
+ *   batches (pcap_dispatch with a large kernel buffer), and dispatches them
+ *   to several worker threads through lock-free ring buffers. Every worker
+ *   owns one compressor/decompressor pair and handles all the packets of a
+ *   partition of the flows (hash of the IP addresses and ports), so the
+ *   packets of one flow are processed in order by one single pair. Every
+ *   worker keeps its own statistics, they are summed up when printed.
+ *
  * Statistics:
  *   Some statistics are gathered during the tests. There are printed on the
  *   console. More stats should be added. A better way to export them remains to
@@ -62,6 +71,8 @@
 #include <unistd.h>
 #include <signal.h>
 #include <syslog.h>
+#include <time.h>
+#include <pthread.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <fcntl.h>
@@ -121,6 +132,40 @@ struct ether_header
 /** The Ethertype for the IPv6 protocol */
 #define ETHERTYPE_IPV6  0x86ddU
 
+/** The default number of worker threads */
+#define SNIFFER_WORKERS_DEFAULT  1U
+/** The maximum number of worker threads */
+#define SNIFFER_WORKERS_MAX  64U
+
+/** The default size (in MB) of the kernel buffer for captured packets */
+#define SNIFFER_CAPTURE_BUF_DEFAULT  64U
+/** The maximum size (in MB) of the kernel buffer for captured packets */
+#define SNIFFER_CAPTURE_BUF_MAX  2047U
+/** The capture timeout (in ms), signals are checked at least that often */
+#define SNIFFER_CAPTURE_TIMEOUT  100
+
+/** The size (in bytes) of the capture ring of one worker, a power of 2 */
+#define SNIFFER_CAPTURE_RING_SIZE  (16U * 1024U * 1024U)
+/** The size (in bytes) of the dump ring of one worker, a power of 2 */
+#define SNIFFER_DUMP_RING_SIZE  (4U * 1024U * 1024U)
+/** The time (in ns) a thread sleeps when its ring buffers are empty */
+#define SNIFFER_RING_IDLE_NS  50000L
+
+/** The default maximum number of dump files open at the same time */
+#define SNIFFER_DUMP_FILES_DEFAULT  128U
+/** The maximum number of dump files open at the same time */
+#define SNIFFER_DUMP_FILES_MAX  65536U
+/** The time (in ms) a failing worker waits for its packets to be dumped */
+#define SNIFFER_DUMP_SYNC_TIMEOUT  5000U
+
+/** The number of packets a worker handles before it publishes its stats */
+#define SNIFFER_STATS_PERIOD  64U
+
+/** The maximum number of traces to keep */
+#define MAX_LAST_TRACES  5000
+/** The maximum length of a trace */
+#define MAX_TRACE_LEN  300
+
 
 /** Some statistics collected by the sniffer */
 struct sniffer_stats_t
@@ -174,6 +219,163 @@ struct sniffer_stats_t
 };
 
 
+/** The operations recorded in the ring buffers */
+typedef enum
+{
+	/** A captured packet to compress/decompress */
+	SNIFFER_OP_PKT      = 0,
+	/** A packet that starts a new stream, its dump file is truncated */
+	SNIFFER_OP_DUMP_NEW = 1,
+	/** A packet to append to the dump file of its stream */
+	SNIFFER_OP_DUMP_PKT = 2,
+	/** A request to write all pending packets to the dump files */
+	SNIFFER_OP_DUMP_SYNC = 3
+} sniffer_op_t;
+
+
+/** One packet stored in a ring buffer */
+struct sniffer_ring_pkt
+{
+	/** The length (in bytes) of the record in the ring, 0 to wrap around */
+	size_t rec_len;
+	/** The operation to perform on the packet */
+	sniffer_op_t op;
+	/** The ID of the context the packet belongs to (dump operations only) */
+	unsigned int cid;
+	/** The PCAP header of the packet */
+	struct pcap_pkthdr header;
+	/** The packet itself (link layer included) */
+	unsigned char data[];
+};
+
+
+/** A lock-free ring buffer of packets with one producer and one consumer */
+struct sniffer_ring
+{
+	/** The memory of the ring buffer */
+	unsigned char *buf;
+	/** The size (in bytes) of the ring buffer, a power of 2 */
+	size_t size;
+	/** The position of the next packet to write, updated by the producer */
+	size_t head;
+	/** The number of packets dropped because the ring buffer was full,
+	 *  updated by the producer */
+	unsigned long drops;
+	/** The position of the next packet to read, updated by the consumer */
+	size_t tail __attribute__((aligned(64)));
+};
+
+
+/** The dump file of one stream, managed by the writer thread only */
+struct sniffer_dump_stream
+{
+	/** The PCAP dumper if the dump file is open, NULL otherwise */
+	pcap_dumper_t *dumper;
+	/** Whether the dump file was already created or not */
+	bool is_created;
+	/** The more recently used open dump file */
+	struct sniffer_dump_stream *lru_prev;
+	/** The less recently used open dump file */
+	struct sniffer_dump_stream *lru_next;
+};
+
+
+/** One worker thread that compresses/decompresses a partition of the flows */
+struct sniffer_worker
+{
+	/** The ID of the worker */
+	size_t id;
+	/** The thread of the worker */
+	pthread_t thread;
+	/** Whether the thread of the worker is running or not */
+	bool is_started;
+	/** Whether the worker shall stop once its ring buffer is empty */
+	bool do_stop;
+
+	/** The PCAP handler that sniffs the packets */
+	pcap_t *handle;
+	/** The length of the link layer header before IP data */
+	size_t link_len_src;
+
+	/** The ROHC compressor of the worker */
+	struct rohc_comp *comp;
+	/** The ROHC decompressor of the worker */
+	struct rohc_decomp *decomp;
+
+	/** The prefix of the names of the PCAP dump files */
+	char dump_prefix[64];
+	/** The dump files of the worker, one per context */
+	struct sniffer_dump_stream *dump_streams;
+	/** The number of dump files */
+	size_t dump_streams_nr;
+	/** The position in the dump ring up to which the packets were written
+	 *  to the dump files, updated by the writer thread */
+	size_t dump_synced;
+
+	/** The ring buffer for the last traces of the worker */
+	char (*last_traces)[MAX_TRACE_LEN + 1];
+	/** The index of the first trace */
+	int last_traces_first;
+	/** The index of the last trace */
+	int last_traces_last;
+
+	/** The packets captured for the worker */
+	struct sniffer_ring capture_ring;
+	/** The packets to dump, written by the worker for the writer thread */
+	struct sniffer_ring dump_ring;
+
+	/** The statistics of the worker, updated by the worker only */
+	struct sniffer_stats_t stats __attribute__((aligned(64)));
+
+	/** The last statistics published by the worker for other threads */
+	struct sniffer_stats_t stats_pub __attribute__((aligned(64)));
+	/** The sequence number of the published statistics, odd while updated */
+	size_t stats_seq;
+};
+
+
+/** The writer thread that saves the packets of the streams in dump files */
+struct sniffer_dump_writer
+{
+	/** The thread of the writer */
+	pthread_t thread;
+	/** Whether the thread of the writer is running or not */
+	bool is_started;
+	/** Whether the writer shall stop once all the dump rings are empty */
+	bool do_stop;
+
+	/** The PCAP handler that sniffs the packets */
+	pcap_t *handle;
+	/** The workers that produce the packets to dump */
+	struct sniffer_worker *workers;
+	/** The number of workers */
+	size_t workers_nr;
+
+	/** The maximum number of dump files open at the same time */
+	size_t open_max;
+	/** The number of dump files currently open */
+	size_t open_nr;
+	/** The most recently used open dump file */
+	struct sniffer_dump_stream *lru_first;
+	/** The least recently used open dump file */
+	struct sniffer_dump_stream *lru_last;
+	/** The number of dump files closed to open other ones */
+	unsigned long evictions_nr;
+};
+
+
+/** The context of the capture thread */
+struct sniffer_capture
+{
+	/** The workers the captured packets are dispatched to */
+	struct sniffer_worker *workers;
+	/** The number of workers */
+	size_t workers_nr;
+	/** The length of the link layer header before IP data */
+	size_t link_len_src;
+};
+
+
 /* prototypes of private functions */
 
 static void usage(void);
@@ -185,22 +387,86 @@ static bool parse_args(int argc,
                        const char **const pidfilename,
                        int *const max_contexts,
                        int enabled_profiles[ROHC_PROFILE_MAX],
+                       size_t *const workers_nr,
+                       size_t *const capture_buf_size,
+                       size_t *const dump_files_max,
                        rohc_cid_type_t *const cid_type,
                        const char **const device_name)
-	__attribute__((warn_unused_result, nonnull(2, 3, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(2, 3, 4, 5, 6, 7, 8, 9, 10)));
 
 static bool sniff(const rohc_cid_type_t cid_type,
                   const size_t max_contexts,
                   const int enabled_profiles[],
+                  const size_t workers_nr,
+                  const size_t capture_buf_size,
+                  const size_t dump_files_max,
                   const char *const device_name)
-	__attribute__((warn_unused_result, nonnull(4)));
+	__attribute__((warn_unused_result, nonnull(3, 7)));
+static void sniffer_dispatch_pkt(u_char *const user,
+                                 const struct pcap_pkthdr *const header,
+                                 const u_char *const packet)
+	__attribute__((nonnull(1, 2, 3)));
+static size_t sniffer_flow_hash(const unsigned char *const packet,
+                                const size_t len,
+                                const size_t link_len_src)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static bool sniffer_ring_init(struct sniffer_ring *const ring,
+                              const size_t size)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool sniffer_ring_push(struct sniffer_ring *const ring,
+                              const sniffer_op_t op,
+                              const unsigned int cid,
+                              const struct pcap_pkthdr *const header,
+                              const unsigned char *const packet)
+	__attribute__((nonnull(1, 4)));
+static struct sniffer_ring_pkt * sniffer_ring_peek(struct sniffer_ring *const ring)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void sniffer_ring_pop(struct sniffer_ring *const ring,
+                             const struct sniffer_ring_pkt *const rec)
+	__attribute__((nonnull(1, 2)));
+
+static bool sniffer_worker_init(struct sniffer_worker *const worker,
+                                const size_t worker_id,
+                                const size_t workers_nr,
+                                const rohc_cid_type_t cid_type,
+                                const size_t max_contexts,
+                                const int enabled_profiles[],
+                                pcap_t *const handle,
+                                const size_t link_len_src)
+	__attribute__((warn_unused_result, nonnull(1, 6, 7)));
+static void sniffer_worker_free(struct sniffer_worker *const worker)
+	__attribute__((nonnull(1)));
+static void * sniffer_worker_run(void *const arg)
+	__attribute__((nonnull(1)));
+static void sniffer_worker_publish_stats(struct sniffer_worker *const worker)
+	__attribute__((nonnull(1)));
+
+static void sniffer_dump_sync(struct sniffer_worker *const worker)
+	__attribute__((nonnull(1)));
+static void * sniffer_dump_writer_run(void *const arg)
+	__attribute__((nonnull(1)));
+static void sniffer_dump_writer_handle(struct sniffer_dump_writer *const writer,
+                                       const struct sniffer_worker *const worker,
+                                       const struct sniffer_ring_pkt *const rec)
+	__attribute__((nonnull(1, 2, 3)));
+static void sniffer_dump_writer_close(struct sniffer_dump_writer *const writer,
+                                      struct sniffer_dump_stream *const stream)
+	__attribute__((nonnull(1, 2)));
+
+static void sniffer_collect_stats(struct sniffer_stats_t *const stats)
+	__attribute__((nonnull(1)));
+static void sniffer_print_last_traces(const struct sniffer_worker *const worker)
+	__attribute__((nonnull(1)));
+
 static int compress_decompress(struct rohc_comp *comp,
                                struct rohc_decomp *decomp,
                                struct pcap_pkthdr header,
                                unsigned char *packet,
                                size_t link_len_src,
                                pcap_t *handle,
-                               pcap_dumper_t *dumpers[],
+                               struct sniffer_ring *const dump_ring,
+                               const char *const dump_prefix,
                                struct rohc_buf *const feedback_send,
                                unsigned int *const cid,
                                struct sniffer_stats_t *stats);
@@ -238,8 +504,19 @@ static bool write_pid_file(const char *const path)
 /** Whether the application shall stop or not */
 static bool stop_program;
 
-/** Some statistics collected by the sniffer */
-static struct sniffer_stats_t sniffer_stats;
+/** The PCAP handler that sniffs the packets */
+static pcap_t *sniffer_handle = NULL;
+
+/** The number of packets captured so far */
+static unsigned long sniffer_captured_nr;
+
+/** The workers that compress/decompress the captured packets */
+static struct sniffer_worker *sniffer_workers = NULL;
+/** The number of workers */
+static size_t sniffer_workers_nr = 0;
+
+/** The writer thread that saves the packets in dump files */
+static struct sniffer_dump_writer *sniffer_writer = NULL;
 
 /** Whether the application runs in daemon mode or not */
 static bool is_daemon;
@@ -250,21 +527,6 @@ static bool is_verbose;
 /** Whether the application prints stats at regular interval of time or not */
 static bool do_print_stat;
 
-/** The PCAP dumpers */
-static pcap_dumper_t *sniffer_dumpers[ROHC_LARGE_CID_MAX + 1] = { 0 };
-
-/** The maximum number of traces to keep */
-#define MAX_LAST_TRACES  5000
-/** The maximum length of a trace */
-#define MAX_TRACE_LEN  300
-
-/** The ring buffer for the last traces */
-static char last_traces[MAX_LAST_TRACES][MAX_LAST_TRACES + 1];
-/** The index of the first trace */
-static int last_traces_first;
-/** The index of the last trace */
-static int last_traces_last;
-
 /** Whether to print traces on stderr or not */
 static bool do_print_stderr = true;
 
@@ -299,16 +561,17 @@ int main(int argc, char *argv[])
 	bool pidfile_created = false;
 	const char *device_name;
 	int max_contexts;
+	size_t workers_nr;
+	size_t capture_buf_size;
+	size_t dump_files_max;
 	rohc_cid_type_t cid_type;
 	int ret;
-	int i;
 
 	/* by default, we don't stop */
 	stop_program = false;
 
-	/* reset stats */
-	memset(&sniffer_stats, 0, sizeof(struct sniffer_stats_t));
-	sniffer_stats.comp_unit_size = 1;
+	/* no packet captured yet */
+	sniffer_captured_nr = 0;
 
 	/* set to quiet mode by default */
 	is_verbose = false;
@@ -317,20 +580,13 @@ int main(int argc, char *argv[])
 	/* disable daemon mode by default */
 	is_daemon = false;
 
-	/* no traces at the moment */
-	for(i = 0; i < MAX_LAST_TRACES; i++)
-	{
-		last_traces[i][0] = '\0';
-	}
-	last_traces_first = -1;
-	last_traces_last = -1;
-
 	/* traces go to syslog */
 	openlog("rohc_sniffer", LOG_PID, LOG_USER);
 
 	/* parse program arguments, print the help message in case of failure */
 	if(!parse_args(argc, argv, &pidfilename, &max_contexts, enabled_profiles,
-	               &cid_type, &device_name))
+	               &workers_nr, &capture_buf_size, &dump_files_max, &cid_type,
+	               &device_name))
 	{
 		goto error;
 	}
@@ -394,7 +650,8 @@ int main(int argc, char *argv[])
 	}
 
 	/* test ROHC compression/decompression with the packets from the file */
-	if(!sniff(cid_type, max_contexts, enabled_profiles, device_name))
+	if(!sniff(cid_type, max_contexts, enabled_profiles, workers_nr,
+	          capture_buf_size, dump_files_max, device_name))
 	{
 		goto error;
 	}
@@ -430,15 +687,26 @@ error:
 /**
  * @brief Parse the command line arguments of the program
  *
- * @param argc  The number of program arguments
- * @param argv  The program arguments
- * @return      true of arguments are valid, false otherwise
+ * @param argc                   The number of program arguments
+ * @param argv                   The program arguments
+ * @param[out] pidfilename       The path of the PID file, NULL if none
+ * @param[out] max_contexts      The maximum number of ROHC contexts per worker
+ * @param[out] enabled_profiles  The ROHC profiles to enable/disable
+ * @param[out] workers_nr        The number of worker threads
+ * @param[out] capture_buf_size  The size (in MB) of the kernel capture buffer
+ * @param[out] dump_files_max    The maximum number of open dump files
+ * @param[out] cid_type          The type of CIDs to use
+ * @param[out] device_name       The name of the network device
+ * @return                       true of arguments are valid, false otherwise
  */
 static bool parse_args(int argc,
                        char *argv[],
                        const char **const pidfilename,
                        int *const max_contexts,
                        int enabled_profiles[ROHC_PROFILE_MAX],
+                       size_t *const workers_nr,
+                       size_t *const capture_buf_size,
+                       size_t *const dump_files_max,
                        rohc_cid_type_t *const cid_type,
                        const char **const device_name)
 {
@@ -448,6 +716,9 @@ static bool parse_args(int argc,
 	int i;
 
 	*max_contexts = ROHC_SMALL_CID_MAX + 1;
+	*workers_nr = SNIFFER_WORKERS_DEFAULT;
+	*capture_buf_size = SNIFFER_CAPTURE_BUF_DEFAULT;
+	*dump_files_max = SNIFFER_DUMP_FILES_DEFAULT;
 	*pidfilename = NULL;
 	*device_name = NULL;
 
@@ -524,6 +795,71 @@ static bool parse_args(int argc,
 			*max_contexts = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--workers"))
+		{
+			/* get the number of worker threads */
+			int value;
+			if(argc <= 1)
+			{
+				SNIFFER_LOG(LOG_WARNING, "option --workers takes one argument");
+				usage();
+				goto error;
+			}
+			value = atoi(argv[1]);
+			if(value < 1 || ((unsigned int) value) > SNIFFER_WORKERS_MAX)
+			{
+				SNIFFER_LOG(LOG_WARNING, "the number of workers should be between "
+				            "1 and %u", SNIFFER_WORKERS_MAX);
+				usage();
+				goto error;
+			}
+			*workers_nr = value;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--capture-buffer"))
+		{
+			/* get the size of the kernel capture buffer */
+			int value;
+			if(argc <= 1)
+			{
+				SNIFFER_LOG(LOG_WARNING, "option --capture-buffer takes one "
+				            "argument");
+				usage();
+				goto error;
+			}
+			value = atoi(argv[1]);
+			if(value < 1 || ((unsigned int) value) > SNIFFER_CAPTURE_BUF_MAX)
+			{
+				SNIFFER_LOG(LOG_WARNING, "the size of the capture buffer should "
+				            "be between 1 and %u MB", SNIFFER_CAPTURE_BUF_MAX);
+				usage();
+				goto error;
+			}
+			*capture_buf_size = value;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--max-dump-files"))
+		{
+			/* get the maximum number of dump files open at the same time */
+			int value;
+			if(argc <= 1)
+			{
+				SNIFFER_LOG(LOG_WARNING, "option --max-dump-files takes one "
+				            "argument");
+				usage();
+				goto error;
+			}
+			value = atoi(argv[1]);
+			if(value < 1 || ((unsigned int) value) > SNIFFER_DUMP_FILES_MAX)
+			{
+				SNIFFER_LOG(LOG_WARNING, "the maximum number of dump files should "
+				            "be between 1 and %u", SNIFFER_DUMP_FILES_MAX);
+				usage();
+				goto error;
+			}
+			*dump_files_max = value;
+			args_used++;
+		}
 		else if(!strcmp(*argv, "--rohc-version"))
 		{
 			/* get the ROHC version to use */
@@ -722,6 +1058,15 @@ static void usage(void)
 	       "  -p, --pidfile FILE      Write daemon PID in the given file\n"
 	       "  -m, --max-contexts NUM  The maximum number of ROHC contexts to\n"
 	       "                          simultaneously use during the test\n"
+	       "                          (per worker)\n"
+	       "      --workers NUM       The number of worker threads that\n"
+	       "                          compress/decompress the captured\n"
+	       "                          packets (default: 1)\n"
+	       "      --capture-buffer MB The size of the kernel buffer for\n"
+	       "                          captured packets (default: 64 MB)\n"
+	       "      --max-dump-files NUM\n"
+	       "                          The maximum number of dump files\n"
+	       "                          open at the same time (default: 128)\n"
 	       "      --rohc-version NUM  The ROHC version to use: 1 for ROHCv1\n"
 	       "                          and 2 for ROHCv2\n"
 	       "      --disable PROFILE   A ROHC profile to disable\n"
@@ -735,6 +1080,9 @@ static void usage(void)
 	       "  rohc_sniffer -m 450 largecid wlan0  compress traffic from\n"
 	       "                                      wlan0 with large CIDs, no\n"
 	       "                                      more than 450 streams\n"
+	       "  rohc_sniffer --workers 8 largecid eth1\n"
+	       "                                      compress traffic from\n"
+	       "                                      eth1 with 8 threads\n"
 	       "\n"
 	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
 }
@@ -755,56 +1103,42 @@ static void sniffer_interrupt(int signum)
 	 * then kill the program */
 	if(signum == SIGSEGV || signum == SIGABRT)
 	{
-		int i;
-		size_t j;
+		size_t worker_id;
 
 		if(signum == SIGSEGV)
 		{
-			SNIFFER_LOG(LOG_WARNING, "a segfault occurred at packet #%lu",
-			            sniffer_stats.total_packets);
+			SNIFFER_LOG(LOG_WARNING, "a segfault occurred after packet #%lu was "
+			            "captured", sniffer_captured_nr);
 		}
 		else
 		{
-			SNIFFER_LOG(LOG_WARNING, "an assertion failed at packet #%lu",
-			            sniffer_stats.total_packets);
+			SNIFFER_LOG(LOG_WARNING, "an assertion failed after packet #%lu was "
+			            "captured", sniffer_captured_nr);
 		}
 
-		/* close PCAP dumpers */
-		for(j = 0; j <= ROHC_LARGE_CID_MAX; j++)
+		for(worker_id = 0; worker_id < sniffer_workers_nr; worker_id++)
 		{
-			if(sniffer_dumpers[j] != NULL)
-			{
-				SNIFFER_LOG(LOG_INFO, "close dump file for context with ID %zu", j);
-				pcap_dump_close(sniffer_dumpers[j]);
-			}
-		}
+			const struct sniffer_worker *const worker =
+				&(sniffer_workers[worker_id]);
 
-		/* print last debug traces */
-		if(last_traces_first == -1 || last_traces_last == -1)
-		{
-			SNIFFER_LOG(LOG_NOTICE, "no trace to print");
-			raise(SIGKILL);
-			return;
-		}
+			SNIFFER_LOG(LOG_WARNING, "worker #%zu handled %lu packets", worker_id,
+			            worker->stats.total_packets);
 
-		if(last_traces_first <= last_traces_last)
-		{
-			SNIFFER_LOG(LOG_NOTICE, "print the last %d traces...",
-			            last_traces_last - last_traces_first);
-			for(i = last_traces_first; i <= last_traces_last; i++)
-			{
-				SNIFFER_LOG(LOG_WARNING, "%s", last_traces[i]);
-			}
+			/* print last debug traces */
+			sniffer_print_last_traces(worker);
 		}
-		else
+
+		/* write the PCAP dumps on disk, the failing worker already waited for
+		 * its packets to be handled by the writer thread */
+		if(sniffer_writer != NULL)
 		{
-			SNIFFER_LOG(LOG_NOTICE, "print the last %d traces...",
-			            MAX_LAST_TRACES - last_traces_first + last_traces_last);
-			for(i = last_traces_first;
-			    i <= MAX_LAST_TRACES + last_traces_last;
-			    i++)
+			const struct sniffer_dump_stream *stream;
+
+			SNIFFER_LOG(LOG_INFO, "flush %zu dump files", sniffer_writer->open_nr);
+			for(stream = sniffer_writer->lru_first; stream != NULL;
+			    stream = stream->lru_next)
 			{
-				SNIFFER_LOG(LOG_WARNING, "%s", last_traces[i % MAX_LAST_TRACES]);
+				pcap_dump_flush(stream->dumper);
 			}
 		}
 		SNIFFER_LOG(LOG_NOTICE, "all last traces printed, you can analyze "
@@ -823,6 +1157,48 @@ static void sniffer_interrupt(int signum)
 }
 
 
+/**
+ * @brief Print the last library traces recorded by one worker
+ *
+ * @param worker  The worker to print the last traces for
+ */
+static void sniffer_print_last_traces(const struct sniffer_worker *const worker)
+{
+	int i;
+
+	if(worker->last_traces == NULL ||
+	   worker->last_traces_first == -1 || worker->last_traces_last == -1)
+	{
+		SNIFFER_LOG(LOG_NOTICE, "no trace to print for worker #%zu", worker->id);
+		return;
+	}
+
+	if(worker->last_traces_first <= worker->last_traces_last)
+	{
+		SNIFFER_LOG(LOG_NOTICE, "print the last %d traces of worker #%zu...",
+		            worker->last_traces_last - worker->last_traces_first,
+		            worker->id);
+		for(i = worker->last_traces_first; i <= worker->last_traces_last; i++)
+		{
+			SNIFFER_LOG(LOG_WARNING, "%s", worker->last_traces[i]);
+		}
+	}
+	else
+	{
+		SNIFFER_LOG(LOG_NOTICE, "print the last %d traces of worker #%zu...",
+		            MAX_LAST_TRACES - worker->last_traces_first +
+		            worker->last_traces_last, worker->id);
+		for(i = worker->last_traces_first;
+		    i <= MAX_LAST_TRACES + worker->last_traces_last;
+		    i++)
+		{
+			SNIFFER_LOG(LOG_WARNING, "%s",
+			            worker->last_traces[i % MAX_LAST_TRACES]);
+		}
+	}
+}
+
+
 /**
  * @brief Compute a percentage
  *
@@ -857,156 +1233,201 @@ static unsigned long long compute_percent(const unsigned long value,
  */
 static void sniffer_print_stats(int signum __attribute__((unused)))
 {
+	struct sniffer_stats_t stats;
+	unsigned long ring_drops = 0;
+	unsigned long dump_drops = 0;
 	unsigned long total;
+	size_t worker_id;
 	int i;
 
 	SNIFFER_LOG(LOG_INFO, "dump ROHC sniffer statistics...");
 
+	/* sum up the statistics of all the workers */
+	sniffer_collect_stats(&stats);
+	for(worker_id = 0; worker_id < sniffer_workers_nr; worker_id++)
+	{
+		ring_drops += sniffer_workers[worker_id].capture_ring.drops;
+		dump_drops += __atomic_load_n(&sniffer_workers[worker_id].dump_ring.drops,
+		                              __ATOMIC_RELAXED);
+	}
+
+	/* capture */
+	SNIFFER_LOG(LOG_INFO, "capture:");
+	SNIFFER_LOG(LOG_INFO, "  captured packets: %lu packets", sniffer_captured_nr);
+	SNIFFER_LOG(LOG_INFO, "  dropped by the sniffer: %lu packets (%llu%%)",
+	            ring_drops, compute_percent(ring_drops, sniffer_captured_nr));
+	if(sniffer_handle != NULL)
+	{
+		struct pcap_stat capture_stats;
+
+		if(pcap_stats(sniffer_handle, &capture_stats) == 0)
+		{
+			SNIFFER_LOG(LOG_INFO, "  dropped by the kernel: %u packets",
+			            capture_stats.ps_drop);
+			SNIFFER_LOG(LOG_INFO, "  dropped by the interface: %u packets",
+			            capture_stats.ps_ifdrop);
+		}
+	}
+	SNIFFER_LOG(LOG_INFO, "  workers: %zu", sniffer_workers_nr);
+
+	/* dump files */
+	if(sniffer_writer != NULL)
+	{
+		SNIFFER_LOG(LOG_INFO, "dump files:");
+		SNIFFER_LOG(LOG_INFO, "  open files: %zu (max %zu)",
+		            __atomic_load_n(&sniffer_writer->open_nr, __ATOMIC_RELAXED),
+		            sniffer_writer->open_max);
+		SNIFFER_LOG(LOG_INFO, "  files closed to open other ones: %lu",
+		            __atomic_load_n(&sniffer_writer->evictions_nr,
+		                            __ATOMIC_RELAXED));
+		SNIFFER_LOG(LOG_INFO, "  packets not dumped: %lu packets", dump_drops);
+	}
+
 	/* general */
 	SNIFFER_LOG(LOG_INFO, "general:");
 	SNIFFER_LOG(LOG_INFO, "  total packets: %lu packets",
-	            sniffer_stats.total_packets);
+	            stats.total_packets);
 	SNIFFER_LOG(LOG_INFO, "  bad packets: %lu packets (%llu%%)",
-	            sniffer_stats.bad_packets,
-	            compute_percent(sniffer_stats.bad_packets, sniffer_stats.total_packets));
+	            stats.bad_packets,
+	            compute_percent(stats.bad_packets, stats.total_packets));
 	SNIFFER_LOG(LOG_INFO, "  loss (estim.):");
 	SNIFFER_LOG(LOG_INFO, "    %lu packets among %lu bursts (%llu%%)",
-	            sniffer_stats.nr_lost_packets, sniffer_stats.nr_loss_bursts,
-	            compute_percent(sniffer_stats.nr_lost_packets, sniffer_stats.total_packets));
+	            stats.nr_lost_packets, stats.nr_loss_bursts,
+	            compute_percent(stats.nr_lost_packets, stats.total_packets));
 	SNIFFER_LOG(LOG_INFO, "    packets per burst: max %lu, avg %lu, min %lu",
-	            sniffer_stats.max_loss_burst_len, (sniffer_stats.nr_loss_bursts != 0 ?
-	            sniffer_stats.nr_lost_packets / sniffer_stats.nr_loss_bursts : 0),
-	            sniffer_stats.min_loss_burst_len);
+	            stats.max_loss_burst_len, (stats.nr_loss_bursts != 0 ?
+	            stats.nr_lost_packets / stats.nr_loss_bursts : 0),
+	            stats.min_loss_burst_len);
 	SNIFFER_LOG(LOG_INFO, "  mis-ordered packets (estim.): %lu packets "
-	            "(%llu%%)", sniffer_stats.nr_misordered_packets,
-	            compute_percent(sniffer_stats.nr_misordered_packets, sniffer_stats.total_packets));
+	            "(%llu%%)", stats.nr_misordered_packets,
+	            compute_percent(stats.nr_misordered_packets, stats.total_packets));
 	SNIFFER_LOG(LOG_INFO, "  duplicated packets (estim.): %lu packets "
-	            "(%llu%%)", sniffer_stats.nr_duplicated_packets,
-	            compute_percent(sniffer_stats.nr_duplicated_packets, sniffer_stats.total_packets));
+	            "(%llu%%)", stats.nr_duplicated_packets,
+	            compute_percent(stats.nr_duplicated_packets, stats.total_packets));
 
 	/* compression gain */
 	SNIFFER_LOG(LOG_INFO, "compression gain:");
-	if(sniffer_stats.comp_unit_size == 1)
+	if(stats.comp_unit_size == 1)
 	{
 		SNIFFER_LOG(LOG_INFO, "  pre-compress: %lu bytes (incl. %lu KB of headers)",
-		            sniffer_stats.comp_pre_nr_bytes, sniffer_stats.comp_pre_nr_hdr_bytes / 1000);
+		            stats.comp_pre_nr_bytes, stats.comp_pre_nr_hdr_bytes / 1000);
 	}
 	else
 	{
 		SNIFFER_LOG(LOG_INFO, "  pre-compress: %lu %s (incl. %lu KB of headers)",
-		            sniffer_stats.comp_pre_nr_units,
-		            sniffer_stats.comp_unit_size == 1000 ? "KB" :
-		            (sniffer_stats.comp_unit_size == 1000*1000 ? "MB" :
-		             (sniffer_stats.comp_unit_size == 1000*1000*1000 ? "GB" : "?")),
-		            sniffer_stats.comp_pre_nr_hdr_bytes / 1000);
+		            stats.comp_pre_nr_units,
+		            stats.comp_unit_size == 1000 ? "KB" :
+		            (stats.comp_unit_size == 1000*1000 ? "MB" :
+		             (stats.comp_unit_size == 1000*1000*1000 ? "GB" : "?")),
+		            stats.comp_pre_nr_hdr_bytes / 1000);
 	}
-	if(sniffer_stats.comp_unit_size == 1)
+	if(stats.comp_unit_size == 1)
 	{
 		SNIFFER_LOG(LOG_INFO, "  post-compress: %lu bytes (incl. %lu KB of headers)",
-		            sniffer_stats.comp_post_nr_bytes, sniffer_stats.comp_post_nr_hdr_bytes / 1000);
+		            stats.comp_post_nr_bytes, stats.comp_post_nr_hdr_bytes / 1000);
 	}
 	else
 	{
 		SNIFFER_LOG(LOG_INFO, "  post-compress: %lu %s (incl. %lu KB of headers)",
-		            sniffer_stats.comp_post_nr_units,
-		            sniffer_stats.comp_unit_size == 1000 ? "KB" :
-		            (sniffer_stats.comp_unit_size == 1000*1000 ? "MB" :
-		             (sniffer_stats.comp_unit_size == 1000*1000*1000 ? "GB" : "?")),
-		            sniffer_stats.comp_post_nr_hdr_bytes / 1000);
+		            stats.comp_post_nr_units,
+		            stats.comp_unit_size == 1000 ? "KB" :
+		            (stats.comp_unit_size == 1000*1000 ? "MB" :
+		             (stats.comp_unit_size == 1000*1000*1000 ? "GB" : "?")),
+		            stats.comp_post_nr_hdr_bytes / 1000);
 	}
-	if(sniffer_stats.comp_unit_size == 1)
+	if(stats.comp_unit_size == 1)
 	{
 		SNIFFER_LOG(LOG_INFO, "  compress ratio: %llu%% of total, ie. %llu%% "
 		            "of gain",
-		            compute_percent(sniffer_stats.comp_post_nr_bytes, sniffer_stats.comp_pre_nr_bytes),
-		            100 - compute_percent(sniffer_stats.comp_post_nr_bytes, sniffer_stats.comp_pre_nr_bytes));
+		            compute_percent(stats.comp_post_nr_bytes, stats.comp_pre_nr_bytes),
+		            100 - compute_percent(stats.comp_post_nr_bytes, stats.comp_pre_nr_bytes));
 	}
 	else
 	{
 		SNIFFER_LOG(LOG_INFO, "  compress ratio: %llu%% of total packets, ie. %llu%% "
 		            "of gain on full packets",
-		            compute_percent(sniffer_stats.comp_post_nr_units, sniffer_stats.comp_pre_nr_units),
-		            100 - compute_percent(sniffer_stats.comp_post_nr_units, sniffer_stats.comp_pre_nr_units));
+		            compute_percent(stats.comp_post_nr_units, stats.comp_pre_nr_units),
+		            100 - compute_percent(stats.comp_post_nr_units, stats.comp_pre_nr_units));
 	}
 	SNIFFER_LOG(LOG_INFO, "  compress ratio: %llu%% of total headers, ie. %llu%% "
 	            "of gain on headers alone",
-	            compute_percent(sniffer_stats.comp_post_nr_hdr_bytes, sniffer_stats.comp_pre_nr_hdr_bytes),
-	            100 - compute_percent(sniffer_stats.comp_post_nr_hdr_bytes, sniffer_stats.comp_pre_nr_hdr_bytes));
+	            compute_percent(stats.comp_post_nr_hdr_bytes, stats.comp_pre_nr_hdr_bytes),
+	            100 - compute_percent(stats.comp_post_nr_hdr_bytes, stats.comp_pre_nr_hdr_bytes));
 	SNIFFER_LOG(LOG_INFO, "  used and re-used contexts: %lu",
-	            sniffer_stats.comp_nr_reused_cid);
+	            stats.comp_nr_reused_cid);
 
 	/* packets per profile */
-	total = sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_UDP] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_ESP] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP];
+	total = stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED] +
+	        stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP] +
+	        stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP] +
+	        stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP] +
+	        stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP] +
+	        stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_UDP] +
+	        stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_ESP] +
+	        stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP];
 	SNIFFER_LOG(LOG_INFO, "packets per profile:");
 	SNIFFER_LOG(LOG_INFO, "  ROHCv1 Uncompressed profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED],
+	            stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED],
 	                            total));
 	SNIFFER_LOG(LOG_INFO, "  ROHCv1 IP/UDP/RTP profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP], total));
+	            stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP], total));
 	SNIFFER_LOG(LOG_INFO, "  ROHCv1 IP/UDP profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP], total));
+	            stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP], total));
 	SNIFFER_LOG(LOG_INFO, "  ROHCv1 IP-only profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP], total));
+	            stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP], total));
 	SNIFFER_LOG(LOG_INFO, "  ROHCv1 IP/TCP profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP], total));
+	            stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP], total));
 	SNIFFER_LOG(LOG_INFO, "  ROHCv2 IP/UDP profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_UDP],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_UDP], total));
+	            stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_UDP],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_UDP], total));
 	SNIFFER_LOG(LOG_INFO, "  ROHCv2 IP/ESP profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_ESP],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_ESP], total));
+	            stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_ESP],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP_ESP], total));
 	SNIFFER_LOG(LOG_INFO, "  ROHCv2 IP-only profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP], total));
+	            stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHCv2_PROFILE_IP], total));
 
 	/* packets per mode */
-	total = sniffer_stats.comp_nr_pkts_per_mode[ROHC_U_MODE] +
-	        sniffer_stats.comp_nr_pkts_per_mode[ROHC_O_MODE] +
-	        sniffer_stats.comp_nr_pkts_per_mode[ROHC_R_MODE];
+	total = stats.comp_nr_pkts_per_mode[ROHC_U_MODE] +
+	        stats.comp_nr_pkts_per_mode[ROHC_O_MODE] +
+	        stats.comp_nr_pkts_per_mode[ROHC_R_MODE];
 	SNIFFER_LOG(LOG_INFO, "packets per mode:");
 	SNIFFER_LOG(LOG_INFO, "  U-mode: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_mode[ROHC_U_MODE],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_mode[ROHC_U_MODE], total));
+	            stats.comp_nr_pkts_per_mode[ROHC_U_MODE],
+	            compute_percent(stats.comp_nr_pkts_per_mode[ROHC_U_MODE], total));
 	SNIFFER_LOG(LOG_INFO, "  O-mode: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_mode[ROHC_O_MODE],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_mode[ROHC_O_MODE], total));
+	            stats.comp_nr_pkts_per_mode[ROHC_O_MODE],
+	            compute_percent(stats.comp_nr_pkts_per_mode[ROHC_O_MODE], total));
 	SNIFFER_LOG(LOG_INFO, "  R-mode: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_mode[ROHC_R_MODE],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_mode[ROHC_R_MODE], total));
+	            stats.comp_nr_pkts_per_mode[ROHC_R_MODE],
+	            compute_percent(stats.comp_nr_pkts_per_mode[ROHC_R_MODE], total));
 
 	/* packets per state */
-	total = sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR] +
-	        sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO] +
-	        sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO];
+	total = stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR] +
+	        stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO] +
+	        stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO];
 	SNIFFER_LOG(LOG_INFO, "packets per state:");
 	SNIFFER_LOG(LOG_INFO, "  IR state: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR], total));
+	            stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR],
+	            compute_percent(stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR], total));
 	SNIFFER_LOG(LOG_INFO, "  FO state: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO], total));
+	            stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO],
+	            compute_percent(stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO], total));
 	SNIFFER_LOG(LOG_INFO, "  SO state: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO], total));
+	            stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO],
+	            compute_percent(stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO], total));
 
 	/* packets per packet type */
 	SNIFFER_LOG(LOG_INFO, "packets per packet type:");
 	total = 0;
 	for(i = ROHC_PACKET_IR; i < ROHC_PACKET_MAX; i++)
 	{
-		total += sniffer_stats.comp_nr_pkts_per_pkt_type[i];
+		total += stats.comp_nr_pkts_per_pkt_type[i];
 	}
 	for(i = ROHC_PACKET_IR; i < ROHC_PACKET_MAX; i++)
 	{
@@ -1015,8 +1436,8 @@ static void sniffer_print_stats(int signum __attribute__((unused)))
 		{
 			SNIFFER_LOG(LOG_INFO, "  packet type %s: %lu packets (%llu%%)",
 			            rohc_get_packet_descr(i),
-			            sniffer_stats.comp_nr_pkts_per_pkt_type[i],
-			            compute_percent(sniffer_stats.comp_nr_pkts_per_pkt_type[i], total));
+			            stats.comp_nr_pkts_per_pkt_type[i],
+			            compute_percent(stats.comp_nr_pkts_per_pkt_type[i], total));
 		}
 	}
 
@@ -1024,58 +1445,174 @@ static void sniffer_print_stats(int signum __attribute__((unused)))
 }
 
 
+/**
+ * @brief Sum up the statistics published by all the workers
+ *
+ * The function does not take any lock: every worker publishes a copy of its
+ * statistics protected by a sequence number, the copy is read again if the
+ * worker updated it in the meantime.
+ *
+ * @param[out] stats  The statistics of all the workers
+ */
+static void sniffer_collect_stats(struct sniffer_stats_t *const stats)
+{
+	unsigned long long comp_pre_nr_bytes = 0;
+	unsigned long long comp_post_nr_bytes = 0;
+	size_t worker_id;
+	size_t i;
+
+	memset(stats, 0, sizeof(struct sniffer_stats_t));
+	stats->comp_unit_size = 1;
+
+	for(worker_id = 0; worker_id < sniffer_workers_nr; worker_id++)
+	{
+		struct sniffer_worker *const worker = &(sniffer_workers[worker_id]);
+		struct sniffer_stats_t w;
+		size_t seq;
+
+		/* get a consistent copy of the stats published by the worker */
+		do
+		{
+			seq = __atomic_load_n(&worker->stats_seq, __ATOMIC_ACQUIRE);
+			memcpy(&w, &worker->stats_pub, sizeof(struct sniffer_stats_t));
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		}
+		while((seq % 2) != 0 ||
+		      seq != __atomic_load_n(&worker->stats_seq, __ATOMIC_RELAXED));
+
+		/* the workers may count bytes with different units */
+		comp_pre_nr_bytes += ((unsigned long long) w.comp_pre_nr_units) *
+		                     w.comp_unit_size + w.comp_pre_nr_bytes;
+		comp_post_nr_bytes += ((unsigned long long) w.comp_post_nr_units) *
+		                      w.comp_unit_size + w.comp_post_nr_bytes;
+		stats->comp_pre_nr_hdr_bytes += w.comp_pre_nr_hdr_bytes;
+		stats->comp_post_nr_hdr_bytes += w.comp_post_nr_hdr_bytes;
+
+		for(i = 0; i < ROHC_PROFILE_MAX; i++)
+		{
+			stats->comp_nr_pkts_per_profile[i] += w.comp_nr_pkts_per_profile[i];
+		}
+		for(i = 0; i <= ROHC_R_MODE; i++)
+		{
+			stats->comp_nr_pkts_per_mode[i] += w.comp_nr_pkts_per_mode[i];
+		}
+		for(i = 0; i <= ROHC_COMP_STATE_SO; i++)
+		{
+			stats->comp_nr_pkts_per_state[i] += w.comp_nr_pkts_per_state[i];
+		}
+		for(i = 0; i < ROHC_PACKET_MAX; i++)
+		{
+			stats->comp_nr_pkts_per_pkt_type[i] += w.comp_nr_pkts_per_pkt_type[i];
+		}
+		stats->comp_nr_reused_cid += w.comp_nr_reused_cid;
+
+		stats->total_packets += w.total_packets;
+		stats->bad_packets += w.bad_packets;
+
+		stats->nr_lost_packets += w.nr_lost_packets;
+		stats->nr_loss_bursts += w.nr_loss_bursts;
+		stats->max_loss_burst_len = max(stats->max_loss_burst_len,
+		                                w.max_loss_burst_len);
+		if(w.min_loss_burst_len != 0 &&
+		   (stats->min_loss_burst_len == 0 ||
+		    w.min_loss_burst_len < stats->min_loss_burst_len))
+		{
+			stats->min_loss_burst_len = w.min_loss_burst_len;
+		}
+
+		stats->nr_misordered_packets += w.nr_misordered_packets;
+		stats->nr_duplicated_packets += w.nr_duplicated_packets;
+	}
+
+	/* use the same units as the workers do: bytes, KB, MB then GB */
+	while(stats->comp_unit_size < (1000 * 1000 * 1000) &&
+	      (comp_pre_nr_bytes / stats->comp_unit_size) >= (100 * 1000) &&
+	      (comp_post_nr_bytes / stats->comp_unit_size) >= (100 * 1000))
+	{
+		stats->comp_unit_size *= 1000;
+	}
+	stats->comp_pre_nr_units = comp_pre_nr_bytes / stats->comp_unit_size;
+	stats->comp_pre_nr_bytes = comp_pre_nr_bytes % stats->comp_unit_size;
+	stats->comp_post_nr_units = comp_post_nr_bytes / stats->comp_unit_size;
+	stats->comp_post_nr_bytes = comp_post_nr_bytes % stats->comp_unit_size;
+}
+
+
 /**
  * @brief Test the ROHC library with a sniffed flow of IP packets going
- *        through one compressor/decompressor pair
+ *        through several compressor/decompressor pairs
+ *
+ * The calling thread captures the packets and dispatches them to the worker
+ * threads, one compressor/decompressor pair per worker. One more thread
+ * saves the packets in dump files, one file per stream.
  *
  * @param cid_type          The type of CIDs that the compressor shall use
  * @param max_contexts      The maximum number of ROHC contexts to use
+ *                          per worker
  * @param enabled_profiles  The ROHC profiles to enable
+ * @param workers_nr        The number of worker threads
+ * @param capture_buf_size  The size (in MB) of the kernel capture buffer
+ * @param dump_files_max    The maximum number of dump files open at the
+ *                          same time
  * @param device_name       The name of the network device
  * @return                  Whether the sniffer setup was OK
  */
 static bool sniff(const rohc_cid_type_t cid_type,
                   const size_t max_contexts,
                   const int enabled_profiles[],
+                  const size_t workers_nr,
+                  const size_t capture_buf_size,
+                  const size_t dump_files_max,
                   const char *const device_name)
 {
 	char errbuf[PCAP_ERRBUF_SIZE];
 	pcap_t *handle;
 	int link_layer_type_src;
-	int link_len_src;
-	struct pcap_pkthdr header;
-	unsigned char *packet;
-
-	struct rohc_comp *comp;
-	struct rohc_decomp *decomp;
-
-	uint8_t feedback_send_buffer[MAX_ROHC_SIZE];
-	struct rohc_buf feedback_send =
-		rohc_buf_init_empty(feedback_send_buffer, MAX_ROHC_SIZE);
-
-	unsigned int i;
+	size_t link_len_src;
 
-	/* statistics */
-	unsigned int nb_ok = 0;
-	unsigned int nb_bad = 0;
-	unsigned int nb_internal_err = 0;
-	unsigned int err_comp = 0;
-	unsigned int err_decomp = 0;
-	unsigned int nb_ref = 0;
+	struct sniffer_capture capture;
+	struct sniffer_dump_writer writer;
+	struct sniffer_worker *workers;
+	sigset_t workers_sigmask;
+	sigset_t main_sigmask;
+	size_t i;
+	int ret;
 
 	/* init status */
 	bool status = false;
 
 	assert(device_name != NULL);
 
-	/* open the network device */
-	handle = pcap_open_live(device_name, DEV_MTU, 0, 0, errbuf);
+	/* open the network device with a large kernel buffer, so that bursts of
+	 * traffic are absorbed while the workers are busy */
+	handle = pcap_create(device_name, errbuf);
 	if(handle == NULL)
 	{
 		SNIFFER_LOG(LOG_WARNING, "failed to open network device '%s': %s",
 		            device_name, errbuf);
 		goto error;
 	}
+	if(pcap_set_snaplen(handle, DEV_MTU) != 0 ||
+	   pcap_set_promisc(handle, 0) != 0 ||
+	   pcap_set_timeout(handle, SNIFFER_CAPTURE_TIMEOUT) != 0 ||
+	   pcap_set_buffer_size(handle, capture_buf_size * 1024 * 1024) != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to configure capture on network "
+		            "device '%s'", device_name);
+		goto close_input;
+	}
+	ret = pcap_activate(handle);
+	if(ret < 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to open network device '%s': %s",
+		            device_name, pcap_geterr(handle));
+		goto close_input;
+	}
+	else if(ret > 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "network device '%s' opened with warning: %s",
+		            device_name, pcap_geterr(handle));
+	}
 
 	/* link layer in the source dump must be Ethernet */
 	link_layer_type_src = pcap_datalink(handle);
@@ -1102,130 +1639,665 @@ static bool sniff(const rohc_cid_type_t cid_type,
 		link_len_src = 0;
 	}
 
-	/* create the ROHC compressor */
-	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_false_random_num, NULL);
-	if(comp == NULL)
+	/* create the workers, each of them with one compressor/decompressor pair */
+	if(posix_memalign((void **) &workers, __alignof__(struct sniffer_worker),
+	                  workers_nr * sizeof(struct sniffer_worker)) != 0)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to create the ROHC compressor");
+		SNIFFER_LOG(LOG_WARNING, "failed to allocate memory for %zu workers",
+		            workers_nr);
 		goto close_input;
 	}
-
-	/* set the callback for traces on compressor */
-	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
-	{
-		SNIFFER_LOG(LOG_WARNING, "failed to set the trace callback for the "
-		            "compressor");
-		goto destroy_comp;
-	}
-
-	/* enable the compression profiles */
-	for(i = ROHC_PROFILE_UNCOMPRESSED; i < ROHC_PROFILE_MAX; i++)
+	memset(workers, 0, workers_nr * sizeof(struct sniffer_worker));
+	for(i = 0; i < workers_nr; i++)
 	{
-		if(enabled_profiles[i] == 1 && !rohc_comp_enable_profile(comp, i))
-		{
-			SNIFFER_LOG(LOG_WARNING, "failed to enable compression profile "
-			            "0x%04x", i);
-			goto destroy_comp;
-		}
-		else if(enabled_profiles[i] == 0 && !rohc_comp_disable_profile(comp, i))
+		if(!sniffer_worker_init(&(workers[i]), i, workers_nr, cid_type,
+		                        max_contexts, enabled_profiles, handle,
+		                        link_len_src))
 		{
-			SNIFFER_LOG(LOG_WARNING, "failed to disable compression profile "
-			            "0x%04x", i);
-			goto destroy_comp;
+			SNIFFER_LOG(LOG_WARNING, "failed to create worker #%zu", i);
+			goto free_workers;
 		}
 	}
+	sniffer_handle = handle;
+	sniffer_workers = workers;
+	sniffer_workers_nr = workers_nr;
 
-	/* set the callback for RTP stream detection */
-	if(!rohc_comp_set_rtp_detection_cb(comp, rtp_detect_cb, NULL))
-	{
-		SNIFFER_LOG(LOG_WARNING, "failed to set the RTP stream detection "
-		            "callback for compressor");
-		goto destroy_comp;
-	}
+	/* the writer thread saves the packets of all workers in dump files */
+	memset(&writer, 0, sizeof(struct sniffer_dump_writer));
+	writer.handle = handle;
+	writer.workers = workers;
+	writer.workers_nr = workers_nr;
+	writer.open_max = dump_files_max;
+	sniffer_writer = &writer;
 
-	/* create the decompressor (bi-directional mode) */
-	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_O_MODE);
-	if(decomp == NULL)
+	/* the signals that stop the program or print stats are handled by the
+	 * capture thread only */
+	sigemptyset(&workers_sigmask);
+	sigaddset(&workers_sigmask, SIGINT);
+	sigaddset(&workers_sigmask, SIGTERM);
+	sigaddset(&workers_sigmask, SIGUSR1);
+	sigaddset(&workers_sigmask, SIGHUP);
+	if(pthread_sigmask(SIG_BLOCK, &workers_sigmask, &main_sigmask) != 0)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to create the decompressor");
-		goto destroy_comp;
+		SNIFFER_LOG(LOG_WARNING, "failed to block signals for workers");
+		goto free_workers;
 	}
-
-	/* set the callback for traces on decompressor */
-	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	ret = pthread_create(&(writer.thread), NULL, sniffer_dump_writer_run,
+	                     &writer);
+	if(ret != 0)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to set trace callback for "
-		            "decompressor");
-		goto destroy_decomp;
+		SNIFFER_LOG(LOG_WARNING, "failed to start the writer thread: %s (%d)",
+		            strerror(ret), ret);
+		pthread_sigmask(SIG_SETMASK, &main_sigmask, NULL);
+		goto free_workers;
 	}
-
-	/* enable the decompression profiles */
-	for(i = ROHC_PROFILE_UNCOMPRESSED; i < ROHC_PROFILE_MAX; i++)
+	writer.is_started = true;
+	for(i = 0; i < workers_nr; i++)
 	{
-		if(enabled_profiles[i] == 1 && !rohc_decomp_enable_profile(decomp, i))
-		{
-			SNIFFER_LOG(LOG_WARNING, "failed to enable decompression profile "
-			            "0x%04x", i);
-			goto destroy_decomp;
-		}
-		else if(enabled_profiles[i] == 0 &&
-		        !rohc_decomp_disable_profile(decomp, i))
+		ret = pthread_create(&(workers[i].thread), NULL, sniffer_worker_run,
+		                     &(workers[i]));
+		if(ret != 0)
 		{
-			SNIFFER_LOG(LOG_WARNING, "failed to disable decompression profile "
-			            "0x%04x", i);
-			goto destroy_decomp;
+			SNIFFER_LOG(LOG_WARNING, "failed to start worker #%zu: %s (%d)",
+			            i, strerror(ret), ret);
+			break;
 		}
+		workers[i].is_started = true;
+	}
+	if(pthread_sigmask(SIG_SETMASK, &main_sigmask, NULL) != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to restore signals");
+		goto stop_workers;
+	}
+	if(i < workers_nr)
+	{
+		goto stop_workers;
 	}
 
-	/* reset the PCAP dumpers (used to save sniffed packets in several PCAP
-	 * files, one per Context ID) */
-	bzero(sniffer_dumpers, sizeof(pcap_dumper_t *) * max_contexts);
-
-	SNIFFER_LOG(LOG_INFO, "ROHC sniffer successfully started");
+	SNIFFER_LOG(LOG_INFO, "ROHC sniffer successfully started with %zu workers",
+	            workers_nr);
 	SNIFFER_LOG(LOG_INFO, "start processing captured packets");
 
-	/* for each sniffed packet */
-	sniffer_stats.total_packets = 0;
+	/* dispatch the sniffed packets to the workers by batches */
+	capture.workers = workers;
+	capture.workers_nr = workers_nr;
+	capture.link_len_src = link_len_src;
 	while(!stop_program)
 	{
-		unsigned int cid = 0;
-		int ret;
+		ret = pcap_dispatch(handle, -1, sniffer_dispatch_pkt, (u_char *) &capture);
+		if(ret == -1)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to capture packets: %s",
+			            pcap_geterr(handle));
+			goto stop_workers;
+		}
+		else if(ret == -2)
+		{
+			break;
+		}
+	}
+
+	if(stop_program)
+	{
+		SNIFFER_LOG(LOG_INFO, "program stopped by signal");
+	}
 
-		/* try to capture a packet */
-		packet = (unsigned char *) pcap_next(handle, &header);
-		if(packet == NULL)
+	status = true;
+
+stop_workers:
+	/* the workers handle the packets left in their ring buffers, then stop */
+	for(i = 0; i < workers_nr; i++)
+	{
+		if(workers[i].is_started)
 		{
-			/* no packet captured, re-try */
-			continue;
+			__atomic_store_n(&(workers[i].do_stop), true, __ATOMIC_RELEASE);
+		}
+	}
+	for(i = 0; i < workers_nr; i++)
+	{
+		if(workers[i].is_started)
+		{
+			pthread_join(workers[i].thread, NULL);
+			workers[i].is_started = false;
+		}
+	}
+	/* then the writer thread writes the packets left in the dump rings,
+	 * closes the dump files, and stops */
+	__atomic_store_n(&(writer.do_stop), true, __ATOMIC_RELEASE);
+	pthread_join(writer.thread, NULL);
+	writer.is_started = false;
+free_workers:
+	sniffer_writer = NULL;
+	sniffer_workers_nr = 0;
+	sniffer_workers = NULL;
+	sniffer_handle = NULL;
+	for(i = 0; i < workers_nr; i++)
+	{
+		sniffer_worker_free(&(workers[i]));
+	}
+	free(workers);
+close_input:
+	pcap_close(handle);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Dispatch one captured packet to the worker in charge of its flow
+ *
+ * The packet is copied in the capture ring of the worker. The packet is
+ * dropped if the ring buffer is full: the capture shall never wait for one
+ * slow worker.
+ *
+ * @param user    The context of the capture thread
+ * @param header  The PCAP header for the packet
+ * @param packet  The captured packet (link layer included)
+ */
+static void sniffer_dispatch_pkt(u_char *const user,
+                                 const struct pcap_pkthdr *const header,
+                                 const u_char *const packet)
+{
+	const struct sniffer_capture *const capture =
+		(const struct sniffer_capture *) user;
+	struct sniffer_worker *worker;
+
+	sniffer_captured_nr++;
+
+	if(!is_daemon &&
+	   (sniffer_captured_nr == 1 || (sniffer_captured_nr % 100) == 0))
+	{
+		if(sniffer_captured_nr > 1)
+		{
+			printf("\r");
+		}
+		printf("packet #%lu", sniffer_captured_nr);
+		fflush(stdout);
+
+		if(do_print_stat && (sniffer_captured_nr % 1000) == 0)
+		{
+			printf("\n\n");
+			fprintf(stderr, "================================================\n");
+			sniffer_print_stats(SIGUSR1);
+			fprintf(stderr, "================================================\n");
+			fprintf(stderr, "\n");
+			fflush(stderr);
+		}
+	}
+
+	/* all the packets of one flow are handled by the same worker */
+	worker = &(capture->workers[sniffer_flow_hash(packet, header->caplen,
+	                                              capture->link_len_src) %
+	                            capture->workers_nr]);
+	sniffer_ring_push(&worker->capture_ring, SNIFFER_OP_PKT, 0, header, packet);
+}
+
+
+/**
+ * @brief Create a ring buffer of packets
+ *
+ * @param ring  The ring buffer to initialize
+ * @param size  The size (in bytes) of the ring buffer, a power of 2
+ * @return      true if the ring buffer was created, false otherwise
+ */
+static bool sniffer_ring_init(struct sniffer_ring *const ring,
+                              const size_t size)
+{
+	assert((size & (size - 1)) == 0);
+
+	ring->buf = malloc(size);
+	if(ring->buf == NULL)
+	{
+		return false;
+	}
+	ring->size = size;
+	ring->head = 0;
+	ring->drops = 0;
+	ring->tail = 0;
+
+	return true;
+}
+
+
+/**
+ * @brief Copy one packet at the end of a ring buffer
+ *
+ * Only the producer of the ring buffer shall call the function. The packet
+ * is dropped if the ring buffer is full.
+ *
+ * @param ring    The ring buffer
+ * @param op      The operation to perform on the packet
+ * @param cid     The ID of the context the packet belongs to
+ * @param header  The PCAP header for the packet
+ * @param packet  The packet, may be NULL if header->caplen is 0
+ * @return        true if the packet was copied, false if it was dropped
+ */
+static bool sniffer_ring_push(struct sniffer_ring *const ring,
+                              const sniffer_op_t op,
+                              const unsigned int cid,
+                              const struct pcap_pkthdr *const header,
+                              const unsigned char *const packet)
+{
+	const size_t rec_align = __alignof__(struct sniffer_ring_pkt);
+	const size_t rec_len = (sizeof(struct sniffer_ring_pkt) + header->caplen +
+	                        rec_align - 1) & ~(rec_align - 1);
+	const size_t ring_tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	size_t ring_head = ring->head;
+	size_t rec_off = ring_head & (ring->size - 1);
+	size_t needed_len = rec_len;
+	struct sniffer_ring_pkt *rec;
+
+	/* a record never wraps around the end of the ring buffer */
+	if(rec_len > (ring->size - rec_off))
+	{
+		needed_len += ring->size - rec_off;
+	}
+	if((ring->size - (ring_head - ring_tail)) < needed_len)
+	{
+		__atomic_store_n(&ring->drops, ring->drops + 1, __ATOMIC_RELAXED);
+		return false;
+	}
+	if(rec_len > (ring->size - rec_off))
+	{
+		rec = (struct sniffer_ring_pkt *) (ring->buf + rec_off);
+		rec->rec_len = 0;
+		ring_head += ring->size - rec_off;
+		rec_off = 0;
+	}
+
+	/* copy the packet, then make it available to the consumer */
+	rec = (struct sniffer_ring_pkt *) (ring->buf + rec_off);
+	rec->rec_len = rec_len;
+	rec->op = op;
+	rec->cid = cid;
+	memcpy(&(rec->header), header, sizeof(struct pcap_pkthdr));
+	if(header->caplen > 0)
+	{
+		memcpy(rec->data, packet, header->caplen);
+	}
+	__atomic_store_n(&ring->head, ring_head + rec_len, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+
+/**
+ * @brief Get the first packet of a ring buffer
+ *
+ * Only the consumer of the ring buffer shall call the function. The packet
+ * stays in the ring buffer until \ref sniffer_ring_pop is called.
+ *
+ * @param ring  The ring buffer
+ * @return      The first packet, NULL if the ring buffer is empty
+ */
+static struct sniffer_ring_pkt * sniffer_ring_peek(struct sniffer_ring *const ring)
+{
+	const size_t ring_head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	const size_t rec_off = ring->tail & (ring->size - 1);
+	struct sniffer_ring_pkt *rec;
+
+	if(ring->tail == ring_head)
+	{
+		return NULL;
+	}
+
+	rec = (struct sniffer_ring_pkt *) (ring->buf + rec_off);
+	if(rec->rec_len == 0)
+	{
+		/* the packet was wrapped around: the producer published it at the
+		 * beginning of the ring buffer at the same time as the marker */
+		__atomic_store_n(&ring->tail, ring->tail + ring->size - rec_off,
+		                 __ATOMIC_RELEASE);
+		rec = (struct sniffer_ring_pkt *) ring->buf;
+	}
+
+	return rec;
+}
+
+
+/**
+ * @brief Remove the first packet of a ring buffer
+ *
+ * Only the consumer of the ring buffer shall call the function.
+ *
+ * @param ring  The ring buffer
+ * @param rec   The first packet as returned by \ref sniffer_ring_peek
+ */
+static void sniffer_ring_pop(struct sniffer_ring *const ring,
+                             const struct sniffer_ring_pkt *const rec)
+{
+	__atomic_store_n(&ring->tail, ring->tail + rec->rec_len, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Compute the hash of the flow of one captured packet
+ *
+ * The hash is computed on the IP addresses, and on the UDP/TCP ports of
+ * non-fragmented packets. It is the same for both directions of one flow.
+ * Non-IP packets all get the same hash.
+ *
+ * @param packet        The captured packet (link layer included)
+ * @param len           The length of the captured packet
+ * @param link_len_src  The length of the link layer header before IP data
+ * @return              The hash of the flow
+ */
+static size_t sniffer_flow_hash(const unsigned char *const packet,
+                                const size_t len,
+                                const size_t link_len_src)
+{
+	const unsigned char *const ip = packet + link_len_src;
+	const size_t ip_len = (len > link_len_src ? len - link_len_src : 0);
+	const unsigned char *addrs;
+	size_t addrs_len;
+	size_t l4_offset;
+	uint8_t protocol;
+	bool is_fragment;
+	uint32_t hash = 0;
+	size_t i;
+
+	if(ip_len >= sizeof(struct ip) && (ip[0] >> 4) == 4)
+	{
+		addrs = ip + 12;
+		addrs_len = 2 * sizeof(struct in_addr);
+		protocol = ip[9];
+		l4_offset = (ip[0] & 0x0f) * 4U;
+		is_fragment = ((ip[6] & 0x3f) != 0 || ip[7] != 0);
+	}
+	else if(ip_len >= sizeof(struct ip6_hdr) && (ip[0] >> 4) == 6)
+	{
+		addrs = ip + 8;
+		addrs_len = 2 * sizeof(struct in6_addr);
+		protocol = ip[6];
+		l4_offset = sizeof(struct ip6_hdr);
+		is_fragment = false;
+	}
+	else
+	{
+		return 0;
+	}
+
+	/* addition is commutative: same hash for source and destination swapped */
+	for(i = 0; i < addrs_len; i += sizeof(uint32_t))
+	{
+		uint32_t word;
+		memcpy(&word, addrs + i, sizeof(uint32_t));
+		hash += word;
+	}
+	if((protocol == IPPROTO_UDP || protocol == IPPROTO_TCP ||
+	    protocol == IPPROTO_UDPLITE) &&
+	   !is_fragment && ip_len >= (l4_offset + 4))
+	{
+		uint16_t sport;
+		uint16_t dport;
+		memcpy(&sport, ip + l4_offset, sizeof(uint16_t));
+		memcpy(&dport, ip + l4_offset + 2, sizeof(uint16_t));
+		hash += ((uint32_t) (sport + dport)) << 16;
+	}
+	hash ^= protocol;
+
+	/* mix the bits, the lowest ones select the worker */
+	hash *= 0x9e3779b1U;
+	hash ^= hash >> 16;
+
+	return hash;
+}
+
+
+/**
+ * @brief Create one worker with its compressor/decompressor pair
+ *
+ * The thread of the worker is not started.
+ *
+ * @param worker            The worker to initialize, zeroed by the caller
+ * @param worker_id         The ID of the worker
+ * @param workers_nr        The number of workers
+ * @param cid_type          The type of CIDs that the compressor shall use
+ * @param max_contexts      The maximum number of ROHC contexts to use
+ * @param enabled_profiles  The ROHC profiles to enable
+ * @param handle            The PCAP handler that sniffs the packets
+ * @param link_len_src      The length of the link layer header before IP data
+ * @return                  true if the worker was successfully created,
+ *                          false otherwise
+ */
+static bool sniffer_worker_init(struct sniffer_worker *const worker,
+                                const size_t worker_id,
+                                const size_t workers_nr,
+                                const rohc_cid_type_t cid_type,
+                                const size_t max_contexts,
+                                const int enabled_profiles[],
+                                pcap_t *const handle,
+                                const size_t link_len_src)
+{
+	unsigned int i;
+
+	worker->id = worker_id;
+	worker->handle = handle;
+	worker->link_len_src = link_len_src;
+	worker->stats.comp_unit_size = 1;
+	worker->stats_pub.comp_unit_size = 1;
+
+	/* keep the names of the dump files of the single-threaded sniffer */
+	if(workers_nr == 1)
+	{
+		snprintf(worker->dump_prefix, sizeof(worker->dump_prefix),
+		         "./dump_stream");
+	}
+	else
+	{
+		snprintf(worker->dump_prefix, sizeof(worker->dump_prefix),
+		         "./dump_stream_worker_%zu", worker_id);
+	}
+
+	/* no traces at the moment */
+	worker->last_traces = calloc(MAX_LAST_TRACES, MAX_TRACE_LEN + 1);
+	if(worker->last_traces == NULL)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to allocate memory for traces");
+		goto error;
+	}
+	worker->last_traces_first = -1;
+	worker->last_traces_last = -1;
+
+	/* the sniffed packets are saved in several PCAP files, one per Context
+	 * ID, by the writer thread */
+	worker->dump_streams = calloc(max_contexts,
+	                              sizeof(struct sniffer_dump_stream));
+	if(worker->dump_streams == NULL)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to allocate memory for dump files");
+		goto error;
+	}
+	worker->dump_streams_nr = max_contexts;
+
+	if(!sniffer_ring_init(&worker->capture_ring, SNIFFER_CAPTURE_RING_SIZE) ||
+	   !sniffer_ring_init(&worker->dump_ring, SNIFFER_DUMP_RING_SIZE))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to allocate memory for ring buffers");
+		goto error;
+	}
+
+	/* create the ROHC compressor */
+	worker->comp = rohc_comp_new2(cid_type, max_contexts - 1,
+	                              gen_false_random_num, NULL);
+	if(worker->comp == NULL)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create the ROHC compressor");
+		goto error;
+	}
+
+	/* set the callback for traces on compressor */
+	if(!rohc_comp_set_traces_cb2(worker->comp, print_rohc_traces, worker))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to set the trace callback for the "
+		            "compressor");
+		goto error;
+	}
+
+	/* enable the compression profiles */
+	for(i = ROHC_PROFILE_UNCOMPRESSED; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(enabled_profiles[i] == 1 && !rohc_comp_enable_profile(worker->comp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to enable compression profile "
+			            "0x%04x", i);
+			goto error;
+		}
+		else if(enabled_profiles[i] == 0 &&
+		        !rohc_comp_disable_profile(worker->comp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to disable compression profile "
+			            "0x%04x", i);
+			goto error;
+		}
+	}
+
+	/* set the callback for RTP stream detection */
+	if(!rohc_comp_set_rtp_detection_cb(worker->comp, rtp_detect_cb, NULL))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to set the RTP stream detection "
+		            "callback for compressor");
+		goto error;
+	}
+
+	/* create the decompressor (bi-directional mode) */
+	worker->decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_O_MODE);
+	if(worker->decomp == NULL)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create the decompressor");
+		goto error;
+	}
+
+	/* set the callback for traces on decompressor */
+	if(!rohc_decomp_set_traces_cb2(worker->decomp, print_rohc_traces, worker))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to set trace callback for "
+		            "decompressor");
+		goto error;
+	}
+
+	/* enable the decompression profiles */
+	for(i = ROHC_PROFILE_UNCOMPRESSED; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(enabled_profiles[i] == 1 &&
+		   !rohc_decomp_enable_profile(worker->decomp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to enable decompression profile "
+			            "0x%04x", i);
+			goto error;
 		}
+		else if(enabled_profiles[i] == 0 &&
+		        !rohc_decomp_disable_profile(worker->decomp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to disable decompression profile "
+			            "0x%04x", i);
+			goto error;
+		}
+	}
 
-		sniffer_stats.total_packets++;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Destroy one worker, its thread and the writer thread shall be
+ *        stopped
+ *
+ * @param worker  The worker to destroy, even if partially initialized
+ */
+static void sniffer_worker_free(struct sniffer_worker *const worker)
+{
+	if(worker->decomp != NULL)
+	{
+		rohc_decomp_free(worker->decomp);
+		worker->decomp = NULL;
+	}
+	if(worker->comp != NULL)
+	{
+		rohc_comp_free(worker->comp);
+		worker->comp = NULL;
+	}
+	free(worker->dump_ring.buf);
+	worker->dump_ring.buf = NULL;
+	free(worker->capture_ring.buf);
+	worker->capture_ring.buf = NULL;
+	free(worker->dump_streams);
+	worker->dump_streams = NULL;
+	free(worker->last_traces);
+	worker->last_traces = NULL;
+}
+
+
+/**
+ * @brief The thread of one worker: compress, decompress and compare the
+ *        packets from its capture ring
+ *
+ * The program dies (assertion) if compression/decompression/comparison
+ * fails, as the single-threaded sniffer did. The packets of the failing
+ * stream are written to its dump file before.
+ *
+ * @param arg  The worker
+ * @return     Always NULL
+ */
+static void * sniffer_worker_run(void *const arg)
+{
+	struct sniffer_worker *const worker = arg;
+
+	uint8_t feedback_send_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf feedback_send =
+		rohc_buf_init_empty(feedback_send_buffer, MAX_ROHC_SIZE);
+
+	size_t unpublished_nr = 0;
+
+	/* statistics */
+	unsigned int nb_ok = 0;
+	unsigned int nb_bad = 0;
+	unsigned int nb_internal_err = 0;
+	unsigned int err_comp = 0;
+	unsigned int err_decomp = 0;
+	unsigned int nb_ref = 0;
+
+	while(true)
+	{
+		struct sniffer_ring_pkt *const rec =
+			sniffer_ring_peek(&worker->capture_ring);
+		unsigned int cid = 0;
+		int ret;
 
-		if(!is_daemon &&
-		   (sniffer_stats.total_packets == 1 || (sniffer_stats.total_packets % 100) == 0))
+		if(rec == NULL)
 		{
-			if(sniffer_stats.total_packets > 1)
+			const struct timespec idle_time = {
+				.tv_sec = 0,
+				.tv_nsec = SNIFFER_RING_IDLE_NS
+			};
+
+			if(unpublished_nr > 0)
 			{
-				printf("\r");
+				sniffer_worker_publish_stats(worker);
+				unpublished_nr = 0;
 			}
-			printf("packet #%lu", sniffer_stats.total_packets);
-			fflush(stdout);
 
-			if(do_print_stat && (sniffer_stats.total_packets % 1000) == 0)
+			/* stop only once all the packets were handled */
+			if(__atomic_load_n(&worker->do_stop, __ATOMIC_ACQUIRE) &&
+			   sniffer_ring_peek(&worker->capture_ring) == NULL)
 			{
-				printf("\n\n");
-				fprintf(stderr, "================================================\n");
-				sniffer_print_stats(SIGUSR1);
-				fprintf(stderr, "================================================\n");
-				fprintf(stderr, "\n");
-				fflush(stderr);
+				break;
 			}
+			nanosleep(&idle_time, NULL);
+			continue;
 		}
 
+		worker->stats.total_packets++;
+
 		/* compress & decompress from compressor to decompressor */
-		ret = compress_decompress(comp, decomp, header, packet,
-		                          link_len_src, handle, sniffer_dumpers,
-		                          &feedback_send, &cid, &sniffer_stats);
+		ret = compress_decompress(worker->comp, worker->decomp, rec->header,
+		                          rec->data, worker->link_len_src,
+		                          worker->handle, &worker->dump_ring,
+		                          worker->dump_prefix, &feedback_send, &cid,
+		                          &worker->stats);
 		if(ret == -1)
 		{
 			err_comp++;
@@ -1245,7 +2317,7 @@ static bool sniff(const rohc_cid_type_t cid_type,
 		else if(ret == -3)
 		{
 			nb_bad++;
-			sniffer_stats.bad_packets++;
+			worker->stats.bad_packets++;
 		}
 		else
 		{
@@ -1255,42 +2327,304 @@ static bool sniff(const rohc_cid_type_t cid_type,
 		/* in case of problem (ignore bad packets), just die! */
 		if(ret != 1 && ret != -3)
 		{
-			SNIFFER_LOG(LOG_WARNING, "packet #%lu, CID %u: stats OK, ERR(COMP), "
-			            "ERR(DECOMP), ERR(REF), ERR(BAD), ERR(INTERNAL)  =  "
-			            "%u  %u  %u  %u  %u  %u", sniffer_stats.total_packets,
-			            cid, nb_ok, err_comp, err_decomp, nb_ref, nb_bad,
-			            nb_internal_err);
+			SNIFFER_LOG(LOG_WARNING, "worker #%zu, packet #%lu, CID %u: stats "
+			            "OK, ERR(COMP), ERR(DECOMP), ERR(REF), ERR(BAD), "
+			            "ERR(INTERNAL)  =  %u  %u  %u  %u  %u  %u", worker->id,
+			            worker->stats.total_packets, cid, nb_ok, err_comp,
+			            err_decomp, nb_ref, nb_bad, nb_internal_err);
+
+			/* the failing stream shall be in its dump file */
+			sniffer_dump_sync(worker);
 
 			/* last debug traces are recorded in SIGABRT handler */
 			assert(0);
 		}
+
+		/* release the packet for the capture thread */
+		sniffer_ring_pop(&worker->capture_ring, rec);
+
+		unpublished_nr++;
+		if(unpublished_nr >= SNIFFER_STATS_PERIOD)
+		{
+			sniffer_worker_publish_stats(worker);
+			unpublished_nr = 0;
+		}
 	}
 
-	if(stop_program)
+	return NULL;
+}
+
+
+/**
+ * @brief Publish the statistics of one worker for the other threads
+ *
+ * The sequence number is odd while the copy is updated, so that readers
+ * retry instead of reading half-updated statistics.
+ *
+ * @param worker  The worker that publishes its statistics
+ */
+static void sniffer_worker_publish_stats(struct sniffer_worker *const worker)
+{
+	const size_t seq = worker->stats_seq;
+
+	__atomic_store_n(&worker->stats_seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(&worker->stats_pub, &worker->stats, sizeof(struct sniffer_stats_t));
+	__atomic_store_n(&worker->stats_seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Wait for the writer thread to write all the packets dumped by one
+ *        worker
+ *
+ * Give up after \ref SNIFFER_DUMP_SYNC_TIMEOUT ms, in case the writer thread
+ * is not running.
+ *
+ * @param worker  The worker that waits for its packets to be written
+ */
+static void sniffer_dump_sync(struct sniffer_worker *const worker)
+{
+	const struct timespec wait_time = {
+		.tv_sec = 0,
+		.tv_nsec = 1000 * 1000
+	};
+	struct pcap_pkthdr header;
+	size_t waited_ms = 0;
+
+	memset(&header, 0, sizeof(struct pcap_pkthdr));
+	while(!sniffer_ring_push(&worker->dump_ring, SNIFFER_OP_DUMP_SYNC, 0,
+	                         &header, NULL))
 	{
-		SNIFFER_LOG(LOG_INFO, "program stopped by signal");
+		if(waited_ms >= SNIFFER_DUMP_SYNC_TIMEOUT)
+		{
+			return;
+		}
+		nanosleep(&wait_time, NULL);
+		waited_ms++;
 	}
 
-	status = true;
+	while(__atomic_load_n(&worker->dump_synced, __ATOMIC_ACQUIRE) !=
+	      worker->dump_ring.head)
+	{
+		if(waited_ms >= SNIFFER_DUMP_SYNC_TIMEOUT)
+		{
+			SNIFFER_LOG(LOG_WARNING, "worker #%zu: the dump files may miss "
+			            "some packets", worker->id);
+			return;
+		}
+		nanosleep(&wait_time, NULL);
+		waited_ms++;
+	}
+}
+
 
-	/* close PCAP dumpers */
-	for(i = 0; i < max_contexts; i++)
+/**
+ * @brief The writer thread: save the packets from the dump rings of all the
+ *        workers in the dump files of their streams
+ *
+ * At most \ref sniffer_dump_writer::open_max dump files are open at the same
+ * time, the least recently used one is closed to open another one. The file
+ * of a stream is re-opened in append mode later on if needed.
+ *
+ * @param arg  The writer
+ * @return     Always NULL
+ */
+static void * sniffer_dump_writer_run(void *const arg)
+{
+	struct sniffer_dump_writer *const writer = arg;
+	const struct timespec idle_time = {
+		.tv_sec = 0,
+		.tv_nsec = SNIFFER_RING_IDLE_NS
+	};
+
+	while(true)
 	{
-		if(sniffer_dumpers[i] != NULL)
+		/* the workers are stopped before the writer: once told to stop, the
+		 * writer stops after one pass without any packet */
+		const bool do_stop = __atomic_load_n(&writer->do_stop, __ATOMIC_ACQUIRE);
+		size_t handled_nr = 0;
+		size_t worker_id;
+
+		for(worker_id = 0; worker_id < writer->workers_nr; worker_id++)
 		{
-			SNIFFER_LOG(LOG_INFO, "close dump file for context with ID %u", i);
-			pcap_dump_close(sniffer_dumpers[i]);
+			struct sniffer_worker *const worker = &(writer->workers[worker_id]);
+			struct sniffer_ring_pkt *rec;
+
+			while((rec = sniffer_ring_peek(&worker->dump_ring)) != NULL)
+			{
+				const bool is_sync = (rec->op == SNIFFER_OP_DUMP_SYNC);
+
+				sniffer_dump_writer_handle(writer, worker, rec);
+				sniffer_ring_pop(&worker->dump_ring, rec);
+				if(is_sync)
+				{
+					__atomic_store_n(&worker->dump_synced, worker->dump_ring.tail,
+					                 __ATOMIC_RELEASE);
+				}
+				handled_nr++;
+			}
+		}
+
+		if(handled_nr == 0)
+		{
+			if(do_stop)
+			{
+				break;
+			}
+			nanosleep(&idle_time, NULL);
 		}
 	}
 
-destroy_decomp:
-	rohc_decomp_free(decomp);
-destroy_comp:
-	rohc_comp_free(comp);
-close_input:
-	pcap_close(handle);
-error:
-	return status;
+	/* close all dump files */
+	SNIFFER_LOG(LOG_INFO, "close %zu dump files", writer->open_nr);
+	while(writer->lru_first != NULL)
+	{
+		sniffer_dump_writer_close(writer, writer->lru_first);
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Write one packet from a dump ring in the dump file of its stream
+ *
+ * @param writer  The writer
+ * @param worker  The worker that dumped the packet
+ * @param rec     The dumped packet
+ */
+static void sniffer_dump_writer_handle(struct sniffer_dump_writer *const writer,
+                                       const struct sniffer_worker *const worker,
+                                       const struct sniffer_ring_pkt *const rec)
+{
+	struct sniffer_dump_stream *stream;
+	char dump_filename[1024];
+
+	/* write all pending packets to the disk if asked by the worker */
+	if(rec->op == SNIFFER_OP_DUMP_SYNC)
+	{
+		for(stream = writer->lru_first; stream != NULL; stream = stream->lru_next)
+		{
+			pcap_dump_flush(stream->dumper);
+		}
+		return;
+	}
+
+	assert(rec->cid < worker->dump_streams_nr);
+	stream = &(worker->dump_streams[rec->cid]);
+	snprintf(dump_filename, 1024, "%s_cid_%u.pcap", worker->dump_prefix,
+	         rec->cid);
+
+	/* start a new dump file if the context is used for a new stream */
+	if(rec->op == SNIFFER_OP_DUMP_NEW && stream->dumper != NULL)
+	{
+		if(is_verbose)
+		{
+			SNIFFER_LOG(LOG_INFO, "replace dump file '%s' for context with ID %u",
+			            dump_filename, rec->cid);
+		}
+		sniffer_dump_writer_close(writer, stream);
+	}
+
+	if(stream->dumper == NULL)
+	{
+		/* close the least recently used dump file if too many are open */
+		if(writer->open_nr >= writer->open_max)
+		{
+			sniffer_dump_writer_close(writer, writer->lru_last);
+			__atomic_store_n(&writer->evictions_nr, writer->evictions_nr + 1,
+			                 __ATOMIC_RELAXED);
+		}
+
+		/* create a new dump file for a new stream (any previous file is
+		 * truncated), append to the dump file of an existing stream */
+		if(rec->op == SNIFFER_OP_DUMP_PKT && stream->is_created)
+		{
+			stream->dumper = pcap_dump_open_append(writer->handle, dump_filename);
+		}
+		else
+		{
+			stream->dumper = pcap_dump_open(writer->handle, dump_filename);
+		}
+		if(stream->dumper == NULL)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to open dump file '%s' for context "
+			            "with ID %u: %s", dump_filename, rec->cid,
+			            pcap_geterr(writer->handle));
+			return;
+		}
+		stream->is_created = true;
+		__atomic_store_n(&writer->open_nr, writer->open_nr + 1,
+		                 __ATOMIC_RELAXED);
+	}
+	else if(stream != writer->lru_first)
+	{
+		/* unlink the dump file from the LRU list */
+		stream->lru_prev->lru_next = stream->lru_next;
+		if(stream->lru_next != NULL)
+		{
+			stream->lru_next->lru_prev = stream->lru_prev;
+		}
+		else
+		{
+			writer->lru_last = stream->lru_prev;
+		}
+	}
+
+	/* the dump file is now the most recently used one */
+	if(stream != writer->lru_first)
+	{
+		stream->lru_prev = NULL;
+		stream->lru_next = writer->lru_first;
+		if(writer->lru_first != NULL)
+		{
+			writer->lru_first->lru_prev = stream;
+		}
+		else
+		{
+			writer->lru_last = stream;
+		}
+		writer->lru_first = stream;
+	}
+
+	pcap_dump((u_char *) stream->dumper, &rec->header, rec->data);
+}
+
+
+/**
+ * @brief Close the dump file of one stream
+ *
+ * @param writer  The writer
+ * @param stream  The stream with an open dump file
+ */
+static void sniffer_dump_writer_close(struct sniffer_dump_writer *const writer,
+                                      struct sniffer_dump_stream *const stream)
+{
+	assert(stream->dumper != NULL);
+
+	if(stream->lru_prev != NULL)
+	{
+		stream->lru_prev->lru_next = stream->lru_next;
+	}
+	else
+	{
+		writer->lru_first = stream->lru_next;
+	}
+	if(stream->lru_next != NULL)
+	{
+		stream->lru_next->lru_prev = stream->lru_prev;
+	}
+	else
+	{
+		writer->lru_last = stream->lru_prev;
+	}
+	stream->lru_prev = NULL;
+	stream->lru_next = NULL;
+
+	pcap_dump_close(stream->dumper);
+	stream->dumper = NULL;
+	__atomic_store_n(&writer->open_nr, writer->open_nr - 1, __ATOMIC_RELAXED);
 }
 
 
@@ -1304,7 +2638,9 @@ error:
  * @param packet         The packet to compress/decompress (link layer included)
  * @param link_len_src   The length of the link layer header before IP data
  * @param handle         The PCAP handler that sniffed the packet
- * @param dumpers        The PCAP dumpers, one per context
+ * @param dump_ring      The ring of the packets to dump
+ * @param dump_prefix    The prefix of the names of the PCAP dump files
+ * @param feedback_send  IN/OUT: The feedback to piggyback on the next packet
  * @param cid            OUT: the CID used for the last packet
  * @param stats          IN/OUT: The sniffer stats
  * @return               1 if the process is successful
@@ -1321,7 +2657,8 @@ static int compress_decompress(struct rohc_comp *comp,
                                unsigned char *packet,
                                size_t link_len_src,
                                pcap_t *handle,
-                               pcap_dumper_t *dumpers[],
+                               struct sniffer_ring *const dump_ring,
+                               const char *const dump_prefix,
                                struct rohc_buf *const feedback_send,
                                unsigned int *const cid,
                                struct sniffer_stats_t *stats)
@@ -1439,6 +2776,7 @@ static int compress_decompress(struct rohc_comp *comp,
 	status = rohc_compress4(comp, uncomp_packet, &rohc_packet);
 	if(status != ROHC_STATUS_OK)
 	{
+		char dump_filename[1024];
 		pcap_dumper_t *dumper;
 
 		SNIFFER_LOG(LOG_WARNING, "compression failed");
@@ -1446,18 +2784,18 @@ static int compress_decompress(struct rohc_comp *comp,
 		rohc_buf_push(&uncomp_packet, link_len_src);
 
 		/* open the new dumper */
-		dumper = pcap_dump_open(handle, "./dump_stream_default.pcap");
+		snprintf(dump_filename, 1024, "%s_default.pcap", dump_prefix);
+		dumper = pcap_dump_open(handle, dump_filename);
 		if(dumper == NULL)
 		{
 			SNIFFER_LOG(LOG_WARNING, "failed to open new dump file '%s'",
-			            "./dump_stream_default.pcap");
+			            dump_filename);
 			assert(0);
 			goto error;
 		}
 
 		/* dump the IP packet */
-		SNIFFER_LOG(LOG_INFO, "dump packet in file '%s'",
-		            "./dump_stream_default.pcap");
+		SNIFFER_LOG(LOG_INFO, "dump packet in file '%s'", dump_filename);
 		pcap_dump((u_char *) dumper, &header, packet);
 
 		SNIFFER_LOG(LOG_INFO, "close dump file");
@@ -1540,46 +2878,12 @@ static int compress_decompress(struct rohc_comp *comp,
 		stats->comp_nr_reused_cid++;
 	}
 
-	/* open a new dumper if none exists or the stream changed */
-	if(comp_last_packet_info.is_context_init)
-	{
-		char dump_filename[1024];
-
-		snprintf(dump_filename, 1024, "./dump_stream_cid_%u.pcap",
-		         comp_last_packet_info.context_id);
-		/* TODO: check result */
-
-		/* close the previous dumper and remove its file if one was opened */
-		if(dumpers[comp_last_packet_info.context_id] != NULL)
-		{
-			if(is_verbose)
-			{
-				SNIFFER_LOG(LOG_INFO, "replace dump file '%s' for context with "
-				            "ID %u", dump_filename,
-				            comp_last_packet_info.context_id);
-			}
-			pcap_dump_close(dumpers[comp_last_packet_info.context_id]);
-			unlink(dump_filename);
-			/* TODO: check result */
-		}
-
-		/* open the new dumper */
-		dumpers[comp_last_packet_info.context_id] =
-			pcap_dump_open(handle, dump_filename);
-		if(dumpers[comp_last_packet_info.context_id] == NULL)
-		{
-			SNIFFER_LOG(LOG_WARNING, "failed to open new dump file '%s' for "
-			            "context with ID %u", dump_filename,
-			            comp_last_packet_info.context_id);
-			assert(0);
-			goto error;
-		}
-	}
-
-	/* dump the IP packet */
+	/* dump the IP packet in the file of its stream, a new file if the
+	 * context is used for a new stream: the writer thread writes it later */
 	rohc_buf_push(&uncomp_packet, link_len_src);
-	pcap_dump((u_char *) dumpers[comp_last_packet_info.context_id],
-	          &header, packet);
+	sniffer_ring_push(dump_ring, comp_last_packet_info.is_context_init ?
+	                  SNIFFER_OP_DUMP_NEW : SNIFFER_OP_DUMP_PKT,
+	                  comp_last_packet_info.context_id, &header, packet);
 	rohc_buf_pull(&uncomp_packet, link_len_src);
 
 	/* record the CID */
@@ -1868,7 +3172,7 @@ too_short:
 /**
  * @brief Callback to print traces of the ROHC library
  *
- * @param priv_ctxt  An optional private context, may be NULL
+ * @param priv_ctxt  The worker the compressor/decompressor belongs to
  * @param level      The priority level of the trace
  * @param entity     The entity that emitted the trace among:
  *                    \li ROHC_TRACE_COMP
@@ -1877,12 +3181,14 @@ too_short:
  *                   the trace is related to
  * @param format     The format string of the trace
  */
-static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
+static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
                               const rohc_trace_entity_t entity __attribute__((unused)),
                               const int profile __attribute__((unused)),
                               const char *format, ...)
 {
+	struct sniffer_worker *const worker = priv_ctxt;
+
 	if(level >= ROHC_TRACE_WARNING || is_verbose)
 	{
 		va_list args;
@@ -1908,35 +3214,35 @@ static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
 		}
 	}
 
-	if(last_traces_last == -1)
+	if(worker->last_traces_last == -1)
 	{
-		last_traces_last = 0;
+		worker->last_traces_last = 0;
 	}
 	else
 	{
-		last_traces_last = (last_traces_last + 1) % MAX_LAST_TRACES;
+		worker->last_traces_last = (worker->last_traces_last + 1) % MAX_LAST_TRACES;
 	}
 	{
 		va_list args;
 		va_start(args, format);
-		vsnprintf(last_traces[last_traces_last], MAX_TRACE_LEN + 1, format, args);
-		last_traces[last_traces_last][MAX_TRACE_LEN] = '\0';
+		vsnprintf(worker->last_traces[worker->last_traces_last], MAX_TRACE_LEN + 1, format, args);
+		worker->last_traces[worker->last_traces_last][MAX_TRACE_LEN] = '\0';
 		/* TODO: check return code */
 		va_end(args);
 		/* remove the final \n if present */
-		if(strlen(last_traces[last_traces_last]) >= 1 &&
-		   last_traces[last_traces_last][strlen(last_traces[last_traces_last]) - 1] == '\n')
+		if(strlen(worker->last_traces[worker->last_traces_last]) >= 1 &&
+		   worker->last_traces[worker->last_traces_last][strlen(worker->last_traces[worker->last_traces_last]) - 1] == '\n')
 		{
-			last_traces[last_traces_last][strlen(last_traces[last_traces_last]) - 1] = '\0';
+			worker->last_traces[worker->last_traces_last][strlen(worker->last_traces[worker->last_traces_last]) - 1] = '\0';
 		}
 	}
-	if(last_traces_first == -1)
+	if(worker->last_traces_first == -1)
 	{
-		last_traces_first = 0;
+		worker->last_traces_first = 0;
 	}
-	else if(last_traces_first == last_traces_last)
+	else if(worker->last_traces_first == worker->last_traces_last)
 	{
-		last_traces_first = (last_traces_first + 1) % MAX_LAST_TRACES;
+		worker->last_traces_first = (worker->last_traces_first + 1) % MAX_LAST_TRACES;
 	}
 }
 
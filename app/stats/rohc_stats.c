@@ -47,10 +47,15 @@
 #include <unistd.h>
 #include <errno.h>
 #include <limits.h> /* for INT_MAX */
+#include <inttypes.h> /* for PRIu64 */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <pthread.h>
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
 #include <protocols/ipv6.h>
+#include <protocols/ip_numbers.h>
 
 /* include for the PCAP library */
 #if HAVE_PCAP_PCAP_H == 1
@@ -108,6 +113,108 @@ struct vlan_hdr
 } __attribute__((packed));
 
 
+/** The maximum number of worker threads in parallel mode */
+#define STATS_MAX_WORKERS  64U
+
+/** The length of the global header of a PCAP file */
+#define PCAP_GLOBAL_HDR_LEN  24U
+/** The length of the header of one PCAP record */
+#define PCAP_RECORD_HDR_LEN  16U
+/** The magic number of PCAP files with microsecond timestamps */
+#define PCAP_MAGIC_USEC  0xa1b2c3d4U
+/** The magic number of PCAP files with nanosecond timestamps */
+#define PCAP_MAGIC_NSEC  0xa1b23c4dU
+/** The PCAP link types, they differ from the DLT_* values on some platforms */
+#define PCAP_LINKTYPE_ETHERNET   1U
+#define PCAP_LINKTYPE_RAW      101U
+#define PCAP_LINKTYPE_LINUX_SLL  113U
+
+
+/** A PCAP file mapped in memory, shared by all the workers of parallel mode */
+struct stats_capture
+{
+	const unsigned char *data; /**< The content of the PCAP file */
+	size_t len;                /**< The length of the PCAP file */
+	bool is_swapped;           /**< Whether the file is in the other byte order */
+	bool is_nsec;              /**< Whether timestamps are in nanoseconds */
+	size_t link_len;           /**< The length of the link layer header */
+	size_t max_pkts_nr;        /**< The maximum number of packets, 0 for all */
+	size_t workers_nr;         /**< The number of workers */
+};
+
+/** The key of one unidirectional flow */
+struct stats_flow_key
+{
+	uint8_t saddr[16];   /**< The source IP address */
+	uint8_t daddr[16];   /**< The destination IP address */
+	uint16_t sport;      /**< The UDP/TCP source port, 0 if none */
+	uint16_t dport;      /**< The UDP/TCP destination port, 0 if none */
+	uint8_t ip_version;  /**< The IP version, 0 for non-IP packets */
+	uint8_t protocol;    /**< The protocol transported by IP */
+};
+
+/** The statistics aggregated for one flow */
+struct stats_flow
+{
+	struct stats_flow_key key;        /**< The key of the flow */
+	unsigned long first_packet;       /**< The number of the first packet */
+	struct rohc_ts first_ts;          /**< The timestamp of the first packet */
+	struct rohc_ts last_ts;           /**< The timestamp of the last packet */
+	int profile_id;                   /**< The profile of the last packet */
+	unsigned long packets_nr;         /**< The number of packets */
+	unsigned long ir_nr;              /**< The number of IR/IR-CR packets */
+	unsigned long ir_dyn_nr;          /**< The number of IR-DYN packets */
+	unsigned long contexts_init_nr;   /**< The number of context (re-)creations */
+	unsigned long long uncomp_bytes;     /**< The uncompressed bytes */
+	unsigned long long uncomp_hdr_bytes; /**< The uncompressed header bytes */
+	unsigned long long comp_bytes;       /**< The compressed bytes */
+	unsigned long long comp_hdr_bytes;   /**< The compressed header bytes */
+};
+
+/** The statistics aggregated for one second of capture */
+struct stats_second
+{
+	uint64_t sec;                        /**< The second of capture */
+	unsigned long packets_nr;            /**< The number of packets */
+	unsigned long ir_nr;                 /**< The number of IR/IR-CR/IR-DYN packets */
+	unsigned long long uncomp_bytes;     /**< The uncompressed bytes */
+	unsigned long long uncomp_hdr_bytes; /**< The uncompressed header bytes */
+	unsigned long long comp_bytes;       /**< The compressed bytes */
+	unsigned long long comp_hdr_bytes;   /**< The compressed header bytes */
+};
+
+/**
+ * @brief One worker of parallel mode
+ *
+ * Every worker walks the whole PCAP file, but only compresses the packets
+ * of the flows that hash to it. One flow is thus handled by one single
+ * compressor, in capture order.
+ */
+struct stats_worker
+{
+	size_t id;                            /**< The ID of the worker */
+	pthread_t thread;                     /**< The thread of the worker */
+	const struct stats_capture *capture;  /**< The PCAP file to read */
+	struct rohc_comp *comp;               /**< The compressor of the worker */
+
+	struct stats_flow *flows;  /**< The flows, in order of appearance */
+	size_t flows_nr;           /**< The number of flows */
+	size_t flows_max;          /**< The number of allocated flows */
+	uint32_t *slots;           /**< The hash table of flows (index + 1) */
+	size_t slots_nr;           /**< The size of the hash table, a power of 2 */
+
+	struct stats_second *seconds; /**< The seconds of capture, in order */
+	size_t seconds_nr;            /**< The number of seconds */
+	size_t seconds_max;           /**< The number of allocated seconds */
+
+	unsigned long packets_nr;  /**< The number of packets compressed */
+	bool is_failure;           /**< Whether the worker failed */
+};
+
+/** Set by the first worker that fails to stop the other ones */
+static int stats_workers_stop = 0;
+
+
 /** Whether the application runs in verbose mode or not */
 static enum
 {
@@ -141,6 +248,49 @@ static int generate_comp_stats_one(struct rohc_comp *comp,
                                    size_t link_len)
 	__attribute__((warn_unused_result, nonnull(1, 4)));
 
+static int generate_comp_stats_parallel(const rohc_cid_type_t cid_type,
+                                        const unsigned int max_contexts,
+                                        const char *const source,
+                                        const size_t max_pkts_nr,
+                                        const size_t workers_nr,
+                                        const char *const output_name)
+	__attribute__((warn_unused_result, nonnull(3)));
+static void * stats_worker_run(void *const arg)
+	__attribute__((nonnull(1)));
+static bool stats_worker_one(struct stats_worker *const worker,
+                             const unsigned long num_packet,
+                             const struct rohc_buf ip_packet,
+                             const struct stats_flow_key *const key,
+                             const uint64_t key_hash)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+static bool stats_parse_frame(const struct stats_capture *const capture,
+                              const unsigned long num_packet,
+                              const unsigned char *const frame,
+                              const size_t caplen,
+                              const size_t len,
+                              const struct rohc_ts arrival_time,
+                              struct rohc_buf *const ip_packet,
+                              struct stats_flow_key *const key)
+	__attribute__((warn_unused_result, nonnull(1, 3, 7, 8)));
+static uint64_t stats_flow_hash(const struct stats_flow_key *const key)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static struct stats_flow * stats_flow_get(struct stats_worker *const worker,
+                                          const struct stats_flow_key *const key,
+                                          const uint64_t key_hash)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static struct stats_second * stats_second_get(struct stats_worker *const worker,
+                                              const uint64_t sec)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool stats_write_csv(FILE *const output,
+                            const struct stats_worker *const workers,
+                            const size_t workers_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static int stats_flow_cmp(const void *const flow1, const void *const flow2)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+static uint32_t stats_pcap_u32(const struct stats_capture *const capture,
+                               const unsigned char *const field)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+
 static int generate_decomp_stats_all(const rohc_cid_type_t cid_type,
                                      const unsigned int max_contexts,
                                      const char *source,
@@ -193,6 +343,8 @@ int main(int argc, char *argv[])
 	int status = 1;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	int max_pkts_nr = 0; /* 0 means all PCAP file or infinite for live capture */
+	int workers_nr = 0; /* 0 means no parallel mode */
+	char *output_name = NULL;
 	size_t max_possible_contexts = ROHC_SMALL_CID_MAX + 1;
 	rohc_cid_type_t cid_type = ROHC_SMALL_CID;
 	int args_used;
@@ -257,6 +409,30 @@ int main(int argc, char *argv[])
 			max_pkts_nr = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--parallel"))
+		{
+			/* get the number of worker threads of parallel mode */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --parallel parameter\n");
+				usage();
+				goto error;
+			}
+			workers_nr = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--output"))
+		{
+			/* get the name of the file for the statistics of parallel mode */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --output parameter\n");
+				usage();
+				goto error;
+			}
+			output_name = argv[1];
+			args_used++;
+		}
 		else if(test_type == NULL)
 		{
 			/* get the name of the test */
@@ -336,6 +512,28 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* parallel mode runs 1 to STATS_MAX_WORKERS compressors */
+	if(workers_nr < 0 || workers_nr > STATS_MAX_WORKERS)
+	{
+		fprintf(stderr, "the number of worker threads should be between 1 "
+		        "and %u\n\n", STATS_MAX_WORKERS);
+		usage();
+		goto error;
+	}
+	if(workers_nr > 0 && strcmp(test_type, "comp") != 0)
+	{
+		fprintf(stderr, "parallel mode is only available for the 'comp' "
+		        "action\n\n");
+		usage();
+		goto error;
+	}
+	if(output_name != NULL && workers_nr == 0)
+	{
+		fprintf(stderr, "option --output requires option --parallel\n\n");
+		usage();
+		goto error;
+	}
+
 	/* the source is mandatory */
 	if(source_descr == NULL)
 	{
@@ -350,6 +548,12 @@ int main(int argc, char *argv[])
 		/* do nothing with the packets from the capture to estimate program overhead */
 		status = generate_dummy_stats_all(source_descr, max_pkts_nr);
 	}
+	else if(strcmp(test_type, "comp") == 0 && workers_nr > 0)
+	{
+		/* compress the flows of the capture with several threads */
+		status = generate_comp_stats_parallel(cid_type, max_contexts, source_descr,
+		                                      max_pkts_nr, workers_nr, output_name);
+	}
 	else if(strcmp(test_type, "comp") == 0)
 	{
 		/* test ROHC compression with the packets from the capture */
@@ -398,6 +602,15 @@ static void usage(void)
 	       "The shell script rohc_stats.sh could be used to generate a HTML\n"
 	       "report.\n"
 	       "\n"
+	       "In parallel mode, the rohc_stats tool maps the PCAP file in memory\n"
+	       "and compresses the flows with several threads, each with its own\n"
+	       "compressor. The packets of one flow are compressed in capture order.\n"
+	       "Instead of one line per packet, it outputs comma-separated records:\n\n"
+	       "  * one 'FLOW' record per unidirectional flow, in order of appearance\n\n"
+	       "  * one 'SECOND' record per second of capture with packets\n\n"
+	       "The fields of both records are described by the header lines\n"
+	       "starting with '#'.\n"
+	       "\n"
 	       "Usage: rohc_stats [OPTIONS] ACTION CID_TYPE SOURCE\n"
 	       "\n"
 	       "Options:\n"
@@ -410,6 +623,11 @@ static void usage(void)
 	       "      --max-pkts-nr NUM   The maximum number of packets to (de)compress\n"
 	       "                          (0 means all packets from file or infinite for\n"
 	       "                           network device)\n"
+	       "      --parallel NUM      Compress the flows of the PCAP file with NUM\n"
+	       "                          threads, and output per-flow and per-second\n"
+	       "                          statistics ('comp' action only, max %u)\n"
+	       "      --output FILE       The file for the statistics of parallel mode\n"
+	       "                          (default: standard output)\n"
 	       "\n"
 	       "With:\n"
 	       "  ACTION    Run a dummy test with 'dummy',\n"
@@ -425,8 +643,10 @@ static void usage(void)
 	       "  rohc_stats comp smallcid /tmp/rtp.pcap  Generate statistics from a file\n"
 	       "  rohc_stats decomp largecid ~/lan.pcap   Generate statistics from a file\n"
 	       "  rohc_stats comp largecid eth0           Generate statistics from Ethernet device 'eth0'\n"
+	       "  rohc_stats --parallel 8 --output lan.csv comp largecid ~/lan.pcap\n"
+	       "                                          Generate statistics from a file with 8 threads\n"
 	       "\n"
-	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n", STATS_MAX_WORKERS);
 }
 
 
@@ -931,6 +1151,863 @@ error:
 }
 
 
+/**
+ * @brief Generate ROHC compression statistics with several threads
+ *
+ * The PCAP file is mapped in memory. Every worker walks the whole file, and
+ * compresses the packets of the flows that hash to it with its own
+ * compressor. The statistics are aggregated per flow and per second of
+ * capture, then written as comma-separated records once all the workers
+ * are done.
+ *
+ * @param cid_type       The type of CIDs the compressors shall use
+ * @param max_contexts   The maximum number of ROHC contexts per compressor
+ * @param source         The PCAP file that contains the IP packets
+ * @param max_pkts_nr    The maximum number of packets to compress
+ * @param workers_nr     The number of worker threads
+ * @param output_name    The file to write statistics in, NULL or "-" for
+ *                       the standard output
+ * @return               0 in case of success,
+ *                       1 in case of failure
+ */
+static int generate_comp_stats_parallel(const rohc_cid_type_t cid_type,
+                                        const unsigned int max_contexts,
+                                        const char *const source,
+                                        const size_t max_pkts_nr,
+                                        const size_t workers_nr,
+                                        const char *const output_name)
+{
+	struct stats_capture capture;
+	struct stats_worker *workers;
+	struct stat source_stat;
+	uint32_t magic;
+	uint32_t link_type;
+	void *map;
+	int fd;
+	FILE *output;
+	size_t started_nr = 0;
+	size_t i;
+	int ret;
+
+	int is_failure = 1;
+
+	memset(&capture, 0, sizeof(struct stats_capture));
+	capture.max_pkts_nr = max_pkts_nr;
+	capture.workers_nr = workers_nr;
+
+	/* map the source PCAP file in memory, live capture is not possible */
+	fd = open(source, O_RDONLY);
+	if(fd < 0)
+	{
+		fprintf(stderr, "failed to open the source pcap file '%s': %s (%d)\n",
+		        source, strerror(errno), errno);
+		goto error;
+	}
+	if(fstat(fd, &source_stat) != 0 || !S_ISREG(source_stat.st_mode))
+	{
+		fprintf(stderr, "parallel mode requires a regular PCAP file as source\n");
+		goto close_input;
+	}
+	if(source_stat.st_size < PCAP_GLOBAL_HDR_LEN)
+	{
+		fprintf(stderr, "source pcap file is too short for the PCAP global "
+		        "header\n");
+		goto close_input;
+	}
+	map = mmap(NULL, source_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(map == MAP_FAILED)
+	{
+		fprintf(stderr, "failed to map the source pcap file in memory: %s (%d)\n",
+		        strerror(errno), errno);
+		goto close_input;
+	}
+	/* the file is read once from beginning to end by every worker */
+	(void) madvise(map, source_stat.st_size, MADV_SEQUENTIAL);
+	capture.data = map;
+	capture.len = source_stat.st_size;
+
+	/* detect the byte order and the timestamp precision of the file */
+	memcpy(&magic, capture.data, sizeof(uint32_t));
+	if(magic == PCAP_MAGIC_USEC || magic == PCAP_MAGIC_NSEC)
+	{
+		capture.is_swapped = false;
+	}
+	else if(__builtin_bswap32(magic) == PCAP_MAGIC_USEC ||
+	        __builtin_bswap32(magic) == PCAP_MAGIC_NSEC)
+	{
+		capture.is_swapped = true;
+		magic = __builtin_bswap32(magic);
+	}
+	else
+	{
+		fprintf(stderr, "source file is not in PCAP format (magic 0x%08x)\n",
+		        magic);
+		goto unmap;
+	}
+	capture.is_nsec = (magic == PCAP_MAGIC_NSEC);
+
+	/* link layer in the source PCAP file must be Ethernet */
+	link_type = stats_pcap_u32(&capture, capture.data + 20) & 0xffffU;
+	if(link_type == PCAP_LINKTYPE_ETHERNET)
+	{
+		capture.link_len = ETHER_HDR_LEN;
+	}
+	else if(link_type == PCAP_LINKTYPE_LINUX_SLL)
+	{
+		capture.link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else if(link_type == PCAP_LINKTYPE_RAW || link_type == DLT_RAW)
+	{
+		capture.link_len = 0;
+	}
+	else
+	{
+		fprintf(stderr, "link type %u not supported in source PCAP file "
+		        "(supported = %u, %u, %u)\n", link_type, PCAP_LINKTYPE_ETHERNET,
+		        PCAP_LINKTYPE_LINUX_SLL, PCAP_LINKTYPE_RAW);
+		goto unmap;
+	}
+
+	/* open the output before compressing anything */
+	if(output_name == NULL || strcmp(output_name, "-") == 0)
+	{
+		output = stdout;
+	}
+	else
+	{
+		output = fopen(output_name, "w");
+		if(output == NULL)
+		{
+			fprintf(stderr, "failed to open the output file '%s': %s (%d)\n",
+			        output_name, strerror(errno), errno);
+			goto unmap;
+		}
+	}
+
+	workers = calloc(workers_nr, sizeof(struct stats_worker));
+	if(workers == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu workers\n", workers_nr);
+		goto close_output;
+	}
+
+	/* initialize the random generator */
+	srand(time(NULL));
+
+	/* create one compressor per worker */
+	for(i = 0; i < workers_nr; i++)
+	{
+		struct stats_worker *const worker = &(workers[i]);
+
+		worker->id = i;
+		worker->capture = &capture;
+
+		worker->comp = rohc_comp_new2(cid_type, max_contexts - 1,
+		                              gen_random_num, NULL);
+		if(worker->comp == NULL)
+		{
+			fprintf(stderr, "cannot create the ROHC compressor of worker #%zu\n", i);
+			goto free_workers;
+		}
+		if(verbosity == VERBOSITY_FULL &&
+		   !rohc_comp_set_traces_cb2(worker->comp, print_rohc_traces, NULL))
+		{
+			fprintf(stderr, "failed to set the callback for traces on "
+			        "compressor\n");
+			goto free_workers;
+		}
+		if(!rohc_comp_set_features(worker->comp,
+		                           ROHC_COMP_FEATURE_TIME_BASED_REFRESHES))
+		{
+			fprintf(stderr, "failed to enable periodic refreshes of contexts "
+			        "based on inter-packet delay\n");
+			goto free_workers;
+		}
+		if(!rohc_comp_enable_profiles(worker->comp, ROHC_PROFILE_UNCOMPRESSED,
+		                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+		                              ROHC_PROFILE_RTP, ROHC_PROFILE_ESP,
+		                              ROHC_PROFILE_TCP, -1))
+		{
+			fprintf(stderr, "failed to enable the compression profiles\n");
+			goto free_workers;
+		}
+		if(!rohc_comp_set_rtp_detection_cb(worker->comp, rohc_comp_rtp_cb, NULL))
+		{
+			goto free_workers;
+		}
+	}
+
+	/* compress the flows of the capture in parallel */
+	for(started_nr = 0; started_nr < workers_nr; started_nr++)
+	{
+		ret = pthread_create(&(workers[started_nr].thread), NULL,
+		                     stats_worker_run, &(workers[started_nr]));
+		if(ret != 0)
+		{
+			fprintf(stderr, "failed to create the thread of worker #%zu: %s (%d)\n",
+			        started_nr, strerror(ret), ret);
+			__atomic_store_n(&stats_workers_stop, 1, __ATOMIC_RELAXED);
+			break;
+		}
+	}
+	for(i = 0; i < started_nr; i++)
+	{
+		pthread_join(workers[i].thread, NULL);
+	}
+	if(started_nr < workers_nr)
+	{
+		goto free_workers;
+	}
+	for(i = 0; i < workers_nr; i++)
+	{
+		if(workers[i].is_failure)
+		{
+			goto free_workers;
+		}
+	}
+
+	/* output the statistics aggregated by all the workers */
+	if(!stats_write_csv(output, workers, workers_nr))
+	{
+		fprintf(stderr, "failed to write the statistics: %s (%d)\n",
+		        strerror(errno), errno);
+		goto free_workers;
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_workers:
+	for(i = 0; i < workers_nr; i++)
+	{
+		if(workers[i].comp != NULL)
+		{
+			rohc_comp_free(workers[i].comp);
+		}
+		free(workers[i].flows);
+		free(workers[i].slots);
+		free(workers[i].seconds);
+	}
+	free(workers);
+close_output:
+	if(output != stdout && fclose(output) != 0)
+	{
+		fprintf(stderr, "failed to close the output file '%s': %s (%d)\n",
+		        output_name, strerror(errno), errno);
+		is_failure = 1;
+	}
+unmap:
+	munmap(map, source_stat.st_size);
+close_input:
+	close(fd);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief The main loop of one worker of parallel mode
+ *
+ * @param arg  The worker
+ * @return     Always NULL
+ */
+static void * stats_worker_run(void *const arg)
+{
+	struct stats_worker *const worker = arg;
+	const struct stats_capture *const capture = worker->capture;
+	size_t offset = PCAP_GLOBAL_HDR_LEN;
+	unsigned long num_packet = 0;
+
+	/* for each packet of the PCAP file, up to max_pkts_nr packets ; a
+	 * truncated last record ends the capture as pcap_next() does */
+	while((capture->max_pkts_nr == 0 || num_packet < capture->max_pkts_nr) &&
+	      (capture->len - offset) >= PCAP_RECORD_HDR_LEN)
+	{
+		const unsigned char *const rec = capture->data + offset;
+		const uint32_t caplen = stats_pcap_u32(capture, rec + 8);
+		const uint32_t len = stats_pcap_u32(capture, rec + 12);
+		struct rohc_ts arrival_time;
+		struct stats_flow_key key;
+		struct rohc_buf ip_packet;
+		uint64_t key_hash;
+
+		if((capture->len - offset - PCAP_RECORD_HDR_LEN) < caplen)
+		{
+			break;
+		}
+		offset += PCAP_RECORD_HDR_LEN + caplen;
+		num_packet++;
+
+		/* another worker failed, stop as soon as possible */
+		if(__atomic_load_n(&stats_workers_stop, __ATOMIC_RELAXED))
+		{
+			break;
+		}
+
+		arrival_time.sec = stats_pcap_u32(capture, rec);
+		arrival_time.nsec = stats_pcap_u32(capture, rec + 4);
+		if(!capture->is_nsec)
+		{
+			arrival_time.nsec *= 1000;
+		}
+
+		/* malformed frames are reported by the first worker only */
+		if(!stats_parse_frame(capture, num_packet, rec + PCAP_RECORD_HDR_LEN,
+		                      caplen, len, arrival_time, &ip_packet, &key))
+		{
+			if(worker->id == 0)
+			{
+				goto error;
+			}
+			continue;
+		}
+
+		/* the high bits select the worker, the low ones the hash table slot */
+		key_hash = stats_flow_hash(&key);
+		if(((key_hash >> 32) % capture->workers_nr) != worker->id)
+		{
+			continue;
+		}
+
+		if(!stats_worker_one(worker, num_packet, ip_packet, &key, key_hash))
+		{
+			fprintf(stderr, "packet %lu: failed to compress or generate stats "
+			        "for packet\n", num_packet);
+			goto error;
+		}
+	}
+
+	return NULL;
+
+error:
+	worker->is_failure = true;
+	__atomic_store_n(&stats_workers_stop, 1, __ATOMIC_RELAXED);
+	return NULL;
+}
+
+
+/**
+ * @brief Compress one IP packet and aggregate its statistics
+ *
+ * @param worker      The worker that compresses the flow of the packet
+ * @param num_packet  The number of the packet in the capture
+ * @param ip_packet   The IP packet to compress
+ * @param key         The key of the flow of the packet
+ * @param key_hash    The hash of the key of the flow
+ * @return            true if the packet was successfully compressed,
+ *                    false otherwise
+ */
+static bool stats_worker_one(struct stats_worker *const worker,
+                             const unsigned long num_packet,
+                             const struct rohc_buf ip_packet,
+                             const struct stats_flow_key *const key,
+                             const uint64_t key_hash)
+{
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf rohc_packet =
+		rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+	rohc_comp_last_packet_info2_t last_packet_info;
+	struct stats_second *second;
+	struct stats_flow *flow;
+	rohc_status_t status;
+
+	/* compress the IP packet */
+	status = rohc_compress4(worker->comp, ip_packet, &rohc_packet);
+	if(status != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "packet #%lu: compression failed\n", num_packet);
+		goto error;
+	}
+	worker->packets_nr++;
+
+	/* get some statistics about the last compressed packet */
+	last_packet_info.version_major = 0;
+	last_packet_info.version_minor = 0;
+	if(!rohc_comp_get_last_packet_info2(worker->comp, &last_packet_info))
+	{
+		fprintf(stderr, "packet #%lu: cannot get stats about the last compressed "
+		        "packet\n", num_packet);
+		goto error;
+	}
+
+	/* aggregate them per flow... */
+	flow = stats_flow_get(worker, key, key_hash);
+	if(flow == NULL)
+	{
+		fprintf(stderr, "packet #%lu: failed to allocate memory for one more "
+		        "flow\n", num_packet);
+		goto error;
+	}
+	if(flow->packets_nr == 0)
+	{
+		flow->first_packet = num_packet;
+		flow->first_ts = ip_packet.time;
+	}
+	flow->last_ts = ip_packet.time;
+	flow->profile_id = last_packet_info.profile_id;
+	flow->packets_nr++;
+	if(last_packet_info.packet_type == ROHC_PACKET_IR ||
+	   last_packet_info.packet_type == ROHC_PACKET_IR_CR)
+	{
+		flow->ir_nr++;
+	}
+	else if(last_packet_info.packet_type == ROHC_PACKET_IR_DYN)
+	{
+		flow->ir_dyn_nr++;
+	}
+	if(last_packet_info.is_context_init)
+	{
+		flow->contexts_init_nr++;
+	}
+	flow->uncomp_bytes += last_packet_info.total_last_uncomp_size;
+	flow->uncomp_hdr_bytes += last_packet_info.header_last_uncomp_size;
+	flow->comp_bytes += last_packet_info.total_last_comp_size;
+	flow->comp_hdr_bytes += last_packet_info.header_last_comp_size;
+
+	/* ... and per second of capture */
+	second = stats_second_get(worker, ip_packet.time.sec);
+	if(second == NULL)
+	{
+		fprintf(stderr, "packet #%lu: failed to allocate memory for one more "
+		        "second\n", num_packet);
+		goto error;
+	}
+	second->packets_nr++;
+	if(last_packet_info.packet_type == ROHC_PACKET_IR ||
+	   last_packet_info.packet_type == ROHC_PACKET_IR_CR ||
+	   last_packet_info.packet_type == ROHC_PACKET_IR_DYN)
+	{
+		second->ir_nr++;
+	}
+	second->uncomp_bytes += last_packet_info.total_last_uncomp_size;
+	second->uncomp_hdr_bytes += last_packet_info.header_last_uncomp_size;
+	second->comp_bytes += last_packet_info.total_last_comp_size;
+	second->comp_hdr_bytes += last_packet_info.header_last_comp_size;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the IP packet and the flow key of one captured frame
+ *
+ * @param capture       The PCAP file the frame comes from
+ * @param num_packet    The number of the frame in the capture
+ * @param frame         The captured frame (link layer included)
+ * @param caplen        The captured length of the frame
+ * @param len           The length of the frame on the wire
+ * @param arrival_time  The arrival time of the frame
+ * @param[out] ip_packet  The IP packet without the link layer
+ * @param[out] key        The key of the flow of the IP packet
+ * @return              true if the frame is well-formed, false otherwise
+ */
+static bool stats_parse_frame(const struct stats_capture *const capture,
+                              const unsigned long num_packet,
+                              const unsigned char *const frame,
+                              const size_t caplen,
+                              const size_t len,
+                              const struct rohc_ts arrival_time,
+                              struct rohc_buf *const ip_packet,
+                              struct stats_flow_key *const key)
+{
+	const struct rohc_buf frame_buf =
+		rohc_buf_init_full((uint8_t *) frame, caplen, arrival_time);
+	const unsigned char *ip;
+	size_t link_len = capture->link_len;
+	size_t l4_offset = 0;
+	bool has_ports = false;
+
+	*ip_packet = frame_buf;
+	memset(key, 0, sizeof(struct stats_flow_key));
+
+	/* check frame length */
+	if(len <= link_len || len != caplen)
+	{
+		fprintf(stderr, "packet #%lu: bad PCAP packet (len = %zu, caplen = %zu)\n",
+		        num_packet, len, caplen);
+		goto error;
+	}
+
+	/* skip the link layer header (including VLAN headers) */
+	if(!detect_vlan_hdrs(ip_packet, &link_len))
+	{
+		fprintf(stderr, "packet #%lu: malformed VLAN header\n", num_packet);
+		goto error;
+	}
+	rohc_buf_pull(ip_packet, link_len);
+	ip = rohc_buf_data(*ip_packet);
+
+	if(ip_packet->len >= sizeof(struct ipv4_hdr) && (ip[0] >> 4) == 4)
+	{
+		const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip;
+
+		/* check for padding after the IP packet in the Ethernet payload */
+		if(link_len == ETHER_HDR_LEN && len == ETHER_FRAME_MIN_LEN &&
+		   ntohs(ipv4->tot_len) < ip_packet->len)
+		{
+			ip_packet->len = ntohs(ipv4->tot_len);
+		}
+
+		key->ip_version = 4;
+		key->protocol = ipv4->protocol;
+		memcpy(key->saddr, &ipv4->saddr, sizeof(uint32_t));
+		memcpy(key->daddr, &ipv4->daddr, sizeof(uint32_t));
+		l4_offset = ipv4->ihl * 4U;
+		has_ports = ((ntohs(ipv4->frag_off) & (IPV4_MF | IPV4_OFFMASK)) == 0);
+	}
+	else if(ip_packet->len >= sizeof(struct ipv6_hdr) && (ip[0] >> 4) == 6)
+	{
+		const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip;
+
+		/* check for padding after the IP packet in the Ethernet payload */
+		if(link_len == ETHER_HDR_LEN && len == ETHER_FRAME_MIN_LEN &&
+		   (sizeof(struct ipv6_hdr) + ntohs(ipv6->plen)) < ip_packet->len)
+		{
+			ip_packet->len = sizeof(struct ipv6_hdr) + ntohs(ipv6->plen);
+		}
+
+		key->ip_version = 6;
+		key->protocol = ipv6->nh;
+		memcpy(key->saddr, &ipv6->saddr, sizeof(struct ipv6_addr));
+		memcpy(key->daddr, &ipv6->daddr, sizeof(struct ipv6_addr));
+		l4_offset = sizeof(struct ipv6_hdr);
+		has_ports = true;
+	}
+
+	/* the ports of the UDP/TCP flows */
+	if(has_ports &&
+	   (key->protocol == ROHC_IPPROTO_UDP || key->protocol == ROHC_IPPROTO_TCP ||
+	    key->protocol == ROHC_IPPROTO_UDPLITE) &&
+	   ip_packet->len >= (l4_offset + 4))
+	{
+		memcpy(&key->sport, ip + l4_offset, sizeof(uint16_t));
+		memcpy(&key->dport, ip + l4_offset + 2, sizeof(uint16_t));
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compute the hash of one flow key (64-bit FNV-1a)
+ *
+ * @param key  The key of the flow
+ * @return     The hash of the flow key
+ */
+static uint64_t stats_flow_hash(const struct stats_flow_key *const key)
+{
+	const uint8_t *const bytes = (const uint8_t *) key;
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	size_t i;
+
+	for(i = 0; i < sizeof(struct stats_flow_key); i++)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+
+/**
+ * @brief Get the statistics of one flow, create them if needed
+ *
+ * @param worker    The worker that handles the flow
+ * @param key       The key of the flow
+ * @param key_hash  The hash of the key of the flow
+ * @return          The statistics of the flow,
+ *                  NULL if memory is missing
+ */
+static struct stats_flow * stats_flow_get(struct stats_worker *const worker,
+                                          const struct stats_flow_key *const key,
+                                          const uint64_t key_hash)
+{
+	struct stats_flow *flow;
+	size_t slot;
+
+	/* grow the hash table at half load */
+	if((worker->flows_nr + 1) * 2 > worker->slots_nr)
+	{
+		const size_t new_slots_nr = (worker->slots_nr == 0 ? 256 :
+		                             worker->slots_nr * 2);
+		uint32_t *const new_slots = calloc(new_slots_nr, sizeof(uint32_t));
+		size_t i;
+
+		if(new_slots == NULL)
+		{
+			goto error;
+		}
+		for(i = 0; i < worker->flows_nr; i++)
+		{
+			slot = stats_flow_hash(&(worker->flows[i].key)) & (new_slots_nr - 1);
+			while(new_slots[slot] != 0)
+			{
+				slot = (slot + 1) & (new_slots_nr - 1);
+			}
+			new_slots[slot] = i + 1;
+		}
+		free(worker->slots);
+		worker->slots = new_slots;
+		worker->slots_nr = new_slots_nr;
+	}
+
+	/* linear probing */
+	slot = key_hash & (worker->slots_nr - 1);
+	while(worker->slots[slot] != 0)
+	{
+		flow = &(worker->flows[worker->slots[slot] - 1]);
+		if(memcmp(&(flow->key), key, sizeof(struct stats_flow_key)) == 0)
+		{
+			return flow;
+		}
+		slot = (slot + 1) & (worker->slots_nr - 1);
+	}
+
+	/* new flow */
+	if(worker->flows_nr == worker->flows_max)
+	{
+		const size_t new_flows_max = (worker->flows_max == 0 ? 128 :
+		                              worker->flows_max * 2);
+		struct stats_flow *const new_flows =
+			realloc(worker->flows, new_flows_max * sizeof(struct stats_flow));
+
+		if(new_flows == NULL)
+		{
+			goto error;
+		}
+		worker->flows = new_flows;
+		worker->flows_max = new_flows_max;
+	}
+	flow = &(worker->flows[worker->flows_nr]);
+	memset(flow, 0, sizeof(struct stats_flow));
+	memcpy(&(flow->key), key, sizeof(struct stats_flow_key));
+	worker->flows_nr++;
+	worker->slots[slot] = worker->flows_nr;
+
+	return flow;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the statistics of one second of capture, create them if needed
+ *
+ * The seconds are kept sorted. Packets are usually captured in time order,
+ * so the last second is checked first.
+ *
+ * @param worker  The worker
+ * @param sec     The second of capture
+ * @return        The statistics of the second,
+ *                NULL if memory is missing
+ */
+static struct stats_second * stats_second_get(struct stats_worker *const worker,
+                                              const uint64_t sec)
+{
+	size_t pos = worker->seconds_nr;
+
+	/* find the second or the position to insert it at */
+	while(pos > 0 && worker->seconds[pos - 1].sec > sec)
+	{
+		pos--;
+	}
+	if(pos > 0 && worker->seconds[pos - 1].sec == sec)
+	{
+		return &(worker->seconds[pos - 1]);
+	}
+
+	/* new second */
+	if(worker->seconds_nr == worker->seconds_max)
+	{
+		const size_t new_seconds_max = (worker->seconds_max == 0 ? 64 :
+		                                worker->seconds_max * 2);
+		struct stats_second *const new_seconds =
+			realloc(worker->seconds, new_seconds_max * sizeof(struct stats_second));
+
+		if(new_seconds == NULL)
+		{
+			goto error;
+		}
+		worker->seconds = new_seconds;
+		worker->seconds_max = new_seconds_max;
+	}
+	memmove(&(worker->seconds[pos + 1]), &(worker->seconds[pos]),
+	        (worker->seconds_nr - pos) * sizeof(struct stats_second));
+	memset(&(worker->seconds[pos]), 0, sizeof(struct stats_second));
+	worker->seconds[pos].sec = sec;
+	worker->seconds_nr++;
+
+	return &(worker->seconds[pos]);
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Compare two flows by their first packet, for qsort()
+ *
+ * @param flow1  The first flow
+ * @param flow2  The second flow
+ * @return       <0, 0 or >0 as qsort() expects
+ */
+static int stats_flow_cmp(const void *const flow1, const void *const flow2)
+{
+	const unsigned long first1 = (*(const struct stats_flow *const *) flow1)->first_packet;
+	const unsigned long first2 = (*(const struct stats_flow *const *) flow2)->first_packet;
+
+	return (first1 > first2) - (first1 < first2);
+}
+
+
+/**
+ * @brief Write the statistics of all the workers as comma-separated records
+ *
+ * Flows are written in order of appearance in the capture, so the output
+ * does not depend on the number of workers.
+ *
+ * @param output      The file to write the statistics in
+ * @param workers     The workers
+ * @param workers_nr  The number of workers
+ * @return            true if the statistics were successfully written,
+ *                    false otherwise
+ */
+static bool stats_write_csv(FILE *const output,
+                            const struct stats_worker *const workers,
+                            const size_t workers_nr)
+{
+	const struct stats_flow **flows;
+	size_t positions[STATS_MAX_WORKERS] = { 0 };
+	size_t flows_nr = 0;
+	size_t i;
+	size_t j;
+
+	/* sort the flows of all the workers by first packet */
+	for(i = 0; i < workers_nr; i++)
+	{
+		flows_nr += workers[i].flows_nr;
+	}
+	flows = malloc((flows_nr > 0 ? flows_nr : 1) * sizeof(struct stats_flow *));
+	if(flows == NULL)
+	{
+		goto error;
+	}
+	flows_nr = 0;
+	for(i = 0; i < workers_nr; i++)
+	{
+		for(j = 0; j < workers[i].flows_nr; j++)
+		{
+			flows[flows_nr] = &(workers[i].flows[j]);
+			flows_nr++;
+		}
+	}
+	qsort(flows, flows_nr, sizeof(struct stats_flow *), stats_flow_cmp);
+
+	fprintf(output, "#FLOW,first packet,IP version,protocol,source,destination,"
+	        "source port,destination port,profile,packets,IR packets,"
+	        "IR-DYN packets,context inits,uncompressed bytes,"
+	        "uncompressed header bytes,compressed bytes,compressed header bytes,"
+	        "first timestamp,last timestamp\n");
+	for(i = 0; i < flows_nr; i++)
+	{
+		const struct stats_flow *const flow = flows[i];
+		char saddr[INET6_ADDRSTRLEN] = "-";
+		char daddr[INET6_ADDRSTRLEN] = "-";
+
+		if(flow->key.ip_version != 0)
+		{
+			const int af = (flow->key.ip_version == 4 ? AF_INET : AF_INET6);
+			inet_ntop(af, flow->key.saddr, saddr, INET6_ADDRSTRLEN);
+			inet_ntop(af, flow->key.daddr, daddr, INET6_ADDRSTRLEN);
+		}
+		fprintf(output, "FLOW,%lu,%u,%u,%s,%s,%u,%u,%d,%lu,%lu,%lu,%lu,"
+		        "%llu,%llu,%llu,%llu,%" PRIu64 ".%09u,%" PRIu64 ".%09u\n",
+		        flow->first_packet, flow->key.ip_version, flow->key.protocol,
+		        saddr, daddr, ntohs(flow->key.sport), ntohs(flow->key.dport),
+		        flow->profile_id, flow->packets_nr, flow->ir_nr, flow->ir_dyn_nr,
+		        flow->contexts_init_nr, flow->uncomp_bytes, flow->uncomp_hdr_bytes,
+		        flow->comp_bytes, flow->comp_hdr_bytes,
+		        flow->first_ts.sec, (unsigned int) flow->first_ts.nsec,
+		        flow->last_ts.sec, (unsigned int) flow->last_ts.nsec);
+	}
+	free(flows);
+
+	/* merge the sorted seconds of all the workers */
+	fprintf(output, "#SECOND,second,packets,IR packets,uncompressed bytes,"
+	        "uncompressed header bytes,compressed bytes,compressed header bytes\n");
+	while(1)
+	{
+		struct stats_second sum;
+		bool found = false;
+
+		memset(&sum, 0, sizeof(struct stats_second));
+		for(i = 0; i < workers_nr; i++)
+		{
+			if(positions[i] < workers[i].seconds_nr &&
+			   (!found || workers[i].seconds[positions[i]].sec < sum.sec))
+			{
+				sum.sec = workers[i].seconds[positions[i]].sec;
+				found = true;
+			}
+		}
+		if(!found)
+		{
+			break;
+		}
+		for(i = 0; i < workers_nr; i++)
+		{
+			if(positions[i] < workers[i].seconds_nr &&
+			   workers[i].seconds[positions[i]].sec == sum.sec)
+			{
+				const struct stats_second *const second =
+					&(workers[i].seconds[positions[i]]);
+				sum.packets_nr += second->packets_nr;
+				sum.ir_nr += second->ir_nr;
+				sum.uncomp_bytes += second->uncomp_bytes;
+				sum.uncomp_hdr_bytes += second->uncomp_hdr_bytes;
+				sum.comp_bytes += second->comp_bytes;
+				sum.comp_hdr_bytes += second->comp_hdr_bytes;
+				positions[i]++;
+			}
+		}
+		fprintf(output, "SECOND,%" PRIu64 ",%lu,%lu,%llu,%llu,%llu,%llu\n",
+		        sum.sec, sum.packets_nr, sum.ir_nr, sum.uncomp_bytes,
+		        sum.uncomp_hdr_bytes, sum.comp_bytes, sum.comp_hdr_bytes);
+	}
+
+	return (fflush(output) == 0 && !ferror(output));
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Read one 32-bit field of the PCAP file in host byte order
+ *
+ * @param capture  The PCAP file
+ * @param field    The field to read
+ * @return         The value of the field
+ */
+static uint32_t stats_pcap_u32(const struct stats_capture *const capture,
+                               const unsigned char *const field)
+{
+	uint32_t value;
+
+	memcpy(&value, field, sizeof(uint32_t));
+
+	return (capture->is_swapped ? __builtin_bswap32(value) : value);
+}
+
+
 /**
  * @brief Generate ROHC decompression statistics with a flow of ROHC packets
  *
@@ -0,0 +1,1792 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_tunnel.c
+ * @brief  ROHC tunnel daemon
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The daemon runs one ROHC channel over UDP between two hosts. The IP packets
+ * routed to a local TUN interface are compressed and sent to the remote
+ * daemon in UDP datagrams; the ROHC packets received from the remote daemon
+ * are decompressed and written to the TUN interface.
+ *
+ * Each direction runs in its own thread, with its own ROHC compressor or
+ * decompressor:
+ *  - the TX thread reads a batch of IP packets from the TUN interface,
+ *    compresses them into a pool of buffers with some headroom, prepends the
+ *    pending feedback to the first ROHC packet of the batch, then sends the
+ *    whole batch with one sendmmsg(2) call;
+ *  - the RX thread receives a batch of ROHC packets with one recvmmsg(2)
+ *    call, decompresses it with \ref rohc_decompress_burst, writes the IP
+ *    packets to the TUN interface, then hands the received and generated
+ *    feedbacks to the TX thread through a lock-free ring.
+ *
+ * The main thread prints the throughput and the processing latencies of both
+ * directions periodically.
+ */
+
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h> /* for PRIu64 */
+#include <string.h>
+#include <assert.h>
+#include <time.h> /* for clock_gettime(2) */
+#include <stdarg.h>
+#include <limits.h> /* for INT_MAX */
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#if HAVE_LINUX_IF_TUN_H == 1
+#  include <linux/if_tun.h>
+#else
+#  error "linux/if_tun.h header not found, the ROHC tunnel requires Linux"
+#endif
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_packets.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The default MTU of the TUN interface */
+#define TUNNEL_DEFAULT_MTU  1500U
+/** The maximum MTU of the TUN interface */
+#define TUNNEL_MAX_MTU  65000U
+/** The extra room for the ROHC headers that are larger than the IP ones */
+#define TUNNEL_ROHC_OVERHEAD  100U
+/** The headroom of TX buffers, for the feedback piggybacked on ROHC packets */
+#define TUNNEL_HEADROOM  256U
+
+/** The default number of packets per batch */
+#define TUNNEL_DEFAULT_BATCH  32U
+/** The maximum number of packets per batch */
+#define TUNNEL_MAX_BATCH  1024U
+
+/** The number of slots of the feedback ring from RX to TX threads */
+#define TUNNEL_FB_RING_SLOTS  1024U
+/** The maximum length of one feedback in the ring */
+#define TUNNEL_FB_MAX_LEN  TUNNEL_HEADROOM
+
+/** How long the threads wait for packets before checking for the stop */
+#define TUNNEL_POLL_TIMEOUT_MS  100
+
+/** The number of sub-buckets per power of 2 of the latency histograms */
+#define TUNNEL_LAT_SUB_BITS  3U
+/** The number of buckets of the latency histograms */
+#define TUNNEL_LAT_BUCKETS  ((64U - TUNNEL_LAT_SUB_BITS + 1U) << TUNNEL_LAT_SUB_BITS)
+
+
+/** The statistics of one direction of the tunnel */
+struct tunnel_stats
+{
+	uint64_t pkts_nr;        /**< The number of IP packets handled */
+	uint64_t ip_bytes;       /**< The number of IP bytes */
+	uint64_t rohc_bytes;     /**< The number of ROHC bytes (feedback included) */
+	uint64_t failures_nr;    /**< The number of packets that failed */
+	uint64_t feedbacks_nr;   /**< The number of feedbacks sent or received */
+	uint64_t batches_nr;     /**< The number of batches */
+	/** The histogram of the processing latencies (in nanoseconds) */
+	uint64_t lat_hist[TUNNEL_LAT_BUCKETS];
+};
+
+/** The kinds of records in the feedback ring */
+typedef enum
+{
+	TUNNEL_FB_RCVD,  /**< Feedback received for the local compressor */
+	TUNNEL_FB_SEND,  /**< Feedback to send to the remote compressor */
+} tunnel_fb_kind_t;
+
+/** One feedback in the ring from RX to TX threads */
+struct tunnel_fb_slot
+{
+	tunnel_fb_kind_t kind;           /**< The kind of feedback */
+	size_t len;                      /**< The length of the feedback */
+	uint8_t data[TUNNEL_FB_MAX_LEN]; /**< The feedback bytes */
+};
+
+/**
+ * @brief The single-producer single-consumer ring of feedbacks
+ *
+ * The RX thread produces, the TX thread consumes. The indexes increase
+ * forever, the slot is the index modulo the number of slots.
+ */
+struct tunnel_fb_ring
+{
+	struct tunnel_fb_slot slots[TUNNEL_FB_RING_SLOTS]; /**< The feedbacks */
+	size_t head;   /**< The next slot to write, written by the producer */
+	uint64_t drops_nr;  /**< The feedbacks dropped because the ring was full */
+	size_t tail __attribute__((aligned(64))); /**< The next slot to read */
+};
+
+/**
+ * @brief A pool of ROHC buffers for one batch of packets
+ *
+ * All the buffers are allocated in one memory block. Every buffer starts
+ * with \e headroom bytes, so that bytes may be prepended to its content
+ * without any copy.
+ */
+struct tunnel_pool
+{
+	uint8_t *mem;            /**< The memory of all the buffers */
+	struct rohc_buf *bufs;   /**< The buffers */
+	size_t nr;               /**< The number of buffers */
+	size_t buf_size;         /**< The size of one buffer, headroom included */
+	size_t headroom;         /**< The headroom of every buffer */
+};
+
+/** The tunnel shared by all the threads */
+struct tunnel
+{
+	int tun_fd;         /**< The TUN interface */
+	int udp_fd;         /**< The UDP socket connected to the remote daemon */
+	int wake_fd;        /**< The eventfd to wake up the TX thread */
+	size_t mtu;         /**< The MTU of the TUN interface */
+	size_t batch;       /**< The maximum number of packets per batch */
+
+	struct rohc_comp *comp;      /**< The compressor of the TX thread */
+	struct rohc_decomp *decomp;  /**< The decompressor of the RX thread */
+
+	struct tunnel_fb_ring fb_ring;  /**< The feedbacks from RX to TX thread */
+
+	struct tunnel_stats tx_stats;   /**< The statistics of the TX thread */
+	struct tunnel_stats rx_stats;   /**< The statistics of the RX thread */
+};
+
+
+/** Whether the application runs in verbose mode or not */
+static enum
+{
+	VERBOSITY_NONE,
+	VERBOSITY_NORMAL,
+	VERBOSITY_FULL
+} verbosity = VERBOSITY_NORMAL;
+
+/** Whether the daemon shall stop, set by signals */
+static int tunnel_stop = 0;
+
+
+/* prototypes of private functions */
+static void usage(void);
+static void tunnel_interrupt(int signum);
+
+static bool tunnel_parse_addr(const char *const addr_str,
+                              const char *const port_str,
+                              struct sockaddr_storage *const addr,
+                              socklen_t *const addr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+static int tunnel_tun_open(const char *const name, const size_t mtu)
+	__attribute__((warn_unused_result, nonnull(1)));
+static int tunnel_udp_open(const struct sockaddr_storage *const local,
+                           const socklen_t local_len,
+                           const struct sockaddr_storage *const remote,
+                           const socklen_t remote_len)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+static bool tunnel_pool_init(struct tunnel_pool *const pool,
+                             const size_t nr,
+                             const size_t buf_size,
+                             const size_t headroom)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void tunnel_pool_reset(struct tunnel_pool *const pool)
+	__attribute__((nonnull(1)));
+static void tunnel_pool_free(struct tunnel_pool *const pool)
+	__attribute__((nonnull(1)));
+
+static void * tunnel_tx_run(void *const arg)
+	__attribute__((nonnull(1)));
+static bool tunnel_tx_send(struct tunnel *const tunnel,
+                           struct mmsghdr *const msgs,
+                           const size_t msgs_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void * tunnel_rx_run(void *const arg)
+	__attribute__((nonnull(1)));
+
+static bool tunnel_fb_push(struct tunnel_fb_ring *const ring,
+                           const tunnel_fb_kind_t kind,
+                           const struct rohc_buf feedback)
+	__attribute__((nonnull(1)));
+static const struct tunnel_fb_slot * tunnel_fb_peek(struct tunnel_fb_ring *const ring)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void tunnel_fb_pop(struct tunnel_fb_ring *const ring)
+	__attribute__((nonnull(1)));
+
+static void tunnel_stats_add(uint64_t *const counter, const uint64_t value)
+	__attribute__((nonnull(1)));
+static void tunnel_stats_lat(struct tunnel_stats *const stats,
+                             const uint64_t ns)
+	__attribute__((nonnull(1)));
+static void tunnel_stats_snapshot(const struct tunnel_stats *const stats,
+                                  struct tunnel_stats *const snapshot)
+	__attribute__((nonnull(1, 2)));
+static uint64_t tunnel_stats_percentile(const struct tunnel_stats *const cur,
+                                        const struct tunnel_stats *const prev,
+                                        const unsigned int percentile)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void tunnel_stats_print(const char *const name,
+                               const struct tunnel_stats *const cur,
+                               const struct tunnel_stats *const prev,
+                               const double duration)
+	__attribute__((nonnull(1, 2, 3)));
+
+static uint64_t tunnel_now(void)
+	__attribute__((warn_unused_result));
+
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Main function for the ROHC tunnel daemon
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct tunnel *tunnel;
+	char *tun_name = NULL;
+	char *local_addr_str = NULL;
+	char *local_port_str = NULL;
+	char *remote_addr_str = NULL;
+	char *remote_port_str = NULL;
+	char *cid_type_name = NULL;
+	struct sockaddr_storage local_addr;
+	struct sockaddr_storage remote_addr;
+	socklen_t local_addr_len;
+	socklen_t remote_addr_len;
+	rohc_cid_type_t cid_type = ROHC_SMALL_CID;
+	int max_contexts = ROHC_SMALL_CID_MAX + 1;
+	size_t max_possible_contexts = ROHC_SMALL_CID_MAX + 1;
+	int mtu = TUNNEL_DEFAULT_MTU;
+	int batch = TUNNEL_DEFAULT_BATCH;
+	int stats_interval = 1;
+	pthread_t tx_thread;
+	pthread_t rx_thread;
+	sigset_t threads_sigmask;
+	sigset_t main_sigmask;
+	struct tunnel_stats tx_prev;
+	struct tunnel_stats rx_prev;
+	struct tunnel_stats tx_total;
+	struct tunnel_stats rx_total;
+	uint64_t start_time;
+	uint64_t prev_time;
+	int args_used;
+	int ret;
+
+	int status = 1;
+
+	/* set to normal mode by default */
+	verbosity = VERBOSITY_NORMAL;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc <= 1)
+	{
+		usage();
+		goto error;
+	}
+
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_tunnel version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "--verbose"))
+		{
+			/* be more verbose */
+			verbosity = VERBOSITY_FULL;
+		}
+		else if(!strcmp(*argv, "--quiet"))
+		{
+			/* be more quiet */
+			verbosity = VERBOSITY_NONE;
+		}
+		else if(!strcmp(*argv, "--cid-type"))
+		{
+			/* get the type of CID to use within the ROHC library */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --cid-type parameter\n");
+				usage();
+				goto error;
+			}
+			cid_type_name = argv[1];
+			args_used++;
+
+			if(!strcmp(cid_type_name, "smallcid"))
+			{
+				cid_type = ROHC_SMALL_CID;
+				max_possible_contexts = ROHC_SMALL_CID_MAX + 1;
+			}
+			else if(!strcmp(cid_type_name, "largecid"))
+			{
+				cid_type = ROHC_LARGE_CID;
+				max_possible_contexts = ROHC_LARGE_CID_MAX + 1;
+			}
+			else
+			{
+				fprintf(stderr, "invalid CID type '%s', only 'smallcid' and "
+				        "'largecid' expected\n", cid_type_name);
+				usage();
+				goto error;
+			}
+		}
+		else if(!strcmp(*argv, "--max-contexts"))
+		{
+			/* get the maximum number of contexts the tunnel should use */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --max-contexts parameter\n");
+				usage();
+				goto error;
+			}
+			max_contexts = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--mtu"))
+		{
+			/* get the MTU of the TUN interface */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --mtu parameter\n");
+				usage();
+				goto error;
+			}
+			mtu = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--batch"))
+		{
+			/* get the maximum number of packets per batch */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --batch parameter\n");
+				usage();
+				goto error;
+			}
+			batch = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--stats-interval"))
+		{
+			/* get the interval between two prints of statistics */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "missing mandatory --stats-interval parameter\n");
+				usage();
+				goto error;
+			}
+			stats_interval = atoi(argv[1]);
+			args_used++;
+		}
+		else if(tun_name == NULL)
+		{
+			tun_name = argv[0];
+		}
+		else if(local_addr_str == NULL)
+		{
+			local_addr_str = argv[0];
+		}
+		else if(local_port_str == NULL)
+		{
+			local_port_str = argv[0];
+		}
+		else if(remote_addr_str == NULL)
+		{
+			remote_addr_str = argv[0];
+		}
+		else if(remote_port_str == NULL)
+		{
+			remote_port_str = argv[0];
+		}
+		else
+		{
+			/* do not accept more arguments without option name */
+			usage();
+			goto error;
+		}
+	}
+
+	/* all the parameters without option name are mandatory */
+	if(remote_port_str == NULL)
+	{
+		fprintf(stderr, "parameters TUN_NAME, LOCAL_ADDR, LOCAL_PORT, "
+		        "REMOTE_ADDR and REMOTE_PORT are mandatory\n\n");
+		usage();
+		goto error;
+	}
+	if(strlen(tun_name) >= IFNAMSIZ)
+	{
+		fprintf(stderr, "the name of the TUN interface should be shorter than "
+		        "%d characters\n\n", IFNAMSIZ);
+		usage();
+		goto error;
+	}
+	if(!tunnel_parse_addr(local_addr_str, local_port_str, &local_addr,
+	                      &local_addr_len))
+	{
+		fprintf(stderr, "invalid local address '%s' or port '%s'\n\n",
+		        local_addr_str, local_port_str);
+		usage();
+		goto error;
+	}
+	if(!tunnel_parse_addr(remote_addr_str, remote_port_str, &remote_addr,
+	                      &remote_addr_len))
+	{
+		fprintf(stderr, "invalid remote address '%s' or port '%s'\n\n",
+		        remote_addr_str, remote_port_str);
+		usage();
+		goto error;
+	}
+	if(local_addr.ss_family != remote_addr.ss_family)
+	{
+		fprintf(stderr, "local and remote addresses should be of the same "
+		        "IP version\n\n");
+		usage();
+		goto error;
+	}
+
+	/* the maximum number of ROHC contexts should be valid wrt CID type */
+	if(max_contexts < 1 || max_contexts > (int) max_possible_contexts)
+	{
+		fprintf(stderr, "the maximum number of ROHC contexts should be "
+		        "between 1 and %zu\n\n", max_possible_contexts);
+		usage();
+		goto error;
+	}
+	if(mtu < 68 || mtu > (int) TUNNEL_MAX_MTU)
+	{
+		fprintf(stderr, "the MTU should be between 68 and %u\n\n",
+		        TUNNEL_MAX_MTU);
+		usage();
+		goto error;
+	}
+	if(batch < 1 || batch > (int) TUNNEL_MAX_BATCH)
+	{
+		fprintf(stderr, "the number of packets per batch should be between 1 "
+		        "and %u\n\n", TUNNEL_MAX_BATCH);
+		usage();
+		goto error;
+	}
+	if(stats_interval < 0)
+	{
+		fprintf(stderr, "the interval between statistics should be positive\n\n");
+		usage();
+		goto error;
+	}
+
+	/* the ring of feedbacks is large, do not put it on the stack */
+	tunnel = calloc(1, sizeof(struct tunnel));
+	if(tunnel == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the tunnel\n");
+		goto error;
+	}
+	tunnel->mtu = mtu;
+	tunnel->batch = batch;
+
+	/* create the TUN interface, the UDP socket, and the wake-up event */
+	tunnel->tun_fd = tunnel_tun_open(tun_name, mtu);
+	if(tunnel->tun_fd < 0)
+	{
+		goto free_tunnel;
+	}
+	tunnel->udp_fd = tunnel_udp_open(&local_addr, local_addr_len,
+	                                 &remote_addr, remote_addr_len);
+	if(tunnel->udp_fd < 0)
+	{
+		goto close_tun;
+	}
+	tunnel->wake_fd = eventfd(0, EFD_NONBLOCK);
+	if(tunnel->wake_fd < 0)
+	{
+		fprintf(stderr, "failed to create the wake-up event: %s (%d)\n",
+		        strerror(errno), errno);
+		goto close_udp;
+	}
+
+	/* initialize the random generator */
+	srand(time(NULL));
+
+	/* create the ROHC compressor of the TX thread */
+	tunnel->comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_random_num,
+	                              NULL);
+	if(tunnel->comp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC compressor\n");
+		goto close_wake;
+	}
+	if(verbosity == VERBOSITY_FULL &&
+	   !rohc_comp_set_traces_cb2(tunnel->comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on compressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_features(tunnel->comp,
+	                           ROHC_COMP_FEATURE_TIME_BASED_REFRESHES))
+	{
+		fprintf(stderr, "failed to enable periodic refreshes of contexts based "
+		        "on inter-packet delay\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_enable_profiles(tunnel->comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	/* create the ROHC decompressor of the RX thread: O-mode, with the
+	 * feedbacks coalesced per context and flushed once per batch */
+	tunnel->decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_O_MODE);
+	if(tunnel->decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(verbosity == VERBOSITY_FULL &&
+	   !rohc_decomp_set_traces_cb2(tunnel->decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_set_features(tunnel->decomp,
+	                             ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK))
+	{
+		fprintf(stderr, "failed to enable the coalescing of feedbacks\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(tunnel->decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	/* the signals that stop the daemon are handled by the main thread only */
+	signal(SIGINT, tunnel_interrupt);
+	signal(SIGTERM, tunnel_interrupt);
+	sigemptyset(&threads_sigmask);
+	sigaddset(&threads_sigmask, SIGINT);
+	sigaddset(&threads_sigmask, SIGTERM);
+	if(pthread_sigmask(SIG_BLOCK, &threads_sigmask, &main_sigmask) != 0)
+	{
+		fprintf(stderr, "failed to block signals for threads\n");
+		goto destroy_decomp;
+	}
+	ret = pthread_create(&tx_thread, NULL, tunnel_tx_run, tunnel);
+	if(ret != 0)
+	{
+		fprintf(stderr, "failed to start the TX thread: %s (%d)\n",
+		        strerror(ret), ret);
+		pthread_sigmask(SIG_SETMASK, &main_sigmask, NULL);
+		goto destroy_decomp;
+	}
+	ret = pthread_create(&rx_thread, NULL, tunnel_rx_run, tunnel);
+	if(ret != 0)
+	{
+		fprintf(stderr, "failed to start the RX thread: %s (%d)\n",
+		        strerror(ret), ret);
+		__atomic_store_n(&tunnel_stop, 1, __ATOMIC_RELAXED);
+		pthread_join(tx_thread, NULL);
+		pthread_sigmask(SIG_SETMASK, &main_sigmask, NULL);
+		goto destroy_decomp;
+	}
+	pthread_sigmask(SIG_SETMASK, &main_sigmask, NULL);
+
+	if(verbosity != VERBOSITY_NONE)
+	{
+		printf("tunnel '%s' started: %s:%s <-> %s:%s, MTU %d, batches of up to "
+		       "%d packets\n", tun_name, local_addr_str, local_port_str,
+		       remote_addr_str, remote_port_str, mtu, batch);
+		fflush(stdout);
+	}
+
+	/* print the statistics of the last interval until the daemon is stopped */
+	memset(&tx_prev, 0, sizeof(struct tunnel_stats));
+	memset(&rx_prev, 0, sizeof(struct tunnel_stats));
+	start_time = tunnel_now();
+	prev_time = start_time;
+	while(!__atomic_load_n(&tunnel_stop, __ATOMIC_RELAXED))
+	{
+		const struct timespec tick = { .tv_sec = 0, .tv_nsec = 100000000 };
+		struct tunnel_stats tx_cur;
+		struct tunnel_stats rx_cur;
+		uint64_t cur_time;
+
+		/* a signal interrupts the sleep */
+		nanosleep(&tick, NULL);
+
+		cur_time = tunnel_now();
+		if(stats_interval == 0 || verbosity == VERBOSITY_NONE ||
+		   (cur_time - prev_time) < (stats_interval * 1000000000ULL))
+		{
+			continue;
+		}
+
+		tunnel_stats_snapshot(&tunnel->tx_stats, &tx_cur);
+		tunnel_stats_snapshot(&tunnel->rx_stats, &rx_cur);
+		printf("[%8.1f s]\n", (cur_time - start_time) / 1e9);
+		tunnel_stats_print("TX", &tx_cur, &tx_prev, (cur_time - prev_time) / 1e9);
+		tunnel_stats_print("RX", &rx_cur, &rx_prev, (cur_time - prev_time) / 1e9);
+		fflush(stdout);
+		tx_prev = tx_cur;
+		rx_prev = rx_cur;
+		prev_time = cur_time;
+	}
+
+	pthread_join(tx_thread, NULL);
+	pthread_join(rx_thread, NULL);
+
+	/* print the statistics of the whole run */
+	if(verbosity != VERBOSITY_NONE)
+	{
+		const double duration = (tunnel_now() - start_time) / 1e9;
+
+		memset(&tx_prev, 0, sizeof(struct tunnel_stats));
+		memset(&rx_prev, 0, sizeof(struct tunnel_stats));
+		tunnel_stats_snapshot(&tunnel->tx_stats, &tx_total);
+		tunnel_stats_snapshot(&tunnel->rx_stats, &rx_total);
+		printf("tunnel '%s' stopped after %.1f s\n", tun_name, duration);
+		tunnel_stats_print("TX", &tx_total, &tx_prev, duration);
+		tunnel_stats_print("RX", &rx_total, &rx_prev, duration);
+		printf("  %" PRIu64 " feedbacks dropped between RX and TX threads\n",
+		       __atomic_load_n(&tunnel->fb_ring.drops_nr, __ATOMIC_RELAXED));
+		fflush(stdout);
+	}
+
+	/* everything went fine */
+	status = 0;
+
+destroy_decomp:
+	rohc_decomp_free(tunnel->decomp);
+destroy_comp:
+	rohc_comp_free(tunnel->comp);
+close_wake:
+	close(tunnel->wake_fd);
+close_udp:
+	close(tunnel->udp_fd);
+close_tun:
+	close(tunnel->tun_fd);
+free_tunnel:
+	free(tunnel);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the tunnel daemon
+ */
+static void usage(void)
+{
+	printf("The ROHC tunnel daemon compresses the IP packets routed to a TUN\n"
+	       "interface, and sends them in UDP datagrams to a remote daemon that\n"
+	       "decompresses them. Both directions are handled.\n"
+	       "\n"
+	       "The daemon creates the TUN interface, but does not configure it:\n"
+	       "use ip(8) to set its addresses and to bring it up.\n"
+	       "\n"
+	       "Every --stats-interval seconds and when stopped, the daemon prints\n"
+	       "for each direction:\n"
+	       "  * the throughput in packets and bits per second,\n"
+	       "  * the compression ratio of the ROHC packets over the IP packets,\n"
+	       "  * the 50th, 90th and 99th percentiles of the latency between the\n"
+	       "    reception of a packet and its emission by the daemon.\n"
+	       "\n"
+	       "Usage: rohc_tunnel [OPTIONS] TUN_NAME LOCAL_ADDR LOCAL_PORT "
+	       "REMOTE_ADDR REMOTE_PORT\n"
+	       "\n"
+	       "Options:\n"
+	       "  -v, --version             Print version information and exit\n"
+	       "  -h, --help                Print this usage and exit\n"
+	       "      --verbose             Be more verbose\n"
+	       "      --quiet               Do not print statistics\n"
+	       "      --cid-type TYPE       The type of CID to use among 'smallcid'\n"
+	       "                            and 'largecid' (default: smallcid)\n"
+	       "      --max-contexts NUM    The maximum number of ROHC contexts to\n"
+	       "                            use in each direction (default: 16)\n"
+	       "      --mtu NUM             The MTU of the TUN interface (default: %u)\n"
+	       "      --batch NUM           The maximum number of packets read or\n"
+	       "                            written in one batch (default: %u, max %u)\n"
+	       "      --stats-interval SEC  The interval between two prints of the\n"
+	       "                            statistics, 0 to print them only at exit\n"
+	       "                            (default: 1)\n"
+	       "\n"
+	       "With:\n"
+	       "  TUN_NAME     The name of the TUN interface to create\n"
+	       "  LOCAL_ADDR   The local IPv4 or IPv6 address of the UDP socket\n"
+	       "  LOCAL_PORT   The local UDP port\n"
+	       "  REMOTE_ADDR  The IPv4 or IPv6 address of the remote daemon\n"
+	       "  REMOTE_PORT  The UDP port of the remote daemon\n"
+	       "\n"
+	       "Example:\n"
+	       "  rohc_tunnel rohc0 10.0.0.1 5000 10.0.0.2 5000\n"
+	       "  ip addr add 192.168.100.1/24 dev rohc0 && ip link set rohc0 up\n"
+	       "\n"
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n",
+	       TUNNEL_DEFAULT_MTU, TUNNEL_DEFAULT_BATCH, TUNNEL_MAX_BATCH);
+}
+
+
+/**
+ * @brief Handle the signals that stop the daemon
+ *
+ * @param signum  The signal that was received
+ */
+static void tunnel_interrupt(int signum)
+{
+	__atomic_store_n(&tunnel_stop, 1, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * @brief Parse one IPv4 or IPv6 address and one UDP port
+ *
+ * @param addr_str       The IP address to parse
+ * @param port_str       The UDP port to parse
+ * @param[out] addr      The parsed socket address
+ * @param[out] addr_len  The length of the parsed socket address
+ * @return               true if the address and port are valid,
+ *                       false otherwise
+ */
+static bool tunnel_parse_addr(const char *const addr_str,
+                              const char *const port_str,
+                              struct sockaddr_storage *const addr,
+                              socklen_t *const addr_len)
+{
+	const int port = atoi(port_str);
+
+	if(port < 1 || port > 0xffff)
+	{
+		goto error;
+	}
+
+	memset(addr, 0, sizeof(struct sockaddr_storage));
+	if(strchr(addr_str, ':') == NULL)
+	{
+		struct sockaddr_in *const addr4 = (struct sockaddr_in *) addr;
+
+		addr4->sin_family = AF_INET;
+		addr4->sin_port = htons(port);
+		if(inet_pton(AF_INET, addr_str, &addr4->sin_addr) != 1)
+		{
+			goto error;
+		}
+		*addr_len = sizeof(struct sockaddr_in);
+	}
+	else
+	{
+		struct sockaddr_in6 *const addr6 = (struct sockaddr_in6 *) addr;
+
+		addr6->sin6_family = AF_INET6;
+		addr6->sin6_port = htons(port);
+		if(inet_pton(AF_INET6, addr_str, &addr6->sin6_addr) != 1)
+		{
+			goto error;
+		}
+		*addr_len = sizeof(struct sockaddr_in6);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Create one TUN interface in non-blocking mode
+ *
+ * @param name  The name of the TUN interface
+ * @param mtu   The MTU of the TUN interface
+ * @return      The file descriptor of the TUN interface,
+ *              -1 in case of failure
+ */
+static int tunnel_tun_open(const char *const name, const size_t mtu)
+{
+	struct ifreq ifr;
+	int sock;
+	int fd;
+
+	fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+	if(fd < 0)
+	{
+		fprintf(stderr, "failed to open /dev/net/tun: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+
+	/* IP packets without the extra packet information header */
+	memset(&ifr, 0, sizeof(struct ifreq));
+	ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+	strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+	if(ioctl(fd, TUNSETIFF, &ifr) != 0)
+	{
+		fprintf(stderr, "failed to create TUN interface '%s': %s (%d)\n",
+		        name, strerror(errno), errno);
+		goto close_tun;
+	}
+
+	/* the IP packets shall fit in the buffers of the daemon */
+	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if(sock < 0)
+	{
+		fprintf(stderr, "failed to create a socket to configure the TUN "
+		        "interface: %s (%d)\n", strerror(errno), errno);
+		goto close_tun;
+	}
+	ifr.ifr_mtu = mtu;
+	if(ioctl(sock, SIOCSIFMTU, &ifr) != 0)
+	{
+		fprintf(stderr, "failed to set MTU %zu on TUN interface '%s': %s (%d)\n",
+		        mtu, name, strerror(errno), errno);
+		close(sock);
+		goto close_tun;
+	}
+	close(sock);
+
+	return fd;
+
+close_tun:
+	close(fd);
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Create the UDP socket connected to the remote daemon
+ *
+ * @param local       The local address of the socket
+ * @param local_len   The length of the local address
+ * @param remote      The address of the remote daemon
+ * @param remote_len  The length of the address of the remote daemon
+ * @return            The file descriptor of the UDP socket,
+ *                    -1 in case of failure
+ */
+static int tunnel_udp_open(const struct sockaddr_storage *const local,
+                           const socklen_t local_len,
+                           const struct sockaddr_storage *const remote,
+                           const socklen_t remote_len)
+{
+	const int buf_size = 4 * 1024 * 1024;
+	int fd;
+
+	fd = socket(local->ss_family, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+	if(fd < 0)
+	{
+		fprintf(stderr, "failed to create the UDP socket: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+
+	/* large socket buffers absorb the bursts, failures are not fatal */
+	(void) setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buf_size, sizeof(int));
+	(void) setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &buf_size, sizeof(int));
+
+	if(bind(fd, (const struct sockaddr *) local, local_len) != 0)
+	{
+		fprintf(stderr, "failed to bind the UDP socket: %s (%d)\n",
+		        strerror(errno), errno);
+		goto close_udp;
+	}
+
+	/* only the remote daemon may send ROHC packets */
+	if(connect(fd, (const struct sockaddr *) remote, remote_len) != 0)
+	{
+		fprintf(stderr, "failed to connect the UDP socket: %s (%d)\n",
+		        strerror(errno), errno);
+		goto close_udp;
+	}
+
+	return fd;
+
+close_udp:
+	close(fd);
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Allocate one pool of ROHC buffers
+ *
+ * @param pool      The pool to initialize
+ * @param nr        The number of buffers
+ * @param buf_size  The size of one buffer, headroom included
+ * @param headroom  The headroom at the beginning of every buffer
+ * @return          true if the pool was successfully allocated,
+ *                  false otherwise
+ */
+static bool tunnel_pool_init(struct tunnel_pool *const pool,
+                             const size_t nr,
+                             const size_t buf_size,
+                             const size_t headroom)
+{
+	assert(headroom < buf_size);
+
+	pool->nr = nr;
+	pool->buf_size = buf_size;
+	pool->headroom = headroom;
+
+	pool->mem = malloc(nr * buf_size);
+	if(pool->mem == NULL)
+	{
+		goto error;
+	}
+	pool->bufs = malloc(nr * sizeof(struct rohc_buf));
+	if(pool->bufs == NULL)
+	{
+		goto free_mem;
+	}
+	tunnel_pool_reset(pool);
+
+	return true;
+
+free_mem:
+	free(pool->mem);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Empty all the buffers of one pool, keeping their headroom
+ *
+ * @param pool  The pool to reset
+ */
+static void tunnel_pool_reset(struct tunnel_pool *const pool)
+{
+	size_t i;
+
+	for(i = 0; i < pool->nr; i++)
+	{
+		const struct rohc_buf buf =
+			rohc_buf_init_empty(pool->mem + i * pool->buf_size, pool->buf_size);
+		pool->bufs[i] = buf;
+		pool->bufs[i].offset = pool->headroom;
+	}
+}
+
+
+/**
+ * @brief Free one pool of ROHC buffers
+ *
+ * @param pool  The pool to free
+ */
+static void tunnel_pool_free(struct tunnel_pool *const pool)
+{
+	free(pool->bufs);
+	free(pool->mem);
+}
+
+
+/**
+ * @brief The main loop of the TX thread: TUN -> compression -> UDP
+ *
+ * @param arg  The tunnel
+ * @return     Always NULL
+ */
+static void * tunnel_tx_run(void *const arg)
+{
+	struct tunnel *const tunnel = arg;
+	struct tunnel_stats *const stats = &tunnel->tx_stats;
+	struct tunnel_pool ip_pool;
+	struct tunnel_pool rohc_pool;
+	uint8_t fb_buffer[TUNNEL_FB_MAX_LEN];
+	struct rohc_buf fb_pending = rohc_buf_init_empty(fb_buffer, TUNNEL_FB_MAX_LEN);
+	struct mmsghdr *msgs;
+	struct iovec *iovs;
+	uint64_t *read_times;
+	size_t i;
+
+	if(!tunnel_pool_init(&ip_pool, tunnel->batch, tunnel->mtu, 0))
+	{
+		fprintf(stderr, "TX: failed to allocate the pool of IP buffers\n");
+		goto error;
+	}
+	if(!tunnel_pool_init(&rohc_pool, tunnel->batch, TUNNEL_HEADROOM +
+	                     tunnel->mtu + TUNNEL_ROHC_OVERHEAD, TUNNEL_HEADROOM))
+	{
+		fprintf(stderr, "TX: failed to allocate the pool of ROHC buffers\n");
+		goto free_ip_pool;
+	}
+	msgs = calloc(tunnel->batch, sizeof(struct mmsghdr));
+	iovs = calloc(tunnel->batch, sizeof(struct iovec));
+	read_times = calloc(tunnel->batch, sizeof(uint64_t));
+	if(msgs == NULL || iovs == NULL || read_times == NULL)
+	{
+		fprintf(stderr, "TX: failed to allocate memory for one batch\n");
+		goto free_batch;
+	}
+	for(i = 0; i < tunnel->batch; i++)
+	{
+		msgs[i].msg_hdr.msg_iov = &(iovs[i]);
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	while(!__atomic_load_n(&tunnel_stop, __ATOMIC_RELAXED))
+	{
+		struct pollfd fds[2] = {
+			{ .fd = tunnel->tun_fd, .events = POLLIN, .revents = 0 },
+			{ .fd = tunnel->wake_fd, .events = POLLIN, .revents = 0 },
+		};
+		const struct tunnel_fb_slot *slot;
+		size_t msgs_nr = 0;
+		size_t pkts_nr = 0;
+		uint64_t sent_time;
+		uint64_t wake_nr;
+
+		if(poll(fds, 2, TUNNEL_POLL_TIMEOUT_MS) < 0 && errno != EINTR)
+		{
+			fprintf(stderr, "TX: failed to wait for packets: %s (%d)\n",
+			        strerror(errno), errno);
+			goto free_batch;
+		}
+		if(fds[1].revents & POLLIN)
+		{
+			(void) !read(tunnel->wake_fd, &wake_nr, sizeof(uint64_t));
+		}
+
+		/* deliver the received feedbacks to the compressor, and gather the
+		 * feedbacks to send to the remote compressor */
+		while((slot = tunnel_fb_peek(&tunnel->fb_ring)) != NULL)
+		{
+			const struct rohc_buf feedback =
+				rohc_buf_init_full((uint8_t *) slot->data, slot->len,
+				                   ((struct rohc_ts) { .sec = 0, .nsec = 0 }));
+
+			if(slot->kind == TUNNEL_FB_RCVD)
+			{
+				if(!rohc_comp_deliver_feedback2(tunnel->comp, feedback))
+				{
+					tunnel_stats_add(&stats->failures_nr, 1);
+				}
+			}
+			else
+			{
+				/* no more room for piggybacking: send the pending feedbacks
+				 * alone in one feedback-only ROHC packet */
+				if((fb_pending.len + feedback.len) > TUNNEL_FB_MAX_LEN)
+				{
+					iovs[0].iov_base = rohc_buf_data(fb_pending);
+					iovs[0].iov_len = fb_pending.len;
+					if(!tunnel_tx_send(tunnel, msgs, 1))
+					{
+						goto free_batch;
+					}
+					rohc_buf_reset(&fb_pending);
+				}
+				rohc_buf_append_buf(&fb_pending, feedback);
+				tunnel_stats_add(&stats->feedbacks_nr, 1);
+			}
+			tunnel_fb_pop(&tunnel->fb_ring);
+		}
+
+		/* read one batch of IP packets from the TUN interface */
+		tunnel_pool_reset(&ip_pool);
+		while(pkts_nr < tunnel->batch)
+		{
+			struct rohc_buf *const ip_packet = &(ip_pool.bufs[pkts_nr]);
+			const ssize_t len =
+				read(tunnel->tun_fd, rohc_buf_data(*ip_packet), tunnel->mtu);
+
+			if(len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			{
+				break;
+			}
+			else if(len < 0 && errno != EINTR)
+			{
+				fprintf(stderr, "TX: failed to read from the TUN interface: "
+				        "%s (%d)\n", strerror(errno), errno);
+				goto free_batch;
+			}
+			else if(len > 0)
+			{
+				read_times[pkts_nr] = tunnel_now();
+				ip_packet->len = len;
+				ip_packet->time.sec = read_times[pkts_nr] / 1000000000ULL;
+				ip_packet->time.nsec = read_times[pkts_nr] % 1000000000ULL;
+				pkts_nr++;
+			}
+		}
+
+		/* compress them */
+		tunnel_pool_reset(&rohc_pool);
+		for(i = 0; i < pkts_nr; i++)
+		{
+			struct rohc_buf *const rohc_packet = &(rohc_pool.bufs[msgs_nr]);
+			rohc_status_t status;
+
+			status = rohc_compress4(tunnel->comp, ip_pool.bufs[i], rohc_packet);
+			if(status != ROHC_STATUS_OK)
+			{
+				tunnel_stats_add(&stats->failures_nr, 1);
+				continue;
+			}
+			tunnel_stats_add(&stats->ip_bytes, ip_pool.bufs[i].len);
+
+			/* piggyback the pending feedbacks in the headroom */
+			if(fb_pending.len > 0)
+			{
+				rohc_buf_prepend(rohc_packet, rohc_buf_data(fb_pending),
+				                 fb_pending.len);
+				rohc_buf_reset(&fb_pending);
+			}
+
+			iovs[msgs_nr].iov_base = rohc_buf_data(*rohc_packet);
+			iovs[msgs_nr].iov_len = rohc_packet->len;
+			read_times[msgs_nr] = read_times[i];
+			msgs_nr++;
+		}
+
+		/* no packet to piggyback the pending feedbacks on */
+		if(msgs_nr == 0 && fb_pending.len > 0)
+		{
+			iovs[0].iov_base = rohc_buf_data(fb_pending);
+			iovs[0].iov_len = fb_pending.len;
+			if(!tunnel_tx_send(tunnel, msgs, 1))
+			{
+				goto free_batch;
+			}
+			rohc_buf_reset(&fb_pending);
+		}
+		if(msgs_nr == 0)
+		{
+			continue;
+		}
+
+		/* send the whole batch at once */
+		if(!tunnel_tx_send(tunnel, msgs, msgs_nr))
+		{
+			goto free_batch;
+		}
+		sent_time = tunnel_now();
+		for(i = 0; i < msgs_nr; i++)
+		{
+			tunnel_stats_lat(stats, sent_time - read_times[i]);
+		}
+		tunnel_stats_add(&stats->pkts_nr, msgs_nr);
+		tunnel_stats_add(&stats->batches_nr, 1);
+	}
+
+free_batch:
+	free(read_times);
+	free(iovs);
+	free(msgs);
+	tunnel_pool_free(&rohc_pool);
+free_ip_pool:
+	tunnel_pool_free(&ip_pool);
+error:
+	/* the daemon cannot run without its TX thread */
+	__atomic_store_n(&tunnel_stop, 1, __ATOMIC_RELAXED);
+	return NULL;
+}
+
+
+/**
+ * @brief Send one batch of ROHC packets to the remote daemon
+ *
+ * The messages are sent with as few sendmmsg(2) calls as possible. The
+ * datagrams that the network refuses are counted as failures.
+ *
+ * @param tunnel   The tunnel
+ * @param msgs     The messages to send
+ * @param msgs_nr  The number of messages to send
+ * @return         true if the batch was handled,
+ *                 false if the socket failed
+ */
+static bool tunnel_tx_send(struct tunnel *const tunnel,
+                           struct mmsghdr *const msgs,
+                           const size_t msgs_nr)
+{
+	struct tunnel_stats *const stats = &tunnel->tx_stats;
+	size_t sent_nr = 0;
+
+	while(sent_nr < msgs_nr)
+	{
+		const int ret = sendmmsg(tunnel->udp_fd, msgs + sent_nr,
+		                         msgs_nr - sent_nr, 0);
+
+		if(ret < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if(ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			/* the socket buffer is full: wait for some room */
+			struct pollfd pfd = { .fd = tunnel->udp_fd, .events = POLLOUT };
+			if(poll(&pfd, 1, TUNNEL_POLL_TIMEOUT_MS) <= 0 &&
+			   __atomic_load_n(&tunnel_stop, __ATOMIC_RELAXED))
+			{
+				break;
+			}
+		}
+		else if(ret < 0 && (errno == ECONNREFUSED || errno == EHOSTUNREACH ||
+		                    errno == ENETUNREACH || errno == EMSGSIZE))
+		{
+			/* the remote daemon is not ready or the datagram is too large:
+			 * drop the first datagram and go on with the others */
+			tunnel_stats_add(&stats->failures_nr, 1);
+			sent_nr++;
+		}
+		else if(ret < 0)
+		{
+			fprintf(stderr, "TX: failed to send ROHC packets: %s (%d)\n",
+			        strerror(errno), errno);
+			goto error;
+		}
+		else
+		{
+			size_t i;
+			for(i = sent_nr; i < (sent_nr + ret); i++)
+			{
+				tunnel_stats_add(&stats->rohc_bytes, msgs[i].msg_len);
+			}
+			sent_nr += ret;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief The main loop of the RX thread: UDP -> decompression -> TUN
+ *
+ * @param arg  The tunnel
+ * @return     Always NULL
+ */
+static void * tunnel_rx_run(void *const arg)
+{
+	struct tunnel *const tunnel = arg;
+	struct tunnel_stats *const stats = &tunnel->rx_stats;
+	const size_t rohc_max_len = tunnel->mtu + TUNNEL_ROHC_OVERHEAD;
+	struct tunnel_pool rohc_pool;
+	struct tunnel_pool ip_pool;
+	struct tunnel_pool rcvd_fb_pool;
+	struct tunnel_pool send_fb_pool;
+	uint8_t fb_buffer[TUNNEL_FB_MAX_LEN];
+	struct rohc_buf fb_flushed = rohc_buf_init_empty(fb_buffer, TUNNEL_FB_MAX_LEN);
+	rohc_status_t *statuses;
+	struct mmsghdr *msgs;
+	struct iovec *iovs;
+	size_t i;
+
+	if(!tunnel_pool_init(&rohc_pool, tunnel->batch, rohc_max_len, 0))
+	{
+		fprintf(stderr, "RX: failed to allocate the pool of ROHC buffers\n");
+		goto error;
+	}
+	if(!tunnel_pool_init(&ip_pool, tunnel->batch, tunnel->mtu, 0))
+	{
+		fprintf(stderr, "RX: failed to allocate the pool of IP buffers\n");
+		goto free_rohc_pool;
+	}
+	if(!tunnel_pool_init(&rcvd_fb_pool, tunnel->batch, rohc_max_len, 0))
+	{
+		fprintf(stderr, "RX: failed to allocate the pool of feedback buffers\n");
+		goto free_ip_pool;
+	}
+	if(!tunnel_pool_init(&send_fb_pool, tunnel->batch, TUNNEL_FB_MAX_LEN, 0))
+	{
+		fprintf(stderr, "RX: failed to allocate the pool of feedback buffers\n");
+		goto free_rcvd_fb_pool;
+	}
+	statuses = calloc(tunnel->batch, sizeof(rohc_status_t));
+	msgs = calloc(tunnel->batch, sizeof(struct mmsghdr));
+	iovs = calloc(tunnel->batch, sizeof(struct iovec));
+	if(statuses == NULL || msgs == NULL || iovs == NULL)
+	{
+		fprintf(stderr, "RX: failed to allocate memory for one batch\n");
+		goto free_batch;
+	}
+	for(i = 0; i < tunnel->batch; i++)
+	{
+		iovs[i].iov_base = rohc_buf_data(rohc_pool.bufs[i]);
+		iovs[i].iov_len = rohc_max_len;
+		msgs[i].msg_hdr.msg_iov = &(iovs[i]);
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	while(!__atomic_load_n(&tunnel_stop, __ATOMIC_RELAXED))
+	{
+		struct pollfd pfd = { .fd = tunnel->udp_fd, .events = POLLIN };
+		bool fb_pushed = false;
+		uint64_t rcvd_time;
+		uint64_t written_time;
+		size_t pkts_nr;
+		size_t fb_nr;
+		int ret;
+
+		ret = poll(&pfd, 1, TUNNEL_POLL_TIMEOUT_MS);
+		if(ret < 0 && errno != EINTR)
+		{
+			fprintf(stderr, "RX: failed to wait for packets: %s (%d)\n",
+			        strerror(errno), errno);
+			goto free_batch;
+		}
+		else if(ret <= 0)
+		{
+			continue;
+		}
+
+		/* receive one batch of ROHC packets */
+		ret = recvmmsg(tunnel->udp_fd, msgs, tunnel->batch, MSG_DONTWAIT, NULL);
+		if(ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK ||
+		               errno == EINTR || errno == ECONNREFUSED))
+		{
+			continue;
+		}
+		else if(ret < 0)
+		{
+			fprintf(stderr, "RX: failed to receive ROHC packets: %s (%d)\n",
+			        strerror(errno), errno);
+			goto free_batch;
+		}
+		pkts_nr = ret;
+		rcvd_time = tunnel_now();
+
+		tunnel_pool_reset(&rohc_pool);
+		tunnel_pool_reset(&ip_pool);
+		tunnel_pool_reset(&rcvd_fb_pool);
+		tunnel_pool_reset(&send_fb_pool);
+		for(i = 0; i < pkts_nr; i++)
+		{
+			/* truncated datagrams are dropped by the decompressor */
+			rohc_pool.bufs[i].len = ((msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ?
+			                         0 : msgs[i].msg_len);
+			rohc_pool.bufs[i].time.sec = rcvd_time / 1000000000ULL;
+			rohc_pool.bufs[i].time.nsec = rcvd_time % 1000000000ULL;
+			tunnel_stats_add(&stats->rohc_bytes, msgs[i].msg_len);
+		}
+
+		/* decompress them */
+		if(rohc_decompress_burst(tunnel->decomp, rohc_pool.bufs, ip_pool.bufs,
+		                         statuses, rcvd_fb_pool.bufs, send_fb_pool.bufs,
+		                         pkts_nr) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "RX: failed to decompress one batch of ROHC "
+			        "packets\n");
+			goto free_batch;
+		}
+
+		/* write the IP packets to the TUN interface, one by one */
+		for(i = 0; i < pkts_nr; i++)
+		{
+			const struct rohc_buf *const ip_packet = &(ip_pool.bufs[i]);
+
+			if(statuses[i] != ROHC_STATUS_OK)
+			{
+				tunnel_stats_add(&stats->failures_nr, 1);
+			}
+			else if(ip_packet->len > 0)
+			{
+				if(write(tunnel->tun_fd, rohc_buf_data(*ip_packet),
+				         ip_packet->len) != (ssize_t) ip_packet->len)
+				{
+					tunnel_stats_add(&stats->failures_nr, 1);
+					continue;
+				}
+				written_time = tunnel_now();
+				tunnel_stats_lat(stats, written_time - rcvd_time);
+				tunnel_stats_add(&stats->ip_bytes, ip_packet->len);
+				tunnel_stats_add(&stats->pkts_nr, 1);
+			}
+
+			/* hand the feedbacks over to the TX thread */
+			if(rcvd_fb_pool.bufs[i].len > 0)
+			{
+				fb_pushed |= tunnel_fb_push(&tunnel->fb_ring, TUNNEL_FB_RCVD,
+				                            rcvd_fb_pool.bufs[i]);
+				tunnel_stats_add(&stats->feedbacks_nr, 1);
+			}
+			if(send_fb_pool.bufs[i].len > 0)
+			{
+				fb_pushed |= tunnel_fb_push(&tunnel->fb_ring, TUNNEL_FB_SEND,
+				                            send_fb_pool.bufs[i]);
+			}
+		}
+		tunnel_stats_add(&stats->batches_nr, 1);
+
+		/* the feedbacks coalesced per context during the whole batch */
+		do
+		{
+			rohc_buf_reset(&fb_flushed);
+			fb_nr = rohc_decomp_flush_feedback(tunnel->decomp, &fb_flushed);
+			if(fb_flushed.len > 0)
+			{
+				fb_pushed |= tunnel_fb_push(&tunnel->fb_ring, TUNNEL_FB_SEND,
+				                            fb_flushed);
+			}
+		}
+		while(fb_nr > 0);
+
+		/* wake up the TX thread if it waits for IP packets */
+		if(fb_pushed)
+		{
+			const uint64_t wake_nr = 1;
+			(void) !write(tunnel->wake_fd, &wake_nr, sizeof(uint64_t));
+		}
+	}
+
+free_batch:
+	free(iovs);
+	free(msgs);
+	free(statuses);
+	tunnel_pool_free(&send_fb_pool);
+free_rcvd_fb_pool:
+	tunnel_pool_free(&rcvd_fb_pool);
+free_ip_pool:
+	tunnel_pool_free(&ip_pool);
+free_rohc_pool:
+	tunnel_pool_free(&rohc_pool);
+error:
+	/* the daemon cannot run without its RX thread */
+	__atomic_store_n(&tunnel_stop, 1, __ATOMIC_RELAXED);
+	return NULL;
+}
+
+
+/**
+ * @brief Hand one feedback over to the TX thread
+ *
+ * Only the RX thread shall call the function.
+ *
+ * @param ring      The ring of feedbacks
+ * @param kind      The kind of feedback
+ * @param feedback  The feedback
+ * @return          true if the feedback was queued,
+ *                  false if it was dropped
+ */
+static bool tunnel_fb_push(struct tunnel_fb_ring *const ring,
+                           const tunnel_fb_kind_t kind,
+                           const struct rohc_buf feedback)
+{
+	const size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	struct tunnel_fb_slot *slot;
+
+	if(feedback.len > TUNNEL_FB_MAX_LEN ||
+	   (ring->head - tail) >= TUNNEL_FB_RING_SLOTS)
+	{
+		__atomic_store_n(&ring->drops_nr, ring->drops_nr + 1, __ATOMIC_RELAXED);
+		return false;
+	}
+
+	slot = &(ring->slots[ring->head % TUNNEL_FB_RING_SLOTS]);
+	slot->kind = kind;
+	slot->len = feedback.len;
+	memcpy(slot->data, rohc_buf_data(feedback), feedback.len);
+	__atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+
+/**
+ * @brief Get the oldest feedback of the ring without removing it
+ *
+ * Only the TX thread shall call the function.
+ *
+ * @param ring  The ring of feedbacks
+ * @return      The oldest feedback, NULL if the ring is empty
+ */
+static const struct tunnel_fb_slot * tunnel_fb_peek(struct tunnel_fb_ring *const ring)
+{
+	const size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+	if(head == ring->tail)
+	{
+		return NULL;
+	}
+
+	return &(ring->slots[ring->tail % TUNNEL_FB_RING_SLOTS]);
+}
+
+
+/**
+ * @brief Remove the oldest feedback of the ring
+ *
+ * Only the TX thread shall call the function.
+ *
+ * @param ring  The ring of feedbacks
+ */
+static void tunnel_fb_pop(struct tunnel_fb_ring *const ring)
+{
+	__atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Increase one statistics counter
+ *
+ * Only the thread that owns the counter shall call the function, the main
+ * thread reads the counter concurrently.
+ *
+ * @param counter  The counter
+ * @param value    The value to add to the counter
+ */
+static void tunnel_stats_add(uint64_t *const counter, const uint64_t value)
+{
+	__atomic_store_n(counter, (*counter) + value, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * @brief Record one latency in the histogram of one direction
+ *
+ * The histogram has 8 buckets per power of 2, so the percentiles are
+ * accurate to 12.5%.
+ *
+ * @param stats  The statistics of the direction
+ * @param ns     The latency (in nanoseconds)
+ */
+static void tunnel_stats_lat(struct tunnel_stats *const stats,
+                             const uint64_t ns)
+{
+	const uint64_t sub_nr = (1U << TUNNEL_LAT_SUB_BITS);
+	size_t bucket;
+
+	if(ns < sub_nr)
+	{
+		bucket = ns;
+	}
+	else
+	{
+		const unsigned int msb = 63 - __builtin_clzll(ns);
+		const unsigned int shift = msb - TUNNEL_LAT_SUB_BITS;
+		bucket = ((msb - TUNNEL_LAT_SUB_BITS + 1) << TUNNEL_LAT_SUB_BITS) +
+		         ((ns >> shift) & (sub_nr - 1));
+	}
+	tunnel_stats_add(&(stats->lat_hist[bucket]), 1);
+}
+
+
+/**
+ * @brief Copy the statistics of one direction for the main thread
+ *
+ * @param stats          The statistics updated by the thread of the direction
+ * @param[out] snapshot  The copy of the statistics
+ */
+static void tunnel_stats_snapshot(const struct tunnel_stats *const stats,
+                                  struct tunnel_stats *const snapshot)
+{
+	size_t i;
+
+	snapshot->pkts_nr = __atomic_load_n(&stats->pkts_nr, __ATOMIC_RELAXED);
+	snapshot->ip_bytes = __atomic_load_n(&stats->ip_bytes, __ATOMIC_RELAXED);
+	snapshot->rohc_bytes = __atomic_load_n(&stats->rohc_bytes, __ATOMIC_RELAXED);
+	snapshot->failures_nr = __atomic_load_n(&stats->failures_nr, __ATOMIC_RELAXED);
+	snapshot->feedbacks_nr = __atomic_load_n(&stats->feedbacks_nr, __ATOMIC_RELAXED);
+	snapshot->batches_nr = __atomic_load_n(&stats->batches_nr, __ATOMIC_RELAXED);
+	for(i = 0; i < TUNNEL_LAT_BUCKETS; i++)
+	{
+		snapshot->lat_hist[i] = __atomic_load_n(&(stats->lat_hist[i]),
+		                                        __ATOMIC_RELAXED);
+	}
+}
+
+
+/**
+ * @brief Get one percentile of the latencies recorded between two snapshots
+ *
+ * @param cur         The current snapshot
+ * @param prev        The previous snapshot
+ * @param percentile  The percentile to get, in range [0, 100]
+ * @return            The upper bound of the bucket of the percentile
+ *                    (in nanoseconds), 0 if there is no latency
+ */
+static uint64_t tunnel_stats_percentile(const struct tunnel_stats *const cur,
+                                        const struct tunnel_stats *const prev,
+                                        const unsigned int percentile)
+{
+	const uint64_t sub_nr = (1U << TUNNEL_LAT_SUB_BITS);
+	uint64_t samples_nr = 0;
+	uint64_t rank;
+	uint64_t seen_nr = 0;
+	size_t bucket;
+
+	for(bucket = 0; bucket < TUNNEL_LAT_BUCKETS; bucket++)
+	{
+		samples_nr += cur->lat_hist[bucket] - prev->lat_hist[bucket];
+	}
+	if(samples_nr == 0)
+	{
+		return 0;
+	}
+	rank = (samples_nr * percentile + 99) / 100;
+	if(rank == 0)
+	{
+		rank = 1;
+	}
+
+	for(bucket = 0; bucket < TUNNEL_LAT_BUCKETS; bucket++)
+	{
+		seen_nr += cur->lat_hist[bucket] - prev->lat_hist[bucket];
+		if(seen_nr >= rank)
+		{
+			break;
+		}
+	}
+	if(bucket < sub_nr)
+	{
+		return bucket;
+	}
+	else
+	{
+		const unsigned int shift = (bucket >> TUNNEL_LAT_SUB_BITS) - 1;
+		const uint64_t sub = bucket & (sub_nr - 1);
+		return ((sub_nr + sub + 1) << shift) - 1;
+	}
+}
+
+
+/**
+ * @brief Print the statistics of one direction between two snapshots
+ *
+ * @param name      The name of the direction
+ * @param cur       The current snapshot
+ * @param prev      The previous snapshot
+ * @param duration  The time between the two snapshots (in seconds)
+ */
+static void tunnel_stats_print(const char *const name,
+                               const struct tunnel_stats *const cur,
+                               const struct tunnel_stats *const prev,
+                               const double duration)
+{
+	const uint64_t pkts_nr = cur->pkts_nr - prev->pkts_nr;
+	const uint64_t ip_bytes = cur->ip_bytes - prev->ip_bytes;
+	const uint64_t rohc_bytes = cur->rohc_bytes - prev->rohc_bytes;
+	const uint64_t batches_nr = cur->batches_nr - prev->batches_nr;
+
+	printf("  %s: %9.0f pkt/s, IP %8.3f Mbit/s, ROHC %8.3f Mbit/s (%5.1f%%), "
+	       "%4.1f pkt/batch, latency p50/p90/p99 %.1f/%.1f/%.1f us, "
+	       "%" PRIu64 " failures, %" PRIu64 " feedbacks\n", name,
+	       (duration > 0 ? pkts_nr / duration : 0),
+	       (duration > 0 ? ip_bytes * 8 / duration / 1e6 : 0),
+	       (duration > 0 ? rohc_bytes * 8 / duration / 1e6 : 0),
+	       (ip_bytes > 0 ? rohc_bytes * 100.0 / ip_bytes : 0),
+	       (batches_nr > 0 ? ((double) pkts_nr) / batches_nr : 0),
+	       tunnel_stats_percentile(cur, prev, 50) / 1e3,
+	       tunnel_stats_percentile(cur, prev, 90) / 1e3,
+	       tunnel_stats_percentile(cur, prev, 99) / 1e3,
+	       cur->failures_nr - prev->failures_nr,
+	       cur->feedbacks_nr - prev->feedbacks_nr);
+}
+
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (in nanoseconds)
+ */
+static uint64_t tunnel_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t) ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
+
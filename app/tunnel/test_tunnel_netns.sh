@@ -0,0 +1,137 @@
+#!/bin/sh
+#
+# Copyright 2026 Didier Barvaux
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+#
+# file:        test_tunnel_netns.sh
+# description: run two ROHC tunnel daemons in two network namespaces linked
+#              by a veth pair, then send traffic through the ROHC tunnel
+# author:      Didier Barvaux <didier@barvaux.org>
+#
+# The script must be run as root. It sends ICMP echo requests through the
+# tunnel with ping(8), then UDP and TCP traffic with iperf3(1) if available.
+# The daemons print their throughput and latency statistics when stopped.
+#
+# usage: test_tunnel_netns.sh [PINGS_NR [DAEMON_OPTIONS]]
+#
+# Environment variables:
+#    ROHC_TUNNEL=<path>  the rohc_tunnel binary (default: next to the script)
+#
+
+pings_nr="${1:-1000}"
+[ $# -gt 0 ] && shift
+daemon_opts="$@"
+
+test -z "${ROHC_TUNNEL}" && ROHC_TUNNEL="`dirname "$0"`/rohc_tunnel"
+test ! -x "${ROHC_TUNNEL}" && ROHC_TUNNEL="`which rohc_tunnel`"
+if [ ! -x "${ROHC_TUNNEL}" ] ; then
+	echo "the rohc_tunnel tool was not found, please build it." >&2
+	exit 1
+fi
+if [ "`id -u`" != "0" ] ; then
+	echo "network namespaces require root privileges, test skipped" >&2
+	exit 77
+fi
+if [ -z "`which ip`" ] ; then
+	echo "the ip tool was not found, test skipped" >&2
+	exit 77
+fi
+
+NETNS_A="rohc_tunnel_a"
+NETNS_B="rohc_tunnel_b"
+LOGDIR="`mktemp -d`"
+
+cleanup()
+{
+	for netns in ${NETNS_A} ${NETNS_B} ; do
+		ip netns pids ${netns} 2>/dev/null | xargs -r kill 2>/dev/null
+		ip netns del ${netns} 2>/dev/null
+	done
+	rm -rf "${LOGDIR}"
+}
+trap cleanup EXIT
+
+# two namespaces linked by a veth pair for the UDP underlay
+for netns in ${NETNS_A} ${NETNS_B} ; do
+	ip netns del ${netns} 2>/dev/null
+	ip netns add ${netns} || exit 1
+	ip netns exec ${netns} ip link set lo up
+done
+ip link add name rohc_ul_a type veth peer name rohc_ul_b || exit 1
+ip link set rohc_ul_a netns ${NETNS_A}
+ip link set rohc_ul_b netns ${NETNS_B}
+ip netns exec ${NETNS_A} ip -4 addr add 10.200.0.1/24 dev rohc_ul_a
+ip netns exec ${NETNS_B} ip -4 addr add 10.200.0.2/24 dev rohc_ul_b
+ip netns exec ${NETNS_A} ip link set rohc_ul_a up
+ip netns exec ${NETNS_B} ip link set rohc_ul_b up
+
+# one ROHC tunnel daemon per namespace
+ip netns exec ${NETNS_A} ${ROHC_TUNNEL} ${daemon_opts} \
+	rohc0 10.200.0.1 5000 10.200.0.2 5000 > "${LOGDIR}/a.log" 2>&1 &
+pid_a=$!
+ip netns exec ${NETNS_B} ${ROHC_TUNNEL} ${daemon_opts} \
+	rohc0 10.200.0.2 5000 10.200.0.1 5000 > "${LOGDIR}/b.log" 2>&1 &
+pid_b=$!
+for netns in ${NETNS_A} ${NETNS_B} ; do
+	i=0
+	while ! ip netns exec ${netns} ip link show rohc0 >/dev/null 2>&1 ; do
+		i=$(( i + 1 ))
+		if [ ${i} -gt 50 ] ; then
+			echo "TUN interface not created in namespace ${netns}" >&2
+			cat "${LOGDIR}/a.log" "${LOGDIR}/b.log" >&2
+			exit 1
+		fi
+		sleep 0.1
+	done
+done
+
+# the overlay addresses on the TUN interfaces
+ip netns exec ${NETNS_A} ip -4 addr add 192.168.200.1/24 dev rohc0
+ip netns exec ${NETNS_B} ip -4 addr add 192.168.200.2/24 dev rohc0
+ip netns exec ${NETNS_A} ip link set rohc0 up
+ip netns exec ${NETNS_B} ip link set rohc0 up
+
+ret=0
+if [ -n "`which ping`" ] ; then
+	echo "send ${pings_nr} ICMP echo requests through the ROHC tunnel..."
+	ip netns exec ${NETNS_A} ping -q -c ${pings_nr} -i 0.01 -W 1 192.168.200.2
+	ret=$?
+else
+	echo "the ping tool was not found, ICMP test skipped" >&2
+fi
+
+if [ ${ret} -eq 0 ] && [ -n "`which iperf3`" ] ; then
+	ip netns exec ${NETNS_B} iperf3 -s -1 -D
+	sleep 0.5
+	echo "send UDP traffic through the ROHC tunnel..."
+	ip netns exec ${NETNS_A} iperf3 -c 192.168.200.2 -u -b 100M -l 200 -t 5 || ret=1
+	ip netns exec ${NETNS_B} iperf3 -s -1 -D
+	sleep 0.5
+	echo "send TCP traffic through the ROHC tunnel..."
+	ip netns exec ${NETNS_A} iperf3 -c 192.168.200.2 -t 5 || ret=1
+fi
+
+# stop the daemons, they print their statistics
+kill -INT ${pid_a} ${pid_b}
+wait ${pid_a} || ret=1
+wait ${pid_b} || ret=1
+echo "=== daemon in namespace ${NETNS_A} ==="
+cat "${LOGDIR}/a.log"
+echo "=== daemon in namespace ${NETNS_B} ==="
+cat "${LOGDIR}/b.log"
+
+exit ${ret}
@@ -91,6 +91,8 @@ ${NEW_PWD}/configure \
 	--enable-fortify-sources \
 	--enable-app-sniffer \
 	--enable-app-stats \
+	--enable-app-bench \
+	--enable-app-tunnel \
 	--enable-rohc-tests \
 	--enable-examples \
 	${add_opts} \
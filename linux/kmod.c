@@ -92,6 +92,7 @@ EXPORT_SYMBOL_GPL(rohc_comp_deliver_feedback2);
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_comp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_comp_get_general_info);
+EXPORT_SYMBOL_GPL(rohc_comp_get_memory_usage);
 EXPORT_SYMBOL_GPL(rohc_comp_get_last_packet_info2);
 
 /* configuration */
@@ -105,9 +106,13 @@ EXPORT_SYMBOL_GPL(rohc_comp_get_mrru);
 EXPORT_SYMBOL_GPL(rohc_comp_get_max_cid);
 EXPORT_SYMBOL_GPL(rohc_comp_get_cid_type);
 EXPORT_SYMBOL_GPL(rohc_comp_set_optimistic_approach);
+EXPORT_SYMBOL_GPL(rohc_comp_set_optimistic_approach_adaptive);
 EXPORT_SYMBOL_GPL(rohc_comp_set_reorder_ratio);
 EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes);
 EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes_time);
+EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes_jitter);
+EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes_jitter_time);
+EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes_rate);
 EXPORT_SYMBOL_GPL(rohc_comp_set_traces_cb2);
 EXPORT_SYMBOL_GPL(rohc_comp_set_features);
 
@@ -123,10 +128,15 @@ EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
 EXPORT_SYMBOL_GPL(rohc_decomp_new2);
 EXPORT_SYMBOL_GPL(rohc_decomp_free);
 EXPORT_SYMBOL_GPL(rohc_decompress3);
+EXPORT_SYMBOL_GPL(rohc_decompress_in_place);
+EXPORT_SYMBOL_GPL(rohc_decompress_segments);
+EXPORT_SYMBOL_GPL(rohc_decomp_flush_feedback);
+EXPORT_SYMBOL_GPL(rohc_decompress_burst);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_decomp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_general_info);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_memory_usage);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_context_info);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_last_packet_info);
 
@@ -140,6 +150,14 @@ EXPORT_SYMBOL_GPL(rohc_decomp_get_cid_type);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_max_cid);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_mrru);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_mrru);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_contexts_max_mem);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_contexts_max_mem);
+EXPORT_SYMBOL_GPL(rohc_decomp_pool_new);
+EXPORT_SYMBOL_GPL(rohc_decomp_pool_free);
+EXPORT_SYMBOL_GPL(rohc_decomp_pool_get_worker);
+EXPORT_SYMBOL_GPL(rohc_decomp_pool_dispatch);
+EXPORT_SYMBOL_GPL(rohc_decomp_pool_decompress);
+EXPORT_SYMBOL_GPL(rohc_decomp_pool_get_feedbacks);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_rate_limits);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_rate_limits);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_prtt);
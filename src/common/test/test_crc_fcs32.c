@@ -0,0 +1,230 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_crc_fcs32.c
+ * @brief   Test and benchmark the FCS-32 computation
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The optimized FCS-32 computation is checked against a trivial bitwise
+ * implementation of the algorithm for many lengths, alignments and initial
+ * values. The throughput of the optimized computation is then measured on
+ * several sizes of data, from one small ROHC segment to one jumbo frame,
+ * and printed in verbose mode.
+ */
+
+#include "crc.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/time.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Check the given condition, trace it and fail the test if it is false */
+#define CHECK(condition) \
+	do { \
+		if(!(condition)) { \
+			printf("%s:%d: check '%s' failed\n", __FILE__, __LINE__, \
+			       #condition); \
+			goto error; \
+		} \
+	} while(0)
+
+/** The maximum length of data the FCS-32 is computed on */
+#define TEST_FCS32_MAX_LEN  9000U
+
+/** The maximum misalignment of data the FCS-32 is computed on */
+#define TEST_FCS32_MAX_OFFSET  16U
+
+/** The number of FCS-32 computations per benchmarked size */
+#define TEST_FCS32_BENCH_REPEATS  20000U
+
+
+static uint32_t crc_calc_fcs32_bitwise(const uint8_t *const data,
+                                       const size_t length,
+                                       const uint32_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+
+static uint64_t gettime_ns(void)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Test and benchmark the FCS-32 computation
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	static uint8_t data[TEST_FCS32_MAX_OFFSET + TEST_FCS32_MAX_LEN];
+	const uint32_t init_vals[] = { CRC_INIT_FCS32, 0x00000000, 0x12345678 };
+	const size_t bench_lens[] = { 64, 256, 1500, 9000 };
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test and benchmark the FCS-32 computation\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* pseudo-random data, reproducible from one run to another */
+	for(i = 0; i < sizeof(data); i++)
+	{
+		data[i] = (uint8_t) ((i * 2654435761U) >> 13);
+	}
+
+	/* well-known check value of the CRC-32 used by FCS-32 */
+	CHECK((crc_calc_fcs32((const uint8_t *) "123456789", 9, CRC_INIT_FCS32) ^
+	       0xffffffff) == 0xcbf43926);
+
+	/* compare the optimized and bitwise algorithms */
+	for(i = 0; i < (sizeof(init_vals) / sizeof(uint32_t)); i++)
+	{
+		size_t offset;
+
+		trace(verbose, "compare algorithms with initial value 0x%08x\n",
+		      init_vals[i]);
+
+		for(offset = 0; offset < TEST_FCS32_MAX_OFFSET; offset++)
+		{
+			size_t len;
+
+			for(len = 0; len <= 1100; len++)
+			{
+				CHECK(crc_calc_fcs32(data + offset, len, init_vals[i]) ==
+				      crc_calc_fcs32_bitwise(data + offset, len, init_vals[i]));
+			}
+			for(len = 1100; len <= TEST_FCS32_MAX_LEN; len += 277)
+			{
+				CHECK(crc_calc_fcs32(data + offset, len, init_vals[i]) ==
+				      crc_calc_fcs32_bitwise(data + offset, len, init_vals[i]));
+			}
+		}
+	}
+
+	/* computing the CRC in several chunks gives the same result as computing
+	 * the CRC at once (as ROHC segmentation does) */
+	for(i = 0; i < TEST_FCS32_MAX_LEN; i += 997)
+	{
+		const uint32_t crc_once =
+			crc_calc_fcs32(data, TEST_FCS32_MAX_LEN, CRC_INIT_FCS32);
+		uint32_t crc_chunks = CRC_INIT_FCS32;
+
+		crc_chunks = crc_calc_fcs32(data, i, crc_chunks);
+		crc_chunks = crc_calc_fcs32(data + i, TEST_FCS32_MAX_LEN - i, crc_chunks);
+		CHECK(crc_once == crc_chunks);
+	}
+
+	/* benchmark the optimized algorithm */
+	for(i = 0; i < (sizeof(bench_lens) / sizeof(size_t)); i++)
+	{
+		volatile uint32_t crc = CRC_INIT_FCS32;
+		uint64_t time_start;
+		uint64_t time_end;
+		double ns_per_call;
+		size_t j;
+
+		time_start = gettime_ns();
+		for(j = 0; j < TEST_FCS32_BENCH_REPEATS; j++)
+		{
+			crc = crc_calc_fcs32(data, bench_lens[i], crc);
+		}
+		time_end = gettime_ns();
+
+		ns_per_call = ((double) (time_end - time_start)) / TEST_FCS32_BENCH_REPEATS;
+		trace(verbose, "FCS-32 over %4zu bytes: %8.1f ns per call, "
+		      "%7.1f MB/s\n", bench_lens[i], ns_per_call,
+		      (ns_per_call > 0 ? bench_lens[i] * 1000.0 / ns_per_call : 0));
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compute the FCS-32 bit per bit, the reference implementation
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+static uint32_t crc_calc_fcs32_bitwise(const uint8_t *const data,
+                                       const size_t length,
+                                       const uint32_t init_val)
+{
+	uint32_t crc = init_val;
+	size_t i;
+
+	for(i = 0; i < length; i++)
+	{
+		size_t bit;
+
+		crc ^= data[i];
+		for(bit = 0; bit < 8; bit++)
+		{
+			crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320 : 0);
+		}
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Get the current time in nanoseconds
+ *
+ * @return  The current time in nanoseconds
+ */
+static uint64_t gettime_ns(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (uint64_t) tv.tv_sec * 1000000000ULL + tv.tv_usec * 1000ULL;
+}
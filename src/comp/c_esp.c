@@ -224,5 +224,7 @@ const struct rohc_comp_profile c_esp_profile =
 	.destroy        = rohc_comp_rfc3095_destroy,
 	.encode         = rohc_comp_rfc3095_encode,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.set_oa_repetitions = rohc_comp_rfc3095_set_oa_repetitions,
+	.account_mem    = rohc_comp_rfc3095_account_mem,
 };
 
@@ -54,6 +54,12 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 static void c_rtp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
+static bool c_rtp_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                     const uint8_t oa_repetitions_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void c_rtp_account_mem(const struct rohc_comp_ctxt *const context,
+                              rohc_comp_profile_memory_usage_t *const usage)
+	__attribute__((nonnull(1, 2)));
 
 static rohc_packet_t c_rtp_decide_FO_packet(const struct rohc_comp_ctxt *const context,
                                             const struct rfc3095_tmp_state *const changes)
@@ -162,7 +168,7 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	rtp_context->old_rtp_extension = uncomp_pkt_hdrs->rtp->extension;
 	rtp_context->old_rtp_pt = uncomp_pkt_hdrs->rtp->pt;
 	if(!c_create_sc(&rtp_context->ts_sc,
-	                context->compressor->oa_repetitions_nr,
+	                context->oa_repetitions_nr,
 	                context->compressor->trace_callback,
 	                context->compressor->trace_callback_priv))
 	{
@@ -212,6 +218,58 @@ static void c_rtp_destroy(struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Change the number of Optimistic Approach repetitions of the context
+ *
+ * The W-LSB windows of the RTP TS are resized along with the W-LSB windows
+ * of the SN and of the IP-ID.
+ *
+ * @param context            The compression context
+ * @param oa_repetitions_nr  The new number of repetitions
+ * @return                   true if successful, false otherwise
+ */
+static bool c_rtp_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                     const uint8_t oa_repetitions_nr)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+	struct c_wlsb *const ts_wlsbs[] = {
+		&rtp_context->ts_sc.ts_scaled_wlsb,
+		&rtp_context->ts_sc.ts_unscaled_wlsb,
+	};
+
+	return rohc_comp_rfc3095_set_oa_repetitions_wlsbs(context, oa_repetitions_nr,
+	                                                  ts_wlsbs,
+	                                                  sizeof(ts_wlsbs) /
+	                                                  sizeof(struct c_wlsb *));
+}
+
+
+/**
+ * @brief Add the memory used by the RTP context to the memory usage of
+ *        the profile
+ *
+ * The W-LSB windows of the RTP TS are accounted for too.
+ *
+ * This function is one of the functions that may exist in one profile for the
+ * framework to report the memory used by the profile.
+ *
+ * @param context  The compression context
+ * @param usage    IN/OUT: The memory usage of the profile
+ */
+static void c_rtp_account_mem(const struct rohc_comp_ctxt *const context,
+                              rohc_comp_profile_memory_usage_t *const usage)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+
+	rohc_comp_rfc3095_account_mem(context, usage);
+	usage->specific_mem += sizeof(struct sc_rtp_context);
+	usage->wlsb_mem += wlsb_get_mem_size(&rtp_context->ts_sc.ts_scaled_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&rtp_context->ts_sc.ts_unscaled_wlsb);
+}
+
+
 /**
  * @brief Decide which packet to send when in First Order (FO) state.
  *
@@ -666,7 +724,7 @@ static void rtp_encode_uncomp_fields(const struct rohc_comp_ctxt *const context,
                                      const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                      struct rfc3095_tmp_state *const changes)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
 	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
 	const struct udphdr *const udp = uncomp_pkt_hdrs->udp;
@@ -1102,7 +1160,7 @@ static void rtp_update_context(struct rohc_comp_ctxt *const context,
                                const struct rfc3095_tmp_state *const changes,
                                const rohc_packet_t packet_type)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
 	struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
 	const struct udphdr *const udp = uncomp_pkt_hdrs->udp;
@@ -1214,5 +1272,7 @@ const struct rohc_comp_profile c_rtp_profile =
 	.destroy        = c_rtp_destroy,
 	.encode         = rohc_comp_rfc3095_encode,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.set_oa_repetitions = c_rtp_set_oa_repetitions,
+	.account_mem    = c_rtp_account_mem,
 };
 
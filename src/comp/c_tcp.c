@@ -50,8 +50,10 @@
 #include "c_tcp_dynamic.h"
 #include "c_tcp_replicate.h"
 #include "c_tcp_irregular.h"
+#include "c_tcp_pkt_types.h"
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #ifdef __KERNEL__
@@ -61,8 +63,14 @@
 #include "config.h" /* for WORDS_BIGENDIAN */
 
 
-#define TRACE_GOTO_CHOICE \
-	rohc_comp_debug(context, "Compressed format choice LINE %d", __LINE__ )
+/**
+ * @brief The length of the TCP header recorded in the header template
+ *
+ * The template covers the TCP ports, the sequence and ACK numbers (that are
+ * ignored), the data offset, the RES flags and the ECN flags. The fields
+ * that follow are part of the changes detected for every packet.
+ */
+#define TCP_HDR_TMPL_LEN  14U
 
 
 /*
@@ -80,6 +88,13 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+static bool c_tcp_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                     const uint8_t oa_repetitions_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void c_tcp_account_mem(const struct rohc_comp_ctxt *const context,
+                              rohc_comp_profile_memory_usage_t *const usage)
+	__attribute__((nonnull(1, 2)));
+
 static bool c_tcp_is_cr_possible(const struct rohc_comp_ctxt *const ctxt,
 	                              const struct rohc_pkt_hdrs *const pkt_hdrs)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
@@ -106,6 +121,22 @@ static void tcp_detect_changes(const struct rohc_comp_ctxt *const context,
                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                struct tcp_tmp_variables *const tmp)
 	__attribute__((nonnull(1, 2, 3, 4, 5)));
+static bool tcp_detect_changes_tmpl(const struct rohc_comp_ctxt *const context,
+                                    const struct rohc_comp_ctxt *const ref_ctxt,
+                                    const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                    struct tcp_tmp_variables *const tmp)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+static void tcp_detect_changes_ip_hdrs(const struct rohc_comp_ctxt *const context,
+                                       const struct rohc_comp_ctxt *const ref_ctxt,
+                                       const ip_context_t *const inner_ip_ctxt,
+                                       const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                       struct tcp_tmp_variables *const tmp)
+	__attribute__((nonnull(1, 2, 3, 4, 5)));
+static void tcp_update_hdr_tmpl(struct rohc_comp_ctxt *const context,
+                                const struct rohc_comp_ctxt *const ref_ctxt,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                const struct tcp_tmp_variables *const tmp)
+	__attribute__((nonnull(1, 2, 3, 4)));
 static void tcp_detect_changes_ipv6_exts(const struct rohc_comp_ctxt *const context,
                                          const struct rohc_comp_ctxt *const ref_ctxt,
                                          const ip_context_t *const ip_context,
@@ -139,17 +170,12 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
                                              const struct tcp_tmp_variables *const tmp,
                                              const bool crc7_at_least)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
-static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *const context,
-                                                 const struct rohc_comp_ctxt *const ref_ctxt,
-                                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
-                                                 const struct tcp_tmp_variables *const tmp,
-                                                 const bool crc7_at_least)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
-static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *const context,
-                                                 const struct rohc_comp_ctxt *const ref_ctxt,
-                                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
-                                                 const struct tcp_tmp_variables *const tmp,
-                                                 const bool crc7_at_least)
+static uint32_t tcp_get_pkt_reqs(const struct rohc_comp_ctxt *const context,
+                                 const struct rohc_comp_ctxt *const ref_ctxt,
+                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                 const struct tcp_tmp_variables *const tmp,
+                                 const bool crc7_at_least,
+                                 const bool is_ip_id_seq)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 
 /* IR and CO packets */
@@ -441,6 +467,9 @@ static bool c_tcp_create_from_ctxt(struct rohc_comp_ctxt *const ctxt,
 	ctxt->specific = tcp_ctxt;
 	memcpy(ctxt->specific, base_ctxt->specific, sizeof(struct sc_tcp_context));
 
+	/* the header template of the base context is not valid for the new one */
+	rohc_comp_hdr_tmpl_reset(&tcp_ctxt->hdr_tmpl);
+
 	/* keep the counter of compressed packets from the base context,
 	 * since it is used to init some compression algorithms and we
 	 * don't want the initialization to restart */
@@ -638,7 +667,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	/* create context for TCP header */
 	tcp_context->tcp_window_change_count = 0;
 	tcp_context->ecn_used = false;
-	tcp_context->ecn_used_change_count = comp->oa_repetitions_nr;
+	tcp_context->ecn_used_change_count = context->oa_repetitions_nr;
 	tcp_context->ecn_used_zero_count = 0;
 	tcp_context->res_flags = tcp->res_flags;
 	tcp_context->urg_flag = tcp->urg_flag;
@@ -653,7 +682,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	{
 		if(ipv4_hdrs_nr == 1)
 		{
-			tcp_context->outer_ip_id_behavior_trans_nr = comp->oa_repetitions_nr;
+			tcp_context->outer_ip_id_behavior_trans_nr = context->oa_repetitions_nr;
 		}
 		else
 		{
@@ -662,7 +691,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 	else if(ipv4_hdrs_nr == 0)
 	{
-		tcp_context->outer_ip_id_behavior_trans_nr = comp->oa_repetitions_nr;
+		tcp_context->outer_ip_id_behavior_trans_nr = context->oa_repetitions_nr;
 	}
 	else
 	{
@@ -670,7 +699,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* MSN */
-	is_ok = wlsb_new(&tcp_context->msn_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->msn_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -679,7 +708,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* IP-ID offset */
-	is_ok = wlsb_new(&tcp_context->ip_id_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->ip_id_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -688,7 +717,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* innermost IPv4 TTL or IPv6 Hop Limit */
-	is_ok = wlsb_new(&tcp_context->ttl_hopl_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->ttl_hopl_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -698,7 +727,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* TCP window */
-	is_ok = wlsb_new(&tcp_context->window_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->window_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -707,14 +736,14 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* TCP sequence number */
-	is_ok = wlsb_new(&tcp_context->seq_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->seq_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
 		           "failed to create W-LSB context for TCP sequence number");
 		goto free_wlsb_window;
 	}
-	is_ok = wlsb_new(&tcp_context->seq_scaled_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->seq_scaled_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -724,14 +753,14 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* TCP acknowledgment (ACK) number */
-	is_ok = wlsb_new(&tcp_context->ack_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->ack_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		           "failed to create W-LSB context for TCP ACK number");
 		goto free_wlsb_seq_scaled;
 	}
-	is_ok = wlsb_new(&tcp_context->ack_scaled_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->ack_scaled_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -753,7 +782,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 	}
 
 	/* TCP option Timestamp (request) */
-	is_ok = wlsb_new(&tcp_context->tcp_opts.ts_req_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->tcp_opts.ts_req_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -762,7 +791,7 @@ static bool c_tcp_create_from_pkt(struct rohc_comp_ctxt *const context,
 		goto free_wlsb_ack_scaled;
 	}
 	/* TCP option Timestamp (reply) */
-	is_ok = wlsb_new(&tcp_context->tcp_opts.ts_reply_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&tcp_context->tcp_opts.ts_reply_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -821,6 +850,79 @@ static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Change the number of Optimistic Approach repetitions of the context
+ *
+ * All the W-LSB windows of the TCP context are resized to the new number of
+ * repetitions. If one window cannot be resized, none is.
+ *
+ * @param context            The compression context
+ * @param oa_repetitions_nr  The new number of repetitions
+ * @return                   true if successful, false otherwise
+ */
+static bool c_tcp_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                     const uint8_t oa_repetitions_nr)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+	struct c_wlsb *const wlsbs[] = {
+		&tcp_context->msn_wlsb,
+		&tcp_context->ip_id_wlsb,
+		&tcp_context->ttl_hopl_wlsb,
+		&tcp_context->window_wlsb,
+		&tcp_context->seq_wlsb,
+		&tcp_context->seq_scaled_wlsb,
+		&tcp_context->ack_wlsb,
+		&tcp_context->ack_scaled_wlsb,
+		&tcp_context->tcp_opts.ts_req_wlsb,
+		&tcp_context->tcp_opts.ts_reply_wlsb,
+	};
+	const size_t wlsbs_nr = sizeof(wlsbs) / sizeof(struct c_wlsb *);
+
+	if(!wlsbs_set_width(wlsbs, wlsbs_nr, oa_repetitions_nr))
+	{
+		rohc_comp_warn(context, "failed to resize the W-LSB windows");
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Add the memory used by the TCP context to the memory usage of
+ *        the profile
+ *
+ * The contexts of the IP headers and of the TCP options are part of the TCP
+ * context, the W-LSB windows are allocated apart from it.
+ *
+ * This function is one of the functions that may exist in one profile for the
+ * framework to report the memory used by the profile.
+ *
+ * @param context  The compression context
+ * @param usage    IN/OUT: The memory usage of the profile
+ */
+static void c_tcp_account_mem(const struct rohc_comp_ctxt *const context,
+                              rohc_comp_profile_memory_usage_t *const usage)
+{
+	const struct sc_tcp_context *const tcp_context = context->specific;
+
+	usage->specific_mem += sizeof(struct sc_tcp_context);
+	usage->ip_ctxts_mem += sizeof(tcp_context->ip_contexts);
+	usage->lists_mem += sizeof(tcp_context->tcp_opts);
+
+	usage->wlsb_mem += wlsb_get_mem_size(&tcp_context->msn_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&tcp_context->ttl_hopl_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&tcp_context->ip_id_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&tcp_context->window_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&tcp_context->seq_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&tcp_context->seq_scaled_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&tcp_context->ack_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&tcp_context->ack_scaled_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&tcp_context->tcp_opts.ts_req_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&tcp_context->tcp_opts.ts_reply_wlsb);
+}
+
+
 /**
  * @brief Check whether the given context is valid for Context Replication (CR)
  *
@@ -895,8 +997,9 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
                         rohc_packet_t *const packet_type)
 {
 	const struct rohc_comp *const comp = context->compressor;
+	struct sc_tcp_context *const tcp_context = context->specific;
+	struct tcp_tmp_variables *const tmp = &(tcp_context->tmp);
 	const struct rohc_comp_ctxt *ref_ctxt = NULL;
-	struct tcp_tmp_variables tmp;
 	int counter;
 
 	*packet_type = ROHC_PACKET_UNKNOWN;
@@ -922,10 +1025,10 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 			&(tcp_ref_ctxt->ip_contexts[tcp_ref_ctxt->ip_contexts_nr - 1]);
 
 		/* detect changes between new uncompressed packet and context */
-		tcp_detect_changes(context, ref_ctxt, inner_ip_ref_ctxt, uncomp_pkt_hdrs, &tmp);
+		tcp_detect_changes(context, ref_ctxt, inner_ip_ref_ctxt, uncomp_pkt_hdrs, tmp);
 
 		/* decide which packet to send */
-		*packet_type = tcp_decide_packet(context, ref_ctxt, uncomp_pkt_hdrs, &tmp);
+		*packet_type = tcp_decide_packet(context, ref_ctxt, uncomp_pkt_hdrs, tmp);
 		if((*packet_type) == ROHC_PACKET_UNKNOWN)
 		{
 			rohc_comp_warn(context, "failed to find the packet type to encode");
@@ -938,7 +1041,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 		   (*packet_type) != ROHC_PACKET_IR_DYN)
 		{
 			/* co_common, seq_X, or rnd_X */
-			counter = code_CO_packet(context, ref_ctxt, uncomp_pkt_hdrs, &tmp,
+			counter = code_CO_packet(context, ref_ctxt, uncomp_pkt_hdrs, tmp,
 			                         rohc_pkt, rohc_pkt_max_len, *packet_type);
 			if(counter < 0)
 			{
@@ -948,7 +1051,7 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 		}
 		else /* ROHC_PACKET_IR, ROHC_PACKET_IR_CR or ROHC_PACKET_IR_DYN */
 		{
-			counter = code_IR_packet(context, ref_ctxt, uncomp_pkt_hdrs, &tmp,
+			counter = code_IR_packet(context, ref_ctxt, uncomp_pkt_hdrs, tmp,
 			                         rohc_pkt, rohc_pkt_max_len, *packet_type);
 			if(counter < 0)
 			{
@@ -959,12 +1062,16 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 		rohc_comp_dump_buf(context, "current ROHC packet", rohc_pkt, counter);
 	}
 
+	/* record the IP headers as template for the next packets if possible */
+	tcp_update_hdr_tmpl(context, ref_ctxt, uncomp_pkt_hdrs, tmp);
+
 	/* update context */
-	rohc_tcp_update_ctxt(context, uncomp_pkt_hdrs, *packet_type, &tmp);
+	rohc_tcp_update_ctxt(context, uncomp_pkt_hdrs, *packet_type, tmp);
 
 	return counter;
 
 error:
+	rohc_comp_hdr_tmpl_reset(&tcp_context->hdr_tmpl);
 	return -1;
 }
 
@@ -982,8 +1089,7 @@ static void rohc_tcp_update_ctxt(struct rohc_comp_ctxt *const context,
                                  const rohc_packet_t packet_type,
                                  const struct tcp_tmp_variables *const changes)
 {
-	const struct rohc_comp *const comp = context->compressor;
-	const uint8_t oa_repetitions_nr = comp->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
 	struct sc_tcp_context *const tcp_context = context->specific;
 	size_t ip_hdr_pos;
@@ -3201,11 +3307,16 @@ error:
 /**
  * @brief Detect changes between packet and context
  *
+ * The changes of the IP headers are re-used from the previous packet if the
+ * IP headers match the header template of the context. The changes of the
+ * TCP header and options are always detected.
+ *
  * @param context          The real compression context for traces and update
  * @param ref_ctxt         The reference compression context to detect changes
  * @param inner_ip_ctxt    The context of the innermost IP header
  * @param uncomp_pkt_hdrs  The uncompressed headers to encode
- * @param tmp              The temporary state for the compressed packet
+ * @param tmp              IN: The temporary state for the previous packet
+ *                         OUT: The temporary state for the compressed packet
  */
 static void tcp_detect_changes(const struct rohc_comp_ctxt *const context,
                                const struct rohc_comp_ctxt *const ref_ctxt,
@@ -3213,7 +3324,135 @@ static void tcp_detect_changes(const struct rohc_comp_ctxt *const context,
                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                struct tcp_tmp_variables *const tmp)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const struct sc_tcp_context *const tcp_context = ref_ctxt->specific;
+
+	/* detect changes of the IP headers, unless they match the template */
+	if(!tcp_detect_changes_tmpl(context, ref_ctxt, uncomp_pkt_hdrs, tmp))
+	{
+		tcp_detect_changes_ip_hdrs(context, ref_ctxt, inner_ip_ctxt,
+		                           uncomp_pkt_hdrs, tmp);
+	}
+
+	/* compute how many bits are needed to send header fields */
+	tcp_detect_changes_tcp_hdr(context, ref_ctxt, uncomp_pkt_hdrs, tmp);
+
+	/* parse TCP options for changes */
+	tcp_detect_options_changes(context, uncomp_pkt_hdrs, &tcp_context->tcp_opts,
+	                           &tmp->tcp_opts, !tmp->tcp_ack_num_unchanged);
+}
+
+
+/**
+ * @brief Re-use the changes of the IP headers of the previous packet
+ *
+ * The changes detected for the IP headers of the previous packet are re-used
+ * if the IP headers of the packet match the header template of the context,
+ * ie. if the fields of the IP headers are unchanged except the IPv4 Total
+ * Length, Checksum and innermost Identification, and the IPv6 Payload Length.
+ * The ECN and RES flags of the TCP header are also part of the template since
+ * they control the ecn_used flag. The innermost IP-ID shall keep its behavior.
+ *
+ * @param context          The real compression context for traces and update
+ * @param ref_ctxt         The reference compression context to detect changes
+ * @param uncomp_pkt_hdrs  The uncompressed headers to encode
+ * @param tmp              IN: The temporary state for the previous packet
+ *                         OUT: The temporary state for the compressed packet
+ * @return                 true if the changes of the previous packet were
+ *                         re-used, false if they shall be detected again
+ */
+static bool tcp_detect_changes_tmpl(const struct rohc_comp_ctxt *const context,
+                                    const struct rohc_comp_ctxt *const ref_ctxt,
+                                    const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                    struct tcp_tmp_variables *const tmp)
+{
+	const struct sc_tcp_context *const tcp_context = context->specific;
+	const struct rohc_comp_hdr_tmpl *const tmpl = &(tcp_context->hdr_tmpl);
+	const struct rohc_pkt_ip_hdr *const inner_ip_hdr = uncomp_pkt_hdrs->innermost_ip_hdr;
+	const size_t tcp_offset =
+		((const uint8_t *) uncomp_pkt_hdrs->tcp) - uncomp_pkt_hdrs->all_hdrs;
+	uint16_t ip_id_delta = 0;
+	uint16_t new_msn;
+	size_t ip_hdr_pos;
+
+	if(context->state != ROHC_COMP_STATE_SO || ref_ctxt != context ||
+	   tmpl->oa_repetitions_nr != context->oa_repetitions_nr ||
+	   !rohc_comp_hdr_tmpl_match(tmpl, uncomp_pkt_hdrs->all_hdrs,
+	                             tcp_offset + TCP_HDR_TMPL_LEN))
+	{
+		goto not_matching;
+	}
+
+	/* the outer IP-IDs shall keep their zero or random behaviors */
+	for(ip_hdr_pos = 0; (ip_hdr_pos + 1) < uncomp_pkt_hdrs->ip_hdrs_nr; ip_hdr_pos++)
+	{
+		const struct rohc_pkt_ip_hdr *const ip_hdr = &(uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos]);
+
+		if(ip_hdr->version == IPV4 &&
+		   tmp->changes[ip_hdr_pos].ip_id_behavior == ROHC_IP_ID_BEHAVIOR_RAND &&
+		   ip_hdr->ipv4->id == 0)
+		{
+			rohc_comp_debug(context, "headers match template, but outer IP-ID "
+			                "of IP header #%zu is now zero", ip_hdr_pos + 1);
+			goto not_matching;
+		}
+	}
+
+	new_msn = c_tcp_get_next_msn(context);
+
+	/* the innermost IP-ID shall keep its behavior */
+	if(inner_ip_hdr->version == IPV4)
+	{
+		const ip_context_t *const inner_ip_ctxt =
+			&(tcp_context->ip_contexts[tcp_context->ip_contexts_nr - 1]);
+		const uint16_t ip_id = rohc_ntoh16(inner_ip_hdr->ipv4->id);
+
+		if(rohc_comp_detect_ip_id_behavior(inner_ip_ctxt->last_ip_id, ip_id, 1, 19) !=
+		   tmp->innermost_ip_id_behavior)
+		{
+			rohc_comp_debug(context, "headers match template, but innermost "
+			                "IP-ID changed of behavior");
+			goto not_matching;
+		}
+		if(tmp->innermost_ip_id_behavior == ROHC_IP_ID_BEHAVIOR_SEQ_SWAP)
+		{
+			ip_id_delta = swab16(ip_id) - new_msn;
+		}
+		else
+		{
+			ip_id_delta = ip_id - new_msn;
+		}
+	}
+
+	rohc_comp_debug(context, "IP headers match template, re-use the changes of "
+	                "previous packet for MSN = 0x%04x / %u", new_msn, new_msn);
+	tmp->new_msn = new_msn;
+	tmp->ip_id_delta = ip_id_delta;
+	tmp->is_hdr_tmpl_matching = 1;
+
+	return true;
+
+not_matching:
+	tmp->is_hdr_tmpl_matching = 0;
+	return false;
+}
+
+
+/**
+ * @brief Detect changes between the IP headers of the packet and context
+ *
+ * @param context          The real compression context for traces and update
+ * @param ref_ctxt         The reference compression context to detect changes
+ * @param inner_ip_ctxt    The context of the innermost IP header
+ * @param uncomp_pkt_hdrs  The uncompressed headers to encode
+ * @param tmp              The temporary state for the compressed packet
+ */
+static void tcp_detect_changes_ip_hdrs(const struct rohc_comp_ctxt *const context,
+                                       const struct rohc_comp_ctxt *const ref_ctxt,
+                                       const ip_context_t *const inner_ip_ctxt,
+                                       const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                       struct tcp_tmp_variables *const tmp)
+{
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct sc_tcp_context *const tcp_context = ref_ctxt->specific;
 	size_t ip_hdr_pos;
 	bool pkt_outer_dscp_changed;
@@ -3500,13 +3739,99 @@ static void tcp_detect_changes(const struct rohc_comp_ctxt *const context,
 	{
 		tmp->innermost_dscp_changed = false;
 	}
+}
 
-	/* compute how many bits are needed to send header fields */
-	tcp_detect_changes_tcp_hdr(context, ref_ctxt, uncomp_pkt_hdrs, tmp);
 
-	/* parse TCP options for changes */
-	tcp_detect_options_changes(context, uncomp_pkt_hdrs, &tcp_context->tcp_opts,
-	                           &tmp->tcp_opts, !tmp->tcp_ack_num_unchanged);
+/**
+ * @brief Record the IP headers of the packet as template for the next packets
+ *
+ * The IP headers are recorded in SO state only, once all the IP fields and
+ * IP-ID behaviors were transmitted enough times to be considered unchanged.
+ *
+ * @param context          The real compression context
+ * @param ref_ctxt         The reference compression context
+ * @param uncomp_pkt_hdrs  The uncompressed headers of the packet
+ * @param tmp              The temporary state for the compressed packet
+ */
+static void tcp_update_hdr_tmpl(struct rohc_comp_ctxt *const context,
+                                const struct rohc_comp_ctxt *const ref_ctxt,
+                                const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                const struct tcp_tmp_variables *const tmp)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+	struct rohc_comp_hdr_tmpl *const tmpl = &(tcp_context->hdr_tmpl);
+	const uint8_t *const all_hdrs = uncomp_pkt_hdrs->all_hdrs;
+	const size_t tcp_offset = ((const uint8_t *) uncomp_pkt_hdrs->tcp) - all_hdrs;
+	size_t ip_hdr_pos;
+
+	/* template matched the packet, keep it */
+	if(tmp->is_hdr_tmpl_matching)
+	{
+		return;
+	}
+	rohc_comp_hdr_tmpl_reset(tmpl);
+
+	/* no IP field shall be transmitted anymore */
+	if(context->state != ROHC_COMP_STATE_SO || ref_ctxt != context ||
+	   tmp->outer_ip_ttl_changed || tmp->outer_ip_id_behavior_changed ||
+	   tmp->innermost_ip_id_behavior_changed || tmp->innermost_dscp_changed ||
+	   tmp->ip_df_changed || tmp->ecn_used_changed || tmp->ecn_used_just_changed ||
+	   tmp->is_ipv6_exts_list_static_changed || tmp->is_ipv6_exts_list_dyn_changed)
+	{
+		return;
+	}
+	for(ip_hdr_pos = 0; ip_hdr_pos < uncomp_pkt_hdrs->ip_hdrs_nr; ip_hdr_pos++)
+	{
+		if(tmp->changes[ip_hdr_pos].ttl_hopl_changed ||
+		   uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos].exts_nr > 0)
+		{
+			return;
+		}
+	}
+
+	if(!rohc_comp_hdr_tmpl_set(tmpl, all_hdrs, tcp_offset + TCP_HDR_TMPL_LEN,
+	                           tmp->new_msn))
+	{
+		return;
+	}
+	tmpl->oa_repetitions_nr = context->oa_repetitions_nr;
+
+	/* ignore the IP fields that change from one packet to another */
+	for(ip_hdr_pos = 0; ip_hdr_pos < uncomp_pkt_hdrs->ip_hdrs_nr; ip_hdr_pos++)
+	{
+		const struct rohc_pkt_ip_hdr *const ip_hdr = &(uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos]);
+		const bool is_innermost = !!((ip_hdr_pos + 1) == uncomp_pkt_hdrs->ip_hdrs_nr);
+		const size_t ip_offset = ip_hdr->data - all_hdrs;
+
+		if(ip_hdr->version == IPV4)
+		{
+			rohc_comp_hdr_tmpl_ignore(tmpl, ip_offset + offsetof(struct ipv4_hdr, tot_len),
+			                          sizeof(uint16_t));
+			rohc_comp_hdr_tmpl_ignore(tmpl, ip_offset + offsetof(struct ipv4_hdr, check),
+			                          sizeof(uint16_t));
+			if(is_innermost ||
+			   tmp->changes[ip_hdr_pos].ip_id_behavior == ROHC_IP_ID_BEHAVIOR_RAND)
+			{
+				rohc_comp_hdr_tmpl_ignore(tmpl, ip_offset + offsetof(struct ipv4_hdr, id),
+				                          sizeof(uint16_t));
+			}
+		}
+		else
+		{
+			rohc_comp_hdr_tmpl_ignore(tmpl, ip_offset + offsetof(struct ipv6_hdr, plen),
+			                          sizeof(uint16_t));
+		}
+	}
+
+	/* ignore the TCP sequence and ACK numbers, and the TCP flags but ECN */
+	rohc_comp_hdr_tmpl_ignore(tmpl, tcp_offset + offsetof(struct tcphdr, seq_num),
+	                          sizeof(uint32_t));
+	rohc_comp_hdr_tmpl_ignore(tmpl, tcp_offset + offsetof(struct tcphdr, ack_num),
+	                          sizeof(uint32_t));
+	rohc_comp_hdr_tmpl_ignore_bits(tmpl, tcp_offset + TCP_HDR_TMPL_LEN - 1, 0x3f);
+
+	rohc_comp_debug(context, "record the %u bytes of IP headers as template for "
+	                "next packets", tmpl->len);
 }
 
 
@@ -3525,7 +3850,7 @@ static void tcp_detect_changes_ipv6_exts(const struct rohc_comp_ctxt *const cont
                                          const struct rohc_pkt_ip_hdr *const ip_hdr,
                                          struct tcp_tmp_variables *const tmp)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct sc_tcp_context *const tcp_context = ref_ctxt->specific;
 	uint8_t ext_pos;
 
@@ -3663,7 +3988,7 @@ static void tcp_detect_changes_tcp_hdr(const struct rohc_comp_ctxt *const contex
                                        const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                        struct tcp_tmp_variables *const tmp)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct sc_tcp_context *const tcp_context = ref_ctxt->specific;
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
 
@@ -4110,71 +4435,38 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 		                "not compressible");
 		packet_type = ROHC_PACKET_IR_DYN;
 	}
-	else if(tmp->outer_ip_ttl_changed ||
-	        tmp->innermost_ip_id_behavior_changed ||
-	        tmp->ip_df_changed ||
-	        tmp->innermost_dscp_changed ||
-	        tmp->tcp_ack_flag_changed ||
-	        tmp->tcp_urg_flag_present ||
-	        tmp->tcp_urg_flag_changed ||
-	        tmp->tcp_urg_ptr_changed ||
-	        tmp->ack_num_scaling_changed)
-	{
-		TRACE_GOTO_CHOICE;
-		packet_type = ROHC_PACKET_TCP_CO_COMMON;
-	}
-	else if(tmp->ecn_used_changed ||
-	        tmp->innermost_ttl_hopl_changed)
-	{
-		/* use compressed header with a 7-bit CRC (rnd_8, seq_8 or common):
-		 *  - use common if too many LSB of sequence number are required
-		 *  - use common if too many LSB of sequence number are required
-		 *  - use common if too many LSB of innermost TTL/Hop Limit are required
-		 *  - use common if window changed */
-		if(tmp->innermost_ip_id_behavior <= ROHC_IP_ID_BEHAVIOR_SEQ_SWAP &&
-		   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb, tmp->ip_id_delta, 4, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		   wlsb_is_kp_possible_8bits(&tcp_ref_ctxt->ttl_hopl_wlsb,
-		                             uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                             3, ROHC_LSB_SHIFT_TCP_TTL) &&
-		   !tmp->tcp_window_changed)
-		{
-			/* ROHC_IP_ID_BEHAVIOR_SEQ or ROHC_IP_ID_BEHAVIOR_SEQ_SWAP */
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_SEQ_8;
-		}
-		else if(tmp->innermost_ip_id_behavior > ROHC_IP_ID_BEHAVIOR_SEQ_SWAP &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383) &&
-		        wlsb_is_kp_possible_8bits(&tcp_ref_ctxt->ttl_hopl_wlsb,
-		                                  uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                                  3, ROHC_LSB_SHIFT_TCP_TTL) &&
-		        !tmp->tcp_window_changed)
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_RND_8;
-		}
-		else
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_CO_COMMON;
-		}
-	}
 	else if(tmp->innermost_ip_id_behavior <= ROHC_IP_ID_BEHAVIOR_SEQ_SWAP)
 	{
 		/* ROHC_IP_ID_BEHAVIOR_SEQ or ROHC_IP_ID_BEHAVIOR_SEQ_SWAP:
 		 * co_common or seq_X packet types */
-		packet_type = tcp_decide_FO_SO_packet_seq(context, ref_ctxt, uncomp_pkt_hdrs,
-		                                          tmp, crc7_at_least);
+		const uint32_t pkt_reqs =
+			tcp_get_pkt_reqs(context, ref_ctxt, uncomp_pkt_hdrs, tmp,
+			                 crc7_at_least, true);
+		rohc_comp_debug(context, "packet requirements = 0x%08x", pkt_reqs);
+		packet_type = tcp_pkt_fmt_select(tcp_pkt_fmts_seq, tcp_pkt_fmts_seq_nr,
+		                                 pkt_reqs);
+
+		/* IP-ID is sequential, so only co_common and seq_X packets are allowed */
+		assert(packet_type == ROHC_PACKET_TCP_CO_COMMON ||
+		       (packet_type >= ROHC_PACKET_TCP_SEQ_1 &&
+		        packet_type <= ROHC_PACKET_TCP_SEQ_8));
 	}
 	else if(tmp->innermost_ip_id_behavior == ROHC_IP_ID_BEHAVIOR_RAND ||
 	        tmp->innermost_ip_id_behavior == ROHC_IP_ID_BEHAVIOR_ZERO)
 	{
 		/* ROHC_IP_ID_BEHAVIOR_RAND or ROHC_IP_ID_BEHAVIOR_ZERO:
 		 * co_common or rnd_X packet types */
-		packet_type = tcp_decide_FO_SO_packet_rnd(context, ref_ctxt, uncomp_pkt_hdrs,
-		                                          tmp, crc7_at_least);
+		const uint32_t pkt_reqs =
+			tcp_get_pkt_reqs(context, ref_ctxt, uncomp_pkt_hdrs, tmp,
+			                 crc7_at_least, false);
+		rohc_comp_debug(context, "packet requirements = 0x%08x", pkt_reqs);
+		packet_type = tcp_pkt_fmt_select(tcp_pkt_fmts_rnd, tcp_pkt_fmts_rnd_nr,
+		                                 pkt_reqs);
+
+		/* IP-ID is NOT sequential, so only co_common and rnd_X packets are allowed */
+		assert(packet_type == ROHC_PACKET_TCP_CO_COMMON ||
+		       (packet_type >= ROHC_PACKET_TCP_RND_1 &&
+		        packet_type <= ROHC_PACKET_TCP_RND_8));
 	}
 	else
 	{
@@ -4184,6 +4476,13 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 		goto error;
 	}
 
+	/* the formats with scaled sequence number require some payload */
+	assert((packet_type != ROHC_PACKET_TCP_SEQ_2 &&
+	        packet_type != ROHC_PACKET_TCP_SEQ_6 &&
+	        packet_type != ROHC_PACKET_TCP_RND_2 &&
+	        packet_type != ROHC_PACKET_TCP_RND_6) ||
+	       uncomp_pkt_hdrs->payload_len > 0);
+
 	rohc_comp_debug(context, "code %s packet",
 	                rohc_get_packet_descr(packet_type));
 
@@ -4195,7 +4494,10 @@ error:
 
 
 /**
- * @brief Decide which seq packet to send when in FO or SO state.
+ * @brief Compute the requirements of the packet on the compressed format
+ *
+ * The requirements are computed once, then the packet formats are checked
+ * against them (see \ref tcp_pkt_fmt_select).
  *
  * @param context           The real compression context for traces and update
  * @param ref_ctxt          The reference compression context to detect changes
@@ -4203,380 +4505,161 @@ error:
  * @param tmp               The temporary state for the compressed packet
  * @param crc7_at_least     Whether packet types with CRC strictly smaller
  *                          than 8 bits are allowed or not
- * @return                  \li The packet type among ROHC_PACKET_TCP_SEQ_[1-8]
- *                              and ROHC_PACKET_TCP_CO_COMMON in case of success
- *                          \li ROHC_PACKET_UNKNOWN in case of failure
+ * @param is_ip_id_seq      Whether the innermost IP-ID is sequential or not,
+ *                          ie. whether seq_X or rnd_X formats are considered
+ * @return                  The requirements of the packet, a combination of
+ *                          \ref tcp_pkt_req_t values
  */
-static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *const context,
-                                                 const struct rohc_comp_ctxt *const ref_ctxt,
-                                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
-                                                 const struct tcp_tmp_variables *const tmp,
-                                                 const bool crc7_at_least)
+static uint32_t tcp_get_pkt_reqs(const struct rohc_comp_ctxt *const context,
+                                 const struct rohc_comp_ctxt *const ref_ctxt,
+                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                 const struct tcp_tmp_variables *const tmp,
+                                 const bool crc7_at_least,
+                                 const bool is_ip_id_seq)
 {
 	const struct sc_tcp_context *const tcp_ref_ctxt = ref_ctxt->specific;
 	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
-	rohc_packet_t packet_type;
+	uint32_t pkt_reqs = 0;
 
-	if(tcp->rsf_flags == 0 &&
-	   !tmp->tcp_opts.is_list_needed &&
-	   !tmp->tcp_window_changed &&
-	   (tcp->ack_flag == 0 || tmp->tcp_ack_num_unchanged) &&
-	   !crc7_at_least &&
-	   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-	                              tmp->ip_id_delta, 7, 3) &&
-	   is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
-	                             tmp->seq_num_scaling_changed) &&
-	   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-	                              tmp->seq_num_scaled, 4, 7))
-	{
-		/* seq_2 is possible */
-		TRACE_GOTO_CHOICE;
-		assert(uncomp_pkt_hdrs->payload_len > 0);
-		packet_type = ROHC_PACKET_TCP_SEQ_2;
-	}
-	else if(tcp->rsf_flags != 0 ||
-	        tmp->tcp_opts.is_list_needed)
-	{
-		/* seq_8 or co_common
-		 *
-		 * seq_8 can be used if:
-		 *  - TCP window didn't change,
-		 *  - at most 14 LSB of the TCP sequence number are required,
-		 *  - at most 15 LSB of the TCP ACK number are required,
-		 *  - at most 4 LSBs of IP-ID must be transmitted
-		 * otherwise use co_common packet */
-		if(wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                              tmp->ip_id_delta, 4, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		   wlsb_is_kp_possible_8bits(&tcp_ref_ctxt->ttl_hopl_wlsb,
-		                             uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                             3, ROHC_LSB_SHIFT_TCP_TTL) &&
-		   !tmp->tcp_window_changed)
-		{
-			/* seq_8 is possible */
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_SEQ_8;
-		}
-		else
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_CO_COMMON;
-		}
+	/* some fields may only be transmitted by co_common, no need to compute
+	 * the other requirements in that case */
+	if(tmp->outer_ip_ttl_changed ||
+	   tmp->innermost_ip_id_behavior_changed ||
+	   tmp->ip_df_changed ||
+	   tmp->innermost_dscp_changed ||
+	   tmp->tcp_ack_flag_changed ||
+	   tmp->tcp_urg_flag_present ||
+	   tmp->tcp_urg_flag_changed ||
+	   tmp->tcp_urg_ptr_changed ||
+	   tmp->ack_num_scaling_changed)
+	{
+		rohc_comp_debug(context, "at least one field may only be transmitted "
+		                "by co_common");
+		return TCP_REQ_CO_COMMON;
 	}
-	else if(tmp->tcp_window_changed)
+
+	/* fields that changed */
+	if(crc7_at_least)
 	{
-		/* seq_7 or co_common */
-		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->window_wlsb,
-		                              rohc_ntoh16(tcp->window), 15, 16383) &&
-		   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                              tmp->ip_id_delta, 5, 3) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 32767) &&
-		   tmp->tcp_seq_num_unchanged)
-		{
-			/* seq_7 is possible */
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_SEQ_7;
-		}
-		else
-		{
-			/* seq_7 is not possible, seq_8 neither so fallback on co_common */
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_CO_COMMON;
-		}
+		pkt_reqs |= TCP_REQ_CRC7;
 	}
-	else if(tcp->ack_flag == 0 || tmp->tcp_ack_num_unchanged)
+	if(tmp->ecn_used_changed || tmp->innermost_ttl_hopl_changed)
 	{
-		/* seq_2, seq_1 or co_common */
-		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                              tmp->ip_id_delta, 7, 3) &&
-		   is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
-		                             tmp->seq_num_scaling_changed) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-		                              tmp->seq_num_scaled, 4, 7))
-		{
-			/* seq_2 is possible */
-			TRACE_GOTO_CHOICE;
-			assert(uncomp_pkt_hdrs->payload_len > 0);
-			packet_type = ROHC_PACKET_TCP_SEQ_2;
-		}
-		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 32767))
-		{
-			/* seq_1 is possible */
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_SEQ_1;
-		}
-		else if(wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
-		        true /* TODO: no more than 3 bits of TTL */ &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191))
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_SEQ_8;
-		}
-		else
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_CO_COMMON;
-		}
+		pkt_reqs |= TCP_REQ_TTL_ECN_CHANGED;
 	}
-	else if(tmp->tcp_seq_num_unchanged)
+	if(tcp->rsf_flags != 0 || tmp->tcp_opts.is_list_needed)
 	{
-		/* seq_4, seq_3, or co_common */
-		if(!crc7_at_least &&
-		   wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                              tmp->ip_id_delta, 3, 1) &&
-		   is_field_scaling_possible(tmp->ack_stride,
-		                             tmp->ack_num_scaling_changed) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_scaled_wlsb,
-		                              tmp->ack_num_scaled, 4, 3))
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_SEQ_4;
-		}
-		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383))
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_SEQ_3;
-		}
-		else if(wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-		                                   tmp->ip_id_delta, 4, 3) &&
-		        true /* TODO: no more than 3 bits of TTL */ &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191))
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_SEQ_8;
-		}
-		else
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_CO_COMMON;
-		}
+		pkt_reqs |= TCP_REQ_RSF_OPTS;
 	}
-	else if(wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
-	                                   tmp->ip_id_delta, 4, 3))
-	{
-		/* sequence and acknowledgment numbers changed:
-		 * seq_6, seq_5, seq_8 or co_common */
-		if(!crc7_at_least &&
-		   is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
-		                             tmp->seq_num_scaling_changed) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-		                              tmp->seq_num_scaled, 4, 7) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383))
-		{
-			TRACE_GOTO_CHOICE;
-			assert(uncomp_pkt_hdrs->payload_len > 0);
-			packet_type = ROHC_PACKET_TCP_SEQ_6;
-		}
-		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 32767))
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_SEQ_5;
-		}
-		else if(wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191) &&
-		        wlsb_is_kp_possible_8bits(&tcp_ref_ctxt->ttl_hopl_wlsb,
-		                                  uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
-		                                  3, ROHC_LSB_SHIFT_TCP_TTL) &&
-		        !tmp->tcp_window_changed)
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_SEQ_8;
-		}
-		else
+	if(tmp->tcp_window_changed)
+	{
+		pkt_reqs |= TCP_REQ_WINDOW_CHANGED;
+	}
+	if(!tmp->tcp_seq_num_unchanged)
+	{
+		pkt_reqs |= TCP_REQ_SEQ_CHANGED;
+	}
+	if(!tmp->tcp_ack_num_unchanged)
+	{
+		pkt_reqs |= TCP_REQ_ACK_CHANGED;
+		if(tcp->ack_flag != 0)
 		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_CO_COMMON;
+			pkt_reqs |= TCP_REQ_ACK_USED;
 		}
 	}
-	else
+	if(tcp->ack_flag == 0)
 	{
-		TRACE_GOTO_CHOICE;
-		packet_type = ROHC_PACKET_TCP_CO_COMMON;
+		pkt_reqs |= TCP_REQ_ACK_FLAG_UNSET;
 	}
 
-	/* IP-ID is sequential, so only co_common and seq_X packets are allowed */
-	assert(packet_type == ROHC_PACKET_TCP_CO_COMMON ||
-	       (packet_type >= ROHC_PACKET_TCP_SEQ_1 &&
-	        packet_type <= ROHC_PACKET_TCP_SEQ_8));
-
-	return packet_type;
-}
-
-
-/**
- * @brief Decide which rnd packet to send when in FO or SO state.
- *
- * @param context           The real compression context for traces and update
- * @param ref_ctxt          The reference compression context to detect changes
- * @param uncomp_pkt_hdrs   The uncompressed headers to encode
- * @param tmp               The temporary state for the compressed packet
- * @param crc7_at_least     Whether packet types with CRC strictly smaller
- *                          than 8 bits are allowed or not
- * @return                  \li The packet type among ROHC_PACKET_TCP_SEQ_[1-8]
- *                              and ROHC_PACKET_TCP_CO_COMMON in case of success
- *                          \li ROHC_PACKET_UNKNOWN in case of failure
- */
-static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *const context,
-                                                 const struct rohc_comp_ctxt *const ref_ctxt,
-                                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
-                                                 const struct tcp_tmp_variables *const tmp,
-                                                 const bool crc7_at_least)
-{
-	const struct sc_tcp_context *const tcp_ref_ctxt = ref_ctxt->specific;
-	const struct tcphdr *const tcp = uncomp_pkt_hdrs->tcp;
-	rohc_packet_t packet_type;
+	/* LSB encodings common to the seq_X and rnd_X packet formats */
+	if(!is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
+	                              tmp->seq_num_scaling_changed) ||
+	   !wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
+	                               tmp->seq_num_scaled, 4, 7))
+	{
+		pkt_reqs |= TCP_REQ_SEQ_SCALED_NOT_LSB_4_7;
+	}
+	if(!is_field_scaling_possible(tmp->ack_stride, tmp->ack_num_scaling_changed) ||
+	   !wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_scaled_wlsb,
+	                               tmp->ack_num_scaled, 4, 3))
+	{
+		pkt_reqs |= TCP_REQ_ACK_SCALED_NOT_LSB_4_3;
+	}
+	if(!wlsb_is_kp_possible_8bits(&tcp_ref_ctxt->ttl_hopl_wlsb,
+	                              uncomp_pkt_hdrs->innermost_ip_hdr->ttl_hl,
+	                              3, ROHC_LSB_SHIFT_TCP_TTL))
+	{
+		pkt_reqs |= TCP_REQ_TTL_NOT_LSB_3_3;
+	}
+	if(!wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191))
+	{
+		pkt_reqs |= TCP_REQ_SEQ_NOT_LSB_14_8191;
+	}
+	if(!wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191))
+	{
+		pkt_reqs |= TCP_REQ_ACK_NOT_LSB_15_8191;
+	}
+	if(!wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383))
+	{
+		pkt_reqs |= TCP_REQ_ACK_NOT_LSB_16_16383;
+	}
 
-	if(tcp->rsf_flags == 0 &&
-	   !tmp->tcp_opts.is_list_needed &&
-	   !tmp->tcp_window_changed &&
-	   !crc7_at_least &&
-	   tmp->tcp_ack_num_unchanged &&
-	   is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
-	                             tmp->seq_num_scaling_changed) &&
-	   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-	                              tmp->seq_num_scaled, 4, 7))
-	{
-		/* rnd_2 is possible */
-		assert(uncomp_pkt_hdrs->payload_len > 0);
-		TRACE_GOTO_CHOICE;
-		packet_type = ROHC_PACKET_TCP_RND_2;
-	}
-	else if(tcp->rsf_flags != 0 ||
-	        tmp->tcp_opts.is_list_needed)
-	{
-		if(!tmp->tcp_window_changed &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383))
-		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_RND_8;
-		}
-		else
+	if(is_ip_id_seq)
+	{
+		/* LSB encodings specific to the seq_X packet formats */
+		if(!wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
+		                               tmp->ip_id_delta, 3, 1))
 		{
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_CO_COMMON;
+			pkt_reqs |= TCP_REQ_IP_ID_NOT_LSB_3_1;
 		}
-	}
-	else /* unchanged structure of the list of TCP options */
-	{
-		if(tmp->tcp_window_changed)
+		if(!wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
+		                               tmp->ip_id_delta, 4, 3))
 		{
-			if(!crc7_at_least &&
-			   tmp->tcp_seq_num_unchanged &&
-			   wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 18, 65535))
-			{
-				/* rnd_7 is possible */
-				TRACE_GOTO_CHOICE;
-				packet_type = ROHC_PACKET_TCP_RND_7;
-			}
-			else
-			{
-				/* rnd_7 is not possible, rnd_8 neither so fallback on co_common */
-				TRACE_GOTO_CHOICE;
-				packet_type = ROHC_PACKET_TCP_CO_COMMON;
-			}
+			pkt_reqs |= TCP_REQ_IP_ID_NOT_LSB_4_3;
 		}
-		else if(!crc7_at_least &&
-		        tmp->tcp_ack_num_unchanged &&
-		        is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
-		                                  tmp->seq_num_scaling_changed) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-		                                   tmp->seq_num_scaled, 4, 7))
+		if(!wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
+		                               tmp->ip_id_delta, 5, 3))
 		{
-			/* rnd_2 is possible */
-			assert(uncomp_pkt_hdrs->payload_len > 0);
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_RND_2;
+			pkt_reqs |= TCP_REQ_IP_ID_NOT_LSB_5_3;
 		}
-		else if(!crc7_at_least &&
-		        tcp->ack_flag != 0 &&
-		        is_field_scaling_possible(tmp->ack_stride,
-		                                  tmp->ack_num_scaling_changed) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_scaled_wlsb,
-		                                   tmp->ack_num_scaled, 4, 3) &&
-		        tmp->tcp_seq_num_unchanged)
+		if(!wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->ip_id_wlsb,
+		                               tmp->ip_id_delta, 7, 3))
 		{
-			/* rnd_4 is possible */
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_RND_4;
+			pkt_reqs |= TCP_REQ_IP_ID_NOT_LSB_7_3;
 		}
-		else if(!crc7_at_least &&
-		        tcp->ack_flag != 0 &&
-		        tmp->tcp_seq_num_unchanged &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191))
+		if(!wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 32767))
 		{
-			/* rnd_3 is possible */
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_RND_3;
+			pkt_reqs |= TCP_REQ_SEQ_NOT_LSB_16_32767;
 		}
-		else if(!crc7_at_least &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 18, 65535) &&
-		        tmp->tcp_ack_num_unchanged)
+		if(!wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 32767))
 		{
-			/* rnd_1 is possible */
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_RND_1;
+			pkt_reqs |= TCP_REQ_ACK_NOT_LSB_16_32767;
 		}
-		else if(!crc7_at_least &&
-		        tcp->ack_flag != 0 &&
-		        is_field_scaling_possible(uncomp_pkt_hdrs->payload_len,
-		                                  tmp->seq_num_scaling_changed) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_scaled_wlsb,
-		                                   tmp->seq_num_scaled, 4, 7) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383))
+		if(!wlsb_is_kp_possible_16bits(&tcp_ref_ctxt->window_wlsb,
+		                               rohc_ntoh16(tcp->window), 15, 16383))
 		{
-			/* ACK number present */
-			/* rnd_6 is possible */
-			assert(uncomp_pkt_hdrs->payload_len > 0);
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_RND_6;
+			pkt_reqs |= TCP_REQ_WINDOW_NOT_LSB_15_16383;
 		}
-		else if(!crc7_at_least &&
-		        tcp->ack_flag != 0 &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 14, 8191) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 15, 8191))
+	}
+	else
+	{
+		/* LSB encodings specific to the rnd_X packet formats */
+		if(!wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 65535))
 		{
-			/* ACK number present */
-			/* rnd_5 is possible */
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_RND_5;
+			pkt_reqs |= TCP_REQ_SEQ_NOT_LSB_16_65535;
 		}
-		else if(/* !tmp->tcp_window_changed && */
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 16, 65535) &&
-		        wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 16, 16383))
+		if(!wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->seq_wlsb, tmp->seq_num, 18, 65535))
 		{
-			/* fallback on rnd_8 */
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_RND_8;
+			pkt_reqs |= TCP_REQ_SEQ_NOT_LSB_18_65535;
 		}
-		else
+		if(!wlsb_is_kp_possible_32bits(&tcp_ref_ctxt->ack_wlsb, tmp->ack_num, 18, 65535))
 		{
-			/* rnd_8 is not possible, fallback on co_common */
-			TRACE_GOTO_CHOICE;
-			packet_type = ROHC_PACKET_TCP_CO_COMMON;
+			pkt_reqs |= TCP_REQ_ACK_NOT_LSB_18_65535;
 		}
-	} /* end of case 'unchanged structure of the list of TCP options' */
-
-	/* IP-ID is NOT sequential, so only co_common and rnd_X packets are allowed */
-	assert(packet_type == ROHC_PACKET_TCP_CO_COMMON ||
-	       (packet_type >= ROHC_PACKET_TCP_RND_1 &&
-	        packet_type <= ROHC_PACKET_TCP_RND_8));
+	}
 
-	return packet_type;
+	return pkt_reqs;
 }
 
 
@@ -4600,7 +4683,7 @@ static void tcp_detect_ecn_used_behavior(const struct rohc_comp_ctxt *const cont
                                          const uint8_t pkt_res_val,
                                          struct tcp_tmp_variables *const tmp)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct sc_tcp_context *const tcp_context = ref_ctxt->specific;
 	const bool ctxt_ecn_used = tcp_context->ecn_used;
 
@@ -5027,5 +5110,7 @@ const struct rohc_comp_profile c_tcp_profile =
 	.is_cr_possible = c_tcp_is_cr_possible,
 	.encode         = c_tcp_encode,
 	.feedback       = c_tcp_feedback,
+	.set_oa_repetitions = c_tcp_set_oa_repetitions,
+	.account_mem    = c_tcp_account_mem,
 };
 
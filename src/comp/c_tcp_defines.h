@@ -33,6 +33,7 @@
 #include "protocols/tcp.h"
 #include "schemes/ip_ctxt.h"
 #include "c_tcp_opts_list.h"
+#include "rohc_comp_hdr_tmpl.h"
 
 
 /**
@@ -124,6 +125,8 @@ struct tcp_tmp_variables
 	uint32_t seq_num_scaling_changed:1;
 	uint32_t ack_num_scaling_just_changed:1;
 	uint32_t ack_num_scaling_changed:1;
+	/** Whether the IP headers matched the header template of the context */
+	uint32_t is_hdr_tmpl_matching:1;
 
 	/** The temporary part of the context for TCP options */
 	struct c_tcp_opts_ctxt_tmp tcp_opts;
@@ -199,6 +202,12 @@ struct sc_tcp_context
 
 	uint16_t urg_ptr_nbo;
 	uint16_t window_nbo;
+
+	/** The temporary state of the last compressed packet, the changes of the
+	 *  IP headers are re-used if they match the header template */
+	struct tcp_tmp_variables tmp;
+	/** The template of the IP headers of the flow in SO state */
+	struct rohc_comp_hdr_tmpl hdr_tmpl;
 };
 
 /* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
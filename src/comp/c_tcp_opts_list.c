@@ -732,13 +732,13 @@ void tcp_detect_options_changes(const struct rohc_comp_ctxt *const context,
 		                "base header");
 		tmp->is_list_needed = true;
 	}
-	else if(opts_ctxt->structure_nr_trans < context->compressor->oa_repetitions_nr)
+	else if(opts_ctxt->structure_nr_trans < context->oa_repetitions_nr)
 	{
 		/* the structure was transmitted but not enough times */
 		rohc_comp_debug(context, "structure of TCP options list changed in "
 		                "the last few packets, compressed list must be "
 		                "transmitted at least %u times more in the compressed "
-		                "base header", context->compressor->oa_repetitions_nr -
+		                "base header", context->oa_repetitions_nr -
 		                opts_ctxt->structure_nr_trans);
 		assert(opts_ctxt->old_structure_nr == opts_nr);
 		tmp->is_list_needed = true;
@@ -931,7 +931,7 @@ int c_tcp_code_tcp_opts_irreg(const struct rohc_comp_ctxt *const context,
                               uint8_t *const comp_opts,
                               const size_t comp_opts_max_len)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	uint8_t *rohc_remain_data = comp_opts;
 	size_t rohc_remain_len = comp_opts_max_len;
 	size_t comp_opts_len = 0;
@@ -1515,14 +1515,14 @@ static bool c_tcp_is_list_item_needed(const struct rohc_comp_ctxt *const context
 		                tcp_opt_get_descr(opt_type));
 		item_needed = true;
 	}
-	else if(opt_nr_trans < context->compressor->oa_repetitions_nr)
+	else if(opt_nr_trans < context->oa_repetitions_nr)
 	{
 		/* option was already transmitted and didn't change since then, but the
 		 * compressor is not confident yet that decompressor got the list item */
 		rohc_comp_debug(context, "TCP options list: static part of option '%s' "
 		                "shall be transmitted %u times more to gain transmission "
 		                "confidence", tcp_opt_get_descr(opt_type),
-		                context->compressor->oa_repetitions_nr - opt_nr_trans);
+		                context->oa_repetitions_nr - opt_nr_trans);
 		item_needed = true;
 	}
 	else
@@ -1532,7 +1532,7 @@ static bool c_tcp_is_list_item_needed(const struct rohc_comp_ctxt *const context
 		rohc_comp_debug(context, "TCP options list: static part of option '%s' "
 		                "is unchanged and was transmitted at least %u times",
 		                tcp_opt_get_descr(opt_type),
-		                context->compressor->oa_repetitions_nr);
+		                context->oa_repetitions_nr);
 		item_needed = false;
 	}
 
@@ -0,0 +1,339 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   c_tcp_pkt_types.c
+ * @brief  Capabilities of the compressed packet formats of the TCP profile
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "c_tcp_pkt_types.h"
+
+#include <assert.h>
+
+
+/** The requirements that prevent the formats of the seq_X/rnd_X ladders */
+#define TCP_REQS_LADDER \
+	(TCP_REQ_CO_COMMON | TCP_REQ_TTL_ECN_CHANGED | TCP_REQ_RSF_OPTS)
+
+
+/**
+ * @brief The packet formats for sequential innermost IP-ID
+ *
+ * See RFC6846 §8.2 for the definitions of the packet formats. The formats
+ * are ordered by preference: the first one that is considered for the
+ * packet and that is able to transmit it is used. Some formats appear
+ * several times because they are not preferred in the same way depending on
+ * the fields that changed. co_common comes last because it is able to
+ * transmit every field.
+ */
+const struct tcp_pkt_fmt tcp_pkt_fmts_seq[] =
+{
+	/* the innermost TTL/Hop Limit or the ecn_used flag changed: seq_8 or
+	 * co_common */
+	{
+		.type = ROHC_PACKET_TCP_SEQ_8,
+		.conds = TCP_REQ_TTL_ECN_CHANGED,
+		.caps = TCP_REQ_ALL & ~(TCP_REQ_CO_COMMON |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_IP_ID_NOT_LSB_4_3 |
+		                        TCP_REQ_SEQ_NOT_LSB_14_8191 |
+		                        TCP_REQ_ACK_NOT_LSB_15_8191 |
+		                        TCP_REQ_TTL_NOT_LSB_3_3),
+	},
+	/* seq_2 whenever possible */
+	{
+		.type = ROHC_PACKET_TCP_SEQ_2,
+		.conds = 0,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_ACK_USED |
+		                        TCP_REQ_IP_ID_NOT_LSB_7_3 |
+		                        TCP_REQ_SEQ_SCALED_NOT_LSB_4_7),
+	},
+	/* RST, SYN or FIN flag or list of TCP options: seq_8 or co_common */
+	{
+		.type = ROHC_PACKET_TCP_SEQ_8,
+		.conds = TCP_REQ_RSF_OPTS,
+		.caps = TCP_REQ_ALL & ~(TCP_REQ_CO_COMMON |
+		                        TCP_REQ_TTL_ECN_CHANGED |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_IP_ID_NOT_LSB_4_3 |
+		                        TCP_REQ_SEQ_NOT_LSB_14_8191 |
+		                        TCP_REQ_ACK_NOT_LSB_15_8191 |
+		                        TCP_REQ_TTL_NOT_LSB_3_3),
+	},
+	/* TCP window changed: seq_7 or co_common */
+	{
+		.type = ROHC_PACKET_TCP_SEQ_7,
+		.conds = TCP_REQ_WINDOW_CHANGED,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_SEQ_CHANGED |
+		                        TCP_REQ_IP_ID_NOT_LSB_5_3 |
+		                        TCP_REQ_ACK_NOT_LSB_16_32767 |
+		                        TCP_REQ_WINDOW_NOT_LSB_15_16383),
+	},
+	/* ACK number unchanged or unused: seq_1, seq_8 or co_common */
+	{
+		.type = ROHC_PACKET_TCP_SEQ_1,
+		.conds = 0,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_ACK_USED |
+		                        TCP_REQ_IP_ID_NOT_LSB_4_3 |
+		                        TCP_REQ_SEQ_NOT_LSB_16_32767),
+	},
+	{
+		.type = ROHC_PACKET_TCP_SEQ_8,
+		.conds = 0,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_ACK_USED |
+		                        TCP_REQ_IP_ID_NOT_LSB_4_3 |
+		                        TCP_REQ_SEQ_NOT_LSB_14_8191 |
+		                        TCP_REQ_ACK_NOT_LSB_15_8191),
+	},
+	/* ACK number changed but sequence number unchanged: seq_4, seq_3, seq_8
+	 * or co_common */
+	{
+		.type = ROHC_PACKET_TCP_SEQ_4,
+		.conds = TCP_REQ_ACK_USED,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_SEQ_CHANGED |
+		                        TCP_REQ_IP_ID_NOT_LSB_3_1 |
+		                        TCP_REQ_ACK_SCALED_NOT_LSB_4_3),
+	},
+	{
+		.type = ROHC_PACKET_TCP_SEQ_3,
+		.conds = TCP_REQ_ACK_USED,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_SEQ_CHANGED |
+		                        TCP_REQ_IP_ID_NOT_LSB_4_3 |
+		                        TCP_REQ_ACK_NOT_LSB_16_16383),
+	},
+	{
+		.type = ROHC_PACKET_TCP_SEQ_8,
+		.conds = TCP_REQ_ACK_USED,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_SEQ_CHANGED |
+		                        TCP_REQ_IP_ID_NOT_LSB_4_3 |
+		                        TCP_REQ_SEQ_NOT_LSB_14_8191 |
+		                        TCP_REQ_ACK_NOT_LSB_15_8191),
+	},
+	/* sequence and ACK numbers changed: seq_6, seq_5, seq_8 or co_common */
+	{
+		.type = ROHC_PACKET_TCP_SEQ_6,
+		.conds = TCP_REQ_ACK_USED | TCP_REQ_SEQ_CHANGED,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_IP_ID_NOT_LSB_4_3 |
+		                        TCP_REQ_SEQ_SCALED_NOT_LSB_4_7 |
+		                        TCP_REQ_ACK_NOT_LSB_16_16383),
+	},
+	{
+		.type = ROHC_PACKET_TCP_SEQ_5,
+		.conds = TCP_REQ_ACK_USED | TCP_REQ_SEQ_CHANGED,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_IP_ID_NOT_LSB_4_3 |
+		                        TCP_REQ_SEQ_NOT_LSB_16_32767 |
+		                        TCP_REQ_ACK_NOT_LSB_16_16383),
+	},
+	{
+		.type = ROHC_PACKET_TCP_SEQ_8,
+		.conds = TCP_REQ_ACK_USED | TCP_REQ_SEQ_CHANGED,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_IP_ID_NOT_LSB_4_3 |
+		                        TCP_REQ_SEQ_NOT_LSB_14_8191 |
+		                        TCP_REQ_ACK_NOT_LSB_15_8191 |
+		                        TCP_REQ_TTL_NOT_LSB_3_3),
+	},
+	{
+		.type = ROHC_PACKET_TCP_CO_COMMON,
+		.conds = 0,
+		.caps = TCP_REQ_ALL,
+	},
+};
+
+/** The number of packet formats for sequential innermost IP-ID */
+const size_t tcp_pkt_fmts_seq_nr =
+	sizeof(tcp_pkt_fmts_seq) / sizeof(struct tcp_pkt_fmt);
+
+
+/**
+ * @brief The packet formats for random or zero innermost IP-ID
+ *
+ * See RFC6846 §8.2 for the definitions of the packet formats. The formats
+ * are ordered by preference: the first one that is considered for the
+ * packet and that is able to transmit it is used. Some formats appear
+ * several times because they are not preferred in the same way depending on
+ * the fields that changed. co_common comes last because it is able to
+ * transmit every field.
+ */
+const struct tcp_pkt_fmt tcp_pkt_fmts_rnd[] =
+{
+	/* the innermost TTL/Hop Limit or the ecn_used flag changed: rnd_8 or
+	 * co_common */
+	{
+		.type = ROHC_PACKET_TCP_RND_8,
+		.conds = TCP_REQ_TTL_ECN_CHANGED,
+		.caps = TCP_REQ_ALL & ~(TCP_REQ_CO_COMMON |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_SEQ_NOT_LSB_16_65535 |
+		                        TCP_REQ_ACK_NOT_LSB_16_16383 |
+		                        TCP_REQ_TTL_NOT_LSB_3_3),
+	},
+	/* rnd_2 whenever possible */
+	{
+		.type = ROHC_PACKET_TCP_RND_2,
+		.conds = 0,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_ACK_CHANGED |
+		                        TCP_REQ_SEQ_SCALED_NOT_LSB_4_7),
+	},
+	/* RST, SYN or FIN flag or list of TCP options: rnd_8 or co_common */
+	{
+		.type = ROHC_PACKET_TCP_RND_8,
+		.conds = TCP_REQ_RSF_OPTS,
+		.caps = TCP_REQ_ALL & ~(TCP_REQ_CO_COMMON |
+		                        TCP_REQ_TTL_ECN_CHANGED |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_SEQ_NOT_LSB_16_65535 |
+		                        TCP_REQ_ACK_NOT_LSB_16_16383),
+	},
+	/* TCP window changed: rnd_7 or co_common */
+	{
+		/* the TCP window is transmitted uncompressed */
+		.type = ROHC_PACKET_TCP_RND_7,
+		.conds = TCP_REQ_WINDOW_CHANGED,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_SEQ_CHANGED |
+		                        TCP_REQ_ACK_NOT_LSB_18_65535),
+	},
+	/* TCP window unchanged: rnd_4, rnd_3, rnd_1, rnd_6, rnd_5, rnd_8 or
+	 * co_common */
+	{
+		.type = ROHC_PACKET_TCP_RND_4,
+		.conds = 0,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_SEQ_CHANGED |
+		                        TCP_REQ_ACK_FLAG_UNSET |
+		                        TCP_REQ_ACK_SCALED_NOT_LSB_4_3),
+	},
+	{
+		.type = ROHC_PACKET_TCP_RND_3,
+		.conds = 0,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_SEQ_CHANGED |
+		                        TCP_REQ_ACK_FLAG_UNSET |
+		                        TCP_REQ_ACK_NOT_LSB_15_8191),
+	},
+	{
+		.type = ROHC_PACKET_TCP_RND_1,
+		.conds = 0,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_ACK_CHANGED |
+		                        TCP_REQ_SEQ_NOT_LSB_18_65535),
+	},
+	{
+		.type = ROHC_PACKET_TCP_RND_6,
+		.conds = 0,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_ACK_FLAG_UNSET |
+		                        TCP_REQ_SEQ_SCALED_NOT_LSB_4_7 |
+		                        TCP_REQ_ACK_NOT_LSB_16_16383),
+	},
+	{
+		.type = ROHC_PACKET_TCP_RND_5,
+		.conds = 0,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_CRC7 |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_ACK_FLAG_UNSET |
+		                        TCP_REQ_SEQ_NOT_LSB_14_8191 |
+		                        TCP_REQ_ACK_NOT_LSB_15_8191),
+	},
+	{
+		.type = ROHC_PACKET_TCP_RND_8,
+		.conds = 0,
+		.caps = TCP_REQ_ALL & ~(TCP_REQS_LADDER |
+		                        TCP_REQ_WINDOW_CHANGED |
+		                        TCP_REQ_SEQ_NOT_LSB_16_65535 |
+		                        TCP_REQ_ACK_NOT_LSB_16_16383),
+	},
+	{
+		.type = ROHC_PACKET_TCP_CO_COMMON,
+		.conds = 0,
+		.caps = TCP_REQ_ALL,
+	},
+};
+
+/** The number of packet formats for random or zero innermost IP-ID */
+const size_t tcp_pkt_fmts_rnd_nr =
+	sizeof(tcp_pkt_fmts_rnd) / sizeof(struct tcp_pkt_fmt);
+
+
+/**
+ * @brief Select the preferred packet format that fulfills the requirements
+ *
+ * @param fmts      The packet formats to select from, ordered by preference
+ * @param fmts_nr   The number of packet formats
+ * @param pkt_reqs  The requirements of the packet to compress
+ * @return          The type of the first packet format in the table that is
+ *                  considered for the packet and that fulfills all the
+ *                  requirements of the packet
+ */
+rohc_packet_t tcp_pkt_fmt_select(const struct tcp_pkt_fmt *const fmts,
+                                 const size_t fmts_nr,
+                                 const uint32_t pkt_reqs)
+{
+	size_t i;
+
+	assert(fmts_nr > 0);
+	assert(fmts[fmts_nr - 1].caps == TCP_REQ_ALL);
+
+	for(i = 0; i < (fmts_nr - 1) &&
+	           ((pkt_reqs & fmts[i].conds) != fmts[i].conds ||
+	            (pkt_reqs & ~(fmts[i].caps)) != 0); i++)
+	{
+	}
+
+	return fmts[i].type;
+}
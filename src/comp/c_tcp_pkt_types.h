@@ -0,0 +1,136 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   c_tcp_pkt_types.h
+ * @brief  Capabilities of the compressed packet formats of the TCP profile
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The choice of the compressed packet format is made in two steps:
+ *  1/ the requirements of the packet to compress are computed once, every
+ *     requirement being one bit of a vector (see \ref tcp_pkt_req_t),
+ *  2/ the first packet format that is considered for the requirements of
+ *     the packet and that fulfills all of them is selected in a table of
+ *     packet formats ordered by preference.
+ */
+
+#ifndef ROHC_COMP_TCP_PKT_TYPES_H
+#define ROHC_COMP_TCP_PKT_TYPES_H
+
+#include "rohc_packets.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * @brief The requirements of one TCP packet on the compressed packet format
+ *
+ * The first requirements describe the fields that changed, the next ones
+ * describe the LSB encodings that are not able to transmit a field: a bit
+ * TCP_REQ_X_NOT_LSB_K_P is set when the field X cannot be transmitted with
+ * the LSB(k, p) encoding.
+ */
+typedef enum
+{
+	/** At least one field can only be transmitted by co_common */
+	TCP_REQ_CO_COMMON               = (1U <<  0),
+	/** The CRC shall be 7-bit long at least */
+	TCP_REQ_CRC7                    = (1U <<  1),
+	/** The innermost TTL/Hop Limit or the ecn_used flag changed */
+	TCP_REQ_TTL_ECN_CHANGED         = (1U <<  2),
+	/** At least one of the RST, SYN or FIN flags is set or the list of TCP
+	 *  options shall be transmitted */
+	TCP_REQ_RSF_OPTS                = (1U <<  3),
+	/** The TCP window changed */
+	TCP_REQ_WINDOW_CHANGED          = (1U <<  4),
+	/** The TCP sequence number changed */
+	TCP_REQ_SEQ_CHANGED             = (1U <<  5),
+	/** The TCP ACK number changed */
+	TCP_REQ_ACK_CHANGED             = (1U <<  6),
+	/** The TCP ACK number changed and the ACK flag is set */
+	TCP_REQ_ACK_USED                = (1U <<  7),
+	/** The TCP ACK flag is not set */
+	TCP_REQ_ACK_FLAG_UNSET          = (1U <<  8),
+
+	/** The innermost IP-ID offset cannot be transmitted with LSB(3, 1) */
+	TCP_REQ_IP_ID_NOT_LSB_3_1       = (1U <<  9),
+	/** The innermost IP-ID offset cannot be transmitted with LSB(4, 3) */
+	TCP_REQ_IP_ID_NOT_LSB_4_3       = (1U << 10),
+	/** The innermost IP-ID offset cannot be transmitted with LSB(5, 3) */
+	TCP_REQ_IP_ID_NOT_LSB_5_3       = (1U << 11),
+	/** The innermost IP-ID offset cannot be transmitted with LSB(7, 3) */
+	TCP_REQ_IP_ID_NOT_LSB_7_3       = (1U << 12),
+	/** The sequence number cannot be transmitted with LSB(14, 8191) */
+	TCP_REQ_SEQ_NOT_LSB_14_8191     = (1U << 13),
+	/** The sequence number cannot be transmitted with LSB(16, 32767) */
+	TCP_REQ_SEQ_NOT_LSB_16_32767    = (1U << 14),
+	/** The sequence number cannot be transmitted with LSB(16, 65535) */
+	TCP_REQ_SEQ_NOT_LSB_16_65535    = (1U << 15),
+	/** The sequence number cannot be transmitted with LSB(18, 65535) */
+	TCP_REQ_SEQ_NOT_LSB_18_65535    = (1U << 16),
+	/** The scaled sequence number cannot be transmitted with LSB(4, 7) */
+	TCP_REQ_SEQ_SCALED_NOT_LSB_4_7  = (1U << 17),
+	/** The ACK number cannot be transmitted with LSB(15, 8191) */
+	TCP_REQ_ACK_NOT_LSB_15_8191     = (1U << 18),
+	/** The ACK number cannot be transmitted with LSB(16, 16383) */
+	TCP_REQ_ACK_NOT_LSB_16_16383    = (1U << 19),
+	/** The ACK number cannot be transmitted with LSB(16, 32767) */
+	TCP_REQ_ACK_NOT_LSB_16_32767    = (1U << 20),
+	/** The ACK number cannot be transmitted with LSB(18, 65535) */
+	TCP_REQ_ACK_NOT_LSB_18_65535    = (1U << 21),
+	/** The scaled ACK number cannot be transmitted with LSB(4, 3) */
+	TCP_REQ_ACK_SCALED_NOT_LSB_4_3  = (1U << 22),
+	/** The innermost TTL/Hop Limit cannot be transmitted with LSB(3, 3) */
+	TCP_REQ_TTL_NOT_LSB_3_3         = (1U << 23),
+	/** The TCP window cannot be transmitted with LSB(15, 16383) */
+	TCP_REQ_WINDOW_NOT_LSB_15_16383 = (1U << 24),
+
+} tcp_pkt_req_t;
+
+/** All the requirements of one TCP packet */
+#define TCP_REQ_ALL  ((1U << 25) - 1)
+
+
+/** The capabilities of one compressed packet format of the TCP profile */
+struct tcp_pkt_fmt
+{
+	rohc_packet_t type;  /**< The type of compressed packet */
+	uint32_t conds;      /**< The requirements the packet shall have for the
+	                          format to be considered */
+	uint32_t caps;       /**< The requirements the format is able to fulfill */
+};
+
+
+/** The packet formats for sequential innermost IP-ID, ordered by preference */
+extern const struct tcp_pkt_fmt tcp_pkt_fmts_seq[];
+/** The number of packet formats for sequential innermost IP-ID */
+extern const size_t tcp_pkt_fmts_seq_nr;
+
+/** The packet formats for random or zero innermost IP-ID, ordered by preference */
+extern const struct tcp_pkt_fmt tcp_pkt_fmts_rnd[];
+/** The number of packet formats for random or zero innermost IP-ID */
+extern const size_t tcp_pkt_fmts_rnd_nr;
+
+
+rohc_packet_t tcp_pkt_fmt_select(const struct tcp_pkt_fmt *const fmts,
+                                 const size_t fmts_nr,
+                                 const uint32_t pkt_reqs)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+#endif /* ROHC_COMP_TCP_PKT_TYPES_H */
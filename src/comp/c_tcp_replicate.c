@@ -466,7 +466,7 @@ static int tcp_code_replicate_tcp_part(const struct rohc_comp_ctxt *const contex
                                        uint8_t *const rohc_data,
                                        const size_t rohc_max_len)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct sc_tcp_context *const tcp_context = ref_ctxt->specific;
 	const struct tcphdr *const tcp = (struct tcphdr *) uncomp_pkt_hdrs->tcp;
 
@@ -63,6 +63,9 @@ struct sc_udp_context
 static bool c_udp_create(struct rohc_comp_ctxt *const context,
                          const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void c_udp_account_mem(const struct rohc_comp_ctxt *const context,
+                              rohc_comp_profile_memory_usage_t *const usage)
+	__attribute__((nonnull(1, 2)));
 
 static rohc_packet_t c_udp_decide_FO_packet(const struct rohc_comp_ctxt *const context,
                                             const struct rfc3095_tmp_state *const changes)
@@ -163,6 +166,24 @@ quit:
 }
 
 
+/**
+ * @brief Add the memory used by the UDP context to the memory usage of
+ *        the profile
+ *
+ * This function is one of the functions that may exist in one profile for the
+ * framework to report the memory used by the profile.
+ *
+ * @param context  The compression context
+ * @param usage    IN/OUT: The memory usage of the profile
+ */
+static void c_udp_account_mem(const struct rohc_comp_ctxt *const context,
+                              rohc_comp_profile_memory_usage_t *const usage)
+{
+	rohc_comp_rfc3095_account_mem(context, usage);
+	usage->specific_mem += sizeof(struct sc_udp_context);
+}
+
+
 /**
  * @brief Update the compression context with the successfully compressed packet
  *
@@ -187,7 +208,7 @@ static void udp_update_context(struct rohc_comp_ctxt *const context,
 		{
 			udp_context->udp_checksum_trans_nr = 0;
 		}
-		if(udp_context->udp_checksum_trans_nr < context->compressor->oa_repetitions_nr)
+		if(udp_context->udp_checksum_trans_nr < context->oa_repetitions_nr)
 		{
 			udp_context->udp_checksum_trans_nr++;
 		}
@@ -387,7 +408,7 @@ static void udp_detect_udp_changes(const struct rohc_comp_ctxt *const context,
                                    const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                    struct rfc3095_tmp_state *const tmp)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	const struct sc_udp_context *const udp_ctxt =
@@ -430,5 +451,7 @@ const struct rohc_comp_profile c_udp_profile =
 	.destroy        = rohc_comp_rfc3095_destroy,
 	.encode         = rohc_comp_rfc3095_encode,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.set_oa_repetitions = rohc_comp_rfc3095_set_oa_repetitions,
+	.account_mem    = c_udp_account_mem,
 };
 
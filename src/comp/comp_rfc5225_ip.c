@@ -178,6 +178,12 @@ static bool rohc_comp_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 static void rohc_comp_rfc5225_ip_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
+static bool rohc_comp_rfc5225_ip_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                                    const uint8_t oa_repetitions_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_comp_rfc5225_ip_account_mem(const struct rohc_comp_ctxt *const context,
+                                             rohc_comp_profile_memory_usage_t *const usage)
+	__attribute__((nonnull(1, 2)));
 
 /* encode ROHCv2 IP-only packets */
 static int rohc_comp_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
@@ -456,7 +462,7 @@ static bool rohc_comp_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
 	rfc5225_ctxt->ip_contexts_nr = uncomp_pkt_hdrs->ip_hdrs_nr;
 
 	/* MSN */
-	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -466,7 +472,7 @@ static bool rohc_comp_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
 
 	/* innermost IP-ID offset */
 	is_ok = wlsb_new(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                 comp->oa_repetitions_nr);
+	                 context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -509,6 +515,60 @@ static void rohc_comp_rfc5225_ip_destroy(struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Change the number of Optimistic Approach repetitions of the
+ *        ROHCv2 IP-only context
+ *
+ * The W-LSB windows of the MSN and of the innermost IP-ID offset are resized
+ * to the new number of repetitions.
+ *
+ * @param context            The compression context
+ * @param oa_repetitions_nr  The new number of repetitions
+ * @return                   true if successful, false otherwise
+ */
+static bool rohc_comp_rfc5225_ip_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                                    const uint8_t oa_repetitions_nr)
+{
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	struct c_wlsb *const wlsbs[] = {
+		&rfc5225_ctxt->msn_wlsb,
+		&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
+	};
+
+	if(!wlsbs_set_width(wlsbs, sizeof(wlsbs) / sizeof(struct c_wlsb *),
+	                    oa_repetitions_nr))
+	{
+		rohc_comp_warn(context, "failed to resize the W-LSB windows");
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Add the memory used by the ROHCv2 IP-only context to the memory usage of
+ *        the profile
+ *
+ * This function is one of the functions that may exist in one profile for the
+ * framework to report the memory used by the profile.
+ *
+ * @param context  The compression context
+ * @param usage    IN/OUT: The memory usage of the profile
+ */
+static void rohc_comp_rfc5225_ip_account_mem(const struct rohc_comp_ctxt *const context,
+                                             rohc_comp_profile_memory_usage_t *const usage)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+
+	usage->specific_mem += sizeof(struct rohc_comp_rfc5225_ip_ctxt);
+	usage->ip_ctxts_mem += sizeof(rfc5225_ctxt->ip_contexts);
+
+	usage->wlsb_mem += wlsb_get_mem_size(&rfc5225_ctxt->msn_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&rfc5225_ctxt->innermost_ip_id_offset_wlsb);
+}
+
+
 /**
  * @brief Encode an uncompressed packet according to a pattern decided by
  *        several different factors
@@ -534,7 +594,7 @@ static int rohc_comp_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
                                        const size_t rohc_pkt_max_len,
                                        rohc_packet_t *const packet_type)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 
 	uint8_t *rohc_remain_data = rohc_pkt;
@@ -743,7 +803,7 @@ static void rohc_comp_rfc5225_ip_detect_changes(const struct rohc_comp_ctxt *con
                                                 const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                 struct comp_rfc5225_tmp_variables *const tmp)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
 	const ip_context_t *innermost_ip_ctxt = NULL;
 	size_t ip_hdr_pos;
@@ -3305,5 +3365,7 @@ const struct rohc_comp_profile rohc_comp_rfc5225_ip_profile =
 	.destroy        = rohc_comp_rfc5225_ip_destroy,
 	.encode         = rohc_comp_rfc5225_ip_encode,
 	.feedback       = rohc_comp_rfc5225_ip_feedback,
+	.set_oa_repetitions = rohc_comp_rfc5225_ip_set_oa_repetitions,
+	.account_mem    = rohc_comp_rfc5225_ip_account_mem,
 };
 
@@ -193,6 +193,12 @@ static bool rohc_comp_rfc5225_ip_udp_create(struct rohc_comp_ctxt *const context
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 static void rohc_comp_rfc5225_ip_udp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
+static bool rohc_comp_rfc5225_ip_udp_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                                        const uint8_t oa_repetitions_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_comp_rfc5225_ip_udp_account_mem(const struct rohc_comp_ctxt *const context,
+                                                 rohc_comp_profile_memory_usage_t *const usage)
+	__attribute__((nonnull(1, 2)));
 
 /* encode ROHCv2 IP/UDP packets */
 static int rohc_comp_rfc5225_ip_udp_encode(struct rohc_comp_ctxt *const context,
@@ -487,7 +493,7 @@ static bool rohc_comp_rfc5225_ip_udp_create(struct rohc_comp_ctxt *const context
 	rfc5225_ctxt->ip_contexts_nr = uncomp_pkt_hdrs->ip_hdrs_nr;
 
 	/* MSN */
-	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -497,7 +503,7 @@ static bool rohc_comp_rfc5225_ip_udp_create(struct rohc_comp_ctxt *const context
 
 	/* innermost IP-ID offset */
 	is_ok = wlsb_new(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                 comp->oa_repetitions_nr);
+	                 context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -544,6 +550,60 @@ static void rohc_comp_rfc5225_ip_udp_destroy(struct rohc_comp_ctxt *const contex
 }
 
 
+/**
+ * @brief Change the number of Optimistic Approach repetitions of the
+ *        ROHCv2 IP/UDP context
+ *
+ * The W-LSB windows of the MSN and of the innermost IP-ID offset are resized
+ * to the new number of repetitions.
+ *
+ * @param context            The compression context
+ * @param oa_repetitions_nr  The new number of repetitions
+ * @return                   true if successful, false otherwise
+ */
+static bool rohc_comp_rfc5225_ip_udp_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                                        const uint8_t oa_repetitions_nr)
+{
+	struct rohc_comp_rfc5225_ip_udp_ctxt *const rfc5225_ctxt = context->specific;
+	struct c_wlsb *const wlsbs[] = {
+		&rfc5225_ctxt->msn_wlsb,
+		&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
+	};
+
+	if(!wlsbs_set_width(wlsbs, sizeof(wlsbs) / sizeof(struct c_wlsb *),
+	                    oa_repetitions_nr))
+	{
+		rohc_comp_warn(context, "failed to resize the W-LSB windows");
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Add the memory used by the ROHCv2 IP/UDP context to the memory usage of
+ *        the profile
+ *
+ * This function is one of the functions that may exist in one profile for the
+ * framework to report the memory used by the profile.
+ *
+ * @param context  The compression context
+ * @param usage    IN/OUT: The memory usage of the profile
+ */
+static void rohc_comp_rfc5225_ip_udp_account_mem(const struct rohc_comp_ctxt *const context,
+                                                 rohc_comp_profile_memory_usage_t *const usage)
+{
+	const struct rohc_comp_rfc5225_ip_udp_ctxt *const rfc5225_ctxt = context->specific;
+
+	usage->specific_mem += sizeof(struct rohc_comp_rfc5225_ip_udp_ctxt);
+	usage->ip_ctxts_mem += sizeof(rfc5225_ctxt->ip_contexts);
+
+	usage->wlsb_mem += wlsb_get_mem_size(&rfc5225_ctxt->msn_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&rfc5225_ctxt->innermost_ip_id_offset_wlsb);
+}
+
+
 /**
  * @brief Encode an uncompressed packet according to a pattern decided by
  *        several different factors
@@ -569,7 +629,7 @@ static int rohc_comp_rfc5225_ip_udp_encode(struct rohc_comp_ctxt *const context,
                                            const size_t rohc_pkt_max_len,
                                            rohc_packet_t *const packet_type)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc5225_ip_udp_ctxt *const rfc5225_ctxt = context->specific;
 
 	uint8_t *rohc_remain_data = rohc_pkt;
@@ -788,7 +848,7 @@ static void rohc_comp_rfc5225_ip_udp_detect_changes(const struct rohc_comp_ctxt
                                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                     struct comp_rfc5225_tmp_variables *const tmp)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct rohc_comp_rfc5225_ip_udp_ctxt *const rfc5225_ctxt = context->specific;
 	const ip_context_t *innermost_ip_ctxt = NULL;
 	size_t ip_hdr_pos;
@@ -3464,5 +3524,7 @@ const struct rohc_comp_profile rohc_comp_rfc5225_ip_udp_profile =
 	.destroy        = rohc_comp_rfc5225_ip_udp_destroy,
 	.encode         = rohc_comp_rfc5225_ip_udp_encode,
 	.feedback       = rohc_comp_rfc5225_ip_udp_feedback,
+	.set_oa_repetitions = rohc_comp_rfc5225_ip_udp_set_oa_repetitions,
+	.account_mem    = rohc_comp_rfc5225_ip_udp_account_mem,
 };
 
@@ -196,6 +196,12 @@ static bool rohc_comp_rfc5225_ip_udp_rtp_create(struct rohc_comp_ctxt *const con
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 static void rohc_comp_rfc5225_ip_udp_rtp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
+static bool rohc_comp_rfc5225_ip_udp_rtp_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                                            const uint8_t oa_repetitions_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_comp_rfc5225_ip_udp_rtp_account_mem(const struct rohc_comp_ctxt *const context,
+                                                     rohc_comp_profile_memory_usage_t *const usage)
+	__attribute__((nonnull(1, 2)));
 
 /* encode ROHCv2 IP/UDP/RTP packets */
 static int rohc_comp_rfc5225_ip_udp_rtp_encode(struct rohc_comp_ctxt *const context,
@@ -462,7 +468,7 @@ static bool rohc_comp_rfc5225_ip_udp_rtp_create(struct rohc_comp_ctxt *const con
 	rfc5225_ctxt->ip_contexts_nr = uncomp_pkt_hdrs->ip_hdrs_nr;
 
 	/* MSN */
-	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, comp->oa_repetitions_nr);
+	is_ok = wlsb_new(&rfc5225_ctxt->msn_wlsb, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -472,7 +478,7 @@ static bool rohc_comp_rfc5225_ip_udp_rtp_create(struct rohc_comp_ctxt *const con
 
 	/* innermost IP-ID offset */
 	is_ok = wlsb_new(&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
-	                 comp->oa_repetitions_nr);
+	                 context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, context->profile->id,
@@ -522,6 +528,60 @@ static void rohc_comp_rfc5225_ip_udp_rtp_destroy(struct rohc_comp_ctxt *const co
 }
 
 
+/**
+ * @brief Change the number of Optimistic Approach repetitions of the
+ *        ROHCv2 IP/UDP/RTP context
+ *
+ * The W-LSB windows of the MSN and of the innermost IP-ID offset are resized
+ * to the new number of repetitions.
+ *
+ * @param context            The compression context
+ * @param oa_repetitions_nr  The new number of repetitions
+ * @return                   true if successful, false otherwise
+ */
+static bool rohc_comp_rfc5225_ip_udp_rtp_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                                            const uint8_t oa_repetitions_nr)
+{
+	struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = context->specific;
+	struct c_wlsb *const wlsbs[] = {
+		&rfc5225_ctxt->msn_wlsb,
+		&rfc5225_ctxt->innermost_ip_id_offset_wlsb,
+	};
+
+	if(!wlsbs_set_width(wlsbs, sizeof(wlsbs) / sizeof(struct c_wlsb *),
+	                    oa_repetitions_nr))
+	{
+		rohc_comp_warn(context, "failed to resize the W-LSB windows");
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Add the memory used by the ROHCv2 IP/UDP/RTP context to the memory usage of
+ *        the profile
+ *
+ * This function is one of the functions that may exist in one profile for the
+ * framework to report the memory used by the profile.
+ *
+ * @param context  The compression context
+ * @param usage    IN/OUT: The memory usage of the profile
+ */
+static void rohc_comp_rfc5225_ip_udp_rtp_account_mem(const struct rohc_comp_ctxt *const context,
+                                                     rohc_comp_profile_memory_usage_t *const usage)
+{
+	const struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = context->specific;
+
+	usage->specific_mem += sizeof(struct rohc_comp_rfc5225_ip_udp_rtp_ctxt);
+	usage->ip_ctxts_mem += sizeof(rfc5225_ctxt->ip_contexts);
+
+	usage->wlsb_mem += wlsb_get_mem_size(&rfc5225_ctxt->msn_wlsb);
+	usage->wlsb_mem += wlsb_get_mem_size(&rfc5225_ctxt->innermost_ip_id_offset_wlsb);
+}
+
+
 /**
  * @brief Encode an uncompressed packet according to a pattern decided by
  *        several different factors
@@ -548,7 +608,7 @@ static int rohc_comp_rfc5225_ip_udp_rtp_encode(struct rohc_comp_ctxt *const cont
                                                const size_t rohc_pkt_max_len,
                                                rohc_packet_t *const packet_type)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = context->specific;
 
 	uint8_t *rohc_remain_data = rohc_pkt;
@@ -767,7 +827,7 @@ static void rohc_comp_rfc5225_ip_udp_rtp_detect_changes(const struct rohc_comp_c
                                                         const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                                         struct comp_rfc5225_tmp_variables *const tmp)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = context->specific;
 	const ip_context_t *innermost_ip_ctxt = NULL;
 	size_t ip_hdr_pos;
@@ -1591,7 +1651,7 @@ static rohc_packet_t rohc_comp_rfc5225_ip_udp_rtp_decide_FO_SO_pkt(const struct
 {
 	const struct rohc_comp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt = ctxt->specific;
 	const int16_t msn_offset = tmp->msn_offset;
-	const uint8_t oa_repetitions_nr = ctxt->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = ctxt->oa_repetitions_nr;
 	const rohc_reordering_offset_t reorder_ratio = ctxt->compressor->reorder_ratio;
 	const ip_context_t *const innermost_ip_ctxt =
 		&(rfc5225_ctxt->ip_contexts[rfc5225_ctxt->ip_contexts_nr - 1]);
@@ -3118,5 +3178,7 @@ const struct rohc_comp_profile rohc_comp_rfc5225_ip_udp_rtp_profile =
 	.destroy        = rohc_comp_rfc5225_ip_udp_rtp_destroy,
 	.encode         = rohc_comp_rfc5225_ip_udp_rtp_encode,
 	.feedback       = rohc_comp_rfc5225_ip_udp_rtp_feedback,
+	.set_oa_repetitions = rohc_comp_rfc5225_ip_udp_rtp_set_oa_repetitions,
+	.account_mem    = rohc_comp_rfc5225_ip_udp_rtp_account_mem,
 };
 
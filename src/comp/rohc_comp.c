@@ -124,6 +124,15 @@ static const struct rohc_comp_profile *const
 };
 
 
+/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
+#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
+     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
+_Static_assert(((ROHC_PROFILE_ID_MAJOR_MAX + 1) * (ROHC_PROFILE_ID_MINOR_MAX + 1)) <=
+               ROHC_COMP_MEM_PROFILES_MAX,
+               "rohc_comp_memory_usage_t should be able to describe all profiles");
+#endif
+
 
 /*
  * Prototypes of private functions related to ROHC compression profiles
@@ -232,6 +241,20 @@ static void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const cont
                                                const struct rohc_ts pkt_time)
 	__attribute__((nonnull(1)));
 
+static void rohc_comp_periodic_draw_ir_jitter(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
+static void rohc_comp_periodic_draw_fo_jitter(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
+static uint32_t rohc_comp_periodic_draw_jitter(const struct rohc_comp *const comp,
+                                               const uint32_t max_jitter)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool rohc_comp_periodic_refresh_allowed(struct rohc_comp *const comp,
+                                               const struct rohc_ts pkt_time)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 
 /*
  * Prototypes of private functions related to ROHC feedback
@@ -242,6 +265,10 @@ static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
                                          const size_t size)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
+static void rohc_comp_adapt_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                           const bool is_nack)
+	__attribute__((nonnull(1)));
+
 static bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
                                          const uint8_t *const feedback,
                                          const size_t feedback_len,
@@ -399,6 +426,10 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 		goto destroy_comp;
 	}
 
+	/* the number of repetitions is not adapted by default */
+	comp->oa_repetitions_min = 0;
+	comp->oa_repetitions_max = 0;
+
 	/* set the default reordering ratio for W-LSB MSN in ROHCv2 profiles */
 	is_fine = rohc_comp_set_reorder_ratio(comp, reorder_ratio);
 	if(is_fine != true)
@@ -422,6 +453,13 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 		goto destroy_comp;
 	}
 
+	/* no jitter and no rate limit for periodic refreshes by default */
+	comp->periodic_refreshes_ir_jitter_pkts = 0;
+	comp->periodic_refreshes_fo_jitter_pkts = 0;
+	comp->periodic_refreshes_ir_jitter_time = 0;
+	comp->periodic_refreshes_fo_jitter_time = 0;
+	comp->periodic_refreshes_rate_max = 0;
+
 	/* create the MAX_CID + 1 contexts */
 	if(!c_create_contexts(comp))
 	{
@@ -1504,11 +1542,11 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 
 	/* increment the number of packets that were emitted in the current
 	 * compression state */
-	if(c->state_oa_repeat_nr < comp->oa_repetitions_nr)
+	if(c->state_oa_repeat_nr < c->oa_repetitions_nr)
 	{
 		c->state_oa_repeat_nr++;
 		rohc_comp_debug(c, "last change was transmitted %u/%u times",
-		                c->state_oa_repeat_nr, comp->oa_repetitions_nr);
+		                c->state_oa_repeat_nr, c->oa_repetitions_nr);
 	}
 
 	/* the payload starts after the header, skip it */
@@ -1624,6 +1662,13 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	c->header_uncompressed_size += pkt_hdrs.all_hdrs_len;
 	c->header_compressed_size += rohc_hdr_size;
 	c->num_sent_packets++;
+	c->oa_pkts_since_feedback++;
+	if(c->oa_pkts_since_feedback >= ROHC_OA_ADAPT_LOSS_HORIZON)
+	{
+		/* the decompressor sends a NACK when a packet fails, so no feedback
+		 * for many packets means that none of them was lost or damaged */
+		rohc_comp_adapt_oa_repetitions(c, false);
+	}
 
 	c->total_last_uncompressed_size = uncomp_packet.len;
 	c->total_last_compressed_size = rohc_packet->len;
@@ -2049,6 +2094,102 @@ bool rohc_comp_set_optimistic_approach(struct rohc_comp *const comp,
 }
 
 
+/**
+ * @brief Adapt the number of Optimistic Approach repetitions to losses
+ *
+ * The number of repetitions set by \ref rohc_comp_set_optimistic_approach
+ * is a trade-off: it wastes bytes on links without losses, and it is too
+ * small on links with many losses, so contexts get damaged and repaired.
+ *
+ * This function allows the library users to let the ROHC compressor adapt
+ * the number of repetitions of every context in O-mode within the given
+ * bounds. The compressor estimates the loss rate of every context from the
+ * arrival of feedback: a NACK or a STATIC-NACK increases it, an ACK or
+ * many packets without any feedback decrease it. The minimal number of repetitions is used when no loss is
+ * observed, the maximal number of repetitions is used when the estimated
+ * loss rate reaches 10%.
+ *
+ * The width of the W-LSB windows of the context is adapted along with the
+ * number of repetitions.
+ *
+ * The contexts start with the number of repetitions set by
+ * \ref rohc_comp_set_optimistic_approach. Contexts in U-mode or R-mode are
+ * not adapted.
+ *
+ * The adaptation is disabled by default. Set both bounds to 0 to disable it.
+ *
+ * The current number of repetitions of the context of the last compressed
+ * packet is given by \ref rohc_comp_get_last_packet_info2.
+ *
+ * @warning The value can not be modified after library initialization
+ *
+ * @param comp                The ROHC compressor to configure
+ * @param min_repetitions_nr  The minimal number of repetitions,
+ *                            0 to disable the adaptation
+ * @param max_repetitions_nr  The maximal number of repetitions,
+ *                            0 to disable the adaptation
+ * @return                    true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_optimistic_approach
+ * @see rohc_comp_get_last_packet_info2
+ */
+bool rohc_comp_set_optimistic_approach_adaptive(struct rohc_comp *const comp,
+                                                const size_t min_repetitions_nr,
+                                                const size_t max_repetitions_nr)
+{
+	/* we need a valid compressor */
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	/* both bounds shall be 0, or they shall be in both ranges
+	 * ]0;ROHC_WLSB_WIDTH_MAX] and ]0;UINT8_MAX] with min <= max */
+	if((min_repetitions_nr != 0 || max_repetitions_nr != 0) &&
+	   (min_repetitions_nr == 0 ||
+	    min_repetitions_nr > max_repetitions_nr ||
+	    max_repetitions_nr > ROHC_WLSB_WIDTH_MAX ||
+	    max_repetitions_nr > UINT8_MAX))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "set the bounds of the number of Optimistic Approach "
+		             "repetitions to [%zu;%zu]: bounds must be in range ]0;%u] "
+		             "or both 0", min_repetitions_nr, max_repetitions_nr,
+		             rohc_min(ROHC_WLSB_WIDTH_MAX, UINT8_MAX));
+		return false;
+	}
+
+	/* refuse to set a value if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		             "modify the bounds of the number of Optimistic Approach "
+		             "repetitions after initialization");
+		return false;
+	}
+
+	comp->oa_repetitions_min = min_repetitions_nr;
+	comp->oa_repetitions_max = max_repetitions_nr;
+
+	if(comp->oa_repetitions_max == 0)
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "adaptation of the number of Optimistic Approach repetitions "
+		          "disabled");
+	}
+	else
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "number of Optimistic Approach repetitions adapted in range "
+		          "[%u;%u]", comp->oa_repetitions_min, comp->oa_repetitions_max);
+	}
+
+	return true;
+}
+
+
 /**
  * @brief Set the window width for the W-LSB encoding scheme
  *
@@ -2251,6 +2392,207 @@ bool rohc_comp_set_periodic_refreshes_time(struct rohc_comp *const comp,
 }
 
 
+/**
+ * @brief Set the random jitters in packets for IR and FO periodic refreshes
+ *
+ * Contexts that are created at the same time reach their IR and FO timeouts
+ * at the same time, so all of them are refreshed at once. To spread the
+ * periodic refreshes over time, the timeouts of every context are shortened
+ * by a random number of packets, uniformly distributed between 0 and the
+ * given jitter. A new random number is drawn every time the context is
+ * refreshed.
+ *
+ * The random numbers are given by the callback for random numbers of the
+ * compressor. A jitter greater than or equal to its timeout is reduced to
+ * the timeout minus one.
+ *
+ * There is no jitter by default.
+ *
+ * @warning The values can not be modified after library initialization
+ *
+ * @param comp       The ROHC compressor
+ * @param ir_jitter  The maximal number of packets the IR timeout of every
+ *                   context is shortened by, 0 for no jitter
+ * @param fo_jitter  The maximal number of packets the FO timeout of every
+ *                   context is shortened by, 0 for no jitter
+ * @return           true in case of success, false in case of failure
+ *
+ * @see rohc_comp_set_periodic_refreshes
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_periodic_refreshes_jitter(struct rohc_comp *const comp,
+                                             const size_t ir_jitter,
+                                             const size_t fo_jitter)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	/* refuse to set values if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to modify the jitters for periodic refreshes "
+		             "after initialization");
+		return false;
+	}
+
+	comp->periodic_refreshes_ir_jitter_pkts = ir_jitter;
+	comp->periodic_refreshes_fo_jitter_pkts = fo_jitter;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR jitter for "
+	          "context periodic refreshes set to %zu packets", ir_jitter);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO jitter for "
+	          "context periodic refreshes set to %zu packets", fo_jitter);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the random jitters in ms for IR and FO periodic refreshes
+ *
+ * Same as \ref rohc_comp_set_periodic_refreshes_jitter for the timeouts
+ * in milliseconds: the timeouts of every context are shortened by a random
+ * delay, uniformly distributed between 0 and the given jitter.
+ *
+ * There is no jitter by default.
+ *
+ * @warning The values can not be modified after library initialization
+ *
+ * @param comp       The ROHC compressor
+ * @param ir_jitter  The maximal delay (in ms) the IR timeout of every
+ *                   context is shortened by, 0 for no jitter
+ * @param fo_jitter  The maximal delay (in ms) the FO timeout of every
+ *                   context is shortened by, 0 for no jitter
+ * @return           true in case of success, false in case of failure
+ *
+ * @see rohc_comp_set_periodic_refreshes_time
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_periodic_refreshes_jitter_time(struct rohc_comp *const comp,
+                                                  const uint64_t ir_jitter,
+                                                  const uint64_t fo_jitter)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if(ir_jitter >= UINT32_MAX || fo_jitter >= UINT32_MAX)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid jitters for context periodic refreshes "
+		             "(IR jitter = %" PRIu64 " ms, FO jitter = %" PRIu64 " ms)",
+		             ir_jitter, fo_jitter);
+		return false;
+	}
+
+	/* refuse to set values if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to modify the jitters for periodic refreshes "
+		             "after initialization");
+		return false;
+	}
+
+	comp->periodic_refreshes_ir_jitter_time = ir_jitter;
+	comp->periodic_refreshes_fo_jitter_time = fo_jitter;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR jitter for "
+	          "context periodic refreshes set to %" PRIu64 " ms", ir_jitter);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO jitter for "
+	          "context periodic refreshes set to %" PRIu64 " ms", fo_jitter);
+
+	return true;
+}
+
+
+/**
+ * @brief Limit the rate of periodic refreshes for all contexts
+ *
+ * Limit the number of periodic IR and FO refreshes that all the contexts of
+ * the compressor may start within the given period of time. The limit is
+ * enforced by a token bucket that holds up to \e max_refreshes tokens and
+ * that is refilled continuously at the rate of \e max_refreshes tokens per
+ * \e period. Every periodic refresh consumes one token. When no token is
+ * available, the context postpones its refresh to one of the next packets.
+ *
+ * The time is given by the arrival times of the uncompressed packets, see
+ * \ref rohc_compress4. If the arrival times do not advance, eg. if they are
+ * always zero, the token bucket is refilled completely once every FO
+ * timeout (in packets, see \ref rohc_comp_set_periodic_refreshes) counted
+ * over the packets of all the contexts, so the periodic refreshes are
+ * rate-limited but never stopped.
+ *
+ * There is no limit by default.
+ *
+ * @warning The values can not be modified after library initialization
+ *
+ * @param comp           The ROHC compressor
+ * @param max_refreshes  The maximal number of periodic refreshes per period,
+ *                       0 for no limit
+ * @param period         The period of time (in ms), in range
+ *                       [1, 3600000] if \e max_refreshes is not 0
+ * @return               true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_periodic_refreshes_rate(struct rohc_comp *const comp,
+                                           const size_t max_refreshes,
+                                           const uint64_t period)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if(max_refreshes > UINT32_MAX ||
+	   (max_refreshes > 0 &&
+	    (period == 0 || period > ROHC_COMP_REFRESHES_RATE_PERIOD_MAX)))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "invalid rate for context periodic refreshes (%zu refreshes "
+		             "per %" PRIu64 " ms)", max_refreshes, period);
+		return false;
+	}
+
+	/* refuse to set values if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to modify the rate of periodic refreshes after "
+		             "initialization");
+		return false;
+	}
+
+	/* the token bucket is full at the beginning */
+	comp->periodic_refreshes_rate_max = max_refreshes;
+	comp->periodic_refreshes_rate_period = period * 1000U;
+	comp->periodic_refreshes_tokens =
+		comp->periodic_refreshes_rate_max * comp->periodic_refreshes_rate_period;
+	comp->periodic_refreshes_tokens_time.sec = 0;
+	comp->periodic_refreshes_tokens_time.nsec = 0;
+	comp->periodic_refreshes_tokens_pkts = 0;
+
+	if(max_refreshes == 0)
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "no limit for "
+		          "the rate of context periodic refreshes");
+	}
+	else
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "rate of "
+		          "context periodic refreshes limited to %zu refreshes per "
+		          "%" PRIu64 " ms", max_refreshes, period);
+	}
+
+	return true;
+}
+
+
 /**
  * @brief Set the number of uncompressed transmissions for list compression
  *
@@ -3056,6 +3398,12 @@ static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
 		goto error;
 	}
 
+	/* adapt the number of repetitions of the context to the losses observed
+	 * by the decompressor: FEEDBACK-1 is always an ACK, the type of the
+	 * FEEDBACK-2 is given by its first 2 bits in all profiles */
+	rohc_comp_adapt_oa_repetitions(context, (feedback_type == ROHC_FEEDBACK_2 &&
+	                                         (remain_data[0] >> 6) != ROHC_FEEDBACK_ACK));
+
 	/* everything went fine */
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 	           "FEEDBACK-%d data successfully handled", feedback_type);
@@ -3067,6 +3415,87 @@ error:
 }
 
 
+/**
+ * @brief Adapt the number of Optimistic Approach repetitions of one context
+ *
+ * The loss rate of the context is estimated from the feedback received by
+ * the compressor: one feedback reports on all the packets sent since the
+ * previous feedback, so a NACK means that one of them at least was lost or
+ * damaged, and an ACK means that none was. The estimation is the ratio of
+ * the losses over the packets reported by the feedbacks: a NACK received
+ * after few packets thus counts more than a NACK received after many
+ * packets, whatever the number of feedbacks in between. Once more than
+ * \ref ROHC_OA_ADAPT_LOSS_HORIZON packets were reported, the counts of
+ * losses and packets are halved, so that old losses are forgotten.
+ *
+ * O-mode decompressors send ACKs seldom, but they send a NACK as soon as a
+ * packet fails: \ref ROHC_OA_ADAPT_LOSS_HORIZON packets without feedback
+ * are thus reported as one ACK.
+ *
+ * The number of repetitions grows linearly from its minimum for no loss
+ * to its maximum for \ref ROHC_OA_ADAPT_LOSS_RATE_MAX.
+ *
+ * @param context  The compression context the feedback was received for
+ * @param is_nack  Whether the feedback is a NACK or STATIC-NACK
+ */
+static void rohc_comp_adapt_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                           const bool is_nack)
+{
+	const struct rohc_comp *const comp = context->compressor;
+	const uint32_t pkts_nr =
+		rohc_min(rohc_max(context->oa_pkts_since_feedback, 1U),
+		         ROHC_OA_ADAPT_LOSS_HORIZON);
+	uint32_t loss_rate;
+	uint32_t oa_repetitions_nr;
+
+	context->oa_pkts_since_feedback = 0;
+
+	if(comp->oa_repetitions_max == 0 || context->mode != ROHC_O_MODE)
+	{
+		return;
+	}
+
+	/* update the estimated loss rate: one loss at least among the packets
+	 * reported by a NACK, no loss among the packets reported by an ACK */
+	context->oa_sent_pkts += pkts_nr;
+	if(is_nack)
+	{
+		context->oa_lost_pkts += 0x10000U;
+	}
+	while(context->oa_sent_pkts > ROHC_OA_ADAPT_LOSS_HORIZON)
+	{
+		context->oa_sent_pkts /= 2;
+		context->oa_lost_pkts /= 2;
+	}
+	loss_rate = context->oa_lost_pkts / context->oa_sent_pkts;
+
+	/* compute the number of repetitions for the estimated loss rate */
+	loss_rate = rohc_min(loss_rate, ROHC_OA_ADAPT_LOSS_RATE_MAX);
+	oa_repetitions_nr = comp->oa_repetitions_min +
+		((comp->oa_repetitions_max - comp->oa_repetitions_min) * loss_rate +
+		 ROHC_OA_ADAPT_LOSS_RATE_MAX / 2) / ROHC_OA_ADAPT_LOSS_RATE_MAX;
+	if(oa_repetitions_nr == context->oa_repetitions_nr)
+	{
+		return;
+	}
+
+	/* resize the W-LSB windows of the context */
+	if(context->profile->set_oa_repetitions != NULL &&
+	   !context->profile->set_oa_repetitions(context, oa_repetitions_nr))
+	{
+		rohc_comp_warn(context, "failed to change the number of Optimistic "
+		               "Approach repetitions from %u to %u",
+		               context->oa_repetitions_nr, oa_repetitions_nr);
+		return;
+	}
+
+	rohc_comp_debug(context, "estimated loss rate %u/65536: number of Optimistic "
+	                "Approach repetitions changed from %u to %u",
+	                loss_rate, context->oa_repetitions_nr, oa_repetitions_nr);
+	context->oa_repetitions_nr = oa_repetitions_nr;
+}
+
+
 /**
  * @brief Deliver a feedback packet to the compressor
  *
@@ -3176,6 +3605,7 @@ error:
  * \ref rohc_comp_last_packet_info2_t structure with the \e version_major and
  * \e version_minor fields set to one of the following supported versions:
  *  - Major 0, minor 0
+ *  - Major 0, minor 1
  *
  * See the \ref rohc_comp_last_packet_info2_t structure for details about
  * fields that are supported in the above versions.
@@ -3227,7 +3657,11 @@ bool rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
 		info->header_last_comp_size = comp->last_context->header_last_compressed_size;
 
 		/* new fields added by minor versions */
-		if(info->version_minor > 0)
+		if(info->version_minor >= 1)
+		{
+			info->oa_repetitions_nr = comp->last_context->oa_repetitions_nr;
+		}
+		if(info->version_minor > 1)
 		{
 			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			           "unsupported minor version (%u) of the structure for "
@@ -3319,6 +3753,144 @@ error:
 }
 
 
+/**
+ * @brief Get the memory used by the compressor
+ *
+ * Get the memory allocated by the compressor, broken down per subsystem and
+ * per profile. The memory used by every profile is broken down in the memory
+ * used by the profile-specific parts of its contexts, the contexts of the IP
+ * headers, list compression, and the W-LSB windows.
+ *
+ * All the enabled profiles are described, in the order of their profile IDs,
+ * even if they have no context yet.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_memory_usage_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_comp_memory_usage_t structure for details about fields
+ * that are supported in the above versions.
+ *
+ * @param comp           The ROHC compressor to get memory usage from
+ * @param[in,out] usage  The structure where memory usage will be stored
+ * @return               true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_memory_usage_t
+ */
+bool rohc_comp_get_memory_usage(const struct rohc_comp *const comp,
+                                rohc_comp_memory_usage_t *const usage)
+{
+	size_t profiles_idx[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
+	size_t profile_major;
+	size_t profile_minor;
+	size_t cid;
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(usage == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for memory usage is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(usage->version_major != 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "memory usage", usage->version_major);
+		goto error;
+	}
+	if(usage->version_minor > 0)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported minor version (%u) of the structure for "
+		           "memory usage", usage->version_minor);
+		goto error;
+	}
+
+	/* the subsystems common to all profiles */
+	usage->comp_mem = sizeof(struct rohc_comp);
+	usage->contexts_mem = (comp->medium.max_cid + 1) * sizeof(struct rohc_comp_ctxt);
+	usage->rru_mem = (comp->rru != NULL ? comp->mrru : 0);
+
+	/* one entry for every enabled profile */
+	usage->profiles_nr = 0;
+	for(profile_major = 0; profile_major <= ROHC_PROFILE_ID_MAJOR_MAX; profile_major++)
+	{
+		for(profile_minor = 0; profile_minor <= ROHC_PROFILE_ID_MINOR_MAX; profile_minor++)
+		{
+			const struct rohc_comp_profile *const profile =
+				rohc_comp_profiles[profile_major][profile_minor];
+
+			if(profile == NULL || !comp->enabled_profiles[profile_major][profile_minor])
+			{
+				profiles_idx[profile_major][profile_minor] = ROHC_COMP_MEM_PROFILES_MAX;
+				continue;
+			}
+			profiles_idx[profile_major][profile_minor] = usage->profiles_nr;
+			memset(&usage->profiles[usage->profiles_nr], 0,
+			       sizeof(rohc_comp_profile_memory_usage_t));
+			usage->profiles[usage->profiles_nr].profile = profile->id;
+			usage->profiles_nr++;
+		}
+	}
+
+	/* account the memory used by the profile-specific parts of the contexts */
+	for(cid = 0; cid <= comp->medium.max_cid; cid++)
+	{
+		const struct rohc_comp_ctxt *const ctxt = &(comp->contexts[cid]);
+		rohc_comp_profile_memory_usage_t *profile_usage;
+		size_t *profile_idx;
+
+		if(!ctxt->used)
+		{
+			continue;
+		}
+
+		/* the profile of the context might have been disabled since the
+		 * context was created */
+		profile_idx = &profiles_idx[(ctxt->profile->id >> 8) & 0xff][ctxt->profile->id & 0xff];
+		if((*profile_idx) == ROHC_COMP_MEM_PROFILES_MAX)
+		{
+			(*profile_idx) = usage->profiles_nr;
+			memset(&usage->profiles[usage->profiles_nr], 0,
+			       sizeof(rohc_comp_profile_memory_usage_t));
+			usage->profiles[usage->profiles_nr].profile = ctxt->profile->id;
+			usage->profiles_nr++;
+		}
+		profile_usage = &usage->profiles[*profile_idx];
+
+		profile_usage->contexts_nr++;
+		if(ctxt->profile->account_mem != NULL)
+		{
+			ctxt->profile->account_mem(ctxt, profile_usage);
+		}
+	}
+
+	/* sum all subsystems */
+	usage->total_mem = usage->comp_mem + usage->contexts_mem + usage->rru_mem;
+	for(i = 0; i < usage->profiles_nr; i++)
+	{
+		usage->total_mem += usage->profiles[i].specific_mem;
+		usage->total_mem += usage->profiles[i].wlsb_mem;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Give a description for the given ROHC compression context state
  *
@@ -3468,7 +4040,15 @@ static struct rohc_comp_ctxt *
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "create context with CID %u without replication", cid_to_use);
 		c->state = ROHC_COMP_STATE_IR;
+
+		/* the W-LSB windows of a replicated context are copied from the base
+		 * context, so the replicated context keeps the number of repetitions
+		 * of its base context */
+		c->oa_repetitions_nr = comp->oa_repetitions_nr;
 	}
+	c->oa_lost_pkts = 0;
+	c->oa_sent_pkts = 0;
+	c->oa_pkts_since_feedback = 0;
 
 	memcpy(&c->fingerprint, fingerprint, sizeof(struct rohc_fingerprint));
 
@@ -3497,6 +4077,10 @@ static struct rohc_comp_ctxt *
 
 	c->compressor = comp;
 
+	/* spread the periodic refreshes of the contexts over time */
+	rohc_comp_periodic_draw_fo_jitter(c);
+	rohc_comp_periodic_draw_ir_jitter(c);
+
 	/* create profile-specific context */
 	if(c->state == ROHC_COMP_STATE_CR)
 	{
@@ -3754,7 +4338,7 @@ static struct rohc_comp_ctxt *
 		if(context != NULL &&
 		   profile->id == ROHCv1_PROFILE_IP_TCP && /* TODO: replace TCP by CR capacity */
 		   context->state == ROHC_COMP_STATE_CR &&
-		   context->state_oa_repeat_nr < comp->oa_repetitions_nr)
+		   context->state_oa_repeat_nr < context->oa_repetitions_nr)
 		{
 			/* Context Replication is in action, so check whether the base context
 			 * changed too much to be re-used or not */
@@ -3765,7 +4349,7 @@ static struct rohc_comp_ctxt *
 			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			           "Context Replication in action (%u/%u packets sent): check "
 			           "for CID %u whether base context with CID %u changed too much",
-			           context->state_oa_repeat_nr, comp->oa_repetitions_nr,
+			           context->state_oa_repeat_nr, context->oa_repetitions_nr,
 			           context->cid, base_ctxt->cid);
 
 			/* there are two ways the base context may have changed:
@@ -4049,7 +4633,7 @@ void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
 static void rohc_comp_decide_state(struct rohc_comp_ctxt *const context,
                                    struct rohc_ts pkt_time)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	const rohc_comp_state_t curr_state = context->state;
 	rohc_comp_state_t next_state;
 
@@ -4091,65 +4675,94 @@ static void rohc_comp_decide_state(struct rohc_comp_ctxt *const context,
  * @brief Periodically change the context state after a certain number
  *        of packets.
  *
+ * The timeouts of the context are shortened by the random jitters of the
+ * context. The refresh is postponed if the rate of periodic refreshes is
+ * limited and no token is available.
+ *
  * @param context   The compression context
  * @param pkt_time  The time of packet arrival
  */
 static void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const context,
                                                const struct rohc_ts pkt_time)
 {
+	struct rohc_comp *const comp = context->compressor;
+	const size_t ir_timeout_pkts =
+		comp->periodic_refreshes_ir_timeout_pkts - context->go_back_ir_jitter_pkts;
+	const size_t fo_timeout_pkts =
+		comp->periodic_refreshes_fo_timeout_pkts - context->go_back_fo_jitter_pkts;
+	const uint64_t ir_timeout_time =
+		comp->periodic_refreshes_ir_timeout_time * 1000U - context->go_back_ir_jitter_time;
+	const uint64_t fo_timeout_time =
+		comp->periodic_refreshes_fo_timeout_time * 1000U - context->go_back_fo_jitter_time;
+	rohc_comp_state_t refresh_state;
 	rohc_comp_state_t next_state;
 
-	rohc_debug(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+	rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id,
 	           "CID %u: timeouts for periodic refreshes: FO = %zu / %zu, "
 	           "IR = %zu / %zu", context->cid, context->go_back_fo_count,
-	           context->compressor->periodic_refreshes_fo_timeout_pkts,
-	           context->go_back_ir_count,
-	           context->compressor->periodic_refreshes_ir_timeout_pkts);
+	           fo_timeout_pkts, context->go_back_ir_count, ir_timeout_pkts);
 
-	if(context->go_back_ir_count >=
-	   context->compressor->periodic_refreshes_ir_timeout_pkts)
+	if(context->go_back_ir_count >= ir_timeout_pkts)
 	{
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %u: periodic change to IR state", context->cid);
-		context->go_back_ir_count = 0;
-		next_state = ROHC_COMP_STATE_IR;
+		refresh_state = ROHC_COMP_STATE_IR;
 	}
-	else if((context->compressor->features & ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) != 0 &&
-	        rohc_time_interval(context->go_back_ir_time, pkt_time) >=
-	        context->compressor->periodic_refreshes_ir_timeout_time * 1000U)
+	else if((comp->features & ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) != 0 &&
+	        rohc_time_interval(context->go_back_ir_time, pkt_time) >= ir_timeout_time)
 	{
 		const uint64_t interval_since_ir_refresh =
 			rohc_time_interval(context->go_back_ir_time, pkt_time);
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %u: force IR refresh since %" PRIu64 " us elapsed since "
 		          "last IR packet", context->cid, interval_since_ir_refresh);
-		context->go_back_ir_count = 0;
-		next_state = ROHC_COMP_STATE_IR;
+		refresh_state = ROHC_COMP_STATE_IR;
 	}
-	else if(context->go_back_fo_count >=
-	        context->compressor->periodic_refreshes_fo_timeout_pkts)
+	else if(context->go_back_fo_count >= fo_timeout_pkts)
 	{
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %u: periodic change to FO state", context->cid);
-		context->go_back_fo_count = 0;
-		next_state = ROHC_COMP_STATE_FO;
+		refresh_state = ROHC_COMP_STATE_FO;
 	}
-	else if((context->compressor->features & ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) != 0 &&
-	        rohc_time_interval(context->go_back_fo_time, pkt_time) >=
-	        context->compressor->periodic_refreshes_fo_timeout_time * 1000U)
+	else if((comp->features & ROHC_COMP_FEATURE_TIME_BASED_REFRESHES) != 0 &&
+	        rohc_time_interval(context->go_back_fo_time, pkt_time) >= fo_timeout_time)
 	{
 		const uint64_t interval_since_fo_refresh =
 			rohc_time_interval(context->go_back_fo_time, pkt_time);
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %u: force FO refresh since %" PRIu64 " us elapsed since "
 		          "last FO packet", context->cid, interval_since_fo_refresh);
-		context->go_back_fo_count = 0;
-		next_state = ROHC_COMP_STATE_FO;
+		refresh_state = ROHC_COMP_STATE_FO;
 	}
 	else
+	{
+		refresh_state = ROHC_COMP_STATE_UNKNOWN;
+	}
+
+	/* limit the rate of periodic refreshes for all contexts */
+	if(refresh_state == ROHC_COMP_STATE_UNKNOWN)
 	{
 		next_state = context->state;
 	}
+	else if(!rohc_comp_periodic_refresh_allowed(comp, pkt_time))
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
+		          "CID %u: too many periodic refreshes, postpone refresh",
+		          context->cid);
+		next_state = context->state;
+	}
+	else if(refresh_state == ROHC_COMP_STATE_IR)
+	{
+		context->go_back_ir_count = 0;
+		rohc_comp_periodic_draw_ir_jitter(context);
+		next_state = ROHC_COMP_STATE_IR;
+	}
+	else /* ROHC_COMP_STATE_FO */
+	{
+		context->go_back_fo_count = 0;
+		rohc_comp_periodic_draw_fo_jitter(context);
+		next_state = ROHC_COMP_STATE_FO;
+	}
 
 	rohc_comp_change_state(context, next_state);
 
@@ -4171,6 +4784,154 @@ static void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const cont
 }
 
 
+/**
+ * @brief Draw the random jitters of the IR timeouts of the given context
+ *
+ * @param context  The compression context
+ */
+static void rohc_comp_periodic_draw_ir_jitter(struct rohc_comp_ctxt *const context)
+{
+	const struct rohc_comp *const comp = context->compressor;
+	const size_t max_jitter_pkts =
+		rohc_min(comp->periodic_refreshes_ir_jitter_pkts,
+		         comp->periodic_refreshes_ir_timeout_pkts - 1);
+	const uint64_t max_jitter_time =
+		rohc_min(comp->periodic_refreshes_ir_jitter_time,
+		         comp->periodic_refreshes_ir_timeout_time - 1);
+
+	context->go_back_ir_jitter_pkts =
+		rohc_comp_periodic_draw_jitter(comp, (uint32_t) rohc_min(max_jitter_pkts, UINT32_MAX));
+	context->go_back_ir_jitter_time =
+		((uint64_t) rohc_comp_periodic_draw_jitter(comp, (uint32_t) max_jitter_time)) * 1000U;
+}
+
+
+/**
+ * @brief Draw the random jitters of the FO timeouts of the given context
+ *
+ * @param context  The compression context
+ */
+static void rohc_comp_periodic_draw_fo_jitter(struct rohc_comp_ctxt *const context)
+{
+	const struct rohc_comp *const comp = context->compressor;
+	const size_t max_jitter_pkts =
+		rohc_min(comp->periodic_refreshes_fo_jitter_pkts,
+		         comp->periodic_refreshes_fo_timeout_pkts - 1);
+	const uint64_t max_jitter_time =
+		rohc_min(comp->periodic_refreshes_fo_jitter_time,
+		         comp->periodic_refreshes_fo_timeout_time - 1);
+
+	context->go_back_fo_jitter_pkts =
+		rohc_comp_periodic_draw_jitter(comp, (uint32_t) rohc_min(max_jitter_pkts, UINT32_MAX));
+	context->go_back_fo_jitter_time =
+		((uint64_t) rohc_comp_periodic_draw_jitter(comp, (uint32_t) max_jitter_time)) * 1000U;
+}
+
+
+/**
+ * @brief Draw one random jitter uniformly distributed in [0, max_jitter]
+ *
+ * The callback for random numbers is not called if there is no jitter, so
+ * that the sequence of random numbers is not modified.
+ *
+ * @param comp        The ROHC compressor
+ * @param max_jitter  The maximal jitter
+ * @return            The random jitter
+ */
+static uint32_t rohc_comp_periodic_draw_jitter(const struct rohc_comp *const comp,
+                                               const uint32_t max_jitter)
+{
+	uint32_t jitter;
+
+	if(max_jitter == 0)
+	{
+		jitter = 0;
+	}
+	else
+	{
+		const uint32_t rand_val = comp->random_cb(comp, comp->random_cb_ctxt);
+
+		if(max_jitter == UINT32_MAX)
+		{
+			jitter = rand_val;
+		}
+		else
+		{
+			jitter = rand_val % (max_jitter + 1);
+		}
+	}
+
+	return jitter;
+}
+
+
+/**
+ * @brief Whether one more periodic refresh is allowed or not
+ *
+ * Refill the token bucket that limits the rate of periodic refreshes with
+ * the time elapsed since the previous refresh attempt, then consume one
+ * token if available. If the arrival times do not advance, refill the
+ * bucket completely once every FO timeout (in packets) instead, otherwise
+ * zero or constant arrival times would stop the periodic refreshes forever.
+ *
+ * @param comp      The ROHC compressor
+ * @param pkt_time  The time of packet arrival
+ * @return          true if the periodic refresh is allowed,
+ *                  false if it shall be postponed
+ */
+static bool rohc_comp_periodic_refresh_allowed(struct rohc_comp *const comp,
+                                               const struct rohc_ts pkt_time)
+{
+	const uint64_t tokens_max =
+		comp->periodic_refreshes_rate_max * comp->periodic_refreshes_rate_period;
+	const struct rohc_ts last_time = comp->periodic_refreshes_tokens_time;
+
+	/* no limit */
+	if(comp->periodic_refreshes_rate_max == 0)
+	{
+		return true;
+	}
+
+	/* refill the bucket with the time elapsed since last update, ignore the
+	 * packets that arrived before the last update */
+	if(pkt_time.sec > last_time.sec ||
+	   (pkt_time.sec == last_time.sec && pkt_time.nsec > last_time.nsec))
+	{
+		const uint64_t elapsed = rohc_time_interval(last_time, pkt_time);
+
+		if(elapsed >= comp->periodic_refreshes_rate_period)
+		{
+			comp->periodic_refreshes_tokens = tokens_max;
+		}
+		else
+		{
+			comp->periodic_refreshes_tokens =
+				rohc_min(comp->periodic_refreshes_tokens +
+				         elapsed * comp->periodic_refreshes_rate_max, tokens_max);
+		}
+		comp->periodic_refreshes_tokens_time = pkt_time;
+		comp->periodic_refreshes_tokens_pkts = comp->num_packets;
+	}
+	else if((size_t) (comp->num_packets - comp->periodic_refreshes_tokens_pkts) >=
+	        comp->periodic_refreshes_fo_timeout_pkts)
+	{
+		/* the arrival times do not advance: refill the bucket with the
+		 * packets compressed since last update */
+		comp->periodic_refreshes_tokens = tokens_max;
+		comp->periodic_refreshes_tokens_pkts = comp->num_packets;
+	}
+
+	/* one periodic refresh consumes one token */
+	if(comp->periodic_refreshes_tokens < comp->periodic_refreshes_rate_period)
+	{
+		return false;
+	}
+	comp->periodic_refreshes_tokens -= comp->periodic_refreshes_rate_period;
+
+	return true;
+}
+
+
 /**
  * @brief Re-initialize the given context
  *
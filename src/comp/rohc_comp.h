@@ -126,6 +126,7 @@ typedef enum
  *    is_context_init, context_mode, context_state, context_used, profile_id,
  *    packet_type, total_last_uncomp_size, header_last_uncomp_size,
  *    total_last_comp_size, and header_last_comp_size
+ *  - Major 0 / Minor 1 adds: oa_repetitions_nr
  *
  * @ingroup rohc_comp
  *
@@ -159,6 +160,9 @@ typedef struct
 	unsigned long total_last_comp_size;
 	/** The compressed size (in bytes) of the last compressed header */
 	unsigned long header_last_comp_size;
+	/** The number of Optimistic Approach repetitions of the last context used
+	 *  by the compressor (since minor version 1) */
+	unsigned int oa_repetitions_nr;
 } __attribute__((packed)) rohc_comp_last_packet_info2_t;
 
 
@@ -212,6 +216,81 @@ typedef struct
 } __attribute__((packed)) rohc_comp_general_info_t;
 
 
+/** The maximum number of profiles described by \ref rohc_comp_memory_usage_t */
+#define ROHC_COMP_MEM_PROFILES_MAX  18U
+
+
+/**
+ * @brief The memory used by the contexts of one compression profile
+ *
+ * The memory used by the profile-specific parts of the contexts is broken down
+ * in its main parts: the contexts of the IP headers, and the contexts of the
+ * list compression (IPv6 extension headers, TCP options). The W-LSB windows
+ * are allocated apart from the profile-specific parts of the contexts, their
+ * width depends on the number of Optimistic Approach repetitions of every
+ * context.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_memory_usage_t
+ */
+typedef struct
+{
+	/** The profile the contexts are associated with */
+	rohc_profile_t profile;
+	/** The number of contexts associated with the profile */
+	size_t contexts_nr;
+	/** The memory (in bytes) used by the profile-specific parts of the
+	 *  contexts, W-LSB windows excluded */
+	size_t specific_mem;
+	/** The part of \e specific_mem used by the contexts of the IP headers */
+	size_t ip_ctxts_mem;
+	/** The part of \e specific_mem used by list compression */
+	size_t lists_mem;
+	/** The memory (in bytes) used by the W-LSB windows of the contexts */
+	size_t wlsb_mem;
+} __attribute__((packed)) rohc_comp_profile_memory_usage_t;
+
+
+/**
+ * @brief The memory used by the compressor
+ *
+ * The structure is used by the \ref rohc_comp_get_memory_usage function
+ * to report the memory allocated by the compressor, per subsystem and per
+ * profile.
+ *
+ * Versioning works as for \ref rohc_comp_general_info_t.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor,
+ *    total_mem, comp_mem, contexts_mem, rru_mem, profiles_nr, and profiles.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_memory_usage
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The memory (in bytes) used by the compressor, all subsystems included */
+	size_t total_mem;
+	/** The memory (in bytes) used by the compressor object itself */
+	size_t comp_mem;
+	/** The memory (in bytes) used by the generic parts of the contexts, they
+	 *  are allocated for MAX_CID + 1 contexts when the compressor is created */
+	size_t contexts_mem;
+	/** The memory (in bytes) used by the buffer for segmentation (MRRU) */
+	size_t rru_mem;
+	/** The number of profiles described in \e profiles */
+	size_t profiles_nr;
+	/** The memory used by the contexts of every enabled profile */
+	rohc_comp_profile_memory_usage_t profiles[ROHC_COMP_MEM_PROFILES_MAX];
+} __attribute__((packed)) rohc_comp_memory_usage_t;
+
+
 /**
  * @brief The different features of the ROHC compressor
  *
@@ -386,6 +465,11 @@ bool ROHC_EXPORT rohc_comp_set_optimistic_approach(struct rohc_comp *const comp,
                                                    const size_t repetitions_nr)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_optimistic_approach_adaptive(struct rohc_comp *const comp,
+                                                            const size_t min_repetitions_nr,
+                                                            const size_t max_repetitions_nr)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_wlsb_window_width(struct rohc_comp *const comp,
                                                  const size_t width)
 	__attribute__((warn_unused_result))
@@ -405,6 +489,21 @@ bool ROHC_EXPORT rohc_comp_set_periodic_refreshes_time(struct rohc_comp *const c
                                                        const uint64_t fo_timeout)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_periodic_refreshes_jitter(struct rohc_comp *const comp,
+                                                         const size_t ir_jitter,
+                                                         const size_t fo_jitter)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_periodic_refreshes_jitter_time(struct rohc_comp *const comp,
+                                                              const uint64_t ir_jitter,
+                                                              const uint64_t fo_jitter)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_periodic_refreshes_rate(struct rohc_comp *const comp,
+                                                       const size_t max_refreshes,
+                                                       const uint64_t period)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
                                              const size_t list_trans_nr)
 	__attribute__((warn_unused_result))
@@ -419,6 +518,10 @@ bool ROHC_EXPORT rohc_comp_get_general_info(const struct rohc_comp *const comp,
                                             rohc_comp_general_info_t *const info)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_get_memory_usage(const struct rohc_comp *const comp,
+                                            rohc_comp_memory_usage_t *const usage)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
                                                  rohc_comp_last_packet_info2_t *const info)
 	__attribute__((warn_unused_result));
@@ -0,0 +1,189 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_comp_hdr_tmpl.h
+ * @brief  Template of the uncompressed headers of one steady-state flow
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * Once a flow reached a steady state, the uncompressed headers of its
+ * packets only differ in a few well-known fields (IP-ID, length, checksum,
+ * sequence number...). The compression profiles record the headers of the
+ * last packet as a template and mask out those fields. If the headers of
+ * the next packet match the template, the results of the change detection
+ * of the previous packet may be re-used instead of being computed again.
+ */
+
+#ifndef ROHC_COMP_HDR_TMPL_H
+#define ROHC_COMP_HDR_TMPL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/** The maximum length of the headers recorded in a template */
+#define ROHC_COMP_HDR_TMPL_MAX_LEN  128U
+
+
+/** The template of the uncompressed headers of one flow */
+struct rohc_comp_hdr_tmpl
+{
+	/** The length of the headers, 0 if the template is not valid */
+	uint16_t len;
+	/** The Optimistic Approach repetitions when the template was recorded */
+	uint8_t oa_repetitions_nr;
+	/** The number of consecutive packets with the MSN/SN incremented by one */
+	uint8_t sn_incr_nr;
+	/** The MSN/SN of the packet the template was recorded from */
+	uint32_t sn;
+	/** The headers of the packet the template was recorded from */
+	uint8_t data[ROHC_COMP_HDR_TMPL_MAX_LEN];
+	/** The bits of the headers that shall not change from one packet to
+	 *  another, the bits of the other fields are zeroed */
+	uint8_t mask[ROHC_COMP_HDR_TMPL_MAX_LEN];
+};
+
+
+/**
+ * @brief Invalidate the given template
+ *
+ * @param tmpl  The template to invalidate
+ */
+static inline void rohc_comp_hdr_tmpl_reset(struct rohc_comp_hdr_tmpl *const tmpl)
+{
+	tmpl->len = 0;
+}
+
+
+/**
+ * @brief Record the given headers in the template
+ *
+ * All the bits of the headers shall not change until some fields are
+ * ignored with \ref rohc_comp_hdr_tmpl_ignore.
+ *
+ * @param tmpl      The template to record the headers in
+ * @param hdrs      The uncompressed headers
+ * @param hdrs_len  The length of the uncompressed headers
+ * @param sn        The MSN/SN of the packet
+ * @return          true if headers were recorded,
+ *                  false if they are too long for the template
+ */
+static inline bool rohc_comp_hdr_tmpl_set(struct rohc_comp_hdr_tmpl *const tmpl,
+                                          const uint8_t *const hdrs,
+                                          const size_t hdrs_len,
+                                          const uint32_t sn)
+{
+	if(hdrs_len == 0 || hdrs_len > ROHC_COMP_HDR_TMPL_MAX_LEN)
+	{
+		tmpl->len = 0;
+		return false;
+	}
+
+	memcpy(tmpl->data, hdrs, hdrs_len);
+	memset(tmpl->mask, 0xff, hdrs_len);
+	tmpl->len = hdrs_len;
+	tmpl->sn = sn;
+
+	return true;
+}
+
+
+/**
+ * @brief Ignore some bits of the headers recorded in the template
+ *
+ * @param tmpl    The template
+ * @param offset  The offset of the byte in the headers
+ * @param bits    The bits of the byte that may change from one packet to
+ *                another
+ */
+static inline void rohc_comp_hdr_tmpl_ignore_bits(struct rohc_comp_hdr_tmpl *const tmpl,
+                                                  const size_t offset,
+                                                  const uint8_t bits)
+{
+	if(offset < tmpl->len)
+	{
+		tmpl->mask[offset] &= ~bits;
+	}
+}
+
+
+/**
+ * @brief Ignore one field of the headers recorded in the template
+ *
+ * @param tmpl    The template
+ * @param offset  The offset of the field in the headers
+ * @param len     The length of the field
+ */
+static inline void rohc_comp_hdr_tmpl_ignore(struct rohc_comp_hdr_tmpl *const tmpl,
+                                             const size_t offset,
+                                             const size_t len)
+{
+	if(offset < tmpl->len)
+	{
+		const size_t max_len = tmpl->len - offset;
+		memset(tmpl->mask + offset, 0x00, (len < max_len ? len : max_len));
+	}
+}
+
+
+/**
+ * @brief Whether the given headers match the template or not
+ *
+ * The headers are compared 8 bytes at a time, the bits ignored by the
+ * template are not compared.
+ *
+ * @param tmpl      The template
+ * @param hdrs      The uncompressed headers
+ * @param hdrs_len  The length of the uncompressed headers
+ * @return          true if the template is valid and the headers match it,
+ *                  false otherwise
+ */
+static inline bool rohc_comp_hdr_tmpl_match(const struct rohc_comp_hdr_tmpl *const tmpl,
+                                            const uint8_t *const hdrs,
+                                            const size_t hdrs_len)
+{
+	uint64_t diff = 0;
+	size_t i;
+
+	if(tmpl->len == 0 || hdrs_len != tmpl->len)
+	{
+		return false;
+	}
+
+	for(i = 0; (i + sizeof(uint64_t)) <= hdrs_len; i += sizeof(uint64_t))
+	{
+		uint64_t pkt_word;
+		uint64_t tmpl_word;
+		uint64_t mask_word;
+
+		memcpy(&pkt_word, hdrs + i, sizeof(uint64_t));
+		memcpy(&tmpl_word, tmpl->data + i, sizeof(uint64_t));
+		memcpy(&mask_word, tmpl->mask + i, sizeof(uint64_t));
+		diff |= (pkt_word ^ tmpl_word) & mask_word;
+	}
+	for(; i < hdrs_len; i++)
+	{
+		diff |= (hdrs[i] ^ tmpl->data[i]) & tmpl->mask[i];
+	}
+
+	return (diff == 0);
+}
+
+#endif /* ROHC_COMP_HDR_TMPL_H */
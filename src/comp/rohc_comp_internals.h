@@ -63,6 +63,18 @@
  *  before changing back the state to FO (periodic refreshes) */
 #define CHANGE_TO_FO_TIME  500U
 
+/** The maximal period of time (in ms) the number of periodic refreshes may
+ *  be limited for */
+#define ROHC_COMP_REFRESHES_RATE_PERIOD_MAX  3600000U
+
+/** The estimated loss rate (in 1/65536) from which the O-mode contexts use
+ *  the maximal number of Optimistic Approach repetitions (10%) */
+#define ROHC_OA_ADAPT_LOSS_RATE_MAX  6554U
+
+/** The number of packets the loss rate of one O-mode context is estimated
+ *  on: older packets and losses weigh less and less */
+#define ROHC_OA_ADAPT_LOSS_HORIZON  512U
+
 
 /** Print a warning trace for the given compression context */
 #define rohc_comp_warn(context, format, ...) \
@@ -170,6 +182,12 @@ struct rohc_comp
 
 	/** The nr of Optimistic Approach repetitions to gain transmission confidence */
 	uint8_t oa_repetitions_nr;
+	/** The minimal nr of Optimistic Approach repetitions the O-mode contexts
+	 *  may adapt to, 0 if the adaptation is disabled */
+	uint8_t oa_repetitions_min;
+	/** The maximal nr of Optimistic Approach repetitions the O-mode contexts
+	 *  may adapt to, 0 if the adaptation is disabled */
+	uint8_t oa_repetitions_max;
 	/** The reorder offset specifies how much reordering is handled by the
 	 *  W-LSB encoding of the MSN in ROHCv2 profiles */
 	rohc_reordering_offset_t reorder_ratio;
@@ -185,6 +203,31 @@ struct rohc_comp
 	/** The maximal delay spent in > FO states (= SO state) before changing back
 	 *  the state to FO (periodic refreshes) */
 	uint64_t periodic_refreshes_fo_timeout_time;
+	/** The maximal random number of packets the IR timeout of one context
+	 *  is shortened by (periodic refreshes) */
+	size_t periodic_refreshes_ir_jitter_pkts;
+	/** The maximal random number of packets the FO timeout of one context
+	 *  is shortened by (periodic refreshes) */
+	size_t periodic_refreshes_fo_jitter_pkts;
+	/** The maximal random delay (in ms) the IR timeout of one context is
+	 *  shortened by (periodic refreshes) */
+	uint32_t periodic_refreshes_ir_jitter_time;
+	/** The maximal random delay (in ms) the FO timeout of one context is
+	 *  shortened by (periodic refreshes) */
+	uint32_t periodic_refreshes_fo_jitter_time;
+	/** The maximal number of periodic refreshes for all contexts per period
+	 *  of time, 0 for no limit */
+	uint32_t periodic_refreshes_rate_max;
+	/** The period of time (in us) the number of periodic refreshes is
+	 *  limited for */
+	uint64_t periodic_refreshes_rate_period;
+	/** The tokens available for periodic refreshes, one periodic refresh
+	 *  consumes \ref periodic_refreshes_rate_period tokens */
+	uint64_t periodic_refreshes_tokens;
+	/** The arrival time of the packet the tokens were last updated for */
+	struct rohc_ts periodic_refreshes_tokens_time;
+	/** The number of packets compressed when the tokens were last updated */
+	int periodic_refreshes_tokens_pkts;
 	/** Maximum Reconstructed Reception Unit */
 	size_t mrru;
 
@@ -269,6 +312,31 @@ struct rohc_comp_profile
 	                 const uint8_t *const feedback_data,
 	                 const size_t feedback_data_len)
 		__attribute__((warn_unused_result, nonnull(1, 3, 5)));
+
+	/**
+	 * @brief The handler used to change the width of the W-LSB windows of
+	 *        the context when its number of Optimistic Approach repetitions
+	 *        is adapted, NULL if the profile has no W-LSB window
+	 *
+	 * @param context            The compression context
+	 * @param oa_repetitions_nr  The new number of repetitions
+	 * @return                   true if successful, false otherwise
+	 */
+	bool (*set_oa_repetitions)(struct rohc_comp_ctxt *const context,
+	                           const uint8_t oa_repetitions_nr)
+		__attribute__((warn_unused_result, nonnull(1)));
+
+	/**
+	 * @brief The handler used to add the memory used by the profile-specific
+	 *        part of the context to the memory usage of the profile, NULL if
+	 *        the profile has no profile-specific part
+	 *
+	 * @param context  The compression context
+	 * @param usage    IN/OUT: The memory usage of the profile
+	 */
+	void (*account_mem)(const struct rohc_comp_ctxt *const context,
+	                    rohc_comp_profile_memory_usage_t *const usage)
+		__attribute__((nonnull(1, 2)));
 };
 
 
@@ -317,6 +385,21 @@ struct rohc_comp_ctxt
 
 	/** The number of packets sent while in the different compression states */
 	uint8_t state_oa_repeat_nr;
+	/** The nr of Optimistic Approach repetitions used by the context, it is
+	 *  also the width of the W-LSB windows of the context */
+	uint8_t oa_repetitions_nr;
+	/**
+	 * @brief The number of packets lost (in 1/65536) between compressor and
+	 *        decompressor among the \ref oa_sent_pkts last packets, used to
+	 *        adapt the number of Optimistic Approach repetitions of O-mode
+	 *        contexts
+	 * @see rohc_comp_adapt_oa_repetitions
+	 */
+	uint32_t oa_lost_pkts;
+	/** The number of packets the loss rate \ref oa_lost_pkts is estimated on */
+	uint32_t oa_sent_pkts;
+	/** The number of packets sent since the last feedback was received */
+	uint32_t oa_pkts_since_feedback;
 
 	/**
 	 * @brief The number of packet sent while in SO state, used for the periodic
@@ -342,6 +425,22 @@ struct rohc_comp_ctxt
 	 * @see rohc_comp_periodic_down_transition
 	 */
 	struct rohc_ts go_back_ir_time;
+	/**
+	 * @brief The random numbers of packets the FO and IR timeouts of the
+	 *        context are shortened by, used to spread the periodic refreshes
+	 *        of the contexts over time
+	 * @see rohc_comp_periodic_down_transition
+	 */
+	size_t go_back_fo_jitter_pkts;
+	size_t go_back_ir_jitter_pkts;
+	/**
+	 * @brief The random delays (in us) the FO and IR timeouts of the context
+	 *        are shortened by, used to spread the periodic refreshes of the
+	 *        contexts over time
+	 * @see rohc_comp_periodic_down_transition
+	 */
+	uint64_t go_back_fo_jitter_time;
+	uint64_t go_back_ir_jitter_time;
 
 	/** The cumulated size of the uncompressed packets */
 	int total_uncompressed_size;
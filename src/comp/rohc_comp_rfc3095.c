@@ -43,6 +43,7 @@
 #include "crc.h"
 
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 #include <assert.h>
 
@@ -66,6 +67,8 @@ static void ip_header_info_free(struct ip_header_info *const header_info)
 
 static void c_init_tmp_variables(struct rfc3095_tmp_state *const tmp_vars)
 	__attribute__((nonnull(1)));
+static void c_init_tmp_next_hdr_variables(struct rfc3095_tmp_state *const tmp_vars)
+	__attribute__((nonnull(1)));
 
 static rohc_packet_t decide_packet(const struct rohc_comp_ctxt *const context,
                                    const struct rfc3095_tmp_state *const changes)
@@ -360,11 +363,34 @@ static void rohc_comp_rfc3095_detect_changes(const struct rohc_comp_ctxt *const
                                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                              struct rfc3095_tmp_state *const changes)
 	__attribute__((nonnull(1, 2, 3)));
+static bool rohc_comp_rfc3095_detect_changes_tmpl(const struct rohc_comp_ctxt *const context,
+                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                                  struct rfc3095_tmp_state *const changes)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void rohc_comp_rfc3095_detect_sn_bits(const struct rohc_comp_ctxt *const context,
+                                             struct rfc3095_tmp_state *const changes)
+	__attribute__((nonnull(1, 2)));
+static void rohc_comp_rfc3095_detect_ip_id_bits(const struct rohc_comp_ctxt *const context,
+                                                const struct ip_header_info *const ip_ctxt,
+                                                struct rfc3095_ip_hdr_changes *const ip_hdr_changes)
+	__attribute__((nonnull(1, 2, 3)));
+static void rohc_comp_rfc3095_update_hdr_tmpl(struct rohc_comp_ctxt *const context,
+                                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                              const struct rfc3095_tmp_state *const changes)
+	__attribute__((nonnull(1, 2, 3)));
+static bool rohc_comp_rfc3095_is_sn_incr(const struct rohc_comp_ctxt *const context,
+                                         const uint32_t sn_ref,
+                                         const uint32_t sn)
+	__attribute__((warn_unused_result, nonnull(1), pure));
 static void detect_ip_changes(const struct rohc_comp_ctxt *const context,
                               const struct ip_header_info *const header_info,
                               const struct rohc_pkt_ip_hdr *const ip,
                               struct rfc3095_ip_hdr_changes *const changes)
 	__attribute__((nonnull(1, 2, 3, 4)));
+static uint16_t rohc_comp_rfc3095_get_ip_id_delta(const struct rohc_pkt_ip_hdr *const ip,
+                                                  const struct rfc3095_ip_hdr_changes *const changes,
+                                                  const uint32_t new_sn)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
 static void detect_ip_id_behaviours(const struct rohc_comp_ctxt *const context,
                                     const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
                                     struct rfc3095_tmp_state *const changes)
@@ -556,6 +582,21 @@ static void c_init_tmp_variables(struct rfc3095_tmp_state *const tmp_vars)
 		ip_changes->ext_list_content_changed = 0;
 	}
 
+	c_init_tmp_next_hdr_variables(tmp_vars);
+
+	tmp_vars->innermost_ip_id_rnd_changed = 0;
+	tmp_vars->innermost_ip_id_5bits_possible = 0;
+	tmp_vars->is_hdr_tmpl_matching = 0;
+}
+
+
+/**
+ * @brief Initialize the temporary variables related to the next header
+ *
+ * @param tmp_vars  The temporary variables to initialize
+ */
+static void c_init_tmp_next_hdr_variables(struct rfc3095_tmp_state *const tmp_vars)
+{
 	tmp_vars->udp_check_behavior_just_changed = false;
 	tmp_vars->udp_check_behavior_changed = false;
 	tmp_vars->rtp_version_just_changed = false;
@@ -570,9 +611,6 @@ static void c_init_tmp_variables(struct rfc3095_tmp_state *const tmp_vars)
 	tmp_vars->sn_bits_ext_nr = 0;
 	tmp_vars->ts_bits_req_nr = 0;
 	tmp_vars->ts_bits_ext_nr = 0;
-
-	tmp_vars->innermost_ip_id_rnd_changed = 0;
-	tmp_vars->innermost_ip_id_5bits_possible = 0;
 }
 
 
@@ -605,14 +643,14 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	context->specific = rfc3095_ctxt;
 
 	/* init the parameters to encode the SN with W-LSB encoding */
-	is_ok = wlsb_new(&rfc3095_ctxt->sn_window, context->compressor->oa_repetitions_nr);
+	is_ok = wlsb_new(&rfc3095_ctxt->sn_window, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		           "no memory to allocate W-LSB encoding for SN");
 		goto free_generic_context;
 	}
-	is_ok = wlsb_new(&rfc3095_ctxt->msn_non_acked, context->compressor->oa_repetitions_nr);
+	is_ok = wlsb_new(&rfc3095_ctxt->msn_non_acked, context->oa_repetitions_nr);
 	if(!is_ok)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -630,7 +668,7 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 		rohc_debug(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		           "init context for IP header #%zu", ip_hdr_pos + 1);
 		if(!ip_header_info_new(ip_ctxt, pkt_ip_hdr,
-		                       context->compressor->oa_repetitions_nr,
+		                       context->oa_repetitions_nr,
 		                       context->profile->id,
 		                       context->compressor->trace_callback,
 		                       context->compressor->trace_callback_priv))
@@ -720,6 +758,137 @@ void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Change the number of Optimistic Approach repetitions of the context
+ *
+ * The W-LSB windows of the SN and of the IP-ID are resized to the new number
+ * of repetitions. The list compressors of the IPv6 extension headers use the
+ * new number of repetitions for the next lists.
+ *
+ * This function is one of the functions that may exist in one profile for the
+ * framework to adapt the number of repetitions of O-mode contexts.
+ *
+ * @param context            The compression context
+ * @param oa_repetitions_nr  The new number of repetitions
+ * @return                   true if successful, false otherwise
+ */
+bool rohc_comp_rfc3095_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                          const uint8_t oa_repetitions_nr)
+{
+	return rohc_comp_rfc3095_set_oa_repetitions_wlsbs(context, oa_repetitions_nr,
+	                                                  NULL, 0);
+}
+
+
+/**
+ * @brief Change the number of Optimistic Approach repetitions of the context
+ *        and of the profile-specific W-LSB windows
+ *
+ * The W-LSB windows of the SN, of the IP-ID and the given W-LSB windows of
+ * the profile are resized at once: if one of them cannot be resized, none
+ * is and the context is left unchanged.
+ *
+ * @param context            The compression context
+ * @param oa_repetitions_nr  The new number of repetitions
+ * @param profile_wlsbs      The W-LSB windows specific to the profile
+ * @param profile_wlsbs_nr   The number of W-LSB windows specific to the
+ *                           profile
+ * @return                   true if successful, false otherwise
+ */
+bool rohc_comp_rfc3095_set_oa_repetitions_wlsbs(struct rohc_comp_ctxt *const context,
+                                                const uint8_t oa_repetitions_nr,
+                                                struct c_wlsb *const profile_wlsbs[],
+                                                const size_t profile_wlsbs_nr)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	struct c_wlsb *wlsbs[ROHC_WLSB_SET_WIDTH_MAX_NR];
+	size_t wlsbs_nr = 0;
+	size_t ip_hdr_pos;
+	size_t i;
+
+	assert((2 + ROHC_MAX_IP_HDRS + profile_wlsbs_nr) <= ROHC_WLSB_SET_WIDTH_MAX_NR);
+
+	wlsbs[wlsbs_nr++] = &rfc3095_ctxt->sn_window;
+	wlsbs[wlsbs_nr++] = &rfc3095_ctxt->msn_non_acked;
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+	{
+		struct ip_header_info *const ip_ctxt = &rfc3095_ctxt->ip_ctxts[ip_hdr_pos];
+
+		if(ip_ctxt->version == IPV4)
+		{
+			wlsbs[wlsbs_nr++] = &ip_ctxt->info.v4.ip_id_window;
+		}
+	}
+	for(i = 0; i < profile_wlsbs_nr; i++)
+	{
+		wlsbs[wlsbs_nr++] = profile_wlsbs[i];
+	}
+
+	if(!wlsbs_set_width(wlsbs, wlsbs_nr, oa_repetitions_nr))
+	{
+		rohc_comp_warn(context, "failed to resize the W-LSB windows");
+		goto error;
+	}
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+	{
+		struct ip_header_info *const ip_ctxt = &rfc3095_ctxt->ip_ctxts[ip_hdr_pos];
+
+		if(ip_ctxt->version != IPV4)
+		{
+			ip_ctxt->info.v6.ext_comp.oa_repetitions_nr = oa_repetitions_nr;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Add the memory used by the RFC3095 part of the context to the
+ *        memory usage of the profile
+ *
+ * The IP header contexts are reserved for all the IP headers the profile
+ * supports, and each of them holds one list compressor for the IPv6 extension
+ * headers. The W-LSB windows of the IP-ID are allocated for IPv4 headers only.
+ * The profile-specific data of the UDP and RTP profiles is accounted for by
+ * the profiles themselves.
+ *
+ * This function is one of the functions that may exist in one profile for the
+ * framework to report the memory used by the profile.
+ *
+ * @param context  The compression context
+ * @param usage    IN/OUT: The memory usage of the profile
+ */
+void rohc_comp_rfc3095_account_mem(const struct rohc_comp_ctxt *const context,
+                                   rohc_comp_profile_memory_usage_t *const usage)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const size_t lists_mem = ROHC_MAX_IP_HDRS * sizeof(struct list_comp);
+	size_t ip_hdr_pos;
+
+	usage->specific_mem += sizeof(struct rohc_comp_rfc3095_ctxt);
+	usage->ip_ctxts_mem += sizeof(rfc3095_ctxt->ip_ctxts) - lists_mem;
+	usage->lists_mem += lists_mem;
+
+	usage->wlsb_mem += wlsb_get_mem_size(&rfc3095_ctxt->sn_window);
+	usage->wlsb_mem += wlsb_get_mem_size(&rfc3095_ctxt->msn_non_acked);
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+	{
+		const struct ip_header_info *const ip_ctxt =
+			&rfc3095_ctxt->ip_ctxts[ip_hdr_pos];
+
+		if(ip_ctxt->version == IPV4)
+		{
+			usage->wlsb_mem += wlsb_get_mem_size(&ip_ctxt->info.v4.ip_id_window);
+		}
+	}
+}
+
+
 /**
  * @brief Encode an IP packet according to a pattern decided by several
  *        different factors.
@@ -751,18 +920,11 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
                              rohc_packet_t *const packet_type)
 {
 	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	struct rfc3095_tmp_state *changes;
+	struct rfc3095_tmp_state *const changes = &rfc3095_ctxt->tmp;
 	int size;
 
 	*packet_type = ROHC_PACKET_UNKNOWN;
 
-	changes = malloc(sizeof(struct rfc3095_tmp_state));
-	if(changes == NULL)
-	{
-		rohc_comp_warn(context, "failed to allocate memory for temporary state");
-		goto error;
-	}
-
 	/* detect changes between new uncompressed packet and context */
 	rohc_comp_rfc3095_detect_changes(context, uncomp_pkt_hdrs, changes);
 
@@ -924,20 +1086,20 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
 	                   rohc_pkt, rohc_pkt_max_len, *packet_type);
 	if(size < 0)
 	{
-		goto free_tmp_state;
+		goto error;
 	}
 
+	/* record the headers as template for the next packets if possible */
+	rohc_comp_rfc3095_update_hdr_tmpl(context, uncomp_pkt_hdrs, changes);
+
 	/* update the context with the new headers */
 	update_context(context, uncomp_pkt_hdrs, changes, *packet_type);
 
-	free(changes);
-
 	/* return the length of the ROHC packet */
 	return size;
 
-free_tmp_state:
-	free(changes);
 error:
+	rohc_comp_hdr_tmpl_reset(&rfc3095_ctxt->hdr_tmpl);
 	return -1;
 }
 
@@ -1164,7 +1326,7 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
                                            const size_t sn_bits_nr,
                                            const bool sn_not_valid)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
 	size_t ip_hdr_pos;
 
@@ -1283,6 +1445,11 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
 			acked_nr = wlsb_ack(&rfc3095_ctxt->sn_window, sn_bits, sn_bits_nr);
 			rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
 			                "from SN W-LSB", acked_nr);
+
+			/* the W-LSB windows changed, the header template cannot be used
+			 * until the SN window is filled with consecutive SNs again */
+			rohc_comp_hdr_tmpl_reset(&rfc3095_ctxt->hdr_tmpl);
+			rfc3095_ctxt->hdr_tmpl.sn_incr_nr = 0;
 		}
 	}
 
@@ -1351,6 +1518,13 @@ static void rohc_comp_rfc3095_detect_changes(const struct rohc_comp_ctxt *const
 	 * a new context is used instead */
 	assert(uncomp_pkt_hdrs->ip_hdrs_nr == rfc3095_ctxt->ip_hdr_nr);
 
+	/* re-use the changes of the previous packet if the headers of the new
+	 * packet match the header template of the context */
+	if(rohc_comp_rfc3095_detect_changes_tmpl(context, uncomp_pkt_hdrs, changes))
+	{
+		return;
+	}
+
 	/* init the temporary variables, whose lifetime is limited to the compression
 	 * of one single packet */
 	c_init_tmp_variables(changes);
@@ -1359,6 +1533,206 @@ static void rohc_comp_rfc3095_detect_changes(const struct rohc_comp_ctxt *const
 	/* compute or find the new SN */
 	changes->new_sn = rfc3095_ctxt->get_next_sn(context, uncomp_pkt_hdrs);
 	rohc_comp_debug(context, "new SN = %u / 0x%x", changes->new_sn, changes->new_sn);
+	rohc_comp_rfc3095_detect_sn_bits(context, changes);
+
+	/* check NBO and RND of the IP-ID of the IP headers (IPv4 only) */
+	detect_ip_id_behaviours(context, uncomp_pkt_hdrs, changes);
+
+	/* find IP fields that changed */
+	changes->at_least_one_rnd_changed = 0;
+	changes->at_least_one_sid_changed = 0;
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+	{
+		const struct rohc_pkt_ip_hdr *const pkt_ip_hdr =
+			&(uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos]);
+		const struct ip_header_info *const ip_ctxt =
+			&(rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
+		struct rfc3095_ip_hdr_changes *const ip_hdr_changes =
+			&(changes->ip_hdr_changes[ip_hdr_pos]);
+
+		detect_ip_changes(context, ip_ctxt, pkt_ip_hdr, ip_hdr_changes);
+
+		changes->at_least_one_rnd_changed |= ip_hdr_changes->rnd_changed;
+		changes->at_least_one_sid_changed |= ip_hdr_changes->sid_changed;
+
+		if(ip_ctxt->version == IPV6)
+		{
+			/* no IP-ID in IPv6 */
+			ip_hdr_changes->ip_id_changed = false;
+			ip_hdr_changes->ip_id_3bits_possible = false;
+			ip_hdr_changes->ip_id_5bits_possible = false;
+			ip_hdr_changes->ip_id_6bits_possible = false;
+			ip_hdr_changes->ip_id_8bits_possible = false;
+			ip_hdr_changes->ip_id_11bits_possible = false;
+		}
+		else /* IPV4 */
+		{
+			/* compute the new IP-ID / SN delta */
+			ip_hdr_changes->ip_id_delta =
+				rohc_comp_rfc3095_get_ip_id_delta(pkt_ip_hdr, ip_hdr_changes,
+				                                  changes->new_sn);
+			rohc_comp_debug(context, "IP header #%zu: new IP-ID delta = 0x%x / %u "
+			                "(NBO = %d, RND = %d, SID = %d)", ip_hdr_pos + 1,
+			                ip_hdr_changes->ip_id_delta, ip_hdr_changes->ip_id_delta,
+			                ip_hdr_changes->nbo, ip_hdr_changes->rnd,
+			                ip_hdr_changes->sid);
+
+			/* how many bits are required to encode the new IP-ID / SN delta ? */
+			rohc_comp_rfc3095_detect_ip_id_bits(context, ip_ctxt, ip_hdr_changes);
+		}
+	}
+	/* determine the number of IP-ID bits and the IP-ID offset of the
+	 * innermost IPv4 header with non-random IP-ID */
+	rohc_get_innermost_ipv4_non_rnd(context, changes);
+
+	/* update info related to transport header */
+	if(rfc3095_ctxt->encode_uncomp_fields != NULL)
+	{
+		rfc3095_ctxt->encode_uncomp_fields(context, uncomp_pkt_hdrs, changes);
+	}
+}
+
+
+/**
+ * @brief Re-use the changes detected for the previous packet if possible
+ *
+ * In SO state, the changes detected for the previous packet remain valid for
+ * the new packet if:
+ *  - the headers of the new packet match the header template of the context,
+ *    ie. only the length, checksum, IP-ID, SN and TS fields changed,
+ *  - the SN is incremented by one,
+ *  - the IP-ID / SN offsets of the non-constant IP-IDs are unchanged.
+ *
+ * The numbers of bits that may encode the new SN and the new IP-ID / SN
+ * offsets are always computed again from the W-LSB windows: the windows
+ * slide with every packet and shrink with every acknowledgment, so the
+ * numbers of bits of the previous packet may not be enough for the new one.
+ * The changes of the next header (UDP, RTP...) are always detected again.
+ *
+ * @param context          The compression context
+ * @param uncomp_pkt_hdrs  The uncompressed headers to encode
+ * @param changes          IN: The header fields that changed for the previous
+ *                             packet
+ *                         OUT: The header fields that changed wrt to context
+ * @return                 true if the changes of the previous packet were
+ *                         re-used, false if they shall be detected again
+ */
+static bool rohc_comp_rfc3095_detect_changes_tmpl(const struct rohc_comp_ctxt *const context,
+                                                  const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                                  struct rfc3095_tmp_state *const changes)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const struct rohc_comp_hdr_tmpl *const tmpl = &rfc3095_ctxt->hdr_tmpl;
+	uint16_t ip_id_deltas[ROHC_MAX_IP_HDRS] = { 0 };
+	uint32_t new_sn;
+	size_t ip_hdr_pos;
+
+	if(context->state != ROHC_COMP_STATE_SO ||
+	   tmpl->oa_repetitions_nr != context->oa_repetitions_nr ||
+	   !rohc_comp_hdr_tmpl_match(tmpl, uncomp_pkt_hdrs->all_hdrs,
+	                             uncomp_pkt_hdrs->all_hdrs_len))
+	{
+		goto not_matching;
+	}
+
+	/* the SN shall be incremented by one */
+	new_sn = rfc3095_ctxt->get_next_sn(context, uncomp_pkt_hdrs);
+	if(!rohc_comp_rfc3095_is_sn_incr(context, tmpl->sn, new_sn))
+	{
+		rohc_comp_debug(context, "headers match template, but SN %u is not the "
+		                "successor of SN %u", new_sn, tmpl->sn);
+		goto not_matching;
+	}
+
+	/* the IP-ID / SN offsets shall be unchanged */
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+	{
+		const struct ip_header_info *const ip_ctxt =
+			&(rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
+		const struct rohc_pkt_ip_hdr *const pkt_ip_hdr =
+			&(uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos]);
+		const struct rfc3095_ip_hdr_changes *const ip_hdr_changes =
+			&(changes->ip_hdr_changes[ip_hdr_pos]);
+
+		if(ip_ctxt->version != IPV4 || ip_hdr_changes->sid)
+		{
+			continue;
+		}
+
+		ip_id_deltas[ip_hdr_pos] =
+			rohc_comp_rfc3095_get_ip_id_delta(pkt_ip_hdr, ip_hdr_changes, new_sn);
+		if(ip_id_deltas[ip_hdr_pos] != ip_hdr_changes->ip_id_delta)
+		{
+			rohc_comp_debug(context, "headers match template, but IP-ID / SN "
+			                "offset of IP header #%zu changed", ip_hdr_pos + 1);
+			goto not_matching;
+		}
+
+		/* a Little Endian IP-ID may look like a NBO one when it wraps around */
+		if(ip_hdr_changes->nbo == 0 &&
+		   is_ip_id_increasing(rohc_ntoh16(ip_ctxt->info.v4.old_ip.id),
+		                       rohc_ntoh16(pkt_ip_hdr->ipv4->id), 19))
+		{
+			rohc_comp_debug(context, "headers match template, but IP-ID of IP "
+			                "header #%zu may change of byte order", ip_hdr_pos + 1);
+			goto not_matching;
+		}
+	}
+
+	rohc_comp_debug(context, "headers match template, re-use the changes of "
+	                "previous packet for new SN = %u / 0x%x", new_sn, new_sn);
+	changes->new_sn = new_sn;
+	changes->is_hdr_tmpl_matching = 1;
+	rohc_comp_rfc3095_detect_sn_bits(context, changes);
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+	{
+		const struct ip_header_info *const ip_ctxt =
+			&(rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
+		struct rfc3095_ip_hdr_changes *const ip_hdr_changes =
+			&(changes->ip_hdr_changes[ip_hdr_pos]);
+
+		if(ip_ctxt->version == IPV4)
+		{
+			ip_hdr_changes->ip_id_delta = (ip_hdr_changes->sid ?
+				rohc_comp_rfc3095_get_ip_id_delta(&(uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos]),
+				                                  ip_hdr_changes, new_sn) :
+				ip_id_deltas[ip_hdr_pos]);
+			rohc_comp_rfc3095_detect_ip_id_bits(context, ip_ctxt, ip_hdr_changes);
+		}
+	}
+
+	/* the IP-ID / SN offset of a constant IP-ID changes with every SN */
+	rohc_get_innermost_ipv4_non_rnd(context, changes);
+
+	/* update info related to transport header */
+	c_init_tmp_next_hdr_variables(changes);
+	if(rfc3095_ctxt->encode_uncomp_fields != NULL)
+	{
+		rfc3095_ctxt->encode_uncomp_fields(context, uncomp_pkt_hdrs, changes);
+	}
+
+	return true;
+
+not_matching:
+	return false;
+}
+
+
+/**
+ * @brief Find how many SN bits may encode the new SN
+ *
+ * The W-LSB window of the SN is checked for every number of bits that the
+ * packet formats of the profile may transmit.
+ *
+ * @param context  The compression context
+ * @param changes   IN: The new SN
+ *                 OUT: The numbers of bits that may encode the new SN
+ */
+static void rohc_comp_rfc3095_detect_sn_bits(const struct rohc_comp_ctxt *const context,
+                                             struct rfc3095_tmp_state *const changes)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+
 	if(context->profile->id == ROHC_PROFILE_RTP)
 	{
 		changes->sn_4bits_possible =
@@ -1449,129 +1823,256 @@ static void rohc_comp_rfc3095_detect_changes(const struct rohc_comp_ctxt *const
 	{
 		rohc_comp_debug(context, "  14 bits may encode new SN");
 	}
+}
 
-	/* check NBO and RND of the IP-ID of the IP headers (IPv4 only) */
-	detect_ip_id_behaviours(context, uncomp_pkt_hdrs, changes);
 
-	/* find IP fields that changed */
-	changes->at_least_one_rnd_changed = 0;
-	changes->at_least_one_sid_changed = 0;
-	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+/**
+ * @brief Find how many bits may encode the new IP-ID / SN offset
+ *
+ * The W-LSB window of the IP-ID / SN offset is checked for every number of
+ * bits that the packet formats may transmit.
+ *
+ * @param context         The compression context
+ * @param ip_ctxt         The context of the IPv4 header
+ * @param ip_hdr_changes   IN: The new IP-ID / SN offset and the behaviour
+ *                             of the IP-ID
+ *                        OUT: The numbers of bits that may encode the new
+ *                             IP-ID / SN offset
+ */
+static void rohc_comp_rfc3095_detect_ip_id_bits(const struct rohc_comp_ctxt *const context,
+                                                const struct ip_header_info *const ip_ctxt,
+                                                struct rfc3095_ip_hdr_changes *const ip_hdr_changes)
+{
+	if(ip_hdr_changes->sid)
 	{
-		const struct rohc_pkt_ip_hdr *const pkt_ip_hdr =
-			&(uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos]);
-		const struct ip_header_info *const ip_ctxt =
-			&(rfc3095_ctxt->ip_ctxts[ip_hdr_pos]);
-		struct rfc3095_ip_hdr_changes *const ip_hdr_changes =
-			&(changes->ip_hdr_changes[ip_hdr_pos]);
+		/* IP-ID is constant, no IP-ID bit to transmit */
+		ip_hdr_changes->ip_id_changed = false;
+		ip_hdr_changes->ip_id_3bits_possible = true;
+		ip_hdr_changes->ip_id_5bits_possible = true;
+		ip_hdr_changes->ip_id_6bits_possible = true;
+		ip_hdr_changes->ip_id_8bits_possible = true;
+		ip_hdr_changes->ip_id_11bits_possible = true;
+		rohc_comp_debug(context, "  IP-ID is constant, no IP-ID bit to transmit");
+	}
+	else
+	{
+		/* send only required bits in FO or SO states */
+		ip_hdr_changes->ip_id_changed =
+			!wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
+			                            ip_hdr_changes->ip_id_delta,
+			                            0, ROHC_LSB_SHIFT_IP_ID);
+		ip_hdr_changes->ip_id_3bits_possible =
+			wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
+			                           ip_hdr_changes->ip_id_delta,
+			                           3, ROHC_LSB_SHIFT_IP_ID);
+		ip_hdr_changes->ip_id_5bits_possible =
+			wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
+			                           ip_hdr_changes->ip_id_delta,
+			                           5, ROHC_LSB_SHIFT_IP_ID);
+		ip_hdr_changes->ip_id_6bits_possible =
+			wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
+			                           ip_hdr_changes->ip_id_delta,
+			                           6, ROHC_LSB_SHIFT_IP_ID);
+		ip_hdr_changes->ip_id_8bits_possible =
+			wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
+			                           ip_hdr_changes->ip_id_delta,
+			                           8, ROHC_LSB_SHIFT_IP_ID);
+		ip_hdr_changes->ip_id_11bits_possible =
+			wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
+			                           ip_hdr_changes->ip_id_delta,
+			                           11, ROHC_LSB_SHIFT_IP_ID);
+	}
+	rohc_comp_debug(context, "  %s bits are required to encode new IP-ID delta",
+	                ip_hdr_changes->ip_id_changed ? "some" : "no");
+	if(ip_hdr_changes->ip_id_3bits_possible)
+	{
+		rohc_comp_debug(context, "  3 bits may encode new IP-ID delta");
+	}
+	if(ip_hdr_changes->ip_id_5bits_possible)
+	{
+		rohc_comp_debug(context, "  5 bits may encode new IP-ID delta");
+	}
+	if(ip_hdr_changes->ip_id_6bits_possible)
+	{
+		rohc_comp_debug(context, "  6 bits may encode new IP-ID delta");
+	}
+	if(ip_hdr_changes->ip_id_8bits_possible)
+	{
+		rohc_comp_debug(context, "  8 bits may encode new IP-ID delta");
+	}
+	if(ip_hdr_changes->ip_id_11bits_possible)
+	{
+		rohc_comp_debug(context, "  11 bits may encode new IP-ID delta");
+	}
+}
 
-		detect_ip_changes(context, ip_ctxt, pkt_ip_hdr, ip_hdr_changes);
 
-		changes->at_least_one_rnd_changed |= ip_hdr_changes->rnd_changed;
-		changes->at_least_one_sid_changed |= ip_hdr_changes->sid_changed;
+/**
+ * @brief Record the headers of the packet as template for the next packets
+ *
+ * The headers are recorded in SO state only, once all the IP fields were
+ * transmitted enough times to be considered as unchanged. The fields that
+ * change from one packet to another in a steady flow are ignored by the
+ * template: IPv4 Total Length, Checksum and non-constant Identification,
+ * IPv6 Payload Length, UDP Length and Checksum, RTP Sequence Number and
+ * Timestamp, and ESP Sequence Number.
+ *
+ * @param context          The compression context
+ * @param uncomp_pkt_hdrs  The uncompressed headers of the packet
+ * @param changes          The header fields that changed wrt to context
+ */
+static void rohc_comp_rfc3095_update_hdr_tmpl(struct rohc_comp_ctxt *const context,
+                                              const struct rohc_pkt_hdrs *const uncomp_pkt_hdrs,
+                                              const struct rfc3095_tmp_state *const changes)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	struct rohc_comp_hdr_tmpl *const tmpl = &rfc3095_ctxt->hdr_tmpl;
+	const uint8_t *const all_hdrs = uncomp_pkt_hdrs->all_hdrs;
+	size_t ip_hdr_pos;
 
-		if(ip_ctxt->version == IPV6)
+	/* count the successive packets with SN incremented by one */
+	if(rohc_comp_rfc3095_is_sn_incr(context, rfc3095_ctxt->last_sn, changes->new_sn))
+	{
+		if(tmpl->sn_incr_nr < UINT8_MAX)
 		{
-			/* no IP-ID in IPv6 */
-			ip_hdr_changes->ip_id_changed = false;
-			ip_hdr_changes->ip_id_3bits_possible = false;
-			ip_hdr_changes->ip_id_5bits_possible = false;
-			ip_hdr_changes->ip_id_6bits_possible = false;
-			ip_hdr_changes->ip_id_8bits_possible = false;
-			ip_hdr_changes->ip_id_11bits_possible = false;
+			tmpl->sn_incr_nr++;
 		}
-		else /* IPV4 */
+	}
+	else
+	{
+		tmpl->sn_incr_nr = 0;
+	}
+
+	/* template matched the packet, only the SN changed */
+	if(changes->is_hdr_tmpl_matching)
+	{
+		tmpl->sn = changes->new_sn;
+		return;
+	}
+	rohc_comp_hdr_tmpl_reset(tmpl);
+
+	/* the SN window shall only contain consecutive SNs */
+	if(context->state != ROHC_COMP_STATE_SO ||
+	   tmpl->sn_incr_nr < rfc3095_ctxt->sn_window.window_width)
+	{
+		return;
+	}
+
+	/* no IP field shall be transmitted anymore */
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+	{
+		const struct rfc3095_ip_hdr_changes *const ip_hdr_changes =
+			&(changes->ip_hdr_changes[ip_hdr_pos]);
+
+		if(ip_hdr_changes->tos_tc_changed || ip_hdr_changes->ttl_hl_changed)
 		{
-			/* compute the new IP-ID / SN delta */
+			return;
+		}
+		if(rfc3095_ctxt->ip_ctxts[ip_hdr_pos].version == IPV4)
+		{
+			if(ip_hdr_changes->df_changed || ip_hdr_changes->nbo_changed ||
+			   ip_hdr_changes->rnd_changed || ip_hdr_changes->sid_changed ||
+			   ip_hdr_changes->rnd ||
+			   (!ip_hdr_changes->sid && ip_hdr_changes->ip_id_changed))
 			{
-				const uint16_t id = pkt_ip_hdr->ipv4->id;
-				const bool is_little_endian =
-					(ip_hdr_changes->rnd == 0 && ip_hdr_changes->nbo == 0);
-				const uint16_t id_nbo = (is_little_endian ? swab16(id) : id);
-				const uint16_t id_nbo_h = rohc_ntoh16(id_nbo);
-				ip_hdr_changes->ip_id_delta = id_nbo_h - changes->new_sn;
-				rohc_comp_debug(context, "IP header #%zu: new IP-ID delta = "
-				                "0x%04x - 0x%04x = 0x%x / %u "
-				                "(NBO = %d, RND = %d, SID = %d)", ip_hdr_pos + 1,
-				                id_nbo_h, changes->new_sn,
-				                ip_hdr_changes->ip_id_delta, ip_hdr_changes->ip_id_delta,
-				                ip_hdr_changes->nbo, ip_hdr_changes->rnd,
-				                ip_hdr_changes->sid);
+				return;
 			}
+		}
+		else if(uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos].exts_nr > 0 ||
+		        ip_hdr_changes->ext_list_struct_changed ||
+		        ip_hdr_changes->ext_list_content_changed)
+		{
+			return;
+		}
+	}
 
-			/* how many bits are required to encode the new IP-ID / SN delta ? */
-			if(ip_hdr_changes->sid)
-			{
-				/* IP-ID is constant, no IP-ID bit to transmit */
-				ip_hdr_changes->ip_id_changed = false;
-				ip_hdr_changes->ip_id_3bits_possible = true;
-				ip_hdr_changes->ip_id_5bits_possible = true;
-				ip_hdr_changes->ip_id_6bits_possible = true;
-				ip_hdr_changes->ip_id_8bits_possible = true;
-				ip_hdr_changes->ip_id_11bits_possible = true;
-				rohc_comp_debug(context, "  IP-ID is constant, no IP-ID bit to transmit");
-			}
-			else
-			{
-				/* send only required bits in FO or SO states */
-				ip_hdr_changes->ip_id_changed =
-					!wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                            ip_hdr_changes->ip_id_delta,
-					                            0, ROHC_LSB_SHIFT_IP_ID);
-				ip_hdr_changes->ip_id_3bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_hdr_changes->ip_id_delta,
-					                           3, ROHC_LSB_SHIFT_IP_ID);
-				ip_hdr_changes->ip_id_5bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_hdr_changes->ip_id_delta,
-					                           5, ROHC_LSB_SHIFT_IP_ID);
-				ip_hdr_changes->ip_id_6bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_hdr_changes->ip_id_delta,
-					                           6, ROHC_LSB_SHIFT_IP_ID);
-				ip_hdr_changes->ip_id_8bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_hdr_changes->ip_id_delta,
-					                           8, ROHC_LSB_SHIFT_IP_ID);
-				ip_hdr_changes->ip_id_11bits_possible =
-					wlsb_is_kp_possible_16bits(&ip_ctxt->info.v4.ip_id_window,
-					                           ip_hdr_changes->ip_id_delta,
-					                           11, ROHC_LSB_SHIFT_IP_ID);
-			}
-			rohc_comp_debug(context, "  %s bits are required to encode new IP-ID delta",
-			                ip_hdr_changes->ip_id_changed ? "some" : "no");
-			if(ip_hdr_changes->ip_id_3bits_possible)
-			{
-				rohc_comp_debug(context, "  3 bits may encode new IP-ID delta");
-			}
-			if(ip_hdr_changes->ip_id_5bits_possible)
-			{
-				rohc_comp_debug(context, "  5 bits may encode new IP-ID delta");
-			}
-			if(ip_hdr_changes->ip_id_6bits_possible)
-			{
-				rohc_comp_debug(context, "  6 bits may encode new IP-ID delta");
-			}
-			if(ip_hdr_changes->ip_id_8bits_possible)
-			{
-				rohc_comp_debug(context, "  8 bits may encode new IP-ID delta");
-			}
-			if(ip_hdr_changes->ip_id_11bits_possible)
+	if(!rohc_comp_hdr_tmpl_set(tmpl, all_hdrs, uncomp_pkt_hdrs->all_hdrs_len,
+	                           changes->new_sn))
+	{
+		return;
+	}
+	tmpl->oa_repetitions_nr = context->oa_repetitions_nr;
+
+	/* ignore the IP fields that change from one packet to another */
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc3095_ctxt->ip_hdr_nr; ip_hdr_pos++)
+	{
+		const struct rohc_pkt_ip_hdr *const pkt_ip_hdr =
+			&(uncomp_pkt_hdrs->ip_hdrs[ip_hdr_pos]);
+		const size_t ip_offset = pkt_ip_hdr->data - all_hdrs;
+
+		if(pkt_ip_hdr->version == IPV4)
+		{
+			rohc_comp_hdr_tmpl_ignore(tmpl, ip_offset + offsetof(struct ipv4_hdr, tot_len),
+			                          sizeof(uint16_t));
+			rohc_comp_hdr_tmpl_ignore(tmpl, ip_offset + offsetof(struct ipv4_hdr, check),
+			                          sizeof(uint16_t));
+			if(!changes->ip_hdr_changes[ip_hdr_pos].sid)
 			{
-				rohc_comp_debug(context, "  11 bits may encode new IP-ID delta");
+				rohc_comp_hdr_tmpl_ignore(tmpl, ip_offset + offsetof(struct ipv4_hdr, id),
+				                          sizeof(uint16_t));
 			}
 		}
+		else
+		{
+			rohc_comp_hdr_tmpl_ignore(tmpl, ip_offset + offsetof(struct ipv6_hdr, plen),
+			                          sizeof(uint16_t));
+		}
 	}
-	/* determine the number of IP-ID bits and the IP-ID offset of the
-	 * innermost IPv4 header with non-random IP-ID */
-	rohc_get_innermost_ipv4_non_rnd(context, changes);
 
-	/* update info related to transport header */
-	if(rfc3095_ctxt->encode_uncomp_fields != NULL)
+	/* ignore the next header fields that change from one packet to another */
+	if(context->profile->id == ROHC_PROFILE_UDP ||
+	   context->profile->id == ROHC_PROFILE_RTP)
 	{
-		rfc3095_ctxt->encode_uncomp_fields(context, uncomp_pkt_hdrs, changes);
+		const size_t udp_offset = uncomp_pkt_hdrs->transport - all_hdrs;
+
+		rohc_comp_hdr_tmpl_ignore(tmpl, udp_offset + offsetof(struct udphdr, len),
+		                          sizeof(uint16_t));
+		rohc_comp_hdr_tmpl_ignore(tmpl, udp_offset + offsetof(struct udphdr, check),
+		                          sizeof(uint16_t));
 	}
+	if(context->profile->id == ROHC_PROFILE_RTP)
+	{
+		const size_t rtp_offset = ((const uint8_t *) uncomp_pkt_hdrs->rtp) - all_hdrs;
+
+		rohc_comp_hdr_tmpl_ignore(tmpl, rtp_offset + offsetof(struct rtphdr, sn),
+		                          sizeof(uint16_t));
+		rohc_comp_hdr_tmpl_ignore(tmpl, rtp_offset + offsetof(struct rtphdr, timestamp),
+		                          sizeof(uint32_t));
+	}
+	else if(context->profile->id == ROHC_PROFILE_ESP)
+	{
+		const size_t esp_offset = uncomp_pkt_hdrs->transport - all_hdrs;
+
+		rohc_comp_hdr_tmpl_ignore(tmpl, esp_offset + offsetof(struct esphdr, sn),
+		                          sizeof(uint32_t));
+	}
+
+	rohc_comp_debug(context, "record the %u bytes of headers as template for "
+	                "next packets", tmpl->len);
+}
+
+
+/**
+ * @brief Whether the SN is the successor of the reference SN or not
+ *
+ * @param context  The compression context
+ * @param sn_ref   The reference SN
+ * @param sn       The SN to check
+ * @return         true if the SN is the reference SN incremented by one,
+ *                 false otherwise
+ */
+static bool rohc_comp_rfc3095_is_sn_incr(const struct rohc_comp_ctxt *const context,
+                                         const uint32_t sn_ref,
+                                         const uint32_t sn)
+{
+	if(context->profile->id == ROHC_PROFILE_ESP)
+	{
+		/* 32-bit ESP SN */
+		return (sn == (uint32_t) (sn_ref + 1));
+	}
+
+	/* 16-bit RTP SN or 16-bit SN generated by the compressor */
+	return (sn == ((sn_ref + 1) & 0xffff));
 }
 
 
@@ -5521,7 +6022,7 @@ static void update_context_ip_hdr(const struct rohc_comp_ctxt *const context,
                                   const struct rfc3095_ip_hdr_changes *const changes,
                                   const uint32_t new_sn)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 
 	ip_flags->is_first_header = false;
 
@@ -5639,7 +6140,7 @@ static void detect_ip_changes(const struct rohc_comp_ctxt *const context,
                               const struct rohc_pkt_ip_hdr *const ip,
                               struct rfc3095_ip_hdr_changes *const changes)
 {
-	const uint8_t oa_repetitions_nr = context->compressor->oa_repetitions_nr;
+	const uint8_t oa_repetitions_nr = context->oa_repetitions_nr;
 	uint8_t old_tos;
 	uint8_t old_ttl;
 
@@ -5813,6 +6314,26 @@ static void detect_ip_changes(const struct rohc_comp_ctxt *const context,
 }
 
 
+/**
+ * @brief Compute the offset between the IP-ID and the SN
+ *
+ * @param ip       The IPv4 header
+ * @param changes  The changes of the IPv4 header, ie. its IP-ID behaviour
+ * @param new_sn   The SN of the packet
+ * @return         The IP-ID / SN offset
+ */
+static uint16_t rohc_comp_rfc3095_get_ip_id_delta(const struct rohc_pkt_ip_hdr *const ip,
+                                                  const struct rfc3095_ip_hdr_changes *const changes,
+                                                  const uint32_t new_sn)
+{
+	const uint16_t id = ip->ipv4->id;
+	const bool is_little_endian = (changes->rnd == 0 && changes->nbo == 0);
+	const uint16_t id_nbo = (is_little_endian ? swab16(id) : id);
+
+	return (rohc_ntoh16(id_nbo) - new_sn);
+}
+
+
 /**
  * @brief Detect the behaviour of the IP-ID fields of the IPv4 headers
  *
@@ -30,6 +30,7 @@
 #define ROHC_COMP_RFC3095_H
 
 #include "rohc_comp_internals.h"
+#include "rohc_comp_hdr_tmpl.h"
 #include "rohc_packets.h"
 #include "protocols/uncomp_pkt_hdrs.h"
 #include "schemes/comp_list.h"
@@ -259,6 +260,8 @@ struct rfc3095_tmp_state
 	uint32_t is_crc_static_3_cached_valid:1;
 	uint32_t is_crc_static_7_cached_valid:1;
 	uint32_t uo_crc_type:4;
+	/** Whether the headers matched the header template of the context */
+	uint32_t is_hdr_tmpl_matching:1;
 
 	uint16_t innermost_ip_id_delta;
 
@@ -313,6 +316,12 @@ struct rohc_comp_rfc3095_ctxt
 	/** The cache for the CRC-7 value on CRC-STATIC fields */
 	uint8_t crc_static_7_cached;
 
+	/** The temporary state of the last compressed packet, re-used by the next
+	 *  packet if its headers match the header template */
+	struct rfc3095_tmp_state tmp;
+	/** The template of the uncompressed headers of the flow in SO state */
+	struct rohc_comp_hdr_tmpl hdr_tmpl;
+
 	/* below are some information and handlers to manage the next header
 	 * (if any) located just after the IP headers (1 or 2 IP headers) */
 
@@ -435,6 +444,19 @@ bool rohc_comp_rfc3095_feedback(struct rohc_comp_ctxt *const context,
                                 const size_t feedback_data_len)
 	__attribute__((warn_unused_result, nonnull(1, 3, 5)));
 
+bool rohc_comp_rfc3095_set_oa_repetitions(struct rohc_comp_ctxt *const context,
+                                          const uint8_t oa_repetitions_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+bool rohc_comp_rfc3095_set_oa_repetitions_wlsbs(struct rohc_comp_ctxt *const context,
+                                                const uint8_t oa_repetitions_nr,
+                                                struct c_wlsb *const profile_wlsbs[],
+                                                const size_t profile_wlsbs_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_comp_rfc3095_account_mem(const struct rohc_comp_ctxt *const context,
+                                   rohc_comp_profile_memory_usage_t *const usage)
+	__attribute__((nonnull(1, 2)));
+
 void rohc_get_ipid_bits(const struct rohc_comp_ctxt *const context,
                         const struct rfc3095_tmp_state *const changes,
                         bool *const innermost_ip_id_changed,
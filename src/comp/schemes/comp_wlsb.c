@@ -119,6 +119,127 @@ void wlsb_free(struct c_wlsb *const wlsb)
 }
 
 
+/**
+ * @brief Change the width of the windows of several W-LSB encoding objects
+ *
+ * The most recent entries of every window are kept. If a window grows, the
+ * oldest entry is duplicated to fill the new entries: the values the LSB
+ * encoding is based on are thus the same as before, so the decompressor
+ * is able to decode the next values as before.
+ *
+ * All the new windows are allocated before any W-LSB encoding object is
+ * modified: if one allocation fails, all the W-LSB encoding objects are
+ * left unchanged.
+ *
+ * @param[in,out] wlsbs  The W-LSB encoding objects to modify
+ * @param wlsbs_nr       The number of W-LSB encoding objects to modify,
+ *                       at most \ref ROHC_WLSB_SET_WIDTH_MAX_NR
+ * @param window_width   The new number of entries in the windows
+ * @return               true if the width of the windows was changed,
+ *                       false if none was changed
+ */
+bool wlsbs_set_width(struct c_wlsb *const wlsbs[],
+                     const size_t wlsbs_nr,
+                     const size_t window_width)
+{
+	struct c_window *windows[ROHC_WLSB_SET_WIDTH_MAX_NR];
+	size_t i;
+
+	assert(wlsbs_nr <= ROHC_WLSB_SET_WIDTH_MAX_NR);
+	assert(window_width > 0);
+	assert(window_width <= ROHC_WLSB_WIDTH_MAX);
+
+	if(wlsbs_nr > ROHC_WLSB_SET_WIDTH_MAX_NR)
+	{
+		goto error;
+	}
+
+	/* allocate and fill all the new windows first */
+	for(i = 0; i < wlsbs_nr; i++)
+	{
+		const struct c_wlsb *const wlsb = wlsbs[i];
+
+		if(window_width == wlsb->window_width)
+		{
+			windows[i] = NULL;
+			continue;
+		}
+
+		windows[i] = malloc(sizeof(struct c_window) * window_width);
+		if(windows[i] == NULL)
+		{
+			goto free_windows;
+		}
+
+		if(wlsb->count > 0)
+		{
+			size_t j;
+
+			/* copy the entries from the oldest one to the most recent one, the
+			 * next entry to write is the oldest one */
+			for(j = 0; j < window_width; j++)
+			{
+				size_t entry;
+
+				if((j + wlsb->window_width) < window_width)
+				{
+					entry = wlsb->next;
+				}
+				else
+				{
+					entry = (wlsb->next + wlsb->window_width + j - window_width) %
+					        wlsb->window_width;
+				}
+				windows[i][j] = wlsb->window[entry];
+			}
+		}
+	}
+
+	/* then replace the old windows, this cannot fail */
+	for(i = 0; i < wlsbs_nr; i++)
+	{
+		struct c_wlsb *const wlsb = wlsbs[i];
+
+		if(windows[i] == NULL)
+		{
+			continue;
+		}
+		if(wlsb->count > 0)
+		{
+			wlsb->count = window_width;
+		}
+		free(wlsb->window);
+		wlsb->window = windows[i];
+		wlsb->window_width = window_width;
+		wlsb->next = 0;
+	}
+
+	return true;
+
+free_windows:
+	while(i > 0)
+	{
+		i--;
+		free(windows[i]);
+	}
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the memory (in bytes) allocated for the window of a W-LSB
+ *        encoding object
+ *
+ * @param wlsb  The W-LSB object
+ * @return      The memory allocated for the window of the W-LSB object
+ */
+size_t wlsb_get_mem_size(const struct c_wlsb *const wlsb)
+{
+	return (sizeof(struct c_window) * wlsb->window_width);
+}
+
+
 /**
  * @brief Add a value into a W-LSB encoding object
  *
@@ -39,6 +39,9 @@
  * Public structures and types
  */
 
+/** The maximum number of W-LSB encoding objects resized at once */
+#define ROHC_WLSB_SET_WIDTH_MAX_NR  10U
+
 /**
  * @brief One W-LSB window entry
  */
@@ -105,6 +108,12 @@ bool wlsb_copy(struct c_wlsb *const dst,
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 void wlsb_free(struct c_wlsb *const wlsb)
 	__attribute__((nonnull(1)));
+bool wlsbs_set_width(struct c_wlsb *const wlsbs[],
+                     const size_t wlsbs_nr,
+                     const size_t window_width)
+	__attribute__((warn_unused_result, nonnull(1)));
+size_t wlsb_get_mem_size(const struct c_wlsb *const wlsb)
+	__attribute__((warn_unused_result, nonnull(1), pure));
 
 void c_add_wlsb(struct c_wlsb *const wlsb,
                 const uint32_t sn,
@@ -240,6 +240,16 @@ int main(int argc, char *argv[])
 	CHECK(rohc_comp_set_optimistic_approach(comp, 64) == true);
 	CHECK(rohc_comp_set_optimistic_approach(comp, 16) == true);
 
+	/* rohc_comp_set_optimistic_approach_adaptive() */
+	CHECK(rohc_comp_set_optimistic_approach_adaptive(NULL, 2, 8) == false);
+	CHECK(rohc_comp_set_optimistic_approach_adaptive(comp, 0, 8) == false);
+	CHECK(rohc_comp_set_optimistic_approach_adaptive(comp, 2, 0) == false);
+	CHECK(rohc_comp_set_optimistic_approach_adaptive(comp, 8, 2) == false);
+	CHECK(rohc_comp_set_optimistic_approach_adaptive(comp, 2, 256) == false);
+	CHECK(rohc_comp_set_optimistic_approach_adaptive(comp, 255, 255) == true);
+	CHECK(rohc_comp_set_optimistic_approach_adaptive(comp, 0, 0) == true);
+	CHECK(rohc_comp_set_optimistic_approach_adaptive(comp, 2, 8) == true);
+
 	/* rohc_comp_set_periodic_refreshes() */
 	CHECK(rohc_comp_set_periodic_refreshes(NULL, 1700, 700) == false);
 	CHECK(rohc_comp_set_periodic_refreshes(comp, 0, 700) == false);
@@ -254,6 +264,26 @@ int main(int argc, char *argv[])
 	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 5, 10) == false);
 	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 10, 5) == true);
 
+	/* rohc_comp_set_periodic_refreshes_jitter() */
+	CHECK(rohc_comp_set_periodic_refreshes_jitter(NULL, 100, 50) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_jitter(comp, 0, 0) == true);
+	CHECK(rohc_comp_set_periodic_refreshes_jitter(comp, 100, 50) == true);
+
+	/* rohc_comp_set_periodic_refreshes_jitter_time() */
+	CHECK(rohc_comp_set_periodic_refreshes_jitter_time(NULL, 100, 50) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_jitter_time(comp, UINT32_MAX, 50) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_jitter_time(comp, 100, UINT32_MAX) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_jitter_time(comp, 0, 0) == true);
+	CHECK(rohc_comp_set_periodic_refreshes_jitter_time(comp, 100, 50) == true);
+
+	/* rohc_comp_set_periodic_refreshes_rate() */
+	CHECK(rohc_comp_set_periodic_refreshes_rate(NULL, 10, 1000) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_rate(comp, 10, 0) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_rate(comp, 10, 3600000 + 1) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_rate(comp, 0, 0) == true);
+	CHECK(rohc_comp_set_periodic_refreshes_rate(comp, 10, 3600000) == true);
+	CHECK(rohc_comp_set_periodic_refreshes_rate(comp, 10, 1000) == true);
+
 	/* rohc_comp_set_rtp_detection_cb() */
 	{
 		rohc_rtp_detection_callback_t fct =
@@ -368,6 +398,9 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_last_packet_info2(comp, &info) == false);
 		info.version_minor = 0;
 		CHECK(rohc_comp_get_last_packet_info2(comp, &info) == true);
+		info.version_minor = 1;
+		CHECK(rohc_comp_get_last_packet_info2(comp, &info) == true);
+		CHECK(info.oa_repetitions_nr == 16);
 	}
 
 	/* rohc_comp_get_general_info() */
@@ -385,6 +418,45 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_general_info(comp, &info) == true);
 	}
 
+	/* rohc_comp_get_memory_usage() */
+	{
+		rohc_comp_general_info_t info;
+		rohc_comp_memory_usage_t usage;
+		size_t contexts_nr = 0;
+		size_t profiles_mem = 0;
+		size_t i;
+
+		memset(&usage, 0, sizeof(rohc_comp_memory_usage_t));
+		CHECK(rohc_comp_get_memory_usage(NULL, &usage) == false);
+		CHECK(rohc_comp_get_memory_usage(comp, NULL) == false);
+		usage.version_major = 0xffff;
+		CHECK(rohc_comp_get_memory_usage(comp, &usage) == false);
+		usage.version_major = 0;
+		usage.version_minor = 0xffff;
+		CHECK(rohc_comp_get_memory_usage(comp, &usage) == false);
+		usage.version_minor = 0;
+		CHECK(rohc_comp_get_memory_usage(comp, &usage) == true);
+
+		/* every context is accounted for in one profile */
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(usage.profiles_nr > 0);
+		CHECK(usage.profiles_nr <= ROHC_COMP_MEM_PROFILES_MAX);
+		for(i = 0; i < usage.profiles_nr; i++)
+		{
+			CHECK(usage.profiles[i].ip_ctxts_mem <= usage.profiles[i].specific_mem);
+			CHECK(usage.profiles[i].lists_mem <= usage.profiles[i].specific_mem);
+			CHECK(usage.profiles[i].contexts_nr > 0 || usage.profiles[i].specific_mem == 0);
+			contexts_nr += usage.profiles[i].contexts_nr;
+			profiles_mem += usage.profiles[i].specific_mem + usage.profiles[i].wlsb_mem;
+		}
+		CHECK(contexts_nr == info.contexts_nr);
+		CHECK(usage.comp_mem > 0);
+		CHECK(usage.contexts_mem > 0);
+		CHECK(usage.total_mem == (usage.comp_mem + usage.contexts_mem +
+		                          usage.rru_mem + profiles_mem));
+	}
+
 	/* rohc_comp_get_state_descr() */
 	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_IR), "IR") == 0);
 	CHECK(strcmp(rohc_comp_get_state_descr(ROHC_COMP_STATE_FO), "FO") == 0);
@@ -423,6 +495,7 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == false);
 
 		CHECK(rohc_comp_set_optimistic_approach(comp, 16) == false);
+		CHECK(rohc_comp_set_optimistic_approach_adaptive(comp, 2, 8) == false);
 
 		CHECK(rohc_comp_set_periodic_refreshes(comp, 10, 5) == false);
 	}
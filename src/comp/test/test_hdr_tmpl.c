@@ -0,0 +1,165 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_hdr_tmpl.c
+ * @brief   Test the templates of uncompressed headers
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_comp_hdr_tmpl.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Check the given condition, trace it and fail the test if it is false */
+#define CHECK(condition) \
+	do { \
+		if(!(condition)) { \
+			printf("%s:%d: check '%s' failed\n", __FILE__, __LINE__, \
+			       #condition); \
+			goto error; \
+		} \
+	} while(0)
+
+
+/**
+ * @brief Test the templates of uncompressed headers
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	struct rohc_comp_hdr_tmpl tmpl;
+	uint8_t hdrs[ROHC_COMP_HDR_TMPL_MAX_LEN + 1];
+	uint8_t pkt[ROHC_COMP_HDR_TMPL_MAX_LEN + 1];
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t len;
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the templates of uncompressed headers\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	for(i = 0; i < sizeof(hdrs); i++)
+	{
+		hdrs[i] = (uint8_t) (i * 7 + 3);
+	}
+
+	/* an invalid template matches nothing */
+	trace(verbose, "check invalid templates\n");
+	rohc_comp_hdr_tmpl_reset(&tmpl);
+	CHECK(!rohc_comp_hdr_tmpl_match(&tmpl, hdrs, 40));
+	CHECK(!rohc_comp_hdr_tmpl_set(&tmpl, hdrs, 0, 1));
+	CHECK(!rohc_comp_hdr_tmpl_match(&tmpl, hdrs, 0));
+	CHECK(!rohc_comp_hdr_tmpl_set(&tmpl, hdrs, ROHC_COMP_HDR_TMPL_MAX_LEN + 1, 1));
+	CHECK(!rohc_comp_hdr_tmpl_match(&tmpl, hdrs, ROHC_COMP_HDR_TMPL_MAX_LEN + 1));
+
+	/* for every length: the recorded headers match, any changed bit does not,
+	 * unless it was ignored, and headers of another length never match */
+	for(len = 1; len <= ROHC_COMP_HDR_TMPL_MAX_LEN; len++)
+	{
+		trace(verbose, "check %zu-byte template\n", len);
+
+		CHECK(rohc_comp_hdr_tmpl_set(&tmpl, hdrs, len, 42));
+		CHECK(tmpl.len == len);
+		CHECK(tmpl.sn == 42);
+		CHECK(rohc_comp_hdr_tmpl_match(&tmpl, hdrs, len));
+		CHECK(!rohc_comp_hdr_tmpl_match(&tmpl, hdrs, len - 1));
+		CHECK(!rohc_comp_hdr_tmpl_match(&tmpl, hdrs, len + 1));
+
+		for(i = 0; i < len; i++)
+		{
+			memcpy(pkt, hdrs, len);
+			pkt[i] ^= 0x01;
+			CHECK(!rohc_comp_hdr_tmpl_match(&tmpl, pkt, len));
+		}
+
+		/* ignore the low bit of the last byte only */
+		rohc_comp_hdr_tmpl_ignore_bits(&tmpl, len - 1, 0x01);
+		memcpy(pkt, hdrs, len);
+		pkt[len - 1] ^= 0x01;
+		CHECK(rohc_comp_hdr_tmpl_match(&tmpl, pkt, len));
+		pkt[len - 1] ^= 0x80;
+		CHECK(!rohc_comp_hdr_tmpl_match(&tmpl, pkt, len));
+
+		/* ignore one 16-bit field in the middle, fields are clamped to the
+		 * length of the template */
+		rohc_comp_hdr_tmpl_ignore(&tmpl, len / 2, sizeof(uint16_t));
+		memcpy(pkt, hdrs, len);
+		pkt[len / 2] = ~pkt[len / 2];
+		if((len / 2 + 1) < len)
+		{
+			pkt[len / 2 + 1] = ~pkt[len / 2 + 1];
+		}
+		CHECK(rohc_comp_hdr_tmpl_match(&tmpl, pkt, len));
+		if(len / 2 > 0)
+		{
+			pkt[0] ^= 0x10;
+			CHECK(!rohc_comp_hdr_tmpl_match(&tmpl, pkt, len));
+		}
+
+		/* fields after the end of the template are ignored */
+		rohc_comp_hdr_tmpl_ignore(&tmpl, len, sizeof(uint32_t));
+		rohc_comp_hdr_tmpl_ignore_bits(&tmpl, len, 0xff);
+		CHECK(rohc_comp_hdr_tmpl_match(&tmpl, hdrs, len));
+
+		/* headers are compared with the template, not with the mask */
+		CHECK(rohc_comp_hdr_tmpl_set(&tmpl, pkt, len, 43));
+		CHECK(rohc_comp_hdr_tmpl_match(&tmpl, pkt, len));
+		CHECK(!rohc_comp_hdr_tmpl_match(&tmpl, hdrs, len));
+
+		rohc_comp_hdr_tmpl_reset(&tmpl);
+		CHECK(!rohc_comp_hdr_tmpl_match(&tmpl, pkt, len));
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
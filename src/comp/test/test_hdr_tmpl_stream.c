@@ -0,0 +1,387 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_hdr_tmpl_stream.c
+ * @brief   Compress streams with and without the header templates
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The same IPv4/UDP and IPv4/UDP/RTP streams are compressed by two
+ * compressors. The header templates of the second compressor are
+ * invalidated before every packet, so the second compressor always runs
+ * the full change detection. The ROHC packets of both compressors shall be
+ * identical byte for byte.
+ *
+ * The streams are decompressed in O-mode and some of the ACKs are delivered
+ * to both compressors, so that the contexts run in O-mode with W-LSB windows
+ * that slide with every packet.
+ */
+
+#include "test_helpers.h"
+
+#include "rohc_comp_internals.h"
+#include "rohc_comp_rfc3095.h"
+
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+/** The number of packets per stream */
+#define TEST_PKTS_NR  3000U
+/** The length of the IPv4/UDP/RTP packets */
+#define TEST_IP_LEN  80U
+/** The maximum length of the ROHC packets and feedbacks */
+#define TEST_BUF_MAX_LEN  200U
+/** The UDP port of the RTP stream */
+#define TEST_RTP_PORT  5004U
+/** The number of Optimistic Approach repetitions, large enough for the
+ *  W-LSB windows to require more than 4 SN bits once they are full */
+#define TEST_OA_REPETITIONS  40U
+/** One ACK out of TEST_ACK_PERIOD is delivered to the compressors */
+#define TEST_ACK_PERIOD  70U
+
+
+static bool compress_stream(const bool verbose, const bool is_rtp)
+	__attribute__((warn_unused_result));
+
+static struct rohc_comp * create_comp(void)
+	__attribute__((warn_unused_result));
+
+static void invalidate_hdr_tmpls(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+
+static bool is_hdr_tmpl_matching(const struct rohc_comp *const comp)
+	__attribute__((nonnull(1), warn_unused_result));
+
+static void build_ip_pkt(uint8_t *const ip,
+                         const bool is_rtp,
+                         const size_t pkt_id)
+	__attribute__((nonnull(1)));
+
+static bool rtp_detect(const unsigned char *const ip,
+                       const unsigned char *const udp,
+                       const unsigned char *const payload,
+                       const unsigned int payload_size,
+                       void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Compress streams with and without the header templates
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(!test_parse_args(argc, argv, "compress streams with and without the "
+	                    "header templates", &verbose))
+	{
+		goto error;
+	}
+
+	trace(verbose, "IPv4/UDP stream\n");
+	CHECK(compress_stream(verbose, false));
+	trace(verbose, "IPv4/UDP/RTP stream\n");
+	CHECK(compress_stream(verbose, true));
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compress one stream with and without the header templates
+ *
+ * @param verbose  Whether to run in verbose mode or not
+ * @param is_rtp   Whether the stream is RTP or not
+ * @return         true if the ROHC packets are identical, false otherwise
+ */
+static bool compress_stream(const bool verbose, const bool is_rtp)
+{
+	struct rohc_comp *comp_tmpl = NULL;
+	struct rohc_comp *comp_ref = NULL;
+	struct rohc_decomp *decomp = NULL;
+	size_t tmpl_matches_nr = 0;
+	size_t acks_nr = 0;
+	bool is_success = false;
+	size_t i;
+
+	/* the same configuration for both compressors */
+	comp_tmpl = create_comp();
+	CHECK(comp_tmpl != NULL);
+	comp_ref = create_comp();
+	CHECK(comp_ref != NULL);
+
+	/* do not rate-limit ACKs, the test selects the ACKs to deliver */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	CHECK(decomp != NULL);
+	CHECK(rohc_decomp_enable_profiles(decomp, ROHCv1_PROFILE_IP_UDP,
+	                                  ROHCv1_PROFILE_IP_UDP_RTP, -1));
+	CHECK(rohc_decomp_set_rate_limits(decomp, 1, 1, 30, 100, 30, 100));
+
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		const struct rohc_ts ts = { .sec = i / 50, .nsec = (i % 50) * 20000000 };
+		uint8_t ip_data[TEST_IP_LEN];
+		const struct rohc_buf ip_pkt = rohc_buf_init_full(ip_data, TEST_IP_LEN, ts);
+		uint8_t rohc_tmpl_data[TEST_BUF_MAX_LEN];
+		struct rohc_buf rohc_tmpl =
+			rohc_buf_init_empty(rohc_tmpl_data, TEST_BUF_MAX_LEN);
+		uint8_t rohc_ref_data[TEST_BUF_MAX_LEN];
+		struct rohc_buf rohc_ref =
+			rohc_buf_init_empty(rohc_ref_data, TEST_BUF_MAX_LEN);
+		uint8_t decomp_data[TEST_BUF_MAX_LEN];
+		struct rohc_buf decomp_pkt =
+			rohc_buf_init_empty(decomp_data, TEST_BUF_MAX_LEN);
+		uint8_t feedback_data[TEST_BUF_MAX_LEN];
+		struct rohc_buf feedback =
+			rohc_buf_init_empty(feedback_data, TEST_BUF_MAX_LEN);
+
+		build_ip_pkt(ip_data, is_rtp, i);
+
+		CHECK(rohc_compress4(comp_tmpl, ip_pkt, &rohc_tmpl) == ROHC_STATUS_OK);
+		if(is_hdr_tmpl_matching(comp_tmpl))
+		{
+			tmpl_matches_nr++;
+		}
+		invalidate_hdr_tmpls(comp_ref);
+		CHECK(rohc_compress4(comp_ref, ip_pkt, &rohc_ref) == ROHC_STATUS_OK);
+
+		if(rohc_tmpl.len != rohc_ref.len ||
+		   memcmp(rohc_buf_data(rohc_tmpl), rohc_buf_data(rohc_ref),
+		          rohc_tmpl.len) != 0)
+		{
+			trace(verbose, "packet #%zu: %zu-byte ROHC packet with template, "
+			      "%zu-byte ROHC packet without template\n", i + 1,
+			      rohc_tmpl.len, rohc_ref.len);
+			CHECK(false);
+		}
+
+		/* the decompressor shall get the original packet back */
+		CHECK(rohc_decompress3(decomp, rohc_tmpl, &decomp_pkt, NULL,
+		                       &feedback) == ROHC_STATUS_OK);
+		CHECK(decomp_pkt.len == TEST_IP_LEN);
+		CHECK(memcmp(rohc_buf_data(decomp_pkt), ip_data, TEST_IP_LEN) == 0);
+
+		/* deliver one ACK out of TEST_ACK_PERIOD to both compressors */
+		if(feedback.len > 0 && (i % TEST_ACK_PERIOD) == 0)
+		{
+			CHECK(rohc_comp_deliver_feedback2(comp_tmpl, feedback));
+			CHECK(rohc_comp_deliver_feedback2(comp_ref, feedback));
+			acks_nr++;
+		}
+	}
+
+	trace(verbose, "\t%u packets, %zu matched the template, %zu feedbacks\n",
+	      TEST_PKTS_NR, tmpl_matches_nr, acks_nr);
+
+	/* the fast path shall be taken for most packets, and ACKs shall be
+	 * received several times */
+	CHECK(tmpl_matches_nr > (TEST_PKTS_NR / 2));
+	CHECK(acks_nr > 10);
+
+	is_success = true;
+
+error:
+	rohc_decomp_free(decomp);
+	rohc_comp_free(comp_ref);
+	rohc_comp_free(comp_tmpl);
+	return is_success;
+}
+
+
+/**
+ * @brief Create one compressor for the IPv4/UDP and IPv4/UDP/RTP profiles
+ *
+ * @return  The new compressor, NULL in case of failure
+ */
+static struct rohc_comp * create_comp(void)
+{
+	struct rohc_comp *comp;
+
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHCv1_PROFILE_IP_UDP,
+	                              ROHCv1_PROFILE_IP_UDP_RTP, -1) ||
+	   !rohc_comp_set_rtp_detection_cb(comp, rtp_detect, NULL) ||
+	   !rohc_comp_set_optimistic_approach(comp, TEST_OA_REPETITIONS))
+	{
+		goto free_comp;
+	}
+
+	return comp;
+
+free_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Invalidate the header templates of all the contexts
+ *
+ * @param comp  The compressor
+ */
+static void invalidate_hdr_tmpls(struct rohc_comp *const comp)
+{
+	size_t cid;
+
+	for(cid = 0; cid <= comp->medium.max_cid; cid++)
+	{
+		struct rohc_comp_ctxt *const ctxt = &(comp->contexts[cid]);
+
+		if(ctxt->used)
+		{
+			struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = ctxt->specific;
+			rohc_comp_hdr_tmpl_reset(&rfc3095_ctxt->hdr_tmpl);
+		}
+	}
+}
+
+
+/**
+ * @brief Whether the last packet matched the header template of its context
+ *
+ * @param comp  The compressor
+ * @return      true if the last packet matched a header template
+ */
+static bool is_hdr_tmpl_matching(const struct rohc_comp *const comp)
+{
+	const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
+
+	if(comp->last_context == NULL)
+	{
+		return false;
+	}
+	rfc3095_ctxt = comp->last_context->specific;
+
+	return !!rfc3095_ctxt->tmp.is_hdr_tmpl_matching;
+}
+
+
+/**
+ * @brief Build one IPv4/UDP or IPv4/UDP/RTP packet of the stream
+ *
+ * The IP-ID is sequential but jumps every 200 packets, and the RTP SN
+ * skips a few values every 300 packets as if packets were lost before the
+ * compressor.
+ *
+ * @param ip      The buffer for the packet
+ * @param is_rtp  Whether to build a RTP packet or not
+ * @param pkt_id  The ID of the packet in the stream
+ */
+static void build_ip_pkt(uint8_t *const ip,
+                         const bool is_rtp,
+                         const size_t pkt_id)
+{
+	const uint16_t ip_id = 1000 + pkt_id + (pkt_id / 200) * 40;
+	const uint16_t rtp_sn = 2000 + pkt_id + (pkt_id / 300) * 3;
+	const uint32_t rtp_ts = 160 * rtp_sn;
+	const uint16_t port = (is_rtp ? TEST_RTP_PORT : 4000);
+	size_t i;
+
+	memset(ip, 0, TEST_IP_LEN);
+
+	/* IPv4 header */
+	test_build_ipv4_hdr(ip, TEST_IP_LEN, 17, ip_id, 0xc0a80001, 0xc0a80102,
+	                    false);
+
+	/* UDP header without checksum */
+	ip[20] = (port >> 8) & 0xff;
+	ip[21] = port & 0xff;
+	ip[22] = (port >> 8) & 0xff;
+	ip[23] = port & 0xff;
+	ip[25] = TEST_IP_LEN - 20;
+
+	/* RTP header, or start of the UDP payload */
+	ip[28] = 0x80;
+	ip[29] = 0x00;
+	ip[30] = (rtp_sn >> 8) & 0xff;
+	ip[31] = rtp_sn & 0xff;
+	ip[32] = (rtp_ts >> 24) & 0xff;
+	ip[33] = (rtp_ts >> 16) & 0xff;
+	ip[34] = (rtp_ts >> 8) & 0xff;
+	ip[35] = rtp_ts & 0xff;
+	ip[39] = 0x42;
+
+	/* payload */
+	for(i = 40; i < TEST_IP_LEN; i++)
+	{
+		ip[i] = pkt_id + i;
+	}
+}
+
+
+/**
+ * @brief Detect the RTP stream by its UDP port
+ *
+ * @param ip            The innermost IP packet
+ * @param udp           The UDP header of the packet
+ * @param payload       The UDP payload of the packet
+ * @param payload_size  The size of the UDP payload (in bytes)
+ * @param rtp_private   Unused
+ * @return              true if the packet is RTP, false otherwise
+ */
+static bool rtp_detect(const unsigned char *const ip __attribute__((unused)),
+                       const unsigned char *const udp,
+                       const unsigned char *const payload __attribute__((unused)),
+                       const unsigned int payload_size __attribute__((unused)),
+                       void *const rtp_private __attribute__((unused)))
+{
+	const uint16_t dport = (udp[2] << 8) | udp[3];
+	return (dport == TEST_RTP_PORT);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * Both compressors shall get the same numbers to build the same packets.
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A constant number
+ */
+static int gen_random_num(const struct rohc_comp *const comp __attribute__((unused)),
+                          void *const user_context __attribute__((unused)))
+{
+	return 0;
+}
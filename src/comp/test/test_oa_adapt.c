@@ -0,0 +1,276 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_oa_adapt.c
+ * @brief   Test the adaptation of the Optimistic Approach repetitions
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * One IPv4/UDP stream is compressed in O-mode with adaptive Optimistic
+ * Approach repetitions, and all the feedbacks of the decompressor are
+ * delivered back to the compressor:
+ *  - while no packet is damaged, the decompressor sends ACKs only and the
+ *    context keeps the minimal number of repetitions,
+ *  - once some packets are damaged, the decompressor sends NACKs and the
+ *    number of repetitions and the width of the W-LSB windows grow,
+ *  - once packets are not damaged anymore, the ACKs and the packets without
+ *    any NACK make the number of repetitions and the width of the W-LSB
+ *    windows go back to the minimum.
+ */
+
+#include "test_helpers.h"
+
+#include "rohc_comp_internals.h"
+#include "rohc_comp_rfc3095.h"
+
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** The minimal number of Optimistic Approach repetitions */
+#define TEST_OA_MIN  2U
+/** The maximal number of Optimistic Approach repetitions */
+#define TEST_OA_MAX  16U
+/** The number of packets sent before and while packets are damaged */
+#define TEST_PKTS_NR  500U
+/** The number of packets sent after packets were damaged */
+#define TEST_RECOVERY_PKTS_NR  4000U
+/** One UO-0 packet out of TEST_DAMAGE_PERIOD is damaged */
+#define TEST_DAMAGE_PERIOD  10U
+/** The length of the IPv4/UDP packets */
+#define TEST_IP_LEN  60U
+/** The maximum length of the ROHC packets and feedbacks */
+#define TEST_BUF_MAX_LEN  200U
+
+
+/** The compressor, the decompressor and the stream between them */
+struct test_link
+{
+	struct rohc_comp *comp;     /**< The compressor */
+	struct rohc_decomp *decomp; /**< The decompressor */
+	size_t pkt_id;              /**< The ID of the next packet of the stream */
+	size_t acks_nr;             /**< The number of ACKs received */
+	size_t nacks_nr;            /**< The number of NACKs received */
+	uint8_t oa_max;             /**< The largest number of repetitions */
+};
+
+
+static bool send_pkts(const bool verbose,
+                      struct test_link *const link,
+                      const size_t pkts_nr,
+                      const bool damage)
+	__attribute__((nonnull(2), warn_unused_result));
+
+static bool is_oa_consistent(const struct rohc_comp_ctxt *const ctxt)
+	__attribute__((nonnull(1), warn_unused_result));
+
+
+/**
+ * @brief Test the adaptation of the Optimistic Approach repetitions
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	struct test_link link = {
+		.comp = NULL,
+		.decomp = NULL,
+		.pkt_id = 0,
+		.acks_nr = 0,
+		.nacks_nr = 0,
+		.oa_max = 0,
+	};
+	const struct rohc_comp_ctxt *ctxt;
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(!test_parse_args(argc, argv, "test the adaptation of the Optimistic "
+	                    "Approach repetitions", &verbose))
+	{
+		goto error;
+	}
+
+	link.comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                           test_gen_random_num, NULL);
+	CHECK(link.comp != NULL);
+	CHECK(rohc_comp_enable_profile(link.comp, ROHCv1_PROFILE_IP_UDP));
+	CHECK(rohc_comp_set_optimistic_approach(link.comp, TEST_OA_MIN));
+	CHECK(rohc_comp_set_optimistic_approach_adaptive(link.comp, TEST_OA_MIN,
+	                                                 TEST_OA_MAX));
+
+	/* send every feedback, the test delivers all of them to the compressor */
+	link.decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	CHECK(link.decomp != NULL);
+	CHECK(rohc_decomp_enable_profile(link.decomp, ROHCv1_PROFILE_IP_UDP));
+	CHECK(rohc_decomp_set_rate_limits(link.decomp, 32, 32, 1, 32, 1, 32));
+
+	/* no damaged packet: ACKs only, minimal number of repetitions */
+	trace(verbose, "no damaged packet:\n");
+	CHECK(send_pkts(verbose, &link, TEST_PKTS_NR, false));
+	ctxt = &(link.comp->contexts[0]);
+	CHECK(ctxt->used);
+	CHECK(ctxt->mode == ROHC_O_MODE);
+	CHECK(link.acks_nr > 0);
+	CHECK(link.nacks_nr == 0);
+	CHECK(link.oa_max == TEST_OA_MIN);
+	CHECK(is_oa_consistent(ctxt));
+
+	/* damaged packets: NACKs, more repetitions and larger W-LSB windows */
+	trace(verbose, "one UO-0 packet out of %u damaged:\n", TEST_DAMAGE_PERIOD);
+	CHECK(send_pkts(verbose, &link, TEST_PKTS_NR, true));
+	CHECK(link.nacks_nr > 0);
+	CHECK(link.oa_max > (TEST_OA_MIN + (TEST_OA_MAX - TEST_OA_MIN) / 2));
+	CHECK(ctxt->oa_repetitions_nr > TEST_OA_MIN);
+	CHECK(is_oa_consistent(ctxt));
+
+	/* no damaged packet anymore: no NACK, back to the minimal number of
+	 * repetitions and to the narrow W-LSB windows */
+	trace(verbose, "no damaged packet anymore:\n");
+	link.nacks_nr = 0;
+	CHECK(send_pkts(verbose, &link, TEST_RECOVERY_PKTS_NR, false));
+	CHECK(link.nacks_nr == 0);
+	CHECK(ctxt->oa_repetitions_nr == TEST_OA_MIN);
+	CHECK(is_oa_consistent(ctxt));
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	rohc_decomp_free(link.decomp);
+	rohc_comp_free(link.comp);
+	return is_failure;
+}
+
+
+/**
+ * @brief Send packets over the link and deliver all feedbacks back
+ *
+ * @param verbose  Whether to run in verbose mode or not
+ * @param link     The compressor, the decompressor and the stream
+ * @param pkts_nr  The number of packets to send
+ * @param damage   Whether to damage some UO-0 packets or not
+ * @return         true if the packets were sent successfully, false otherwise
+ */
+static bool send_pkts(const bool verbose,
+                      struct test_link *const link,
+                      const size_t pkts_nr,
+                      const bool damage)
+{
+	const size_t acks_nr = link->acks_nr;
+	const size_t nacks_nr = link->nacks_nr;
+	size_t damaged_nr = 0;
+	size_t i;
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		const size_t pkt_id = link->pkt_id++;
+		const struct rohc_ts ts = {
+			.sec = pkt_id / 50,
+			.nsec = (pkt_id % 50) * 20000000
+		};
+		uint8_t ip_data[TEST_IP_LEN];
+		const struct rohc_buf ip_pkt = rohc_buf_init_full(ip_data, TEST_IP_LEN, ts);
+		uint8_t rohc_data[TEST_BUF_MAX_LEN];
+		struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_data, TEST_BUF_MAX_LEN);
+		uint8_t decomp_data[TEST_BUF_MAX_LEN];
+		struct rohc_buf decomp_pkt =
+			rohc_buf_init_empty(decomp_data, TEST_BUF_MAX_LEN);
+		uint8_t feedback_data[TEST_BUF_MAX_LEN];
+		struct rohc_buf feedback =
+			rohc_buf_init_empty(feedback_data, TEST_BUF_MAX_LEN);
+		rohc_status_t status;
+
+		test_build_ipv4_udp_pkt(ip_data, TEST_IP_LEN, false, 0, pkt_id);
+		CHECK(rohc_compress4(link->comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+
+		/* damage the 3-bit CRC of some UO-0 packets */
+		if(damage && (pkt_id % TEST_DAMAGE_PERIOD) == 0 &&
+		   (rohc_buf_byte(rohc_pkt) & 0x80) == 0)
+		{
+			rohc_buf_byte(rohc_pkt) ^= 0x07;
+			damaged_nr++;
+		}
+
+		status = rohc_decompress3(link->decomp, rohc_pkt, &decomp_pkt, NULL,
+		                          &feedback);
+		if(!damage)
+		{
+			CHECK(status == ROHC_STATUS_OK);
+			CHECK(decomp_pkt.len == TEST_IP_LEN);
+			CHECK(memcmp(rohc_buf_data(decomp_pkt), ip_data, TEST_IP_LEN) == 0);
+		}
+
+		/* deliver the feedback to the compressor: the feedback header is 1
+		 * byte long if its Code field gives the length of the feedback data,
+		 * 2 bytes long otherwise, then FEEDBACK-2 for CID 0 starts with the
+		 * Acktype */
+		if(feedback.len > 0)
+		{
+			const size_t hdr_len = ((rohc_buf_byte(feedback) & 0x07) != 0 ? 1 : 2);
+
+			if(feedback.len > (hdr_len + 1) &&
+			   (rohc_buf_byte_at(feedback, hdr_len) >> 6) != 0)
+			{
+				link->nacks_nr++;
+			}
+			else
+			{
+				link->acks_nr++;
+			}
+			CHECK(rohc_comp_deliver_feedback2(link->comp, feedback));
+			link->oa_max = rohc_max(link->oa_max, link->comp->contexts[0].oa_repetitions_nr);
+		}
+	}
+
+	trace(verbose, "\t%zu packets, %zu damaged, %zu ACKs, %zu NACKs, "
+	      "%u repetitions (at most %u)\n", pkts_nr, damaged_nr,
+	      link->acks_nr - acks_nr, link->nacks_nr - nacks_nr,
+	      link->comp->contexts[0].oa_repetitions_nr, link->oa_max);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Whether the W-LSB windows of the context match its repetitions
+ *
+ * @param ctxt  The compression context
+ * @return      true if the W-LSB windows of the SN and of the IP-ID are as
+ *              wide as the number of repetitions of the context
+ */
+static bool is_oa_consistent(const struct rohc_comp_ctxt *const ctxt)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = ctxt->specific;
+
+	return (rfc3095_ctxt->sn_window.window_width == ctxt->oa_repetitions_nr &&
+	        rfc3095_ctxt->msn_non_acked.window_width == ctxt->oa_repetitions_nr &&
+	        rfc3095_ctxt->ip_ctxts[0].info.v4.ip_id_window.window_width ==
+	        ctxt->oa_repetitions_nr);
+}
@@ -0,0 +1,286 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_periodic_refreshes.c
+ * @brief   Test the jitter and the rate limit of periodic context refreshes
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Several U-mode flows are created at the same time and compressed in a
+ * round-robin way. The test records the packets at which every context
+ * moves downward for a periodic IR or FO refresh:
+ *  - without jitter nor rate limit, all contexts are refreshed in the same
+ *    round,
+ *  - with jitter, the refreshes of the contexts are spread over several
+ *    rounds, and the IR refreshes are never late,
+ *  - with a rate limit, the refreshes of all the contexts never exceed the
+ *    rate, so the refreshes are postponed, but every context is still
+ *    refreshed,
+ *  - with a rate limit and zero timestamps, the refreshes are limited by
+ *    packets instead of time, but they are never stopped.
+ */
+
+#include "test_helpers.h"
+
+#include "rohc_comp_internals.h"
+
+#include <rohc/rohc_comp.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** The number of flows, one per CID */
+#define TEST_FLOWS_NR  16U
+/** The number of packets per flow */
+#define TEST_PKTS_PER_FLOW  2000U
+/** The mean time between two packets of the channel (in us) */
+#define TEST_PKT_INTERVAL  1000U
+/** The IR timeout for periodic refreshes (in packets) */
+#define TEST_IR_TIMEOUT  200U
+/** The FO timeout for periodic refreshes (in packets) */
+#define TEST_FO_TIMEOUT  100U
+/** The length of the IPv4/UDP packets */
+#define TEST_IP_LEN  60U
+/** The maximum length of the ROHC packets */
+#define TEST_ROHC_MAX_LEN  200U
+
+
+/** The periodic refreshes observed during one run */
+struct test_refreshes
+{
+	/** The number of periodic refreshes started in every round */
+	size_t per_round[TEST_PKTS_PER_FLOW];
+	/** The number of periodic refreshes started by every context */
+	size_t per_flow[TEST_FLOWS_NR];
+	/** The total number of periodic refreshes */
+	size_t total_nr;
+	/** The time elapsed between the first and the last packets (in us) */
+	uint64_t duration;
+	/** The largest number of periodic refreshes started in one round */
+	size_t max_per_round;
+	/** The largest number of packets between two IR refreshes of one
+	 *  context, in packets of that context */
+	size_t max_ir_interval;
+	/** The smallest number of packets between two IR refreshes of one
+	 *  context, in packets of that context */
+	size_t min_ir_interval;
+};
+
+
+static bool run_flows(const bool verbose,
+                      const size_t ir_jitter,
+                      const size_t fo_jitter,
+                      const size_t max_refreshes,
+                      const uint64_t period,
+                      const bool with_time,
+                      struct test_refreshes *const refreshes)
+	__attribute__((nonnull(7), warn_unused_result));
+
+
+/**
+ * @brief Test the jitter and the rate limit of periodic context refreshes
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	static struct test_refreshes refreshes;
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t flow_id;
+
+	/* do we run in verbose mode ? */
+	if(!test_parse_args(argc, argv, "test the jitter and the rate limit of "
+	                    "periodic refreshes", &verbose))
+	{
+		goto error;
+	}
+
+	/* no jitter, no rate limit: the contexts created at the same time are
+	 * refreshed in lockstep */
+	trace(verbose, "no jitter, no rate limit:\n");
+	CHECK(run_flows(verbose, 0, 0, 0, 0, true, &refreshes));
+	CHECK(refreshes.max_per_round == TEST_FLOWS_NR);
+	CHECK(refreshes.max_ir_interval == refreshes.min_ir_interval);
+
+	/* jitter: the refreshes are spread over several rounds, every IR
+	 * timeout is shortened by at most the jitter */
+	trace(verbose, "IR jitter of %u packets, FO jitter of %u packets:\n",
+	      TEST_IR_TIMEOUT / 2, TEST_FO_TIMEOUT / 2);
+	CHECK(run_flows(verbose, TEST_IR_TIMEOUT / 2, TEST_FO_TIMEOUT / 2,
+	                0, 0, true, &refreshes));
+	CHECK(refreshes.max_per_round < (TEST_FLOWS_NR / 2));
+	CHECK(refreshes.max_ir_interval > refreshes.min_ir_interval);
+	CHECK(refreshes.min_ir_interval >= (TEST_IR_TIMEOUT / 2));
+	CHECK(refreshes.max_ir_interval <= (TEST_IR_TIMEOUT + TEST_FO_TIMEOUT));
+
+	/* rate limit of 3 refreshes per second: the token bucket holds up to
+	 * 3 refreshes and is refilled with 3 refreshes per second; all contexts
+	 * are always due for a refresh, so every token is used by the first
+	 * context that sends a packet after the refill */
+	trace(verbose, "at most 3 refreshes per second:\n");
+	CHECK(run_flows(verbose, 0, 0, 3, 1000, true, &refreshes));
+	CHECK(refreshes.max_per_round <= 3);
+	CHECK(refreshes.total_nr <= (3 + 3 * refreshes.duration / 1000000));
+	CHECK(refreshes.min_ir_interval > TEST_IR_TIMEOUT);
+	for(flow_id = 0; flow_id < TEST_FLOWS_NR; flow_id++)
+	{
+		CHECK(refreshes.per_flow[flow_id] > 0);
+	}
+
+	/* rate limit with zero timestamps: the time does not advance, so the
+	 * token bucket is refilled once every FO timeout counted in packets of
+	 * all the contexts, the refreshes are postponed but never stopped */
+	trace(verbose, "at most 3 refreshes per second, zero timestamps:\n");
+	CHECK(run_flows(verbose, 0, 0, 3, 1000, false, &refreshes));
+	CHECK(refreshes.max_per_round <= 3);
+	CHECK(refreshes.total_nr > 3);
+	CHECK(refreshes.total_nr <=
+	      (3 + 3 * TEST_FLOWS_NR * TEST_PKTS_PER_FLOW / TEST_FO_TIMEOUT));
+	CHECK(refreshes.min_ir_interval > TEST_IR_TIMEOUT);
+	for(flow_id = 0; flow_id < TEST_FLOWS_NR; flow_id++)
+	{
+		CHECK(refreshes.per_flow[flow_id] > 1);
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compress the flows and record their periodic refreshes
+ *
+ * @param verbose          Whether to run in verbose mode or not
+ * @param ir_jitter        The IR jitter (in packets)
+ * @param fo_jitter        The FO jitter (in packets)
+ * @param max_refreshes    The maximum number of refreshes per period
+ * @param period           The period for the rate limit (in ms)
+ * @param with_time        Whether the packets are given their arrival times
+ *                         or zero timestamps
+ * @param[out] refreshes   The periodic refreshes observed
+ * @return                 true if the flows were compressed successfully,
+ *                         false otherwise
+ */
+static bool run_flows(const bool verbose,
+                      const size_t ir_jitter,
+                      const size_t fo_jitter,
+                      const size_t max_refreshes,
+                      const uint64_t period,
+                      const bool with_time,
+                      struct test_refreshes *const refreshes)
+{
+	size_t last_ir_refresh[TEST_FLOWS_NR];
+	struct rohc_comp *comp;
+	bool is_success = false;
+	uint64_t time_us = 0;
+	size_t pkt_id;
+	size_t flow_id;
+
+	memset(refreshes, 0, sizeof(struct test_refreshes));
+	refreshes->min_ir_interval = SIZE_MAX;
+	srand(42);
+
+	comp = rohc_comp_new2(ROHC_SMALL_CID, TEST_FLOWS_NR - 1,
+	                      test_gen_random_num, NULL);
+	CHECK(comp != NULL);
+	CHECK(rohc_comp_enable_profile(comp, ROHCv1_PROFILE_IP_UDP));
+	CHECK(rohc_comp_set_periodic_refreshes(comp, TEST_IR_TIMEOUT, TEST_FO_TIMEOUT));
+	CHECK(rohc_comp_set_periodic_refreshes_jitter(comp, ir_jitter, fo_jitter));
+	CHECK(rohc_comp_set_periodic_refreshes_rate(comp, max_refreshes, period));
+
+	for(pkt_id = 0; pkt_id < TEST_PKTS_PER_FLOW; pkt_id++)
+	{
+		for(flow_id = 0; flow_id < TEST_FLOWS_NR; flow_id++)
+		{
+			const struct rohc_ts ts = {
+				.sec = (with_time ? time_us / 1000000 : 0),
+				.nsec = (with_time ? (time_us % 1000000) * 1000 : 0)
+			};
+			uint8_t ip_data[TEST_IP_LEN];
+			const struct rohc_buf ip_pkt =
+				rohc_buf_init_full(ip_data, TEST_IP_LEN, ts);
+			uint8_t rohc_data[TEST_ROHC_MAX_LEN];
+			struct rohc_buf rohc_pkt =
+				rohc_buf_init_empty(rohc_data, TEST_ROHC_MAX_LEN);
+			const struct rohc_comp_ctxt *const ctxt = &(comp->contexts[flow_id]);
+			const rohc_comp_state_t prev_state =
+				(ctxt->used ? ctxt->state : ROHC_COMP_STATE_UNKNOWN);
+
+			test_build_ipv4_udp_pkt(ip_data, TEST_IP_LEN, false, flow_id,
+			                        pkt_id);
+			CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			CHECK(ctxt->used);
+			CHECK(ctxt->cid == flow_id);
+
+			/* a periodic refresh moves the context downward: from SO to FO or
+			 * IR, or from FO to IR if the IR timeout expires during a FO
+			 * refresh */
+			if((prev_state == ROHC_COMP_STATE_SO && ctxt->state != ROHC_COMP_STATE_SO) ||
+			   (prev_state == ROHC_COMP_STATE_FO && ctxt->state == ROHC_COMP_STATE_IR))
+			{
+				refreshes->per_round[pkt_id]++;
+				refreshes->per_flow[flow_id]++;
+				refreshes->total_nr++;
+				if(ctxt->state == ROHC_COMP_STATE_IR)
+				{
+					if(last_ir_refresh[flow_id] > 0)
+					{
+						const size_t interval = pkt_id - last_ir_refresh[flow_id];
+						refreshes->min_ir_interval =
+							rohc_min(refreshes->min_ir_interval, interval);
+						refreshes->max_ir_interval =
+							rohc_max(refreshes->max_ir_interval, interval);
+					}
+					last_ir_refresh[flow_id] = pkt_id;
+				}
+			}
+			else if(pkt_id == 0)
+			{
+				last_ir_refresh[flow_id] = 0;
+			}
+
+			/* the packets do not arrive at a fixed rate, otherwise the tokens
+			 * of the rate limit are always refilled just before the packets of
+			 * the same contexts */
+			refreshes->duration = time_us;
+			time_us += rand() % (2 * TEST_PKT_INTERVAL + 1);
+		}
+		refreshes->max_per_round =
+			rohc_max(refreshes->max_per_round, refreshes->per_round[pkt_id]);
+	}
+
+	trace(verbose, "\t%zu refreshes, at most %zu refreshes per round, "
+	      "%zu to %zu packets between IR refreshes\n", refreshes->total_nr,
+	      refreshes->max_per_round, refreshes->min_ir_interval,
+	      refreshes->max_ir_interval);
+	is_success = true;
+
+error:
+	rohc_comp_free(comp);
+	return is_success;
+}
@@ -0,0 +1,445 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_tcp_pkt_types.c
+ * @brief   Test the selection of the TCP compressed packet formats
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "test_helpers.h"
+
+#include "c_tcp_pkt_types.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** One packet and the packet format expected for it */
+struct tcp_pkt_fmt_test
+{
+	const char *descr;      /**< The description of the packet */
+	uint32_t pkt_reqs;      /**< The requirements of the packet */
+	rohc_packet_t exp_seq;  /**< The format expected with sequential IP-ID */
+	rohc_packet_t exp_rnd;  /**< The format expected with random IP-ID */
+};
+
+
+static bool check_fmts_table(const struct tcp_pkt_fmt *const fmts,
+                             const size_t fmts_nr)
+	__attribute__((nonnull(1), warn_unused_result));
+
+static rohc_packet_t decide_seq(const uint32_t reqs)
+	__attribute__((warn_unused_result, const));
+static rohc_packet_t decide_rnd(const uint32_t reqs)
+	__attribute__((warn_unused_result, const));
+
+
+/** Whether the packet has the given requirement(s) or not */
+#define HAS(req) ((reqs & (req)) != 0)
+
+
+/**
+ * @brief Test the selection of the TCP compressed packet formats
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	const struct tcp_pkt_fmt_test tests[] = {
+		{
+			"nothing changed",
+			0,
+			ROHC_PACKET_TCP_SEQ_2, ROHC_PACKET_TCP_RND_2
+		},
+		{
+			"new data, ACK flag unset",
+			TCP_REQ_SEQ_CHANGED | TCP_REQ_ACK_FLAG_UNSET,
+			ROHC_PACKET_TCP_SEQ_2, ROHC_PACKET_TCP_RND_2
+		},
+		{
+			"new data, sequence number not scalable",
+			TCP_REQ_SEQ_CHANGED | TCP_REQ_SEQ_SCALED_NOT_LSB_4_7 |
+			TCP_REQ_ACK_SCALED_NOT_LSB_4_3,
+			ROHC_PACKET_TCP_SEQ_1, ROHC_PACKET_TCP_RND_1
+		},
+		{
+			"pure ACK",
+			TCP_REQ_ACK_CHANGED | TCP_REQ_ACK_USED,
+			ROHC_PACKET_TCP_SEQ_4, ROHC_PACKET_TCP_RND_4
+		},
+		{
+			"pure ACK, ACK number not scalable",
+			TCP_REQ_ACK_CHANGED | TCP_REQ_ACK_USED |
+			TCP_REQ_ACK_SCALED_NOT_LSB_4_3,
+			ROHC_PACKET_TCP_SEQ_3, ROHC_PACKET_TCP_RND_3
+		},
+		{
+			"new data and ACK",
+			TCP_REQ_SEQ_CHANGED | TCP_REQ_ACK_CHANGED | TCP_REQ_ACK_USED,
+			ROHC_PACKET_TCP_SEQ_6, ROHC_PACKET_TCP_RND_6
+		},
+		{
+			"new data and ACK, sequence number not scalable",
+			TCP_REQ_SEQ_CHANGED | TCP_REQ_ACK_CHANGED | TCP_REQ_ACK_USED |
+			TCP_REQ_SEQ_SCALED_NOT_LSB_4_7 | TCP_REQ_ACK_SCALED_NOT_LSB_4_3,
+			ROHC_PACKET_TCP_SEQ_5, ROHC_PACKET_TCP_RND_5
+		},
+		{
+			"window changed",
+			TCP_REQ_WINDOW_CHANGED,
+			ROHC_PACKET_TCP_SEQ_7, ROHC_PACKET_TCP_RND_7
+		},
+		{
+			"window changed with new data",
+			TCP_REQ_WINDOW_CHANGED | TCP_REQ_SEQ_CHANGED,
+			ROHC_PACKET_TCP_CO_COMMON, ROHC_PACKET_TCP_CO_COMMON
+		},
+		{
+			"7-bit CRC required",
+			TCP_REQ_CRC7,
+			ROHC_PACKET_TCP_SEQ_8, ROHC_PACKET_TCP_RND_8
+		},
+		{
+			"SYN flag",
+			TCP_REQ_RSF_OPTS,
+			ROHC_PACKET_TCP_SEQ_8, ROHC_PACKET_TCP_RND_8
+		},
+		{
+			"SYN flag, TTL too far from context",
+			TCP_REQ_RSF_OPTS | TCP_REQ_TTL_NOT_LSB_3_3,
+			ROHC_PACKET_TCP_CO_COMMON, ROHC_PACKET_TCP_RND_8
+		},
+		{
+			"TTL changed",
+			TCP_REQ_TTL_ECN_CHANGED,
+			ROHC_PACKET_TCP_SEQ_8, ROHC_PACKET_TCP_RND_8
+		},
+		{
+			"TTL changed too much",
+			TCP_REQ_TTL_ECN_CHANGED | TCP_REQ_TTL_NOT_LSB_3_3,
+			ROHC_PACKET_TCP_CO_COMMON, ROHC_PACKET_TCP_CO_COMMON
+		},
+		{
+			"window changed and 7-bit CRC required",
+			TCP_REQ_WINDOW_CHANGED | TCP_REQ_CRC7,
+			ROHC_PACKET_TCP_CO_COMMON, ROHC_PACKET_TCP_CO_COMMON
+		},
+		{
+			"field only transmitted by co_common",
+			TCP_REQ_CO_COMMON,
+			ROHC_PACKET_TCP_CO_COMMON, ROHC_PACKET_TCP_CO_COMMON
+		},
+		{
+			"every requirement",
+			TCP_REQ_ALL,
+			ROHC_PACKET_TCP_CO_COMMON, ROHC_PACKET_TCP_CO_COMMON
+		},
+	};
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	uint32_t reqs;
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(!test_parse_args(argc, argv, "test the selection of the TCP "
+	                    "compressed packet formats", &verbose))
+	{
+		goto error;
+	}
+
+	/* check the consistency of the tables of packet formats */
+	trace(verbose, "check the table of seq_X packet formats\n");
+	CHECK(check_fmts_table(tcp_pkt_fmts_seq, tcp_pkt_fmts_seq_nr));
+	trace(verbose, "check the table of rnd_X packet formats\n");
+	CHECK(check_fmts_table(tcp_pkt_fmts_rnd, tcp_pkt_fmts_rnd_nr));
+
+	/* check the selection for some typical packets */
+	for(i = 0; i < (sizeof(tests) / sizeof(struct tcp_pkt_fmt_test)); i++)
+	{
+		const rohc_packet_t seq =
+			tcp_pkt_fmt_select(tcp_pkt_fmts_seq, tcp_pkt_fmts_seq_nr,
+			                   tests[i].pkt_reqs);
+		const rohc_packet_t rnd =
+			tcp_pkt_fmt_select(tcp_pkt_fmts_rnd, tcp_pkt_fmts_rnd_nr,
+			                   tests[i].pkt_reqs);
+
+		trace(verbose, "%s (0x%08x): %s / %s\n", tests[i].descr,
+		      tests[i].pkt_reqs, rohc_get_packet_descr(seq),
+		      rohc_get_packet_descr(rnd));
+		CHECK(seq == tests[i].exp_seq);
+		CHECK(rnd == tests[i].exp_rnd);
+	}
+
+	/* check that the tables select the same formats as the decision ladders
+	 * for every combination of requirements */
+	trace(verbose, "compare the tables with the decision ladders\n");
+	for(reqs = 0; reqs <= TCP_REQ_ALL; reqs++)
+	{
+		CHECK(tcp_pkt_fmt_select(tcp_pkt_fmts_seq, tcp_pkt_fmts_seq_nr, reqs) ==
+		      decide_seq(reqs));
+		CHECK(tcp_pkt_fmt_select(tcp_pkt_fmts_rnd, tcp_pkt_fmts_rnd_nr, reqs) ==
+		      decide_rnd(reqs));
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Check the consistency of one table of packet formats
+ *
+ * @param fmts     The table of packet formats
+ * @param fmts_nr  The number of packet formats in the table
+ * @return         true if the table is consistent, false otherwise
+ */
+static bool check_fmts_table(const struct tcp_pkt_fmt *const fmts,
+                             const size_t fmts_nr)
+{
+	uint32_t req;
+	size_t i;
+
+	/* co_common is the last format and it fulfills every requirement */
+	CHECK(fmts_nr > 1);
+	CHECK(fmts[fmts_nr - 1].type == ROHC_PACKET_TCP_CO_COMMON);
+	CHECK(fmts[fmts_nr - 1].conds == 0);
+	CHECK(fmts[fmts_nr - 1].caps == TCP_REQ_ALL);
+
+	for(i = 0; i < (fmts_nr - 1); i++)
+	{
+		const bool is_crc7 = (fmts[i].type == ROHC_PACKET_TCP_SEQ_8 ||
+		                      fmts[i].type == ROHC_PACKET_TCP_RND_8);
+
+		/* no format is able to fulfill all requirements but co_common */
+		CHECK((fmts[i].caps & TCP_REQ_CO_COMMON) == 0);
+		CHECK(fmts[i].caps != TCP_REQ_ALL);
+		/* a format is considered only for requirements it fulfills */
+		CHECK((fmts[i].caps & fmts[i].conds) == fmts[i].conds);
+		/* only the formats with 7-bit CRC transmit the TTL, the flags and
+		 * the list of TCP options */
+		CHECK(((fmts[i].caps & TCP_REQ_CRC7) != 0) == is_crc7);
+		CHECK((fmts[i].caps & TCP_REQ_RSF_OPTS) == 0 || is_crc7);
+		CHECK((fmts[i].caps & TCP_REQ_TTL_ECN_CHANGED) == 0 || is_crc7);
+	}
+
+	/* every single requirement is fulfilled by the selected format */
+	for(req = 1; req <= TCP_REQ_ALL; req <<= 1)
+	{
+		const rohc_packet_t type = tcp_pkt_fmt_select(fmts, fmts_nr, req);
+
+		for(i = 0; i < fmts_nr && fmts[i].type != type; i++)
+		{
+		}
+		CHECK(i < fmts_nr);
+		CHECK((fmts[i].caps & req) == req);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decide which seq_X packet format to use as the decision ladder does
+ *
+ * @param reqs  The requirements of the packet
+ * @return      The packet type among ROHC_PACKET_TCP_SEQ_[1-8] and
+ *              ROHC_PACKET_TCP_CO_COMMON
+ */
+static rohc_packet_t decide_seq(const uint32_t reqs)
+{
+	const bool seq_8_possible =
+		!HAS(TCP_REQ_IP_ID_NOT_LSB_4_3 | TCP_REQ_SEQ_NOT_LSB_14_8191 |
+		     TCP_REQ_ACK_NOT_LSB_15_8191);
+
+	if(HAS(TCP_REQ_CO_COMMON))
+	{
+		return ROHC_PACKET_TCP_CO_COMMON;
+	}
+	else if(HAS(TCP_REQ_TTL_ECN_CHANGED))
+	{
+		if(seq_8_possible &&
+		   !HAS(TCP_REQ_TTL_NOT_LSB_3_3 | TCP_REQ_WINDOW_CHANGED))
+		{
+			return ROHC_PACKET_TCP_SEQ_8;
+		}
+		return ROHC_PACKET_TCP_CO_COMMON;
+	}
+	else if(!HAS(TCP_REQ_RSF_OPTS | TCP_REQ_WINDOW_CHANGED | TCP_REQ_ACK_USED |
+	             TCP_REQ_CRC7 | TCP_REQ_IP_ID_NOT_LSB_7_3 |
+	             TCP_REQ_SEQ_SCALED_NOT_LSB_4_7))
+	{
+		return ROHC_PACKET_TCP_SEQ_2;
+	}
+	else if(HAS(TCP_REQ_RSF_OPTS))
+	{
+		if(seq_8_possible &&
+		   !HAS(TCP_REQ_TTL_NOT_LSB_3_3 | TCP_REQ_WINDOW_CHANGED))
+		{
+			return ROHC_PACKET_TCP_SEQ_8;
+		}
+		return ROHC_PACKET_TCP_CO_COMMON;
+	}
+	else if(HAS(TCP_REQ_WINDOW_CHANGED))
+	{
+		if(!HAS(TCP_REQ_CRC7 | TCP_REQ_WINDOW_NOT_LSB_15_16383 |
+		        TCP_REQ_IP_ID_NOT_LSB_5_3 | TCP_REQ_ACK_NOT_LSB_16_32767 |
+		        TCP_REQ_SEQ_CHANGED))
+		{
+			return ROHC_PACKET_TCP_SEQ_7;
+		}
+		return ROHC_PACKET_TCP_CO_COMMON;
+	}
+	else if(!HAS(TCP_REQ_ACK_USED))
+	{
+		if(!HAS(TCP_REQ_CRC7 | TCP_REQ_IP_ID_NOT_LSB_4_3 |
+		        TCP_REQ_SEQ_NOT_LSB_16_32767))
+		{
+			return ROHC_PACKET_TCP_SEQ_1;
+		}
+		else if(seq_8_possible)
+		{
+			return ROHC_PACKET_TCP_SEQ_8;
+		}
+		return ROHC_PACKET_TCP_CO_COMMON;
+	}
+	else if(!HAS(TCP_REQ_SEQ_CHANGED))
+	{
+		if(!HAS(TCP_REQ_CRC7 | TCP_REQ_IP_ID_NOT_LSB_3_1 |
+		        TCP_REQ_ACK_SCALED_NOT_LSB_4_3))
+		{
+			return ROHC_PACKET_TCP_SEQ_4;
+		}
+		else if(!HAS(TCP_REQ_CRC7 | TCP_REQ_IP_ID_NOT_LSB_4_3 |
+		             TCP_REQ_ACK_NOT_LSB_16_16383))
+		{
+			return ROHC_PACKET_TCP_SEQ_3;
+		}
+		else if(seq_8_possible)
+		{
+			return ROHC_PACKET_TCP_SEQ_8;
+		}
+		return ROHC_PACKET_TCP_CO_COMMON;
+	}
+	else if(!HAS(TCP_REQ_IP_ID_NOT_LSB_4_3))
+	{
+		if(!HAS(TCP_REQ_CRC7 | TCP_REQ_SEQ_SCALED_NOT_LSB_4_7 |
+		        TCP_REQ_ACK_NOT_LSB_16_16383))
+		{
+			return ROHC_PACKET_TCP_SEQ_6;
+		}
+		else if(!HAS(TCP_REQ_CRC7 | TCP_REQ_ACK_NOT_LSB_16_16383 |
+		             TCP_REQ_SEQ_NOT_LSB_16_32767))
+		{
+			return ROHC_PACKET_TCP_SEQ_5;
+		}
+		else if(seq_8_possible && !HAS(TCP_REQ_TTL_NOT_LSB_3_3))
+		{
+			return ROHC_PACKET_TCP_SEQ_8;
+		}
+		return ROHC_PACKET_TCP_CO_COMMON;
+	}
+
+	return ROHC_PACKET_TCP_CO_COMMON;
+}
+
+
+/**
+ * @brief Decide which rnd_X packet format to use as the decision ladder does
+ *
+ * @param reqs  The requirements of the packet
+ * @return      The packet type among ROHC_PACKET_TCP_RND_[1-8] and
+ *              ROHC_PACKET_TCP_CO_COMMON
+ */
+static rohc_packet_t decide_rnd(const uint32_t reqs)
+{
+	const bool rnd_8_possible =
+		!HAS(TCP_REQ_WINDOW_CHANGED | TCP_REQ_SEQ_NOT_LSB_16_65535 |
+		     TCP_REQ_ACK_NOT_LSB_16_16383);
+
+	if(HAS(TCP_REQ_CO_COMMON))
+	{
+		return ROHC_PACKET_TCP_CO_COMMON;
+	}
+	else if(HAS(TCP_REQ_TTL_ECN_CHANGED))
+	{
+		if(rnd_8_possible && !HAS(TCP_REQ_TTL_NOT_LSB_3_3))
+		{
+			return ROHC_PACKET_TCP_RND_8;
+		}
+		return ROHC_PACKET_TCP_CO_COMMON;
+	}
+	else if(!HAS(TCP_REQ_RSF_OPTS | TCP_REQ_WINDOW_CHANGED | TCP_REQ_CRC7 |
+	             TCP_REQ_ACK_CHANGED | TCP_REQ_SEQ_SCALED_NOT_LSB_4_7))
+	{
+		return ROHC_PACKET_TCP_RND_2;
+	}
+	else if(HAS(TCP_REQ_RSF_OPTS))
+	{
+		return (rnd_8_possible ? ROHC_PACKET_TCP_RND_8 : ROHC_PACKET_TCP_CO_COMMON);
+	}
+	else if(HAS(TCP_REQ_WINDOW_CHANGED))
+	{
+		if(!HAS(TCP_REQ_CRC7 | TCP_REQ_SEQ_CHANGED | TCP_REQ_ACK_NOT_LSB_18_65535))
+		{
+			return ROHC_PACKET_TCP_RND_7;
+		}
+		return ROHC_PACKET_TCP_CO_COMMON;
+	}
+	else if(!HAS(TCP_REQ_CRC7 | TCP_REQ_ACK_FLAG_UNSET |
+	             TCP_REQ_ACK_SCALED_NOT_LSB_4_3 | TCP_REQ_SEQ_CHANGED))
+	{
+		return ROHC_PACKET_TCP_RND_4;
+	}
+	else if(!HAS(TCP_REQ_CRC7 | TCP_REQ_ACK_FLAG_UNSET | TCP_REQ_SEQ_CHANGED |
+	             TCP_REQ_ACK_NOT_LSB_15_8191))
+	{
+		return ROHC_PACKET_TCP_RND_3;
+	}
+	else if(!HAS(TCP_REQ_CRC7 | TCP_REQ_SEQ_NOT_LSB_18_65535 |
+	             TCP_REQ_ACK_CHANGED))
+	{
+		return ROHC_PACKET_TCP_RND_1;
+	}
+	else if(!HAS(TCP_REQ_CRC7 | TCP_REQ_ACK_FLAG_UNSET |
+	             TCP_REQ_SEQ_SCALED_NOT_LSB_4_7 | TCP_REQ_ACK_NOT_LSB_16_16383))
+	{
+		return ROHC_PACKET_TCP_RND_6;
+	}
+	else if(!HAS(TCP_REQ_CRC7 | TCP_REQ_ACK_FLAG_UNSET |
+	             TCP_REQ_SEQ_NOT_LSB_14_8191 | TCP_REQ_ACK_NOT_LSB_15_8191))
+	{
+		return ROHC_PACKET_TCP_RND_5;
+	}
+	else if(rnd_8_possible)
+	{
+		return ROHC_PACKET_TCP_RND_8;
+	}
+
+	return ROHC_PACKET_TCP_CO_COMMON;
+}
@@ -64,9 +64,8 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 static int esp_parse_static_esp(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *packet,
@@ -189,7 +188,7 @@ free_outer_ip_changes_next_header:
 free_esp_context:
 	zfree(esp_context);
 destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -202,10 +201,8 @@ quit:
  * framework to work.
  *
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
  */
-static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
 	/* clean ESP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
@@ -214,7 +211,7 @@ static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
 	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 }
 
 
@@ -413,6 +410,10 @@ const struct rohc_decomp_profile d_esp_profile =
 {
 	.id              = ROHC_PROFILE_ESP, /* profile ID (RFC 3095, §8) */
 	.msn_max_bits    = 32,
+	.persist_ctxt_size   = ROHC_DECOMP_RFC3095_CTXT_SIZE + sizeof(struct d_esp_context) +
+	                       2 * sizeof(struct esphdr),
+	.extr_bits_size      = sizeof(struct rohc_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_esp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_esp_destroy,
 	.detect_pkt_type = ip_detect_packet_type,
@@ -45,9 +45,8 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                         const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 
 /**
@@ -105,12 +104,10 @@ quit:
  * framework to work.
  *
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
  */
-static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                         const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 }
 
 
@@ -126,7 +123,7 @@ static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
 rohc_packet_t ip_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                     const uint8_t *const rohc_packet,
                                     const size_t rohc_length,
-                                    const size_t large_cid_len __attribute__((unused)))
+                                    const size_t large_cid_len)
 {
 	rohc_packet_t type;
 
@@ -137,37 +134,15 @@ rohc_packet_t ip_detect_packet_type(const struct rohc_decomp_ctxt *const context
 	rohc_decomp_debug(context, "try to determine the header from first byte "
 	                  "0x%02x", rohc_packet[0]);
 
-	if(rohc_decomp_packet_is_uo0(rohc_packet, rohc_length))
-	{
-		/* UO-0 packet */
-		type = ROHC_PACKET_UO_0;
-	}
-	else if(rohc_decomp_packet_is_uo1(rohc_packet, rohc_length))
-	{
-		/* UO-1 packet */
-		type = ROHC_PACKET_UO_1;
-	}
-	else if(rohc_decomp_packet_is_uor2(rohc_packet, rohc_length))
-	{
-		/* UOR-2 packet */
-		type = ROHC_PACKET_UOR_2;
-	}
-	else if(rohc_decomp_packet_is_irdyn(rohc_packet, rohc_length))
-	{
-		/* IR-DYN packet */
-		type = ROHC_PACKET_IR_DYN;
-	}
-	else if(rohc_decomp_packet_is_ir(rohc_packet, rohc_length))
-	{
-		/* IR packet */
-		type = ROHC_PACKET_IR;
-	}
-	else
+	/* UO-0, UO-1, UOR-2, IR-DYN or IR packet */
+	type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RFC3095,
+	                                       rohc_packet, rohc_length, large_cid_len);
+	if(type == ROHC_PACKET_UNKNOWN)
 	{
 		/* unknown packet */
 		rohc_decomp_warn(context, "failed to recognize the packet type in byte "
-		                 "0x%02x", rohc_packet[0]);
-		type = ROHC_PACKET_UNKNOWN;
+		                 "0x%02x of the %zu-byte packet", rohc_packet[0],
+		                 rohc_length);
 	}
 
 	return type;
@@ -521,6 +496,9 @@ const struct rohc_decomp_profile d_ip_profile =
 {
 	.id              = ROHC_PROFILE_IP, /* profile ID (see 5 in RFC 3843) */
 	.msn_max_bits    = 16,
+	.persist_ctxt_size   = ROHC_DECOMP_RFC3095_CTXT_SIZE,
+	.extr_bits_size      = sizeof(struct rohc_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_ip_create,
 	.free_context    = (rohc_decomp_free_context_t) d_ip_destroy,
 	.detect_pkt_type = ip_detect_packet_type,
@@ -72,9 +72,8 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
@@ -82,16 +81,8 @@ static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const
                                             const size_t large_cid_len)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static rohc_packet_t rtp_choose_uo1_variant(const struct rohc_decomp_ctxt *const context,
-                                            const uint8_t *const packet,
-                                            const size_t rohc_length)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
-
-static rohc_packet_t rtp_choose_uor2_variant(const struct rohc_decomp_ctxt *const context,
-                                             const uint8_t *const packet,
-                                             const size_t rohc_length,
-                                             const size_t large_cid_len)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
+static rohc_decomp_pkt_table_t rtp_choose_pkt_table(const struct rohc_decomp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
 
 static int rtp_parse_static_rtp(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *packet,
@@ -261,7 +252,7 @@ free_outer_ip_changes_next_header:
 free_rtp_context:
 	zfree(rtp_context);
 destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -274,10 +265,8 @@ quit:
  * framework to work.
  *
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
  */
-static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
 	/* clean UDP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
@@ -286,7 +275,7 @@ static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
 	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 }
 
 
@@ -313,138 +302,25 @@ static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const
 	rohc_decomp_debug(context, "try to determine the header from first byte "
 	                  "0x%02x", rohc_packet[0]);
 
-	if(rohc_decomp_packet_is_uo0(rohc_packet, rohc_length))
-	{
-		/* UO-0 packet */
-		type = ROHC_PACKET_UO_0;
-	}
-	else if(rohc_decomp_packet_is_uo1(rohc_packet, rohc_length))
-	{
-		/* choose between the UO-1-RTP, UO-1-ID, and UO-1-TS variants */
-		type = rtp_choose_uo1_variant(context, rohc_packet, rohc_length);
-	}
-	else if(rohc_decomp_packet_is_uor2(rohc_packet, rohc_length))
-	{
-		/* choose between the UOR-2-RTP, UOR-2-ID, and UOR-2-TS variants */
-		type = rtp_choose_uor2_variant(context, rohc_packet, rohc_length,
-		                               large_cid_len);
-	}
-	else if(rohc_decomp_packet_is_irdyn(rohc_packet, rohc_length))
+	/* the context tells which variants of the UO-1* and UOR-2* packets may be
+	 * used, the first byte tells the rest */
+	type = rohc_decomp_pkt_type_from_table(rtp_choose_pkt_table(context),
+	                                       rohc_packet, rohc_length, large_cid_len);
+	if(type == ROHC_PACKET_UOR_2_ID &&
+	   rohc_decomp_packet_is_uor2_ts(rohc_packet, rohc_length, large_cid_len))
 	{
-		/* IR-DYN packet */
-		type = ROHC_PACKET_IR_DYN;
+		/* UOR-2-ID or UOR-2-TS packet, the T field is in the 2nd byte */
+		rohc_decomp_debug(context, "UOR-2* packet disambiguation: T = 1, "
+		                  "so try parsing as UOR-2-TS, and fallback on "
+		                  "UOR-2-RTP later if value(RND) = 1 in packet");
+		type = ROHC_PACKET_UOR_2_TS;
 	}
-	else if(rohc_decomp_packet_is_ir(rohc_packet, rohc_length))
-	{
-		/* IR packet */
-		type = ROHC_PACKET_IR;
-	}
-	else
+	else if(type == ROHC_PACKET_UNKNOWN)
 	{
 		/* unknown packet */
 		rohc_decomp_warn(context, "failed to recognize the packet type in byte "
-		                 "0x%02x", rohc_packet[0]);
-		type = ROHC_PACKET_UNKNOWN;
-	}
-
-	return type;
-}
-
-
-/**
- * @brief Choose between UO-1-RTP, UO-1-TS, and UO-1-ID variants
- *
- * This function is useful to choose which packet type to try to parse in the
- * UO-1* families.
- *
- * @param context        The decompression context
- * @param packet         The ROHC packet
- * @param rohc_length    The length of the ROHC packet
- * @return               The packet type
- */
-static rohc_packet_t rtp_choose_uo1_variant(const struct rohc_decomp_ctxt *const context,
-                                            const uint8_t *const packet,
-                                            const size_t rohc_length)
-{
-	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-	rohc_packet_t type;
-	size_t nr_ipv4_non_rnd;
-	size_t nr_ipv4;
-
-	/* compute the number of IPv4 headers, and IPv4 with context(RND) = 0 */
-	nr_ipv4 = 0;
-	nr_ipv4_non_rnd = 0;
-	if(is_outer_ipv4_ctxt(rfc3095_ctxt))
-	{
-		nr_ipv4++;
-		if(!is_outer_ipv4_rnd_ctxt(rfc3095_ctxt))
-		{
-			nr_ipv4_non_rnd++;
-		}
-	}
-	if(is_inner_ipv4_ctxt(rfc3095_ctxt))
-	{
-		nr_ipv4++;
-		if(!is_inner_ipv4_rnd_ctxt(rfc3095_ctxt))
-		{
-			nr_ipv4_non_rnd++;
-		}
-	}
-
-	/* There is no easy way to disambiguate UO-1-ID/TS and UO-1-RTP
-	 * packets. The following algorithm is based on notes you may
-	 * read in RFC 3095, section 5.7.3:
-	 *  - UO-1-RTP cannot be used if the context contains at least one
-	 *    IPv4 header with value(RND) = 0. This disambiguates it from
-	 *    UO-1-ID and UO-1-TS.
-	 *  - UO-1-ID cannot be used if there is no IPv4 header in the
-	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - UO-1-TS cannot be used if there is no IPv4 header in the
-	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - T: T = 0 indicates format UO-1-ID;
-	 *       T = 1 indicates format UO-1-TS.
-	 */
-	if(nr_ipv4 == 0)
-	{
-		/* no IPv4 header at all, so only UO-1-RTP packet can be used */
-		rohc_decomp_debug(context, "UO-1* packet disambiguation: no IPv4 "
-		                  "header at all, so parse as UO-1-RTP");
-		type = ROHC_PACKET_UO_1_RTP;
-	}
-	else if(nr_ipv4_non_rnd == 0)
-	{
-		/* there is no IPv4 header with context(RND) = 0, and UO-1* packets
-		 * have either no value(RND) or value(RND) = context(RND) if they have
-		 * one. So only UO-1-RTP packet can be used */
-		rohc_decomp_debug(context, "UO-1* packet disambiguation: no IPv4 "
-		                  "header with context(RND) = 0, so parse as "
-		                  "UO-1-RTP");
-		type = ROHC_PACKET_UO_1_RTP;
-	}
-	else
-	{
-		/* there is at least one IPv4 header with context(RND) = 0, and UO-1*
-		 * packets have either no value(RND) or value(RND) = context(RND) if
-		 * they have one. So only UO-1-TS/ID are possible */
-		rohc_decomp_debug(context, "UO-1* packet disambiguation: at least one "
-		                  "IP header is IPv4 with context(RND) = 0, so parse "
-		                  "as UO-1-ID or UO-1-TS");
-
-		/* UO-1-ID or UO-1-TS packet, check the T field */
-		if(rohc_decomp_packet_is_uo1_ts(packet, rohc_length))
-		{
-			/* UO-1-TS packet */
-			rohc_decomp_debug(context, "UO-1* packet disambiguation: T = 1, "
-			                  "so parse as UO-1-TS");
-			type = ROHC_PACKET_UO_1_TS;
-		}
-		else
-		{
-			/* UO-1-ID packet */
-			rohc_decomp_debug(context, "UO-1* packet disambiguation: T = 0, "
-			                  "so parse as UO-1-ID");
-			type = ROHC_PACKET_UO_1_ID;
-		}
+		                 "0x%02x of the %zu-byte packet", rohc_packet[0],
+		                 rohc_length);
 	}
 
 	return type;
@@ -452,24 +328,19 @@ static rohc_packet_t rtp_choose_uo1_variant(const struct rohc_decomp_ctxt *const
 
 
 /**
- * @brief Choose between UOR-2-RTP, UOR-2-TS, and UOR-2-ID variants
+ * @brief Choose the table to detect the UO-1* and UOR-2* variants
  *
- * This function is useful to choose which packet type to try to decode (may
- * change later, causing a packet reparse) in the UOR-2* family.
+ * The UO-1-RTP, UO-1-TS, and UO-1-ID variants (and the UOR-2-RTP, UOR-2-TS,
+ * and UOR-2-ID variants) share the same discriminator. The context tells
+ * which variants may be used.
  *
- * @param context        The decompression context
- * @param packet         The ROHC packet
- * @param rohc_length    The length of the ROHC packet
- * @param large_cid_len  The length of the optional large CID field
- * @return               The packet type
+ * @param context  The decompression context
+ * @return         The lookup table to use to classify packets
  */
-static rohc_packet_t rtp_choose_uor2_variant(const struct rohc_decomp_ctxt *const context,
-                                             const uint8_t *const packet,
-                                             const size_t rohc_length,
-                                             const size_t large_cid_len)
+static rohc_decomp_pkt_table_t rtp_choose_pkt_table(const struct rohc_decomp_ctxt *const context)
 {
 	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-	rohc_packet_t type;
+	rohc_decomp_pkt_table_t table;
 	size_t nr_ipv4_non_rnd;
 	size_t nr_ipv4;
 
@@ -493,69 +364,47 @@ static rohc_packet_t rtp_choose_uor2_variant(const struct rohc_decomp_ctxt *cons
 		}
 	}
 
-	/* There is no easy way to disambiguate UOR-2-ID/TS and UOR-2-RTP
-	 * packets. The following algorithm is based on notes you may
-	 * read in RFC 3095, section 5.7.4:
-	 *  - UOR-2-RTP cannot be used if the context contains at least one
-	 *    IPv4 header with value(RND) = 0. This disambiguates it from
-	 *    UOR-2-ID and UOR-2-TS.
-	 *  - UOR-2-ID cannot be used if there is no IPv4 header in the
-	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - UOR-2-TS cannot be used if there is no IPv4 header in the
+	/* There is no easy way to disambiguate UO-1-ID/TS and UO-1-RTP packets
+	 * (or UOR-2-ID/TS and UOR-2-RTP packets). The following algorithm is based
+	 * on notes you may read in RFC 3095, sections 5.7.3 and 5.7.4:
+	 *  - *-RTP cannot be used if the context contains at least one IPv4
+	 *    header with value(RND) = 0. This disambiguates it from *-ID and
+	 *    *-TS.
+	 *  - *-ID and *-TS cannot be used if there is no IPv4 header in the
 	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - T: T = 0 indicates format UOR-2-ID;
-	 *       T = 1 indicates format UOR-2-TS.
+	 *  - T: T = 0 indicates format *-ID;
+	 *       T = 1 indicates format *-TS.
+	 *
+	 * UO-1* packets have either no value(RND) or value(RND) = context(RND)
+	 * if they have one. UOR-2* packets may contain a RND field and update the
+	 * context, so parsing may fallback on another variant later if the RND
+	 * field found in the packet contradicts the context.
 	 */
 	if(nr_ipv4 == 0)
 	{
 		/* no IPv4 header at all, so only *-RTP packet can be used */
-		rohc_decomp_debug(context, "UOR-2* packet disambiguation: no IPv4 "
-		                  "header at all, so parse as UOR-2-RTP");
-		type = ROHC_PACKET_UOR_2_RTP;
+		rohc_decomp_debug(context, "UO-1*/UOR-2* packet disambiguation: no "
+		                  "IPv4 header at all, so parse as UO-1-RTP/UOR-2-RTP");
+		table = ROHC_DECOMP_PKT_TABLE_RTP;
 	}
 	else if(nr_ipv4_non_rnd == 0)
 	{
-		/* there is no IPv4 header with context(RND) = 0, but maybe there is a
-		 * IPv4 header with value(RND) = 0 (the ROHC packet may contain a RND
-		 * field and update context). So try parsing UOR-2-RTP, and fallback
-		 * on UOR-2-TS/ID if value(RND) = 0 is found. */
-		rohc_decomp_debug(context, "UOR-2* packet disambiguation: no IPv4 "
-		                  "header with context(RND) = 0, so try parsing as "
-		                  "UOR-2-RTP, and fallback on UOR-2-ID/TS later if "
-		                  "value(RND) = 0 in packet");
-		type = ROHC_PACKET_UOR_2_RTP;
+		/* there is no IPv4 header with context(RND) = 0 */
+		rohc_decomp_debug(context, "UO-1*/UOR-2* packet disambiguation: no "
+		                  "IPv4 header with context(RND) = 0, so parse as "
+		                  "UO-1-RTP/UOR-2-RTP");
+		table = ROHC_DECOMP_PKT_TABLE_RTP;
 	}
 	else
 	{
-		/* there is at least one IPv4 header with context(RND) = 0, but maybe
-		 * there is a IPv4 header with value(RND) = 1 (the ROHC packet may
-		 * contain a RND field and update context), so try parsing UOR-2-TS/ID,
-		 * and fallback on UOR-2-RTP if value(RND) = 1 is found */
-		rohc_decomp_debug(context, "UOR-2* packet disambiguation: at least one "
-		                  "IP header is IPv4 with context(RND) = 0, so try "
-		                  "parsing as UOR-2-ID/TS, and fallback on UOR-2-RTP "
-		                  "later if value(RND) = 1 in packet");
-
-		/* UOR-2-ID or UOR-2-TS packet, check the T field */
-		if(rohc_decomp_packet_is_uor2_ts(packet, rohc_length, large_cid_len))
-		{
-			/* UOR-2-TS packet */
-			rohc_decomp_debug(context, "UOR-2* packet disambiguation: T = 1, "
-			                  "so try parsing as UOR-2-TS, and fallback on "
-			                  "UOR-2-RTP later if value(RND) = 1 in packet");
-			type = ROHC_PACKET_UOR_2_TS;
-		}
-		else
-		{
-			/* UOR-2-ID packet */
-			rohc_decomp_debug(context, "UOR-2* packet disambiguation: T = 0, "
-			                  "so try parsing as UOR-2-ID, and fallback on "
-			                  "UOR-2-RTP later if value(RND) = 1 in packet");
-			type = ROHC_PACKET_UOR_2_ID;
-		}
+		/* there is at least one IPv4 header with context(RND) = 0 */
+		rohc_decomp_debug(context, "UO-1*/UOR-2* packet disambiguation: at "
+		                  "least one IP header is IPv4 with context(RND) = 0, so "
+		                  "parse as UO-1-ID/TS or UOR-2-ID/TS");
+		table = ROHC_DECOMP_PKT_TABLE_RTP_IPV4_ID;
 	}
 
-	return type;
+	return table;
 }
 
 
@@ -1917,6 +1766,10 @@ const struct rohc_decomp_profile d_rtp_profile =
 {
 	.id              = ROHC_PROFILE_RTP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.persist_ctxt_size   = ROHC_DECOMP_RFC3095_CTXT_SIZE + sizeof(struct d_rtp_context) +
+	                       2 * (sizeof(struct udphdr) + sizeof(struct rtphdr)),
+	.extr_bits_size      = sizeof(struct rohc_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_rtp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_rtp_destroy,
 	.detect_pkt_type = rtp_detect_packet_type,
@@ -32,6 +32,7 @@
 #include "d_tcp_replicate.h"
 #include "d_tcp_irregular.h"
 #include "d_tcp_opts_list.h"
+#include "rohc_decomp_detect_packet.h"
 
 #include "rohc_decomp.h"
 #include "rohc_decomp_internals.h"
@@ -69,10 +70,6 @@ static void d_tcp_create_from_ctxt(struct rohc_decomp_ctxt *const ctxt,
                                    const struct rohc_tcp_decoded_values *const decoded)
 	__attribute__((nonnull(1, 2)));
 
-static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
-
 static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
                                             const size_t rohc_length,
@@ -473,7 +470,8 @@ static bool d_tcp_create_from_pkt(const struct rohc_decomp_ctxt *const context,
 	struct d_tcp_context *tcp_context;
 
 	/* allocate memory for the context */
-	*persist_ctxt = calloc(1, sizeof(struct d_tcp_context));
+	*persist_ctxt = rohc_decomp_persist_ctxt_alloc(context->decompressor,
+	                                               context->profile);
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -514,53 +512,14 @@ static bool d_tcp_create_from_pkt(const struct rohc_decomp_ctxt *const context,
 	/* volatile part of the decompression context */
 	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_tcp_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the TCP decompression context");
-		goto destroy_context;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_tcp_decoded_values));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the TCP decompression context");
-		goto free_extr_bits;
-	}
 
 	return true;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-destroy_context:
-	zfree(tcp_context);
 quit:
 	return false;
 }
 
 
-/**
- * @brief Destroy the context.
- *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param tcp_context  The persistent decompression context for the TCP profile
- * @param volat_ctxt   The volatile decompression context
- */
-static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-{
-	/* free the TCP decompression context itself */
-	free(tcp_context);
-
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
-}
-
-
 /**
  * @brief Detect the type of ROHC packet for the TCP profile
  *
@@ -573,9 +532,10 @@ static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
 static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
                                             const size_t rohc_length,
-                                            const size_t large_cid_len __attribute__((unused)))
+                                            const size_t large_cid_len)
 {
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
+	rohc_decomp_pkt_table_t table;
 	rohc_packet_t type;
 
 	/* at least one byte required to check discriminator byte in packet
@@ -585,17 +545,12 @@ static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const
 	rohc_decomp_debug(context, "try to determine the header from first byte "
 	                  "0x%02x", rohc_packet[0]);
 
-	if(rohc_packet[0] == ROHC_PACKET_TYPE_IR)
-	{
-		type = ROHC_PACKET_IR;
-	}
-	else if(rohc_packet[0] == ROHC_PACKET_TYPE_IR_CR)
-	{
-		type = ROHC_PACKET_IR_CR;
-	}
-	else if(rohc_packet[0] == ROHC_PACKET_TYPE_IR_DYN)
+	if(rohc_packet[0] == ROHC_PACKET_TYPE_IR ||
+	   rohc_packet[0] == ROHC_PACKET_TYPE_IR_CR ||
+	   rohc_packet[0] == ROHC_PACKET_TYPE_IR_DYN)
 	{
-		type = ROHC_PACKET_IR_DYN;
+		/* IR, IR-CR and IR-DYN packets share the same entries in all tables */
+		table = ROHC_DECOMP_PKT_TABLE_TCP_SEQ;
 	}
 	else
 	{
@@ -625,80 +580,18 @@ static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const
 		                  "0x%02x and innermost IP-ID behavior %s", rohc_packet[0],
 		                  rohc_ip_id_behavior_get_descr(innermost_ip_id_behavior));
 
-		if(rohc_packet[0] & 0x80)
-		{
-			switch(rohc_packet[0] & 0xf0)
-			{
-				case 0x80: /* 1000 = seq_5 / rnd_5 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_5 : ROHC_PACKET_TCP_RND_5);
-					break;
-				case 0x90: /* 1001 = seq_3 / rnd_5 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_3 : ROHC_PACKET_TCP_RND_5);
-					break;
-				case 0xa0: /* 1010 = seq_1 / rnd_6 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_1 : ROHC_PACKET_TCP_RND_6);
-					break;
-				case 0xb0: /* 1011 = seq_8 / rnd_1 / rnd_7 / rnd_8 */
-					if(is_ip_id_seq)
-					{
-						type = ROHC_PACKET_TCP_SEQ_8;
-					}
-					else if(rohc_packet[0] & 0x08)
-					{
-						if(rohc_packet[0] & 0x04)
-						{
-							type = ROHC_PACKET_TCP_RND_7;
-						}
-						else
-						{
-							type = ROHC_PACKET_TCP_RND_1;
-						}
-					}
-					else
-					{
-						type = ROHC_PACKET_TCP_RND_8;
-					}
-					break;
-				case 0xc0: /* 1100 = seq_7 / rnd_2 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_7 : ROHC_PACKET_TCP_RND_2);
-					break;
-				case 0xd0: /* 1101 = seq_2 / seq_6 / rnd_4 */
-					if(is_ip_id_seq)
-					{
-						if(rohc_packet[0] & 0x08)
-						{
-							type = ROHC_PACKET_TCP_SEQ_6;
-						}
-						else
-						{
-							type = ROHC_PACKET_TCP_SEQ_2;
-						}
-					}
-					else
-					{
-						type = ROHC_PACKET_TCP_RND_4;
-					}
-					break;
-				case 0xf0: /* 1111 = common */
-					if((rohc_packet[0] & 0xfe) == 0xfa)
-					{
-						type = ROHC_PACKET_TCP_CO_COMMON;
-					}
-					else
-					{
-						type = ROHC_PACKET_UNKNOWN;
-					}
-					break;
-				default:
-					type = ROHC_PACKET_UNKNOWN;
-					break;
-			}
-		}
-		else
-		{
-			/* seq_4 / rnd_3 */
-			type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_4 : ROHC_PACKET_TCP_RND_3);
-		}
+		/* the discriminators of the seq_* and rnd_* packets overlap */
+		table = (is_ip_id_seq ? ROHC_DECOMP_PKT_TABLE_TCP_SEQ :
+		         ROHC_DECOMP_PKT_TABLE_TCP_RND);
+	}
+
+	type = rohc_decomp_pkt_type_from_table(table, rohc_packet, rohc_length,
+	                                       large_cid_len);
+	if(type == ROHC_PACKET_UNKNOWN)
+	{
+		rohc_decomp_warn(context, "failed to recognize the packet type in byte "
+		                 "0x%02x of the %zu-byte packet", rohc_packet[0],
+		                 rohc_length);
 	}
 
 	return type;
@@ -3243,12 +3136,13 @@ static bool d_tcp_decode_bits_tcp_hdr(const struct rohc_decomp_ctxt *const conte
 			                 "for a packet with an empty payload");
 			goto error;
 		}
+		decoded->seq_num_residue = tcp_context->seq_num_residue;
 		decoded->seq_num = decoded->seq_num_scaled * payload_len +
-		                   tcp_context->seq_num_residue;
+		                   decoded->seq_num_residue;
 		rohc_decomp_debug(context, "  seq_number_scaled = 0x%x, payload size = %zu, "
 		                  "seq_number_residue = 0x%x -> seq_number = 0x%x",
 		                  decoded->seq_num_scaled, payload_len,
-		                  tcp_context->seq_num_residue, decoded->seq_num);
+		                  decoded->seq_num_residue, decoded->seq_num);
 	}
 	else
 	{
@@ -4574,8 +4468,11 @@ const struct rohc_decomp_profile d_tcp_profile =
 {
 	.id              = ROHC_PROFILE_TCP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.persist_ctxt_size   = sizeof(struct d_tcp_context),
+	.extr_bits_size      = sizeof(struct rohc_tcp_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_tcp_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_tcp_create_from_pkt,
-	.free_context    = (rohc_decomp_free_context_t) d_tcp_destroy,
+	.free_context    = NULL, /* kept for re-use by the decompressor */
 	.detect_pkt_type = tcp_detect_packet_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) d_tcp_parse_packet,
 	.decode_bits     = (rohc_decomp_decode_bits_t) d_tcp_decode_bits,
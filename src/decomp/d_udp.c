@@ -63,9 +63,8 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
 
 static int udp_parse_dynamic_udp(const struct rohc_decomp_ctxt *const context,
                                  const uint8_t *packet,
@@ -189,7 +188,7 @@ free_outer_ip_changes_next_header:
 free_udp_context:
 	zfree(udp_context);
 destroy_context:
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -202,10 +201,8 @@ quit:
  * framework to work.
  *
  * @param rfc3095_ctxt  The persistent decompression context for the RFC3095 profiles
- * @param volat_ctxt    The volatile decompression context
  */
-static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
 	/* clean UDP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
@@ -214,7 +211,7 @@ static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
 	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the resources of the generic context */
-	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt);
 }
 
 
@@ -575,6 +572,10 @@ const struct rohc_decomp_profile d_udp_profile =
 {
 	.id              = ROHC_PROFILE_UDP, /* profile ID (see 8 in RFC3095) */
 	.msn_max_bits    = 16,
+	.persist_ctxt_size   = ROHC_DECOMP_RFC3095_CTXT_SIZE + sizeof(struct d_udp_context) +
+	                       2 * sizeof(struct udphdr),
+	.extr_bits_size      = sizeof(struct rohc_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_decoded_values),
 	.new_context     = (rohc_decomp_new_context_t) d_udp_create,
 	.free_context    = (rohc_decomp_free_context_t) d_udp_destroy,
 	.detect_pkt_type = ip_detect_packet_type,
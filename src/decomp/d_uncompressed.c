@@ -63,9 +63,7 @@ static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
                                struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void uncomp_free_context(void *const persist_ctxt,
-                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(2)));
+static void uncomp_free_context(void *const persist_ctxt);
 
 static rohc_packet_t uncomp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
@@ -158,27 +156,8 @@ static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
 	/* volatile part */
 	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_uncomp_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of the Uncompressed decompression profile");
-		goto error;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_uncomp_decoded));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of the Uncompressed decompression profile");
-		goto free_extr_bits;
-	}
 
 	return true;
-
-free_extr_bits:
-	free(volat_ctxt->extr_bits);
-error:
-	return false;
 }
 
 
@@ -190,14 +169,10 @@ error:
  * framework to work.
  *
  * @param persist_ctxt  The persistent part of the decompression context
- * @param volat_ctxt    The volatile part of the decompression context
  */
-static void uncomp_free_context(void *const persist_ctxt,
-                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+static void uncomp_free_context(void *const persist_ctxt)
 {
 	assert(persist_ctxt == NULL);
-	free(volat_ctxt->extr_bits);
-	free(volat_ctxt->decoded_values);
 }
 
 
@@ -548,6 +523,9 @@ const struct rohc_decomp_profile d_uncomp_profile =
 {
 	.id              = ROHC_PROFILE_UNCOMPRESSED, /* profile ID (RFC3095 §8) */
 	.msn_max_bits    = 0, /* no MSN */
+	.persist_ctxt_size   = 0, /* no profile-specific part */
+	.extr_bits_size      = sizeof(struct rohc_uncomp_extr_bits),
+	.decoded_values_size = sizeof(struct rohc_uncomp_decoded),
 	.new_context     = uncomp_new_context,
 	.free_context    = uncomp_free_context,
 	.detect_pkt_type = uncomp_detect_pkt_type,
@@ -27,7 +27,7 @@
 #include "rohc_decomp.h"
 #include "rohc_decomp_internals.h"
 #include "rohc_traces_internal.h"
-#include "rohc_decomp_detect_packet.h" /* for rohc_decomp_packet_is_ir() */
+#include "rohc_decomp_detect_packet.h"
 #include "protocols/ip_numbers.h"
 #include "protocols/ip.h"
 #include "protocols/rfc5225.h"
@@ -203,10 +203,6 @@ static bool decomp_rfc5225_ip_udp_rtp_new_context(const struct rohc_decomp_ctxt
                                               struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-static void decomp_rfc5225_ip_udp_rtp_free_context(struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt,
-                                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
-
 static rohc_packet_t decomp_rfc5225_ip_udp_rtp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
                                                            const uint8_t *const rohc_packet,
                                                            const size_t rohc_length,
@@ -412,7 +408,8 @@ static bool decomp_rfc5225_ip_udp_rtp_new_context(const struct rohc_decomp_ctxt
 	struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt *rfc5225_ctxt;
 
 	/* allocate memory for the context */
-	*persist_ctxt = calloc(1, sizeof(struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt));
+	*persist_ctxt = rohc_decomp_persist_ctxt_alloc(context->decompressor,
+	                                               context->profile);
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -432,54 +429,14 @@ static bool decomp_rfc5225_ip_udp_rtp_new_context(const struct rohc_decomp_ctxt
 	/* volatile part */
 	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_rfc5225_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the ROHCv2 IP/UDP/RTP decompression context");
-		goto destroy_context;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_rfc5225_decoded));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the ROHCv2 IP/UDP/RTP decompression context");
-		goto free_extr_bits;
-	}
 
 	return true;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-destroy_context:
-	zfree(rfc5225_ctxt);
 error:
 	return false;
 }
 
 
-/**
- * @brief Destroy profile-specific data, nothing to destroy for the
- *        ROHCv2 IP/UDP/RTP profile
- *
- * This function is one of the functions that must exist in one profile for the
- * framework to work.
- *
- * @param rfc5225_ctxt  The persistent decompression context for the IP/UDP/RTP profile
- * @param volat_ctxt    The volatile part of the decompression context
- */
-static void decomp_rfc5225_ip_udp_rtp_free_context(struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt *const rfc5225_ctxt,
-                                               const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-{
-	/* free the ROHCv2 IP/UDP/RTP decompression context itself */
-	free(rfc5225_ctxt);
-
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
-}
-
-
 /**
  * @brief Detect the type of ROHC packet for the ROHCv2 IP/UDP/RTP profile
  *
@@ -495,7 +452,7 @@ static void decomp_rfc5225_ip_udp_rtp_free_context(struct rohc_decomp_rfc5225_ip
 static rohc_packet_t decomp_rfc5225_ip_udp_rtp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
                                                            const uint8_t *const rohc_packet,
                                                            const size_t rohc_length,
-                                                           const size_t large_cid_len __attribute__((unused)))
+                                                           const size_t large_cid_len)
 {
 	rohc_packet_t type;
 
@@ -506,38 +463,11 @@ static rohc_packet_t decomp_rfc5225_ip_udp_rtp_detect_pkt_type(const struct rohc
 	rohc_decomp_debug(context, "try to determine the header from first byte "
 	                  "0x%02x", rohc_packet[0]);
 
-	if(GET_BIT_7(rohc_packet) == 0) /* 1-bit discriminator '0' */
-	{
-		type = ROHC_PACKET_PT_0_CRC3;
-	}
-	else if(GET_BIT_5_7(rohc_packet) == 0x04) /* 3-bit discriminator '100' */
-	{
-		type = ROHC_PACKET_NORTP_PT_0_CRC7;
-	}
-	else if(GET_BIT_5_7(rohc_packet) == 0x05) /* 3-bit discriminator '101' */
-	{
-		type = ROHC_PACKET_NORTP_PT_1_SEQ_ID;
-	}
-	else if(GET_BIT_5_7(rohc_packet) == 0x06) /* 3-bit discriminator '110' */
-	{
-		type = ROHC_PACKET_NORTP_PT_2_SEQ_ID;
-	}
-	else if(GET_BIT_0_7(rohc_packet) == 0xfa) /* 8-bit discriminator '11111010' */
-	{
-		type = ROHC_PACKET_CO_COMMON;
-	}
-	else if(rohc_packet[0] == ROHC_PACKET_TYPE_CO_REPAIR) /* 8-bit '11111011' */
-	{
-		type = ROHC_PACKET_CO_REPAIR;
-	}
-	else if(rohc_packet[0] == ROHC_PACKET_TYPE_IR) /* 8-bit '11111101' */
-	{
-		type = ROHC_PACKET_IR;
-	}
-	else
-	{
-		type = ROHC_PACKET_UNKNOWN;
-	}
+	/* pt_0_crc3 '0', pt_0_crc7 '100', pt_1_seq_id '101', pt_2_seq_id '110',
+	 * co_common '11111010', co_repair '11111011' and IR '11111101' */
+	type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RFC5225,
+	                                       rohc_packet, rohc_length,
+	                                       large_cid_len);
 
 	return type;
 }
@@ -2724,8 +2654,11 @@ const struct rohc_decomp_profile rohc_decomp_rfc5225_ip_udp_rtp_profile =
 {
 	.id              = ROHCv2_PROFILE_IP_UDP_RTP, /* profile ID (RFC5225, ROHCv2 IP/UDP/RTP) */
 	.msn_max_bits    = 16,
+	.persist_ctxt_size   = sizeof(struct rohc_decomp_rfc5225_ip_udp_rtp_ctxt),
+	.extr_bits_size      = sizeof(struct rohc_rfc5225_bits),
+	.decoded_values_size = sizeof(struct rohc_rfc5225_decoded),
 	.new_context     = decomp_rfc5225_ip_udp_rtp_new_context,
-	.free_context    = (rohc_decomp_free_context_t) decomp_rfc5225_ip_udp_rtp_free_context,
+	.free_context    = NULL, /* kept for re-use by the decompressor */
 	.detect_pkt_type = decomp_rfc5225_ip_udp_rtp_detect_pkt_type,
 	.parse_pkt       = (rohc_decomp_parse_pkt_t) decomp_rfc5225_ip_udp_rtp_parse_pkt,
 	.decode_bits     = (rohc_decomp_decode_bits_t) decomp_rfc5225_ip_udp_rtp_decode_bits,
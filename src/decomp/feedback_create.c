@@ -41,11 +41,12 @@
  * Prototypes of private functions.
  */
 
-static bool f_append_cid(struct d_feedback *const feedback,
-                         const uint16_t cid,
-                         const rohc_cid_type_t cid_type,
-                         size_t *const cid_len)
-	__attribute__((warn_unused_result, nonnull(1, 4)));
+static bool f_write_cid(uint8_t *const cid_field,
+                        const size_t avail_len,
+                        const uint16_t cid,
+                        const rohc_cid_type_t cid_type,
+                        size_t *const cid_len)
+	__attribute__((warn_unused_result, nonnull(1, 5)));
 
 
 /**
@@ -297,60 +298,38 @@ error:
 
 
 /**
- * @brief Append the CID to the feedback packet.
+ * @brief Write the CID of the feedback packet
  *
- * @param feedback     The feedback packet to which the CID must be appended
- * @param cid          The Context ID (CID) to append
+ * Write the Add-CID octet for small CIDs or the SDVL-encoded large CID.
+ * Nothing is written for the small CID 0.
+ *
+ * @param cid_field    The buffer to write the CID in
+ * @param avail_len    The length of the buffer (in bytes)
+ * @param cid          The Context ID (CID) to write
  * @param cid_type     The type of CID used for the feedback
  * @param[out] cid_len The length of the add-CID or large CID field
- * @return             Whether the CID is successfully appended or not
+ * @return             Whether the CID is successfully written or not
  */
-static bool f_append_cid(struct d_feedback *const feedback,
-                         const uint16_t cid,
-                         const rohc_cid_type_t cid_type,
-                         size_t *const cid_len)
+static bool f_write_cid(uint8_t *const cid_field,
+                        const size_t avail_len,
+                        const uint16_t cid,
+                        const rohc_cid_type_t cid_type,
+                        size_t *const cid_len)
 {
-	size_t i;
-
 	if(cid_type == ROHC_LARGE_CID)
 	{
 		/* large CIDs are used */
 		assert(cid <= ROHC_LARGE_CID_MAX);
 
-		/* determine the number of bits required for the SDVL-encoded large CID */
-		*cid_len = sdvl_get_encoded_len(cid);
-		assert((*cid_len) == 1 || (*cid_len) == 2); /* ensured by SDVL algorithm */
-
-		/* check if the feedback packet can contain a SDVL-encoded large CID */
-		if((feedback->size + (*cid_len)) > FEEDBACK_DATA_MAX_LEN)
-		{
-#ifdef ROHC_FEEDBACK_DEBUG
-			printf("feedback packet is too small for large CID\n");
-#endif
-			return false;
-		}
-
-#ifdef ROHC_FEEDBACK_DEBUG
-		printf("add %zu bytes for large CID to feedback\n", *cid_len);
-#endif
-
-		/* move feedback data to make space for the SDVL-encoded large CID */
-		assert(feedback->size >= 1);
-		for(i = feedback->size; i > 0; i--)
-		{
-			feedback->data[i - 1 + (*cid_len)] = feedback->data[i - 1];
-		}
-
 		/* SDVL-encode the large CID */
-		if(!sdvl_encode_full(feedback->data, 4U /* TODO */, cid_len, cid))
+		if(!sdvl_encode_full(cid_field, avail_len, cid_len, cid))
 		{
 #ifdef ROHC_FEEDBACK_DEBUG
-			printf("failed to SDVL-encoded large CID %u, should never "
-			       "happen!\n", cid);
+			printf("failed to SDVL-encode large CID %u\n", cid);
 #endif
 			return false;
 		}
-		feedback->size += (*cid_len);
+		assert((*cid_len) == 1 || (*cid_len) == 2); /* ensured by SDVL algorithm */
 	}
 	else /* small CID */
 	{
@@ -360,30 +339,17 @@ static bool f_append_cid(struct d_feedback *const feedback,
 		/* add 1 byte only if CID is non-zero */
 		if(cid != 0)
 		{
-#ifdef ROHC_FEEDBACK_DEBUG
-			printf("add 1 byte for small CID to feedback\n");
-#endif
-
-			/* move feedback data to make space for the small CID */
-			assert(feedback->size >= 1);
-			for(i = feedback->size; i > 0; i--)
+			if(avail_len < 1)
 			{
-				feedback->data[i] = feedback->data[i - 1];
+				return false;
 			}
-
-			/* write the small CID to the feedback packet */
-			feedback->data[0] = 0xe0;
-			feedback->data[0] = (cid & 0xf) | feedback->data[0];
-			feedback->size++;
+			cid_field[0] = 0xe0 | (cid & 0xf);
 			*cid_len = 1;
 		}
-#ifdef ROHC_FEEDBACK_DEBUG
 		else
 		{
-			printf("no need to prepend Add-CID byte to feedback\n");
 			*cid_len = 0;
 		}
-#endif
 	}
 
 	return true;
@@ -393,34 +359,41 @@ static bool f_append_cid(struct d_feedback *const feedback,
 /**
  * @brief Wrap the feedback packet and add a CRC option if specified.
  *
+ * The feedback header, the CID and the feedback data are written at the end
+ * of the given buffer, then the CRC is computed over the written bytes. No
+ * memory is allocated. Nothing is written if the buffer is too small.
+ *
  * @warning CID may be greater than MAX_CID if the context was not found and
  *          generated a No Context feedback; it must however respect CID type
  *
- * @param feedback          The feedback packet to which the CID must be
- *                          appended
+ * @param feedback          The feedback packet to wrap
  * @param cid               The Context ID (CID) to append
  * @param cid_type          The type of CID used for the feedback
  * @param protect_with_crc  Whether the CRC option must be added or not
- * @param final_size        OUT: The final size of the feedback packet
- * @return                  The feedback packet if successful, NULL otherwise
+ * @param[out] feedback_pkt The buffer to append the feedback packet to
+ * @return                  true if successful (even if the buffer is too
+ *                          small for the feedback), false otherwise
  */
-uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
-                          const uint16_t cid,
-                          const rohc_cid_type_t cid_type,
-                          const rohc_feedback_crc_t protect_with_crc,
-                          size_t *const final_size)
+bool f_wrap_feedback(struct d_feedback *const feedback,
+                     const uint16_t cid,
+                     const rohc_cid_type_t cid_type,
+                     const rohc_feedback_crc_t protect_with_crc,
+                     struct rohc_buf *const feedback_pkt)
 {
-	uint8_t *feedback_packet;
+	const size_t feedback_cid_max_len = 2;
+	uint8_t cid_field[2];
 	size_t feedback_cid_len = 0;
+	size_t feedback_hdr_len;
+	size_t feedback_len;
 	size_t crc_pos = 0;
-	uint8_t crc;
+	uint8_t *pkt;
 
-	/* append the CID to the feedback packet */
-	if(!f_append_cid(feedback, cid, cid_type, &feedback_cid_len))
+	/* encode the CID */
+	if(!f_write_cid(cid_field, feedback_cid_max_len, cid, cid_type,
+	                &feedback_cid_len))
 	{
 		goto error;
 	}
-	assert(feedback_cid_len <= 2);
 
 	/* add the CRC option if specified */
 	if(protect_with_crc == ROHC_FEEDBACK_WITH_CRC_OPT)
@@ -436,7 +409,7 @@ uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
 			goto error;
 		}
 		/* CRC goes in the last byte of the feedback (CRC option is the last one) */
-		crc_pos = feedback->size - 1;
+		crc_pos = feedback_cid_len + feedback->size - 1;
 	}
 	else if(protect_with_crc == ROHC_FEEDBACK_WITH_CRC_BASE)
 	{
@@ -451,31 +424,54 @@ uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
 		goto error;
 	}
 
-	/* allocate memory for the feedback packet */
-	feedback_packet = (uint8_t *) malloc(feedback->size);
-	if(feedback_packet == NULL)
+	/* the feedback packet is made of the CID and the feedback data, the
+	 * feedback header encodes its length in the Code field or in the Size
+	 * field */
+	feedback_len = feedback_cid_len + feedback->size;
+	if(feedback_len > (FEEDBACK_DATA_MAX_LEN + feedback_cid_max_len))
 	{
 		goto error;
 	}
+	feedback_hdr_len = 1 + (feedback_len < 8 ? 0 : 1);
+	if((feedback_pkt->len + feedback_hdr_len + feedback_len) >
+	   rohc_buf_avail_len(*feedback_pkt))
+	{
+#ifdef ROHC_FEEDBACK_DEBUG
+		printf("buffer is too small for the %zu-byte feedback\n",
+		       feedback_hdr_len + feedback_len);
+#endif
+		goto skip;
+	}
 
-	/* duplicate the feedback packet */
-	memcpy(feedback_packet, feedback->data, feedback->size);
+	/* write the feedback header then the feedback packet */
+	pkt = rohc_buf_data_at(*feedback_pkt, feedback_pkt->len);
+	if(feedback_len < 8)
+	{
+		pkt[0] = 0xf0 | feedback_len;
+	}
+	else
+	{
+		pkt[0] = 0xf0;
+		pkt[1] = feedback_len;
+	}
+	pkt += feedback_hdr_len;
+	memcpy(pkt, cid_field, feedback_cid_len);
+	memcpy(pkt + feedback_cid_len, feedback->data, feedback->size);
 
 	/* compute the CRC and store it in the feedback packet if specified */
 	if(protect_with_crc != ROHC_FEEDBACK_WITH_NO_CRC)
 	{
-		crc = crc_calculate(ROHC_CRC_TYPE_8, feedback_packet, feedback->size,
-		                    CRC_INIT_8);
-		feedback_packet[crc_pos] = crc;
+		pkt[crc_pos] = crc_calculate(ROHC_CRC_TYPE_8, pkt, feedback_len,
+		                             CRC_INIT_8);
 	}
 
-	*final_size = feedback->size;
-	feedback->size = 0;
+	feedback_pkt->len += feedback_hdr_len + feedback_len;
 
-	return feedback_packet;
+skip:
+	feedback->size = 0;
+	return true;
 
 error:
 	feedback->size = 0;
-	return NULL;
+	return false;
 }
-
@@ -80,11 +80,11 @@ bool f_add_option(struct d_feedback *const feedback,
                   const size_t data_len)
 	__attribute__((warn_unused_result, nonnull(1)));
 
-uint8_t * f_wrap_feedback(struct d_feedback *feedback,
-                          const uint16_t cid,
-                          const rohc_cid_type_t cid_type,
-                          const rohc_feedback_crc_t protect_with_crc,
-                          size_t *const final_size)
+bool f_wrap_feedback(struct d_feedback *const feedback,
+                     const uint16_t cid,
+                     const rohc_cid_type_t cid_type,
+                     const rohc_feedback_crc_t protect_with_crc,
+                     struct rohc_buf *const feedback_pkt)
 	__attribute__((warn_unused_result, nonnull(1, 5)));
 
 
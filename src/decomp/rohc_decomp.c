@@ -39,6 +39,7 @@
 
 #include "rohc_decomp.h"
 #include "rohc_decomp_internals.h"
+#include "rohc_decomp_rfc3095.h"
 #include "rohc_traces_internal.h"
 #include "rohc_time_internal.h"
 #include "rohc_utils.h"
@@ -100,6 +101,15 @@ static const struct rohc_decomp_profile *const
 	},
 };
 
+/* compiler sanity check for C11-compliant compilers and GCC >= 4.6 */
+#if ((defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L) || \
+     (defined(__GNUC__) && defined(__GNUC_MINOR__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))))
+_Static_assert(((ROHC_PROFILE_ID_MAJOR_MAX + 1) * (ROHC_PROFILE_ID_MINOR_MAX + 1)) <=
+               ROHC_DECOMP_MEM_PROFILES_MAX,
+               "rohc_decomp_memory_usage_t should be able to describe all profiles");
+#endif
+
 
 /*
  * Definitions of private structures
@@ -139,6 +149,24 @@ struct rohc_decomp_stream
 };
 
 
+/**
+ * @brief The beginning of a ROHC packet parsed before its decompression
+ *
+ * The CIDs of the packets of a burst are decoded before the packets are
+ * decompressed, so that their contexts are prefetched. The padding, the
+ * feedback items and the CID of every packet are then not parsed a second
+ * time when the packet is decompressed.
+ */
+struct rohc_decomp_peeked_cid
+{
+	size_t padding_len;   /**< The length of the padding */
+	size_t feedbacks_len; /**< The length of the feedback items after padding */
+	rohc_cid_t cid;       /**< The CID of the packet */
+	size_t add_cid_len;   /**< The length of the Add-CID field (small CIDs) */
+	size_t large_cid_len; /**< The length of the large CID field */
+};
+
+
 /*
  * Prototypes of private functions
  */
@@ -158,20 +186,67 @@ static bool rohc_decomp_profile_enabled_nocheck(const struct rohc_decomp *const
 
 static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
                                                 const rohc_cid_t cid,
-                                                const struct rohc_decomp_profile *const profile)
+                                                const struct rohc_decomp_profile *const profile,
+                                                const struct rohc_decomp_ctxt *const kept_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 3)));
 static struct rohc_decomp_ctxt * find_context(const struct rohc_decomp *const decomp,
                                               const rohc_cid_t cid)
 	__attribute__((nonnull(1), warn_unused_result));
 static void context_free(struct rohc_decomp_ctxt *const context)
 	__attribute__((nonnull(1)));
+static void rohc_decomp_persist_ctxt_release(struct rohc_decomp *const decomp,
+                                             const struct rohc_decomp_profile *const profile,
+                                             void *const persist_ctxt)
+	__attribute__((nonnull(1, 2, 3)));
+static void rohc_decomp_persist_free_pool(struct rohc_decomp *const decomp,
+                                          const uint8_t profile_major,
+                                          const uint8_t profile_minor)
+	__attribute__((nonnull(1)));
+static void context_touch(struct rohc_decomp *const decomp,
+                          struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static bool rohc_decomp_evict_contexts(struct rohc_decomp *const decomp,
+                                       const size_t needed_mem,
+                                       const struct rohc_decomp_ctxt *const kept_ctxt)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static bool rohc_decomp_check_pkts(const struct rohc_decomp *const decomp,
+                                   const struct rohc_buf rohc_packet,
+                                   const struct rohc_buf uncomp_packet)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static rohc_status_t __rohc_decompress(struct rohc_decomp *const decomp,
+                                       const struct rohc_buf rohc_packet,
+                                       const bool is_rru,
+                                       const bool in_place,
+                                       const struct rohc_decomp_peeked_cid *const peeked,
+                                       struct rohc_buf *const uncomp_packet,
+                                       struct rohc_buf *const rcvd_feedback,
+                                       struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result, nonnull(1, 6)));
 
 static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
                                      const struct rohc_buf rohc_packet,
+                                     const bool is_rru,
+                                     const bool in_place,
+                                     const struct rohc_decomp_peeked_cid *const peeked,
                                      struct rohc_buf *const uncomp_packet,
                                      struct rohc_buf *const rcvd_feedback,
                                      struct rohc_decomp_stream *const stream)
-	__attribute__((nonnull(1, 3, 5), warn_unused_result));
+	__attribute__((nonnull(1, 6, 8), warn_unused_result));
+
+static rohc_status_t rohc_decomp_append_segment(struct rohc_decomp *const decomp,
+                                                struct rohc_buf *const rohc_data)
+	__attribute__((nonnull(1, 2), warn_unused_result));
+
+static void rohc_decomp_rru_fcs_init(struct rohc_decomp_rru_fcs *const fcs)
+	__attribute__((nonnull(1)));
+static void rohc_decomp_rru_fcs_update(struct rohc_decomp_rru_fcs *const fcs,
+                                       const uint8_t *const data,
+                                       const size_t len)
+	__attribute__((nonnull(1, 2)));
+static bool rohc_decomp_rru_fcs_check(const struct rohc_decomp_rru_fcs *const fcs)
+	__attribute__((nonnull(1), warn_unused_result, pure));
 
 static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
                                    const uint8_t *packet,
@@ -185,6 +260,11 @@ static void rohc_decomp_parse_padding(const struct rohc_decomp *const decomp,
                                       struct rohc_buf *const packet)
 	__attribute__((nonnull(1, 2)));
 
+static bool rohc_decomp_peek_cid(const struct rohc_decomp *const decomp,
+                                 const struct rohc_buf rohc_packet,
+                                 struct rohc_decomp_peeked_cid *const peeked)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
 static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
                                               const uint8_t *const packet,
                                               const size_t packet_len,
@@ -200,10 +280,11 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const struct rohc_buf rohc_packet,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
+                                            const bool in_place,
                                             struct rohc_buf *const uncomp_packet,
                                             rohc_packet_t *const packet_type,
                                             bool *const do_change_mode)
-	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 7, 8, 9)));
 
 static rohc_status_t rohc_decomp_try_decode_pkt(const struct rohc_decomp *const decomp,
                                                 const struct rohc_decomp_ctxt *const context,
@@ -255,6 +336,15 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
                                       const struct rohc_decomp_stream *const stream,
                                       struct rohc_buf *const feedback)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool rohc_decomp_feedback_queue(struct rohc_decomp *const decomp,
+                                       const struct rohc_decomp_stream *const infos,
+                                       const enum rohc_feedback_ack_type ack_type,
+                                       struct d_feedback *const sfeedback,
+                                       const rohc_feedback_crc_t crc_present)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static void rohc_decomp_feedback_unqueue(struct rohc_decomp *const decomp,
+                                         struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
 
 /* statistics-related functions */
 static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
@@ -289,27 +379,56 @@ static struct rohc_decomp_ctxt * find_context(const struct rohc_decomp *const de
  * @param decomp        The ROHC decompressor
  * @param cid           The CID of the new context
  * @param profile       The profile to be assigned with the new context
+ * @param kept_ctxt     The context that shall not be evicted to make room for
+ *                      the new context, eg. the base context of an IR-CR
+ *                      packet, NULL if none
  * @return              The new context if successful, NULL otherwise
  */
 static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
                                                 const rohc_cid_t cid,
-                                                const struct rohc_decomp_profile *const profile)
+                                                const struct rohc_decomp_profile *const profile,
+                                                const struct rohc_decomp_ctxt *const kept_ctxt)
 {
+	const size_t ctxt_mem = sizeof(struct rohc_decomp_ctxt) +
+	                        profile->persist_ctxt_size;
 	struct rohc_decomp_ctxt *context;
 
 	assert(cid <= ROHC_LARGE_CID_MAX);
 
-	/* allocate memory for the decompression context */
-	context = (struct rohc_decomp_ctxt *) malloc(sizeof(struct rohc_decomp_ctxt));
-	if(context == NULL)
+	/* evict the least recently used contexts if the new context does not fit
+	 * in the memory allowed for contexts */
+	if(!rohc_decomp_evict_contexts(decomp, ctxt_mem, kept_ctxt))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
-		             "cannot allocate memory for the contexts");
+		             "the %zu bytes required by the new context do not fit in the "
+		             "%zu bytes allowed for all contexts", ctxt_mem,
+		             decomp->ctxts_max_mem);
 		goto error;
 	}
 
+	/* re-use one released context if possible, allocate memory for the
+	 * decompression context otherwise */
+	if(decomp->ctxts_pool != NULL)
+	{
+		context = decomp->ctxts_pool;
+		decomp->ctxts_pool = context->lru_next;
+		assert(decomp->ctxts_pool_nr > 0);
+		decomp->ctxts_pool_nr--;
+	}
+	else
+	{
+		context = (struct rohc_decomp_ctxt *) malloc(sizeof(struct rohc_decomp_ctxt));
+		if(context == NULL)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+			             "cannot allocate memory for the contexts");
+			goto error;
+		}
+	}
+
 	/* record the CID */
 	context->cid = cid;
+	context->mem_size = ctxt_mem;
 
 	/* associate the decompressor with the context */
 	context->decompressor = decomp;
@@ -329,6 +448,9 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent = 0;
 	context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed = 0;
 	context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent = 0;
+	context->pending_fb.len = 0;
+	context->fb_prev = NULL;
+	context->fb_next = NULL;
 
 	/* init the context for packet/context corrections upon CRC failures */
 	/* at the beginning, no attempt to correct CRC failure */
@@ -357,6 +479,45 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	context->nr_misordered_packets = 0;
 	context->is_duplicated = 0;
 
+	/* the bits extracted from ROHC packets and the values decoded from them
+	 * are only needed during the decompression of one packet: share them
+	 * between all the contexts of the profile instead of allocating them
+	 * again for every new context */
+	{
+		const uint8_t profile_major = (profile->id >> 8) & 0xff;
+		const uint8_t profile_minor = profile->id & 0xff;
+		struct rohc_decomp_volat_scratch *scratch;
+
+		assert(profile_major <= ROHC_PROFILE_ID_MAJOR_MAX);
+		assert(profile_minor <= ROHC_PROFILE_ID_MINOR_MAX);
+		scratch = &(decomp->volat_scratch[profile_major][profile_minor]);
+
+		if(scratch->extr_bits == NULL)
+		{
+			scratch->extr_bits = malloc(profile->extr_bits_size);
+			if(scratch->extr_bits == NULL)
+			{
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+				             "failed to allocate memory for the bits extracted from "
+				             "ROHC packets");
+				goto destroy_context;
+			}
+		}
+		if(scratch->decoded_values == NULL)
+		{
+			scratch->decoded_values = malloc(profile->decoded_values_size);
+			if(scratch->decoded_values == NULL)
+			{
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
+				             "failed to allocate memory for the values decoded from "
+				             "ROHC packets");
+				goto destroy_context;
+			}
+		}
+		context->volat_ctxt.extr_bits = scratch->extr_bits;
+		context->volat_ctxt.decoded_values = scratch->decoded_values;
+	}
+
 	/* create the profile-specific parts of the decompression context (performed
 	 * at the every end so that everything is initialized in context first) */
 	if(!profile->new_context(context, &context->persist_ctxt, &context->volat_ctxt))
@@ -371,6 +532,20 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	 * might have MAX_CID + 2 contexts) */
 	assert(decomp->num_contexts_used <= (decomp->medium.max_cid + 1));
 	decomp->num_contexts_used++;
+	decomp->ctxts_mem += context->mem_size;
+
+	/* the new context is the most recently used one */
+	context->lru_prev = NULL;
+	context->lru_next = decomp->lru_first;
+	if(decomp->lru_first != NULL)
+	{
+		decomp->lru_first->lru_prev = context;
+	}
+	else
+	{
+		decomp->lru_last = context;
+	}
+	decomp->lru_first = context;
 
 	return context;
 
@@ -389,21 +564,257 @@ error:
  */
 static void context_free(struct rohc_decomp_ctxt *const context)
 {
+	struct rohc_decomp *const decomp = context->decompressor;
+
 	assert(context->decompressor != NULL);
 	assert(context->profile != NULL);
 
 	rohc_debug(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
 	           "free context with CID %u", context->cid);
 
-	/* destroy the profile-specific data */
-	context->profile->free_context(context->persist_ctxt, &context->volat_ctxt);
+	/* destroy the profile-specific data, or keep it for re-use */
+	if(context->profile->free_context != NULL)
+	{
+		context->profile->free_context(context->persist_ctxt);
+	}
+	else
+	{
+		rohc_decomp_persist_ctxt_release(decomp, context->profile,
+		                                 context->persist_ctxt);
+	}
+
+	/* drop the feedback that is still pending for the context */
+	if(context->pending_fb.len > 0)
+	{
+		rohc_decomp_feedback_unqueue(decomp, context);
+	}
 
 	/* decompressor got one more context */
-	assert(context->decompressor->num_contexts_used > 0);
-	context->decompressor->num_contexts_used--;
+	assert(decomp->num_contexts_used > 0);
+	decomp->num_contexts_used--;
+	assert(decomp->ctxts_mem >= context->mem_size);
+	decomp->ctxts_mem -= context->mem_size;
+
+	/* remove the context from the LRU list */
+	if(context->lru_prev != NULL)
+	{
+		context->lru_prev->lru_next = context->lru_next;
+	}
+	else
+	{
+		decomp->lru_first = context->lru_next;
+	}
+	if(context->lru_next != NULL)
+	{
+		context->lru_next->lru_prev = context->lru_prev;
+	}
+	else
+	{
+		decomp->lru_last = context->lru_prev;
+	}
+
+	/* keep the context itself for re-use if the pool is not full yet,
+	 * destroy it otherwise */
+	if(decomp->ctxts_pool_nr < ROHC_DECOMP_CTXTS_POOL_MAX)
+	{
+		context->lru_prev = NULL;
+		context->lru_next = decomp->ctxts_pool;
+		decomp->ctxts_pool = context;
+		decomp->ctxts_pool_nr++;
+	}
+	else
+	{
+		free(context);
+	}
+}
+
+
+/**
+ * @brief Allocate the profile-specific part of one decompression context
+ *
+ * Re-use the profile-specific part of one context of the same profile that
+ * was released before if possible, allocate memory otherwise. The memory is
+ * zeroed in both cases. The decompressor keeps the part for re-use when the
+ * context is destroyed, so the profile shall not define a handler to destroy
+ * it.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param profile  The profile of the new context
+ * @return         The profile-specific part of the context,
+ *                 NULL if no memory is available
+ */
+void * rohc_decomp_persist_ctxt_alloc(struct rohc_decomp *const decomp,
+                                      const struct rohc_decomp_profile *const profile)
+{
+	const uint8_t profile_major = (profile->id >> 8) & 0xff;
+	const uint8_t profile_minor = profile->id & 0xff;
+	struct rohc_decomp_persist_pool *const pool =
+		&(decomp->persist_pools[profile_major][profile_minor]);
+	void *persist_ctxt;
+
+	assert(profile->free_context == NULL);
+	assert(profile->persist_ctxt_size >= sizeof(void *));
+
+	if(pool->first != NULL)
+	{
+		persist_ctxt = pool->first;
+		pool->first = *((void **) persist_ctxt);
+		assert(pool->nr > 0);
+		pool->nr--;
+		memset(persist_ctxt, 0, profile->persist_ctxt_size);
+	}
+	else
+	{
+		persist_ctxt = calloc(1, profile->persist_ctxt_size);
+	}
+
+	return persist_ctxt;
+}
+
+
+/**
+ * @brief Release the profile-specific part of one decompression context
+ *
+ * Keep the profile-specific part for re-use by the next context of the same
+ * profile if the pool is not full yet, destroy it otherwise.
+ *
+ * @param decomp        The ROHC decompressor
+ * @param profile       The profile of the context
+ * @param persist_ctxt  The profile-specific part of the context
+ */
+static void rohc_decomp_persist_ctxt_release(struct rohc_decomp *const decomp,
+                                             const struct rohc_decomp_profile *const profile,
+                                             void *const persist_ctxt)
+{
+	const uint8_t profile_major = (profile->id >> 8) & 0xff;
+	const uint8_t profile_minor = profile->id & 0xff;
+	struct rohc_decomp_persist_pool *const pool =
+		&(decomp->persist_pools[profile_major][profile_minor]);
+
+	if(pool->nr < ROHC_DECOMP_CTXTS_POOL_MAX)
+	{
+		*((void **) persist_ctxt) = pool->first;
+		pool->first = persist_ctxt;
+		pool->nr++;
+	}
+	else
+	{
+		free(persist_ctxt);
+	}
+}
+
+
+/**
+ * @brief Destroy the profile-specific parts kept for re-use for one profile
+ *
+ * @param decomp         The ROHC decompressor
+ * @param profile_major  The major byte of the profile ID
+ * @param profile_minor  The minor byte of the profile ID
+ */
+static void rohc_decomp_persist_free_pool(struct rohc_decomp *const decomp,
+                                          const uint8_t profile_major,
+                                          const uint8_t profile_minor)
+{
+	struct rohc_decomp_persist_pool *const pool =
+		&(decomp->persist_pools[profile_major][profile_minor]);
+
+	while(pool->first != NULL)
+	{
+		void *const persist_ctxt = pool->first;
+		pool->first = *((void **) persist_ctxt);
+		free(persist_ctxt);
+	}
+	pool->nr = 0;
+}
+
+
+/**
+ * @brief Mark the given decompression context as the most recently used one
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The context that was just used
+ */
+static void context_touch(struct rohc_decomp *const decomp,
+                          struct rohc_decomp_ctxt *const context)
+{
+	if(decomp->lru_first == context)
+	{
+		return;
+	}
+
+	/* unlink the context from its current position (it is not the first one) */
+	assert(context->lru_prev != NULL);
+	context->lru_prev->lru_next = context->lru_next;
+	if(context->lru_next != NULL)
+	{
+		context->lru_next->lru_prev = context->lru_prev;
+	}
+	else
+	{
+		decomp->lru_last = context->lru_prev;
+	}
+
+	/* put the context at the head of the list */
+	context->lru_prev = NULL;
+	context->lru_next = decomp->lru_first;
+	decomp->lru_first->lru_prev = context;
+	decomp->lru_first = context;
+}
+
+
+/**
+ * @brief Evict the least recently used contexts until some memory is available
+ *
+ * @param decomp      The ROHC decompressor
+ * @param needed_mem  The memory (in bytes) that shall be available for new
+ *                    contexts once eviction is done
+ * @param kept_ctxt   The context that shall not be evicted, NULL if none
+ * @return            true if the needed memory is available,
+ *                    false if it cannot be made available
+ */
+static bool rohc_decomp_evict_contexts(struct rohc_decomp *const decomp,
+                                       const size_t needed_mem,
+                                       const struct rohc_decomp_ctxt *const kept_ctxt)
+{
+	/* no limit, nothing to evict */
+	if(decomp->ctxts_max_mem == 0)
+	{
+		return true;
+	}
+	if(needed_mem > decomp->ctxts_max_mem)
+	{
+		return false;
+	}
+
+	while(decomp->ctxts_mem > (decomp->ctxts_max_mem - needed_mem))
+	{
+		struct rohc_decomp_ctxt *victim = decomp->lru_last;
+
+		assert(victim != NULL);
+		if(victim == kept_ctxt)
+		{
+			victim = victim->lru_prev;
+			if(victim == NULL)
+			{
+				return false;
+			}
+		}
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, victim->profile->id,
+		           "evict least recently used context with CID %u to respect "
+		           "the %zu-byte memory limit", victim->cid, decomp->ctxts_max_mem);
+		if(decomp->contexts[victim->cid] == victim)
+		{
+			decomp->contexts[victim->cid] = NULL;
+		}
+		if(decomp->last_context == victim)
+		{
+			decomp->last_context = NULL;
+		}
+		context_free(victim);
+		decomp->stats.evicted_contexts++;
+	}
 
-	/* destroy the context itself */
-	free(context);
+	return true;
 }
 
 
@@ -532,6 +943,10 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 		for(profile_minor = 0; profile_minor <= ROHC_PROFILE_ID_MINOR_MAX; profile_minor++)
 		{
 			decomp->enabled_profiles[profile_major][profile_minor] = false;
+			decomp->volat_scratch[profile_major][profile_minor].extr_bits = NULL;
+			decomp->volat_scratch[profile_major][profile_minor].decoded_values = NULL;
+			decomp->persist_pools[profile_major][profile_minor].first = NULL;
+			decomp->persist_pools[profile_major][profile_minor].nr = 0;
 		}
 	}
 
@@ -547,6 +962,14 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 		goto destroy_decomp;
 	}
 	decomp->last_context = NULL;
+	decomp->lru_first = NULL;
+	decomp->lru_last = NULL;
+	decomp->ctxts_pool = NULL;
+	decomp->ctxts_pool_nr = 0;
+	decomp->rfc3095_ctxts_pool = NULL;
+	decomp->rfc3095_ctxts_pool_nr = 0;
+	decomp->ctxts_mem = 0;
+	decomp->ctxts_max_mem = 0; /* no limit by default */
 
 	/* counters and thresholds for feedbacks and downward state transitions */
 	{
@@ -564,10 +987,13 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 		decomp->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent = 0;
 		decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed = 0;
 		decomp->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent = 0;
+		decomp->fb_first = NULL;
+		decomp->fb_last = NULL;
 	}
 
 	/* no Reconstructed Reception Unit (RRU) at the moment */
 	decomp->rru_len = 0;
+	rohc_decomp_rru_fcs_init(&decomp->rru_fcs);
 	/* no segmentation by default */
 	decomp->mrru = 0;
 	decomp->rru = NULL;
@@ -632,6 +1058,41 @@ void rohc_decomp_free(struct rohc_decomp *const decomp)
 	}
 	zfree(decomp->contexts);
 	assert(decomp->num_contexts_used == 0);
+	assert(decomp->ctxts_mem == 0);
+
+	/* destroy the released contexts kept for re-use */
+	while(decomp->ctxts_pool != NULL)
+	{
+		struct rohc_decomp_ctxt *const context = decomp->ctxts_pool;
+		decomp->ctxts_pool = context->lru_next;
+		free(context);
+	}
+	rohc_decomp_rfc3095_free_pool(decomp);
+
+	/* free the parsing scratch areas shared by the contexts of every profile */
+	{
+		size_t profile_major;
+
+		for(profile_major = 0; profile_major <= ROHC_PROFILE_ID_MAJOR_MAX; profile_major++)
+		{
+			size_t profile_minor;
+
+			for(profile_minor = 0; profile_minor <= ROHC_PROFILE_ID_MINOR_MAX; profile_minor++)
+			{
+				struct rohc_decomp_volat_scratch *const scratch =
+					&(decomp->volat_scratch[profile_major][profile_minor]);
+				if(scratch->extr_bits != NULL)
+				{
+					zfree(scratch->extr_bits);
+				}
+				if(scratch->decoded_values != NULL)
+				{
+					zfree(scratch->decoded_values);
+				}
+				rohc_decomp_persist_free_pool(decomp, profile_major, profile_minor);
+			}
+		}
+	}
 
 	/* free RRU buffer */
 	if(decomp->rru != NULL)
@@ -659,75 +1120,987 @@ error:
  *  \li the received feedback \e rcvd_feedback might be empty if the ROHC
  *      packet doesn't contain at least one feedback item
  *
- * If \e feedback_send is not NULL, the decompression may return some feedback
- * information on it. In such a case, the caller is responsible to send it to
- * the compressor through any feedback channel.
+ * If \e feedback_send is not NULL, the decompression may return some feedback
+ * information on it. In such a case, the caller is responsible to send it to
+ * the compressor through any feedback channel.
+ *
+ * Time-related features in the ROHC protocol: set the \e rohc_packet.time
+ * parameter to 0 if arrival time of the ROHC packet is unknown or to disable
+ * the time-related features in the ROHC protocol.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor through
+ *                            the feedback channel:
+ *                            \li If NULL, ignore the received feedback data
+ *                            \li If not NULL, store the received feedback in
+ *                                at the given address
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor through the feedback channel:
+ *                            \li If NULL, the decompression won't generate
+ *                                feedback information for its compressor
+ *                            \li If not NULL, may store the generated
+ *                                feedback at the given address
+ * @return                    Possible return values:
+ *                            \li \ref ROHC_STATUS_OK if a decompressed packet
+ *                                is returned
+ *                            \li \ref ROHC_STATUS_NO_CONTEXT if no
+ *                                 decompression context matches the CID
+ *                                 stored in the given ROHC packet and the
+ *                                 ROHC packet is not an IR packet
+ *                            \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the
+ *                                output buffer is too small for the
+ *                                compressed packet
+ *                            \li \ref ROHC_STATUS_MALFORMED if the
+ *                                decompression failed because the ROHC packet
+ *                                is malformed
+ *                            \li \ref ROHC_STATUS_BAD_CRC if the CRC detected
+ *                                a transmission or decompression problem
+ *                            \li \ref ROHC_STATUS_ERROR if another problem
+ *                                occurred
+ *
+ * @ingroup rohc_decomp
+ *
+ * \par Example #1:
+ * \snippet example_rohc_decomp.c define ROHC decompressor
+ * \snippet example_rohc_decomp.c define IP and ROHC packets
+ * \code
+	...
+\endcode
+ * \snippet example_rohc_decomp.c decompress ROHC packet #1
+ * \snippet example_rohc_decomp.c decompress ROHC packet #2
+ * \snippet example_rohc_decomp.c decompress ROHC packet #3
+ *
+ * @see rohc_decomp_set_mrru
+ * @see rohc_decompress_in_place
+ */
+rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
+                               const struct rohc_buf rohc_packet,
+                               struct rohc_buf *const uncomp_packet,
+                               struct rohc_buf *const rcvd_feedback,
+                               struct rohc_buf *const feedback_send)
+{
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+
+	/* check inputs validity */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(uncomp_packet == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is NULL");
+		goto error;
+	}
+	if(!rohc_decomp_check_pkts(decomp, rohc_packet, *uncomp_packet))
+	{
+		goto error;
+	}
+
+	status = __rohc_decompress(decomp, rohc_packet, false, false, NULL,
+	                           uncomp_packet, rcvd_feedback, feedback_send);
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Decompress a burst of ROHC packets
+ *
+ * Decompress the given ROHC packets one after the other, as successive calls
+ * to \ref rohc_decompress3 would do: the results are exactly the same. The
+ * decompressor is checked once for the whole burst. The CIDs of the next
+ * packets of the burst are decoded in advance, so that their decompression
+ * contexts are fetched into CPU caches while the previous packets are
+ * decompressed, and the packets are not parsed again for their CIDs.
+ *
+ * The \e i-th uncompressed packet, status, received feedback and feedback to
+ * send are the outputs of \ref rohc_decompress3 for the \e i-th ROHC packet.
+ *
+ * @param decomp               The ROHC decompressor
+ * @param rohc_packets         The \e pkts_nr compressed packets to decompress
+ * @param[out] uncomp_packets  The \e pkts_nr resulting uncompressed packets
+ * @param[out] statuses        The \e pkts_nr statuses of the decompressions,
+ *                             see \ref rohc_decompress3 for their values
+ * @param[out] rcvd_feedbacks  The \e pkts_nr feedbacks received from the
+ *                             remote peer for the same-side associated ROHC
+ *                             compressor, NULL to ignore them
+ * @param[out] feedbacks_send  The \e pkts_nr feedbacks to be transmitted to
+ *                             the remote compressor, NULL to generate none
+ * @param pkts_nr              The number of packets in the burst
+ * @return                     \ref ROHC_STATUS_OK if all the packets of the
+ *                             burst were handled, see \e statuses for the
+ *                             result of every packet,
+ *                             \ref ROHC_STATUS_ERROR if the parameters are
+ *                             invalid and no packet was handled
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+rohc_status_t rohc_decompress_burst(struct rohc_decomp *const decomp,
+                                    const struct rohc_buf *const rohc_packets,
+                                    struct rohc_buf *const uncomp_packets,
+                                    rohc_status_t *const statuses,
+                                    struct rohc_buf *const rcvd_feedbacks,
+                                    struct rohc_buf *const feedbacks_send,
+                                    const size_t pkts_nr)
+{
+	size_t first_pkt_pos;
+
+	/* check inputs validity, packets are checked one by one later */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_packets == NULL || uncomp_packets == NULL || statuses == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packets, uncomp_packets or statuses is NULL");
+		goto error;
+	}
+
+	for(first_pkt_pos = 0; first_pkt_pos < pkts_nr;
+	    first_pkt_pos += ROHC_DECOMP_BURST_PREFETCH_NR)
+	{
+		const size_t chunk_len =
+			rohc_min(pkts_nr - first_pkt_pos, ROHC_DECOMP_BURST_PREFETCH_NR);
+		struct rohc_decomp_peeked_cid peeked[ROHC_DECOMP_BURST_PREFETCH_NR];
+		const struct rohc_decomp_ctxt *ctxts[ROHC_DECOMP_BURST_PREFETCH_NR];
+		bool is_valid[ROHC_DECOMP_BURST_PREFETCH_NR];
+		bool is_peeked[ROHC_DECOMP_BURST_PREFETCH_NR];
+		size_t i;
+
+		/* check the next packets of the burst, decode their CIDs and prefetch
+		 * their contexts */
+		for(i = 0; i < chunk_len; i++)
+		{
+			const size_t pkt_pos = first_pkt_pos + i;
+
+			is_valid[i] = rohc_decomp_check_pkts(decomp, rohc_packets[pkt_pos],
+			                                     uncomp_packets[pkt_pos]);
+			is_peeked[i] = (is_valid[i] &&
+			                rohc_decomp_peek_cid(decomp, rohc_packets[pkt_pos],
+			                                     &peeked[i]));
+			ctxts[i] = (is_peeked[i] ? decomp->contexts[peeked[i].cid] : NULL);
+			if(ctxts[i] != NULL)
+			{
+				__builtin_prefetch(ctxts[i], 1);
+			}
+		}
+
+		/* prefetch the profile-specific parts of the contexts, the contexts
+		 * are not changed until the packets of the chunk are decompressed */
+		for(i = 0; i < chunk_len; i++)
+		{
+			if(ctxts[i] != NULL)
+			{
+				__builtin_prefetch(ctxts[i]->persist_ctxt, 1);
+			}
+		}
+
+		/* decompress the packets in order, without parsing their CIDs again */
+		for(i = 0; i < chunk_len; i++)
+		{
+			const size_t pkt_pos = first_pkt_pos + i;
+
+			if(!is_valid[i])
+			{
+				statuses[pkt_pos] = ROHC_STATUS_ERROR;
+				continue;
+			}
+			statuses[pkt_pos] =
+				__rohc_decompress(decomp, rohc_packets[pkt_pos], false, false,
+				                  (is_peeked[i] ? &peeked[i] : NULL),
+				                  &uncomp_packets[pkt_pos],
+				                  (rcvd_feedbacks != NULL ? &rcvd_feedbacks[pkt_pos] : NULL),
+				                  (feedbacks_send != NULL ? &feedbacks_send[pkt_pos] : NULL));
+		}
+	}
+
+	return ROHC_STATUS_OK;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet in place
+ *
+ * Decompress the given ROHC packet into an uncompressed packet that shares
+ * the buffer of the ROHC packet. The uncompressed headers are written right
+ * before the payload of the ROHC packet, so the payload is not copied.
+ *
+ * The uncompressed headers are usually larger than the ROHC headers, so the
+ * caller shall reserve some space in front of the ROHC packet: set the
+ * \e offset field of the \e packet buffer to the length of that headroom.
+ * The ROHC headers are overwritten by the uncompressed headers.
+ *
+ * In case of success, \e packet describes the uncompressed packet on output:
+ * its \e offset and \e len fields are updated, its \e data and \e max_len
+ * fields are not. The uncompressed packet might be empty for the same reasons
+ * as with \ref rohc_decompress3. In case of failure, the uncompressed packet
+ * is empty and the ROHC packet shall be considered lost.
+ *
+ * A ROHC packet that is the final segment of a ROHC Reconstructed Reception
+ * Unit (RRU) cannot be decompressed in place since its payload is stored in
+ * the decompressor: the uncompressed packet is then written from the very
+ * beginning of the buffer, like with \ref rohc_decompress3.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param[in,out] packet      IN:  The compressed packet to decompress
+ *                            OUT: The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor, see
+ *                            \ref rohc_decompress3
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, see \ref rohc_decompress3
+ * @return                    The same return values as \ref rohc_decompress3,
+ *                            \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the headroom
+ *                            is too small for the uncompressed headers
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+rohc_status_t rohc_decompress_in_place(struct rohc_decomp *const decomp,
+                                       struct rohc_buf *const packet,
+                                       struct rohc_buf *const rcvd_feedback,
+                                       struct rohc_buf *const feedback_send)
+{
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	struct rohc_buf uncomp_packet;
+
+	/* check inputs validity */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(packet == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet is malformed");
+		goto error;
+	}
+	if(rohc_buf_is_empty(*packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet is empty");
+		goto error;
+	}
+
+	/* the uncompressed packet shares the buffer of the ROHC packet, the
+	 * uncompressed headers are built from the beginning of the buffer, then
+	 * moved in front of the payload */
+	uncomp_packet = *packet;
+	uncomp_packet.offset = 0;
+	uncomp_packet.len = 0;
+
+	status = __rohc_decompress(decomp, *packet, false, true, NULL, &uncomp_packet,
+	                           rcvd_feedback, feedback_send);
+	packet->offset = uncomp_packet.offset;
+	packet->len = uncomp_packet.len;
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Decompress the ROHC packet carried by the given ROHC segments
+ *
+ * Reassemble the Reconstructed Reception Unit (RRU) carried by the given ROHC
+ * segments, then decompress it. Contrary to \ref rohc_decompress3, the
+ * segments are not copied into the decompressor one after the other: all the
+ * segments of the RRU are given at once, in order, in buffers owned by the
+ * caller. The FCS-32 of the RRU is computed while walking through the
+ * segments.
+ *
+ * If the RRU is carried by one single segment, it is decompressed right from
+ * the buffer of that segment. Otherwise, the RRU is gathered once at the very
+ * end of the buffer of the uncompressed packet, then decompressed in place as
+ * with \ref rohc_decompress_in_place: the payload is not copied again, and the
+ * \e offset field of the uncompressed packet is updated on output.
+ *
+ * Every ROHC segment may start with padding and feedback items. All segments
+ * but the last one shall be non-final segments, the last one shall be a final
+ * segment. The RRU that \ref rohc_decompress3 might be reassembling is not
+ * affected.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param segments            The \e segments_nr ROHC segments of the RRU
+ * @param segments_nr         The number of ROHC segments of the RRU
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor in all
+ *                            the segments, see \ref rohc_decompress3
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, see \ref rohc_decompress3
+ * @return                    The same return values as \ref rohc_decompress3,
+ *                            \ref ROHC_STATUS_MALFORMED if the segments do not
+ *                            form one RRU or if the RRU is larger than MRRU,
+ *                            \ref ROHC_STATUS_BAD_CRC if the FCS-32 of the
+ *                            RRU is wrong, \ref ROHC_STATUS_OUTPUT_TOO_SMALL
+ *                            if the uncompressed packet is too small for the
+ *                            segments
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ * @see rohc_decomp_set_mrru
+ */
+rohc_status_t rohc_decompress_segments(struct rohc_decomp *const decomp,
+                                       const struct rohc_buf *const segments,
+                                       const size_t segments_nr,
+                                       struct rohc_buf *const uncomp_packet,
+                                       struct rohc_buf *const rcvd_feedback,
+                                       struct rohc_buf *const feedback_send)
+{
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	struct rohc_decomp_rru_fcs rru_fcs;
+	struct rohc_buf uncomp_buf;
+	struct rohc_buf rru;
+	uint8_t *rru_data = NULL;
+	size_t segments_len = 0;
+	size_t rru_len = 0;
+	size_t i;
+
+	/* check inputs validity */
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(segments == NULL || segments_nr == 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "no ROHC segment given");
+		goto error;
+	}
+	for(i = 0; i < segments_nr; i++)
+	{
+		if(rohc_buf_is_malformed(segments[i]))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given ROHC segment #%zu is malformed", i + 1);
+			goto error;
+		}
+		segments_len += segments[i].len;
+	}
+	if(uncomp_packet == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*uncomp_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*uncomp_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is not empty");
+		goto error;
+	}
+	if(rcvd_feedback != NULL)
+	{
+		if(rohc_buf_is_malformed(*rcvd_feedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given rcvd_feedback is malformed");
+			goto error;
+		}
+		if(!rohc_buf_is_empty(*rcvd_feedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given rcvd_feedback is not empty");
+			goto error;
+		}
+	}
+
+	/* every segment is one received packet, the last one is accounted for
+	 * when the RRU is decompressed */
+	decomp->stats.received += segments_nr - 1;
+
+	/* several segments: gather the RRU at the end of the output buffer, so
+	 * that there is as much room as possible for the uncompressed headers */
+	if(segments_nr > 1)
+	{
+		if(segments_len > rohc_buf_avail_len(*uncomp_packet))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "output buffer is too small for the %zu bytes of the "
+			             "%zu ROHC segments", segments_len, segments_nr);
+			status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+			goto error_segments;
+		}
+		rru_data = uncomp_packet->data + uncomp_packet->max_len - segments_len;
+	}
+
+	/* walk through the segments */
+	rohc_decomp_rru_fcs_init(&rru_fcs);
+	for(i = 0; i < segments_nr; i++)
+	{
+		struct rohc_buf segment = segments[i];
+		const bool is_last = (i == (segments_nr - 1));
+		bool is_final;
+
+		rohc_decomp_parse_padding(decomp, &segment);
+
+		/* the feedback items of all segments are stored one after the other */
+		if(rcvd_feedback != NULL)
+		{
+			struct rohc_buf segment_feedback = *rcvd_feedback;
+			bool parsing_ok;
+
+			rohc_buf_pull(&segment_feedback, rcvd_feedback->len);
+			parsing_ok =
+				rohc_decomp_parse_feedbacks(decomp, &segment, &segment_feedback);
+			rcvd_feedback->len += segment_feedback.len;
+			if(!parsing_ok)
+			{
+				goto error_malformed;
+			}
+		}
+		else if(!rohc_decomp_parse_feedbacks(decomp, &segment, NULL))
+		{
+			goto error_malformed;
+		}
+
+		if(segment.len == 0 ||
+		   !rohc_decomp_packet_is_segment(rohc_buf_data(segment)))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "ROHC packet #%zu is not a ROHC segment", i + 1);
+			goto error_malformed;
+		}
+		is_final = !!GET_REAL(GET_BIT_0(rohc_buf_data(segment)));
+		if(is_final != is_last)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "ROHC segment #%zu/%zu is unexpectedly a %s segment",
+			             i + 1, segments_nr, is_final ? "final" : "non-final");
+			goto error_malformed;
+		}
+		rohc_buf_pull(&segment, 1);
+
+		if((rru_len + segment.len) > decomp->mrru)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "invalid RRU: ROHC segment #%zu is too large for MRRU "
+			             "(%zu bytes already received, %zu bytes received, "
+			             "MRRU = %zu bytes", i + 1, rru_len, segment.len,
+			             decomp->mrru);
+			goto error_malformed;
+		}
+		rohc_decomp_rru_fcs_update(&rru_fcs, rohc_buf_data(segment), segment.len);
+		if(rru_data != NULL)
+		{
+			memcpy(rru_data + rru_len, rohc_buf_data(segment), segment.len);
+		}
+		else
+		{
+			rru = segment;
+		}
+		rru_len += segment.len;
+	}
+
+	/* all segments received, let's check CRC */
+	if(rru_len <= CRC_FCS32_LEN)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "invalid %zd-byte RRU: should be more than 4-byte long",
+		             rru_len);
+		goto error_malformed;
+	}
+	rru_len -= CRC_FCS32_LEN;
+	if(!rohc_decomp_rru_fcs_check(&rru_fcs))
+	{
+		uint32_t crc_packet;
+		memcpy(&crc_packet, rru_fcs.tail, CRC_FCS32_LEN);
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "invalid %zd-byte RRU: bad CRC (packet = 0x%08x, "
+		             "computed = 0x%08x)", rru_len, rohc_ntoh32(crc_packet),
+		             rohc_ntoh32(rru_fcs.crc));
+		decomp->stats.received++;
+		decomp->stats.failed_crc++;
+		status = ROHC_STATUS_BAD_CRC;
+		goto error;
+	}
+
+	/* decode the RRU: in place if it was gathered in the output buffer */
+	uncomp_buf = *uncomp_packet;
+	if(rru_data != NULL)
+	{
+		rru = *uncomp_packet;
+		rru.offset = rru_data - uncomp_packet->data;
+	}
+	rru.len = rru_len;
+	status = __rohc_decompress(decomp, rru, true, (rru_data != NULL), NULL,
+	                           &uncomp_buf, NULL, feedback_send);
+	uncomp_packet->offset = uncomp_buf.offset;
+	uncomp_packet->len = uncomp_buf.len;
+
+error:
+	return status;
+
+error_malformed:
+	status = ROHC_STATUS_MALFORMED;
+error_segments:
+	decomp->stats.received++;
+	decomp->stats.failed_decomp++;
+	return status;
+}
+
+
+/**
+ * @brief Flush the feedbacks coalesced by the decompressor
+ *
+ * When the \ref ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK feature is enabled,
+ * the decompression functions do not return the feedbacks for the remote
+ * compressor in their \e feedback_send parameter anymore. Instead, every
+ * context keeps its last feedback: a new ACK replaces the pending ACK, and a
+ * new NACK or STATIC-NACK replaces any pending feedback. The feedbacks for
+ * packets without context are still returned in \e feedback_send.
+ *
+ * The function appends the pending feedbacks to the given buffer, oldest
+ * first, as many as the buffer can hold. The feedbacks that do not fit in
+ * the buffer are kept for the next flush. The pending feedback of one
+ * context is lost if the context is destroyed before the flush.
+ *
+ * The feedbacks may be sent in one packet on the feedback channel, or
+ * piggybacked on the next ROHC packet sent to the remote compressor by
+ * flushing them in front of it.
+ *
+ * @param decomp         The ROHC decompressor
+ * @param[out] feedbacks  The buffer to append the feedbacks to
+ * @return               The number of feedbacks appended to the buffer
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_features
+ */
+size_t rohc_decomp_flush_feedback(struct rohc_decomp *const decomp,
+                                  struct rohc_buf *const feedbacks)
+{
+	size_t feedbacks_nr = 0;
+	size_t feedbacks_len = 0;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(feedbacks == NULL || rohc_buf_is_malformed(*feedbacks))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given feedbacks buffer is malformed");
+		goto error;
+	}
+
+	while(decomp->fb_first != NULL)
+	{
+		struct rohc_decomp_ctxt *const context = decomp->fb_first;
+
+		if((feedbacks->len + context->pending_fb.len) >
+		   rohc_buf_avail_len(*feedbacks))
+		{
+			break;
+		}
+		rohc_buf_append(feedbacks, context->pending_fb.data,
+		                context->pending_fb.len);
+		feedbacks_len += context->pending_fb.len;
+		feedbacks_nr++;
+		rohc_decomp_feedback_unqueue(decomp, context);
+	}
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "%zu feedbacks flushed in %zu bytes, %s", feedbacks_nr,
+	           feedbacks_len, decomp->fb_first != NULL ?
+	           "others are still pending" : "no more pending feedback");
+
+	return feedbacks_nr;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Create a new pool of ROHC decompressors for one ROHC channel
+ *
+ * The CIDs of the channel are split into \e workers_nr ranges of the same
+ * size. Every worker owns one range of CIDs and one ROHC decompressor with
+ * its own contexts, parsing scratch, feedback counters and statistics, so
+ * the workers may decompress packets on different threads without any lock.
+ *
+ * The library does not create any thread: the application reads the ROHC
+ * channel, finds the worker of every ROHC packet with
+ * \ref rohc_decomp_pool_dispatch, then hands the packet to the thread that
+ * runs that worker. The thread decompresses the packets of its worker in
+ * their order of arrival with \ref rohc_decomp_pool_decompress, so the
+ * packets of every flow are decompressed in order.
+ *
+ * The feedbacks generated by the workers are queued in the pool, they are
+ * read with \ref rohc_decomp_pool_get_feedbacks by one single thread, for
+ * example the one that sends packets on the reverse channel.
+ *
+ * Every worker shall be configured like a single decompressor (profiles,
+ * traces, features...) with the decompressor returned by
+ * \ref rohc_decomp_pool_get_worker before the first packet is dispatched.
+ *
+ * @param cid_type    The type of Context IDs (CID) that the channel uses
+ * @param max_cid     The maximum value that the channel may use for CIDs
+ * @param mode        The operational mode that the decompressors target
+ * @param workers_nr  The number of workers in
+ *                    [1, min(MAX_CID + 1, ROHC_DECOMP_POOL_WORKERS_MAX)]
+ * @return            The created pool if successful,
+ *                    NULL if creation failed
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_pool_free
+ * @see rohc_decomp_pool_get_worker
+ * @see rohc_decomp_pool_dispatch
+ * @see rohc_decomp_pool_decompress
+ * @see rohc_decomp_pool_get_feedbacks
+ */
+struct rohc_decomp_pool * rohc_decomp_pool_new(const rohc_cid_type_t cid_type,
+                                               const rohc_cid_t max_cid,
+                                               const rohc_mode_t mode,
+                                               const size_t workers_nr)
+{
+	struct rohc_decomp_pool *pool;
+	size_t worker_id;
+
+	/* check input parameters, others are checked by rohc_decomp_new2() */
+	if(workers_nr == 0 || workers_nr > ROHC_DECOMP_POOL_WORKERS_MAX ||
+	   workers_nr > (((size_t) max_cid) + 1))
+	{
+		goto error;
+	}
+
+	pool = malloc(sizeof(struct rohc_decomp_pool));
+	if(pool == NULL)
+	{
+		goto error;
+	}
+	pool->workers_nr = workers_nr;
+	pool->cids_per_worker = (((size_t) max_cid) + workers_nr) / workers_nr;
+	pool->next_fb_worker = 0;
+
+	pool->workers = calloc(workers_nr, sizeof(struct rohc_decomp_pool_worker));
+	if(pool->workers == NULL)
+	{
+		goto free_pool;
+	}
+
+	/* create one decompressor per worker, all of them accept the whole range
+	 * of CIDs since the CIDs of the packets are not translated */
+	for(worker_id = 0; worker_id < workers_nr; worker_id++)
+	{
+		struct rohc_decomp_pool_worker *const worker = &(pool->workers[worker_id]);
+
+		worker->decomp = rohc_decomp_new2(cid_type, max_cid, mode);
+		if(worker->decomp == NULL)
+		{
+			goto free_workers;
+		}
+		worker->fb_head = 0;
+		worker->fb_tail = 0;
+		worker->fbs_dropped_nr = 0;
+	}
+
+	return pool;
+
+free_workers:
+	for(worker_id = 0; worker_id < workers_nr; worker_id++)
+	{
+		rohc_decomp_free(pool->workers[worker_id].decomp);
+	}
+	free(pool->workers);
+free_pool:
+	free(pool);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given pool of ROHC decompressors
+ *
+ * No worker shall be running when the pool is destroyed.
+ *
+ * @param pool  The pool to destroy
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_pool_new
+ */
+void rohc_decomp_pool_free(struct rohc_decomp_pool *const pool)
+{
+	size_t worker_id;
+
+	if(pool == NULL)
+	{
+		return;
+	}
+
+	for(worker_id = 0; worker_id < pool->workers_nr; worker_id++)
+	{
+		rohc_decomp_free(pool->workers[worker_id].decomp);
+	}
+	free(pool->workers);
+	free(pool);
+}
+
+
+/**
+ * @brief Get the ROHC decompressor of one worker of the pool
+ *
+ * The decompressor may be used to configure the worker before packets are
+ * dispatched, or to retrieve its statistics. It shall not be used to
+ * decompress packets: use \ref rohc_decomp_pool_decompress instead, so that
+ * the feedbacks are queued in the pool.
+ *
+ * @param pool       The pool of ROHC decompressors
+ * @param worker_id  The ID of the worker in [0, workers_nr - 1]
+ * @return           The ROHC decompressor of the worker,
+ *                   NULL if the parameters are invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_pool_new
+ */
+struct rohc_decomp * rohc_decomp_pool_get_worker(const struct rohc_decomp_pool *const pool,
+                                                 const size_t worker_id)
+{
+	if(pool == NULL || worker_id >= pool->workers_nr)
+	{
+		return NULL;
+	}
+
+	return pool->workers[worker_id].decomp;
+}
+
+
+/**
+ * @brief Find the worker that shall decompress the given ROHC packet
+ *
+ * Only the padding, the feedback items and the CID of the ROHC packet are
+ * parsed, no context is accessed: the function may be called by the thread
+ * that reads the ROHC channel while the workers decompress other packets.
+ *
+ * The packets without CID (feedback-only packets and ROHC segments) and the
+ * malformed packets are dispatched to the first worker, that will handle or
+ * reject them. The CID of a ROHC segment is known only once all segments of
+ * the Reconstructed Reception Unit (RRU) were received, so channels that use
+ * segmentation shall be decompressed by pools of one single worker.
+ *
+ * @param pool            The pool of ROHC decompressors
+ * @param rohc_packet     The ROHC packet to dispatch
+ * @param[out] worker_id  The ID of the worker that shall decompress the packet
+ * @return                true if the packet was dispatched,
+ *                        false if the parameters are invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_pool_decompress
+ */
+bool rohc_decomp_pool_dispatch(const struct rohc_decomp_pool *const pool,
+                               const struct rohc_buf rohc_packet,
+                               size_t *const worker_id)
+{
+	struct rohc_decomp_peeked_cid peeked;
+
+	if(pool == NULL || worker_id == NULL)
+	{
+		goto error;
+	}
+
+	if(!rohc_buf_is_malformed(rohc_packet) &&
+	   rohc_decomp_peek_cid(pool->workers[0].decomp, rohc_packet, &peeked))
+	{
+		*worker_id = peeked.cid / pool->cids_per_worker;
+		assert((*worker_id) < pool->workers_nr);
+	}
+	else
+	{
+		*worker_id = 0;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decompress one ROHC packet with one worker of the pool
+ *
+ * Decompress the ROHC packet like \ref rohc_decompress3 does with the
+ * decompressor of the given worker. The feedback generated for the remote
+ * compressor, if any, is queued in the pool. Only one thread at a time
+ * shall call the function for a given worker.
+ *
+ * The ROHC packet shall have been dispatched to the worker by
+ * \ref rohc_decomp_pool_dispatch. The feedback is dropped if the queue of
+ * the worker is full: feedbacks are not mandatory for the correctness of
+ * the decompression.
+ *
+ * @param pool                The pool of ROHC decompressors
+ * @param worker_id           The ID of the worker that decompresses the packet
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] uncomp_packet  The resulting uncompressed packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor, see
+ *                            \ref rohc_decompress3
+ * @return                    The same return values as
+ *                            \ref rohc_decompress3
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_pool_dispatch
+ * @see rohc_decomp_pool_get_feedbacks
+ */
+rohc_status_t rohc_decomp_pool_decompress(struct rohc_decomp_pool *const pool,
+                                          const size_t worker_id,
+                                          const struct rohc_buf rohc_packet,
+                                          struct rohc_buf *const uncomp_packet,
+                                          struct rohc_buf *const rcvd_feedback)
+{
+	struct rohc_decomp_pool_worker *worker;
+	uint8_t feedback_data[ROHC_DECOMP_POOL_FEEDBACK_MAX_LEN];
+	struct rohc_buf feedback_send =
+		rohc_buf_init_empty(feedback_data, ROHC_DECOMP_POOL_FEEDBACK_MAX_LEN);
+	struct rohc_decomp_pool_feedback *fb = NULL;
+	rohc_status_t status;
+	size_t fb_tail;
+	size_t fb_head;
+
+	if(pool == NULL || worker_id >= pool->workers_nr)
+	{
+		return ROHC_STATUS_ERROR;
+	}
+	worker = &(pool->workers[worker_id]);
+
+	/* build the feedback for the remote compressor directly in the next free
+	 * slot of the queue if any, in a temporary buffer otherwise */
+	fb_tail = worker->fb_tail;
+	fb_head = __atomic_load_n(&worker->fb_head, __ATOMIC_ACQUIRE);
+	if((fb_tail - fb_head) < ROHC_DECOMP_POOL_FEEDBACK_QUEUE_LEN)
+	{
+		fb = &(worker->fbs[fb_tail % ROHC_DECOMP_POOL_FEEDBACK_QUEUE_LEN]);
+		feedback_send.data = fb->data;
+	}
+
+	status = rohc_decompress3(worker->decomp, rohc_packet, uncomp_packet,
+	                          rcvd_feedback, &feedback_send);
+
+	/* queue the feedback if any */
+	if(!rohc_buf_is_empty(feedback_send))
+	{
+		if(fb == NULL)
+		{
+			rohc_warning(worker->decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "worker #%zu: queue of feedbacks is full, drop the "
+			             "%zu-byte feedback", worker_id, feedback_send.len);
+			worker->fbs_dropped_nr++;
+		}
+		else
+		{
+			fb->len = feedback_send.len;
+			__atomic_store_n(&worker->fb_tail, fb_tail + 1, __ATOMIC_RELEASE);
+		}
+	}
+
+	return status;
+}
+
+
+/**
+ * @brief Get the feedbacks generated by the workers of the pool
+ *
+ * Append the feedbacks queued by the workers to the given buffer, as many as
+ * the buffer can hold. The feedbacks of every worker are appended in the
+ * order they were generated, the workers are visited in a round-robin way.
+ * The feedbacks that do not fit in the buffer are kept for the next call.
  *
- * Time-related features in the ROHC protocol: set the \e rohc_packet.time
- * parameter to 0 if arrival time of the ROHC packet is unknown or to disable
- * the time-related features in the ROHC protocol.
+ * Only one thread at a time shall call the function for a given pool, but
+ * it may run while the workers decompress packets.
  *
- * @param decomp              The ROHC decompressor
- * @param rohc_packet         The compressed packet to decompress
- * @param[out] uncomp_packet  The resulting uncompressed packet
- * @param[out] rcvd_feedback  The feedback received from the remote peer for
- *                            the same-side associated ROHC compressor through
- *                            the feedback channel:
- *                            \li If NULL, ignore the received feedback data
- *                            \li If not NULL, store the received feedback in
- *                                at the given address
- * @param[out] feedback_send  The feedback to be transmitted to the remote
- *                            compressor through the feedback channel:
- *                            \li If NULL, the decompression won't generate
- *                                feedback information for its compressor
- *                            \li If not NULL, may store the generated
- *                                feedback at the given address
- * @return                    Possible return values:
- *                            \li \ref ROHC_STATUS_OK if a decompressed packet
- *                                is returned
- *                            \li \ref ROHC_STATUS_NO_CONTEXT if no
- *                                 decompression context matches the CID
- *                                 stored in the given ROHC packet and the
- *                                 ROHC packet is not an IR packet
- *                            \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the
- *                                output buffer is too small for the
- *                                compressed packet
- *                            \li \ref ROHC_STATUS_MALFORMED if the
- *                                decompression failed because the ROHC packet
- *                                is malformed
- *                            \li \ref ROHC_STATUS_BAD_CRC if the CRC detected
- *                                a transmission or decompression problem
- *                            \li \ref ROHC_STATUS_ERROR if another problem
- *                                occurred
+ * @param pool           The pool of ROHC decompressors
+ * @param[out] feedbacks  The buffer to append the feedbacks to
+ * @return               The number of feedbacks appended to the buffer
  *
  * @ingroup rohc_decomp
  *
- * \par Example #1:
- * \snippet example_rohc_decomp.c define ROHC decompressor
- * \snippet example_rohc_decomp.c define IP and ROHC packets
- * \code
-	...
-\endcode
- * \snippet example_rohc_decomp.c decompress ROHC packet #1
- * \snippet example_rohc_decomp.c decompress ROHC packet #2
- * \snippet example_rohc_decomp.c decompress ROHC packet #3
- *
- * @see rohc_decomp_set_mrru
+ * @see rohc_decomp_pool_decompress
  */
-rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
-                               const struct rohc_buf rohc_packet,
-                               struct rohc_buf *const uncomp_packet,
-                               struct rohc_buf *const rcvd_feedback,
-                               struct rohc_buf *const feedback_send)
+size_t rohc_decomp_pool_get_feedbacks(struct rohc_decomp_pool *const pool,
+                                      struct rohc_buf *const feedbacks)
 {
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
-	struct rohc_decomp_stream stream;
+	size_t feedbacks_nr = 0;
+	size_t i;
 
-	/* check inputs validity */
-	if(decomp == NULL)
+	if(pool == NULL || feedbacks == NULL || rohc_buf_is_malformed(*feedbacks))
 	{
-		goto error;
+		return 0;
+	}
+
+	for(i = 0; i < pool->workers_nr; i++)
+	{
+		const size_t worker_id = (pool->next_fb_worker + i) % pool->workers_nr;
+		struct rohc_decomp_pool_worker *const worker = &(pool->workers[worker_id]);
+		const size_t fb_tail = __atomic_load_n(&worker->fb_tail, __ATOMIC_ACQUIRE);
+		size_t fb_head = worker->fb_head;
+
+		while(fb_head != fb_tail)
+		{
+			const struct rohc_decomp_pool_feedback *const fb =
+				&(worker->fbs[fb_head % ROHC_DECOMP_POOL_FEEDBACK_QUEUE_LEN]);
+
+			if((feedbacks->len + fb->len) > rohc_buf_avail_len(*feedbacks))
+			{
+				break;
+			}
+			rohc_buf_append(feedbacks, fb->data, fb->len);
+			feedbacks_nr++;
+			fb_head++;
+		}
+		__atomic_store_n(&worker->fb_head, fb_head, __ATOMIC_RELEASE);
 	}
+	pool->next_fb_worker = (pool->next_fb_worker + 1) % pool->workers_nr;
+
+	return feedbacks_nr;
+}
+
+
+/**
+ * @brief Check the ROHC and uncompressed packets given for decompression
+ *
+ * @param decomp         The ROHC decompressor
+ * @param rohc_packet    The compressed packet to decompress
+ * @param uncomp_packet  The buffer for the uncompressed packet
+ * @return               true if the packets are valid, false otherwise
+ */
+static bool rohc_decomp_check_pkts(const struct rohc_decomp *const decomp,
+                                   const struct rohc_buf rohc_packet,
+                                   const struct rohc_buf uncomp_packet)
+{
 	if(rohc_buf_is_malformed(rohc_packet))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
@@ -740,24 +2113,62 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 		             "given rohc_packet is empty");
 		goto error;
 	}
-	if(uncomp_packet == NULL)
-	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is NULL");
-		goto error;
-	}
-	if(rohc_buf_is_malformed(*uncomp_packet))
+	if(rohc_buf_is_malformed(uncomp_packet))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "given uncomp_packet is malformed");
 		goto error;
 	}
-	if(!rohc_buf_is_empty(*uncomp_packet))
+	if(!rohc_buf_is_empty(uncomp_packet))
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "given uncomp_packet is not empty");
 		goto error;
 	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet into one uncompressed packet
+ *
+ * The common part of \ref rohc_decompress3, \ref rohc_decompress_in_place
+ * and \ref rohc_decompress_segments once the ROHC and uncompressed packets
+ * were checked.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The compressed packet to decompress
+ * @param is_rru              Whether \e rohc_packet is a RRU that was already
+ *                            reassembled from its segments or not
+ * @param in_place            Whether \e uncomp_packet shares the buffer of
+ *                            \e rohc_packet, so that the uncompressed packet
+ *                            is built in place, or not
+ * @param peeked              The padding, feedback items and CID of
+ *                            \e rohc_packet if they were already parsed,
+ *                            NULL otherwise
+ * @param[out] uncomp_packet  The resulting uncompressed packet, it may share
+ *                            the buffer of \e rohc_packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor
+ * @return                    The same return values as \ref rohc_decompress3
+ */
+static rohc_status_t __rohc_decompress(struct rohc_decomp *const decomp,
+                                       const struct rohc_buf rohc_packet,
+                                       const bool is_rru,
+                                       const bool in_place,
+                                       const struct rohc_decomp_peeked_cid *const peeked,
+                                       struct rohc_buf *const uncomp_packet,
+                                       struct rohc_buf *const rcvd_feedback,
+                                       struct rohc_buf *const feedback_send)
+{
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	struct rohc_decomp_stream stream;
+
 	if(rcvd_feedback != NULL)
 	{
 		if(rohc_buf_is_malformed(*rcvd_feedback))
@@ -803,8 +2214,8 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
 	}
 
 	/* decode ROHC header */
-	status = d_decode_header(decomp, rohc_packet, uncomp_packet, rcvd_feedback,
-	                         &stream);
+	status = d_decode_header(decomp, rohc_packet, is_rru, in_place, peeked,
+	                         uncomp_packet, rcvd_feedback, &stream);
 	assert(status != ROHC_STATUS_SEGMENT);
 
 	/* handle mode transitions if context was found and it is still valid */
@@ -952,6 +2363,15 @@ error:
  *
  * @param decomp              The ROHC decompressor
  * @param rohc_packet         The ROHC packet to decode
+ * @param is_rru              Whether \e rohc_packet is a RRU that was already
+ *                            reassembled from its segments or not: a RRU
+ *                            contains neither padding, nor feedback, nor
+ *                            segment header
+ * @param in_place            Whether \e uncomp_packet shares the buffer of
+ *                            \e rohc_packet or not, see \ref __rohc_decompress
+ * @param peeked              The padding, feedback items and CID of
+ *                            \e rohc_packet if they were already parsed,
+ *                            NULL otherwise
  * @param[out] uncomp_packet  The uncompressed packet
  * @param[out] rcvd_feedback  The feedback received from the remote peer for
  *                            the same-side associated ROHC compressor through
@@ -974,6 +2394,9 @@ error:
  */
 static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
                                      const struct rohc_buf rohc_packet,
+                                     const bool is_rru,
+                                     const bool in_place,
+                                     const struct rohc_decomp_peeked_cid *const peeked,
                                      struct rohc_buf *const uncomp_packet,
                                      struct rohc_buf *const rcvd_feedback,
                                      struct rohc_decomp_stream *const stream)
@@ -988,6 +2411,9 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	const uint8_t *walk;
 	size_t remain_len;
 
+	/* whether the uncompressed packet is built in the ROHC packet or not */
+	bool decode_in_place = in_place;
+
 	rohc_status_t status;
 
 	/* at the beginning, context is not found yet but channel CID type is known */
@@ -1014,6 +2440,38 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 		goto error_malformed;
 	}
 
+	/* a RRU reassembled by the caller was already stripped of padding,
+	 * feedback and segment headers */
+	if(is_rru)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "decode the %zu-byte RRU", remain_rohc_data.len);
+		goto decode_rru;
+	}
+
+	/* the padding, feedback items and CID of the packet were already parsed
+	 * by the caller, skip them without parsing them again */
+	if(peeked != NULL)
+	{
+		rohc_buf_pull(&remain_rohc_data, peeked->padding_len);
+		if(peeked->feedbacks_len > 0 &&
+		   !rohc_decomp_parse_feedbacks(decomp, &remain_rohc_data, rcvd_feedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "failed to decode feedback items at the beginning of "
+			             "the ROHC packet");
+			goto error_malformed;
+		}
+		walk = rohc_buf_data(remain_rohc_data);
+		remain_len = remain_rohc_data.len;
+		stream->cid = peeked->cid;
+		add_cid_len = peeked->add_cid_len;
+		large_cid_len = peeked->large_cid_len;
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "CID %u already decoded", stream->cid);
+		goto cid_decoded;
+	}
+
 	/* skip padding bits if some are present */
 	rohc_decomp_parse_padding(decomp, &remain_rohc_data);
 
@@ -1041,8 +2499,6 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 		           "decompressor received %zu bytes of feedback for the "
 		           "same-side associated compressor", rcvd_feedback->len);
 	}
-	walk = rohc_buf_data(remain_rohc_data);
-	remain_len = remain_rohc_data.len;
 
 	/* is there some data after feedback? */
 	if(remain_rohc_data.len == 0)
@@ -1053,91 +2509,32 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	}
 
 	/* ROHC segment? */
-	if(rohc_decomp_packet_is_segment(walk))
+	if(rohc_decomp_packet_is_segment(rohc_buf_data(remain_rohc_data)))
 	{
-		const bool is_final = !!GET_REAL(GET_BIT_0(walk));
-		uint32_t crc_computed;
-
-		/* skip the segment type byte */
-		walk++;
-		remain_len--;
-		rohc_buf_pull(&remain_rohc_data, 1);
-
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "ROHC packet is a %zu-byte %s segment", remain_len,
-		           is_final ? "final" : "non-final");
-
-		/* store all the remaining ROHC data in RRU */
-		if((decomp->rru_len + remain_len) > decomp->mrru)
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "invalid RRU: received segment is too large for MRRU "
-			             "(%zu bytes already received, %zu bytes received, "
-			             "MRRU = %zu bytes", decomp->rru_len, remain_len,
-			             decomp->mrru);
-			/* dicard RRU */
-			decomp->rru_len = 0;
-			goto error_malformed;
-		}
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "append new segment to the %zd bytes we already received",
-		           decomp->rru_len);
-		memcpy(decomp->rru + decomp->rru_len, walk, remain_len);
-		decomp->rru_len += remain_len;
-
-		/* stop decoding here is not final segment */
-		if(!is_final)
+		status = rohc_decomp_append_segment(decomp, &remain_rohc_data);
+		if(status == ROHC_STATUS_SEGMENT)
 		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			           "%zd bytes of RRU already received, wait for more "
-			           "segments before decompressing RRU", decomp->rru_len);
+			/* wait for more segments */
 			goto skip;
 		}
-
-		/* final segment received, let's check CRC */
-		if(decomp->rru_len <= 4)
+		else if(status == ROHC_STATUS_BAD_CRC)
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "invalid %zd-byte RRU: should be more than 4-byte long",
-			             decomp->rru_len);
-			/* discard RRU */
-			decomp->rru_len = 0;
-			goto error_malformed;
+			goto error_crc;
 		}
-		decomp->rru_len -= 4;
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "final segment received, check the 4-byte CRC of the "
-		           "%zd-byte RRU", decomp->rru_len);
-		crc_computed = crc_calc_fcs32(decomp->rru, decomp->rru_len,
-		                              CRC_INIT_FCS32);
-		if(memcmp(&crc_computed, decomp->rru + decomp->rru_len, 4) != 0)
+		else if(status != ROHC_STATUS_OK)
 		{
-			uint32_t crc_packet;
-			memcpy(&crc_packet, decomp->rru + decomp->rru_len, 4);
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "invalid %zd-byte RRU: bad CRC (packet = 0x%08x, "
-			             "computed = 0x%08x)", decomp->rru_len,
-			             rohc_ntoh32(crc_packet), rohc_ntoh32(crc_computed));
-			/* discard RRU */
-			decomp->rru_len = 0;
-			goto error_crc;
+			goto error_malformed;
 		}
 
-		/* CRC of segment is OK, let's decode RRU */
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "final segment received, decode the %zd-byte RRU",
-		           decomp->rru_len);
-		walk = decomp->rru;
-		remain_len = decomp->rru_len;
-		remain_rohc_data.offset = 0;
-		remain_rohc_data.data = decomp->rru;
-		remain_rohc_data.len = decomp->rru_len;
-		remain_rohc_data.max_len = decomp->rru_len;
-
-		/* reset context for next RRU */
-		decomp->rru_len = 0;
+		/* the RRU was reassembled in the decompressor, it cannot be
+		 * decompressed in place */
+		decode_in_place = false;
 	}
 
+decode_rru:
+	walk = rohc_buf_data(remain_rohc_data);
+	remain_len = remain_rohc_data.len;
+
 	/* decode small or large CID */
 	if(!rohc_decomp_decode_cid(decomp, walk, remain_len, &stream->cid,
 	                           &add_cid_len, &large_cid_len))
@@ -1146,6 +2543,8 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 		             "failed to decode small or large CID in packet");
 		goto error_malformed;
 	}
+
+cid_decoded:
 	stream->cid_found = true;
 
 	/* check whether the decoded CID is allowed by the decompressor */
@@ -1180,6 +2579,7 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	assert(status == ROHC_STATUS_OK);
 	profile = stream->context->profile;
 	decomp->last_context = stream->context;
+	context_touch(decomp, stream->context);
 	sn_feedback_min_bits = rohc_min(decomp->sn_feedback_min_bits,
 	                                profile->msn_max_bits);
 	rohc_decomp_debug(stream->context, "decode packet with profile '%s' (0x%04x)",
@@ -1263,8 +2663,9 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	/* decode the packet thanks to the profile-specific routines
 	 * (may change the initial assumption about the packet type) */
 	status = rohc_decomp_decode_pkt(decomp, stream->context, remain_rohc_data,
-	                                add_cid_len, large_cid_len, uncomp_packet,
-	                                &stream->packet_type, &stream->do_change_mode);
+	                                add_cid_len, large_cid_len, decode_in_place,
+	                                uncomp_packet, &stream->packet_type,
+	                                &stream->do_change_mode);
 	if(status != ROHC_STATUS_OK)
 	{
 		/* decompression failed, free resources if necessary */
@@ -1321,6 +2722,184 @@ error_no_context:
 }
 
 
+/**
+ * @brief Append one ROHC segment to the RRU being reassembled
+ *
+ * The segment is stored in the RRU buffer of the decompressor. The FCS-32 of
+ * the RRU is computed as segments are received, so the final segment only
+ * requires to complete the CRC with its own bytes.
+ *
+ * @param decomp             The ROHC decompressor
+ * @param[in,out] rohc_data  IN:  The ROHC segment, segment header included
+ *                           OUT: The whole RRU without its FCS-32 if the
+ *                                segment was the final one and the RRU is
+ *                                valid
+ * @return                   Possible return values:
+ *                            \li ROHC_STATUS_OK if the RRU is complete and
+ *                                its FCS-32 is valid,
+ *                            \li ROHC_STATUS_SEGMENT if more segments are
+ *                                required to complete the RRU,
+ *                            \li ROHC_STATUS_MALFORMED if the RRU is too
+ *                                large for MRRU or too small for its FCS-32,
+ *                            \li ROHC_STATUS_BAD_CRC if the FCS-32 of the
+ *                                RRU is wrong
+ */
+static rohc_status_t rohc_decomp_append_segment(struct rohc_decomp *const decomp,
+                                                struct rohc_buf *const rohc_data)
+{
+	const bool is_final = !!GET_REAL(GET_BIT_0(rohc_buf_data(*rohc_data)));
+
+	/* skip the segment type byte */
+	rohc_buf_pull(rohc_data, 1);
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "ROHC packet is a %zu-byte %s segment", rohc_data->len,
+	           is_final ? "final" : "non-final");
+
+	/* store all the remaining ROHC data in RRU */
+	if((decomp->rru_len + rohc_data->len) > decomp->mrru)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "invalid RRU: received segment is too large for MRRU "
+		             "(%zu bytes already received, %zu bytes received, "
+		             "MRRU = %zu bytes", decomp->rru_len, rohc_data->len,
+		             decomp->mrru);
+		goto discard_malformed;
+	}
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "append new segment to the %zd bytes we already received",
+	           decomp->rru_len);
+	memcpy(decomp->rru + decomp->rru_len, rohc_buf_data(*rohc_data),
+	       rohc_data->len);
+	decomp->rru_len += rohc_data->len;
+	rohc_decomp_rru_fcs_update(&decomp->rru_fcs, rohc_buf_data(*rohc_data),
+	                           rohc_data->len);
+
+	/* stop decoding here is not final segment */
+	if(!is_final)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "%zd bytes of RRU already received, wait for more "
+		           "segments before decompressing RRU", decomp->rru_len);
+		return ROHC_STATUS_SEGMENT;
+	}
+
+	/* final segment received, let's check CRC */
+	if(decomp->rru_len <= CRC_FCS32_LEN)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "invalid %zd-byte RRU: should be more than 4-byte long",
+		             decomp->rru_len);
+		goto discard_malformed;
+	}
+	decomp->rru_len -= CRC_FCS32_LEN;
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "final segment received, check the 4-byte CRC of the "
+	           "%zd-byte RRU", decomp->rru_len);
+	if(!rohc_decomp_rru_fcs_check(&decomp->rru_fcs))
+	{
+		uint32_t crc_packet;
+		memcpy(&crc_packet, decomp->rru_fcs.tail, CRC_FCS32_LEN);
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "invalid %zd-byte RRU: bad CRC (packet = 0x%08x, "
+		             "computed = 0x%08x)", decomp->rru_len,
+		             rohc_ntoh32(crc_packet), rohc_ntoh32(decomp->rru_fcs.crc));
+		/* discard RRU */
+		decomp->rru_len = 0;
+		rohc_decomp_rru_fcs_init(&decomp->rru_fcs);
+		return ROHC_STATUS_BAD_CRC;
+	}
+
+	/* CRC of segment is OK, let's decode RRU */
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "final segment received, decode the %zd-byte RRU",
+	           decomp->rru_len);
+	rohc_data->offset = 0;
+	rohc_data->data = decomp->rru;
+	rohc_data->len = decomp->rru_len;
+	rohc_data->max_len = decomp->rru_len;
+
+	/* reset context for next RRU */
+	decomp->rru_len = 0;
+	rohc_decomp_rru_fcs_init(&decomp->rru_fcs);
+
+	return ROHC_STATUS_OK;
+
+discard_malformed:
+	decomp->rru_len = 0;
+	rohc_decomp_rru_fcs_init(&decomp->rru_fcs);
+	return ROHC_STATUS_MALFORMED;
+}
+
+
+/**
+ * @brief Start the FCS-32 of a new RRU
+ *
+ * @param fcs  The FCS-32 of the RRU
+ */
+static void rohc_decomp_rru_fcs_init(struct rohc_decomp_rru_fcs *const fcs)
+{
+	fcs->crc = CRC_INIT_FCS32;
+	fcs->tail_len = 0;
+}
+
+
+/**
+ * @brief Add some bytes of the RRU to its FCS-32
+ *
+ * The last \ref CRC_FCS32_LEN bytes received are held back since they might
+ * be the FCS-32 transmitted at the very end of the RRU.
+ *
+ * @param fcs   The FCS-32 of the RRU
+ * @param data  The next bytes of the RRU
+ * @param len   The number of bytes in \e data
+ */
+static void rohc_decomp_rru_fcs_update(struct rohc_decomp_rru_fcs *const fcs,
+                                       const uint8_t *const data,
+                                       const size_t len)
+{
+	if(len >= CRC_FCS32_LEN)
+	{
+		/* the bytes held back and all new bytes but the last ones are part of
+		 * the RRU */
+		fcs->crc = crc_calc_fcs32(fcs->tail, fcs->tail_len, fcs->crc);
+		fcs->crc = crc_calc_fcs32(data, len - CRC_FCS32_LEN, fcs->crc);
+		memcpy(fcs->tail, data + len - CRC_FCS32_LEN, CRC_FCS32_LEN);
+		fcs->tail_len = CRC_FCS32_LEN;
+	}
+	else
+	{
+		/* only the oldest bytes held back are part of the RRU */
+		size_t settled_len = 0;
+
+		if((fcs->tail_len + len) > CRC_FCS32_LEN)
+		{
+			settled_len = fcs->tail_len + len - CRC_FCS32_LEN;
+			fcs->crc = crc_calc_fcs32(fcs->tail, settled_len, fcs->crc);
+			memmove(fcs->tail, fcs->tail + settled_len,
+			        fcs->tail_len - settled_len);
+		}
+		fcs->tail_len -= settled_len;
+		memcpy(fcs->tail + fcs->tail_len, data, len);
+		fcs->tail_len += len;
+	}
+}
+
+
+/**
+ * @brief Check the FCS-32 of a complete RRU
+ *
+ * @param fcs  The FCS-32 of the RRU
+ * @return     true if the FCS-32 transmitted at the end of the RRU is the one
+ *             computed over the RRU, false otherwise
+ */
+static bool rohc_decomp_rru_fcs_check(const struct rohc_decomp_rru_fcs *const fcs)
+{
+	return (fcs->tail_len == CRC_FCS32_LEN &&
+	        memcmp(&fcs->crc, fcs->tail, CRC_FCS32_LEN) == 0);
+}
+
+
 /**
  * @brief Decode one ROHC packet
  *
@@ -1336,11 +2915,17 @@ error_no_context:
  * Steps C and D may be repeated if packet or context repair is attempted
  * upon CRC failure.
  *
+ * If the uncompressed packet shares the buffer of the ROHC packet, the
+ * uncompressed headers are built in the space before the ROHC payload, then
+ * moved right in front of it in step E: the payload is not copied.
+ *
  * @param decomp               The ROHC decompressor
  * @param context              The decompression context
  * @param rohc_packet          The ROHC packet to decode
  * @param add_cid_len          The length of the optional Add-CID field
  * @param large_cid_len        The length of the optional large CID field
+ * @param in_place             Whether \e uncomp_packet shares the buffer of
+ *                             \e rohc_packet or not
  * @param[out] uncomp_packet   The uncompressed packet
  * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
  *                             OUT: The type of the parsed ROHC packet
@@ -1356,6 +2941,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const struct rohc_buf rohc_packet,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
+                                            const bool in_place,
                                             struct rohc_buf *const uncomp_packet,
                                             rohc_packet_t *const packet_type,
                                             bool *const do_change_mode)
@@ -1373,6 +2959,8 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 	const uint8_t *payload_data;
 	size_t payload_len;
 
+	const size_t uncomp_max_len = uncomp_packet->max_len;
+
 	/* Whether to attempt packet correction or not */
 	bool try_decoding_again;
 
@@ -1408,6 +2996,25 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 	rohc_decomp_debug(context, "ROHC payload (length = %zu bytes) starts at "
 	                  "offset %zu", payload_len, rohc_hdr_len);
 
+	/* when decompressing in place, the uncompressed headers shall not overwrite
+	 * the payload: the ROHC headers were parsed, so they may be overwritten */
+	if(in_place)
+	{
+		const size_t payload_offset = rohc_packet.offset + rohc_hdr_len;
+
+		if(uncomp_packet->offset > payload_offset)
+		{
+			rohc_decomp_warn(context, "uncompressed packet starts after the "
+			                 "ROHC payload");
+			status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+			goto error;
+		}
+		uncomp_packet->max_len = payload_offset;
+		rohc_decomp_debug(context, "decompress in place with %zu bytes available "
+		                  "for uncompressed headers",
+		                  rohc_buf_avail_len(*uncomp_packet));
+	}
+
 
 	/*
 	 * B. Check for correct compressed header (CRC)
@@ -1581,7 +3188,6 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		}
 	}
 	uncomp_hdr_len = uncomp_packet->len;
-	rohc_buf_pull(uncomp_packet, uncomp_hdr_len);
 
 
 	/* E. Copy the payload (if any) */
@@ -1595,21 +3201,37 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		status = ROHC_STATUS_ERROR;
 		goto error;
 	}
-	if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
+	if(in_place)
 	{
-		rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
-		                 "max) for the %zu-byte payload",
-		                 rohc_buf_avail_len(*uncomp_packet), payload_len);
-		status = ROHC_STATUS_OUTPUT_TOO_SMALL;
-		goto error;
+		/* move the uncompressed headers right in front of the payload that is
+		 * already in place, the headers may overlap the former ROHC headers */
+		const size_t payload_offset = rohc_packet.offset + rohc_hdr_len;
+
+		assert(uncomp_max_len >= (payload_offset + payload_len));
+		memmove(uncomp_packet->data + payload_offset - uncomp_hdr_len,
+		        rohc_buf_data(*uncomp_packet), uncomp_hdr_len);
+		uncomp_packet->offset = payload_offset - uncomp_hdr_len;
+		uncomp_packet->len = uncomp_hdr_len + payload_len;
 	}
-	if(payload_len != 0)
+	else
 	{
-		rohc_buf_append(uncomp_packet, payload_data, payload_len);
-		rohc_buf_pull(uncomp_packet, payload_len);
+		rohc_buf_pull(uncomp_packet, uncomp_hdr_len);
+		if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
+		{
+			rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
+			                 "max) for the %zu-byte payload",
+			                 rohc_buf_avail_len(*uncomp_packet), payload_len);
+			status = ROHC_STATUS_OUTPUT_TOO_SMALL;
+			goto error;
+		}
+		if(payload_len != 0)
+		{
+			rohc_buf_append(uncomp_packet, payload_data, payload_len);
+			rohc_buf_pull(uncomp_packet, payload_len);
+		}
+		/* unhide the uncompressed headers and payload */
+		rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
 	}
-	/* unhide the uncompressed headers and payload */
-	rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
 	rohc_decomp_debug(context, "uncompressed packet length = %zu bytes",
 	                  uncomp_packet->len);
 
@@ -1642,6 +3264,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 	status = ROHC_STATUS_OK;
 
 error:
+	uncomp_packet->max_len = uncomp_max_len;
 	return status;
 }
 
@@ -1684,9 +3307,12 @@ static rohc_status_t rohc_decomp_try_decode_pkt(const struct rohc_decomp *const
 
 	/* A. Decode extracted bits
 	 *
-	 * All bits are now extracted from the packet, let's decode them.
+	 * All bits are now extracted from the packet, let's decode them. The
+	 * decoded values are shared by all the contexts of the profile: clear
+	 * them first, so that no field decoded for another flow is used.
 	 */
 
+	memset(decoded_values, 0, profile->decoded_values_size);
 	status = profile->decode_bits(context, extr_bits, payload_len, decoded_values);
 	if(status != ROHC_STATUS_OK)
 	{
@@ -1830,6 +3456,9 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
                                      const struct rohc_decomp_stream *const infos,
                                      struct rohc_buf *const feedback)
 {
+	const bool is_coalesced =
+		!!((decomp->features & ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK) != 0 &&
+		   infos->context != NULL);
 #ifndef ROHC_NO_TRACES
 	const char mode_short[ROHC_R_MODE + 1] = { '?', 'U', 'O', 'R' };
 #endif
@@ -1941,7 +3570,7 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent |= 1;
 
 	/* prepare feedback packet if asked by user */
-	if(feedback == NULL)
+	if(feedback == NULL && !is_coalesced)
 	{
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 		           "user choose not to use a feedback channel, do not build any "
@@ -1951,9 +3580,6 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 	{
 		rohc_feedback_crc_t crc_present;
 		struct d_feedback sfeedback;
-		uint8_t *feedbackp;
-		size_t feedbacksize;
-		size_t feedback_hdr_len;
 
 		/* FEEDBACK-1 or FEEDBACK-2 ? */
 		if(infos->profile_id == ROHC_PROFILE_UNCOMPRESSED ||
@@ -1994,44 +3620,35 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 			}
 		}
 
-		/* build the feedback packet */
-		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, &feedbacksize);
-		if(feedbackp == NULL)
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to wrap the ACK feedback");
-			goto error;
-		}
-
-		/* copy the feedback to the buffer provided by the user */
-		/* TODO: build feedback directly into the provided buffer */
-		feedback_hdr_len = 1 + (feedbacksize < 8 ? 0 : 1);
-		if((feedback_hdr_len + feedbacksize) <= rohc_buf_avail_len(*feedback))
+		/* queue the feedback in the context if feedbacks are coalesced, build
+		 * it directly in the buffer provided by the user otherwise */
+		if(is_coalesced)
 		{
-			if(feedbacksize < 8)
+			if(!rohc_decomp_feedback_queue(decomp, infos, ROHC_FEEDBACK_ACK,
+			                               &sfeedback, crc_present))
 			{
-				rohc_buf_byte(*feedback) = 0xf0 | feedbacksize;
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+				             "failed to queue the ACK feedback");
+				goto error;
 			}
-			else
+		}
+		else
+		{
+			if(!f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
+			                    crc_present, feedback))
 			{
-				rohc_buf_byte(*feedback) = 0xf0;
-				rohc_buf_byte_at(*feedback, 1) = feedbacksize;
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+				             "failed to wrap the ACK feedback");
+				goto error;
 			}
-			feedback->len += feedback_hdr_len;
-			rohc_buf_append(feedback, feedbackp, feedbacksize);
-		}
 
-		if(feedback->len > 0)
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "decompressor built a %zu-byte positive feedback "
-			           "(header = %zu bytes, data = %zu bytes)", feedback->len,
-			           feedback_hdr_len, feedbacksize);
+			if(feedback->len > 0)
+			{
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+				           "decompressor built a %zu-byte positive feedback",
+				           feedback->len);
+			}
 		}
-
-		/* destroy the temporary feedback buffer */
-		free(feedbackp);
 	}
 
 skip:
@@ -2059,6 +3676,11 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
                                       const struct rohc_decomp_stream *const infos,
                                       struct rohc_buf *const feedback)
 {
+	/* feedbacks are coalesced in contexts, so feedbacks for packets without
+	 * context are never coalesced */
+	const bool is_coalesced =
+		!!((decomp->features & ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK) != 0 &&
+		   infos->context != NULL);
 	bool do_downward_transition = false;
 	bool do_build_ack = false;
 	enum rohc_feedback_ack_type ack_type;
@@ -2279,7 +3901,7 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 		           "do not send a negative ACK");
 	}
-	else if(feedback == NULL)
+	else if(feedback == NULL && !is_coalesced)
 	{
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 		           "user choose not to use a feedback channel, do not build any "
@@ -2289,9 +3911,6 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 	{
 		rohc_feedback_crc_t crc_present;
 		struct d_feedback sfeedback;
-		uint8_t *feedbackp;
-		size_t feedbacksize;
-		size_t feedback_hdr_len;
 
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 		           "should send a negative ACK (CID = %u, NACK type = %d, current "
@@ -2328,44 +3947,35 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
 		}
 
-		/* build the feedback packet */
-		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, &feedbacksize);
-		if(feedbackp == NULL)
+		/* queue the feedback in the context if feedbacks are coalesced, build
+		 * it directly in the buffer provided by the user otherwise */
+		if(is_coalesced)
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to wrap the (STATIC-)NACK feedback");
-			goto error;
+			if(!rohc_decomp_feedback_queue(decomp, infos, ack_type, &sfeedback,
+			                               crc_present))
+			{
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+				             "failed to queue the (STATIC-)NACK feedback");
+				goto error;
+			}
 		}
-
-		/* copy the feedback to the buffer provided by the user */
-		/* TODO: build feedback directly into the provided buffer */
-		feedback_hdr_len = 1 + (feedbacksize < 8 ? 0 : 1);
-		if((feedback_hdr_len + feedbacksize) <= rohc_buf_avail_len(*feedback))
+		else
 		{
-			if(feedbacksize < 8)
+			if(!f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
+			                    crc_present, feedback))
 			{
-				rohc_buf_byte(*feedback) = 0xf0 | feedbacksize;
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+				             "failed to wrap the (STATIC-)NACK feedback");
+				goto error;
 			}
-			else
+
+			if(feedback->len > 0)
 			{
-				rohc_buf_byte(*feedback) = 0xf0;
-				rohc_buf_byte_at(*feedback, 1) = feedbacksize;
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+				           "decompressor built a %zu-byte negative feedback",
+				           feedback->len);
 			}
-			feedback->len += feedback_hdr_len;
-			rohc_buf_append(feedback, feedbackp, feedbacksize);
-		}
-
-		if(feedback->len > 0)
-		{
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			           "decompressor built a %zu-byte negative feedback (%zu bytes "
-			           "of header + %zu bytes of data)", feedback->len,
-			           feedback_hdr_len, feedbacksize);
 		}
-
-		/* destroy the temporary feedback buffer */
-		free(feedbackp);
 	}
 
 	/* upon decompression failure, perform downward transitions if context is
@@ -2414,6 +4024,115 @@ error:
 }
 
 
+/**
+ * @brief Queue one feedback in its context until the next flush
+ *
+ * Only one feedback is kept per context: a new feedback replaces the pending
+ * one, except that a new ACK never replaces a pending (STATIC-)NACK. The
+ * contexts keep their place in the queue when their feedback is replaced.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param infos        The information collected on the decompressed packet
+ * @param ack_type     The type of acknowledgement
+ * @param sfeedback    The feedback to queue
+ * @param crc_present  Whether the feedback shall be protected by a CRC or not
+ * @return             true if the feedback was queued or dropped in favor of
+ *                     the pending one, false if a problem occurred
+ *
+ * @see rohc_decomp_flush_feedback
+ */
+static bool rohc_decomp_feedback_queue(struct rohc_decomp *const decomp,
+                                       const struct rohc_decomp_stream *const infos,
+                                       const enum rohc_feedback_ack_type ack_type,
+                                       struct d_feedback *const sfeedback,
+                                       const rohc_feedback_crc_t crc_present)
+{
+	struct rohc_decomp_ctxt *const context = infos->context;
+	struct rohc_decomp_feedback_item *const pending_fb = &(context->pending_fb);
+	const bool is_queued = !!(pending_fb->len > 0);
+	struct rohc_buf pending_fb_buf =
+		rohc_buf_init_empty(pending_fb->data, ROHC_DECOMP_FEEDBACK_ITEM_MAX_LEN);
+
+	/* a pending negative feedback is more important than a new ACK */
+	if(is_queued && ack_type == ROHC_FEEDBACK_ACK &&
+	   pending_fb->type != ROHC_FEEDBACK_ACK)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "CID %u: keep the pending negative feedback instead of the "
+		           "new ACK", infos->cid);
+		return true;
+	}
+
+	/* build the feedback in the context, in place of the pending one */
+	if(!f_wrap_feedback(sfeedback, infos->cid, infos->cid_type, crc_present,
+	                    &pending_fb_buf))
+	{
+		goto error;
+	}
+	assert(pending_fb_buf.len > 0);
+	pending_fb->type = ack_type;
+	pending_fb->len = pending_fb_buf.len;
+
+	/* the context goes at the end of the queue if it had no pending feedback */
+	if(!is_queued)
+	{
+		context->fb_prev = decomp->fb_last;
+		context->fb_next = NULL;
+		if(decomp->fb_last != NULL)
+		{
+			decomp->fb_last->fb_next = context;
+		}
+		else
+		{
+			decomp->fb_first = context;
+		}
+		decomp->fb_last = context;
+	}
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+	           "CID %u: %zu-byte feedback %s", infos->cid, pending_fb->len,
+	           is_queued ? "replaces the pending one" : "queued");
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Remove the pending feedback of one context from the queue
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The context with a pending feedback
+ */
+static void rohc_decomp_feedback_unqueue(struct rohc_decomp *const decomp,
+                                         struct rohc_decomp_ctxt *const context)
+{
+	assert(context->pending_fb.len > 0);
+
+	if(context->fb_prev != NULL)
+	{
+		context->fb_prev->fb_next = context->fb_next;
+	}
+	else
+	{
+		decomp->fb_first = context->fb_next;
+	}
+	if(context->fb_next != NULL)
+	{
+		context->fb_next->fb_prev = context->fb_prev;
+	}
+	else
+	{
+		decomp->fb_last = context->fb_prev;
+	}
+	context->fb_prev = NULL;
+	context->fb_next = NULL;
+	context->pending_fb.len = 0;
+}
+
+
 /**
  * @brief Update statistics upon successful decompression
  *
@@ -2448,6 +4167,7 @@ static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
 	decomp->stats.corrected_crc_failures = 0;
 	decomp->stats.corrected_sn_wraparounds = 0;
 	decomp->stats.corrected_wrong_sn_updates = 0;
+	decomp->stats.evicted_contexts = 0;
 }
 
 
@@ -2588,6 +4308,166 @@ error:
 }
 
 
+/**
+ * @brief Get the memory used by the decompressor
+ *
+ * Get the memory allocated by the decompressor, broken down per subsystem and
+ * per profile. The memory used by every profile is broken down in the memory
+ * used by the generic and profile-specific parts of its contexts, and the
+ * memory used to parse and decode the ROHC packets of the profile.
+ *
+ * All the enabled profiles are described, in the order of their profile IDs,
+ * even if they have no context yet.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_decomp_memory_usage_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_decomp_memory_usage_t structure for details about fields
+ * that are supported in the above versions.
+ *
+ * @param decomp         The ROHC decompressor to get memory usage from
+ * @param[in,out] usage  The structure where memory usage will be stored
+ * @return               true in case of success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_memory_usage_t
+ */
+bool rohc_decomp_get_memory_usage(const struct rohc_decomp *const decomp,
+                                  rohc_decomp_memory_usage_t *const usage)
+{
+	size_t profiles_idx[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
+	size_t profile_major;
+	size_t profile_minor;
+	size_t cid;
+	size_t i;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(usage == NULL)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "structure for memory usage is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(usage->version_major != 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "memory usage", usage->version_major);
+		goto error;
+	}
+	if(usage->version_minor > 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "unsupported minor version (%u) of the structure for "
+		           "memory usage", usage->version_minor);
+		goto error;
+	}
+
+	/* the subsystems common to all profiles */
+	usage->decomp_mem = sizeof(struct rohc_decomp);
+	usage->contexts_mem =
+		(decomp->medium.max_cid + 1) * sizeof(struct rohc_decomp_ctxt *);
+	usage->pool_mem = decomp->ctxts_pool_nr * sizeof(struct rohc_decomp_ctxt) +
+	                  decomp->rfc3095_ctxts_pool_nr * ROHC_DECOMP_RFC3095_CTXT_SIZE;
+	usage->rru_mem = (decomp->rru != NULL ? decomp->mrru : 0);
+
+	/* one entry for every enabled profile and for every profile that
+	 * allocated its parsing scratch areas */
+	usage->profiles_nr = 0;
+	for(profile_major = 0; profile_major <= ROHC_PROFILE_ID_MAJOR_MAX; profile_major++)
+	{
+		for(profile_minor = 0; profile_minor <= ROHC_PROFILE_ID_MINOR_MAX; profile_minor++)
+		{
+			const struct rohc_decomp_profile *const profile =
+				rohc_decomp_profiles[profile_major][profile_minor];
+			const struct rohc_decomp_volat_scratch *const scratch =
+				&(decomp->volat_scratch[profile_major][profile_minor]);
+			rohc_decomp_profile_memory_usage_t *profile_usage;
+
+			profiles_idx[profile_major][profile_minor] = ROHC_DECOMP_MEM_PROFILES_MAX;
+			if(profile != NULL)
+			{
+				usage->pool_mem += profile->persist_ctxt_size *
+					decomp->persist_pools[profile_major][profile_minor].nr;
+			}
+			if(profile == NULL ||
+			   (!decomp->enabled_profiles[profile_major][profile_minor] &&
+			    scratch->extr_bits == NULL && scratch->decoded_values == NULL))
+			{
+				continue;
+			}
+			profiles_idx[profile_major][profile_minor] = usage->profiles_nr;
+			profile_usage = &usage->profiles[usage->profiles_nr];
+			memset(profile_usage, 0, sizeof(rohc_decomp_profile_memory_usage_t));
+			profile_usage->profile = profile->id;
+			if(scratch->extr_bits != NULL)
+			{
+				profile_usage->scratch_mem += profile->extr_bits_size;
+			}
+			if(scratch->decoded_values != NULL)
+			{
+				profile_usage->scratch_mem += profile->decoded_values_size;
+			}
+			usage->profiles_nr++;
+		}
+	}
+
+	/* account the memory used by the contexts */
+	for(cid = 0; cid <= decomp->medium.max_cid; cid++)
+	{
+		const struct rohc_decomp_ctxt *const ctxt = decomp->contexts[cid];
+		rohc_decomp_profile_memory_usage_t *profile_usage;
+		size_t *profile_idx;
+
+		if(ctxt == NULL)
+		{
+			continue;
+		}
+
+		/* the profile of the context might have been disabled since the
+		 * context was created */
+		profile_idx = &profiles_idx[(ctxt->profile->id >> 8) & 0xff][ctxt->profile->id & 0xff];
+		if((*profile_idx) == ROHC_DECOMP_MEM_PROFILES_MAX)
+		{
+			(*profile_idx) = usage->profiles_nr;
+			memset(&usage->profiles[usage->profiles_nr], 0,
+			       sizeof(rohc_decomp_profile_memory_usage_t));
+			usage->profiles[usage->profiles_nr].profile = ctxt->profile->id;
+			usage->profiles_nr++;
+		}
+		profile_usage = &usage->profiles[*profile_idx];
+
+		profile_usage->contexts_nr++;
+		profile_usage->contexts_mem += sizeof(struct rohc_decomp_ctxt);
+		profile_usage->specific_mem += ctxt->profile->persist_ctxt_size;
+	}
+
+	/* sum all subsystems */
+	usage->total_mem = usage->decomp_mem + usage->contexts_mem +
+	                   usage->pool_mem + usage->rru_mem;
+	for(i = 0; i < usage->profiles_nr; i++)
+	{
+		usage->total_mem += usage->profiles[i].contexts_mem;
+		usage->total_mem += usage->profiles[i].specific_mem;
+		usage->total_mem += usage->profiles[i].scratch_mem;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Get some information about the given decompression context
  *
@@ -2694,6 +4574,8 @@ error:
  * \ref rohc_decomp_general_info_t structure with the \e version_major and
  * \e version_minor fields set to one of the following supported versions:
  *  - Major 0, minor 0
+ *  - Major 0, minor 1
+ *  - Major 0, minor 2
  *
  * See the \ref rohc_decomp_general_info_t structure for details about fields
  * that are supported in the above versions.
@@ -2736,6 +4618,11 @@ bool rohc_decomp_get_general_info(const struct rohc_decomp *const decomp,
 			case 0:
 				/* nothing to add */
 				break;
+			case 2:
+				/* new fields in 0.2 */
+				info->evicted_contexts_nr = decomp->stats.evicted_contexts;
+				info->contexts_mem = decomp->ctxts_mem;
+				/* fall through */
 			case 1:
 				/* new fields in 0.1 */
 				info->corrected_crc_failures = decomp->stats.corrected_crc_failures;
@@ -3008,6 +4895,93 @@ error:
 }
 
 
+/**
+ * @brief Set the maximum memory for the decompression contexts
+ *
+ * Set the maximum amount of memory (in bytes) that the decompression contexts
+ * may use. When a new context does not fit in that amount of memory, the least
+ * recently used contexts are evicted until it does. A compressor that sends
+ * packets for an evicted context will be asked to send IR packets again.
+ *
+ * The number of evicted contexts is reported by the \e evicted_contexts_nr
+ * field of \ref rohc_decomp_general_info_t.
+ *
+ * If the decompressor already uses more memory than the new limit, the least
+ * recently used contexts are evicted immediately.
+ *
+ * The evicted and released contexts are kept for re-use by the next new
+ * contexts, up to 64 contexts and 64 profile-specific parts per profile. The
+ * profile-specific parts of the TCP and ROHCv2 profiles and the generic part
+ * of the RFC3095 profiles are kept; the UDP, RTP and ESP parts of the RFC3095
+ * profiles are not. The memory kept for re-use is not counted in the limit,
+ * it is reported by the \e pool_mem field of
+ * \ref rohc_decomp_memory_usage_t.
+ *
+ * The default value is 0, ie. no limit.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param max_mem  The maximum memory (in bytes) for the contexts,
+ *                 0 for no limit
+ * @return         true if the limit was successfully set, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_contexts_max_mem
+ * @see rohc_decomp_get_general_info
+ */
+bool rohc_decomp_set_contexts_max_mem(struct rohc_decomp *const decomp,
+                                      const size_t max_mem)
+{
+	bool is_fine;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	decomp->ctxts_max_mem = max_mem;
+	is_fine = rohc_decomp_evict_contexts(decomp, 0, NULL);
+	assert(is_fine);
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "maximum memory for contexts is now set to %zu bytes "
+	           "(%zu bytes in use)", decomp->ctxts_max_mem, decomp->ctxts_mem);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the maximum memory for the decompression contexts
+ *
+ * @param decomp       The ROHC decompressor
+ * @param[out] max_mem  The maximum memory (in bytes) for the contexts,
+ *                      0 for no limit
+ * @return             true if the limit was successfully retrieved,
+ *                     false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_contexts_max_mem
+ */
+bool rohc_decomp_get_contexts_max_mem(const struct rohc_decomp *const decomp,
+                                      size_t *const max_mem)
+{
+	if(decomp == NULL || max_mem == NULL)
+	{
+		goto error;
+	}
+
+	*max_mem = decomp->ctxts_max_mem;
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Set the number of packets sent during one Round-Trip Time (RTT).
  *
@@ -3350,7 +5324,8 @@ bool rohc_decomp_set_features(struct rohc_decomp *const decomp,
 {
 	const rohc_decomp_features_t all_features =
 		ROHC_DECOMP_FEATURE_CRC_REPAIR |
-		ROHC_DECOMP_FEATURE_DUMP_PACKETS;
+		ROHC_DECOMP_FEATURE_DUMP_PACKETS |
+		ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK;
 
 	/* decompressor must be valid */
 	if(decomp == NULL)
@@ -3926,6 +5901,103 @@ static void rohc_decomp_parse_padding(const struct rohc_decomp *const decomp,
 }
 
 
+/**
+ * @brief Decode the CID of the given ROHC packet without decompressing it
+ *
+ * Skip the padding and feedback items at the beginning of the ROHC packet,
+ * then decode its small or large CID. No trace is emitted. The result may be
+ * given to \ref d_decode_header so that the packet is not parsed again.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet to parse
+ * @param[out] peeked  The lengths of the padding and feedback items, and the
+ *                     CID of the ROHC packet
+ * @return             true if the CID was decoded, false if the packet is
+ *                     malformed, if it is a ROHC segment, or if the CID is
+ *                     greater than MAX_CID
+ */
+static bool rohc_decomp_peek_cid(const struct rohc_decomp *const decomp,
+                                 const struct rohc_buf rohc_packet,
+                                 struct rohc_decomp_peeked_cid *const peeked)
+{
+	struct rohc_buf remain_data = rohc_packet;
+
+	/* skip padding */
+	peeked->padding_len = 0;
+	while(remain_data.len > 0 &&
+	      rohc_decomp_packet_is_padding(rohc_buf_data(remain_data)))
+	{
+		rohc_buf_pull(&remain_data, 1);
+		peeked->padding_len++;
+	}
+
+	/* skip feedback items */
+	peeked->feedbacks_len = 0;
+	while(remain_data.len > 0 && rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len) ||
+		   remain_data.len < (feedback_hdr_len + feedback_data_len))
+		{
+			goto error;
+		}
+		rohc_buf_pull(&remain_data, feedback_hdr_len + feedback_data_len);
+		peeked->feedbacks_len += feedback_hdr_len + feedback_data_len;
+	}
+
+	/* no CID in feedback-only packets, and the CID of a RRU is known only
+	 * once all its segments are received */
+	if(remain_data.len == 0 ||
+	   rohc_decomp_packet_is_segment(rohc_buf_data(remain_data)))
+	{
+		goto error;
+	}
+
+	if(decomp->medium.cid_type == ROHC_SMALL_CID)
+	{
+		peeked->large_cid_len = 0;
+		peeked->cid = rohc_add_cid_decode(rohc_buf_data(remain_data),
+		                                  remain_data.len);
+		if(peeked->cid == UINT8_MAX)
+		{
+			peeked->cid = 0;
+			peeked->add_cid_len = 0;
+		}
+		else
+		{
+			peeked->add_cid_len = 1;
+		}
+	}
+	else
+	{
+		uint32_t large_cid;
+		size_t large_cid_bits_nr;
+
+		if(remain_data.len < 2)
+		{
+			goto error;
+		}
+		peeked->add_cid_len = 0;
+		peeked->large_cid_len = sdvl_decode(rohc_buf_data_at(remain_data, 1),
+		                                    remain_data.len - 1, &large_cid,
+		                                    &large_cid_bits_nr);
+		if(peeked->large_cid_len != 1 && peeked->large_cid_len != 2)
+		{
+			goto error;
+		}
+		peeked->cid = large_cid & 0xffff;
+	}
+
+	return (peeked->cid <= decomp->medium.max_cid);
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Find the context for the given ROHC packet
  *
@@ -3962,6 +6034,7 @@ static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
 	const uint8_t *remain_data = packet;
 	size_t remain_len = packet_len;
 	bool new_context_needed = false;
+	const struct rohc_decomp_ctxt *cr_base_ctxt = NULL;
 	bool is_packet_ir_dyn;
 	bool is_packet_ir_cr;
 	bool is_packet_ir;
@@ -4029,6 +6102,38 @@ static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
 
 		is_packet_ir_cr = !!((*profile_id) == ROHC_PROFILE_TCP && (pkt_type & 0x01) == 0);
 		is_packet_ir = (is_packet_ir && !is_packet_ir_cr);
+
+		/* the base context of an IR-CR packet shall not be evicted to make room
+		 * for the new context: find it from the CRC byte, the B flag and the
+		 * Base CID that follow the profile octet, the packet is checked again
+		 * once it is parsed by the profile */
+		if(is_packet_ir_cr && remain_len >= 2)
+		{
+			const bool is_base_cid_present = !!GET_BIT_7(remain_data + 1);
+			rohc_cid_t base_cid = cid;
+
+			if(is_base_cid_present && remain_len >= 3)
+			{
+				if(decomp->medium.cid_type == ROHC_SMALL_CID)
+				{
+					base_cid = GET_BIT_0_3(remain_data + 2);
+				}
+				else
+				{
+					uint32_t base_cid_32b;
+					size_t base_cid_bits_nr;
+					const size_t base_cid_len =
+						sdvl_decode(remain_data + 2, remain_len - 2, &base_cid_32b,
+						            &base_cid_bits_nr);
+					base_cid = ((base_cid_len == 1 || base_cid_len == 2) ?
+					            (base_cid_32b & 0xffff) : UINT16_MAX);
+				}
+			}
+			if(base_cid <= decomp->medium.max_cid)
+			{
+				cr_base_ctxt = decomp->contexts[base_cid];
+			}
+		}
 	}
 	else
 	{
@@ -4105,7 +6210,7 @@ static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		           "create new context with CID %u and profile '%s' (0x%04x)",
 		           cid, rohc_get_profile_descr(*profile_id), *profile_id);
-		*context = context_create(decomp, cid, profile);
+		*context = context_create(decomp, cid, profile, cr_base_ctxt);
 		if((*context) == NULL)
 		{
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
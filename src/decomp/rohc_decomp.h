@@ -49,11 +49,12 @@ extern "C"
 
 
 /*
- * Declare the private ROHC decompressor structure that is defined inside the
- * library.
+ * Declare the private ROHC decompressor structures that are defined inside
+ * the library.
  */
 
 struct rohc_decomp;
+struct rohc_decomp_pool;
 
 
 
@@ -249,6 +250,9 @@ typedef struct
  * Supported versions:
  *  - major 0 and minor = 0 contains: version_major, version_minor,
  *    contexts_nr, packets_nr, comp_bytes_nr, and uncomp_bytes_nr.
+ *  - major 0 and minor = 1 adds: corrected_crc_failures,
+ *    corrected_sn_wraparounds, and corrected_wrong_sn_updates.
+ *  - major 0 and minor = 2 adds: evicted_contexts_nr and contexts_mem.
  *
  * @ingroup rohc_decomp
  *
@@ -279,9 +283,86 @@ typedef struct
 	 *  upon CRC failure */
 	unsigned long corrected_wrong_sn_updates;
 
+	/* added in 0.2 */
+	/** The cumulative number of contexts evicted to respect the memory limit
+	 *  set by \ref rohc_decomp_set_contexts_max_mem */
+	unsigned long evicted_contexts_nr;
+	/** The memory (in bytes) currently used by the contexts */
+	size_t contexts_mem;
+
 } __attribute__((packed)) rohc_decomp_general_info_t;
 
 
+/** The maximum number of profiles described by \ref rohc_decomp_memory_usage_t */
+#define ROHC_DECOMP_MEM_PROFILES_MAX  18U
+
+
+/**
+ * @brief The memory used by the contexts of one decompression profile
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_memory_usage_t
+ */
+typedef struct
+{
+	/** The profile the contexts are associated with */
+	rohc_profile_t profile;
+	/** The number of contexts associated with the profile */
+	size_t contexts_nr;
+	/** The memory (in bytes) used by the generic parts of the contexts */
+	size_t contexts_mem;
+	/** The memory (in bytes) used by the profile-specific parts of the
+	 *  contexts */
+	size_t specific_mem;
+	/** The memory (in bytes) used to parse and decode the ROHC packets of the
+	 *  profile, shared by all the contexts of the profile */
+	size_t scratch_mem;
+} __attribute__((packed)) rohc_decomp_profile_memory_usage_t;
+
+
+/**
+ * @brief The memory used by the decompressor
+ *
+ * The structure is used by the \ref rohc_decomp_get_memory_usage function
+ * to report the memory allocated by the decompressor, per subsystem and per
+ * profile.
+ *
+ * Versioning works as for \ref rohc_decomp_general_info_t.
+ *
+ * Supported versions:
+ *  - major 0 and minor = 0 contains: version_major, version_minor,
+ *    total_mem, decomp_mem, contexts_mem, pool_mem, rru_mem, profiles_nr,
+ *    and profiles.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_memory_usage
+ */
+typedef struct
+{
+	/** The major version of this structure */
+	unsigned short version_major;
+	/** The minor version of this structure */
+	unsigned short version_minor;
+	/** The memory (in bytes) used by the decompressor, all subsystems
+	 *  included */
+	size_t total_mem;
+	/** The memory (in bytes) used by the decompressor object itself */
+	size_t decomp_mem;
+	/** The memory (in bytes) used by the array of MAX_CID + 1 contexts */
+	size_t contexts_mem;
+	/** The memory (in bytes) used by the released contexts kept for re-use */
+	size_t pool_mem;
+	/** The memory (in bytes) used by the buffer for segmentation (MRRU) */
+	size_t rru_mem;
+	/** The number of profiles described in \e profiles */
+	size_t profiles_nr;
+	/** The memory used by the contexts of every enabled profile */
+	rohc_decomp_profile_memory_usage_t profiles[ROHC_DECOMP_MEM_PROFILES_MAX];
+} __attribute__((packed)) rohc_decomp_memory_usage_t;
+
+
 /**
  * @brief The different features of the ROHC decompressor
  *
@@ -303,6 +384,9 @@ typedef enum
 	ROHC_DECOMP_FEATURE_COMPAT_1_6_x = (1 << 1),
 	/** Dump content of packets in traces (beware: performance impact) */
 	ROHC_DECOMP_FEATURE_DUMP_PACKETS = (1 << 3),
+	/** Coalesce feedbacks per context until they are flushed with
+	 *  \ref rohc_decomp_flush_feedback */
+	ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK = (1 << 4),
 
 } rohc_decomp_features_t;
 
@@ -326,6 +410,67 @@ rohc_status_t ROHC_EXPORT rohc_decompress3(struct rohc_decomp *const decomp,
                                            struct rohc_buf *const feedback_send)
 	__attribute__((warn_unused_result));
 
+rohc_status_t ROHC_EXPORT rohc_decompress_burst(struct rohc_decomp *const decomp,
+                                                const struct rohc_buf *const rohc_packets,
+                                                struct rohc_buf *const uncomp_packets,
+                                                rohc_status_t *const statuses,
+                                                struct rohc_buf *const rcvd_feedbacks,
+                                                struct rohc_buf *const feedbacks_send,
+                                                const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_decompress_in_place(struct rohc_decomp *const decomp,
+                                                   struct rohc_buf *const packet,
+                                                   struct rohc_buf *const rcvd_feedback,
+                                                   struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_decompress_segments(struct rohc_decomp *const decomp,
+                                                   const struct rohc_buf *const segments,
+                                                   const size_t segments_nr,
+                                                   struct rohc_buf *const uncomp_packet,
+                                                   struct rohc_buf *const rcvd_feedback,
+                                                   struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decomp_flush_feedback(struct rohc_decomp *const decomp,
+                                              struct rohc_buf *const feedbacks)
+	__attribute__((warn_unused_result));
+
+
+
+/*
+ * Functions related to decompressor pools:
+ */
+
+struct rohc_decomp_pool * ROHC_EXPORT rohc_decomp_pool_new(const rohc_cid_type_t cid_type,
+                                                           const rohc_cid_t max_cid,
+                                                           const rohc_mode_t mode,
+                                                           const size_t workers_nr)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_decomp_pool_free(struct rohc_decomp_pool *const pool);
+
+struct rohc_decomp * ROHC_EXPORT rohc_decomp_pool_get_worker(const struct rohc_decomp_pool *const pool,
+                                                             const size_t worker_id)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_pool_dispatch(const struct rohc_decomp_pool *const pool,
+                                           const struct rohc_buf rohc_packet,
+                                           size_t *const worker_id)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_decomp_pool_decompress(struct rohc_decomp_pool *const pool,
+                                                      const size_t worker_id,
+                                                      const struct rohc_buf rohc_packet,
+                                                      struct rohc_buf *const uncomp_packet,
+                                                      struct rohc_buf *const rcvd_feedback)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decomp_pool_get_feedbacks(struct rohc_decomp_pool *const pool,
+                                                  struct rohc_buf *const feedbacks)
+	__attribute__((warn_unused_result));
+
 
 
 /*
@@ -339,6 +484,10 @@ bool ROHC_EXPORT rohc_decomp_get_general_info(const struct rohc_decomp *const de
                                               rohc_decomp_general_info_t *const info)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_get_memory_usage(const struct rohc_decomp *const decomp,
+                                              rohc_decomp_memory_usage_t *const usage)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_decomp_get_context_info(const struct rohc_decomp *const decomp,
                                               const rohc_cid_t cid,
                                               rohc_decomp_context_info_t *const info)
@@ -373,6 +522,16 @@ bool ROHC_EXPORT rohc_decomp_get_mrru(const struct rohc_decomp *const decomp,
                                       size_t *const mrru)
 	__attribute__((warn_unused_result));
 
+/* memory for contexts */
+
+bool ROHC_EXPORT rohc_decomp_set_contexts_max_mem(struct rohc_decomp *const decomp,
+                                                  const size_t max_mem)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_contexts_max_mem(const struct rohc_decomp *const decomp,
+                                                  size_t *const max_mem)
+	__attribute__((warn_unused_result));
+
 /* pRTT */
 
 bool ROHC_EXPORT rohc_decomp_set_prtt(struct rohc_decomp *const decomp,
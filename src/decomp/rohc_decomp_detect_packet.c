@@ -41,6 +41,208 @@
 #define D_IR_DYN_PACKET  0xf8
 
 
+/*
+ * Classification of ROHC packets from their first byte.
+ *
+ * For every family of profiles, the X_TYPE(b) and X_LEN(b) macros give the
+ * packet type and the minimal length of the base header for the first byte b
+ * as constant expressions, so that the lookup tables are built at compile
+ * time. Base header lengths include the first byte, but not the large CID.
+ */
+
+/* RFC 3095: UO-0 '0', UO-1 '10', UOR-2 '110', IR-DYN '11111000',
+ * IR '1111110' */
+#define D_PKT_IS_UO0(b)    (((b) & 0x80) == 0x00)
+#define D_PKT_IS_UO1(b)    (((b) & 0xc0) == 0x80)
+#define D_PKT_IS_UOR2(b)   (((b) & 0xe0) == 0xc0)
+#define D_PKT_IS_IRDYN(b)  ((b) == D_IR_DYN_PACKET)
+#define D_PKT_IS_IR(b)     (((b) >> 1) == D_IR_PACKET)
+
+#define D_RFC3095_TYPE(b) \
+	(D_PKT_IS_UO0(b) ? ROHC_PACKET_UO_0 : \
+	 D_PKT_IS_UO1(b) ? ROHC_PACKET_UO_1 : \
+	 D_PKT_IS_UOR2(b) ? ROHC_PACKET_UOR_2 : \
+	 D_PKT_IS_IRDYN(b) ? ROHC_PACKET_IR_DYN : \
+	 D_PKT_IS_IR(b) ? ROHC_PACKET_IR : \
+	 ROHC_PACKET_UNKNOWN)
+#define D_RFC3095_LEN(b) \
+	(D_PKT_IS_UO0(b) ? 1 : \
+	 D_PKT_IS_UO1(b) ? 2 : \
+	 D_PKT_IS_UOR2(b) ? 2 : \
+	 (D_PKT_IS_IRDYN(b) || D_PKT_IS_IR(b)) ? 3 : /* type, profile, CRC */ \
+	 0)
+
+/* RFC 3095, RTP profile: UO-1-RTP and UOR-2-RTP only */
+#define D_RTP_TYPE(b) \
+	(D_PKT_IS_UO1(b) ? ROHC_PACKET_UO_1_RTP : \
+	 D_PKT_IS_UOR2(b) ? ROHC_PACKET_UOR_2_RTP : \
+	 D_RFC3095_TYPE(b))
+#define D_RTP_LEN(b) \
+	(D_PKT_IS_UOR2(b) ? 3 : D_RFC3095_LEN(b))
+
+/* RFC 3095, RTP profile: UO-1-ID/TS (T bit in first byte) and UOR-2-ID
+ * (may become UOR-2-TS once the T bit in the second byte is known) */
+#define D_RTP_IPV4_ID_TYPE(b) \
+	(D_PKT_IS_UO1(b) ? (((b) & 0x20) ? ROHC_PACKET_UO_1_TS : ROHC_PACKET_UO_1_ID) : \
+	 D_PKT_IS_UOR2(b) ? ROHC_PACKET_UOR_2_ID : \
+	 D_RFC3095_TYPE(b))
+#define D_RTP_IPV4_ID_LEN(b) \
+	D_RTP_LEN(b)
+
+/* RFC 6846: IR '11111101', IR-CR '11111100', IR-DYN '11111000',
+ * co_common '1111101' */
+#define D_TCP_IS_IR(b)         ((b) == 0xfd)
+#define D_TCP_IS_IR_CR(b)      ((b) == 0xfc)
+#define D_TCP_IS_CO_COMMON(b)  (((b) & 0xfe) == 0xfa)
+
+#define D_TCP_COMMON_TYPE(b, co_type) \
+	(D_TCP_IS_IR(b) ? ROHC_PACKET_IR : \
+	 D_TCP_IS_IR_CR(b) ? ROHC_PACKET_IR_CR : \
+	 D_PKT_IS_IRDYN(b) ? ROHC_PACKET_IR_DYN : \
+	 D_TCP_IS_CO_COMMON(b) ? ROHC_PACKET_TCP_CO_COMMON : \
+	 (co_type))
+#define D_TCP_COMMON_LEN(b, co_len) \
+	((D_TCP_IS_IR(b) || D_TCP_IS_IR_CR(b) || D_PKT_IS_IRDYN(b)) ? 3 : \
+	 D_TCP_IS_CO_COMMON(b) ? 5 : \
+	 (co_len))
+
+#define D_TCP_SEQ_TYPE(b) \
+	D_TCP_COMMON_TYPE(b, \
+		(((b) & 0x80) == 0x00 ? ROHC_PACKET_TCP_SEQ_4 : \
+		 ((b) & 0xf0) == 0x80 ? ROHC_PACKET_TCP_SEQ_5 : \
+		 ((b) & 0xf0) == 0x90 ? ROHC_PACKET_TCP_SEQ_3 : \
+		 ((b) & 0xf0) == 0xa0 ? ROHC_PACKET_TCP_SEQ_1 : \
+		 ((b) & 0xf0) == 0xb0 ? ROHC_PACKET_TCP_SEQ_8 : \
+		 ((b) & 0xf0) == 0xc0 ? ROHC_PACKET_TCP_SEQ_7 : \
+		 ((b) & 0xf8) == 0xd8 ? ROHC_PACKET_TCP_SEQ_6 : \
+		 ((b) & 0xf8) == 0xd0 ? ROHC_PACKET_TCP_SEQ_2 : \
+		 ROHC_PACKET_UNKNOWN))
+#define D_TCP_SEQ_LEN(b) \
+	D_TCP_COMMON_LEN(b, \
+		(((b) & 0x80) == 0x00 ? 2 : /* seq_4 */ \
+		 ((b) & 0xf0) == 0x80 ? 6 : /* seq_5 */ \
+		 ((b) & 0xf0) == 0x90 ? 4 : /* seq_3 */ \
+		 ((b) & 0xf0) == 0xa0 ? 4 : /* seq_1 */ \
+		 ((b) & 0xf0) == 0xb0 ? 7 : /* seq_8 */ \
+		 ((b) & 0xf0) == 0xc0 ? 6 : /* seq_7 */ \
+		 ((b) & 0xf8) == 0xd8 ? 5 : /* seq_6 */ \
+		 ((b) & 0xf8) == 0xd0 ? 3 : /* seq_2 */ \
+		 0))
+
+#define D_TCP_RND_TYPE(b) \
+	D_TCP_COMMON_TYPE(b, \
+		(((b) & 0x80) == 0x00 ? ROHC_PACKET_TCP_RND_3 : \
+		 ((b) & 0xe0) == 0x80 ? ROHC_PACKET_TCP_RND_5 : \
+		 ((b) & 0xf0) == 0xa0 ? ROHC_PACKET_TCP_RND_6 : \
+		 ((b) & 0xfc) == 0xbc ? ROHC_PACKET_TCP_RND_7 : \
+		 ((b) & 0xfc) == 0xb8 ? ROHC_PACKET_TCP_RND_1 : \
+		 ((b) & 0xf8) == 0xb0 ? ROHC_PACKET_TCP_RND_8 : \
+		 ((b) & 0xf0) == 0xc0 ? ROHC_PACKET_TCP_RND_2 : \
+		 ((b) & 0xf0) == 0xd0 ? ROHC_PACKET_TCP_RND_4 : \
+		 ROHC_PACKET_UNKNOWN))
+#define D_TCP_RND_LEN(b) \
+	D_TCP_COMMON_LEN(b, \
+		(((b) & 0x80) == 0x00 ? 3 : /* rnd_3 */ \
+		 ((b) & 0xe0) == 0x80 ? 5 : /* rnd_5 */ \
+		 ((b) & 0xf0) == 0xa0 ? 4 : /* rnd_6 */ \
+		 ((b) & 0xfc) == 0xbc ? 6 : /* rnd_7 */ \
+		 ((b) & 0xfc) == 0xb8 ? 4 : /* rnd_1 */ \
+		 ((b) & 0xf8) == 0xb0 ? 7 : /* rnd_8 */ \
+		 ((b) & 0xf0) == 0xc0 ? 2 : /* rnd_2 */ \
+		 ((b) & 0xf0) == 0xd0 ? 2 : /* rnd_4 */ \
+		 0))
+
+/* RFC 5225: pt_0_crc3 '0', pt_0_crc7 '100', pt_1_seq_id '101',
+ * pt_2_seq_id '110', co_common '11111010', co_repair '11111011',
+ * IR '11111101' */
+#define D_RFC5225_TYPE(b) \
+	(((b) & 0x80) == 0x00 ? ROHC_PACKET_PT_0_CRC3 : \
+	 ((b) & 0xe0) == 0x80 ? ROHC_PACKET_NORTP_PT_0_CRC7 : \
+	 ((b) & 0xe0) == 0xa0 ? ROHC_PACKET_NORTP_PT_1_SEQ_ID : \
+	 ((b) & 0xe0) == 0xc0 ? ROHC_PACKET_NORTP_PT_2_SEQ_ID : \
+	 (b) == 0xfa ? ROHC_PACKET_CO_COMMON : \
+	 (b) == 0xfb ? ROHC_PACKET_CO_REPAIR : \
+	 (b) == 0xfd ? ROHC_PACKET_IR : \
+	 ROHC_PACKET_UNKNOWN)
+#define D_RFC5225_LEN(b) \
+	(((b) & 0x80) == 0x00 ? 1 : /* pt_0_crc3 */ \
+	 ((b) & 0xe0) == 0x80 ? 2 : /* pt_0_crc7 */ \
+	 ((b) & 0xe0) == 0xa0 ? 2 : /* pt_1_seq_id */ \
+	 ((b) & 0xe0) == 0xc0 ? 3 : /* pt_2_seq_id */ \
+	 (b) == 0xfa ? 3 : /* co_common base */ \
+	 (b) == 0xfb ? 3 : /* type, CRC-7 and CRC-3 */ \
+	 (b) == 0xfd ? 3 : /* type, profile, CRC */ \
+	 0)
+
+/* build one lookup table of 256 entries from the X_TYPE/X_LEN macros */
+#define D_PKT_CLASS(x, b)       { x##_TYPE(b), x##_LEN(b) }
+#define D_PKT_CLASSES_4(x, b) \
+	D_PKT_CLASS(x, (b)), D_PKT_CLASS(x, (b) + 1), \
+	D_PKT_CLASS(x, (b) + 2), D_PKT_CLASS(x, (b) + 3)
+#define D_PKT_CLASSES_16(x, b) \
+	D_PKT_CLASSES_4(x, (b)), D_PKT_CLASSES_4(x, (b) + 4), \
+	D_PKT_CLASSES_4(x, (b) + 8), D_PKT_CLASSES_4(x, (b) + 12)
+#define D_PKT_CLASSES_64(x, b) \
+	D_PKT_CLASSES_16(x, (b)), D_PKT_CLASSES_16(x, (b) + 16), \
+	D_PKT_CLASSES_16(x, (b) + 32), D_PKT_CLASSES_16(x, (b) + 48)
+#define D_PKT_TABLE(x) \
+	{ \
+		D_PKT_CLASSES_64(x, 0x00), D_PKT_CLASSES_64(x, 0x40), \
+		D_PKT_CLASSES_64(x, 0x80), D_PKT_CLASSES_64(x, 0xc0) \
+	}
+
+
+/** The lookup tables from the first byte of ROHC packets to their class */
+const struct rohc_decomp_pkt_class
+	rohc_decomp_pkt_tables[ROHC_DECOMP_PKT_TABLE_MAX][256] =
+{
+	[ROHC_DECOMP_PKT_TABLE_RFC3095]     = D_PKT_TABLE(D_RFC3095),
+	[ROHC_DECOMP_PKT_TABLE_RTP]         = D_PKT_TABLE(D_RTP),
+	[ROHC_DECOMP_PKT_TABLE_RTP_IPV4_ID] = D_PKT_TABLE(D_RTP_IPV4_ID),
+	[ROHC_DECOMP_PKT_TABLE_TCP_SEQ]     = D_PKT_TABLE(D_TCP_SEQ),
+	[ROHC_DECOMP_PKT_TABLE_TCP_RND]     = D_PKT_TABLE(D_TCP_RND),
+	[ROHC_DECOMP_PKT_TABLE_RFC5225]     = D_PKT_TABLE(D_RFC5225),
+};
+
+
+/**
+ * @brief Find out the type of a ROHC packet thanks to one lookup table
+ *
+ * The first byte of the ROHC packet selects the packet type in the table,
+ * no comparison chain is required. The packet is rejected if it is too short
+ * for the base header of the packet type.
+ *
+ * @param table          The lookup table for the profile and context state
+ * @param data           The ROHC packet to analyze
+ * @param data_len       The length of the ROHC packet
+ * @param large_cid_len  The length of the optional large CID field
+ * @return               The packet type, ROHC_PACKET_UNKNOWN if the first
+ *                       byte is not a known discriminator or if the packet
+ *                       is too short
+ */
+rohc_packet_t rohc_decomp_pkt_type_from_table(const rohc_decomp_pkt_table_t table,
+                                              const uint8_t *const data,
+                                              const size_t data_len,
+                                              const size_t large_cid_len)
+{
+	const struct rohc_decomp_pkt_class *pkt_class;
+
+	assert(table < ROHC_DECOMP_PKT_TABLE_MAX);
+
+	if(data_len < 1)
+	{
+		return ROHC_PACKET_UNKNOWN;
+	}
+	pkt_class = &(rohc_decomp_pkt_tables[table][data[0]]);
+	if(data_len < (pkt_class->base_hdr_len + large_cid_len))
+	{
+		return ROHC_PACKET_UNKNOWN;
+	}
+
+	return pkt_class->type;
+}
+
+
 /**
  * @brief Find out whether the field is a segment field or not
  *
@@ -27,15 +27,65 @@
 #ifndef ROHC_DECOMP_DETECT_PACKET_H
 #define ROHC_DECOMP_DETECT_PACKET_H
 
+#include "rohc_packets.h"
+
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
 
+/**
+ * @brief The lookup tables that classify ROHC packets from their first byte
+ *
+ * There is one table per family of profiles and per context state that
+ * changes the meaning of the first byte.
+ */
+typedef enum
+{
+	/** IP-only, UDP and ESP profiles (RFC 3095) */
+	ROHC_DECOMP_PKT_TABLE_RFC3095 = 0,
+	/** RTP profile (RFC 3095) with no IPv4 header with context(RND) = 0 */
+	ROHC_DECOMP_PKT_TABLE_RTP,
+	/** RTP profile (RFC 3095) with at least one IPv4 header with
+	 *  context(RND) = 0 */
+	ROHC_DECOMP_PKT_TABLE_RTP_IPV4_ID,
+	/** TCP profile (RFC 6846) with a sequential innermost IP-ID */
+	ROHC_DECOMP_PKT_TABLE_TCP_SEQ,
+	/** TCP profile (RFC 6846) with a non-sequential innermost IP-ID */
+	ROHC_DECOMP_PKT_TABLE_TCP_RND,
+	/** ROHCv2 profiles (RFC 5225) */
+	ROHC_DECOMP_PKT_TABLE_RFC5225,
+
+	ROHC_DECOMP_PKT_TABLE_MAX /**< The number of lookup tables */
+} rohc_decomp_pkt_table_t;
+
+
+/** The classification of one ROHC packet according to its first byte */
+struct rohc_decomp_pkt_class
+{
+	/** The type of the ROHC packet, see \ref rohc_packet_t */
+	uint8_t type;
+	/** The minimal length (in bytes) of the base header, large CID excluded */
+	uint8_t base_hdr_len;
+};
+
+
+/** The lookup tables from the first byte of ROHC packets to their class */
+extern const struct rohc_decomp_pkt_class
+	rohc_decomp_pkt_tables[ROHC_DECOMP_PKT_TABLE_MAX][256];
+
+
 /*
  * Function prototypes.
  */
 
+/* table-driven packet detection */
+rohc_packet_t rohc_decomp_pkt_type_from_table(const rohc_decomp_pkt_table_t table,
+                                              const uint8_t *const data,
+                                              const size_t data_len,
+                                              const size_t large_cid_len)
+	__attribute__((warn_unused_result, nonnull(2), pure));
+
 /* ROHC segment */
 bool rohc_decomp_packet_is_segment(const uint8_t *const data)
 	__attribute__((warn_unused_result, nonnull(1), pure));
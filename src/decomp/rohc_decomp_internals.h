@@ -39,6 +39,15 @@
  */
 
 
+/** The number of packets of one burst whose CIDs are decoded and whose
+ *  contexts are prefetched before they are decompressed */
+#define ROHC_DECOMP_BURST_PREFETCH_NR  16U
+
+/** The maximum number of released contexts that the decompressor keeps in its
+ *  pool for later re-use */
+#define ROHC_DECOMP_CTXTS_POOL_MAX  64U
+
+
 /** Print a warning trace for the given decompression context */
 #define rohc_decomp_warn(context, format, ...) \
 	rohc_warning((context)->decompressor, ROHC_TRACE_DECOMP, \
@@ -95,6 +104,9 @@ struct d_statistics
 	/** The cumulative number of successful corrections of incorrect SN updates
 	 *  upon CRC failure */
 	unsigned long corrected_wrong_sn_updates;
+
+	/** The cumulative number of contexts evicted to respect the memory limit */
+	unsigned long evicted_contexts;
 };
 
 
@@ -132,6 +144,54 @@ struct rohc_ack_stats
 };
 
 
+/**
+ * @brief The parsing scratch areas shared by all the contexts of one profile
+ *
+ * Only one packet is decompressed at a time by a given decompressor, so the
+ * bits extracted from the ROHC packet and the values decoded from them do not
+ * need to be stored in every context. The extracted bits are reset by the
+ * profile before every packet is parsed, the decoded values are cleared
+ * before every decoding attempt.
+ */
+struct rohc_decomp_volat_scratch
+{
+	void *extr_bits;       /**< The bits extracted from the ROHC packet */
+	void *decoded_values;  /**< The values decoded from the extracted bits */
+};
+
+
+/**
+ * @brief The persistent parts of the released contexts of one profile
+ *
+ * Only the profiles that allocate their persistent part with
+ * \ref rohc_decomp_persist_ctxt_alloc use the pool. The released parts are
+ * linked through their first bytes.
+ */
+struct rohc_decomp_persist_pool
+{
+	void *first;  /**< The first released part kept for re-use */
+	size_t nr;    /**< The number of released parts kept for re-use */
+};
+
+
+/**
+ * @brief The FCS-32 of one Reconstructed Reception Unit (RRU) being received
+ *
+ * The RRU ends with its FCS-32, but the length of the RRU is not known before
+ * its final segment is received: the last bytes received are held back until
+ * more bytes are received, all other bytes are covered by the running CRC.
+ */
+struct rohc_decomp_rru_fcs
+{
+	/** The CRC of all the RRU bytes received so far, except the held ones */
+	uint32_t crc;
+	/** The last RRU bytes received, the FCS-32 once the RRU is complete */
+	uint8_t tail[CRC_FCS32_LEN];
+	/** The number of bytes in \e tail */
+	size_t tail_len;
+};
+
+
 /**
  * @brief The ROHC decompressor
  */
@@ -145,6 +205,9 @@ struct rohc_decomp
 
 	/** Which profiles are enabled and with one are not? */
 	bool enabled_profiles[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
+	/** The parsing scratch areas of the profiles, allocated on first use */
+	struct rohc_decomp_volat_scratch
+		volat_scratch[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
 
 	/** The operation mode that the contexts shall target */
 	rohc_mode_t target_mode;
@@ -155,6 +218,27 @@ struct rohc_decomp
 	uint16_t num_contexts_used;
 	/** The last decompression context used by the decompressor */
 	struct rohc_decomp_ctxt *last_context;
+	/** The most recently used decompression context */
+	struct rohc_decomp_ctxt *lru_first;
+	/** The least recently used decompression context, evicted first */
+	struct rohc_decomp_ctxt *lru_last;
+	/** The released contexts kept for re-use */
+	struct rohc_decomp_ctxt *ctxts_pool;
+	/** The number of released contexts kept for re-use */
+	size_t ctxts_pool_nr;
+	/** The generic parts of released RFC3095 contexts kept for re-use */
+	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxts_pool;
+	/** The number of generic parts of RFC3095 contexts kept for re-use */
+	size_t rfc3095_ctxts_pool_nr;
+	/** The persistent parts of released TCP and ROHCv2 contexts kept for
+	 *  re-use, one pool per profile */
+	struct rohc_decomp_persist_pool
+		persist_pools[ROHC_PROFILE_ID_MAJOR_MAX + 1][ROHC_PROFILE_ID_MINOR_MAX + 1];
+	/** The memory (in bytes) allocated for the decompression contexts */
+	size_t ctxts_mem;
+	/** The maximum memory (in bytes) for the decompression contexts,
+	 *  0 for no limit */
+	size_t ctxts_max_mem;
 
 
 	/* feedback-related variables */
@@ -169,6 +253,11 @@ struct rohc_decomp
 	uint32_t last_pkts_errors;
 	/** The information for feedback rate-limiting */
 	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
+	/** The context with the oldest pending feedback when feedbacks are
+	 *  coalesced, see \ref ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK */
+	struct rohc_decomp_ctxt *fb_first;
+	/** The context with the newest pending feedback */
+	struct rohc_decomp_ctxt *fb_last;
 
 
 	/* segment-related variables */
@@ -177,6 +266,9 @@ struct rohc_decomp
 	uint8_t *rru;
 	/** The length (in bytes) of the Reconstructed Reception Unit */
 	size_t rru_len;
+	/** The FCS-32 of the Reconstructed Reception Unit, computed as segments
+	 *  are received */
+	struct rohc_decomp_rru_fcs rru_fcs;
 	/** The Maximum Reconstructed Reception Unit (MRRU) */
 	size_t mrru;
 
@@ -191,6 +283,70 @@ struct rohc_decomp
 };
 
 
+/** The maximum number of workers of one decompressor pool */
+#define ROHC_DECOMP_POOL_WORKERS_MAX  64U
+
+/** The maximum length (in bytes) of one feedback queued by one worker */
+#define ROHC_DECOMP_POOL_FEEDBACK_MAX_LEN  64U
+
+/** The number of feedbacks that one worker may queue before they are read */
+#define ROHC_DECOMP_POOL_FEEDBACK_QUEUE_LEN  64U
+
+
+/** One feedback queued by one worker of a decompressor pool */
+struct rohc_decomp_pool_feedback
+{
+	/** The length (in bytes) of the feedback */
+	size_t len;
+	/** The feedback data */
+	uint8_t data[ROHC_DECOMP_POOL_FEEDBACK_MAX_LEN];
+};
+
+
+/**
+ * @brief One worker of a decompressor pool
+ *
+ * The feedbacks generated by the worker are queued in a single-producer /
+ * single-consumer ring: only the worker writes \e fb_tail and only the
+ * reader of feedbacks writes \e fb_head. The two indexes are located on
+ * both sides of the ring so that they do not share one cache line.
+ */
+struct rohc_decomp_pool_worker
+{
+	/** The decompressor that owns the contexts of the worker */
+	struct rohc_decomp *decomp;
+	/** The index of the next feedback to read, written by the reader only */
+	size_t fb_head;
+	/** The ring of feedbacks generated by the worker */
+	struct rohc_decomp_pool_feedback fbs[ROHC_DECOMP_POOL_FEEDBACK_QUEUE_LEN];
+	/** The index of the next free feedback slot, written by the worker only */
+	size_t fb_tail;
+	/** The number of feedbacks dropped because the ring was full */
+	size_t fbs_dropped_nr;
+};
+
+
+/**
+ * @brief A pool of ROHC decompressors that share one ROHC channel
+ *
+ * Every worker of the pool owns one range of CIDs of the channel, and one
+ * decompressor with its own contexts, parsing scratch, feedback counters
+ * and statistics. Workers thus share no mutable state and may run on
+ * different threads.
+ */
+struct rohc_decomp_pool
+{
+	/** The number of workers in the pool */
+	size_t workers_nr;
+	/** The number of CIDs owned by every worker */
+	size_t cids_per_worker;
+	/** The worker whose feedbacks are read first next time */
+	size_t next_fb_worker;
+	/** The workers of the pool */
+	struct rohc_decomp_pool_worker *workers;
+};
+
+
 /**
  * @brief The different correction algorithms available in case of CRC failure
  */
@@ -261,6 +417,23 @@ struct rohc_decomp_volat_ctxt
 };
 
 
+/** The maximum length (in bytes) of one feedback item: feedback type and
+ *  Size octet, CID and feedback data */
+#define ROHC_DECOMP_FEEDBACK_ITEM_MAX_LEN  (2U + 2U + FEEDBACK_DATA_MAX_LEN)
+
+
+/** One feedback item waiting to be flushed */
+struct rohc_decomp_feedback_item
+{
+	/** The type of acknowledgement */
+	enum rohc_feedback_ack_type type;
+	/** The length of the feedback item, 0 if no feedback is pending */
+	size_t len;
+	/** The feedback item, header included */
+	uint8_t data[ROHC_DECOMP_FEEDBACK_ITEM_MAX_LEN];
+};
+
+
 /**
  * @brief The ROHC decompression context
  */
@@ -279,6 +452,14 @@ struct rohc_decomp_ctxt
 	/** The volatile data, erased between two ROHC packets */
 	struct rohc_decomp_volat_ctxt volat_ctxt;
 
+	/** The memory (in bytes) allocated for the context */
+	size_t mem_size;
+	/** The previous context in the LRU list (more recently used) */
+	struct rohc_decomp_ctxt *lru_prev;
+	/** The next context in the LRU list (less recently used), or the next
+	 *  context in the pool of released contexts */
+	struct rohc_decomp_ctxt *lru_next;
+
 	/** The operation mode in which the context operates */
 	rohc_mode_t mode;
 	/** The operation state in which the context operates */
@@ -288,6 +469,12 @@ struct rohc_decomp_ctxt
 	uint32_t last_pkts_errors;
 	/** The information for feedback rate-limiting */
 	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
+	/** The feedback pending for the context when feedbacks are coalesced */
+	struct rohc_decomp_feedback_item pending_fb;
+	/** The previous context in the list of pending feedbacks (older one) */
+	struct rohc_decomp_ctxt *fb_prev;
+	/** The next context in the list of pending feedbacks (newer one) */
+	struct rohc_decomp_ctxt *fb_next;
 
 	/** The context for corrections upon CRC failure */
 	struct rohc_decomp_crc_corr_ctxt crc_corr;
@@ -339,9 +526,7 @@ typedef bool (*rohc_decomp_new_context_t)(const struct rohc_decomp_ctxt *const c
                                           struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-typedef void (*rohc_decomp_free_context_t)(void *const persist_ctxt,
-                                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(2)));
+typedef void (*rohc_decomp_free_context_t)(void *const persist_ctxt);
 
 typedef rohc_packet_t (*rohc_decomp_detect_pkt_type_t) (const struct rohc_decomp_ctxt *const context,
                                                         const uint8_t *const rohc_packet,
@@ -405,12 +590,22 @@ struct rohc_decomp_profile
 	/** The maximum number of bits of the Master Sequence Number (MSN) */
 	const size_t msn_max_bits;
 
+	/** The memory (in bytes) allocated for the profile-specific part of one
+	 *  decompression context */
+	const size_t persist_ctxt_size;
+	/** The size (in bytes) of the bits extracted from one ROHC packet */
+	const size_t extr_bits_size;
+	/** The size (in bytes) of the values decoded from the extracted bits */
+	const size_t decoded_values_size;
+
 	/** @brief The handler used to create the profile-specific part of the
 	 *         decompression context */
 	rohc_decomp_new_context_t new_context;
 
 	/** @brief The handler used to destroy the profile-specific part of the
-	 *         decompression context */
+	 *         decompression context, NULL if the profile-specific part is
+	 *         allocated with \ref rohc_decomp_persist_ctxt_alloc and kept
+	 *         by the decompressor for re-use */
 	rohc_decomp_free_context_t free_context;
 
 	/** The handler used to detect the type of the ROHC packet */
@@ -435,5 +630,14 @@ struct rohc_decomp_profile
 	rohc_decomp_get_sn_t get_sn;
 };
 
+
+/*
+ * Functions shared by the decompression profiles
+ */
+
+void * rohc_decomp_persist_ctxt_alloc(struct rohc_decomp *const decomp,
+                                      const struct rohc_decomp_profile *const profile)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
 #endif
 
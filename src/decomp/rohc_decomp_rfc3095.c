@@ -362,38 +362,40 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
                                 void *const trace_cb_priv,
                                 const int profile_id)
 {
+	struct rohc_decomp *const decomp = context->decompressor;
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 
-	/* allocate memory for the generic context */
-	*persist_ctxt = calloc(1, sizeof(struct rohc_decomp_rfc3095_ctxt));
-	if((*persist_ctxt) == NULL)
+	/* re-use the generic part of one released context if possible, allocate
+	 * memory for the generic context otherwise */
+	if(decomp->rfc3095_ctxts_pool != NULL)
 	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "no memory for the generic decompression context");
-		goto quit;
+		rfc3095_ctxt = decomp->rfc3095_ctxts_pool;
+		decomp->rfc3095_ctxts_pool = rfc3095_ctxt->pool_next;
+		assert(decomp->rfc3095_ctxts_pool_nr > 0);
+		decomp->rfc3095_ctxts_pool_nr--;
+		memset(rfc3095_ctxt, 0, sizeof(struct rohc_decomp_rfc3095_ctxt));
 	}
-	rfc3095_ctxt = *persist_ctxt;
+	else
+	{
+		rfc3095_ctxt = calloc(1, sizeof(struct rohc_decomp_rfc3095_ctxt));
+		if(rfc3095_ctxt == NULL)
+		{
+			rohc_error(decomp, ROHC_TRACE_DECOMP, context->profile->id,
+			           "no memory for the generic decompression context");
+			goto quit;
+		}
+	}
+	rfc3095_ctxt->decomp = decomp;
+	*persist_ctxt = rfc3095_ctxt;
 
 	/* create the Offset IP-ID decoding context for outer IP header */
 	ip_id_offset_init(&rfc3095_ctxt->outer_ip_id_offset_ctxt);
 	/* create the Offset IP-ID decoding context for inner IP header */
 	ip_id_offset_init(&rfc3095_ctxt->inner_ip_id_offset_ctxt);
 
-	rfc3095_ctxt->outer_ip_changes = calloc(2, sizeof(struct rohc_decomp_rfc3095_changes));
-	if(rfc3095_ctxt->outer_ip_changes == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the outer IP header changes");
-		goto free_context;
-	}
-
-	rfc3095_ctxt->inner_ip_changes = calloc(1, sizeof(struct rohc_decomp_rfc3095_changes));
-	if(rfc3095_ctxt->inner_ip_changes == NULL)
-	{
-		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
-		           "cannot allocate memory for the inner IP header changes");
-		goto free_outer_ip_changes;
-	}
+	/* the information about the IP headers is part of the generic context */
+	rfc3095_ctxt->outer_ip_changes = &(rfc3095_ctxt->ip_changes[0]);
+	rfc3095_ctxt->inner_ip_changes = &(rfc3095_ctxt->ip_changes[1]);
 
 	/* init the context used to compress the list of IPv6 extension headers
 	 * for the outer and inner IP headers */
@@ -414,31 +416,9 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	/* volatile part of the decompression context */
 	volat_ctxt->crc.comp.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.uncomp.type = ROHC_CRC_TYPE_NONE;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_extr_bits));
-	if(volat_ctxt->extr_bits == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the RFC3095 decompression context");
-		goto free_inner_ip_changes;
-	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_decoded_values));
-	if(volat_ctxt->decoded_values == NULL)
-	{
-		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
-		                 "of one of the RFC3095 decompression context");
-		goto free_extr_bits;
-	}
 
 	return true;
 
-free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
-free_inner_ip_changes:
-	zfree(rfc3095_ctxt->inner_ip_changes);
-free_outer_ip_changes:
-	zfree(rfc3095_ctxt->outer_ip_changes);
-free_context:
-	zfree(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -450,25 +430,48 @@ quit:
  * This function is one of the functions that must exist in one profile for the
  * framework to work.
  *
+ * The generic part of the context is kept in the pool of the decompressor for
+ * re-use by the next RFC3095 context if the pool is not full.
+ *
  * @param rfc3095_ctxt  The generic decompression context
- * @param volat_ctxt    The volatile part of the decompression context
  */
-void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
 {
-	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
-
-	/* destroy the information about the IP headers */
-	zfree(rfc3095_ctxt->outer_ip_changes);
-	zfree(rfc3095_ctxt->inner_ip_changes);
+	struct rohc_decomp *const decomp = rfc3095_ctxt->decomp;
 
 	/* destroy profile-specific part */
 	zfree(rfc3095_ctxt->specific);
 
-	/* destroy generic context itself */
-	free(rfc3095_ctxt);
+	/* keep the generic context for re-use if the pool is not full yet,
+	 * destroy it otherwise */
+	if(decomp->rfc3095_ctxts_pool_nr < ROHC_DECOMP_CTXTS_POOL_MAX)
+	{
+		rfc3095_ctxt->pool_next = decomp->rfc3095_ctxts_pool;
+		decomp->rfc3095_ctxts_pool = rfc3095_ctxt;
+		decomp->rfc3095_ctxts_pool_nr++;
+	}
+	else
+	{
+		free(rfc3095_ctxt);
+	}
+}
+
+
+/**
+ * @brief Destroy the generic parts of RFC3095 contexts kept for re-use
+ *
+ * @param decomp  The decompressor that owns the pool
+ */
+void rohc_decomp_rfc3095_free_pool(struct rohc_decomp *const decomp)
+{
+	while(decomp->rfc3095_ctxts_pool != NULL)
+	{
+		struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+			decomp->rfc3095_ctxts_pool;
+		decomp->rfc3095_ctxts_pool = rfc3095_ctxt->pool_next;
+		free(rfc3095_ctxt);
+	}
+	decomp->rfc3095_ctxts_pool_nr = 0;
 }
 
 
@@ -314,10 +314,17 @@ struct rohc_decomp_rfc3095_changes
  */
 struct rohc_decomp_rfc3095_ctxt
 {
+	/// The decompressor that owns the context
+	struct rohc_decomp *decomp;
+	/// The next released context in the pool of the decompressor
+	struct rohc_decomp_rfc3095_ctxt *pool_next;
+
 	/// Information about the outer IP header
 	struct rohc_decomp_rfc3095_changes *outer_ip_changes;
 	/// Information about the inner IP header
 	struct rohc_decomp_rfc3095_changes *inner_ip_changes;
+	/// The memory for the information about the outer and inner IP headers
+	struct rohc_decomp_rfc3095_changes ip_changes[2];
 
 	/// The LSB decoding context for the Sequence Number (SN)
 	struct rohc_lsb_decode sn_lsb_ctxt;
@@ -426,6 +433,11 @@ struct rohc_decomp_rfc3095_ctxt
 };
 
 
+/** The memory (in bytes) allocated for the generic part of one RFC3095 context */
+#define ROHC_DECOMP_RFC3095_CTXT_SIZE \
+	sizeof(struct rohc_decomp_rfc3095_ctxt)
+
+
 /*
  * Public function prototypes.
  */
@@ -438,9 +450,11 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
                                 const int profile_id)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
-void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
-                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
-	__attribute__((nonnull(1, 2)));
+void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
+
+void rohc_decomp_rfc3095_free_pool(struct rohc_decomp *const decomp)
+	__attribute__((nonnull(1)));
 
 bool rfc3095_decomp_parse_pkt(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_buf rohc_packet,
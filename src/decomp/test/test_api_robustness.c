@@ -356,6 +356,232 @@ int main(int argc, char *argv[])
 			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, &pkt_malformed) == ROHC_STATUS_ERROR);
 			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, &pkt_full) == ROHC_STATUS_ERROR);
 		}
+
+		/* rohc_decompress_in_place() */
+		{
+			uint8_t buf_in_place[100];
+			struct rohc_buf pkt_in_place = rohc_buf_init_full(buf_in_place, 0, ts);
+			const size_t headroom = 10;
+
+			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(pkt2.len > 0);
+
+			CHECK(rohc_decompress_in_place(NULL, &pkt_in_place, NULL, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_in_place(decomp, NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_in_place(decomp, &pkt_in_place, NULL, NULL) == ROHC_STATUS_ERROR);
+			pkt_in_place.max_len = sizeof(buf_in_place);
+			CHECK(rohc_decompress_in_place(decomp, &pkt_in_place, NULL, NULL) == ROHC_STATUS_ERROR);
+
+			/* the payload shall not move, the headers shall be built in front of it */
+			memcpy(buf_in_place + headroom, buf, sizeof(buf));
+			pkt_in_place.offset = headroom;
+			pkt_in_place.len = sizeof(buf);
+			CHECK(rohc_decompress_in_place(decomp, &pkt_in_place, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(pkt_in_place.data == buf_in_place);
+			CHECK(pkt_in_place.max_len == sizeof(buf_in_place));
+			CHECK((pkt_in_place.offset + pkt_in_place.len) == (headroom + sizeof(buf)));
+			CHECK(pkt_in_place.len == pkt2.len);
+			CHECK(memcmp(rohc_buf_data(pkt_in_place), rohc_buf_data(pkt2), pkt2.len) == 0);
+
+			/* the IR header is larger than the uncompressed header, so no headroom
+			 * is required */
+			memcpy(buf_in_place, buf, sizeof(buf));
+			pkt_in_place.offset = 0;
+			pkt_in_place.len = sizeof(buf);
+			CHECK(rohc_decompress_in_place(decomp, &pkt_in_place, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK((pkt_in_place.offset + pkt_in_place.len) == sizeof(buf));
+			CHECK(memcmp(rohc_buf_data(pkt_in_place), rohc_buf_data(pkt2), pkt2.len) == 0);
+		}
+
+		/* rohc_decompress_burst() */
+		{
+#define BURST_LEN 20U
+			struct rohc_decomp *decomp_burst;
+			struct rohc_decomp *decomp_seq;
+			uint8_t buf_garbage[] = { 0x00, 0x42 };
+			struct rohc_buf pkts[BURST_LEN];
+			uint8_t uncomp_bufs[2][BURST_LEN][100];
+			struct rohc_buf uncomp_pkts[2][BURST_LEN];
+			uint8_t feedback_bufs[2][BURST_LEN][100];
+			struct rohc_buf feedbacks[2][BURST_LEN];
+			rohc_status_t statuses[2][BURST_LEN];
+			size_t i;
+
+			decomp_burst = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+			CHECK(decomp_burst != NULL);
+			CHECK(rohc_decomp_enable_profile(decomp_burst, ROHC_PROFILE_IP) == true);
+			decomp_seq = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+			CHECK(decomp_seq != NULL);
+			CHECK(rohc_decomp_enable_profile(decomp_seq, ROHC_PROFILE_IP) == true);
+
+			for(i = 0; i < BURST_LEN; i++)
+			{
+				if((i % 3) == 1)
+				{
+					pkts[i] = (struct rohc_buf) rohc_buf_init_full(buf_garbage, sizeof(buf_garbage), ts);
+				}
+				else
+				{
+					pkts[i] = pkt;
+				}
+				for(size_t j = 0; j < 2; j++)
+				{
+					uncomp_pkts[j][i] = (struct rohc_buf) rohc_buf_init_empty(uncomp_bufs[j][i], 100);
+					feedbacks[j][i] = (struct rohc_buf) rohc_buf_init_empty(feedback_bufs[j][i], 100);
+				}
+			}
+
+			CHECK(rohc_decompress_burst(NULL, pkts, uncomp_pkts[0], statuses[0],
+			                            NULL, feedbacks[0], BURST_LEN) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_burst(decomp_burst, NULL, uncomp_pkts[0], statuses[0],
+			                            NULL, feedbacks[0], BURST_LEN) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_burst(decomp_burst, pkts, NULL, statuses[0],
+			                            NULL, feedbacks[0], BURST_LEN) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_burst(decomp_burst, pkts, uncomp_pkts[0], NULL,
+			                            NULL, feedbacks[0], BURST_LEN) == ROHC_STATUS_ERROR);
+			CHECK(rohc_decompress_burst(decomp_burst, pkts, uncomp_pkts[0], statuses[0],
+			                            NULL, feedbacks[0], 0) == ROHC_STATUS_OK);
+
+			/* the burst shall give the same results as sequential calls */
+			CHECK(rohc_decompress_burst(decomp_burst, pkts, uncomp_pkts[0], statuses[0],
+			                            NULL, feedbacks[0], BURST_LEN) == ROHC_STATUS_OK);
+			for(i = 0; i < BURST_LEN; i++)
+			{
+				statuses[1][i] = rohc_decompress3(decomp_seq, pkts[i], &uncomp_pkts[1][i],
+				                                  NULL, &feedbacks[1][i]);
+			}
+			for(i = 0; i < BURST_LEN; i++)
+			{
+				CHECK(statuses[0][i] == statuses[1][i]);
+				CHECK((statuses[0][i] == ROHC_STATUS_OK) == ((i % 3) != 1));
+				CHECK(uncomp_pkts[0][i].len == uncomp_pkts[1][i].len);
+				CHECK(memcmp(rohc_buf_data(uncomp_pkts[0][i]), rohc_buf_data(uncomp_pkts[1][i]),
+				             uncomp_pkts[0][i].len) == 0);
+				CHECK(feedbacks[0][i].len == feedbacks[1][i].len);
+				CHECK(memcmp(rohc_buf_data(feedbacks[0][i]), rohc_buf_data(feedbacks[1][i]),
+				             feedbacks[0][i].len) == 0);
+			}
+
+			rohc_decomp_free(decomp_seq);
+			rohc_decomp_free(decomp_burst);
+#undef BURST_LEN
+		}
+
+		/* rohc_decomp_set_contexts_max_mem() and context eviction */
+		{
+			struct rohc_decomp *decomp_mem;
+			rohc_decomp_general_info_t ginfo;
+			rohc_decomp_context_info_t cinfo;
+			uint8_t buf_cid[sizeof(buf)];
+			struct rohc_buf pkt_cid = rohc_buf_init_full(buf_cid, sizeof(buf_cid), ts);
+			size_t ctxt_mem;
+			size_t max_mem;
+			rohc_cid_t cid;
+
+			decomp_mem = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+			CHECK(decomp_mem != NULL);
+			CHECK(rohc_decomp_enable_profile(decomp_mem, ROHC_PROFILE_IP) == true);
+			memcpy(buf_cid, buf, sizeof(buf));
+
+			CHECK(rohc_decomp_set_contexts_max_mem(NULL, 0) == false);
+			CHECK(rohc_decomp_get_contexts_max_mem(NULL, &max_mem) == false);
+			CHECK(rohc_decomp_get_contexts_max_mem(decomp_mem, NULL) == false);
+			CHECK(rohc_decomp_get_contexts_max_mem(decomp_mem, &max_mem) == true);
+			CHECK(max_mem == 0);
+
+			/* measure the memory used by one context */
+			memset(&ginfo, 0, sizeof(rohc_decomp_general_info_t));
+			ginfo.version_minor = 2;
+			CHECK(rohc_decomp_get_general_info(decomp_mem, &ginfo) == true);
+			CHECK(ginfo.contexts_mem == 0);
+			CHECK(ginfo.evicted_contexts_nr == 0);
+			pkt2 = (struct rohc_buf) rohc_buf_init_empty(buf2, 100);
+			CHECK(rohc_decompress3(decomp_mem, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(rohc_decomp_get_general_info(decomp_mem, &ginfo) == true);
+			ctxt_mem = ginfo.contexts_mem;
+			CHECK(ctxt_mem > 0);
+
+			/* room for 2 contexts only: CIDs 1 and 2 evict CID 0 */
+			CHECK(rohc_decomp_set_contexts_max_mem(decomp_mem, 2 * ctxt_mem) == true);
+			CHECK(rohc_decomp_get_contexts_max_mem(decomp_mem, &max_mem) == true);
+			CHECK(max_mem == (2 * ctxt_mem));
+			{
+				/* CID 2 evicts CID 0, then CID 3 evicts CID 2 since CID 1 was
+				 * used again in between */
+				const rohc_cid_t cids[] = { 1, 2, 1, 3 };
+				const uint8_t crcs[] = { 0xce, 0x5a, 0x27, 0xb3 }; /* IR CRC per CID */
+				size_t i;
+
+				for(i = 0; i < (sizeof(cids) / sizeof(rohc_cid_t)); i++)
+				{
+					buf_cid[1] = cids[i]; /* large CID on one byte */
+					buf_cid[3] = crcs[cids[i]];
+					pkt2 = (struct rohc_buf) rohc_buf_init_empty(buf2, 100);
+					CHECK(rohc_decompress3(decomp_mem, pkt_cid, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+				}
+			}
+			CHECK(rohc_decomp_get_general_info(decomp_mem, &ginfo) == true);
+			CHECK(ginfo.contexts_nr == 2);
+			CHECK(ginfo.contexts_mem == (2 * ctxt_mem));
+			CHECK(ginfo.evicted_contexts_nr == 2);
+
+			/* rohc_decomp_get_memory_usage(): the 2 contexts of the IP-only
+			 * profile, the only profile enabled */
+			{
+				rohc_decomp_memory_usage_t usage;
+
+				memset(&usage, 0, sizeof(rohc_decomp_memory_usage_t));
+				CHECK(rohc_decomp_get_memory_usage(NULL, &usage) == false);
+				CHECK(rohc_decomp_get_memory_usage(decomp_mem, NULL) == false);
+				usage.version_major = 0xffff;
+				CHECK(rohc_decomp_get_memory_usage(decomp_mem, &usage) == false);
+				usage.version_major = 0;
+				usage.version_minor = 0xffff;
+				CHECK(rohc_decomp_get_memory_usage(decomp_mem, &usage) == false);
+				usage.version_minor = 0;
+				CHECK(rohc_decomp_get_memory_usage(decomp_mem, &usage) == true);
+
+				CHECK(usage.profiles_nr == 1);
+				CHECK(usage.profiles[0].profile == ROHC_PROFILE_IP);
+				CHECK(usage.profiles[0].contexts_nr == 2);
+				CHECK((usage.profiles[0].contexts_mem + usage.profiles[0].specific_mem) ==
+				      ginfo.contexts_mem);
+				CHECK(usage.profiles[0].scratch_mem > 0);
+				CHECK(usage.total_mem == (usage.decomp_mem + usage.contexts_mem +
+				                          usage.pool_mem + usage.rru_mem +
+				                          ginfo.contexts_mem + usage.profiles[0].scratch_mem));
+			}
+			for(cid = 0; cid <= 3; cid++)
+			{
+				memset(&cinfo, 0, sizeof(rohc_decomp_context_info_t));
+				CHECK(rohc_decomp_get_context_info(decomp_mem, cid, &cinfo) == true);
+				CHECK((cinfo.packets_nr > 0) == (cid == 1 || cid == 3));
+			}
+
+			/* lower the limit: the least recently used context is evicted at once */
+			CHECK(rohc_decomp_set_contexts_max_mem(decomp_mem, ctxt_mem) == true);
+			CHECK(rohc_decomp_get_general_info(decomp_mem, &ginfo) == true);
+			CHECK(ginfo.contexts_nr == 1);
+			CHECK(ginfo.evicted_contexts_nr == 3);
+			memset(&cinfo, 0, sizeof(rohc_decomp_context_info_t));
+			CHECK(rohc_decomp_get_context_info(decomp_mem, 3, &cinfo) == true);
+			CHECK(cinfo.packets_nr > 0);
+
+			/* no new context may fit in a too small limit */
+			CHECK(rohc_decomp_set_contexts_max_mem(decomp_mem, 1) == true);
+			pkt2 = (struct rohc_buf) rohc_buf_init_empty(buf2, 100);
+			CHECK(rohc_decompress3(decomp_mem, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_NO_CONTEXT);
+			CHECK(rohc_decomp_get_general_info(decomp_mem, &ginfo) == true);
+			CHECK(ginfo.contexts_nr == 0);
+			CHECK(ginfo.contexts_mem == 0);
+
+			/* no limit any more */
+			CHECK(rohc_decomp_set_contexts_max_mem(decomp_mem, 0) == true);
+			pkt2 = (struct rohc_buf) rohc_buf_init_empty(buf2, 100);
+			CHECK(rohc_decompress3(decomp_mem, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+
+			rohc_decomp_free(decomp_mem);
+		}
 	}
 
 	/* rohc_decomp_get_last_packet_info() */
@@ -390,6 +616,8 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
 		info.version_minor = 1;
 		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		info.version_minor = 2;
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
 	}
 
 	/* rohc_decomp_get_state_descr() */
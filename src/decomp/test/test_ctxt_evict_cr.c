@@ -0,0 +1,286 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_ctxt_evict_cr.c
+ * @brief   Test that the base context of an IR-CR packet is never evicted
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Two TCP flows are decompressed with a memory limit that fits two contexts
+ * only. A third TCP flow is then compressed as a replication of the first
+ * flow, the least recently used one: the decompressor shall evict the
+ * second flow to make room for the new context, not the base context that
+ * the IR-CR packet needs. The contexts evicted later are kept for re-use,
+ * their TCP part included.
+ */
+
+#include "test_helpers.h"
+
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** The number of packets of the first flows */
+#define TEST_PKTS_NR  10U
+/** The length of the IPv4/TCP packets */
+#define TEST_IP_LEN  (20U + 20U + 32U)
+/** The max length of the ROHC packets and feedbacks */
+#define TEST_BUF_MAX_LEN  2048U
+
+
+/** One TCP flow */
+struct test_flow
+{
+	uint8_t saddr;      /**< The last byte of the source address */
+	uint8_t daddr;      /**< The last byte of the destination address */
+	uint16_t sport;     /**< The TCP source port */
+	uint16_t dport;     /**< The TCP destination port */
+	size_t pkts_nr;     /**< The number of packets sent on the flow */
+};
+
+
+static void build_ip_pkt(uint8_t *const ip,
+                         struct test_flow *const flow)
+	__attribute__((nonnull(1, 2)));
+
+static bool transmit(struct rohc_comp *const comp,
+                     struct rohc_decomp *const decomp,
+                     struct test_flow *const flow,
+                     uint8_t *const first_rohc_byte,
+                     rohc_status_t *const status)
+	__attribute__((nonnull(1, 2, 3, 4, 5), warn_unused_result));
+
+
+/**
+ * @brief Test that the base context of an IR-CR packet is never evicted
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	struct test_flow base_flow = {
+		.saddr = 1, .daddr = 2, .sport = 1000, .dport = 80, .pkts_nr = 0
+	};
+	struct test_flow other_flow = {
+		.saddr = 3, .daddr = 4, .sport = 2000, .dport = 80, .pkts_nr = 0
+	};
+	struct test_flow replicated_flow = {
+		.saddr = 1, .daddr = 2, .sport = 1001, .dport = 80, .pkts_nr = 0
+	};
+	rohc_decomp_general_info_t info;
+	rohc_decomp_memory_usage_t usage;
+	struct rohc_decomp *decomp = NULL;
+	struct rohc_comp *comp = NULL;
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	uint8_t first_rohc_byte;
+	rohc_status_t status;
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(!test_parse_args(argc, argv, "test that the base context of an IR-CR "
+	                    "packet is never evicted", &verbose))
+	{
+		goto error;
+	}
+
+	comp = rohc_comp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX,
+	                      test_gen_random_num, NULL);
+	CHECK(comp != NULL);
+	CHECK(rohc_comp_enable_profile(comp, ROHCv1_PROFILE_IP_TCP));
+
+	decomp = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	CHECK(decomp != NULL);
+	CHECK(rohc_decomp_enable_profile(decomp, ROHCv1_PROFILE_IP_TCP));
+	/* do not rate-limit ACKs, so that the compressor gets the ACKs that
+	 * establish the contexts in O-mode, as required for Context Replication */
+	CHECK(rohc_decomp_set_rate_limits(decomp, 1, 1, 30, 100, 30, 100));
+
+	/* establish the base flow first, then the other flow, so that the base
+	 * context is the least recently used one */
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		CHECK(transmit(comp, decomp, &base_flow, &first_rohc_byte, &status));
+		CHECK(status == ROHC_STATUS_OK);
+	}
+	for(i = 0; i < TEST_PKTS_NR; i++)
+	{
+		CHECK(transmit(comp, decomp, &other_flow, &first_rohc_byte, &status));
+		CHECK(status == ROHC_STATUS_OK);
+	}
+
+	/* limit the memory to the two contexts in use */
+	info.version_major = 0;
+	info.version_minor = 2;
+	CHECK(rohc_decomp_get_general_info(decomp, &info));
+	trace(verbose, "%zu contexts use %zu bytes\n", info.contexts_nr,
+	      info.contexts_mem);
+	CHECK(info.contexts_nr == 2);
+	CHECK(rohc_decomp_set_contexts_max_mem(decomp, info.contexts_mem));
+	CHECK(rohc_decomp_get_general_info(decomp, &info));
+	CHECK(info.evicted_contexts_nr == 0);
+
+	/* the new flow is replicated from the base flow: the other flow shall be
+	 * evicted to make room for it */
+	CHECK(transmit(comp, decomp, &replicated_flow, &first_rohc_byte, &status));
+	trace(verbose, "first packet of the replicated flow: type 0x%02x, "
+	      "status %d\n", first_rohc_byte, status);
+	CHECK(first_rohc_byte == 0xfc); /* IR-CR */
+	CHECK(status == ROHC_STATUS_OK);
+	CHECK(rohc_decomp_get_general_info(decomp, &info));
+	CHECK(info.contexts_nr == 2);
+	CHECK(info.evicted_contexts_nr == 1);
+
+	/* the base flow and the replicated flow are still decompressed */
+	CHECK(transmit(comp, decomp, &base_flow, &first_rohc_byte, &status));
+	CHECK(status == ROHC_STATUS_OK);
+	CHECK(transmit(comp, decomp, &replicated_flow, &first_rohc_byte, &status));
+	CHECK(status == ROHC_STATUS_OK);
+
+	/* the context of the other flow was evicted */
+	CHECK(transmit(comp, decomp, &other_flow, &first_rohc_byte, &status));
+	trace(verbose, "packet of the evicted flow: status %d\n", status);
+	CHECK(status != ROHC_STATUS_OK);
+
+	/* the TCP context evicted by a lower limit is kept for re-use as a whole,
+	 * its TCP part included */
+	CHECK(rohc_decomp_get_general_info(decomp, &info));
+	CHECK(info.contexts_nr == 2);
+	CHECK(rohc_decomp_set_contexts_max_mem(decomp, info.contexts_mem / 2));
+	memset(&usage, 0, sizeof(rohc_decomp_memory_usage_t));
+	CHECK(rohc_decomp_get_memory_usage(decomp, &usage));
+	trace(verbose, "%zu bytes kept for re-use after eviction\n", usage.pool_mem);
+	CHECK(usage.pool_mem == (info.contexts_mem / 2));
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	rohc_decomp_free(decomp);
+	rohc_comp_free(comp);
+	return is_failure;
+}
+
+
+/**
+ * @brief Compress one packet of the given flow, then decompress it
+ *
+ * The feedback of the decompressor is delivered to the compressor.
+ *
+ * @param comp                  The ROHC compressor
+ * @param decomp                The ROHC decompressor
+ * @param flow                  The flow to send one packet for
+ * @param[out] first_rohc_byte  The type octet of the ROHC packet
+ * @param[out] status           The status of the decompression
+ * @return                      true if the packet was compressed and if it was
+ *                              decompressed as the original one when
+ *                              decompression succeeded, false otherwise
+ */
+static bool transmit(struct rohc_comp *const comp,
+                     struct rohc_decomp *const decomp,
+                     struct test_flow *const flow,
+                     uint8_t *const first_rohc_byte,
+                     rohc_status_t *const status)
+{
+	const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+	uint8_t ip_data[TEST_IP_LEN];
+	const struct rohc_buf ip_pkt = rohc_buf_init_full(ip_data, TEST_IP_LEN, ts);
+	uint8_t rohc_data[TEST_BUF_MAX_LEN];
+	struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_data, TEST_BUF_MAX_LEN);
+	uint8_t uncomp_data[TEST_BUF_MAX_LEN];
+	struct rohc_buf uncomp_pkt =
+		rohc_buf_init_empty(uncomp_data, TEST_BUF_MAX_LEN);
+	uint8_t feedback_data[TEST_BUF_MAX_LEN];
+	struct rohc_buf feedback_send =
+		rohc_buf_init_empty(feedback_data, TEST_BUF_MAX_LEN);
+
+	build_ip_pkt(ip_data, flow);
+	CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+	CHECK(rohc_pkt.len > 0);
+	*first_rohc_byte = rohc_buf_byte(rohc_pkt);
+
+	*status = rohc_decompress3(decomp, rohc_pkt, &uncomp_pkt, NULL,
+	                           &feedback_send);
+	if((*status) == ROHC_STATUS_OK)
+	{
+		CHECK(uncomp_pkt.len == TEST_IP_LEN);
+		CHECK(memcmp(rohc_buf_data(uncomp_pkt), ip_data, TEST_IP_LEN) == 0);
+	}
+	if(feedback_send.len > 0)
+	{
+		CHECK(rohc_comp_deliver_feedback2(comp, feedback_send));
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build the next IPv4/TCP packet of one flow
+ *
+ * @param ip    The buffer for the IPv4/TCP packet
+ * @param flow  The flow to build one packet for
+ */
+static void build_ip_pkt(uint8_t *const ip,
+                         struct test_flow *const flow)
+{
+	const uint16_t ip_id = 1000 + flow->pkts_nr;
+	const uint32_t seq = 0x10000000 + flow->pkts_nr * (TEST_IP_LEN - 40);
+	size_t i;
+
+	memset(ip, 0, TEST_IP_LEN);
+
+	/* IPv4 header */
+	test_build_ipv4_hdr(ip, TEST_IP_LEN, 6, ip_id, 0x0a000000 + flow->saddr,
+	                    0x0a000000 + flow->daddr, true);
+
+	/* TCP header with the ACK flag, the checksum is not checked */
+	ip[20] = (flow->sport >> 8) & 0xff;
+	ip[21] = flow->sport & 0xff;
+	ip[22] = (flow->dport >> 8) & 0xff;
+	ip[23] = flow->dport & 0xff;
+	ip[24] = (seq >> 24) & 0xff;
+	ip[25] = (seq >> 16) & 0xff;
+	ip[26] = (seq >> 8) & 0xff;
+	ip[27] = seq & 0xff;
+	ip[31] = 1;
+	ip[32] = 0x50;
+	ip[33] = 0x10;
+	ip[34] = 0xff;
+	ip[35] = 0xff;
+	ip[36] = flow->pkts_nr & 0xff;
+
+	/* payload */
+	for(i = 40; i < TEST_IP_LEN; i++)
+	{
+		ip[i] = flow->pkts_nr + i;
+	}
+
+	flow->pkts_nr++;
+}
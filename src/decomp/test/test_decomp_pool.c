@@ -0,0 +1,278 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_decomp_pool.c
+ * @brief   Test the pools of ROHC decompressors
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Several flows are compressed on one ROHC channel, the ROHC packets are
+ * dispatched to the workers of one pool of decompressors that run on
+ * different threads. Every flow shall be decompressed in order without
+ * any error, and the feedbacks of all workers shall be delivered to the
+ * compressor.
+ */
+
+#include "test_helpers.h"
+
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+
+
+/** The number of workers in the pool */
+#define TEST_POOL_WORKERS_NR  4U
+/** The number of flows compressed on the ROHC channel, one per CID */
+#define TEST_POOL_FLOWS_NR  (ROHC_SMALL_CID_MAX + 1U)
+/** The number of packets per flow */
+#define TEST_POOL_PKTS_PER_FLOW  50U
+/** The total number of packets */
+#define TEST_POOL_PKTS_NR  (TEST_POOL_FLOWS_NR * TEST_POOL_PKTS_PER_FLOW)
+/** The max length of all the feedbacks generated by the workers */
+#define TEST_POOL_FEEDBACKS_MAX_LEN  4096U
+/** The length of the IPv4/UDP packets */
+#define TEST_POOL_IP_LEN  (20U + 8U + 32U)
+/** The max length of the ROHC packets */
+#define TEST_POOL_ROHC_MAX_LEN  (TEST_POOL_IP_LEN + 100U)
+
+
+/** One IPv4/UDP packet and its compressed version */
+struct test_pkt
+{
+	uint8_t ip[TEST_POOL_IP_LEN];
+	uint8_t rohc[TEST_POOL_ROHC_MAX_LEN];
+	size_t rohc_len;
+};
+
+/** The packets dispatched to one worker */
+struct test_worker
+{
+	struct rohc_decomp_pool *pool;
+	size_t worker_id;
+	const struct test_pkt *pkts;
+	size_t pkt_ids[TEST_POOL_PKTS_NR];
+	size_t pkts_nr;
+	size_t errors_nr;
+	volatile bool is_done;
+};
+
+
+static void * run_worker(void *arg)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Test the pools of ROHC decompressors
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	static struct test_pkt pkts[TEST_POOL_PKTS_NR];
+	static struct test_worker workers[TEST_POOL_WORKERS_NR];
+	pthread_t threads[TEST_POOL_WORKERS_NR];
+	uint8_t feedbacks_data[TEST_POOL_FEEDBACKS_MAX_LEN];
+	struct rohc_buf feedbacks =
+		rohc_buf_init_empty(feedbacks_data, TEST_POOL_FEEDBACKS_MAX_LEN);
+	size_t feedbacks_nr = 0;
+	struct rohc_decomp_pool *pool = NULL;
+	struct rohc_comp *comp = NULL;
+	size_t threads_nr = 0;
+	int is_failure = 1; /* test fails by default */
+	bool workers_done;
+	size_t worker_id;
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(!test_parse_args(argc, argv, "test the pools of ROHC decompressors",
+	                    &verbose))
+	{
+		goto error;
+	}
+
+	/* invalid pools */
+	CHECK(rohc_decomp_pool_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                           ROHC_O_MODE, 0) == NULL);
+	CHECK(rohc_decomp_pool_new(ROHC_SMALL_CID, 3, ROHC_O_MODE, 5) == NULL);
+	CHECK(rohc_decomp_pool_new(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX,
+	                           ROHC_O_MODE, 1000) == NULL);
+	CHECK(rohc_decomp_pool_new(ROHC_SMALL_CID, ROHC_LARGE_CID_MAX,
+	                           ROHC_O_MODE, 1) == NULL);
+	rohc_decomp_pool_free(NULL);
+
+	/* compress all flows on one ROHC channel, packets of flows interleaved */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      test_gen_random_num, NULL);
+	CHECK(comp != NULL);
+	CHECK(rohc_comp_enable_profile(comp, ROHCv1_PROFILE_IP_UDP));
+	for(i = 0; i < TEST_POOL_PKTS_NR; i++)
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const struct rohc_buf ip_pkt =
+			rohc_buf_init_full(pkts[i].ip, TEST_POOL_IP_LEN, ts);
+		struct rohc_buf rohc_pkt =
+			rohc_buf_init_empty(pkts[i].rohc, TEST_POOL_ROHC_MAX_LEN);
+
+		test_build_ipv4_udp_pkt(pkts[i].ip, TEST_POOL_IP_LEN, true,
+		                        i % TEST_POOL_FLOWS_NR, i / TEST_POOL_FLOWS_NR);
+		CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+		pkts[i].rohc_len = rohc_pkt.len;
+	}
+
+	/* create the pool */
+	pool = rohc_decomp_pool_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                            ROHC_O_MODE, TEST_POOL_WORKERS_NR);
+	CHECK(pool != NULL);
+	CHECK(rohc_decomp_pool_get_worker(pool, TEST_POOL_WORKERS_NR) == NULL);
+	for(worker_id = 0; worker_id < TEST_POOL_WORKERS_NR; worker_id++)
+	{
+		struct rohc_decomp *const decomp =
+			rohc_decomp_pool_get_worker(pool, worker_id);
+		CHECK(decomp != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp, ROHCv1_PROFILE_IP_UDP));
+
+		workers[worker_id].pool = pool;
+		workers[worker_id].worker_id = worker_id;
+		workers[worker_id].pkts = pkts;
+		workers[worker_id].pkts_nr = 0;
+		workers[worker_id].errors_nr = 0;
+		workers[worker_id].is_done = false;
+	}
+
+	/* dispatch the ROHC packets to the workers */
+	for(i = 0; i < TEST_POOL_PKTS_NR; i++)
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const struct rohc_buf rohc_pkt =
+			rohc_buf_init_full(pkts[i].rohc, pkts[i].rohc_len, ts);
+		struct test_worker *worker;
+
+		CHECK(rohc_decomp_pool_dispatch(pool, rohc_pkt, &worker_id));
+		CHECK(worker_id < TEST_POOL_WORKERS_NR);
+		/* the CIDs are split in ranges of the same size */
+		CHECK(worker_id == ((i % TEST_POOL_FLOWS_NR) /
+		                    (TEST_POOL_FLOWS_NR / TEST_POOL_WORKERS_NR)));
+		worker = &(workers[worker_id]);
+		worker->pkt_ids[worker->pkts_nr] = i;
+		worker->pkts_nr++;
+	}
+
+	/* run the workers, and collect their feedbacks while they run */
+	for(worker_id = 0; worker_id < TEST_POOL_WORKERS_NR; worker_id++)
+	{
+		CHECK(pthread_create(&threads[worker_id], NULL, run_worker,
+		                     &workers[worker_id]) == 0);
+		threads_nr++;
+	}
+	do
+	{
+		workers_done = true;
+		for(worker_id = 0; worker_id < TEST_POOL_WORKERS_NR; worker_id++)
+		{
+			if(!__atomic_load_n(&workers[worker_id].is_done, __ATOMIC_ACQUIRE))
+			{
+				workers_done = false;
+			}
+		}
+		feedbacks_nr += rohc_decomp_pool_get_feedbacks(pool, &feedbacks);
+	}
+	while(!workers_done);
+	while(threads_nr > 0)
+	{
+		threads_nr--;
+		CHECK(pthread_join(threads[threads_nr], NULL) == 0);
+	}
+	for(worker_id = 0; worker_id < TEST_POOL_WORKERS_NR; worker_id++)
+	{
+		trace(verbose, "worker #%zu: %zu packets, %zu errors\n", worker_id,
+		      workers[worker_id].pkts_nr, workers[worker_id].errors_nr);
+		CHECK(workers[worker_id].pkts_nr == (TEST_POOL_PKTS_NR / TEST_POOL_WORKERS_NR));
+		CHECK(workers[worker_id].errors_nr == 0);
+	}
+	feedbacks_nr += rohc_decomp_pool_get_feedbacks(pool, &feedbacks);
+
+	/* one ACK per flow after its IR packet in O-mode, all of them shall be
+	 * accepted by the compressor */
+	trace(verbose, "%zu feedbacks in %zu bytes\n", feedbacks_nr, feedbacks.len);
+	CHECK(feedbacks_nr >= TEST_POOL_FLOWS_NR);
+	CHECK(rohc_comp_deliver_feedback2(comp, feedbacks));
+
+	/* nothing left */
+	rohc_buf_reset(&feedbacks);
+	CHECK(rohc_decomp_pool_get_feedbacks(pool, &feedbacks) == 0);
+	CHECK(feedbacks.len == 0);
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	/* the workers shall not run any more when the pool is released */
+	while(threads_nr > 0)
+	{
+		threads_nr--;
+		pthread_join(threads[threads_nr], NULL);
+	}
+	rohc_decomp_pool_free(pool);
+	rohc_comp_free(comp);
+	return is_failure;
+}
+
+
+/**
+ * @brief Decompress the packets dispatched to one worker
+ *
+ * @param arg  The worker
+ * @return     NULL
+ */
+static void * run_worker(void *arg)
+{
+	struct test_worker *const worker = arg;
+	size_t i;
+
+	for(i = 0; i < worker->pkts_nr; i++)
+	{
+		const struct test_pkt *const pkt = &(worker->pkts[worker->pkt_ids[i]]);
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const struct rohc_buf rohc_pkt =
+			rohc_buf_init_full((uint8_t *) pkt->rohc, pkt->rohc_len, ts);
+		uint8_t ip_data[TEST_POOL_ROHC_MAX_LEN];
+		struct rohc_buf ip_pkt = rohc_buf_init_empty(ip_data, TEST_POOL_ROHC_MAX_LEN);
+		rohc_status_t status;
+
+		status = rohc_decomp_pool_decompress(worker->pool, worker->worker_id,
+		                                     rohc_pkt, &ip_pkt, NULL);
+		if(status != ROHC_STATUS_OK ||
+		   ip_pkt.len != TEST_POOL_IP_LEN ||
+		   memcmp(rohc_buf_data(ip_pkt), pkt->ip, TEST_POOL_IP_LEN) != 0)
+		{
+			worker->errors_nr++;
+		}
+	}
+	__atomic_store_n(&worker->is_done, true, __ATOMIC_RELEASE);
+
+	return NULL;
+}
@@ -0,0 +1,299 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_downward_transitions.c
+ * @brief   Test the downward state transitions of the ROHC decompressor
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * One IPv4/UDP flow is decompressed in O-mode until its context reaches the
+ * Full Context state. A run of failing packets shall then move the context
+ * down to the Static Context state, then to the No Context state:
+ *  - in FC state, a corrupted UO-0 packet fails the CRC check: NACK(O);
+ *  - in SC state, a valid UO-0 packet cannot be received: NACK(O);
+ *  - in NC state, a valid UO-0 packet cannot be received: STATIC-NACK(O).
+ * The IR packet sent by the compressor upon the STATIC-NACK shall then bring
+ * the context back to the Full Context state.
+ */
+
+#include "test_helpers.h"
+
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** The number of packets to establish the context in FC state */
+#define TEST_INIT_PKTS_NR  10U
+/** The length of the IPv4/UDP packets */
+#define TEST_IP_LEN  (20U + 8U + 32U)
+/** The max length of the ROHC packets and feedbacks */
+#define TEST_BUF_MAX_LEN  2048U
+
+/** The Acktype of FEEDBACK-2 when no feedback was returned */
+#define TEST_NO_FEEDBACK  -1
+
+
+static bool compress(struct rohc_comp *const comp,
+                     const size_t pkt_id,
+                     uint8_t *const ip,
+                     struct rohc_buf *const rohc_pkt)
+	__attribute__((nonnull(1, 3, 4), warn_unused_result));
+
+static bool decompress(struct rohc_decomp *const decomp,
+                       const uint8_t *const ip,
+                       const struct rohc_buf rohc_pkt,
+                       const bool is_corrupted,
+                       rohc_status_t *const status,
+                       struct rohc_buf *const feedback)
+	__attribute__((nonnull(1, 2, 5, 6), warn_unused_result));
+
+static int get_ack_type(const struct rohc_buf feedback)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Test the downward state transitions of the decompressor
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	uint8_t ip[TEST_IP_LEN];
+	uint8_t rohc_data[TEST_BUF_MAX_LEN];
+	struct rohc_buf rohc_pkt = rohc_buf_init_empty(rohc_data, TEST_BUF_MAX_LEN);
+	uint8_t feedback_data[TEST_BUF_MAX_LEN];
+	struct rohc_buf feedback =
+		rohc_buf_init_empty(feedback_data, TEST_BUF_MAX_LEN);
+	rohc_decomp_last_packet_info_t info;
+	struct rohc_decomp *decomp = NULL;
+	struct rohc_comp *comp = NULL;
+	int is_failure = 1; /* test fails by default */
+	rohc_status_t status;
+	size_t pkt_id;
+
+	/* do we run in verbose mode ? */
+	if(!test_parse_args(argc, argv, "test the downward state transitions of "
+	                    "the ROHC decompressor", &verbose))
+	{
+		goto error;
+	}
+
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      test_gen_random_num, NULL);
+	CHECK(comp != NULL);
+	CHECK(rohc_comp_enable_profile(comp, ROHCv1_PROFILE_IP_UDP));
+
+	/* create the decompressor in O-mode, do not rate-limit the feedbacks nor
+	 * the downward state transitions, so that every failure is handled */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	CHECK(decomp != NULL);
+	CHECK(rohc_decomp_enable_profile(decomp, ROHCv1_PROFILE_IP_UDP));
+	CHECK(rohc_decomp_set_rate_limits(decomp, 32, 32, 1, 32, 1, 32));
+
+	/* establish the context in O-mode and FC state, the ACKs of the
+	 * decompressor are delivered to the compressor */
+	for(pkt_id = 0; pkt_id < TEST_INIT_PKTS_NR; pkt_id++)
+	{
+		CHECK(compress(comp, pkt_id, ip, &rohc_pkt));
+		CHECK(decompress(decomp, ip, rohc_pkt, false, &status, &feedback));
+		CHECK(status == ROHC_STATUS_OK);
+		if(feedback.len > 0)
+		{
+			CHECK(get_ack_type(feedback) == 0);
+			CHECK(rohc_comp_deliver_feedback2(comp, feedback));
+		}
+	}
+	memset(&info, 0, sizeof(rohc_decomp_last_packet_info_t));
+	CHECK(rohc_decomp_get_last_packet_info(decomp, &info));
+	trace(verbose, "context in mode %d and state %d\n", info.context_mode,
+	      info.context_state);
+	CHECK(info.context_mode == ROHC_O_MODE);
+	CHECK(info.context_state == ROHC_DECOMP_STATE_FC);
+
+	/* FC state: a corrupted UO-0 packet fails the CRC check, the context goes
+	 * down to the SC state with a NACK */
+	CHECK(compress(comp, pkt_id, ip, &rohc_pkt));
+	pkt_id++;
+	CHECK((rohc_buf_byte(rohc_pkt) & 0x80) == 0); /* UO-0 */
+	CHECK(decompress(decomp, ip, rohc_pkt, true, &status, &feedback));
+	trace(verbose, "corrupted UO-0 packet in FC state: status %d\n", status);
+	CHECK(status == ROHC_STATUS_BAD_CRC);
+	CHECK(get_ack_type(feedback) == 1);
+
+	/* SC state: a valid UO-0 packet carries no 7- or 8-bit CRC, so it cannot be
+	 * received, the context goes down to the NC state with a NACK */
+	CHECK(compress(comp, pkt_id, ip, &rohc_pkt));
+	pkt_id++;
+	CHECK((rohc_buf_byte(rohc_pkt) & 0x80) == 0); /* UO-0 */
+	CHECK(decompress(decomp, ip, rohc_pkt, false, &status, &feedback));
+	trace(verbose, "UO-0 packet in SC state: status %d\n", status);
+	CHECK(status == ROHC_STATUS_MALFORMED);
+	CHECK(get_ack_type(feedback) == 1);
+
+	/* NC state: a valid UO-0 packet carries no static information, so it
+	 * cannot be received, the decompressor asks for a STATIC-NACK */
+	CHECK(compress(comp, pkt_id, ip, &rohc_pkt));
+	pkt_id++;
+	CHECK((rohc_buf_byte(rohc_pkt) & 0x80) == 0); /* UO-0 */
+	CHECK(decompress(decomp, ip, rohc_pkt, false, &status, &feedback));
+	trace(verbose, "UO-0 packet in NC state: status %d\n", status);
+	CHECK(status == ROHC_STATUS_MALFORMED);
+	CHECK(get_ack_type(feedback) == 2);
+
+	/* the compressor answers the STATIC-NACK with an IR packet that brings
+	 * the context back to the FC state */
+	CHECK(rohc_comp_deliver_feedback2(comp, feedback));
+	CHECK(compress(comp, pkt_id, ip, &rohc_pkt));
+	pkt_id++;
+	CHECK(rohc_buf_byte(rohc_pkt) == 0xfd); /* IR */
+	CHECK(decompress(decomp, ip, rohc_pkt, false, &status, &feedback));
+	CHECK(status == ROHC_STATUS_OK);
+	memset(&info, 0, sizeof(rohc_decomp_last_packet_info_t));
+	CHECK(rohc_decomp_get_last_packet_info(decomp, &info));
+	trace(verbose, "context in mode %d and state %d\n", info.context_mode,
+	      info.context_state);
+	CHECK(info.context_state == ROHC_DECOMP_STATE_FC);
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	rohc_decomp_free(decomp);
+	rohc_comp_free(comp);
+	return is_failure;
+}
+
+
+/**
+ * @brief Build and compress one IPv4/UDP packet
+ *
+ * @param comp          The ROHC compressor
+ * @param pkt_id        The ID of the packet in the flow
+ * @param ip            The buffer for the IPv4/UDP packet
+ * @param[out] rohc_pkt The compressed packet
+ * @return              true if the packet was successfully compressed,
+ *                      false otherwise
+ */
+static bool compress(struct rohc_comp *const comp,
+                     const size_t pkt_id,
+                     uint8_t *const ip,
+                     struct rohc_buf *const rohc_pkt)
+{
+	const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+	const struct rohc_buf ip_pkt = rohc_buf_init_full(ip, TEST_IP_LEN, ts);
+
+	test_build_ipv4_udp_pkt(ip, TEST_IP_LEN, true, 0, pkt_id);
+	rohc_buf_reset(rohc_pkt);
+
+	return !!(rohc_compress4(comp, ip_pkt, rohc_pkt) == ROHC_STATUS_OK);
+}
+
+
+/**
+ * @brief Decompress one ROHC packet
+ *
+ * @param decomp        The ROHC decompressor
+ * @param ip            The original IPv4/UDP packet
+ * @param rohc_pkt      The packet to decompress
+ * @param is_corrupted  Whether to corrupt the CRC of the UO-0 packet or not
+ * @param[out] status   The status of the decompression
+ * @param[out] feedback The feedback returned by the decompressor
+ * @return              true if the decompressed packet is the original one
+ *                      or if decompression failed, false otherwise
+ */
+static bool decompress(struct rohc_decomp *const decomp,
+                       const uint8_t *const ip,
+                       const struct rohc_buf rohc_pkt,
+                       const bool is_corrupted,
+                       rohc_status_t *const status,
+                       struct rohc_buf *const feedback)
+{
+	uint8_t ip_data[TEST_BUF_MAX_LEN];
+	struct rohc_buf ip_pkt = rohc_buf_init_empty(ip_data, TEST_BUF_MAX_LEN);
+
+	if(is_corrupted)
+	{
+		/* the CRC bits are in the first byte of UO-0 packets for CID 0 */
+		rohc_buf_byte(rohc_pkt) ^= 0x07;
+	}
+
+	rohc_buf_reset(feedback);
+	*status = rohc_decompress3(decomp, rohc_pkt, &ip_pkt, NULL, feedback);
+	if(is_corrupted)
+	{
+		rohc_buf_byte(rohc_pkt) ^= 0x07;
+	}
+	if((*status) == ROHC_STATUS_OK)
+	{
+		CHECK(ip_pkt.len == TEST_IP_LEN);
+		CHECK(memcmp(rohc_buf_data(ip_pkt), ip, TEST_IP_LEN) == 0);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the Acktype of the feedback returned for CID 0
+ *
+ * @param feedback  The feedback returned by the decompressor
+ * @return          The Acktype of the feedback (FEEDBACK-1 is an ACK),
+ *                  TEST_NO_FEEDBACK if no feedback was returned
+ */
+static int get_ack_type(const struct rohc_buf feedback)
+{
+	size_t hdr_len;
+	size_t data_len;
+
+	if(feedback.len < 2 || (rohc_buf_byte(feedback) & 0xf8) != 0xf0)
+	{
+		return TEST_NO_FEEDBACK;
+	}
+	if((rohc_buf_byte(feedback) & 0x07) != 0)
+	{
+		hdr_len = 1;
+		data_len = rohc_buf_byte(feedback) & 0x07;
+	}
+	else
+	{
+		hdr_len = 2;
+		data_len = rohc_buf_byte_at(feedback, 1);
+	}
+	if(data_len == 0 || feedback.len != (hdr_len + data_len))
+	{
+		return TEST_NO_FEEDBACK;
+	}
+	else if(data_len == 1)
+	{
+		return 0;
+	}
+
+	return (rohc_buf_byte_at(feedback, hdr_len) >> 6);
+}
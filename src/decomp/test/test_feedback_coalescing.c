@@ -0,0 +1,309 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_feedback_coalescing.c
+ * @brief   Test the coalescing of feedbacks by the ROHC decompressor
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Several flows are compressed on one ROHC channel and decompressed in
+ * O-mode with the feedbacks coalesced: the decompressor shall keep one
+ * feedback per context, never replace a negative feedback by an ACK, and
+ * flush all feedbacks in one block accepted by the compressor.
+ */
+
+#include "test_helpers.h"
+
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** The number of flows compressed on the ROHC channel, one per CID */
+#define TEST_FLOWS_NR  (ROHC_SMALL_CID_MAX + 1U)
+/** The number of packets per flow */
+#define TEST_PKTS_PER_FLOW  20U
+/** The length of the IPv4/UDP packets */
+#define TEST_IP_LEN  (20U + 8U + 32U)
+/** The max length of the ROHC packets and feedbacks */
+#define TEST_BUF_MAX_LEN  2048U
+
+
+/** One IPv4/UDP packet and its compressed version */
+struct test_pkt
+{
+	uint8_t ip[TEST_IP_LEN];
+	uint8_t rohc[TEST_BUF_MAX_LEN];
+	size_t rohc_len;
+};
+
+
+static bool decompress(struct rohc_decomp *const decomp,
+                       const struct test_pkt *const pkt,
+                       const bool is_corrupted,
+                       rohc_status_t *const status)
+	__attribute__((nonnull(1, 2, 4), warn_unused_result));
+
+static bool count_feedbacks(const bool verbose,
+                            const struct rohc_buf feedbacks,
+                            size_t *const feedbacks_nr,
+                            size_t *const nacks_nr)
+	__attribute__((nonnull(3, 4), warn_unused_result));
+
+
+/**
+ * @brief Test the coalescing of feedbacks
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	static struct test_pkt pkts[TEST_FLOWS_NR][TEST_PKTS_PER_FLOW];
+	uint8_t feedbacks_data[TEST_BUF_MAX_LEN];
+	struct rohc_buf feedbacks =
+		rohc_buf_init_empty(feedbacks_data, TEST_BUF_MAX_LEN);
+	struct rohc_decomp *decomp = NULL;
+	struct rohc_comp *comp = NULL;
+	int is_failure = 1; /* test fails by default */
+	rohc_status_t status;
+	size_t feedbacks_nr;
+	size_t counted_nr;
+	size_t nacks_nr;
+	size_t flow_id;
+	size_t pkt_id;
+
+	/* do we run in verbose mode ? */
+	if(!test_parse_args(argc, argv, "test the coalescing of feedbacks by the "
+	                    "ROHC decompressor", &verbose))
+	{
+		goto error;
+	}
+
+	/* compress all flows on one ROHC channel, packets of flows interleaved */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      test_gen_random_num, NULL);
+	CHECK(comp != NULL);
+	CHECK(rohc_comp_enable_profile(comp, ROHCv1_PROFILE_IP_UDP));
+	for(pkt_id = 0; pkt_id < TEST_PKTS_PER_FLOW; pkt_id++)
+	{
+		for(flow_id = 0; flow_id < TEST_FLOWS_NR; flow_id++)
+		{
+			struct test_pkt *const pkt = &(pkts[flow_id][pkt_id]);
+			const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+			const struct rohc_buf ip_pkt =
+				rohc_buf_init_full(pkt->ip, TEST_IP_LEN, ts);
+			struct rohc_buf rohc_pkt =
+				rohc_buf_init_empty(pkt->rohc, TEST_BUF_MAX_LEN);
+
+			test_build_ipv4_udp_pkt(pkt->ip, TEST_IP_LEN, true, flow_id,
+			                        pkt_id);
+			CHECK(rohc_compress4(comp, ip_pkt, &rohc_pkt) == ROHC_STATUS_OK);
+			pkt->rohc_len = rohc_pkt.len;
+		}
+	}
+
+	/* create the decompressor in O-mode with feedbacks coalesced */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+	CHECK(decomp != NULL);
+	CHECK(rohc_decomp_enable_profile(decomp, ROHCv1_PROFILE_IP_UDP));
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK));
+	/* do not rate-limit ACKs, so that every IR packet is acknowledged */
+	CHECK(rohc_decomp_set_rate_limits(decomp, 1, 1, 30, 100, 30, 100));
+
+	/* invalid parameters */
+	CHECK(rohc_decomp_flush_feedback(NULL, &feedbacks) == 0);
+	CHECK(rohc_decomp_flush_feedback(decomp, NULL) == 0);
+	CHECK(rohc_decomp_flush_feedback(decomp, &feedbacks) == 0);
+	CHECK(feedbacks.len == 0);
+
+	/* the IR packets of all flows, twice: one feedback per context */
+	for(pkt_id = 0; pkt_id < 2; pkt_id++)
+	{
+		for(flow_id = 0; flow_id < TEST_FLOWS_NR; flow_id++)
+		{
+			CHECK(decompress(decomp, &pkts[flow_id][pkt_id], false, &status));
+			CHECK(status == ROHC_STATUS_OK);
+		}
+	}
+
+	/* flush in a buffer too small for all feedbacks, then the others */
+	feedbacks.max_len = 8;
+	feedbacks_nr = rohc_decomp_flush_feedback(decomp, &feedbacks);
+	trace(verbose, "%zu feedbacks flushed in %zu bytes\n", feedbacks_nr,
+	      feedbacks.len);
+	CHECK(feedbacks_nr > 0 && feedbacks_nr < TEST_FLOWS_NR);
+	CHECK(count_feedbacks(verbose, feedbacks, &counted_nr, &nacks_nr));
+	CHECK(counted_nr == feedbacks_nr);
+	feedbacks.max_len = TEST_BUF_MAX_LEN;
+	feedbacks_nr += rohc_decomp_flush_feedback(decomp, &feedbacks);
+	trace(verbose, "%zu feedbacks flushed in %zu bytes\n", feedbacks_nr,
+	      feedbacks.len);
+	CHECK(feedbacks_nr == TEST_FLOWS_NR);
+	CHECK(count_feedbacks(verbose, feedbacks, &counted_nr, &nacks_nr));
+	CHECK(counted_nr == TEST_FLOWS_NR);
+	CHECK(nacks_nr == 0);
+	CHECK(rohc_comp_deliver_feedback2(comp, feedbacks));
+	rohc_buf_reset(&feedbacks);
+	CHECK(rohc_decomp_flush_feedback(decomp, &feedbacks) == 0);
+
+	/* packets of the first flow are corrupted: one negative feedback for the
+	 * flow, that the ACKs of the next IR packets shall not replace */
+	for(pkt_id = 2; pkt_id < (TEST_PKTS_PER_FLOW - 1); pkt_id++)
+	{
+		CHECK(decompress(decomp, &pkts[0][pkt_id], true, &status));
+		trace(verbose, "corrupted packet #%zu: status %d\n", pkt_id, status);
+	}
+	CHECK(decompress(decomp, &pkts[0][0], false, &status));
+	CHECK(status == ROHC_STATUS_OK);
+	CHECK(decompress(decomp, &pkts[0][1], false, &status));
+	CHECK(status == ROHC_STATUS_OK);
+	feedbacks_nr = rohc_decomp_flush_feedback(decomp, &feedbacks);
+	trace(verbose, "%zu feedbacks flushed in %zu bytes\n", feedbacks_nr,
+	      feedbacks.len);
+	CHECK(feedbacks_nr == 1);
+	CHECK(count_feedbacks(verbose, feedbacks, &counted_nr, &nacks_nr));
+	CHECK(counted_nr == 1);
+	CHECK(nacks_nr == 1);
+	CHECK(rohc_comp_deliver_feedback2(comp, feedbacks));
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	rohc_decomp_free(decomp);
+	rohc_comp_free(comp);
+	return is_failure;
+}
+
+
+/**
+ * @brief Decompress one ROHC packet, without returning feedback
+ *
+ * @param decomp        The ROHC decompressor
+ * @param pkt           The packet to decompress
+ * @param is_corrupted  Whether to corrupt the ROHC header or not
+ * @param[out] status   The status of the decompression
+ * @return              true if the decompressed packet is the original one
+ *                      and no feedback was returned, false otherwise
+ */
+static bool decompress(struct rohc_decomp *const decomp,
+                       const struct test_pkt *const pkt,
+                       const bool is_corrupted,
+                       rohc_status_t *const status)
+{
+	const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+	uint8_t rohc_data[TEST_BUF_MAX_LEN];
+	const struct rohc_buf rohc_pkt =
+		rohc_buf_init_full(rohc_data, pkt->rohc_len, ts);
+	uint8_t ip_data[TEST_BUF_MAX_LEN];
+	struct rohc_buf ip_pkt = rohc_buf_init_empty(ip_data, TEST_BUF_MAX_LEN);
+	uint8_t feedback_data[TEST_BUF_MAX_LEN];
+	struct rohc_buf feedback_send =
+		rohc_buf_init_empty(feedback_data, TEST_BUF_MAX_LEN);
+
+	memcpy(rohc_data, pkt->rohc, pkt->rohc_len);
+	if(is_corrupted)
+	{
+		/* the CRC bits are in the first byte of UO-0 packets for CID 0 */
+		rohc_data[0] ^= 0x07;
+	}
+
+	*status = rohc_decompress3(decomp, rohc_pkt, &ip_pkt, NULL, &feedback_send);
+	if((*status) == ROHC_STATUS_OK)
+	{
+		CHECK(ip_pkt.len == TEST_IP_LEN);
+		CHECK(memcmp(rohc_buf_data(ip_pkt), pkt->ip, TEST_IP_LEN) == 0);
+	}
+
+	/* feedbacks are coalesced */
+	CHECK(feedback_send.len == 0);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Count the feedbacks of one feedback block
+ *
+ * @param verbose            Whether to run in verbose mode or not
+ * @param feedbacks          The feedback block
+ * @param[out] feedbacks_nr  The number of feedbacks
+ * @param[out] nacks_nr      The number of negative feedbacks
+ * @return                   true if the feedback block is well-formed,
+ *                           false otherwise
+ */
+static bool count_feedbacks(const bool verbose,
+                            const struct rohc_buf feedbacks,
+                            size_t *const feedbacks_nr,
+                            size_t *const nacks_nr)
+{
+	size_t pos = 0;
+
+	*feedbacks_nr = 0;
+	*nacks_nr = 0;
+	while(pos < feedbacks.len)
+	{
+		const uint8_t code = rohc_buf_byte_at(feedbacks, pos) & 0x07;
+		size_t hdr_len;
+		size_t data_len;
+		size_t cid_len;
+
+		CHECK((rohc_buf_byte_at(feedbacks, pos) & 0xf8) == 0xf0);
+		if(code != 0)
+		{
+			hdr_len = 1;
+			data_len = code;
+		}
+		else
+		{
+			CHECK((pos + 1) < feedbacks.len);
+			hdr_len = 2;
+			data_len = rohc_buf_byte_at(feedbacks, pos + 1);
+		}
+		CHECK((pos + hdr_len + data_len) <= feedbacks.len);
+
+		/* skip the Add-CID octet, then FEEDBACK-2 starts with Acktype */
+		cid_len = ((rohc_buf_byte_at(feedbacks, pos + hdr_len) & 0xf0) == 0xe0);
+		if((data_len - cid_len) > 1 &&
+		   (rohc_buf_byte_at(feedbacks, pos + hdr_len + cid_len) >> 6) != 0)
+		{
+			(*nacks_nr)++;
+		}
+		trace(verbose, "\tfeedback #%zu: %zu bytes\n", (*feedbacks_nr) + 1,
+		      hdr_len + data_len);
+
+		pos += hdr_len + data_len;
+		(*feedbacks_nr)++;
+	}
+
+	return true;
+
+error:
+	return false;
+}
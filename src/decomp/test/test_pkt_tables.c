@@ -0,0 +1,371 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_pkt_tables.c
+ * @brief   Check the lookup tables that classify ROHC packets
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The lookup tables are checked against the bit-by-bit discriminators for
+ * all 256 values of the first byte.
+ */
+
+#include "rohc_decomp_detect_packet.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Check the given condition, trace it and fail the test if it is false */
+#define CHECK(condition) \
+	do { \
+		if(!(condition)) { \
+			printf("%s:%d: check '%s' failed\n", __FILE__, __LINE__, \
+			       #condition); \
+			goto error; \
+		} \
+	} while(0)
+
+
+static rohc_packet_t ref_rfc3095_type(const uint8_t byte)
+	__attribute__((warn_unused_result, const));
+static rohc_packet_t ref_tcp_type(const uint8_t byte, const bool is_ip_id_seq)
+	__attribute__((warn_unused_result, const));
+static rohc_packet_t ref_rfc5225_type(const uint8_t byte)
+	__attribute__((warn_unused_result, const));
+
+
+/**
+ * @brief Check the lookup tables that classify ROHC packets
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	unsigned int i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("check the lookup tables that classify ROHC packets\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	for(i = 0; i <= 0xff; i++)
+	{
+		/* the buffer is large enough for the largest base header */
+		uint8_t pkt[10] = { 0 };
+		const size_t pkt_len = sizeof(pkt);
+		rohc_packet_t rfc3095_type;
+		rohc_packet_t type;
+
+		pkt[0] = i;
+		trace(verbose, "first byte 0x%02x\n", i);
+
+		/* RFC 3095, IP-only, UDP and ESP profiles */
+		rfc3095_type = ref_rfc3095_type(pkt[0]);
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RFC3095,
+		                                       pkt, pkt_len, 0);
+		CHECK(type == rfc3095_type);
+		CHECK((type == ROHC_PACKET_UO_0) == rohc_decomp_packet_is_uo0(pkt, pkt_len));
+		CHECK((type == ROHC_PACKET_UO_1) == rohc_decomp_packet_is_uo1(pkt, pkt_len));
+		CHECK((type == ROHC_PACKET_UOR_2) == rohc_decomp_packet_is_uor2(pkt, pkt_len));
+		CHECK((type == ROHC_PACKET_IR_DYN) == rohc_decomp_packet_is_irdyn(pkt, pkt_len));
+		CHECK((type == ROHC_PACKET_IR) == rohc_decomp_packet_is_ir(pkt, pkt_len));
+
+		/* RFC 3095, RTP profile without IPv4 header with context(RND) = 0 */
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RTP,
+		                                       pkt, pkt_len, 0);
+		if(rfc3095_type == ROHC_PACKET_UO_1)
+		{
+			CHECK(type == ROHC_PACKET_UO_1_RTP);
+		}
+		else if(rfc3095_type == ROHC_PACKET_UOR_2)
+		{
+			CHECK(type == ROHC_PACKET_UOR_2_RTP);
+		}
+		else
+		{
+			CHECK(type == rfc3095_type);
+		}
+
+		/* RFC 3095, RTP profile with one IPv4 header with context(RND) = 0 */
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RTP_IPV4_ID,
+		                                       pkt, pkt_len, 0);
+		if(rfc3095_type == ROHC_PACKET_UO_1)
+		{
+			if(rohc_decomp_packet_is_uo1_ts(pkt, pkt_len))
+			{
+				CHECK(type == ROHC_PACKET_UO_1_TS);
+			}
+			else
+			{
+				CHECK(type == ROHC_PACKET_UO_1_ID);
+			}
+		}
+		else if(rfc3095_type == ROHC_PACKET_UOR_2)
+		{
+			CHECK(type == ROHC_PACKET_UOR_2_ID);
+		}
+		else
+		{
+			CHECK(type == rfc3095_type);
+		}
+
+		/* RFC 6846, TCP profile */
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_TCP_SEQ,
+		                                       pkt, pkt_len, 0);
+		CHECK(type == ref_tcp_type(pkt[0], true));
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_TCP_RND,
+		                                       pkt, pkt_len, 0);
+		CHECK(type == ref_tcp_type(pkt[0], false));
+
+		/* RFC 5225, ROHCv2 profiles */
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RFC5225,
+		                                       pkt, pkt_len, 0);
+		CHECK(type == ref_rfc5225_type(pkt[0]));
+	}
+
+	/* packets shorter than their base header are rejected */
+	{
+		uint8_t pkt[10] = { 0 };
+		rohc_packet_t type;
+
+		/* UO-0 packet: 1 byte + large CID */
+		pkt[0] = 0x00;
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RFC3095,
+		                                       pkt, 1, 0);
+		CHECK(type == ROHC_PACKET_UO_0);
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RFC3095,
+		                                       pkt, 1, 1);
+		CHECK(type == ROHC_PACKET_UNKNOWN);
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RFC3095,
+		                                       pkt, 3, 2);
+		CHECK(type == ROHC_PACKET_UO_0);
+
+		/* UOR-2-RTP packet: 3 bytes */
+		pkt[0] = 0xc0;
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RTP,
+		                                       pkt, 2, 0);
+		CHECK(type == ROHC_PACKET_UNKNOWN);
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RTP,
+		                                       pkt, 3, 0);
+		CHECK(type == ROHC_PACKET_UOR_2_RTP);
+
+		/* TCP co_common packet: 5 bytes */
+		pkt[0] = 0xfa;
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_TCP_RND,
+		                                       pkt, 4, 0);
+		CHECK(type == ROHC_PACKET_UNKNOWN);
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_TCP_RND,
+		                                       pkt, 5, 0);
+		CHECK(type == ROHC_PACKET_TCP_CO_COMMON);
+
+		/* TCP seq_8 packet: 7 bytes */
+		pkt[0] = 0xb0;
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_TCP_SEQ,
+		                                       pkt, 6, 0);
+		CHECK(type == ROHC_PACKET_UNKNOWN);
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_TCP_SEQ,
+		                                       pkt, 7, 0);
+		CHECK(type == ROHC_PACKET_TCP_SEQ_8);
+
+		/* ROHCv2 IR packet: 3 bytes */
+		pkt[0] = 0xfd;
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RFC5225,
+		                                       pkt, 2, 0);
+		CHECK(type == ROHC_PACKET_UNKNOWN);
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RFC5225,
+		                                       pkt, 3, 0);
+		CHECK(type == ROHC_PACKET_IR);
+
+		/* empty packet */
+		type = rohc_decomp_pkt_type_from_table(ROHC_DECOMP_PKT_TABLE_RFC5225,
+		                                       pkt, 0, 0);
+		CHECK(type == ROHC_PACKET_UNKNOWN);
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief The reference classification for the RFC 3095 profiles
+ *
+ * @param byte  The first byte of the ROHC packet
+ * @return      The type of the ROHC packet
+ */
+static rohc_packet_t ref_rfc3095_type(const uint8_t byte)
+{
+	if((byte & 0x80) == 0x00)
+	{
+		return ROHC_PACKET_UO_0;
+	}
+	else if((byte & 0xc0) == 0x80)
+	{
+		return ROHC_PACKET_UO_1;
+	}
+	else if((byte & 0xe0) == 0xc0)
+	{
+		return ROHC_PACKET_UOR_2;
+	}
+	else if(byte == 0xf8)
+	{
+		return ROHC_PACKET_IR_DYN;
+	}
+	else if((byte & 0xfe) == 0xfc)
+	{
+		return ROHC_PACKET_IR;
+	}
+	return ROHC_PACKET_UNKNOWN;
+}
+
+
+/**
+ * @brief The reference classification for the TCP profile
+ *
+ * @param byte          The first byte of the ROHC packet
+ * @param is_ip_id_seq  Whether the innermost IP-ID is sequential or not
+ * @return              The type of the ROHC packet
+ */
+static rohc_packet_t ref_tcp_type(const uint8_t byte, const bool is_ip_id_seq)
+{
+	if(byte == 0xfd)
+	{
+		return ROHC_PACKET_IR;
+	}
+	else if(byte == 0xfc)
+	{
+		return ROHC_PACKET_IR_CR;
+	}
+	else if(byte == 0xf8)
+	{
+		return ROHC_PACKET_IR_DYN;
+	}
+	else if((byte & 0x80) == 0x00)
+	{
+		return (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_4 : ROHC_PACKET_TCP_RND_3);
+	}
+
+	switch(byte & 0xf0)
+	{
+		case 0x80:
+			return (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_5 : ROHC_PACKET_TCP_RND_5);
+		case 0x90:
+			return (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_3 : ROHC_PACKET_TCP_RND_5);
+		case 0xa0:
+			return (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_1 : ROHC_PACKET_TCP_RND_6);
+		case 0xb0:
+			if(is_ip_id_seq)
+			{
+				return ROHC_PACKET_TCP_SEQ_8;
+			}
+			else if(byte & 0x08)
+			{
+				return ((byte & 0x04) ? ROHC_PACKET_TCP_RND_7 : ROHC_PACKET_TCP_RND_1);
+			}
+			return ROHC_PACKET_TCP_RND_8;
+		case 0xc0:
+			return (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_7 : ROHC_PACKET_TCP_RND_2);
+		case 0xd0:
+			if(is_ip_id_seq)
+			{
+				return ((byte & 0x08) ? ROHC_PACKET_TCP_SEQ_6 : ROHC_PACKET_TCP_SEQ_2);
+			}
+			return ROHC_PACKET_TCP_RND_4;
+		case 0xf0:
+			if((byte & 0xfe) == 0xfa)
+			{
+				return ROHC_PACKET_TCP_CO_COMMON;
+			}
+			return ROHC_PACKET_UNKNOWN;
+		default:
+			return ROHC_PACKET_UNKNOWN;
+	}
+}
+
+
+/**
+ * @brief The reference classification for the ROHCv2 profiles
+ *
+ * @param byte  The first byte of the ROHC packet
+ * @return      The type of the ROHC packet
+ */
+static rohc_packet_t ref_rfc5225_type(const uint8_t byte)
+{
+	if((byte & 0x80) == 0x00)
+	{
+		return ROHC_PACKET_PT_0_CRC3;
+	}
+	else if((byte & 0xe0) == 0x80)
+	{
+		return ROHC_PACKET_NORTP_PT_0_CRC7;
+	}
+	else if((byte & 0xe0) == 0xa0)
+	{
+		return ROHC_PACKET_NORTP_PT_1_SEQ_ID;
+	}
+	else if((byte & 0xe0) == 0xc0)
+	{
+		return ROHC_PACKET_NORTP_PT_2_SEQ_ID;
+	}
+	else if(byte == 0xfa)
+	{
+		return ROHC_PACKET_CO_COMMON;
+	}
+	else if(byte == 0xfb)
+	{
+		return ROHC_PACKET_CO_REPAIR;
+	}
+	else if(byte == 0xfd)
+	{
+		return ROHC_PACKET_IR;
+	}
+	return ROHC_PACKET_UNKNOWN;
+}
+
@@ -0,0 +1,1082 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    bench_schemes.c
+ * @brief   Measure the cost of the encoding and decoding schemes
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Every benchmark calls one building block of the library in a loop. The
+ * number of calls per repetition is calibrated so that one repetition lasts
+ * long enough to be timed accurately. After some warm-up repetitions, the
+ * time (and the number of CPU cycles on x86) per call is recorded for every
+ * repetition. The median and the 99th percentile are printed in JSON format,
+ * so that the results of several commits may be compared by scripts.
+ *
+ * Run it with 'make bench'.
+ */
+
+#include "schemes/comp_wlsb.h"
+#include "schemes/decomp_wlsb.h"
+#include "schemes/comp_list_ipv6.h"
+#include "schemes/tcp_ts.h"
+#include "schemes/tcp_sack.h"
+#include "rohc_comp_internals.h"
+#include "crc.h"
+#include "sdvl.h"
+#include "hashtable.h"
+#include "csiphash.h"
+#include "rohc_fingerprint.h"
+
+#include "config.h" /* for PACKAGE_VERSION */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+
+
+/** The default number of measured repetitions per benchmark */
+#define BENCH_REPS_NR  101U
+
+/** The default number of warm-up repetitions per benchmark */
+#define BENCH_WARMUP_NR  10U
+
+/** The minimal duration (in nanoseconds) of one repetition */
+#define BENCH_REP_MIN_NS  100000U
+
+/** The maximal number of calls in one repetition */
+#define BENCH_REP_MAX_CALLS  (1U << 24)
+
+/** The number of pre-computed inputs, values are cycled through */
+#define BENCH_INPUTS_NR  256U
+
+/** The number of entries in the hash table */
+#define BENCH_HASHTABLE_SIZE  1024U
+
+/** The width of the W-LSB windows */
+#define BENCH_WLSB_WIDTH  4U
+
+/** The length of the headers the CRC-3/7/8 are computed on */
+#define BENCH_CRC_HDR_LEN  40U
+
+/** The length of the largest buffer the FCS-32 is computed on */
+#define BENCH_FCS32_MAX_LEN  1500U
+
+
+/** One element stored in the hash table */
+struct bench_ht_elem
+{
+	struct bench_ht_elem *prev;
+	struct bench_ht_elem *next;
+	struct bench_ht_elem *prev_cr;
+	struct bench_ht_elem *next_cr;
+	struct rohc_fingerprint fingerprint;
+};
+
+
+/** The inputs of all the benchmarks */
+struct bench_state
+{
+	/* W-LSB encoding and decoding */
+	struct c_wlsb wlsb8;
+	struct c_wlsb wlsb16;
+	struct c_wlsb wlsb32;
+	struct c_wlsb wlsb_ack;
+	uint32_t wlsb_sn;
+	struct rohc_lsb_decode lsb16;
+	uint16_t values16[BENCH_INPUTS_NR];
+
+	/* CRCs */
+	uint8_t data[BENCH_FCS32_MAX_LEN];
+
+	/* SDVL */
+	uint32_t sdvl_values[BENCH_INPUTS_NR];
+	uint8_t sdvl_encoded[BENCH_INPUTS_NR][4];
+
+	/* hash table */
+	struct hashtable hashtable;
+	struct bench_ht_elem ht_elems[BENCH_HASHTABLE_SIZE];
+	struct rohc_fingerprint ht_misses[BENCH_INPUTS_NR];
+
+	/* list compression */
+	struct list_comp list_comp;
+	struct rohc_list list_type0;
+	struct rohc_list list_type1;
+
+	/* TCP options */
+	struct rohc_comp comp;
+	struct rohc_comp_ctxt ctxt;
+	sack_block_t sack_blocks[TCP_SACK_BLOCKS_MAX_NR];
+
+	/* the output buffer for encoding schemes */
+	uint8_t out[4096];
+};
+
+
+/** The function that runs one benchmark for the given number of calls */
+typedef uint64_t (*bench_run_t)(struct bench_state *const state,
+                                const size_t calls_nr)
+	__attribute__((nonnull(1)));
+
+
+/** One benchmark */
+struct bench_case
+{
+	const char *name;   /**< The name of the benchmark */
+	bench_run_t run;    /**< The function that runs the benchmark */
+};
+
+
+/** The measures for one repetition */
+struct bench_measure
+{
+	double ns;          /**< The nanoseconds per call */
+	double cycles;      /**< The CPU cycles per call */
+};
+
+
+static bool bench_init(struct bench_state *const state)
+	__attribute__((nonnull(1), warn_unused_result));
+static void bench_free(struct bench_state *const state)
+	__attribute__((nonnull(1)));
+
+static void bench_case_run(struct bench_state *const state,
+                           const struct bench_case *const bench,
+                           const size_t warmup_nr,
+                           const size_t reps_nr,
+                           struct bench_measure *const measures,
+                           const bool is_first)
+	__attribute__((nonnull(1, 2, 5)));
+static int bench_measure_cmp_ns(const void *const m1, const void *const m2)
+	__attribute__((nonnull(1, 2), warn_unused_result, pure));
+static int bench_measure_cmp_cycles(const void *const m1, const void *const m2)
+	__attribute__((nonnull(1, 2), warn_unused_result, pure));
+
+static uint64_t bench_now_ns(void)
+	__attribute__((warn_unused_result));
+static uint64_t bench_now_cycles(void)
+	__attribute__((warn_unused_result));
+
+static uint64_t bench_wlsb_kp_8bits(struct bench_state *const state,
+                                    const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_wlsb_kp_16bits(struct bench_state *const state,
+                                     const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_wlsb_kp_32bits(struct bench_state *const state,
+                                     const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_wlsb_add_ack(struct bench_state *const state,
+                                   const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_lsb_decode(struct bench_state *const state,
+                                 const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_crc3(struct bench_state *const state,
+                           const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_crc7(struct bench_state *const state,
+                           const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_crc8(struct bench_state *const state,
+                           const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_fcs32_64(struct bench_state *const state,
+                               const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_fcs32_1500(struct bench_state *const state,
+                                 const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_sdvl_encode(struct bench_state *const state,
+                                  const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_sdvl_decode(struct bench_state *const state,
+                                  const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_hashtable_hit(struct bench_state *const state,
+                                    const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_hashtable_miss(struct bench_state *const state,
+                                     const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_siphash24(struct bench_state *const state,
+                                const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_list_type0(struct bench_state *const state,
+                                 const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_list_type1(struct bench_state *const state,
+                                 const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_tcp_ts(struct bench_state *const state,
+                             const size_t calls_nr)
+	__attribute__((nonnull(1)));
+static uint64_t bench_tcp_sack(struct bench_state *const state,
+                               const size_t calls_nr)
+	__attribute__((nonnull(1)));
+
+
+/** All the benchmarks */
+static const struct bench_case bench_cases[] =
+{
+	{ "wlsb_is_kp_possible_8bits",  bench_wlsb_kp_8bits },
+	{ "wlsb_is_kp_possible_16bits", bench_wlsb_kp_16bits },
+	{ "wlsb_is_kp_possible_32bits", bench_wlsb_kp_32bits },
+	{ "c_add_wlsb+wlsb_ack",        bench_wlsb_add_ack },
+	{ "rohc_lsb_decode",            bench_lsb_decode },
+	{ "crc_calculate_crc3_40B",     bench_crc3 },
+	{ "crc_calculate_crc7_40B",     bench_crc7 },
+	{ "crc_calculate_crc8_40B",     bench_crc8 },
+	{ "crc_calc_fcs32_64B",         bench_fcs32_64 },
+	{ "crc_calc_fcs32_1500B",       bench_fcs32_1500 },
+	{ "sdvl_encode_full",           bench_sdvl_encode },
+	{ "sdvl_decode",                bench_sdvl_decode },
+	{ "hashtable_get_hit",          bench_hashtable_hit },
+	{ "hashtable_get_miss",         bench_hashtable_miss },
+	{ "siphash24_fingerprint",      bench_siphash24 },
+	{ "rohc_list_encode_type0",     bench_list_type0 },
+	{ "rohc_list_encode_type1",     bench_list_type1 },
+	{ "c_tcp_ts_lsb_code",          bench_tcp_ts },
+	{ "c_tcp_opt_sack_code",        bench_tcp_sack },
+};
+
+
+/** The profile of the context TCP options are encoded within */
+static const struct rohc_comp_profile bench_tcp_profile =
+{
+	.id = ROHC_PROFILE_TCP,
+};
+
+
+/** The results of the benchmarks, so that calls are not optimized out */
+static volatile uint64_t bench_sink;
+
+
+/**
+ * @brief Run the benchmarks of the encoding and decoding schemes
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if the benchmarks ran, non-zero otherwise
+ */
+int main(int argc, char *argv[])
+{
+	const size_t cases_nr = sizeof(bench_cases) / sizeof(bench_cases[0]);
+	struct bench_state *state;
+	struct bench_measure *measures;
+	const char *filter = NULL;
+	size_t warmup_nr = BENCH_WARMUP_NR;
+	size_t reps_nr = BENCH_REPS_NR;
+	bool is_first = true;
+	int is_failure = 1;
+	int i;
+	size_t j;
+
+	/* parse arguments */
+	for(i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--reps") == 0 && (i + 1) < argc)
+		{
+			reps_nr = strtoul(argv[++i], NULL, 10);
+		}
+		else if(strcmp(argv[i], "--warmup") == 0 && (i + 1) < argc)
+		{
+			warmup_nr = strtoul(argv[++i], NULL, 10);
+		}
+		else if(strcmp(argv[i], "--filter") == 0 && (i + 1) < argc)
+		{
+			filter = argv[++i];
+		}
+		else if(strcmp(argv[i], "--list") == 0)
+		{
+			for(j = 0; j < cases_nr; j++)
+			{
+				printf("%s\n", bench_cases[j].name);
+			}
+			return 0;
+		}
+		else
+		{
+			fprintf(stderr, "measure the cost of the encoding and decoding "
+			        "schemes\n");
+			fprintf(stderr, "usage: %s [--reps NUM] [--warmup NUM] "
+			        "[--filter SUBSTRING] [--list]\n", argv[0]);
+			goto error;
+		}
+	}
+	if(reps_nr == 0)
+	{
+		fprintf(stderr, "at least one repetition is required\n");
+		goto error;
+	}
+
+	state = malloc(sizeof(struct bench_state));
+	if(state == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the benchmarks\n");
+		goto error;
+	}
+	measures = calloc(reps_nr, sizeof(struct bench_measure));
+	if(measures == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the measures\n");
+		goto free_state;
+	}
+	if(!bench_init(state))
+	{
+		fprintf(stderr, "failed to initialize the benchmarks\n");
+		goto free_measures;
+	}
+
+	printf("{\n");
+	printf("  \"suite\": \"rohc_schemes\",\n");
+	printf("  \"version\": \"%s%s\",\n", PACKAGE_VERSION, PACKAGE_REVNO);
+	printf("  \"warmup\": %zu,\n", warmup_nr);
+	printf("  \"repetitions\": %zu,\n", reps_nr);
+#if defined(__i386__) || defined(__x86_64__)
+	printf("  \"cycles\": \"tsc\",\n");
+#else
+	printf("  \"cycles\": null,\n");
+#endif
+	printf("  \"benchmarks\": [");
+	for(j = 0; j < cases_nr; j++)
+	{
+		if(filter != NULL && strstr(bench_cases[j].name, filter) == NULL)
+		{
+			continue;
+		}
+		bench_case_run(state, &bench_cases[j], warmup_nr, reps_nr, measures,
+		               is_first);
+		is_first = false;
+	}
+	printf("\n  ]\n");
+	printf("}\n");
+
+	is_failure = 0;
+
+	bench_free(state);
+free_measures:
+	free(measures);
+free_state:
+	free(state);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Run one benchmark and print its results in JSON format
+ *
+ * @param state      The inputs of the benchmarks
+ * @param bench      The benchmark to run
+ * @param warmup_nr  The number of warm-up repetitions
+ * @param reps_nr    The number of measured repetitions
+ * @param measures   The measures, one per repetition
+ * @param is_first   Whether the benchmark is the first one printed
+ */
+static void bench_case_run(struct bench_state *const state,
+                           const struct bench_case *const bench,
+                           const size_t warmup_nr,
+                           const size_t reps_nr,
+                           struct bench_measure *const measures,
+                           const bool is_first)
+{
+	const size_t p99_pos = (reps_nr * 99 + 99) / 100 - 1;
+	size_t calls_nr = 1;
+	double median_ns;
+	double median_cycles;
+	size_t i;
+
+	/* calibrate the number of calls per repetition */
+	while(calls_nr < BENCH_REP_MAX_CALLS)
+	{
+		const uint64_t start_ns = bench_now_ns();
+		bench_sink += bench->run(state, calls_nr);
+		if((bench_now_ns() - start_ns) >= BENCH_REP_MIN_NS)
+		{
+			break;
+		}
+		calls_nr *= 2;
+	}
+
+	/* warm up caches and branch predictors */
+	for(i = 0; i < warmup_nr; i++)
+	{
+		bench_sink += bench->run(state, calls_nr);
+	}
+
+	/* measure */
+	for(i = 0; i < reps_nr; i++)
+	{
+		const uint64_t start_cycles = bench_now_cycles();
+		const uint64_t start_ns = bench_now_ns();
+		bench_sink += bench->run(state, calls_nr);
+		measures[i].ns = ((double) (bench_now_ns() - start_ns)) / calls_nr;
+		measures[i].cycles =
+			((double) (bench_now_cycles() - start_cycles)) / calls_nr;
+	}
+
+	printf("%s\n    {\n", (is_first ? "" : ","));
+	printf("      \"name\": \"%s\",\n", bench->name);
+	printf("      \"calls_per_rep\": %zu,\n", calls_nr);
+	qsort(measures, reps_nr, sizeof(struct bench_measure), bench_measure_cmp_ns);
+	median_ns = measures[(reps_nr - 1) / 2].ns;
+	printf("      \"min_ns\": %.3f,\n", measures[0].ns);
+	printf("      \"median_ns\": %.3f,\n", median_ns);
+	printf("      \"p99_ns\": %.3f,\n", measures[p99_pos].ns);
+#if defined(__i386__) || defined(__x86_64__)
+	qsort(measures, reps_nr, sizeof(struct bench_measure),
+	      bench_measure_cmp_cycles);
+	median_cycles = measures[(reps_nr - 1) / 2].cycles;
+	printf("      \"median_cycles\": %.1f,\n", median_cycles);
+	printf("      \"p99_cycles\": %.1f\n", measures[p99_pos].cycles);
+#else
+	median_cycles = 0;
+	printf("      \"median_cycles\": null,\n");
+	printf("      \"p99_cycles\": null\n");
+#endif
+	printf("    }");
+	fflush(stdout);
+
+	/* human-readable summary */
+	fprintf(stderr, "%-28s %10.1f ns %10.1f cycles\n", bench->name,
+	        median_ns, median_cycles);
+}
+
+
+/**
+ * @brief Compare two measures by time for qsort(3)
+ *
+ * @param m1  The first measure
+ * @param m2  The second measure
+ * @return    A negative, zero, or positive value if the first measure is
+ *            lower, equal, or greater than the second one
+ */
+static int bench_measure_cmp_ns(const void *const m1, const void *const m2)
+{
+	const double ns1 = ((const struct bench_measure *) m1)->ns;
+	const double ns2 = ((const struct bench_measure *) m2)->ns;
+
+	return (ns1 > ns2) - (ns1 < ns2);
+}
+
+
+/**
+ * @brief Compare two measures by CPU cycles for qsort(3)
+ *
+ * @param m1  The first measure
+ * @param m2  The second measure
+ * @return    A negative, zero, or positive value if the first measure is
+ *            lower, equal, or greater than the second one
+ */
+static int bench_measure_cmp_cycles(const void *const m1, const void *const m2)
+{
+	const double cycles1 = ((const struct bench_measure *) m1)->cycles;
+	const double cycles2 = ((const struct bench_measure *) m2)->cycles;
+
+	return (cycles1 > cycles2) - (cycles1 < cycles2);
+}
+
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (in nanoseconds)
+ */
+static uint64_t bench_now_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return ((uint64_t) now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+
+/**
+ * @brief Get the current number of CPU cycles
+ *
+ * The Time Stamp Counter is used on x86: it counts at a constant rate that
+ * may differ from the current CPU frequency.
+ *
+ * @return  The current number of CPU cycles, 0 if not available
+ */
+static uint64_t bench_now_cycles(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	uint32_t lo;
+	uint32_t hi;
+
+	__asm__ __volatile__("rdtsc" : "=a" (lo), "=d" (hi));
+
+	return (((uint64_t) hi) << 32) | lo;
+#else
+	return 0;
+#endif
+}
+
+
+/**
+ * @brief Initialize the inputs of all the benchmarks
+ *
+ * @param state  The inputs of the benchmarks
+ * @return       true if successful, false otherwise
+ */
+static bool bench_init(struct bench_state *const state)
+{
+	uint32_t rand_state = 0x12345678;
+	size_t i;
+
+	memset(state, 0, sizeof(struct bench_state));
+
+	/* pseudo-random data */
+	for(i = 0; i < BENCH_FCS32_MAX_LEN; i++)
+	{
+		rand_state ^= rand_state << 13;
+		rand_state ^= rand_state >> 17;
+		rand_state ^= rand_state << 5;
+		state->data[i] = rand_state & 0xff;
+	}
+
+	/* W-LSB windows filled with values close to the encoded ones */
+	if(!wlsb_new(&state->wlsb8, BENCH_WLSB_WIDTH))
+	{
+		goto error;
+	}
+	if(!wlsb_new(&state->wlsb16, BENCH_WLSB_WIDTH))
+	{
+		goto free_wlsb8;
+	}
+	if(!wlsb_new(&state->wlsb32, BENCH_WLSB_WIDTH))
+	{
+		goto free_wlsb16;
+	}
+	if(!wlsb_new(&state->wlsb_ack, BENCH_WLSB_WIDTH))
+	{
+		goto free_wlsb32;
+	}
+	for(i = 0; i < BENCH_WLSB_WIDTH; i++)
+	{
+		c_add_wlsb(&state->wlsb8, i, 0xf0 + i);
+		c_add_wlsb(&state->wlsb16, i, 0xfff0 + i);
+		c_add_wlsb(&state->wlsb32, i, 0xfffffff0 + i);
+		c_add_wlsb(&state->wlsb_ack, i, i);
+	}
+	state->wlsb_sn = BENCH_WLSB_WIDTH;
+	rohc_lsb_init(&state->lsb16, 16);
+	rohc_lsb_set_ref(&state->lsb16, 0xfff0, false);
+	for(i = 0; i < BENCH_INPUTS_NR; i++)
+	{
+		state->values16[i] = 0xfff0 + (i % 64);
+	}
+
+	/* SDVL values of all lengths */
+	for(i = 0; i < BENCH_INPUTS_NR; i++)
+	{
+		static const uint32_t sdvl_max[4] = { 0x7f, 0x3fff, 0x1fffff, 0x1fffffff };
+		size_t len;
+
+		state->sdvl_values[i] = (state->data[i] * 0x01010101U) & sdvl_max[i % 4];
+		if(!sdvl_encode_full(state->sdvl_encoded[i], 4, &len,
+		                     state->sdvl_values[i]))
+		{
+			goto free_wlsb_ack;
+		}
+	}
+
+	/* hash table filled with fingerprints as the compressor does */
+	memcpy(state->hashtable.key, state->data, sizeof(state->hashtable.key));
+	if(!hashtable_new(&state->hashtable, sizeof(struct rohc_fingerprint),
+	                  BENCH_HASHTABLE_SIZE))
+	{
+		goto free_wlsb_ack;
+	}
+	for(i = 0; i < BENCH_HASHTABLE_SIZE; i++)
+	{
+		struct rohc_fingerprint *const fingerprint =
+			&state->ht_elems[i].fingerprint;
+
+		fingerprint->base.profile_id = ROHC_PROFILE_RTP;
+		fingerprint->base.ip_hdrs_nr = 1;
+		fingerprint->base.ip_hdrs[0].version = 4;
+		fingerprint->base.ip_hdrs[0].next_proto = ROHC_IPPROTO_UDP;
+		fingerprint->base.ip_hdrs[0].saddr.u32[3] = 0x0a000000 | i;
+		fingerprint->base.ip_hdrs[0].daddr.u32[3] = 0x0a800001;
+		fingerprint->src_port = 10000 + i;
+		fingerprint->dst_port = 1234;
+		fingerprint->rtp_ssrc = i;
+		hashtable_add(&state->hashtable, fingerprint, &state->ht_elems[i]);
+	}
+	for(i = 0; i < BENCH_INPUTS_NR; i++)
+	{
+		memcpy(&state->ht_misses[i], &state->ht_elems[i].fingerprint,
+		       sizeof(struct rohc_fingerprint));
+		state->ht_misses[i].dst_port = 5678;
+	}
+
+	/* list compression of IPv6 extension headers: a new list without
+	 * reference (type 0), and one item inserted in the reference list
+	 * (type 1) */
+	rohc_comp_list_ipv6_new(&state->list_comp, 3, ROHC_PROFILE_IP, NULL, NULL);
+	{
+		static const uint8_t ext_types[3] = {
+			ROHC_IPPROTO_HOPOPTS, ROHC_IPPROTO_ROUTING, ROHC_IPPROTO_DSTOPTS
+		};
+
+		for(i = 0; i < 3; i++)
+		{
+			const int idx = state->list_comp.get_index_table(ext_types[i], 1);
+			struct rohc_list_item *const item = &state->list_comp.trans_table[idx];
+
+			assert(idx >= 0);
+			item->type = ext_types[i];
+			item->length = 8;
+			memcpy(item->data, state->data + i * 8, 8);
+			item->data[1] = 0; /* length of the extension header */
+			item->known = (i < 2);
+			state->list_type0.items[i] = item;
+			state->list_type1.items[i] = item;
+			if(i < 2)
+			{
+				state->list_comp.lists[0].items[i] = item;
+			}
+		}
+	}
+	state->list_type0.id = 0;
+	state->list_type0.items_nr = 3;
+	state->list_type1.id = 1;
+	state->list_type1.items_nr = 3;
+	state->list_comp.lists[0].items_nr = 2;
+
+	/* TCP options are encoded within one TCP compression context */
+	state->ctxt.compressor = &state->comp;
+	state->ctxt.profile = &bench_tcp_profile;
+	for(i = 0; i < TCP_SACK_BLOCKS_MAX_NR; i++)
+	{
+		state->sack_blocks[i].block_start = rohc_hton32(0x10000000 + i * 0x2000);
+		state->sack_blocks[i].block_end = rohc_hton32(0x10001000 + i * 0x2000);
+	}
+
+	/* check that the benchmarks measure what they are expected to */
+	state->list_comp.ref_id = ROHC_LIST_GEN_ID_NONE;
+	if(rohc_list_encode(&state->list_comp, &state->list_type0, state->out, 0) < 0 ||
+	   (state->out[0] >> 6) != 0)
+	{
+		goto free_hashtable;
+	}
+	state->list_comp.ref_id = 0;
+	if(rohc_list_encode(&state->list_comp, &state->list_type1, state->out, 0) < 0 ||
+	   (state->out[0] >> 6) != 1)
+	{
+		goto free_hashtable;
+	}
+	if(hashtable_get(&state->hashtable, &state->ht_elems[0].fingerprint) !=
+	   &state->ht_elems[0] ||
+	   hashtable_get(&state->hashtable, &state->ht_misses[0]) != NULL)
+	{
+		goto free_hashtable;
+	}
+
+	return true;
+
+free_hashtable:
+	hashtable_free(&state->hashtable);
+free_wlsb_ack:
+	wlsb_free(&state->wlsb_ack);
+free_wlsb32:
+	wlsb_free(&state->wlsb32);
+free_wlsb16:
+	wlsb_free(&state->wlsb16);
+free_wlsb8:
+	wlsb_free(&state->wlsb8);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Release the inputs of all the benchmarks
+ *
+ * @param state  The inputs of the benchmarks
+ */
+static void bench_free(struct bench_state *const state)
+{
+	rohc_comp_list_ipv6_free(&state->list_comp);
+	hashtable_free(&state->hashtable);
+	wlsb_free(&state->wlsb_ack);
+	wlsb_free(&state->wlsb32);
+	wlsb_free(&state->wlsb16);
+	wlsb_free(&state->wlsb8);
+}
+
+
+/** Benchmark \ref wlsb_is_kp_possible_8bits */
+static uint64_t bench_wlsb_kp_8bits(struct bench_state *const state,
+                                    const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		sum += wlsb_is_kp_possible_8bits(&state->wlsb8, 0xf0 + (i & 0x1f), 4, 1);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref wlsb_is_kp_possible_16bits */
+static uint64_t bench_wlsb_kp_16bits(struct bench_state *const state,
+                                     const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		sum += wlsb_is_kp_possible_16bits(&state->wlsb16,
+		                                  state->values16[i % BENCH_INPUTS_NR],
+		                                  5, 1);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref wlsb_is_kp_possible_32bits */
+static uint64_t bench_wlsb_kp_32bits(struct bench_state *const state,
+                                     const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		sum += wlsb_is_kp_possible_32bits(&state->wlsb32, 0xfffffff0 + (i & 0x3f),
+		                                  6, 63);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref c_add_wlsb followed by \ref wlsb_ack */
+static uint64_t bench_wlsb_add_ack(struct bench_state *const state,
+                                   const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		c_add_wlsb(&state->wlsb_ack, state->wlsb_sn, state->wlsb_sn);
+		sum += wlsb_ack(&state->wlsb_ack, (state->wlsb_sn - 2) & 0xffff, 16);
+		state->wlsb_sn++;
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref rohc_lsb_decode */
+static uint64_t bench_lsb_decode(struct bench_state *const state,
+                                 const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		uint32_t decoded;
+
+		if(rohc_lsb_decode(&state->lsb16, ROHC_LSB_REF_0, 0,
+		                   state->values16[i % BENCH_INPUTS_NR] & 0x3f, 6, 1,
+		                   &decoded))
+		{
+			sum += decoded;
+		}
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref crc_calculate with CRC-3 */
+static uint64_t bench_crc3(struct bench_state *const state,
+                           const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		sum += crc_calculate(ROHC_CRC_TYPE_3, state->data + (i & 0xff),
+		                     BENCH_CRC_HDR_LEN, CRC_INIT_3);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref crc_calculate with CRC-7 */
+static uint64_t bench_crc7(struct bench_state *const state,
+                           const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		sum += crc_calculate(ROHC_CRC_TYPE_7, state->data + (i & 0xff),
+		                     BENCH_CRC_HDR_LEN, CRC_INIT_7);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref crc_calculate with CRC-8 */
+static uint64_t bench_crc8(struct bench_state *const state,
+                           const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		sum += crc_calculate(ROHC_CRC_TYPE_8, state->data + (i & 0xff),
+		                     BENCH_CRC_HDR_LEN, CRC_INIT_8);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref crc_calc_fcs32 on small segments */
+static uint64_t bench_fcs32_64(struct bench_state *const state,
+                               const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		sum += crc_calc_fcs32(state->data + (i & 0xff), 64, CRC_INIT_FCS32);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref crc_calc_fcs32 on full-sized segments */
+static uint64_t bench_fcs32_1500(struct bench_state *const state,
+                                 const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		/* change the initial value, otherwise the pure call is hoisted */
+		sum += crc_calc_fcs32(state->data, BENCH_FCS32_MAX_LEN, CRC_INIT_FCS32 ^ i);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref sdvl_encode_full on values of all lengths */
+static uint64_t bench_sdvl_encode(struct bench_state *const state,
+                                  const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		size_t len;
+
+		if(sdvl_encode_full(state->out, 4, &len,
+		                    state->sdvl_values[i % BENCH_INPUTS_NR]))
+		{
+			sum += len + state->out[0];
+		}
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref sdvl_decode on values of all lengths */
+static uint64_t bench_sdvl_decode(struct bench_state *const state,
+                                  const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		uint32_t value;
+		size_t bits_nr;
+
+		sum += sdvl_decode(state->sdvl_encoded[i % BENCH_INPUTS_NR], 4,
+		                   &value, &bits_nr);
+		sum += value;
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref hashtable_get with keys that are found */
+static uint64_t bench_hashtable_hit(struct bench_state *const state,
+                                    const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		const struct bench_ht_elem *const elem =
+			&state->ht_elems[(i * 7) % BENCH_HASHTABLE_SIZE];
+		sum += (uintptr_t) hashtable_get(&state->hashtable, &elem->fingerprint);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref hashtable_get with keys that are not found */
+static uint64_t bench_hashtable_miss(struct bench_state *const state,
+                                     const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		sum += (uintptr_t) hashtable_get(&state->hashtable,
+		                                 &state->ht_misses[i % BENCH_INPUTS_NR]);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref siphash24 on context fingerprints */
+static uint64_t bench_siphash24(struct bench_state *const state,
+                                const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		sum += siphash24(&state->ht_misses[i % BENCH_INPUTS_NR],
+		                 sizeof(struct rohc_fingerprint), state->hashtable.key);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref rohc_list_encode with a new list (encoding type 0) */
+static uint64_t bench_list_type0(struct bench_state *const state,
+                                 const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	state->list_comp.ref_id = ROHC_LIST_GEN_ID_NONE;
+	for(i = 0; i < calls_nr; i++)
+	{
+		sum += rohc_list_encode(&state->list_comp, &state->list_type0,
+		                        state->out, 0);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref rohc_list_encode with one inserted item (encoding type 1) */
+static uint64_t bench_list_type1(struct bench_state *const state,
+                                 const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	state->list_comp.ref_id = 0;
+	for(i = 0; i < calls_nr; i++)
+	{
+		sum += rohc_list_encode(&state->list_comp, &state->list_type1,
+		                        state->out, 0);
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref c_tcp_ts_lsb_code on all the encoded lengths */
+static uint64_t bench_tcp_ts(struct bench_state *const state,
+                             const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		size_t len;
+
+		if(c_tcp_ts_lsb_code(&state->ctxt, 0x12345678 + i, 1 + (i % 4),
+		                     state->out, sizeof(state->out), &len))
+		{
+			sum += len + state->out[0];
+		}
+	}
+
+	return sum;
+}
+
+
+/** Benchmark \ref c_tcp_opt_sack_code with 1 to 4 SACK blocks */
+static uint64_t bench_tcp_sack(struct bench_state *const state,
+                               const size_t calls_nr)
+{
+	uint64_t sum = 0;
+	size_t i;
+
+	for(i = 0; i < calls_nr; i++)
+	{
+		const uint8_t blocks_nr = 1 + (i % TCP_SACK_BLOCKS_MAX_NR);
+		const int len =
+			c_tcp_opt_sack_code(&state->ctxt, 0x0fff0000, state->sack_blocks,
+			                    blocks_nr * sizeof(sack_block_t), false,
+			                    state->out, sizeof(state->out));
+		if(len > 0)
+		{
+			sum += len + state->out[0];
+		}
+	}
+
+	return sum;
+}
+
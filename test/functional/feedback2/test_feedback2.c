@@ -67,6 +67,42 @@ for ./configure ? If yes, check configure output and config.log"
 #include <rohc_packets.h>
 
 
+#if defined(__GLIBC__)
+
+/* count the memory allocations done while decompressing, the functions of
+ * the GNU C library are overridden by the ones of the application */
+#define HAVE_ALLOCS_COUNT 1
+
+extern void * __libc_malloc(size_t size);
+extern void * __libc_calloc(size_t nmemb, size_t size);
+extern void * __libc_realloc(void *ptr, size_t size);
+
+/** Whether memory allocations are counted or not */
+static bool allocs_count = false;
+/** The number of memory allocations counted */
+static size_t allocs_nr = 0;
+
+void * malloc(size_t size)
+{
+	allocs_nr += (allocs_count ? 1 : 0);
+	return __libc_malloc(size);
+}
+
+void * calloc(size_t nmemb, size_t size)
+{
+	allocs_nr += (allocs_count ? 1 : 0);
+	return __libc_calloc(nmemb, size);
+}
+
+void * realloc(void *ptr, size_t size)
+{
+	allocs_nr += (allocs_count ? 1 : 0);
+	return __libc_realloc(ptr, size);
+}
+
+#endif
+
+
 /* prototypes of private functions */
 static void usage(void);
 static int test_comp_and_decomp(const char *filename,
@@ -431,8 +467,15 @@ static int test_comp_and_decomp(const char *filename,
 		rohc_buf_pull(&rohc_packet, link_len);
 
 		/* decompress the ROHC packet with the ROHC decompressor */
+#ifdef HAVE_ALLOCS_COUNT
+		allocs_nr = 0;
+		allocs_count = true;
+#endif
 		status = rohc_decompress3(decomp, rohc_packet, &ip_packet,
 		                          NULL, &feedback_send);
+#ifdef HAVE_ALLOCS_COUNT
+		allocs_count = false;
+#endif
 		if(status != ROHC_STATUS_OK)
 		{
 			fprintf(stderr, "\tfailed to decompress ROHC packet\n");
@@ -440,6 +483,17 @@ static int test_comp_and_decomp(const char *filename,
 		}
 		fprintf(stderr, "\tdecompression is successful\n");
 
+#ifdef HAVE_ALLOCS_COUNT
+		/* once the context is created, ACKs shall be built without any memory
+		 * allocation */
+		if(counter > 1 && strcmp(expected_type, "ack") == 0 && allocs_nr > 0)
+		{
+			fprintf(stderr, "\t%zu memory allocations while decompressing and "
+			        "building the ACK feedback, none expected\n", allocs_nr);
+			goto destroy_decomp;
+		}
+#endif
+
 		/* the decompressor should have generated one feedback */
 		if(rohc_buf_is_empty(feedback_send))
 		{
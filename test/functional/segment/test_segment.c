@@ -24,6 +24,8 @@
  * @author Didier Barvaux <didier@barvaux.org>
  *
  * The application compresses ROHC packets, doing segmentation if needed.
+ * The ROHC segments are decompressed one by one, then all at once from the
+ * buffers they were generated in.
  */
 
 #include "test.h"
@@ -57,6 +59,9 @@
 /** The max size */
 #define TEST_MAX_ROHC_SIZE  (5U * 1024U)
 
+/** The max number of ROHC segments for one IP packet */
+#define TEST_MAX_SEGMENTS_NR  5U
+
 
 /* prototypes of private functions */
 static void usage(void);
@@ -64,6 +69,11 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
                                 const size_t mrru,
                                 const bool is_comp_expected_ok,
                                 const size_t expected_segments_nr);
+static bool test_decomp_segments(struct rohc_decomp *const decomp,
+                                 const struct rohc_buf ip_packet,
+                                 struct rohc_buf *const segments,
+                                 const size_t segments_nr)
+	__attribute__((nonnull(1, 3), warn_unused_result));
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
                               const rohc_trace_entity_t entity,
@@ -200,6 +210,8 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 	struct rohc_buf uncomp_packet =
 		rohc_buf_init_empty(uncomp_buffer, TEST_MAX_ROHC_SIZE * 3);
 
+	uint8_t segments_buffer[TEST_MAX_SEGMENTS_NR][TEST_MAX_ROHC_SIZE];
+	struct rohc_buf segments[TEST_MAX_SEGMENTS_NR];
 	size_t segments_nr;
 
 	int is_failure = 1;
@@ -348,6 +360,17 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 //! [segment ROHC packet #2]
 			fprintf(stderr, "\t%zu-byte ROHC segment generated\n",
 			        rohc_packet.len);
+			if(segments_nr >= TEST_MAX_SEGMENTS_NR)
+			{
+				fprintf(stderr, "\ttoo many ROHC segments\n");
+				goto destroy_decomp;
+			}
+			memcpy(segments_buffer[segments_nr], rohc_buf_data(rohc_packet),
+			       rohc_packet.len);
+			segments[segments_nr].data = segments_buffer[segments_nr];
+			segments[segments_nr].max_len = rohc_packet.len;
+			segments[segments_nr].offset = 0;
+			segments[segments_nr].len = rohc_packet.len;
 			segments_nr++;
 
 			/* decompress segment */
@@ -377,6 +400,15 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 //! [segment ROHC packet #3]
 		fprintf(stderr, "\t%zu-byte final ROHC segment generated\n",
 		        rohc_packet.len);
+		if(segments_nr >= TEST_MAX_SEGMENTS_NR)
+		{
+			fprintf(stderr, "\ttoo many ROHC segments\n");
+			goto destroy_decomp;
+		}
+		segments[segments_nr].data = rohc_packet.data;
+		segments[segments_nr].max_len = rohc_packet.max_len;
+		segments[segments_nr].offset = rohc_packet.offset;
+		segments[segments_nr].len = rohc_packet.len;
 		segments_nr++;
 
 		/* decompress last segment */
@@ -456,6 +488,13 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 		        "original IP packet\n");
 	}
 
+	/* decompress all the ROHC segments at once */
+	if(segments_nr > 0 &&
+	   !test_decomp_segments(decomp, ip_packet, segments, segments_nr))
+	{
+		goto destroy_decomp;
+	}
+
 	/* everything went fine */
 	fprintf(stderr, "\n");
 	is_failure = 0;
@@ -469,6 +508,94 @@ error:
 }
 
 
+/**
+ * @brief Decompress all the ROHC segments of one IP packet at once
+ *
+ * The ROHC segments are decompressed from the buffers they are stored in.
+ * The RRU shall be rejected if one segment is missing or corrupted.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param ip_packet    The original IP packet
+ * @param segments     The ROHC segments of the IP packet
+ * @param segments_nr  The number of ROHC segments
+ * @return             true if test succeeds, false otherwise
+ */
+static bool test_decomp_segments(struct rohc_decomp *const decomp,
+                                 const struct rohc_buf ip_packet,
+                                 struct rohc_buf *const segments,
+                                 const size_t segments_nr)
+{
+	uint8_t uncomp_buffer[TEST_MAX_ROHC_SIZE * 3];
+	struct rohc_buf uncomp_packet =
+		rohc_buf_init_empty(uncomp_buffer, TEST_MAX_ROHC_SIZE * 3);
+	uint8_t small_buffer[TEST_MAX_ROHC_SIZE];
+	struct rohc_buf small_packet =
+		rohc_buf_init_empty(small_buffer, TEST_MAX_ROHC_SIZE);
+	rohc_status_t status;
+
+	/* all segments at once */
+	status = rohc_decompress_segments(decomp, segments, segments_nr,
+	                                  &uncomp_packet, NULL, NULL);
+	if(status != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "\tfailed to decompress the %zu ROHC segments at once "
+		        "(status = %d)\n", segments_nr, status);
+		goto error;
+	}
+	if(uncomp_packet.len != ip_packet.len ||
+	   memcmp(rohc_buf_data(uncomp_packet), rohc_buf_data(ip_packet),
+	          ip_packet.len) != 0)
+	{
+		fprintf(stderr, "\t%zu-byte packet decompressed from the %zu ROHC "
+		        "segments at once does not match original %zu-byte IP "
+		        "packet\n", uncomp_packet.len, segments_nr, ip_packet.len);
+		goto error;
+	}
+	fprintf(stderr, "\tROHC segments decompressed at once match the original "
+	        "IP packet\n");
+
+	/* output buffer too small for the segments */
+	status = rohc_decompress_segments(decomp, segments, segments_nr,
+	                                  &small_packet, NULL, NULL);
+	if(status != ROHC_STATUS_OUTPUT_TOO_SMALL)
+	{
+		fprintf(stderr, "\tROHC segments unexpectedly fit in a too small "
+		        "buffer (status = %d)\n", status);
+		goto error;
+	}
+
+	/* missing final segment */
+	uncomp_packet.offset = 0;
+	uncomp_packet.len = 0;
+	status = rohc_decompress_segments(decomp, segments, segments_nr - 1,
+	                                  &uncomp_packet, NULL, NULL);
+	if(status != ROHC_STATUS_MALFORMED || uncomp_packet.len != 0)
+	{
+		fprintf(stderr, "\tRRU without its final segment was not rejected "
+		        "(status = %d)\n", status);
+		goto error;
+	}
+
+	/* one corrupted byte in the first segment */
+	rohc_buf_byte_at(segments[0], segments[0].len / 2) ^= 0x01;
+	status = rohc_decompress_segments(decomp, segments, segments_nr,
+	                                  &uncomp_packet, NULL, NULL);
+	rohc_buf_byte_at(segments[0], segments[0].len / 2) ^= 0x01;
+	if(status != ROHC_STATUS_BAD_CRC || uncomp_packet.len != 0)
+	{
+		fprintf(stderr, "\tRRU with one corrupted byte was not rejected "
+		        "(status = %d)\n", status);
+		goto error;
+	}
+	fprintf(stderr, "\tincomplete or corrupted ROHC segments are rejected\n");
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Callback to print traces of the ROHC library
  *
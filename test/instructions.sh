@@ -0,0 +1,142 @@
+#!/bin/sh
+#
+# Copyright 2026 Didier Barvaux
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+
+#
+# file:        instructions.sh
+# description: Functions to compare the instructions retired per packet by
+#              the ROHC library with the ones of a baseline.
+# authors:     Didier Barvaux <didier@barvaux.org>
+#
+# The files of instructions contain one 'key = value' pair per line:
+#    counter = perf|callgrind|none
+#    compressed_packets = NUM
+#    decompressed_packets = NUM
+#    comp_instructions_per_packet = NUM
+#    decomp_instructions_per_packet = NUM
+#
+# Environment variables:
+#    INSTR_TOLERANCE=<percent>  the increase of instructions per packet that
+#                               is accepted over the baseline (default: 5)
+#
+
+
+# Count the instructions per packet with Callgrind if the test application
+# was not able to count them itself
+#  param #1      the file of instructions written by the test application
+#  next params   the command line that wrote the file of instructions
+#  return value  0 in case of success, 1 in case of failure, 77 if no
+#                instruction counter is available
+count_instructions_with_callgrind()
+{
+	INSTR_FILE="$1"
+	shift
+	CMD="$@"
+
+	${GREP} -q '^counter = none$' "${INSTR_FILE}" || return 0
+
+	valgrind=$( which valgrind )
+	callgrind_annotate=$( which callgrind_annotate )
+	if [ ! -x "${valgrind}" ] || [ ! -x "${callgrind_annotate}" ] ; then
+		echo "instructions cannot be counted: perf_event_open(2) is not " \
+		     "available, and Callgrind is not installed" >&2
+		return 77
+	fi
+
+	# the exit code of the test is not checked, the test was already run
+	# without Callgrind
+	echo "count instructions with Callgrind..."
+	libtool --mode=execute \
+		${valgrind} -q --tool=callgrind --collect-atstart=no \
+		--toggle-collect=rohc_compress4 --toggle-collect=rohc_decompress3 \
+		--callgrind-out-file="${INSTR_FILE}.callgrind" \
+		${CMD} >/dev/null
+	if [ ! -f "${INSTR_FILE}.callgrind" ] ; then
+		echo "Callgrind failed to count instructions" >&2
+		return 1
+	fi
+
+	# the inclusive costs of the compression and decompression functions
+	${callgrind_annotate} --inclusive=yes "${INSTR_FILE}.callgrind" \
+		> "${INSTR_FILE}.annotate"
+	${AWK} -v annotate_file="${INSTR_FILE}.annotate" \
+	       -v instr_file="${INSTR_FILE}" '
+		FILENAME == annotate_file && $0 ~ /:rohc_compress4( |$)/ {
+			gsub(",", "", $1); comp_nr = $1
+		}
+		FILENAME == annotate_file && $0 ~ /:rohc_decompress3( |$)/ {
+			gsub(",", "", $1); decomp_nr = $1
+		}
+		FILENAME == instr_file && $1 == "compressed_packets" { comp_pkts_nr = $3 }
+		FILENAME == instr_file && $1 == "decompressed_packets" { decomp_pkts_nr = $3 }
+		END {
+			printf("compressed_packets = %d\n", comp_pkts_nr) > instr_file
+			printf("decompressed_packets = %d\n", decomp_pkts_nr) > instr_file
+			printf("counter = callgrind\n") > instr_file
+			printf("comp_instructions_per_packet = %d\n",
+			       comp_pkts_nr > 0 ? comp_nr / comp_pkts_nr : 0) > instr_file
+			printf("decomp_instructions_per_packet = %d\n",
+			       decomp_pkts_nr > 0 ? decomp_nr / decomp_pkts_nr : 0) > instr_file
+		}' "${INSTR_FILE}.annotate" "${INSTR_FILE}"
+	ret=$?
+	rm -f "${INSTR_FILE}.callgrind" "${INSTR_FILE}.annotate"
+	return ${ret}
+}
+
+
+# Compare the instructions per packet with the ones of the baseline
+#  param #1      the file of instructions of the baseline
+#  param #2      the file of instructions of the test
+#  return value  0 in case of success or if there is no baseline, 1 in case
+#                of regression, 77 if the instructions cannot be compared
+compare_instructions()
+{
+	BASELINE_FILE="$1"
+	INSTR_FILE="$2"
+
+	if [ ! -f "${BASELINE_FILE}" ] ; then
+		echo "no baseline '${BASELINE_FILE}', instructions are not checked"
+		return 0
+	fi
+
+	${AWK} -v tolerance="${INSTR_TOLERANCE:-5}" '
+		FNR == NR { ref[$1] = $3 ; next }
+		{ new[$1] = $3 }
+		END {
+			if(ref["counter"] != new["counter"]) {
+				printf("instructions counted with %s cannot be compared with " \
+				       "the baseline counted with %s\n", new["counter"],
+				       ref["counter"]) > "/dev/stderr"
+				exit 77
+			}
+			ret = 0
+			split("comp_instructions_per_packet decomp_instructions_per_packet",
+			      keys, " ")
+			for(i = 1; i <= 2; i++) {
+				limit = ref[keys[i]] * (100 + tolerance) / 100
+				printf("%s: %d (baseline %d, limit %d)\n", keys[i],
+				       new[keys[i]], ref[keys[i]], limit)
+				if(new[keys[i]] > limit) {
+					printf("%s: regression of more than %d%% over the " \
+					       "baseline\n", keys[i], tolerance) > "/dev/stderr"
+					ret = 1
+				}
+			}
+			exit ret
+		}' "${BASELINE_FILE}" "${INSTR_FILE}"
+}
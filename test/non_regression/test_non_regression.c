@@ -99,6 +99,13 @@
 #include <errno.h>
 #include <assert.h>
 #include <stdarg.h>
+#include <inttypes.h> /* for PRIu64 */
+#if HAVE_LINUX_PERF_EVENT_H == 1 && HAVE_SYS_SYSCALL_H == 1
+#  include <linux/perf_event.h> /* for the instruction counter */
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  define HAVE_INSTR_COUNTER 1
+#endif
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
@@ -229,6 +236,13 @@ static void show_rohc_decomp_profile(const struct rohc_decomp *const decomp,
 static int compare_packets(unsigned char *pkt1, int pkt1_size,
                            unsigned char *pkt2, int pkt2_size);
 
+static int instr_counter_open(void)
+	__attribute__((warn_unused_result));
+static uint64_t instr_counter_read(void)
+	__attribute__((warn_unused_result));
+static bool instr_output(const char *const filename)
+	__attribute__((nonnull(1), warn_unused_result));
+
 
 /** The VLAN header */
 struct vlan_hdr
@@ -266,6 +280,18 @@ static int pkt_not_lost = 0;
 /** Loss state per compressor and per context */
 static size_t rcvd_pkts_nr_per_burst[NUM_COMP][ROHC_SMALL_CID_MAX + 1] = { { 0 } };
 
+/** The counter of the instructions retired by the test in user space,
+ *  -1 if instructions are not counted */
+static int instr_fd = -1;
+/** The instructions retired while compressing the IP packets */
+static uint64_t instr_comp_nr = 0;
+/** The number of calls to the compressor */
+static size_t instr_comp_pkts_nr = 0;
+/** The instructions retired while decompressing the ROHC packets */
+static uint64_t instr_decomp_nr = 0;
+/** The number of calls to the decompressor */
+static size_t instr_decomp_pkts_nr = 0;
+
 
 /**
  * @brief Main function for the ROHC test program
@@ -281,6 +307,7 @@ int main(int argc, char *argv[])
 {
 	char *cid_type_name = NULL;
 	char *rohc_size_ofilename = NULL;
+	char *instr_ofilename = NULL;
 	size_t src_filenames_nr = 0;
 	char *src_filenames[SRC_FILENAMES_MAX_NR] = { NULL };
 	char *ofilename = NULL;
@@ -389,6 +416,18 @@ int main(int argc, char *argv[])
 			rohc_size_ofilename = argv[1];
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--instr-output"))
+		{
+			/* get the name of the file to store the instructions per packet */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --instr-output takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			instr_ofilename = argv[1];
+			args_used++;
+		}
 		else if(!strcmp(*argv, "--max-contexts"))
 		{
 			/* get the maximum number of contexts the test should use */
@@ -560,6 +599,17 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* count the instructions retired by the library if asked */
+	if(instr_ofilename != NULL)
+	{
+		instr_fd = instr_counter_open();
+		if(instr_fd < 0)
+		{
+			trace("=== instructions cannot be counted: %s (%d)\n",
+			      strerror(errno), errno);
+		}
+	}
+
 	/* test ROHC compression/decompression with the packets from the file */
 	status = test_comp_and_decomp(cid_type, oa_repetitions, max_contexts, proto_version,
 	                              padding_up_to, no_comparison, ignore_malformed,
@@ -567,6 +617,21 @@ int main(int argc, char *argv[])
 	                              ofilename, cmp_filename,
 	                              rohc_size_ofilename);
 
+	/* save the instructions per packet if asked */
+	if(instr_ofilename != NULL)
+	{
+		if(!instr_output(instr_ofilename) && status == 0)
+		{
+			status = 1;
+		}
+#ifdef HAVE_INSTR_COUNTER
+		if(instr_fd >= 0)
+		{
+			close(instr_fd);
+		}
+#endif
+	}
+
 	trace("=== number of warnings/errors emitted by the library: %zu\n",
 	      nr_rohc_warnings);
 	if(nr_rohc_warnings > 0)
@@ -627,6 +692,8 @@ static void usage(void)
 	        "  -c FILE                    Compare the generated ROHC packets with the\n"
 	        "                             ROHC packets stored in FILE (PCAP format)\n"
 	        "  --rohc-size-output FILE    Save the sizes of ROHC packets in FILE\n"
+	        "  --instr-output FILE        Save the instructions retired per packet\n"
+	        "                             by the library in FILE\n"
 	        "  --max-contexts NUM         The maximum number of ROHC contexts to\n"
 	        "                             simultaneously use during the test\n"
 	        "  --optimistic-approach NUM  The nr of Optimistic Approach repetitions\n"
@@ -965,6 +1032,7 @@ static int compress_decompress(struct rohc_comp *comp,
 	struct rohc_buf rcvd_feedback =
 		rohc_buf_init_empty(rcvd_feedback_buffer, MAX_ROHC_SIZE);
 
+	uint64_t instr_start;
 	int status = 1;
 	rohc_status_t ret;
 
@@ -1085,7 +1153,10 @@ static int compress_decompress(struct rohc_comp *comp,
 
 	/* compress the IP packet into a ROHC packet */
 	trace("=== ROHC compression: start\n");
+	instr_start = instr_counter_read();
 	ret = rohc_compress4(comp, ip_packet, &rohc_packet);
+	instr_comp_nr += instr_counter_read() - instr_start;
+	instr_comp_pkts_nr++;
 	if(ret != ROHC_STATUS_OK)
 	{
 		trace("=== ROHC compression: failure\n");
@@ -1206,8 +1277,11 @@ static int compress_decompress(struct rohc_comp *comp,
 
 	/* decompress the ROHC packet */
 	trace("=== ROHC decompression: start\n");
+	instr_start = instr_counter_read();
 	ret = rohc_decompress3(decomp, rohc_packet, &decomp_packet,
 	                       &rcvd_feedback, feedback_send_by_other);
+	instr_decomp_nr += instr_counter_read() - instr_start;
+	instr_decomp_pkts_nr++;
 	if(ret != ROHC_STATUS_OK)
 	{
 		size_t i;
@@ -2102,3 +2176,98 @@ skip:
 	return valid;
 }
 
+
+
+/**
+ * @brief Open the counter of the instructions retired in user space
+ *
+ * The instructions retired in the kernel are not counted, so that the
+ * system calls that read the counter are not measured.
+ *
+ * @return  The counter of instructions, -1 if not available
+ */
+static int instr_counter_open(void)
+{
+#ifdef HAVE_INSTR_COUNTER
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(struct perf_event_attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(struct perf_event_attr);
+	attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	/* the calling thread on any CPU */
+	return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+
+/**
+ * @brief Read the counter of the instructions retired in user space
+ *
+ * @return  The number of instructions retired so far, 0 if instructions are
+ *          not counted
+ */
+static uint64_t instr_counter_read(void)
+{
+	uint64_t count = 0;
+
+#ifdef HAVE_INSTR_COUNTER
+	if(instr_fd >= 0 && read(instr_fd, &count, sizeof(uint64_t)) != sizeof(uint64_t))
+	{
+		count = 0;
+	}
+#endif
+
+	return count;
+}
+
+
+/**
+ * @brief Save the instructions retired per packet by the library
+ *
+ * The file contains one 'key = value' pair per line. The number of
+ * instructions per packet is only written if the instructions were counted:
+ * the test scripts may then count them with Callgrind instead.
+ *
+ * @param filename  The name of the file to write
+ * @return          true if the file was written, false otherwise
+ */
+static bool instr_output(const char *const filename)
+{
+	FILE *file;
+
+	file = fopen(filename, "w");
+	if(file == NULL)
+	{
+		trace("failed to open file '%s' to output the instructions per "
+		      "packet: %s (%d)\n", filename, strerror(errno), errno);
+		goto error;
+	}
+
+	fprintf(file, "compressed_packets = %zu\n", instr_comp_pkts_nr);
+	fprintf(file, "decompressed_packets = %zu\n", instr_decomp_pkts_nr);
+	if(instr_fd < 0)
+	{
+		fprintf(file, "counter = none\n");
+	}
+	else
+	{
+		fprintf(file, "counter = perf\n");
+		fprintf(file, "comp_instructions_per_packet = %" PRIu64 "\n",
+		        instr_comp_pkts_nr > 0 ? instr_comp_nr / instr_comp_pkts_nr : 0);
+		fprintf(file, "decomp_instructions_per_packet = %" PRIu64 "\n",
+		        instr_decomp_pkts_nr > 0 ? instr_decomp_nr / instr_decomp_pkts_nr : 0);
+	}
+
+	fclose(file);
+	return true;
+
+error:
+	return false;
+}
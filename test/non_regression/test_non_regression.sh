@@ -41,6 +41,10 @@
 # Environment variables:
 #    USE_VALGRIND=yes|no   run the tests within Valgrind or not
 #    USE_PYTHON=<version>  run the tests of the Python binding or not
+#    CHECK_INSTRUCTIONS=yes|no  compare the instructions retired per packet
+#                               with the baseline or not
+#    INSTR_TOLERANCE=<percent>  the accepted increase of instructions per
+#                               packet over the baseline (default: 5)
 #
 
 # skip test in case of cross-compilation
@@ -87,6 +91,8 @@ else
 fi
 CAPTURE_COMPARE="${BASEDIR}/inputs/${STREAM}/rohc${ROHC_VERSION_SUFFIX}_maxcontexts${MAX_CONTEXTS}_wlsb${WLSB_WIDTH}_${CID_TYPE}.pcap"
 SIZE_COMPARE="${BASEDIR}/inputs/${STREAM}/rohc${ROHC_VERSION_SUFFIX}_maxcontexts${MAX_CONTEXTS}_wlsb${WLSB_WIDTH}_${CID_TYPE}.sizes"
+INSTR_COMPARE="${BASEDIR}/inputs/${STREAM}/rohc${ROHC_VERSION_SUFFIX}_maxcontexts${MAX_CONTEXTS}_wlsb${WLSB_WIDTH}_${CID_TYPE}.instrs"
+INSTR_OUTPUT=""
 
 # check that capture names are not empty
 if [ -z "${CAPTURE_SOURCE}" ] ; then
@@ -131,6 +137,11 @@ elif [ "${VERBOSE}" = "generate" ] ; then
 	CMD="${CMD} --max-contexts ${MAX_CONTEXTS}"
 	CMD="${CMD} --rohc-version ${ROHC_VERSION}"
 	CMD="${CMD} ${CID_TYPE} ${CAPTURE_SOURCE}"
+	if [ "${CHECK_INSTRUCTIONS}" = "yes" ] ; then
+		# generate the baseline of instructions per packet
+		INSTR_OUTPUT="${INSTR_COMPARE}"
+		CMD="${CMD} --instr-output ${INSTR_OUTPUT}"
+	fi
 else
 	# normal mode: compare with existing ROHC output captures
 	CMD_PARAMS="${CMD_PARAMS} --optimistic-approach ${WLSB_WIDTH}"
@@ -144,17 +155,42 @@ else
 	fi
 	CMD="${APP} ${CMD_PARAMS} -c ${CAPTURE_COMPARE}"
 	CMD_PYTHON="${CMD_PYTHON} ${CMD_PARAMS} -c ${CAPTURE_COMPARE}"
+	if [ "${CHECK_INSTRUCTIONS}" = "yes" ] ; then
+		# count the instructions per packet to compare them with the baseline
+		INSTR_OUTPUT="$( mktemp )" || exit 1
+		CMD="${CMD} --instr-output ${INSTR_OUTPUT}"
+	fi
 fi
 
 # source valgrind-related functions
 . ${BASEDIR}/../../valgrind.sh
+# source functions related to the instructions per packet
+. ${BASEDIR}/../../instructions.sh
 
 # C or Python test?
 if [ -z "${USE_PYTHON}" ] ; then
 	# run C tests
 
 	# run without valgrind
-	run_test_without_valgrind ${CMD} || exit $?
+	run_test_without_valgrind ${CMD}
+	ret=$?
+
+	# count the instructions per packet with Callgrind if the test was not
+	# able to count them, then compare them with the baseline: a change that
+	# makes the library more expensive fails the test
+	if [ -n "${INSTR_OUTPUT}" ] ; then
+		if [ ${ret} -eq 0 ] || [ "${VERBOSE}" = "generate" ] ; then
+			count_instructions_with_callgrind "${INSTR_OUTPUT}" ${CMD}
+			instr_ret=$?
+			if [ ${instr_ret} -eq 0 ] && [ "${VERBOSE}" != "generate" ] ; then
+				compare_instructions "${INSTR_COMPARE}" "${INSTR_OUTPUT}"
+				instr_ret=$?
+			fi
+			[ ${ret} -eq 0 ] && ret=${instr_ret}
+		fi
+		[ "${VERBOSE}" != "generate" ] && rm -f "${INSTR_OUTPUT}"
+	fi
+	[ ${ret} -ne 0 ] && exit ${ret}
 
 	[ "${VERBOSE}" = "generate" ] && exit 77
 
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_helpers.h
+ * @brief  Helpers shared by the unit tests of the compressor and decompressor
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The unit tests that compress and decompress synthetic flows share the
+ * same command line, the same random callback and the same IPv4/UDP
+ * packets.
+ */
+
+#ifndef ROHC_TEST_HELPERS__H
+#define ROHC_TEST_HELPERS__H
+
+#include <rohc/rohc_comp.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Check the given condition, trace it and fail the test if it is false */
+#define CHECK(condition) \
+	do { \
+		if(!(condition)) { \
+			printf("%s:%d: check '%s' failed\n", __FILE__, __LINE__, \
+			       #condition); \
+			goto error; \
+		} \
+	} while(0)
+
+
+/**
+ * @brief Parse the command line of one unit test: [verbose]
+ *
+ * @param argc          The number of command line arguments
+ * @param argv          The command line arguments
+ * @param descr         The description of the test printed in usage
+ * @param[out] verbose  Whether to run in verbose mode or not
+ * @return              true if the command line is valid,
+ *                      false if it is not (usage is printed)
+ */
+static inline bool test_parse_args(const int argc,
+                                   char *argv[],
+                                   const char *const descr,
+                                   bool *const verbose)
+{
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		*verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		*verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("%s\n", descr);
+		printf("usage: %s [verbose]\n", argv[0]);
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static inline int test_gen_random_num(const struct rohc_comp *const comp __attribute__((unused)),
+                                      void *const user_context __attribute__((unused)))
+{
+	return rand();
+}
+
+
+/**
+ * @brief Build one IPv4 header with a valid checksum
+ *
+ * @param ip        The buffer for the IPv4 packet
+ * @param len       The total length of the IPv4 packet
+ * @param protocol  The protocol of the IPv4 payload
+ * @param ip_id     The IP-ID of the IPv4 header
+ * @param saddr     The source address, in host byte order
+ * @param daddr     The destination address, in host byte order
+ * @param df        Whether the Don't Fragment flag is set or not
+ */
+static inline void test_build_ipv4_hdr(uint8_t *const ip,
+                                       const size_t len,
+                                       const uint8_t protocol,
+                                       const uint16_t ip_id,
+                                       const uint32_t saddr,
+                                       const uint32_t daddr,
+                                       const bool df)
+{
+	uint32_t csum = 0;
+	size_t i;
+
+	memset(ip, 0, 20);
+	ip[0] = 0x45;
+	ip[2] = (len >> 8) & 0xff;
+	ip[3] = len & 0xff;
+	ip[4] = (ip_id >> 8) & 0xff;
+	ip[5] = ip_id & 0xff;
+	ip[6] = (df ? 0x40 : 0x00);
+	ip[8] = 64;
+	ip[9] = protocol;
+	ip[12] = (saddr >> 24) & 0xff;
+	ip[13] = (saddr >> 16) & 0xff;
+	ip[14] = (saddr >> 8) & 0xff;
+	ip[15] = saddr & 0xff;
+	ip[16] = (daddr >> 24) & 0xff;
+	ip[17] = (daddr >> 16) & 0xff;
+	ip[18] = (daddr >> 8) & 0xff;
+	ip[19] = daddr & 0xff;
+	for(i = 0; i < 20; i += 2)
+	{
+		csum += (ip[i] << 8) | ip[i + 1];
+	}
+	csum = (csum & 0xffff) + (csum >> 16);
+	csum = (csum & 0xffff) + (csum >> 16);
+	ip[10] = (~csum >> 8) & 0xff;
+	ip[11] = ~csum & 0xff;
+}
+
+
+/**
+ * @brief Build one IPv4/UDP packet of one synthetic flow
+ *
+ * The flows differ by their destination address 192.168.1.<flow_id + 1>.
+ * The IP-ID and the payload change with every packet of the flow, the UDP
+ * checksum is not computed.
+ *
+ * @param ip       The buffer for the IPv4/UDP packet
+ * @param len      The length of the IPv4/UDP packet, at least 28 bytes
+ * @param df       Whether the Don't Fragment flag is set or not
+ * @param flow_id  The ID of the flow
+ * @param pkt_id   The ID of the packet in the flow
+ */
+static inline void test_build_ipv4_udp_pkt(uint8_t *const ip,
+                                           const size_t len,
+                                           const bool df,
+                                           const size_t flow_id,
+                                           const size_t pkt_id)
+{
+	size_t i;
+
+	memset(ip, 0, len);
+
+	/* IPv4 header */
+	test_build_ipv4_hdr(ip, len, 17, 1000 + pkt_id, 0xc0a80001,
+	                    0xc0a80100 + ((flow_id + 1) & 0xff), df);
+
+	/* UDP header without checksum */
+	ip[20] = 0x12;
+	ip[21] = 0x34;
+	ip[22] = 0x56;
+	ip[23] = 0x78;
+	ip[24] = ((len - 20) >> 8) & 0xff;
+	ip[25] = (len - 20) & 0xff;
+
+	/* payload */
+	for(i = 28; i < len; i++)
+	{
+		ip[i] = pkt_id + i;
+	}
+}
+
+#endif
+